@@ -28,6 +28,8 @@
 #   TINK_INCLUDE_DIRS list of global include paths.
 #   TINK_CXX_STANDARD C++ standard to enforce, 11 for now.
 #   TINK_BUILD_TESTS flag, set to false to disable tests (default false).
+#   TINK_BUILD_BENCHMARKS flag, set to false to disable benchmarks (default
+#     false).
 #
 # Sensible defaults are provided for all variables, except TINK_MODULE, which is
 # defined by calls to tink_module(). Please don't alter it directly.
@@ -245,6 +247,57 @@ function(tink_cc_test)
   add_test(NAME ${_target_name} COMMAND ${_target_name} WORKING_DIRECTORY ${CMAKE_BINARY_DIR})
 endfunction(tink_cc_test)
 
+# Declare a Tink benchmark using Google Benchmark, with a syntax similar to
+# tink_cc_test.
+#
+# Parameters:
+#   NAME  base name of the benchmark.
+#   SRCS  list of benchmark source files, headers included.
+#   DEPS  list of dependencies, see tink_cc_library above.
+#
+# Benchmarks are not registered with CTest. Each benchmark produces a build
+# target named tink_benchmark_<MODULE>_<NAME>, which is also added as a
+# dependency of the `tink_benchmarks` target.
+#
+function(tink_cc_benchmark)
+  cmake_parse_arguments(PARSE_ARGV 0 tink_cc_benchmark
+    ""
+    "NAME"
+    "SRCS;DEPS"
+  )
+
+  if (NOT TINK_BUILD_BENCHMARKS)
+    return()
+  endif()
+
+  if (NOT DEFINED TINK_MODULE)
+    message(FATAL_ERROR "TINK_MODULE not defined")
+  endif()
+
+  STRING(REPLACE "::" "__" _ESCAPED_TINK_MODULE ${TINK_MODULE})
+
+  set(_target_name "tink_benchmark_${_ESCAPED_TINK_MODULE}_${tink_cc_benchmark_NAME}")
+
+  add_executable(${_target_name}
+    ${tink_cc_benchmark_SRCS}
+  )
+
+  target_link_libraries(${_target_name}
+    benchmark::benchmark
+    ${tink_cc_benchmark_DEPS}
+  )
+
+  set_property(TARGET ${_target_name}
+               PROPERTY FOLDER "${TINK_IDE_FOLDER}/Benchmarks")
+  set_property(TARGET ${_target_name} PROPERTY CXX_STANDARD ${TINK_CXX_STANDARD})
+  set_property(TARGET ${_target_name} PROPERTY CXX_STANDARD_REQUIRED true)
+
+  if (NOT TARGET tink_benchmarks)
+    add_custom_target(tink_benchmarks)
+  endif()
+  add_dependencies(tink_benchmarks ${_target_name})
+endfunction(tink_cc_benchmark)
+
 # Declare a C++ Proto library.
 #
 # Parameters:
@@ -78,6 +78,23 @@ if (TINK_BUILD_TESTS)
     "${CMAKE_BINARY_DIR}/testvectors")
 endif()
 
+if (TINK_BUILD_BENCHMARKS)
+  if (TINK_USE_INSTALLED_BENCHMARK)
+    # Generates the target benchmark::benchmark.
+    find_package(benchmark CONFIG REQUIRED)
+  else()
+    set(BENCHMARK_ENABLE_TESTING OFF CACHE BOOL "Tink dependency override" FORCE)
+    set(BENCHMARK_ENABLE_GTEST_TESTS OFF CACHE BOOL "Tink dependency override" FORCE)
+    set(BENCHMARK_ENABLE_INSTALL OFF CACHE BOOL "Tink dependency override" FORCE)
+    # Release from 2023-08-31.
+    http_archive(
+      NAME benchmark
+      URL https://github.com/google/benchmark/archive/refs/tags/v1.8.3.tar.gz
+      SHA256 6bc180a57d23d4d9515519f92b0c83d61b05b5bab188961f36ac7b06b0d9e9ce
+    )
+  endif()
+endif()
+
 if (NOT TINK_USE_INSTALLED_ABSEIL)
   # Release from 2023-08-02.
   http_archive(
@@ -28,7 +28,10 @@
 #include "tink/aead/aes_gcm_siv_proto_serialization.h"
 #include "tink/aead/kms_aead_key_manager.h"
 #include "tink/aead/kms_envelope_aead_key_manager.h"
+#include "tink/aead/x_aes_gcm_key_manager.h"
+#include "tink/aead/x_aes_gcm_proto_serialization.h"
 #include "tink/aead/xchacha20_poly1305_key_manager.h"
+#include "tink/aead/zero_copy_aead_wrapper.h"
 #include "tink/config/tink_fips.h"
 #include "tink/mac/mac_config.h"
 #include "tink/registry.h"
@@ -44,12 +47,18 @@ util::Status AeadConfig::Register() {
     return status;
   }
 
-  // Register primitive wrapper.
+  // Register primitive wrappers.
   status = Registry::RegisterPrimitiveWrapper(absl::make_unique<AeadWrapper>());
   if (!status.ok()) {
     return status;
   }
 
+  status = Registry::RegisterPrimitiveWrapper(
+      absl::make_unique<ZeroCopyAeadWrapper>());
+  if (!status.ok()) {
+    return status;
+  }
+
   // Register key managers which utilize the FIPS validated BoringCrypto
   // implementations.
   status = Registry::RegisterKeyTypeManager(
@@ -92,6 +101,12 @@ util::Status AeadConfig::Register() {
     return status;
   }
 
+  status = Registry::RegisterKeyTypeManager(
+      absl::make_unique<XAesGcmKeyManager>(), true);
+  if (!status.ok()) {
+    return status;
+  }
+
   status = Registry::RegisterKeyTypeManager(
       absl::make_unique<KmsAeadKeyManager>(), true);
   if (!status.ok()) {
@@ -114,6 +129,11 @@ util::Status AeadConfig::Register() {
     return status;
   }
 
+  status = RegisterXAesGcmProtoSerialization();
+  if (!status.ok()) {
+    return status;
+  }
+
   return util::OkStatus();
 }
 
@@ -28,6 +28,7 @@
 #include "proto/hmac.pb.h"
 #include "proto/kms_envelope.pb.h"
 #include "proto/tink.pb.h"
+#include "proto/x_aes_gcm.pb.h"
 
 using google::crypto::tink::AesCtrHmacAeadKeyFormat;
 using google::crypto::tink::AesEaxKeyFormat;
@@ -37,6 +38,7 @@ using google::crypto::tink::HashType;
 using google::crypto::tink::KeyTemplate;
 using google::crypto::tink::KmsEnvelopeAeadKeyFormat;
 using google::crypto::tink::OutputPrefixType;
+using google::crypto::tink::XAesGcmKeyFormat;
 
 namespace crypto {
 namespace tink {
@@ -107,6 +109,17 @@ KeyTemplate* NewXChaCha20Poly1305KeyTemplate() {
   return key_template;
 }
 
+KeyTemplate* NewXAesGcmKeyTemplate(int salt_size_in_bytes) {
+  KeyTemplate* key_template = new KeyTemplate;
+  key_template->set_type_url(
+      "type.googleapis.com/google.crypto.tink.XAesGcmKey");
+  key_template->set_output_prefix_type(OutputPrefixType::TINK);
+  XAesGcmKeyFormat key_format;
+  key_format.mutable_params()->set_salt_size(salt_size_in_bytes);
+  key_format.SerializeToString(key_template->mutable_value());
+  return key_template;
+}
+
 }  // anonymous namespace
 
 // static
@@ -193,6 +206,13 @@ const KeyTemplate& AeadKeyTemplates::XChaCha20Poly1305() {
   return *key_template;
 }
 
+// static
+const KeyTemplate& AeadKeyTemplates::XAes256Gcm8ByteSalt() {
+  static const KeyTemplate* key_template =
+      NewXAesGcmKeyTemplate(/* salt_size_in_bytes= */ 8);
+  return *key_template;
+}
+
 // static
 KeyTemplate AeadKeyTemplates::KmsEnvelopeAead(absl::string_view kek_uri,
                                               const KeyTemplate& dek_template) {
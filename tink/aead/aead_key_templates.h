@@ -127,6 +127,13 @@ class AeadKeyTemplates {
   //   - OutputPrefixType: TINK
   static const google::crypto::tink::KeyTemplate& XChaCha20Poly1305();
 
+  // Returns a KeyTemplate that generates new instances of XAesGcmKey
+  // with the following parameters:
+  //   - Key size: 32 bytes
+  //   - Salt size: 8 bytes
+  //   - OutputPrefixType: TINK
+  static const google::crypto::tink::KeyTemplate& XAes256Gcm8ByteSalt();
+
   // Returns a KeyTemplate that generates new instances of KmsEnvelopeAeadKey
   // with the following parameters:
   //   - KEK is pointing to kek_uri
@@ -31,6 +31,7 @@
 #include "tink/aead/aes_gcm_key_manager.h"
 #include "tink/aead/aes_gcm_siv_key_manager.h"
 #include "tink/aead/kms_envelope_aead_key_manager.h"
+#include "tink/aead/x_aes_gcm_key_manager.h"
 #include "tink/aead/xchacha20_poly1305_key_manager.h"
 #include "tink/config/global_registry.h"
 #include "tink/core/key_manager_impl.h"
@@ -49,6 +50,7 @@
 #include "proto/hmac.pb.h"
 #include "proto/kms_envelope.pb.h"
 #include "proto/tink.pb.h"
+#include "proto/x_aes_gcm.pb.h"
 #include "proto/xchacha20_poly1305.pb.h"
 
 using google::crypto::tink::AesCtrHmacAeadKeyFormat;
@@ -59,6 +61,7 @@ using google::crypto::tink::HashType;
 using google::crypto::tink::KeyTemplate;
 using google::crypto::tink::KmsEnvelopeAeadKeyFormat;
 using google::crypto::tink::OutputPrefixType;
+using google::crypto::tink::XAesGcmKeyFormat;
 
 namespace crypto {
 namespace tink {
@@ -369,6 +372,30 @@ TEST(AeadKeyTemplatesTest, testXChaCha20Poly1305KeyTemplates) {
   EXPECT_TRUE(new_key_result.ok()) << new_key_result.status();
 }
 
+TEST(AeadKeyTemplatesTest, testXAesGcmKeyTemplates) {
+  std::string type_url = "type.googleapis.com/google.crypto.tink.XAesGcmKey";
+
+  // Check that returned template is correct.
+  const KeyTemplate& key_template = AeadKeyTemplates::XAes256Gcm8ByteSalt();
+  EXPECT_EQ(type_url, key_template.type_url());
+  EXPECT_EQ(OutputPrefixType::TINK, key_template.output_prefix_type());
+  XAesGcmKeyFormat key_format;
+  EXPECT_TRUE(key_format.ParseFromString(key_template.value()));
+  EXPECT_EQ(8, key_format.params().salt_size());
+
+  // Check that reference to the same object is returned.
+  const KeyTemplate& key_template_2 = AeadKeyTemplates::XAes256Gcm8ByteSalt();
+  EXPECT_EQ(&key_template, &key_template_2);
+
+  // Check that the template works with the key manager.
+  XAesGcmKeyManager key_type_manager;
+  auto key_manager = internal::MakeKeyManager<Aead>(&key_type_manager);
+  EXPECT_EQ(key_manager->get_key_type(), key_template.type_url());
+  auto new_key_result =
+      key_manager->get_key_factory().NewKey(key_template.value());
+  EXPECT_TRUE(new_key_result.ok()) << new_key_result.status();
+}
+
 TEST(AeadKeyTemplatesTest, testKmsEnvelopeAead) {
   std::string type_url =
       "type.googleapis.com/google.crypto.tink.KmsEnvelopeAeadKey";
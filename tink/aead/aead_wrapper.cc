@@ -16,17 +16,26 @@
 
 #include "tink/aead/aead_wrapper.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/aead.h"
 #include "tink/crypto_format.h"
+#include "tink/internal/batch_util.h"
 #include "tink/internal/monitoring_util.h"
+#include "tink/internal/output_prefix_index.h"
 #include "tink/internal/registry_impl.h"
 #include "tink/internal/util.h"
 #include "tink/monitoring/monitoring.h"
@@ -42,6 +51,8 @@ constexpr absl::string_view kPrimitive = "aead";
 constexpr absl::string_view kEncryptApi = "encrypt";
 constexpr absl::string_view kDecryptApi = "decrypt";
 
+using AeadEntry = PrimitiveSet<Aead>::Entry<Aead>;
+
 util::Status Validate(PrimitiveSet<Aead>* aead_set) {
   if (aead_set == nullptr) {
     return util::Status(absl::StatusCode::kInternal,
@@ -59,9 +70,12 @@ class AeadSetWrapper : public Aead {
  public:
   explicit AeadSetWrapper(
       std::unique_ptr<PrimitiveSet<Aead>> aead_set,
+      const AeadWrapper::Options& options,
       std::unique_ptr<MonitoringClient> monitoring_encryption_client = nullptr,
       std::unique_ptr<MonitoringClient> monitoring_decryption_client = nullptr)
       : aead_set_(std::move(aead_set)),
+        prefix_index_(*aead_set_),
+        options_(options),
         monitoring_encryption_client_(std::move(monitoring_encryption_client)),
         monitoring_decryption_client_(std::move(monitoring_decryption_client)) {
   }
@@ -74,8 +88,37 @@ class AeadSetWrapper : public Aead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const override;
 
+  util::Status EncryptBatch(absl::Span<const absl::string_view> plaintexts,
+                            absl::Span<const absl::string_view> associated_data,
+                            std::string* ciphertexts,
+                            std::vector<int64_t>* offsets) const override;
+
+  util::Status DecryptBatch(absl::Span<const absl::string_view> ciphertexts,
+                            absl::Span<const absl::string_view> associated_data,
+                            std::string* plaintexts,
+                            std::vector<int64_t>* offsets) const override;
+
  private:
+  // Decrypts `ciphertext` with the first matching key in the set, without
+  // logging to monitoring. On success, `key_id` and `raw_ciphertext_size` are
+  // set to the ID of the key used and the size of the ciphertext without the
+  // output prefix.
+  util::StatusOr<std::string> DecryptWithoutMonitoring(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      uint32_t* key_id, int64_t* raw_ciphertext_size) const;
+
+  // Tries the RAW keys on `ciphertext` as configured in `options_`. On
+  // success, `key_id` is set to the ID of the key used.
+  util::StatusOr<std::string> DecryptWithRawKeys(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      uint32_t* key_id) const;
+
   std::unique_ptr<PrimitiveSet<Aead>> aead_set_;
+  const internal::OutputPrefixIndex<Aead> prefix_index_;
+  const AeadWrapper::Options options_;
+  // Position in prefix_index_.raw_entries() of the RAW key that most recently
+  // decrypted a ciphertext.
+  mutable std::atomic<int> most_recent_raw_key_{0};
   std::unique_ptr<MonitoringClient> monitoring_encryption_client_;
   std::unique_ptr<MonitoringClient> monitoring_decryption_client_;
 };
@@ -102,58 +145,205 @@ util::StatusOr<std::string> AeadSetWrapper::Encrypt(
 
 util::StatusOr<std::string> AeadSetWrapper::Decrypt(
     absl::string_view ciphertext, absl::string_view associated_data) const {
+  uint32_t key_id;
+  int64_t raw_ciphertext_size;
+  util::StatusOr<std::string> plaintext = DecryptWithoutMonitoring(
+      ciphertext, associated_data, &key_id, &raw_ciphertext_size);
+  if (monitoring_decryption_client_ != nullptr) {
+    if (plaintext.ok()) {
+      monitoring_decryption_client_->Log(key_id, raw_ciphertext_size);
+    } else {
+      monitoring_decryption_client_->LogFailure();
+    }
+  }
+  return plaintext;
+}
+
+util::StatusOr<std::string> AeadSetWrapper::DecryptWithoutMonitoring(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    uint32_t* key_id, int64_t* raw_ciphertext_size) const {
   // BoringSSL expects a non-null pointer for plaintext and associated_data,
   // regardless of whether the size is 0.
   associated_data = internal::EnsureStringNonNull(associated_data);
 
+  AeadDecryptionStats* const stats = options_.stats.get();
   if (ciphertext.length() > CryptoFormat::kNonRawPrefixSize) {
-    absl::string_view key_id =
-        ciphertext.substr(0, CryptoFormat::kNonRawPrefixSize);
-    util::StatusOr<const PrimitiveSet<Aead>::Primitives*> primitives =
-        aead_set_->get_primitives(key_id);
-    if (primitives.ok()) {
-      absl::string_view raw_ciphertext =
-          ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
-      for (const std::unique_ptr<PrimitiveSet<Aead>::Entry<Aead>>& aead_entry :
-           **primitives) {
-        Aead& aead = aead_entry->get_primitive();
-        util::StatusOr<std::string> plaintext =
-            aead.Decrypt(raw_ciphertext, associated_data);
-        if (plaintext.ok()) {
-          if (monitoring_decryption_client_ != nullptr) {
-            monitoring_decryption_client_->Log(aead_entry->get_key_id(),
-                                               raw_ciphertext.size());
-          }
-          return plaintext;
+    absl::string_view raw_ciphertext =
+        ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
+    for (const AeadEntry* aead_entry : prefix_index_.Find(ciphertext)) {
+      util::StatusOr<std::string> plaintext =
+          aead_entry->get_primitive().Decrypt(raw_ciphertext, associated_data);
+      if (plaintext.ok()) {
+        if (stats != nullptr) {
+          stats->prefix_hits.fetch_add(1, std::memory_order_relaxed);
         }
+        *key_id = aead_entry->get_key_id();
+        *raw_ciphertext_size = raw_ciphertext.size();
+        return plaintext;
       }
     }
   }
+  if (stats != nullptr) {
+    stats->prefix_misses.fetch_add(1, std::memory_order_relaxed);
+  }
 
-  // No matching key succeeded with decryption, try all RAW keys.
-  util::StatusOr<const PrimitiveSet<Aead>::Primitives*> raw_primitives =
-      aead_set_->get_raw_primitives();
-  if (raw_primitives.ok()) {
-    for (const std::unique_ptr<PrimitiveSet<Aead>::Entry<Aead>>& aead_entry :
-         **raw_primitives) {
-      Aead& aead = aead_entry->get_primitive();
-      util::StatusOr<std::string> plaintext =
-          aead.Decrypt(ciphertext, associated_data);
-      if (plaintext.ok()) {
-        if (monitoring_decryption_client_ != nullptr) {
-          monitoring_decryption_client_->Log(aead_entry->get_key_id(),
-                                             ciphertext.size());
-        }
-        return plaintext;
+  // No matching key succeeded with decryption, try the RAW keys.
+  util::StatusOr<std::string> plaintext =
+      DecryptWithRawKeys(ciphertext, associated_data, key_id);
+  if (!plaintext.ok()) {
+    return plaintext.status();
+  }
+  *raw_ciphertext_size = ciphertext.size();
+  return plaintext;
+}
+
+util::StatusOr<std::string> AeadSetWrapper::DecryptWithRawKeys(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    uint32_t* key_id) const {
+  AeadDecryptionStats* const stats = options_.stats.get();
+  absl::Span<AeadEntry* const> raw_entries = prefix_index_.raw_entries();
+  int num_trials = raw_entries.size();
+  if (options_.max_raw_key_trials > 0) {
+    num_trials = std::min(num_trials, options_.max_raw_key_trials);
+  }
+  int first = 0;
+  if (options_.raw_key_trial_order ==
+      AeadWrapper::RawKeyTrialOrder::kMostRecentlyUsedFirst) {
+    first = most_recent_raw_key_.load(std::memory_order_relaxed);
+  }
+  for (int trial = 0; trial < num_trials; ++trial) {
+    // Try `first`, then the other keys in keyset order.
+    const int index = trial == 0 ? first : (trial <= first ? trial - 1 : trial);
+    const AeadEntry* aead_entry = raw_entries[index];
+    util::StatusOr<std::string> plaintext =
+        aead_entry->get_primitive().Decrypt(ciphertext, associated_data);
+    if (stats != nullptr) {
+      stats->raw_attempts.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (plaintext.ok()) {
+      if (stats != nullptr) {
+        stats->raw_hits.fetch_add(1, std::memory_order_relaxed);
+      }
+      if (index != first) {
+        most_recent_raw_key_.store(index, std::memory_order_relaxed);
       }
+      *key_id = aead_entry->get_key_id();
+      return plaintext;
     }
   }
-  if (monitoring_decryption_client_ != nullptr) {
-    monitoring_decryption_client_->LogFailure();
+  if (stats != nullptr && num_trials > 0) {
+    stats->raw_misses.fetch_add(1, std::memory_order_relaxed);
   }
   return util::Status(absl::StatusCode::kInvalidArgument, "decryption failed");
 }
 
+util::Status AeadSetWrapper::EncryptBatch(
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* ciphertexts, std::vector<int64_t>* offsets) const {
+  // The primary is resolved once for the whole batch, and writes each
+  // ciphertext right after its output prefix.
+  const PrimitiveSet<Aead>::Entry<Aead>* primary = aead_set_->get_primary();
+  util::Status status = primary->get_primitive().EncryptBatchWithPrefix(
+      primary->get_identifier(), plaintexts, associated_data, ciphertexts,
+      offsets);
+  if (!status.ok()) {
+    if (monitoring_encryption_client_ != nullptr) {
+      monitoring_encryption_client_->LogFailure();
+    }
+    return status;
+  }
+  if (monitoring_encryption_client_ != nullptr) {
+    int64_t plaintexts_size = 0;
+    for (absl::string_view plaintext : plaintexts) {
+      plaintexts_size += plaintext.size();
+    }
+    monitoring_encryption_client_->Log(primary->get_key_id(), plaintexts_size);
+  }
+  return util::OkStatus();
+}
+
+util::Status AeadSetWrapper::DecryptBatch(
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* plaintexts, std::vector<int64_t>* offsets) const {
+  util::Status status = internal::ValidateBatchAssociatedData(
+      ciphertexts.size(), associated_data);
+  if (!status.ok()) {
+    internal::ClearFailedBatchOutputs(plaintexts, offsets);
+    if (monitoring_decryption_client_ != nullptr) {
+      monitoring_decryption_client_->LogFailure();
+    }
+    return status;
+  }
+
+  // Fast path: all ciphertexts carry the output prefix of the primary, which
+  // is typical for data encrypted since the last key rotation. The batch is
+  // then decrypted by the primary in a single call.
+  const PrimitiveSet<Aead>::Entry<Aead>* primary = aead_set_->get_primary();
+  const std::string& primary_prefix = primary->get_identifier();
+  bool all_primary = true;
+  for (absl::string_view ciphertext : ciphertexts) {
+    if (!absl::StartsWith(ciphertext, primary_prefix)) {
+      all_primary = false;
+      break;
+    }
+  }
+  if (all_primary) {
+    std::vector<absl::string_view> raw_ciphertexts;
+    raw_ciphertexts.reserve(ciphertexts.size());
+    int64_t raw_ciphertexts_size = 0;
+    for (absl::string_view ciphertext : ciphertexts) {
+      raw_ciphertexts.push_back(ciphertext.substr(primary_prefix.size()));
+      raw_ciphertexts_size += raw_ciphertexts.back().size();
+    }
+    status = primary->get_primitive().DecryptBatch(
+        raw_ciphertexts, associated_data, plaintexts, offsets);
+    if (status.ok()) {
+      if (options_.stats != nullptr) {
+        options_.stats->prefix_hits.fetch_add(ciphertexts.size(),
+                                              std::memory_order_relaxed);
+      }
+      if (monitoring_decryption_client_ != nullptr) {
+        monitoring_decryption_client_->Log(primary->get_key_id(),
+                                           raw_ciphertexts_size);
+      }
+      return util::OkStatus();
+    }
+  }
+
+  // Otherwise, decrypt the ciphertexts one by one with the matching keys, and
+  // log once per key used.
+  internal::ClearFailedBatchOutputs(plaintexts, offsets);
+  offsets->assign(1, 0);
+  offsets->reserve(ciphertexts.size() + 1);
+  absl::flat_hash_map<uint32_t, int64_t> raw_ciphertexts_size_per_key;
+  for (int64_t i = 0; i < ciphertexts.size(); ++i) {
+    uint32_t key_id;
+    int64_t raw_ciphertext_size;
+    util::StatusOr<std::string> plaintext = DecryptWithoutMonitoring(
+        ciphertexts[i], internal::BatchAssociatedData(associated_data, i),
+        &key_id, &raw_ciphertext_size);
+    if (!plaintext.ok()) {
+      internal::ClearFailedBatchOutputs(plaintexts, offsets);
+      if (monitoring_decryption_client_ != nullptr) {
+        monitoring_decryption_client_->LogFailure();
+      }
+      return plaintext.status();
+    }
+    plaintexts->append(*plaintext);
+    offsets->push_back(plaintexts->size());
+    raw_ciphertexts_size_per_key[key_id] += raw_ciphertext_size;
+  }
+  if (monitoring_decryption_client_ != nullptr) {
+    for (const auto& key_and_size : raw_ciphertexts_size_per_key) {
+      monitoring_decryption_client_->Log(key_and_size.first,
+                                         key_and_size.second);
+    }
+  }
+  return util::OkStatus();
+}
+
 }  // namespace
 
 util::StatusOr<std::unique_ptr<Aead>> AeadWrapper::Wrap(
@@ -168,7 +358,7 @@ util::StatusOr<std::unique_ptr<Aead>> AeadWrapper::Wrap(
 
   // Monitoring is not enabled. Create a wrapper without monitoring clients.
   if (monitoring_factory == nullptr) {
-    return {absl::make_unique<AeadSetWrapper>(std::move(aead_set))};
+    return {absl::make_unique<AeadSetWrapper>(std::move(aead_set), options_)};
   }
 
   util::StatusOr<MonitoringKeySetInfo> keyset_info =
@@ -192,7 +382,7 @@ util::StatusOr<std::unique_ptr<Aead>> AeadWrapper::Wrap(
   }
 
   return {absl::make_unique<AeadSetWrapper>(
-      std::move(aead_set), *std::move(monitoring_encryption_client),
+      std::move(aead_set), options_, *std::move(monitoring_encryption_client),
       *std::move(monitoring_decryption_client))};
 }
 
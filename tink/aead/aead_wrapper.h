@@ -17,7 +17,10 @@
 #ifndef TINK_AEAD_AEAD_WRAPPER_H_
 #define TINK_AEAD_AEAD_WRAPPER_H_
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <utility>
 
 #include "tink/aead.h"
 #include "tink/primitive_set.h"
@@ -27,17 +30,60 @@
 namespace crypto {
 namespace tink {
 
+// Cumulative counters of how the primitives returned by an AeadWrapper find
+// the key that decrypts a ciphertext. They may be read while decryptions are
+// in progress.
+struct AeadDecryptionStats {
+  // Decryptions that succeeded with a key matching the output prefix.
+  std::atomic<int64_t> prefix_hits{0};
+  // Decryptions that no key matching the output prefix succeeded with,
+  // including ciphertexts whose prefix does not match any key.
+  std::atomic<int64_t> prefix_misses{0};
+  // Decryptions that succeeded with a RAW key.
+  std::atomic<int64_t> raw_hits{0};
+  // Decryptions that none of the tried RAW keys succeeded with.
+  std::atomic<int64_t> raw_misses{0};
+  // Decryption attempts with RAW keys, successful or not.
+  std::atomic<int64_t> raw_attempts{0};
+};
+
 // Wraps a set of Aead-instances that correspond to a keyset,
 // and combines them into a single Aead-primitive, that uses the provided
 // instances, depending on the context:
 //   * Aead::Encrypt(...) uses the primary instance from the set
 //   * Aead::Decrypt(...) uses the instance that matches the ciphertext prefix.
+//     If none does, the RAW instances are tried as configured in Options.
 class AeadWrapper : public PrimitiveWrapper<Aead, Aead> {
  public:
+  // Order in which RAW keys are tried.
+  enum class RawKeyTrialOrder {
+    // In keyset order.
+    kKeysetOrder,
+    // The RAW key that most recently decrypted a ciphertext first, then the
+    // others in keyset order. This helps keysets with many RAW keys where
+    // most ciphertexts are encrypted with the same, not necessarily first,
+    // key.
+    kMostRecentlyUsedFirst,
+  };
+
+  struct Options {
+    RawKeyTrialOrder raw_key_trial_order = RawKeyTrialOrder::kKeysetOrder;
+    // Maximum number of RAW keys tried per ciphertext, or 0 for no limit.
+    int max_raw_key_trials = 0;
+    // If not null, updated by all primitives returned by Wrap().
+    std::shared_ptr<AeadDecryptionStats> stats;
+  };
+
+  AeadWrapper() = default;
+  explicit AeadWrapper(Options options) : options_(std::move(options)) {}
+
   // Returns an Aead-primitive that uses Aead-instances provided in 'aead_set',
   // which must be non-NULL and must contain a primary instance.
   util::StatusOr<std::unique_ptr<Aead>> Wrap(
       std::unique_ptr<PrimitiveSet<Aead>> aead_set) const override;
+
+ private:
+  Options options_;
 };
 
 }  // namespace tink
@@ -21,6 +21,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -29,7 +30,9 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/aead.h"
 #include "tink/aead/mock_aead.h"
 #include "tink/crypto_format.h"
@@ -50,17 +53,21 @@ namespace {
 
 using ::crypto::tink::test::DummyAead;
 using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::IsOkAndHolds;
 using ::crypto::tink::test::StatusIs;
 using ::google::crypto::tink::KeysetInfo;
 using ::google::crypto::tink::KeyStatusType;
 using ::google::crypto::tink::OutputPrefixType;
 using ::testing::_;
 using ::testing::ByMove;
+using ::testing::ElementsAre;
 using ::testing::HasSubstr;
+using ::testing::IsEmpty;
 using ::testing::IsNull;
 using ::testing::IsSubstring;
 using ::testing::Not;
 using ::testing::Return;
+using ::testing::SizeIs;
 using ::testing::StrictMock;
 using ::testing::Test;
 
@@ -197,6 +204,224 @@ TEST(AeadSetWrapperTest, DecryptNonPrimary) {
   EXPECT_THAT(decrypted_plaintext, IsOk());
 }
 
+TEST(AeadSetWrapperTest, EncryptDecryptBatch) {
+  KeysetInfo keyset_info = CreateTestKeysetInfo();
+  auto aead_set = absl::make_unique<PrimitiveSet<Aead>>();
+  for (int i = 0; i < keyset_info.key_info_size(); ++i) {
+    util::StatusOr<PrimitiveSet<Aead>::Entry<Aead>*> entry =
+        aead_set->AddPrimitive(
+            absl::make_unique<DummyAead>(absl::StrCat("aead", i)),
+            keyset_info.key_info(i));
+    ASSERT_THAT(entry, IsOk());
+    ASSERT_THAT(aead_set->set_primary(*entry), IsOk());
+  }
+  util::StatusOr<std::unique_ptr<Aead>> aead =
+      AeadWrapper().Wrap(std::move(aead_set));
+  ASSERT_THAT(aead, IsOk());
+
+  std::vector<absl::string_view> plaintexts = {"plaintext 0", "",
+                                               "plaintext 2"};
+  std::vector<absl::string_view> associated_data = {"ad 0", "ad 1", "ad 2"};
+  std::string ciphertexts;
+  std::vector<int64_t> ciphertext_offsets;
+  ASSERT_THAT((*aead)->EncryptBatch(plaintexts, associated_data, &ciphertexts,
+                                    &ciphertext_offsets),
+              IsOk());
+  ASSERT_THAT(ciphertext_offsets, SizeIs(plaintexts.size() + 1));
+
+  // Every ciphertext of the batch is a regular ciphertext of the primary.
+  std::vector<absl::string_view> ciphertext_views;
+  for (int i = 0; i < plaintexts.size(); ++i) {
+    absl::string_view ciphertext = absl::string_view(ciphertexts).substr(
+        ciphertext_offsets[i],
+        ciphertext_offsets[i + 1] - ciphertext_offsets[i]);
+    EXPECT_THAT(std::string(ciphertext), HasSubstr("aead2"));
+    EXPECT_THAT((*aead)->Decrypt(ciphertext, associated_data[i]),
+                IsOkAndHolds(std::string(plaintexts[i])));
+    ciphertext_views.push_back(ciphertext);
+  }
+
+  std::string decrypted;
+  std::vector<int64_t> plaintext_offsets;
+  ASSERT_THAT((*aead)->DecryptBatch(ciphertext_views, associated_data,
+                                    &decrypted, &plaintext_offsets),
+              IsOk());
+  EXPECT_EQ(decrypted, absl::StrJoin(plaintexts, ""));
+  EXPECT_THAT(plaintext_offsets, ElementsAre(0, 11, 11, 22));
+
+  // A single associated data value applies to the whole batch.
+  std::vector<absl::string_view> shared_associated_data = {"shared ad"};
+  ASSERT_THAT((*aead)->EncryptBatch(plaintexts, shared_associated_data,
+                                    &ciphertexts, &ciphertext_offsets),
+              IsOk());
+  EXPECT_THAT((*aead)->Decrypt(
+                  absl::string_view(ciphertexts)
+                      .substr(0, ciphertext_offsets[1]),
+                  "shared ad"),
+              IsOkAndHolds(std::string(plaintexts[0])));
+
+  // Any other number of associated data values is rejected.
+  EXPECT_THAT((*aead)->EncryptBatch(
+                  plaintexts,
+                  absl::MakeConstSpan(associated_data).subspan(0, 2),
+                  &ciphertexts, &ciphertext_offsets),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(AeadSetWrapperTest, DecryptBatchWithMixedKeys) {
+  KeysetInfo keyset_info = CreateTestKeysetInfo();
+  auto aead_set = absl::make_unique<PrimitiveSet<Aead>>();
+  for (int i = 0; i < keyset_info.key_info_size(); ++i) {
+    util::StatusOr<PrimitiveSet<Aead>::Entry<Aead>*> entry =
+        aead_set->AddPrimitive(
+            absl::make_unique<DummyAead>(absl::StrCat("aead", i)),
+            keyset_info.key_info(i));
+    ASSERT_THAT(entry, IsOk());
+    ASSERT_THAT(aead_set->set_primary(*entry), IsOk());
+  }
+  util::StatusOr<std::unique_ptr<Aead>> aead =
+      AeadWrapper().Wrap(std::move(aead_set));
+  ASSERT_THAT(aead, IsOk());
+
+  // Encrypt with a non-primary key, then with the primary.
+  constexpr absl::string_view kAssociatedData = "ad";
+  util::StatusOr<std::string> prefix =
+      CryptoFormat::GetOutputPrefix(keyset_info.key_info(0));
+  ASSERT_THAT(prefix, IsOk());
+  util::StatusOr<std::string> old_ciphertext =
+      DummyAead("aead0").Encrypt("old", kAssociatedData);
+  ASSERT_THAT(old_ciphertext, IsOk());
+  std::string old_complete_ciphertext = absl::StrCat(*prefix, *old_ciphertext);
+  util::StatusOr<std::string> new_ciphertext =
+      (*aead)->Encrypt("new", kAssociatedData);
+  ASSERT_THAT(new_ciphertext, IsOk());
+
+  std::vector<absl::string_view> ciphertexts = {old_complete_ciphertext,
+                                                *new_ciphertext};
+  std::vector<absl::string_view> associated_data = {kAssociatedData};
+  std::string plaintexts;
+  std::vector<int64_t> offsets;
+  ASSERT_THAT((*aead)->DecryptBatch(ciphertexts, associated_data, &plaintexts,
+                                    &offsets),
+              IsOk());
+  EXPECT_EQ(plaintexts, "oldnew");
+  EXPECT_THAT(offsets, ElementsAre(0, 3, 6));
+
+  // The whole batch fails if any ciphertext is invalid, and the plaintexts
+  // decrypted before the failure are not returned.
+  ciphertexts.push_back("some bad ciphertext");
+  ciphertexts.push_back(*new_ciphertext);
+  EXPECT_THAT((*aead)->DecryptBatch(ciphertexts, associated_data, &plaintexts,
+                                    &offsets),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(plaintexts, IsEmpty());
+  EXPECT_THAT(offsets, IsEmpty());
+}
+
+// Creates a set with a TINK primary and `num_raw_keys` RAW keys. The RAW
+// keys are DummyAeads named "raw0", "raw1", etc.
+std::unique_ptr<PrimitiveSet<Aead>> CreateSetWithRawKeys(int num_raw_keys) {
+  auto aead_set = absl::make_unique<PrimitiveSet<Aead>>();
+  KeysetInfo::KeyInfo key_info;
+  PopulateKeyInfo(&key_info, /*key_id=*/1234543, OutputPrefixType::TINK,
+                  KeyStatusType::ENABLED);
+  util::StatusOr<PrimitiveSet<Aead>::Entry<Aead>*> primary =
+      aead_set->AddPrimitive(absl::make_unique<DummyAead>("primary"),
+                             key_info);
+  EXPECT_THAT(primary, IsOk());
+  EXPECT_THAT(aead_set->set_primary(*primary), IsOk());
+  for (int i = 0; i < num_raw_keys; ++i) {
+    PopulateKeyInfo(&key_info, /*key_id=*/100 + i, OutputPrefixType::RAW,
+                    KeyStatusType::ENABLED);
+    EXPECT_THAT(aead_set
+                    ->AddPrimitive(
+                        absl::make_unique<DummyAead>(absl::StrCat("raw", i)),
+                        key_info)
+                    .status(),
+                IsOk());
+  }
+  return aead_set;
+}
+
+TEST(AeadSetWrapperTest, DecryptionStats) {
+  AeadWrapper::Options options;
+  options.stats = std::make_shared<AeadDecryptionStats>();
+  AeadWrapper wrapper(options);
+  util::StatusOr<std::unique_ptr<Aead>> aead =
+      wrapper.Wrap(CreateSetWithRawKeys(/*num_raw_keys=*/4));
+  ASSERT_THAT(aead, IsOk());
+  const std::string aad = "some_aad";
+
+  util::StatusOr<std::string> ciphertext = (*aead)->Encrypt("plaintext", aad);
+  ASSERT_THAT(ciphertext, IsOk());
+  EXPECT_THAT((*aead)->Decrypt(*ciphertext, aad), IsOkAndHolds("plaintext"));
+  EXPECT_EQ(options.stats->prefix_hits, 1);
+  EXPECT_EQ(options.stats->prefix_misses, 0);
+
+  ciphertext = DummyAead("raw2").Encrypt("plaintext", aad);
+  ASSERT_THAT(ciphertext, IsOk());
+  EXPECT_THAT((*aead)->Decrypt(*ciphertext, aad), IsOkAndHolds("plaintext"));
+  EXPECT_EQ(options.stats->prefix_misses, 1);
+  EXPECT_EQ(options.stats->raw_hits, 1);
+  EXPECT_EQ(options.stats->raw_attempts, 3);
+
+  EXPECT_THAT((*aead)->Decrypt("invalid ciphertext", aad).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(options.stats->prefix_misses, 2);
+  EXPECT_EQ(options.stats->raw_misses, 1);
+  EXPECT_EQ(options.stats->raw_attempts, 7);
+}
+
+TEST(AeadSetWrapperTest, MostRecentlyUsedRawKeyFirst) {
+  AeadWrapper::Options options;
+  options.raw_key_trial_order =
+      AeadWrapper::RawKeyTrialOrder::kMostRecentlyUsedFirst;
+  options.stats = std::make_shared<AeadDecryptionStats>();
+  AeadWrapper wrapper(options);
+  util::StatusOr<std::unique_ptr<Aead>> aead =
+      wrapper.Wrap(CreateSetWithRawKeys(/*num_raw_keys=*/4));
+  ASSERT_THAT(aead, IsOk());
+  const std::string aad = "some_aad";
+
+  util::StatusOr<std::string> ciphertext =
+      DummyAead("raw3").Encrypt("plaintext", aad);
+  ASSERT_THAT(ciphertext, IsOk());
+  EXPECT_THAT((*aead)->Decrypt(*ciphertext, aad), IsOkAndHolds("plaintext"));
+  EXPECT_EQ(options.stats->raw_attempts, 4);
+  // raw3 is now tried first.
+  EXPECT_THAT((*aead)->Decrypt(*ciphertext, aad), IsOkAndHolds("plaintext"));
+  EXPECT_EQ(options.stats->raw_attempts, 5);
+
+  // The other keys are still tried, in keyset order.
+  ciphertext = DummyAead("raw1").Encrypt("plaintext", aad);
+  ASSERT_THAT(ciphertext, IsOk());
+  EXPECT_THAT((*aead)->Decrypt(*ciphertext, aad), IsOkAndHolds("plaintext"));
+  EXPECT_EQ(options.stats->raw_attempts, 8);
+  EXPECT_THAT((*aead)->Decrypt(*ciphertext, aad), IsOkAndHolds("plaintext"));
+  EXPECT_EQ(options.stats->raw_attempts, 9);
+  EXPECT_EQ(options.stats->raw_hits, 4);
+}
+
+TEST(AeadSetWrapperTest, MaxRawKeyTrials) {
+  AeadWrapper::Options options;
+  options.max_raw_key_trials = 2;
+  AeadWrapper wrapper(options);
+  util::StatusOr<std::unique_ptr<Aead>> aead =
+      wrapper.Wrap(CreateSetWithRawKeys(/*num_raw_keys=*/4));
+  ASSERT_THAT(aead, IsOk());
+  const std::string aad = "some_aad";
+
+  util::StatusOr<std::string> ciphertext =
+      DummyAead("raw1").Encrypt("plaintext", aad);
+  ASSERT_THAT(ciphertext, IsOk());
+  EXPECT_THAT((*aead)->Decrypt(*ciphertext, aad), IsOkAndHolds("plaintext"));
+
+  ciphertext = DummyAead("raw2").Encrypt("plaintext", aad);
+  ASSERT_THAT(ciphertext, IsOk());
+  EXPECT_THAT((*aead)->Decrypt(*ciphertext, aad).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 // Tests with monitoring enabled.
 class AeadSetWrapperTestWithMonitoring : public Test {
  protected:
@@ -340,6 +565,58 @@ TEST_F(AeadSetWrapperTestWithMonitoring,
       Not(IsOk()));
 }
 
+
+// Test that a batch is logged once with the total size of its messages.
+TEST_F(AeadSetWrapperTestWithMonitoring,
+       WrapKeysetWithMonitoringEncryptDecryptBatchSuccess) {
+  KeysetInfo keyset_info = CreateTestKeysetInfo();
+  const absl::flat_hash_map<std::string, std::string> kAnnotations = {
+      {"key1", "value1"}, {"key2", "value2"}, {"key3", "value3"}};
+  auto aead_primitive_set = absl::make_unique<PrimitiveSet<Aead>>(kAnnotations);
+  util::StatusOr<PrimitiveSet<Aead>::Entry<Aead>*> primary =
+      aead_primitive_set->AddPrimitive(absl::make_unique<DummyAead>("aead2"),
+                                       keyset_info.key_info(2));
+  ASSERT_THAT(primary, IsOk());
+  ASSERT_THAT(aead_primitive_set->set_primary(*primary), IsOk());
+  const uint32_t kPrimaryKeyId = keyset_info.key_info(2).key_id();
+
+  util::StatusOr<std::unique_ptr<Aead>> aead =
+      AeadWrapper().Wrap(std::move(aead_primitive_set));
+  ASSERT_THAT(aead, IsOk());
+
+  std::vector<absl::string_view> plaintexts = {"plaintext 0", "plaintext 1",
+                                               "plaintext 2"};
+  std::vector<absl::string_view> associated_data = {"Some associated data!"};
+  EXPECT_CALL(*encryption_monitoring_client_ptr_,
+              Log(kPrimaryKeyId, 3 * plaintexts[0].size()));
+  std::string ciphertexts;
+  std::vector<int64_t> offsets;
+  ASSERT_THAT((*aead)->EncryptBatch(plaintexts, associated_data, &ciphertexts,
+                                    &offsets),
+              IsOk());
+
+  // In the log expect the size of the ciphertexts without the non-raw prefix.
+  std::vector<absl::string_view> ciphertext_views;
+  for (int i = 0; i < plaintexts.size(); ++i) {
+    ciphertext_views.push_back(absl::string_view(ciphertexts).substr(
+        offsets[i], offsets[i + 1] - offsets[i]));
+  }
+  EXPECT_CALL(*decryption_monitoring_client_ptr_,
+              Log(kPrimaryKeyId,
+                  ciphertexts.size() - 3 * CryptoFormat::kNonRawPrefixSize));
+  std::string decrypted;
+  EXPECT_THAT((*aead)->DecryptBatch(ciphertext_views, associated_data,
+                                    &decrypted, &offsets),
+              IsOk());
+
+  // A failing batch is logged as a single failure.
+  ciphertext_views.push_back("some bad ciphertext");
+  EXPECT_CALL(*decryption_monitoring_client_ptr_, LogFailure());
+  EXPECT_THAT((*aead)->DecryptBatch(ciphertext_views, associated_data,
+                                    &decrypted, &offsets),
+              Not(IsOk()));
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
@@ -23,16 +23,18 @@
 #include <string>
 #include <utility>
 
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "tink/aead.h"
-#include "tink/mac.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/mac/hmac_key_manager.h"
 #include "tink/subtle/aes_ctr_boringssl.h"
 #include "tink/subtle/encrypt_then_authenticate.h"
 #include "tink/subtle/ind_cpa_cipher.h"
 #include "tink/subtle/random.h"
+#include "tink/subtle/stateful_hmac_boringssl.h"
 #include "tink/util/enums.h"
 #include "tink/util/input_stream_util.h"
 #include "tink/util/secret_data.h"
@@ -86,23 +88,46 @@ StatusOr<AesCtrHmacAeadKey> AesCtrHmacAeadKeyManager::CreateKey(
   return aes_ctr_hmac_aead_key;
 }
 
-StatusOr<std::unique_ptr<Aead>> AesCtrHmacAeadKeyManager::AeadFactory::Create(
-    const AesCtrHmacAeadKey& key) const {
-  auto aes_ctr_result = subtle::AesCtrBoringSsl::New(
+namespace {
+
+StatusOr<std::unique_ptr<subtle::IndCpaCipher>> NewAesCtr(
+    const AesCtrHmacAeadKey& key) {
+  return subtle::AesCtrBoringSsl::New(
       util::SecretDataFromStringView(key.aes_ctr_key().key_value()),
       key.aes_ctr_key().params().iv_size());
-  if (!aes_ctr_result.ok()) return aes_ctr_result.status();
+}
+
+// The HMAC is computed incrementally, so that the associated data and the
+// ciphertext are not copied into a single MAC input.
+std::unique_ptr<subtle::StatefulMacFactory> NewHmacFactory(
+    const AesCtrHmacAeadKey& key) {
+  return absl::make_unique<subtle::StatefulHmacBoringSslFactory>(
+      util::Enums::ProtoToSubtle(key.hmac_key().params().hash()),
+      key.hmac_key().params().tag_size(),
+      util::SecretDataFromStringView(key.hmac_key().key_value()));
+}
 
-  auto hmac_result = HmacKeyManager().GetPrimitive<Mac>(key.hmac_key());
-  if (!hmac_result.ok()) return hmac_result.status();
+}  // namespace
 
-  auto cipher_res = subtle::EncryptThenAuthenticate::New(
-      std::move(aes_ctr_result.value()), std::move(hmac_result.value()),
+StatusOr<std::unique_ptr<Aead>> AesCtrHmacAeadKeyManager::AeadFactory::Create(
+    const AesCtrHmacAeadKey& key) const {
+  StatusOr<std::unique_ptr<subtle::IndCpaCipher>> aes_ctr = NewAesCtr(key);
+  if (!aes_ctr.ok()) return aes_ctr.status();
+  return subtle::EncryptThenAuthenticate::New(
+      *std::move(aes_ctr), NewHmacFactory(key),
+      key.hmac_key().params().tag_size());
+}
+
+StatusOr<std::unique_ptr<ZeroCopyAead>>
+AesCtrHmacAeadKeyManager::ZeroCopyAeadFactory::Create(
+    const AesCtrHmacAeadKey& key) const {
+  StatusOr<std::unique_ptr<subtle::IndCpaCipher>> aes_ctr = NewAesCtr(key);
+  if (!aes_ctr.ok()) return aes_ctr.status();
+  // AES-CTR encrypts into and decrypts from caller buffers, so the ciphertext
+  // is written directly into the buffer of the caller.
+  return subtle::EncryptThenAuthenticate::NewZeroCopy(
+      *std::move(aes_ctr), NewHmacFactory(key),
       key.hmac_key().params().tag_size());
-  if (!cipher_res.ok()) {
-    return cipher_res.status();
-  }
-  return std::move(cipher_res.value());
 }
 
 Status AesCtrHmacAeadKeyManager::ValidateKey(
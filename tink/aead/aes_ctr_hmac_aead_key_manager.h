@@ -24,6 +24,7 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "tink/aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/core/key_type_manager.h"
 #include "tink/core/template_util.h"
 #include "tink/internal/fips_utils.h"
@@ -39,15 +40,21 @@ namespace tink {
 class AesCtrHmacAeadKeyManager
     : public KeyTypeManager<google::crypto::tink::AesCtrHmacAeadKey,
                             google::crypto::tink::AesCtrHmacAeadKeyFormat,
-                            List<Aead>> {
+                            List<Aead, ZeroCopyAead>> {
  public:
   class AeadFactory : public PrimitiveFactory<Aead> {
     crypto::tink::util::StatusOr<std::unique_ptr<Aead>> Create(
         const google::crypto::tink::AesCtrHmacAeadKey& key) const override;
   };
 
+  class ZeroCopyAeadFactory : public PrimitiveFactory<ZeroCopyAead> {
+    crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>> Create(
+        const google::crypto::tink::AesCtrHmacAeadKey& key) const override;
+  };
+
   AesCtrHmacAeadKeyManager()
-      : KeyTypeManager(absl::make_unique<AeadFactory>()) {}
+      : KeyTypeManager(absl::make_unique<AeadFactory>(),
+                       absl::make_unique<ZeroCopyAeadFactory>()) {}
 
   uint32_t get_version() const override { return 0; }
 
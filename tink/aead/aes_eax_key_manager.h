@@ -25,6 +25,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "tink/aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/core/key_type_manager.h"
 #include "tink/core/template_util.h"
 #include "tink/subtle/aes_eax_boringssl.h"
@@ -42,7 +43,8 @@ namespace tink {
 
 class AesEaxKeyManager
     : public KeyTypeManager<google::crypto::tink::AesEaxKey,
-                            google::crypto::tink::AesEaxKeyFormat, List<Aead>> {
+                            google::crypto::tink::AesEaxKeyFormat,
+                            List<Aead, ZeroCopyAead>> {
  public:
   class AeadFactory : public PrimitiveFactory<Aead> {
     crypto::tink::util::StatusOr<std::unique_ptr<Aead>> Create(
@@ -53,7 +55,18 @@ class AesEaxKeyManager
     }
   };
 
-  AesEaxKeyManager() : KeyTypeManager(absl::make_unique<AeadFactory>()) {}
+  class ZeroCopyAeadFactory : public PrimitiveFactory<ZeroCopyAead> {
+    crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>> Create(
+        const google::crypto::tink::AesEaxKey& key) const override {
+      return subtle::AesEaxBoringSsl::NewZeroCopy(
+          util::SecretDataFromStringView(key.key_value()),
+          key.params().iv_size());
+    }
+  };
+
+  AesEaxKeyManager()
+      : KeyTypeManager(absl::make_unique<AeadFactory>(),
+                       absl::make_unique<ZeroCopyAeadFactory>()) {}
 
   uint32_t get_version() const override { return 0; }
 
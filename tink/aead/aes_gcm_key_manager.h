@@ -29,6 +29,8 @@
 #include "tink/aead.h"
 #include "tink/aead/cord_aead.h"
 #include "tink/aead/internal/cord_aes_gcm_boringssl.h"
+#include "tink/aead/internal/zero_copy_aes_gcm_boringssl.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/core/key_type_manager.h"
 #include "tink/core/template_util.h"
 #include "tink/input_stream.h"
@@ -50,7 +52,7 @@ namespace tink {
 class AesGcmKeyManager
     : public KeyTypeManager<google::crypto::tink::AesGcmKey,
                             google::crypto::tink::AesGcmKeyFormat,
-                            List<Aead, CordAead>> {
+                            List<Aead, CordAead, ZeroCopyAead>> {
  public:
   class AeadFactory : public PrimitiveFactory<Aead> {
     crypto::tink::util::StatusOr<std::unique_ptr<Aead>> Create(
@@ -72,10 +74,19 @@ class AesGcmKeyManager
     }
   };
 
+  class ZeroCopyAeadFactory : public PrimitiveFactory<ZeroCopyAead> {
+    crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>> Create(
+        const google::crypto::tink::AesGcmKey& key) const override {
+      return internal::ZeroCopyAesGcmBoringSsl::New(
+          util::SecretDataFromStringView(key.key_value()));
+    }
+  };
+
   AesGcmKeyManager()
-      : KeyTypeManager(absl::make_unique<AesGcmKeyManager::AeadFactory>(),
-                       absl::make_unique<AesGcmKeyManager::CordAeadFactory>()) {
-  }
+      : KeyTypeManager(
+            absl::make_unique<AesGcmKeyManager::AeadFactory>(),
+            absl::make_unique<AesGcmKeyManager::CordAeadFactory>(),
+            absl::make_unique<AesGcmKeyManager::ZeroCopyAeadFactory>()) {}
 
   // Returns the version of this key manager.
   uint32_t get_version() const override { return 0; }
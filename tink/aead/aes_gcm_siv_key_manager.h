@@ -24,6 +24,7 @@
 #include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "tink/aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/core/key_type_manager.h"
 #include "tink/core/template_util.h"
 #include "tink/subtle/aes_gcm_siv_boringssl.h"
@@ -42,7 +43,7 @@ namespace tink {
 class AesGcmSivKeyManager
     : public KeyTypeManager<google::crypto::tink::AesGcmSivKey,
                             google::crypto::tink::AesGcmSivKeyFormat,
-                            List<Aead>> {
+                            List<Aead, ZeroCopyAead>> {
  public:
   class AeadFactory : public PrimitiveFactory<Aead> {
     crypto::tink::util::StatusOr<std::unique_ptr<Aead>> Create(
@@ -52,7 +53,17 @@ class AesGcmSivKeyManager
     }
   };
 
-  AesGcmSivKeyManager() : KeyTypeManager(absl::make_unique<AeadFactory>()) {}
+  class ZeroCopyAeadFactory : public PrimitiveFactory<ZeroCopyAead> {
+    crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>> Create(
+        const google::crypto::tink::AesGcmSivKey& key) const override {
+      return subtle::AesGcmSivBoringSsl::NewZeroCopy(
+          util::SecretDataFromStringView(key.key_value()));
+    }
+  };
+
+  AesGcmSivKeyManager()
+      : KeyTypeManager(absl::make_unique<AeadFactory>(),
+                       absl::make_unique<ZeroCopyAeadFactory>()) {}
 
   uint32_t get_version() const override { return 0; }
 
@@ -24,6 +24,7 @@
 #include "absl/strings/cord.h"
 #include "tink/aead/cord_aead.h"
 #include "tink/crypto_format.h"
+#include "tink/internal/output_prefix_index.h"
 #include "tink/primitive_set.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -48,7 +49,7 @@ util::Status Validate(PrimitiveSet<CordAead>* aead_set) {
 class CordAeadSetWrapper : public CordAead {
  public:
   explicit CordAeadSetWrapper(std::unique_ptr<PrimitiveSet<CordAead>> aead_set)
-      : aead_set_(std::move(aead_set)) {}
+      : aead_set_(std::move(aead_set)), prefix_index_(*aead_set_) {}
 
   crypto::tink::util::StatusOr<absl::Cord> Encrypt(
       absl::Cord plaintext, absl::Cord associated_data) const override;
@@ -60,6 +61,7 @@ class CordAeadSetWrapper : public CordAead {
 
  private:
   std::unique_ptr<PrimitiveSet<CordAead>> aead_set_;
+  const internal::OutputPrefixIndex<CordAead> prefix_index_;
 };
 
 util::StatusOr<absl::Cord> CordAeadSetWrapper::Encrypt(
@@ -78,29 +80,23 @@ util::StatusOr<absl::Cord> CordAeadSetWrapper::Decrypt(
   if (ciphertext.size() > CryptoFormat::kNonRawPrefixSize) {
     std::string key_id =
         std::string(ciphertext.Subcord(0, CryptoFormat::kNonRawPrefixSize));
-    auto primitives_result = aead_set_->get_primitives(key_id);
-    if (primitives_result.ok()) {
-      auto raw_ciphertext =
-          ciphertext.Subcord(key_id.size(), ciphertext.size());
-      for (auto& aead_entry : *(primitives_result.value())) {
-        CordAead& aead = aead_entry->get_primitive();
-        auto decrypt_result = aead.Decrypt(raw_ciphertext, associated_data);
-        if (decrypt_result.ok()) {
-          return std::move(decrypt_result.value());
-        }
+    auto raw_ciphertext =
+        ciphertext.Subcord(key_id.size(), ciphertext.size());
+    for (const auto* aead_entry : prefix_index_.Find(key_id)) {
+      CordAead& aead = aead_entry->get_primitive();
+      auto decrypt_result = aead.Decrypt(raw_ciphertext, associated_data);
+      if (decrypt_result.ok()) {
+        return std::move(decrypt_result.value());
       }
     }
   }
 
   // No matching key succeeded with decryption, try all RAW keys.
-  auto raw_primitives_result = aead_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (auto& aead_entry : *(raw_primitives_result.value())) {
-      CordAead& aead = aead_entry->get_primitive();
-      auto decrypt_result = aead.Decrypt(ciphertext, associated_data);
-      if (decrypt_result.ok()) {
-        return std::move(decrypt_result.value());
-      }
+  for (const auto* aead_entry : prefix_index_.raw_entries()) {
+    CordAead& aead = aead_entry->get_primitive();
+    auto decrypt_result = aead.Decrypt(ciphertext, associated_data);
+    if (decrypt_result.ok()) {
+      return std::move(decrypt_result.value());
     }
   }
   return util::Status(absl::StatusCode::kInvalidArgument, "decryption failed");
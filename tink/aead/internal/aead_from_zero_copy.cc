@@ -15,11 +15,18 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "tink/aead/internal/aead_from_zero_copy.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/aead/internal/zero_copy_aead.h"
+#include "tink/internal/batch_util.h"
 #include "tink/subtle/subtle_util.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -54,6 +61,75 @@ util::StatusOr<std::string> AeadFromZeroCopy::Decrypt(
   return result;
 }
 
+util::Status AeadFromZeroCopy::EncryptBatchWithPrefix(
+    absl::string_view output_prefix,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* ciphertexts, std::vector<int64_t>* offsets) const {
+  util::Status status =
+      ValidateBatchAssociatedData(plaintexts.size(), associated_data);
+  if (!status.ok()) {
+    return status;
+  }
+  int64_t max_size = 0;
+  for (absl::string_view plaintext : plaintexts) {
+    max_size +=
+        output_prefix.size() + aead_->MaxEncryptionSize(plaintext.size());
+  }
+  subtle::ResizeStringUninitialized(ciphertexts, max_size);
+  offsets->resize(plaintexts.size() + 1);
+  (*offsets)[0] = 0;
+  // Ciphertexts are written back to back, each after its prefix; since each
+  // one is at most MaxEncryptionSize() long, the remaining space suffices.
+  for (int64_t i = 0; i < plaintexts.size(); ++i) {
+    char* out = &(*ciphertexts)[(*offsets)[i]];
+    std::copy(output_prefix.begin(), output_prefix.end(), out);
+    util::StatusOr<int64_t> written_bytes = aead_->Encrypt(
+        plaintexts[i], BatchAssociatedData(associated_data, i),
+        absl::MakeSpan(out + output_prefix.size(),
+                       aead_->MaxEncryptionSize(plaintexts[i].size())));
+    if (!written_bytes.ok()) {
+      return written_bytes.status();
+    }
+    (*offsets)[i + 1] = (*offsets)[i] + output_prefix.size() + *written_bytes;
+  }
+  ciphertexts->resize(offsets->back());
+  return util::OkStatus();
+}
+
+util::Status AeadFromZeroCopy::DecryptBatch(
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* plaintexts, std::vector<int64_t>* offsets) const {
+  util::Status status =
+      ValidateBatchAssociatedData(ciphertexts.size(), associated_data);
+  if (!status.ok()) {
+    ClearFailedBatchOutputs(plaintexts, offsets);
+    return status;
+  }
+  int64_t max_size = 0;
+  for (absl::string_view ciphertext : ciphertexts) {
+    max_size += aead_->MaxDecryptionSize(ciphertext.size());
+  }
+  subtle::ResizeStringUninitialized(plaintexts, max_size);
+  offsets->resize(ciphertexts.size() + 1);
+  (*offsets)[0] = 0;
+  for (int64_t i = 0; i < ciphertexts.size(); ++i) {
+    util::StatusOr<int64_t> written_bytes = aead_->Decrypt(
+        ciphertexts[i], BatchAssociatedData(associated_data, i),
+        absl::MakeSpan(*plaintexts)
+            .subspan((*offsets)[i],
+                     aead_->MaxDecryptionSize(ciphertexts[i].size())));
+    if (!written_bytes.ok()) {
+      ClearFailedBatchOutputs(plaintexts, offsets);
+      return written_bytes.status();
+    }
+    (*offsets)[i + 1] = (*offsets)[i] + *written_bytes;
+  }
+  plaintexts->resize(offsets->back());
+  return util::OkStatus();
+}
+
 }  // namespace internal
 }  // namespace tink
 }  // namespace crypto
@@ -16,12 +16,16 @@
 #ifndef TINK_AEAD_INTERNAL_AEAD_FROM_ZERO_COPY_H_
 #define TINK_AEAD_INTERNAL_AEAD_FROM_ZERO_COPY_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/aead.h"
 #include "tink/aead/internal/zero_copy_aead.h"
 #include "tink/subtle/subtle_util.h"
@@ -50,6 +54,19 @@ class AeadFromZeroCopy : public Aead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const override;
 
+  // Batch variants encrypt/decrypt each element directly into `ciphertexts`
+  // (resp. `plaintexts`) through the zero-copy AEAD.
+  crypto::tink::util::Status EncryptBatchWithPrefix(
+      absl::string_view output_prefix,
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* ciphertexts, std::vector<int64_t>* offsets) const override;
+
+  crypto::tink::util::Status DecryptBatch(
+      absl::Span<const absl::string_view> ciphertexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* plaintexts, std::vector<int64_t>* offsets) const override;
+
  private:
   const std::unique_ptr<ZeroCopyAead> aead_;
 };
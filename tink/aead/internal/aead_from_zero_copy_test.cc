@@ -15,15 +15,18 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "tink/aead/internal/aead_from_zero_copy.h"
 
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "tink/aead/internal/mock_zero_copy_aead.h"
@@ -44,6 +47,7 @@ using ::crypto::tink::test::StatusIs;
 using ::crypto::tink::util::Status;
 using ::crypto::tink::util::StatusOr;
 using ::testing::_;
+using ::testing::ElementsAre;
 using ::testing::Invoke;
 using ::testing::Return;
 using ::testing::Unused;
@@ -104,6 +108,47 @@ TEST(AeadFromZeroCopyTest, EncryptFailsIfZeroCopyDecryptFails) {
               StatusIs(absl::StatusCode::kInternal));
 }
 
+TEST(AeadFromZeroCopyTest, EncryptBatchWritesIntoSingleBuffer) {
+  auto mock_zero_copy_aead = std::make_unique<MockZeroCopyAead>();
+  EXPECT_CALL(*mock_zero_copy_aead, MaxEncryptionSize(kPlaintext.size()))
+      .WillRepeatedly(Return(kCiphertext.size()));
+  EXPECT_CALL(*mock_zero_copy_aead, Encrypt(kPlaintext, kAssociatedData, _))
+      .Times(2)
+      .WillRepeatedly(Invoke([&](Unused, Unused, absl::Span<char> buffer) {
+        memcpy(buffer.data(), kCiphertext.data(), kCiphertext.size());
+        return kCiphertext.size();
+      }));
+
+  AeadFromZeroCopy aead(std::move(mock_zero_copy_aead));
+  std::vector<absl::string_view> plaintexts = {kPlaintext, kPlaintext};
+  std::vector<absl::string_view> associated_data = {kAssociatedData};
+  std::string ciphertexts;
+  std::vector<int64_t> offsets;
+  ASSERT_THAT(aead.EncryptBatch(plaintexts, associated_data, &ciphertexts,
+                                &offsets),
+              IsOk());
+  EXPECT_EQ(ciphertexts, absl::StrCat(kCiphertext, kCiphertext));
+  EXPECT_THAT(offsets,
+              ElementsAre(0, kCiphertext.size(), 2 * kCiphertext.size()));
+}
+
+TEST(AeadFromZeroCopyTest, DecryptBatchFailsIfZeroCopyDecryptFails) {
+  auto mock_zero_copy_aead = std::make_unique<MockZeroCopyAead>();
+  EXPECT_CALL(*mock_zero_copy_aead, MaxDecryptionSize(kCiphertext.size()))
+      .WillRepeatedly(Return(kPlaintext.size()));
+  EXPECT_CALL(*mock_zero_copy_aead, Decrypt(kCiphertext, kAssociatedData, _))
+      .WillOnce(
+          Return(Status(absl::StatusCode::kInternal, "Some error happened!")));
+  AeadFromZeroCopy aead(std::move(mock_zero_copy_aead));
+  std::vector<absl::string_view> ciphertexts = {kCiphertext, kCiphertext};
+  std::vector<absl::string_view> associated_data = {kAssociatedData};
+  std::string plaintexts;
+  std::vector<int64_t> offsets;
+  EXPECT_THAT(aead.DecryptBatch(ciphertexts, associated_data, &plaintexts,
+                                &offsets),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
 }  // namespace
 }  // namespace internal
 }  // namespace tink
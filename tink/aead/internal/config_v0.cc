@@ -23,6 +23,7 @@
 #include "tink/aead/aes_gcm_key_manager.h"
 #include "tink/aead/aes_gcm_siv_key_manager.h"
 #include "tink/aead/xchacha20_poly1305_key_manager.h"
+#include "tink/aead/zero_copy_aead_wrapper.h"
 #include "tink/configuration.h"
 #include "tink/internal/configuration_impl.h"
 #include "tink/util/status.h"
@@ -37,6 +38,11 @@ util::Status AddAeadV0(Configuration& config) {
   if (!status.ok()) {
     return status;
   }
+  status = ConfigurationImpl::AddPrimitiveWrapper(
+      absl::make_unique<crypto::tink::ZeroCopyAeadWrapper>(), config);
+  if (!status.ok()) {
+    return status;
+  }
 
   status = ConfigurationImpl::AddKeyTypeManager(
       absl::make_unique<AesCtrHmacAeadKeyManager>(), config);
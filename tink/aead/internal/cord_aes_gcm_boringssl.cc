@@ -162,7 +162,7 @@ util::StatusOr<std::unique_ptr<CordAead>> CordAesGcmBoringSsl::New(
 
 util::StatusOr<absl::Cord> CordAesGcmBoringSsl::Encrypt(
     absl::Cord plaintext, absl::Cord associated_data) const {
-  std::string iv = subtle::Random::GetRandomBytes(kIvSizeInBytes);
+  std::string iv = subtle::Random::GetRandomNonceBytes(kIvSizeInBytes);
 
 #if defined(OPENSSL_IS_BORINGSSL) || OPENSSL_VERSION_NUMBER < 0x30000000L
   util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> context =
@@ -21,6 +21,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/cleanup/cleanup.h"
 #include "absl/memory/memory.h"
@@ -31,9 +32,12 @@
 #include "openssl/crypto.h"
 #include "openssl/evp.h"
 #include "tink/aead/internal/aead_util.h"
+#include "tink/internal/batch_util.h"
 #include "tink/internal/err_util.h"
 #include "tink/internal/ssl_unique_ptr.h"
 #include "tink/internal/util.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -80,16 +84,119 @@ util::StatusOr<int64_t> UpdateCipher(EVP_CIPHER_CTX *context,
   return total_written_bytes;
 }
 
+// SslOneShotAead implementation for OpenSSL's EVP_CIPHER interface.
+//
+// The key schedule (and, for GCM, the GHASH table) is expanded once in New()
+// into an encryption and a decryption template context. Each call only copies
+// the matching template, which avoids re-running the key setup per message.
+// The templates are never modified after construction, so copying them from
+// multiple threads concurrently is safe.
 class OpenSslOneShotAeadImpl : public SslOneShotAead {
  public:
-  explicit OpenSslOneShotAeadImpl(const util::SecretData &key,
-                                  const EVP_CIPHER *cipher, size_t tag_size)
-      : key_(key), cipher_(cipher), tag_size_(tag_size) {}
+  static util::StatusOr<std::unique_ptr<OpenSslOneShotAeadImpl>> New(
+      const util::SecretData &key, const EVP_CIPHER *cipher,
+      size_t tag_size) {
+    util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> encryption_context =
+        NewKeyedContext(key, cipher, /*encryption=*/true);
+    if (!encryption_context.ok()) {
+      return encryption_context.status();
+    }
+    util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> decryption_context =
+        NewKeyedContext(key, cipher, /*encryption=*/false);
+    if (!decryption_context.ok()) {
+      return decryption_context.status();
+    }
+    return {absl::WrapUnique(new OpenSslOneShotAeadImpl(
+        *std::move(encryption_context), *std::move(decryption_context),
+        tag_size))};
+  }
 
   util::StatusOr<int64_t> Encrypt(absl::string_view plaintext,
                                   absl::string_view associated_data,
                                   absl::string_view iv,
                                   absl::Span<char> out) const override {
+    util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> context =
+        NewContext(/*encryption=*/true);
+    if (!context.ok()) {
+      return context.status();
+    }
+    return EncryptWithContext(context->get(), plaintext, associated_data, iv,
+                              out);
+  }
+
+  // Keys a single cipher context for the whole batch, so that the key
+  // schedule is computed once rather than for each message.
+  util::Status EncryptBatch(absl::Span<const BatchEntry> batch) const override {
+    if (batch.empty()) {
+      return util::OkStatus();
+    }
+    util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> context =
+        NewContext(/*encryption=*/true);
+    if (!context.ok()) {
+      return context.status();
+    }
+    for (const BatchEntry &entry : batch) {
+      util::StatusOr<int64_t> written_bytes =
+          EncryptWithContext(context->get(), entry.input, entry.associated_data,
+                             entry.iv, entry.out);
+      if (!written_bytes.ok()) {
+        return written_bytes.status();
+      }
+    }
+    return util::OkStatus();
+  }
+
+  util::StatusOr<int64_t> Decrypt(absl::string_view ciphertext,
+                                  absl::string_view associated_data,
+                                  absl::string_view iv,
+                                  absl::Span<char> out) const override {
+    util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> context =
+        NewContext(/*encryption=*/false);
+    if (!context.ok()) {
+      return context.status();
+    }
+    return DecryptWithContext(context->get(), ciphertext, associated_data, iv,
+                              out);
+  }
+
+  util::Status DecryptBatch(absl::Span<const BatchEntry> batch) const override {
+    if (batch.empty()) {
+      return util::OkStatus();
+    }
+    util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> context =
+        NewContext(/*encryption=*/false);
+    if (!context.ok()) {
+      return context.status();
+    }
+    for (const BatchEntry &entry : batch) {
+      util::StatusOr<int64_t> written_bytes =
+          DecryptWithContext(context->get(), entry.input, entry.associated_data,
+                             entry.iv, entry.out);
+      if (!written_bytes.ok()) {
+        return written_bytes.status();
+      }
+    }
+    return util::OkStatus();
+  }
+
+  int64_t CiphertextSize(int64_t plaintext_length) const override {
+    return plaintext_length + tag_size_;
+  }
+
+  int64_t PlaintextSize(int64_t ciphertext_length) const override {
+    if (ciphertext_length < tag_size_) {
+      return 0;
+    }
+    return ciphertext_length - tag_size_;
+  }
+
+ private:
+  // Encrypts `plaintext` with `context`, which must be keyed for encryption.
+  util::StatusOr<int64_t> EncryptWithContext(EVP_CIPHER_CTX *context,
+                                             absl::string_view plaintext,
+                                             absl::string_view associated_data,
+                                             absl::string_view iv,
+                                             absl::Span<char> out) const {
     absl::string_view plaintext_data = internal::EnsureStringNonNull(plaintext);
     absl::string_view ad = internal::EnsureStringNonNull(associated_data);
 
@@ -101,9 +208,11 @@ class OpenSslOneShotAeadImpl : public SslOneShotAead {
                        min_out_buff_size, " bytes, got ", out.size()));
     }
 
-    if (BuffersOverlap(plaintext, absl::string_view(out.data(), out.size()))) {
-      return util::Status(absl::StatusCode::kInvalidArgument,
-                          "Plaintext and output buffer must not overlap");
+    if (BuffersPartiallyOverlap(plaintext,
+                                absl::string_view(out.data(), out.size()))) {
+      return util::Status(
+          absl::StatusCode::kInvalidArgument,
+          "Plaintext and output buffer must not overlap unless in place");
     }
 
     if (associated_data.size() > std::numeric_limits<int>::max()) {
@@ -114,15 +223,14 @@ class OpenSslOneShotAeadImpl : public SslOneShotAead {
                        associated_data.size()));
     }
 
-    util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> context =
-        GetContext(iv, /*encryption=*/true);
-    if (!context.ok()) {
-      return context.status();
+    util::Status status = SetIv(context, iv, /*encryption=*/true);
+    if (!status.ok()) {
+      return status;
     }
 
     // Set the associated data.
     int len = 0;
-    if (EVP_EncryptUpdate(context->get(), /*out=*/nullptr, &len,
+    if (EVP_EncryptUpdate(context, /*out=*/nullptr, &len,
                           reinterpret_cast<const uint8_t *>(ad.data()),
                           ad.size()) <= 0) {
       return util::Status(absl::StatusCode::kInternal,
@@ -130,28 +238,30 @@ class OpenSslOneShotAeadImpl : public SslOneShotAead {
     }
 
     util::StatusOr<int64_t> raw_ciphertext_bytes =
-        UpdateCipher(context->get(), plaintext_data, out);
+        UpdateCipher(context, plaintext_data, out);
     if (!raw_ciphertext_bytes.ok()) {
       return raw_ciphertext_bytes.status();
     }
 
-    if (EVP_EncryptFinal_ex(context->get(), /*out=*/nullptr, &len) <= 0) {
+    if (EVP_EncryptFinal_ex(context, /*out=*/nullptr, &len) <= 0) {
       return util::Status(absl::StatusCode::kInternal, "Finalization failed");
     }
 
     // Write the tag after the ciphertext.
     absl::Span<char> tag = out.subspan(*raw_ciphertext_bytes, tag_size_);
-    if (EVP_CIPHER_CTX_ctrl(context->get(), EVP_CTRL_AEAD_GET_TAG, tag_size_,
+    if (EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_AEAD_GET_TAG, tag_size_,
                             reinterpret_cast<uint8_t *>(tag.data())) <= 0) {
       return util::Status(absl::StatusCode::kInternal, "Failed to get the tag");
     }
     return *raw_ciphertext_bytes + tag_size_;
   }
 
-  util::StatusOr<int64_t> Decrypt(absl::string_view ciphertext,
-                                  absl::string_view associated_data,
-                                  absl::string_view iv,
-                                  absl::Span<char> out) const override {
+  // Decrypts `ciphertext` with `context`, which must be keyed for decryption.
+  util::StatusOr<int64_t> DecryptWithContext(EVP_CIPHER_CTX *context,
+                                             absl::string_view ciphertext,
+                                             absl::string_view associated_data,
+                                             absl::string_view iv,
+                                             absl::Span<char> out) const {
     absl::string_view ad = internal::EnsureStringNonNull(associated_data);
 
     if (ciphertext.size() < tag_size_) {
@@ -169,9 +279,11 @@ class OpenSslOneShotAeadImpl : public SslOneShotAead {
                        min_out_buff_size, " got ", out.size()));
     }
 
-    if (BuffersOverlap(ciphertext, absl::string_view(out.data(), out.size()))) {
-      return util::Status(absl::StatusCode::kInvalidArgument,
-                          "Ciphertext and output buffer must not overlap");
+    if (BuffersPartiallyOverlap(ciphertext,
+                                absl::string_view(out.data(), out.size()))) {
+      return util::Status(
+          absl::StatusCode::kInvalidArgument,
+          "Ciphertext and output buffer must not overlap unless in place");
     }
 
     if (associated_data.size() > std::numeric_limits<int>::max()) {
@@ -182,15 +294,14 @@ class OpenSslOneShotAeadImpl : public SslOneShotAead {
                        associated_data.size()));
     }
 
-    util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> context =
-        GetContext(iv, /*encryption=*/false);
-    if (!context.ok()) {
-      return context.status();
+    util::Status status = SetIv(context, iv, /*encryption=*/false);
+    if (!status.ok()) {
+      return status;
     }
 
     int len = 0;
     // Add the associated data.
-    if (EVP_DecryptUpdate(context->get(), /*out=*/nullptr, &len,
+    if (EVP_DecryptUpdate(context, /*out=*/nullptr, &len,
                           reinterpret_cast<const uint8_t *>(ad.data()),
                           ad.size()) <= 0) {
       return util::Status(absl::StatusCode::kInternal,
@@ -207,7 +318,7 @@ class OpenSslOneShotAeadImpl : public SslOneShotAead {
     auto tag = std::string(ciphertext.substr(raw_ciphertext_size, tag_size_));
 
     // Set the tag.
-    if (EVP_CIPHER_CTX_ctrl(context->get(), EVP_CTRL_AEAD_SET_TAG, tag_size_,
+    if (EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_AEAD_SET_TAG, tag_size_,
                             reinterpret_cast<uint8_t *>(&tag[0])) <= 0) {
       return util::Status(absl::StatusCode::kInternal,
                           "Could not set authentication tag");
@@ -228,12 +339,12 @@ class OpenSslOneShotAeadImpl : public SslOneShotAead {
         absl::MakeCleanup([out] { OPENSSL_cleanse(out.data(), out.size()); });
 
     util::StatusOr<int64_t> written_bytes =
-        UpdateCipher(context->get(), raw_ciphertext, out_buffer);
+        UpdateCipher(context, raw_ciphertext, out_buffer);
     if (!written_bytes.ok()) {
       return written_bytes.status();
     }
 
-    if (!EVP_DecryptFinal_ex(context->get(), /*out=*/nullptr, &len)) {
+    if (!EVP_DecryptFinal_ex(context, /*out=*/nullptr, &len)) {
       return util::Status(absl::StatusCode::kInternal, "Authentication failed");
     }
 
@@ -242,58 +353,79 @@ class OpenSslOneShotAeadImpl : public SslOneShotAead {
     return *written_bytes;
   }
 
-  int64_t CiphertextSize(int64_t plaintext_length) const override {
-    return plaintext_length + tag_size_;
-  }
-
-  int64_t PlaintextSize(int64_t ciphertext_length) const override {
-    if (ciphertext_length < tag_size_) {
-      return 0;
+  OpenSslOneShotAeadImpl(
+      internal::SslUniquePtr<EVP_CIPHER_CTX> encryption_template,
+      internal::SslUniquePtr<EVP_CIPHER_CTX> decryption_template,
+      size_t tag_size)
+      : encryption_template_(std::move(encryption_template)),
+        decryption_template_(std::move(decryption_template)),
+        tag_size_(tag_size) {}
+
+  // Returns a new EVP_CIPHER_CTX for `cipher` keyed with `key` for encryption
+  // (`encryption` == true) or decryption (`encryption` == false). The IV is
+  // set per message with SetIv().
+  static util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>>
+  NewKeyedContext(const util::SecretData &key, const EVP_CIPHER *cipher,
+                  bool encryption) {
+    internal::SslUniquePtr<EVP_CIPHER_CTX> context(EVP_CIPHER_CTX_new());
+    if (context == nullptr) {
+      return util::Status(absl::StatusCode::kInternal,
+                          "EVP_CIPHER_CTX_new failed");
     }
-    return ciphertext_length - tag_size_;
+    if (EVP_CipherInit_ex(context.get(), cipher, /*impl=*/nullptr,
+                          reinterpret_cast<const uint8_t *>(key.data()),
+                          /*iv=*/nullptr, encryption ? 1 : 0) <= 0) {
+      return util::Status(
+          absl::StatusCode::kInternal,
+          absl::StrCat("Failed to set key of size ", key.size(), " for ",
+                       encryption ? "encryption" : "decryption"));
+    }
+    return std::move(context);
   }
 
- private:
-  // Returns a new EVP_CIPHER_CTX for encryption (`ecryption` == true) or
-  // decryption (`encryption` == false).
-  util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> GetContext(
-      absl::string_view iv, bool encryption) const {
+  // Returns a copy of the encryption (`encryption` == true) or decryption
+  // (`encryption` == false) template context, ready for SetIv().
+  util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> NewContext(
+      bool encryption) const {
     internal::SslUniquePtr<EVP_CIPHER_CTX> context(EVP_CIPHER_CTX_new());
     if (context == nullptr) {
       return util::Status(absl::StatusCode::kInternal,
                           "EVP_CIPHER_CTX_new failed");
     }
-    const int encryption_flag = encryption ? 1 : 0;
-    if (EVP_CipherInit_ex(context.get(), cipher_, /*impl=*/nullptr,
-                          /*key=*/nullptr, /*iv=*/nullptr,
-                          encryption_flag) <= 0) {
+    const EVP_CIPHER_CTX *template_context =
+        encryption ? encryption_template_.get() : decryption_template_.get();
+    if (EVP_CIPHER_CTX_copy(context.get(), template_context) <= 0) {
       return util::Status(
           absl::StatusCode::kInternal,
-          absl::StrCat("Failed initializializing context for ",
-                       encryption ? "encryption" : "decryption"));
+          absl::StrCat("EVP_CIPHER_CTX_copy failed: ",
+                       internal::GetSslErrors()));
     }
+    return std::move(context);
+  }
+
+  // Starts a new message on `context` with `iv`, keeping the key.
+  static util::Status SetIv(EVP_CIPHER_CTX *context, absl::string_view iv,
+                            bool encryption) {
     // Set the size for IV first, then set the IV bytes.
-    if (EVP_CIPHER_CTX_ctrl(context.get(), EVP_CTRL_AEAD_SET_IVLEN, iv.size(),
+    if (EVP_CIPHER_CTX_ctrl(context, EVP_CTRL_AEAD_SET_IVLEN, iv.size(),
                             /*ptr=*/nullptr) <= 0) {
       return util::Status(
           absl::StatusCode::kInternal,
           absl::StrCat("Failed stting size of the IV to ", iv.size()));
     }
-    if (EVP_CipherInit_ex(context.get(), /*cipher=*/nullptr, /*impl=*/nullptr,
-                          reinterpret_cast<const uint8_t *>(key_.data()),
+    if (EVP_CipherInit_ex(context, /*cipher=*/nullptr, /*impl=*/nullptr,
+                          /*key=*/nullptr,
                           reinterpret_cast<const uint8_t *>(iv.data()),
-                          encryption_flag) <= 0) {
+                          encryption ? 1 : 0) <= 0) {
       return util::Status(
           absl::StatusCode::kInternal,
-          absl::StrCat("Failed to set key of size ", key_.size(),
-                       "and IV of size ", iv.size()));
+          absl::StrCat("Failed to set IV of size ", iv.size()));
     }
-
-    return std::move(context);
+    return util::OkStatus();
   }
 
-  const util::SecretData key_;
-  const EVP_CIPHER *cipher_;
+  const internal::SslUniquePtr<EVP_CIPHER_CTX> encryption_template_;
+  const internal::SslUniquePtr<EVP_CIPHER_CTX> decryption_template_;
   const size_t tag_size_;
 };
 
@@ -318,9 +450,11 @@ class BoringSslOneShotAeadImpl : public SslOneShotAead {
     associated_data = internal::EnsureStringNonNull(associated_data);
     iv = internal::EnsureStringNonNull(iv);
 
-    if (BuffersOverlap(plaintext, absl::string_view(out.data(), out.size()))) {
-      return util::Status(absl::StatusCode::kInvalidArgument,
-                          "Plaintext and output buffer must not overlap");
+    if (BuffersPartiallyOverlap(plaintext,
+                                absl::string_view(out.data(), out.size()))) {
+      return util::Status(
+          absl::StatusCode::kInvalidArgument,
+          "Plaintext and output buffer must not overlap unless in place");
     }
 
     const int64_t min_out_buff_size = CiphertextSize(plaintext.size());
@@ -354,9 +488,11 @@ class BoringSslOneShotAeadImpl : public SslOneShotAead {
     associated_data = internal::EnsureStringNonNull(associated_data);
     iv = internal::EnsureStringNonNull(iv);
 
-    if (BuffersOverlap(ciphertext, absl::string_view(out.data(), out.size()))) {
-      return util::Status(absl::StatusCode::kInvalidArgument,
-                          "Ciphertext and output buffer must not overlap");
+    if (BuffersPartiallyOverlap(ciphertext,
+                                absl::string_view(out.data(), out.size()))) {
+      return util::Status(
+          absl::StatusCode::kInvalidArgument,
+          "Ciphertext and output buffer must not overlap unless in place");
     }
 
     if (ciphertext.size() < tag_size_) {
@@ -419,6 +555,30 @@ class BoringSslOneShotAeadImpl : public SslOneShotAead {
 
 }  // namespace
 
+util::Status SslOneShotAead::EncryptBatch(
+    absl::Span<const BatchEntry> batch) const {
+  for (const BatchEntry &entry : batch) {
+    util::StatusOr<int64_t> written_bytes =
+        Encrypt(entry.input, entry.associated_data, entry.iv, entry.out);
+    if (!written_bytes.ok()) {
+      return written_bytes.status();
+    }
+  }
+  return util::OkStatus();
+}
+
+util::Status SslOneShotAead::DecryptBatch(
+    absl::Span<const BatchEntry> batch) const {
+  for (const BatchEntry &entry : batch) {
+    util::StatusOr<int64_t> written_bytes =
+        Decrypt(entry.input, entry.associated_data, entry.iv, entry.out);
+    if (!written_bytes.ok()) {
+      return written_bytes.status();
+    }
+  }
+  return util::OkStatus();
+}
+
 util::StatusOr<std::unique_ptr<SslOneShotAead>> CreateAesGcmOneShotCrypter(
     const util::SecretData &key) {
 #ifdef OPENSSL_IS_BORINGSSL
@@ -444,8 +604,12 @@ util::StatusOr<std::unique_ptr<SslOneShotAead>> CreateAesGcmOneShotCrypter(
     return aead_cipher.status();
   }
 
-  return absl::make_unique<OpenSslOneShotAeadImpl>(key, *aead_cipher,
-                                                   kAesGcmTagSizeInBytes);
+  util::StatusOr<std::unique_ptr<OpenSslOneShotAeadImpl>> aead =
+      OpenSslOneShotAeadImpl::New(key, *aead_cipher, kAesGcmTagSizeInBytes);
+  if (!aead.ok()) {
+    return aead.status();
+  }
+  return {*std::move(aead)};
 #endif
 }
 
@@ -498,6 +662,135 @@ CreateXchacha20Poly1305OneShotCrypter(const util::SecretData &key) {
 #endif
 }
 
+util::Status ValidateEncryptionBuffersWithPrefixIv(absl::string_view plaintext,
+                                                   absl::Span<char> buffer,
+                                                   int iv_size) {
+  absl::string_view buffer_string(buffer.data(), buffer.size());
+  const size_t iv_end = std::min<size_t>(iv_size, buffer_string.size());
+  if (BuffersOverlap(plaintext, buffer_string.substr(0, iv_end)) ||
+      BuffersPartiallyOverlap(plaintext, buffer_string.substr(iv_end))) {
+    return util::Status(absl::StatusCode::kFailedPrecondition,
+                        "Plaintext and ciphertext buffers overlap; only "
+                        "in-place encryption is allowed");
+  }
+  return util::OkStatus();
+}
+
+util::Status ValidateDecryptionBuffersWithPrefixIv(absl::string_view ciphertext,
+                                                   absl::Span<char> buffer,
+                                                   int iv_size) {
+  absl::string_view buffer_string(buffer.data(), buffer.size());
+  const size_t iv_end = std::min<size_t>(iv_size, ciphertext.size());
+  if (BuffersOverlap(ciphertext.substr(0, iv_end), buffer_string) ||
+      BuffersPartiallyOverlap(ciphertext.substr(iv_end), buffer_string)) {
+    return util::Status(absl::StatusCode::kFailedPrecondition,
+                        "Plaintext and ciphertext buffers overlap; only "
+                        "in-place decryption is allowed");
+  }
+  return util::OkStatus();
+}
+
+util::Status EncryptBatchWithRandomIv(
+    const SslOneShotAead &aead, int iv_size,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    absl::string_view output_prefix, std::string *ciphertexts,
+    std::vector<int64_t> *offsets) {
+  std::string ivs;
+  subtle::ResizeStringUninitialized(&ivs, plaintexts.size() * iv_size);
+  util::Status status =
+      subtle::Random::GetRandomNonceBytes(absl::MakeSpan(ivs));
+  if (!status.ok()) {
+    return status;
+  }
+  return EncryptBatchWithPrefixIv(aead, iv_size, ivs, plaintexts,
+                                  associated_data, output_prefix, ciphertexts,
+                                  offsets);
+}
+
+util::Status EncryptBatchWithPrefixIv(
+    const SslOneShotAead &aead, int iv_size, absl::string_view ivs,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    absl::string_view output_prefix, std::string *ciphertexts,
+    std::vector<int64_t> *offsets) {
+  if (ivs.size() != plaintexts.size() * iv_size) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        absl::StrCat("Expected ", plaintexts.size(),
+                                     " IVs of ", iv_size, " bytes, got ",
+                                     ivs.size(), " bytes"));
+  }
+  util::Status status =
+      ValidateBatchAssociatedData(plaintexts.size(), associated_data);
+  if (!status.ok()) {
+    return status;
+  }
+  offsets->resize(plaintexts.size() + 1);
+  (*offsets)[0] = 0;
+  for (int64_t i = 0; i < plaintexts.size(); ++i) {
+    (*offsets)[i + 1] = (*offsets)[i] + output_prefix.size() + iv_size +
+                        aead.CiphertextSize(plaintexts[i].size());
+  }
+  subtle::ResizeStringUninitialized(ciphertexts, offsets->back());
+
+  // Each ciphertext is written after the space reserved for its prefix.
+  std::vector<SslOneShotAead::BatchEntry> batch(plaintexts.size());
+  for (int64_t i = 0; i < plaintexts.size(); ++i) {
+    absl::Span<char> out = absl::MakeSpan(*ciphertexts).subspan(
+        (*offsets)[i], (*offsets)[i + 1] - (*offsets)[i]);
+    std::copy(output_prefix.begin(), output_prefix.end(), out.data());
+    out = out.subspan(output_prefix.size());
+    std::copy_n(ivs.data() + i * iv_size, iv_size, out.data());
+    batch[i].input = plaintexts[i];
+    batch[i].associated_data = BatchAssociatedData(associated_data, i);
+    batch[i].iv = absl::string_view(out.data(), iv_size);
+    batch[i].out = out.subspan(iv_size);
+  }
+  return aead.EncryptBatch(batch);
+}
+
+util::Status DecryptBatchWithPrefixIv(
+    const SslOneShotAead &aead, int iv_size, int tag_size,
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string *plaintexts, std::vector<int64_t> *offsets) {
+  util::Status status =
+      ValidateBatchAssociatedData(ciphertexts.size(), associated_data);
+  if (!status.ok()) {
+    ClearFailedBatchOutputs(plaintexts, offsets);
+    return status;
+  }
+  offsets->resize(ciphertexts.size() + 1);
+  (*offsets)[0] = 0;
+  for (int64_t i = 0; i < ciphertexts.size(); ++i) {
+    if (ciphertexts[i].size() < iv_size + tag_size) {
+      ClearFailedBatchOutputs(plaintexts, offsets);
+      return util::Status(
+          absl::StatusCode::kInvalidArgument,
+          absl::StrCat("Ciphertext ", i, " too short; expected at least ",
+                       iv_size + tag_size, " got ", ciphertexts[i].size()));
+    }
+    (*offsets)[i + 1] =
+        (*offsets)[i] + aead.PlaintextSize(ciphertexts[i].size() - iv_size);
+  }
+  subtle::ResizeStringUninitialized(plaintexts, offsets->back());
+
+  std::vector<SslOneShotAead::BatchEntry> batch(ciphertexts.size());
+  for (int64_t i = 0; i < ciphertexts.size(); ++i) {
+    batch[i].input = ciphertexts[i].substr(iv_size);
+    batch[i].associated_data = BatchAssociatedData(associated_data, i);
+    batch[i].iv = ciphertexts[i].substr(0, iv_size);
+    batch[i].out = absl::MakeSpan(*plaintexts).subspan(
+        (*offsets)[i], (*offsets)[i + 1] - (*offsets)[i]);
+  }
+  // The messages before a failing one have already been decrypted.
+  status = aead.DecryptBatch(batch);
+  if (!status.ok()) {
+    ClearFailedBatchOutputs(plaintexts, offsets);
+  }
+  return status;
+}
+
 }  // namespace internal
 }  // namespace tink
 }  // namespace crypto
@@ -18,10 +18,13 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "tink/util/secret_data.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -44,8 +47,9 @@ class SslOneShotAead {
   // Encrypts `plaintext` with `associated_data` and `iv`, and writes the output
   // to `out`. The implementation places both the raw ciphertext and the
   // resulting tag in `out`, so the caller must make sure it has sufficient
-  // capacity. There should be no overlap between `plaintext` and `out`. In
-  // particular, in-place encryption is not supported.
+  // capacity. Encryption may be done in place, that is, `plaintext` may start
+  // at `out.data()`; any other overlap between `plaintext` and `out` is an
+  // error.
   virtual util::StatusOr<int64_t> Encrypt(absl::string_view plaintext,
                                           absl::string_view associated_data,
                                           absl::string_view iv,
@@ -57,12 +61,37 @@ class SslOneShotAead {
 
   // Decrypts `ciphertext` with `associated_data` and `iv`, and writes the
   // plaintext to `out`. `ciphertext` contains the raw ciphertext and the tag.
-  // There should be no overlap between `ciphertext` and `out`. In particular,
-  // in-place decryption is not supported.
+  // Decryption may be done in place, that is, `ciphertext` may start at
+  // `out.data()`; any other overlap between `ciphertext` and `out` is an
+  // error. If decryption fails the contents of `out`, and thus of an in-place
+  // `ciphertext`, are unspecified.
   virtual util::StatusOr<int64_t> Decrypt(absl::string_view ciphertext,
                                           absl::string_view associated_data,
                                           absl::string_view iv,
                                           absl::Span<char> out) const = 0;
+
+  // A message of a batch; see EncryptBatch() and DecryptBatch().
+  struct BatchEntry {
+    absl::string_view input;
+    absl::string_view associated_data;
+    absl::string_view iv;
+    absl::Span<char> out;
+  };
+
+  // Encrypts the `input` of each entry of `batch` as Encrypt() does. All IVs
+  // must have the same size. Implementations may set up the cipher once for
+  // the whole batch, which pays off for many small messages. Fails if any
+  // encryption fails, in which case the contents of all outputs are
+  // unspecified.
+  //
+  // The default implementation calls Encrypt() for each entry.
+  virtual util::Status EncryptBatch(absl::Span<const BatchEntry> batch) const;
+
+  // Decrypts the `input` of each entry of `batch` as Decrypt() does, with the
+  // same requirements as EncryptBatch().
+  //
+  // The default implementation calls Decrypt() for each entry.
+  virtual util::Status DecryptBatch(absl::Span<const BatchEntry> batch) const;
 };
 
 // Create one-shot crypters for the supported algorithms.
@@ -73,6 +102,52 @@ util::StatusOr<std::unique_ptr<SslOneShotAead>> CreateAesGcmSivOneShotCrypter(
 util::StatusOr<std::unique_ptr<SslOneShotAead>>
 CreateXchacha20Poly1305OneShotCrypter(const util::SecretData &key);
 
+// Checks that `plaintext` can be encrypted into `buffer` as
+// `iv || raw ciphertext || tag`, with an IV of `iv_size` bytes. The buffers
+// must not overlap, unless encryption is in place: `plaintext` starts at
+// `buffer.data() + iv_size`, where the raw ciphertext is written.
+util::Status ValidateEncryptionBuffersWithPrefixIv(absl::string_view plaintext,
+                                                   absl::Span<char> buffer,
+                                                   int iv_size);
+
+// Checks that a `ciphertext` of the form `iv || raw ciphertext || tag`, with
+// an IV of `iv_size` bytes, can be decrypted into `buffer`. The buffers must
+// not overlap, unless decryption is in place: `buffer` starts at
+// `ciphertext.data() + iv_size`, where the raw ciphertext is read from.
+util::Status ValidateDecryptionBuffersWithPrefixIv(absl::string_view ciphertext,
+                                                   absl::Span<char> buffer,
+                                                   int iv_size);
+
+// Encrypts a batch of plaintexts with `aead` as specified by
+// Aead::EncryptBatchWithPrefix. Each ciphertext has the form
+// `output_prefix || iv || raw ciphertext || tag`, where `iv` is a fresh random
+// IV of `iv_size` bytes. The IVs of the whole batch are drawn from the random
+// number generator at once, and the messages are encrypted with a single call
+// to `aead.EncryptBatch()`.
+util::Status EncryptBatchWithRandomIv(
+    const SslOneShotAead &aead, int iv_size,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    absl::string_view output_prefix, std::string *ciphertexts,
+    std::vector<int64_t> *offsets);
+
+// Like EncryptBatchWithRandomIv, but the IV of the i-th message is the i-th
+// `iv_size`-byte chunk of `ivs`, which must hold one IV per plaintext.
+util::Status EncryptBatchWithPrefixIv(
+    const SslOneShotAead &aead, int iv_size, absl::string_view ivs,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    absl::string_view output_prefix, std::string *ciphertexts,
+    std::vector<int64_t> *offsets);
+
+// Decrypts a batch of ciphertexts of the form `iv || raw ciphertext || tag`
+// with `aead.DecryptBatch()` as specified by Aead::DecryptBatch.
+util::Status DecryptBatchWithPrefixIv(
+    const SslOneShotAead &aead, int iv_size, int tag_size,
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string *plaintexts, std::vector<int64_t> *offsets);
+
 }  // namespace internal
 }  // namespace tink
 }  // namespace crypto
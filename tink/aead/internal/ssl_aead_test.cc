@@ -22,6 +22,7 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <unordered_set>
 #include <vector>
 
@@ -49,6 +50,7 @@ namespace {
 using ::crypto::tink::test::IsOk;
 using ::crypto::tink::test::StatusIs;
 using ::testing::AllOf;
+using ::testing::Each;
 using ::testing::Eq;
 using ::testing::Not;
 using ::testing::TestParamInfo;
@@ -377,14 +379,15 @@ TEST_P(SslOneShotAeadTest, BufferOverlapEncryptFails) {
                              absl::HexStringToBytes(test_param.key_hex)));
   ASSERT_THAT(aead, IsOk());
 
-  std::string ciphertext_buffer(kMessage.data(), kMessage.size());
-  subtle::ResizeStringUninitialized(&ciphertext_buffer,
-                                    (*aead)->CiphertextSize(kMessage.size()));
+  // The plaintext starts one byte after the output buffer.
+  std::string ciphertext_buffer = absl::StrCat("x", kMessage);
+  subtle::ResizeStringUninitialized(
+      &ciphertext_buffer, (*aead)->CiphertextSize(kMessage.size()) + 1);
 
   EXPECT_THAT(
       (*aead)
           ->Encrypt(
-              absl::string_view(ciphertext_buffer).substr(0, kMessage.size()),
+              absl::string_view(ciphertext_buffer).substr(1, kMessage.size()),
               kAssociatedData, test_param.iv_hex,
               absl::MakeSpan(ciphertext_buffer))
           .status(),
@@ -406,15 +409,96 @@ TEST_P(SslOneShotAeadTest, BufferOverlapDecryptFails) {
   DoTestEncrypt(aead->get(), kMessage, kAssociatedData, test_param.tag_size, iv,
                 absl::MakeSpan(ciphertext_buffer));
 
+  // The output buffer starts one byte after the ciphertext.
   EXPECT_THAT(
       (*aead)
           ->Decrypt(
               ciphertext_buffer, kAssociatedData, iv,
-              absl::MakeSpan(ciphertext_buffer).subspan(0, kMessage.size()))
+              absl::MakeSpan(ciphertext_buffer).subspan(1, kMessage.size()))
           .status(),
       StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+TEST_P(SslOneShotAeadTest, InPlaceEncryptDecrypt) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  SslOneShotAeadTestParams test_param = GetParam();
+  util::StatusOr<std::unique_ptr<SslOneShotAead>> aead = CipherFromName(
+      test_param.cipher, util::SecretDataFromStringView(
+                             absl::HexStringToBytes(test_param.key_hex)));
+  ASSERT_THAT(aead, IsOk());
+  std::string iv = absl::HexStringToBytes(test_param.iv_hex);
+
+  std::string expected_ciphertext;
+  subtle::ResizeStringUninitialized(&expected_ciphertext,
+                                    (*aead)->CiphertextSize(kMessage.size()));
+  DoTestEncrypt(aead->get(), kMessage, kAssociatedData, test_param.tag_size, iv,
+                absl::MakeSpan(expected_ciphertext));
+
+  // Encrypt in place: the plaintext starts at the beginning of the output.
+  std::string buffer(kMessage);
+  subtle::ResizeStringUninitialized(&buffer,
+                                    (*aead)->CiphertextSize(kMessage.size()));
+  util::StatusOr<int64_t> written_bytes = (*aead)->Encrypt(
+      absl::string_view(buffer).substr(0, kMessage.size()), kAssociatedData,
+      iv, absl::MakeSpan(buffer));
+  ASSERT_THAT(written_bytes, IsOk());
+  EXPECT_EQ(*written_bytes, buffer.size());
+  EXPECT_EQ(buffer, expected_ciphertext);
+
+  // Decrypt in place: the plaintext overwrites the raw ciphertext.
+  written_bytes = (*aead)->Decrypt(buffer, kAssociatedData, iv,
+                                   absl::MakeSpan(buffer));
+  ASSERT_THAT(written_bytes, IsOk());
+  EXPECT_EQ(absl::string_view(buffer).substr(0, *written_bytes), kMessage);
+}
+
+TEST_P(SslOneShotAeadTest, BatchMatchesSingleMessages) {
+  SslOneShotAeadTestParams test_param = GetParam();
+  util::StatusOr<std::unique_ptr<SslOneShotAead>> aead = CipherFromName(
+      test_param.cipher, util::SecretDataFromStringView(
+                             absl::HexStringToBytes(test_param.key_hex)));
+  ASSERT_THAT(aead, IsOk());
+
+  const std::vector<std::string> messages = {"", "a", std::string(kMessage),
+                                             std::string(1000, 'x')};
+  std::vector<std::string> ivs;
+  std::vector<std::string> ciphertexts;
+  std::vector<SslOneShotAead::BatchEntry> batch;
+  for (int i = 0; i < messages.size(); ++i) {
+    // Distinct IVs, so that a context reused across messages is exercised.
+    ivs.push_back(absl::HexStringToBytes(test_param.iv_hex));
+    ivs.back().back() ^= i;
+    ciphertexts.emplace_back((*aead)->CiphertextSize(messages[i].size()), '\0');
+  }
+  for (int i = 0; i < messages.size(); ++i) {
+    batch.push_back({messages[i], kAssociatedData, ivs[i],
+                     absl::MakeSpan(ciphertexts[i])});
+  }
+  ASSERT_THAT((*aead)->EncryptBatch(batch), IsOk());
+  for (int i = 0; i < messages.size(); ++i) {
+    DoTestDecrypt(aead->get(), messages[i], kAssociatedData, ivs[i],
+                  ciphertexts[i]);
+  }
+
+  std::vector<std::string> plaintexts;
+  for (int i = 0; i < messages.size(); ++i) {
+    plaintexts.emplace_back(messages[i].size(), '\0');
+  }
+  for (int i = 0; i < messages.size(); ++i) {
+    batch[i] = {ciphertexts[i], kAssociatedData, ivs[i],
+                absl::MakeSpan(plaintexts[i])};
+  }
+  ASSERT_THAT((*aead)->DecryptBatch(batch), IsOk());
+  EXPECT_EQ(plaintexts, messages);
+
+  // A single modified ciphertext fails the whole batch.
+  std::string modified = ModifyString(ciphertexts[2], /*position=*/0);
+  batch[2].input = modified;
+  EXPECT_THAT((*aead)->DecryptBatch(batch), Not(IsOk()));
+}
+
 std::vector<SslOneShotAeadTestParams> GetSslOneShotAeadTestParams() {
   std::vector<SslOneShotAeadTestParams> params = {
       {/*test_name=*/"AesGcm256", /*cipher=*/CipherType::kAesGcm,
@@ -445,6 +529,56 @@ std::vector<SslOneShotAeadTestParams> GetSslOneShotAeadTestParams() {
   return params;
 }
 
+// Each call works on its own copy of the keyed state, so concurrent calls and
+// failed decryptions must not affect other calls.
+TEST_P(SslOneShotAeadTest, ConcurrentEncryptDecrypt) {
+  SslOneShotAeadTestParams test_param = GetParam();
+  util::StatusOr<std::unique_ptr<SslOneShotAead>> aead = CipherFromName(
+      test_param.cipher, util::SecretDataFromStringView(
+                             absl::HexStringToBytes(test_param.key_hex)));
+  ASSERT_THAT(aead, IsOk());
+  const std::string iv = absl::HexStringToBytes(test_param.iv_hex);
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumMessages = 50;
+  std::vector<int> failures(kNumThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t] {
+      const std::string message = absl::StrCat(kMessage, t);
+      std::string ciphertext((*aead)->CiphertextSize(message.size()), '\0');
+      std::string plaintext(message.size(), '\0');
+      for (int i = 0; i < kNumMessages; ++i) {
+        if (!(*aead)
+                 ->Encrypt(message, kAssociatedData, iv,
+                           absl::MakeSpan(ciphertext))
+                 .ok()) {
+          ++failures[t];
+          continue;
+        }
+        // Interleave failing decryptions with successful ones.
+        if ((*aead)
+                ->Decrypt(ModifyString(ciphertext, /*position=*/i),
+                          kAssociatedData, iv, absl::MakeSpan(plaintext))
+                .ok()) {
+          ++failures[t];
+        }
+        if (!(*aead)
+                 ->Decrypt(ciphertext, kAssociatedData, iv,
+                           absl::MakeSpan(plaintext))
+                 .ok() ||
+            plaintext != message) {
+          ++failures[t];
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_THAT(failures, Each(0));
+}
+
 INSTANTIATE_TEST_SUITE_P(
     SslOneShotAeadTests, SslOneShotAeadTest,
     testing::ValuesIn(GetSslOneShotAeadTestParams()),
@@ -0,0 +1,253 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/internal/x_aes_gcm_boringssl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/hash/hash.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "openssl/aes.h"
+#include "openssl/crypto.h"
+#include "tink/aead.h"
+#include "tink/aead/internal/ssl_aead.h"
+#include "tink/internal/fips_utils.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/subtle_util.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+namespace {
+
+constexpr int kKeySizeInBytes = 32;
+constexpr int kBlockSizeInBytes = 16;
+// Salts are zero-padded to this size for the key derivation.
+constexpr int kMaxSaltSizeInBytes = 12;
+constexpr int kMinSaltSizeInBytes = 8;
+constexpr int kIvSizeInBytes = 12;
+constexpr int kTagSizeInBytes = 16;
+
+// Doubling in GF(2^128), as used to compute CMAC subkeys.
+void MultiplyByX(uint8_t block[kBlockSizeInBytes]) {
+  const uint8_t carry = block[0] >> 7;
+  for (int i = 0; i < kBlockSizeInBytes - 1; ++i) {
+    block[i] = (block[i] << 1) | (block[i + 1] >> 7);
+  }
+  block[kBlockSizeInBytes - 1] =
+      (block[kBlockSizeInBytes - 1] << 1) ^ (carry ? 0x87 : 0);
+}
+
+}  // namespace
+
+constexpr int64_t XAesGcmBoringSsl::kMessagesPerSalt;
+constexpr int XAesGcmBoringSsl::kDerivedKeyCacheSize;
+
+util::StatusOr<std::unique_ptr<Aead>> XAesGcmBoringSsl::New(
+    const util::SecretData& key, int salt_size) {
+  util::Status status = CheckFipsCompatibility<XAesGcmBoringSsl>();
+  if (!status.ok()) {
+    return status;
+  }
+  if (key.size() != kKeySizeInBytes) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        absl::StrCat("Invalid key size; expected ",
+                                     kKeySizeInBytes, " bytes, got ",
+                                     key.size()));
+  }
+  if (salt_size < kMinSaltSizeInBytes || salt_size > kMaxSaltSizeInBytes) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Salt size should be between ", kMinSaltSizeInBytes,
+                     " and ", kMaxSaltSizeInBytes, " bytes, got ", salt_size));
+  }
+  util::SecretUniquePtr<AES_KEY> aes_key = util::MakeSecretUniquePtr<AES_KEY>();
+  if (AES_set_encrypt_key(key.data(), 8 * key.size(), aes_key.get()) != 0) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "could not initialize aes key");
+  }
+  util::SecretData cmac_k1(kBlockSizeInBytes, 0);
+  AES_encrypt(cmac_k1.data(), cmac_k1.data(), aes_key.get());
+  MultiplyByX(cmac_k1.data());
+  return {absl::WrapUnique(
+      new XAesGcmBoringSsl(std::move(aes_key), std::move(cmac_k1), salt_size))};
+}
+
+util::StatusOr<std::shared_ptr<const XAesGcmBoringSsl::DerivedAead>>
+XAesGcmBoringSsl::NewDerivedAead(absl::string_view salt) const {
+  // Each half of the derived key is AES(M_i xor K1), the CMAC of the single
+  // block M_i = 0x00 || i || 'X' || 0x00 || salt.
+  util::SecretData derived_key(kKeySizeInBytes);
+  uint8_t block[kBlockSizeInBytes];
+  for (int i = 0; i < 2; ++i) {
+    std::fill(std::begin(block), std::end(block), 0);
+    block[1] = i + 1;
+    block[2] = 'X';
+    std::copy(salt.begin(), salt.end(), block + 4);
+    for (int j = 0; j < kBlockSizeInBytes; ++j) {
+      block[j] ^= cmac_k1_[j];
+    }
+    AES_encrypt(block, derived_key.data() + i * kBlockSizeInBytes,
+                aes_key_.get());
+  }
+  OPENSSL_cleanse(block, sizeof(block));
+
+  util::StatusOr<std::unique_ptr<SslOneShotAead>> aead =
+      CreateAesGcmOneShotCrypter(derived_key);
+  if (!aead.ok()) {
+    return aead.status();
+  }
+  auto derived_aead = std::make_shared<DerivedAead>();
+  derived_aead->salt = std::string(salt);
+  derived_aead->aead = *std::move(aead);
+  return std::shared_ptr<const DerivedAead>(std::move(derived_aead));
+}
+
+std::shared_ptr<const XAesGcmBoringSsl::DerivedAead>&
+XAesGcmBoringSsl::CacheSlot(absl::string_view salt) const {
+  return cache_[absl::Hash<absl::string_view>()(salt) % kDerivedKeyCacheSize];
+}
+
+util::StatusOr<std::shared_ptr<const XAesGcmBoringSsl::DerivedAead>>
+XAesGcmBoringSsl::GetEncryptionAead() const {
+  std::shared_ptr<EncryptionState> state = std::atomic_load(&encryption_state_);
+  if (state != nullptr &&
+      state->uses.fetch_add(1, std::memory_order_relaxed) < kMessagesPerSalt) {
+    return state->derived_aead;
+  }
+  absl::MutexLock lock(&rotation_mutex_);
+  // Another thread may have drawn a new salt in the meantime.
+  std::shared_ptr<EncryptionState> current =
+      std::atomic_load(&encryption_state_);
+  if (current != state &&
+      current->uses.fetch_add(1, std::memory_order_relaxed) <
+          kMessagesPerSalt) {
+    return current->derived_aead;
+  }
+  std::string salt;
+  subtle::ResizeStringUninitialized(&salt, salt_size_);
+  util::Status status =
+      subtle::Random::GetRandomNonceBytes(absl::MakeSpan(salt));
+  if (!status.ok()) {
+    return status;
+  }
+  util::StatusOr<std::shared_ptr<const DerivedAead>> aead =
+      NewDerivedAead(salt);
+  if (!aead.ok()) {
+    return aead.status();
+  }
+  auto new_state = std::make_shared<EncryptionState>();
+  new_state->derived_aead = *std::move(aead);
+  new_state->uses.store(1, std::memory_order_relaxed);
+  std::atomic_store(&encryption_state_, new_state);
+  // Ciphertexts are often decrypted by the instance that encrypted them.
+  std::atomic_store(&CacheSlot(salt), new_state->derived_aead);
+  return new_state->derived_aead;
+}
+
+util::StatusOr<std::shared_ptr<const XAesGcmBoringSsl::DerivedAead>>
+XAesGcmBoringSsl::GetDecryptionAead(absl::string_view salt) const {
+  std::shared_ptr<const DerivedAead>& slot = CacheSlot(salt);
+  std::shared_ptr<const DerivedAead> cached = std::atomic_load(&slot);
+  if (cached != nullptr && cached->salt == salt) {
+    return cached;
+  }
+  util::StatusOr<std::shared_ptr<const DerivedAead>> aead =
+      NewDerivedAead(salt);
+  if (!aead.ok()) {
+    return aead.status();
+  }
+  std::atomic_store(&slot, *aead);
+  return aead;
+}
+
+util::StatusOr<std::string> XAesGcmBoringSsl::Encrypt(
+    absl::string_view plaintext, absl::string_view associated_data) const {
+  util::StatusOr<std::shared_ptr<const DerivedAead>> derived_aead =
+      GetEncryptionAead();
+  if (!derived_aead.ok()) {
+    return derived_aead.status();
+  }
+  const SslOneShotAead& aead = *(*derived_aead)->aead;
+  const int64_t prefix_size = salt_size_ + kIvSizeInBytes;
+  std::string ciphertext;
+  subtle::ResizeStringUninitialized(
+      &ciphertext, prefix_size + aead.CiphertextSize(plaintext.size()));
+  absl::Span<char> buffer = absl::MakeSpan(ciphertext);
+  const std::string& salt = (*derived_aead)->salt;
+  std::copy(salt.begin(), salt.end(), buffer.begin());
+  util::Status status = subtle::Random::GetRandomNonceBytes(
+      buffer.subspan(salt_size_, kIvSizeInBytes));
+  if (!status.ok()) {
+    return status;
+  }
+  absl::string_view iv(buffer.data() + salt_size_, kIvSizeInBytes);
+  util::StatusOr<int64_t> written_bytes = aead.Encrypt(
+      plaintext, associated_data, iv, buffer.subspan(prefix_size));
+  if (!written_bytes.ok()) {
+    return written_bytes.status();
+  }
+  return std::move(ciphertext);
+}
+
+util::StatusOr<std::string> XAesGcmBoringSsl::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data) const {
+  const int64_t prefix_size = salt_size_ + kIvSizeInBytes;
+  if (static_cast<int64_t>(ciphertext.size()) <
+      prefix_size + kTagSizeInBytes) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Ciphertext too short; expected at least ",
+                     prefix_size + kTagSizeInBytes, " bytes, got ",
+                     ciphertext.size()));
+  }
+  util::StatusOr<std::shared_ptr<const DerivedAead>> derived_aead =
+      GetDecryptionAead(ciphertext.substr(0, salt_size_));
+  if (!derived_aead.ok()) {
+    return derived_aead.status();
+  }
+  const SslOneShotAead& aead = *(*derived_aead)->aead;
+  absl::string_view raw_ciphertext = ciphertext.substr(prefix_size);
+  std::string plaintext;
+  subtle::ResizeStringUninitialized(&plaintext,
+                                    aead.PlaintextSize(raw_ciphertext.size()));
+  util::StatusOr<int64_t> written_bytes =
+      aead.Decrypt(raw_ciphertext, associated_data,
+                   ciphertext.substr(salt_size_, kIvSizeInBytes),
+                   absl::MakeSpan(plaintext));
+  if (!written_bytes.ok()) {
+    return written_bytes.status();
+  }
+  return std::move(plaintext);
+}
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
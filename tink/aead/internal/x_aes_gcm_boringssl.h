@@ -0,0 +1,129 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_AEAD_INTERNAL_X_AES_GCM_BORINGSSL_H_
+#define TINK_AEAD_INTERNAL_X_AES_GCM_BORINGSSL_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/aes.h"
+#include "tink/aead.h"
+#include "tink/aead/internal/ssl_aead.h"
+#include "tink/internal/fips_utils.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// X-AES-GCM (https://c2sp.org/XAES-256-GCM) with salts of 8 to 12 bytes; see
+// XAesGcmParameters. Ciphertexts have the form
+// `salt || iv || raw ciphertext || tag`, without output prefix.
+//
+// The AES-256-GCM key for a salt is derived with two AES block encryptions
+// under the main key, as in the NIST SP 800-108 CMAC-based KDF. Deriving a key
+// also means setting up a new AES-GCM key schedule, so encryption keeps a
+// salt for kMessagesPerSalt messages, each with its own random 12-byte IV.
+// This stays far below the 2^32 messages that AES-GCM allows per key with
+// random IVs, while the number of messages per main key is practically
+// unlimited. Decryption caches up to kDerivedKeyCacheSize derived keys, in
+// slots chosen by a hash of the salt, so ciphertexts that share a salt are
+// decrypted at the speed of AES-GCM. Neither encryption nor decryption takes a
+// lock unless a new key has to be derived for encryption.
+class XAesGcmBoringSsl : public Aead {
+ public:
+  // Number of messages encrypted with one salt before a new one is drawn.
+  static constexpr int64_t kMessagesPerSalt = int64_t{1} << 20;
+  // Number of derived keys kept for decryption.
+  static constexpr int kDerivedKeyCacheSize = 16;
+
+  static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
+      const util::SecretData& key, int salt_size);
+
+  crypto::tink::util::StatusOr<std::string> Encrypt(
+      absl::string_view plaintext,
+      absl::string_view associated_data) const override;
+
+  crypto::tink::util::StatusOr<std::string> Decrypt(
+      absl::string_view ciphertext,
+      absl::string_view associated_data) const override;
+
+  static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
+      crypto::tink::internal::FipsCompatibility::kNotFips;
+
+ private:
+  // AES-GCM keyed with the key derived for `salt`.
+  struct DerivedAead {
+    std::string salt;
+    std::unique_ptr<SslOneShotAead> aead;
+  };
+
+  // The derived key used for encryption, and the number of messages it was
+  // handed out for.
+  struct EncryptionState {
+    std::shared_ptr<const DerivedAead> derived_aead;
+    std::atomic<int64_t> uses{0};
+  };
+
+  XAesGcmBoringSsl(util::SecretUniquePtr<AES_KEY> aes_key,
+                   util::SecretData cmac_k1, int salt_size)
+      : aes_key_(std::move(aes_key)),
+        cmac_k1_(std::move(cmac_k1)),
+        salt_size_(salt_size) {}
+
+  crypto::tink::util::StatusOr<std::shared_ptr<const DerivedAead>>
+  NewDerivedAead(absl::string_view salt) const;
+
+  // Returns the AES-GCM to encrypt the next message with, drawing a new salt
+  // when the current one has been used for kMessagesPerSalt messages.
+  crypto::tink::util::StatusOr<std::shared_ptr<const DerivedAead>>
+  GetEncryptionAead() const;
+
+  // Returns the AES-GCM for `salt`, from the cache if possible.
+  crypto::tink::util::StatusOr<std::shared_ptr<const DerivedAead>>
+  GetDecryptionAead(absl::string_view salt) const;
+
+  // Returns the cache slot for `salt`.
+  std::shared_ptr<const DerivedAead>& CacheSlot(absl::string_view salt) const;
+
+  const util::SecretUniquePtr<AES_KEY> aes_key_;
+  // CMAC subkey K1 of `aes_key_`.
+  const util::SecretData cmac_k1_;
+  const int salt_size_;
+
+  // Held while drawing a new encryption salt, so that concurrent encryptions
+  // that find the current salt used up derive only one new key.
+  mutable absl::Mutex rotation_mutex_;
+  // Only accessed with std::atomic_load() and std::atomic_store().
+  mutable std::shared_ptr<EncryptionState> encryption_state_;
+  // Only accessed with std::atomic_load() and std::atomic_store().
+  mutable std::array<std::shared_ptr<const DerivedAead>, kDerivedKeyCacheSize>
+      cache_;
+};
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_AEAD_INTERNAL_X_AES_GCM_BORINGSSL_H_
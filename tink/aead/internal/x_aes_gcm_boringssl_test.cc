@@ -0,0 +1,282 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/internal/x_aes_gcm_boringssl.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tink/aead.h"
+#include "tink/internal/fips_utils.h"
+#include "tink/subtle/random.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::IsOkAndHolds;
+using ::crypto::tink::test::StatusIs;
+using ::testing::Eq;
+using ::testing::Not;
+using ::testing::SizeIs;
+using ::testing::UnorderedElementsAre;
+
+constexpr int kKeySizeInBytes = 32;
+constexpr int kIvSizeInBytes = 12;
+constexpr int kTagSizeInBytes = 16;
+constexpr absl::string_view kMessage = "Some data to encrypt.";
+constexpr absl::string_view kAssociatedData = "Some data to authenticate.";
+
+class XAesGcmBoringSslTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    if (IsFipsModeEnabled()) {
+      GTEST_SKIP() << "Not supported in FIPS-only mode";
+    }
+  }
+};
+
+std::unique_ptr<Aead> NewAead(absl::string_view key, int salt_size) {
+  util::StatusOr<std::unique_ptr<Aead>> aead =
+      XAesGcmBoringSsl::New(util::SecretDataFromStringView(key), salt_size);
+  EXPECT_THAT(aead, IsOk());
+  return *std::move(aead);
+}
+
+// Test vectors from https://c2sp.org/XAES-256-GCM, which uses 12-byte salts.
+TEST_F(XAesGcmBoringSslTest, TestVectors) {
+  struct TestVector {
+    std::string key;
+    std::string associated_data;
+    std::string ciphertext_hex;
+  };
+  const std::vector<TestVector> test_vectors = {
+      {std::string(kKeySizeInBytes, '\x01'), "",
+       "ce546ef63c9cc60765923609b33a9a1974e96e52daf2fcf7075e2271"},
+      {std::string(kKeySizeInBytes, '\x03'), "c2sp.org/XAES-256-GCM",
+       "986ec1832593df5443a179437fd083bf3fdb41abd740a21f71eb769d"},
+  };
+  for (const TestVector& test_vector : test_vectors) {
+    std::unique_ptr<Aead> aead = NewAead(test_vector.key, /*salt_size=*/12);
+    std::string ciphertext =
+        absl::StrCat("ABCDEFGHIJKLMNOPQRSTUVWX",
+                     absl::HexStringToBytes(test_vector.ciphertext_hex));
+    EXPECT_THAT(aead->Decrypt(ciphertext, test_vector.associated_data),
+                IsOkAndHolds(Eq("XAES-256-GCM")));
+  }
+}
+
+TEST_F(XAesGcmBoringSslTest, EncryptDecrypt) {
+  const std::string key = subtle::Random::GetRandomBytes(kKeySizeInBytes);
+  for (int salt_size = 8; salt_size <= 12; ++salt_size) {
+    SCOPED_TRACE(absl::StrCat("salt_size: ", salt_size));
+    std::unique_ptr<Aead> aead = NewAead(key, salt_size);
+    util::StatusOr<std::string> ciphertext =
+        aead->Encrypt(kMessage, kAssociatedData);
+    ASSERT_THAT(ciphertext, IsOk());
+    EXPECT_THAT(*ciphertext, SizeIs(salt_size + kIvSizeInBytes +
+                                    kMessage.size() + kTagSizeInBytes));
+    EXPECT_THAT(aead->Decrypt(*ciphertext, kAssociatedData),
+                IsOkAndHolds(Eq(kMessage)));
+    // A separate instance with the same key has no cached derived keys.
+    EXPECT_THAT(NewAead(key, salt_size)->Decrypt(*ciphertext, kAssociatedData),
+                IsOkAndHolds(Eq(kMessage)));
+  }
+}
+
+TEST_F(XAesGcmBoringSslTest, EmptyPlaintextAndAssociatedData) {
+  std::unique_ptr<Aead> aead =
+      NewAead(subtle::Random::GetRandomBytes(kKeySizeInBytes), 12);
+  util::StatusOr<std::string> ciphertext = aead->Encrypt("", "");
+  ASSERT_THAT(ciphertext, IsOk());
+  EXPECT_THAT(aead->Decrypt(*ciphertext, ""), IsOkAndHolds(Eq("")));
+}
+
+TEST_F(XAesGcmBoringSslTest, ConsecutiveEncryptionsShareSaltButNotIv) {
+  constexpr int kSaltSize = 12;
+  std::unique_ptr<Aead> aead =
+      NewAead(subtle::Random::GetRandomBytes(kKeySizeInBytes), kSaltSize);
+  util::StatusOr<std::string> ciphertext1 =
+      aead->Encrypt(kMessage, kAssociatedData);
+  util::StatusOr<std::string> ciphertext2 =
+      aead->Encrypt(kMessage, kAssociatedData);
+  ASSERT_THAT(ciphertext1, IsOk());
+  ASSERT_THAT(ciphertext2, IsOk());
+  EXPECT_EQ(ciphertext1->substr(0, kSaltSize),
+            ciphertext2->substr(0, kSaltSize));
+  EXPECT_NE(ciphertext1->substr(kSaltSize, kIvSizeInBytes),
+            ciphertext2->substr(kSaltSize, kIvSizeInBytes));
+}
+
+TEST_F(XAesGcmBoringSslTest, ConcurrentEncryptionsRotateSalt) {
+  constexpr int kSaltSize = 8;
+  constexpr int kNumThreads = 4;
+  constexpr int64_t kMessagesPerThread =
+      XAesGcmBoringSsl::kMessagesPerSalt / kNumThreads + 1;
+  std::unique_ptr<Aead> aead =
+      NewAead(subtle::Random::GetRandomBytes(kKeySizeInBytes), kSaltSize);
+  std::vector<absl::flat_hash_map<std::string, int64_t>> salt_counts(
+      kNumThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&aead, &salt_counts, t] {
+      for (int64_t i = 0; i < kMessagesPerThread; ++i) {
+        util::StatusOr<std::string> ciphertext = aead->Encrypt("", "");
+        ASSERT_THAT(ciphertext, IsOk());
+        ++salt_counts[t][ciphertext->substr(0, kSaltSize)];
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  absl::flat_hash_map<std::string, int64_t> total_counts;
+  for (const auto& thread_counts : salt_counts) {
+    for (const auto& entry : thread_counts) {
+      total_counts[entry.first] += entry.second;
+    }
+  }
+  // Every salt but the last is used for exactly kMessagesPerSalt messages.
+  std::vector<int64_t> counts;
+  for (const auto& entry : total_counts) {
+    counts.push_back(entry.second);
+  }
+  EXPECT_THAT(counts,
+              UnorderedElementsAre(XAesGcmBoringSsl::kMessagesPerSalt,
+                                   kNumThreads * kMessagesPerThread -
+                                       XAesGcmBoringSsl::kMessagesPerSalt));
+}
+
+TEST_F(XAesGcmBoringSslTest, DecryptManySalts) {
+  const std::string key = subtle::Random::GetRandomBytes(kKeySizeInBytes);
+  std::unique_ptr<Aead> aead = NewAead(key, 12);
+  // Each instance encrypts under its own salt. Using more salts than the cache
+  // holds exercises eviction.
+  std::vector<std::string> ciphertexts;
+  for (int i = 0; i < 2 * XAesGcmBoringSsl::kDerivedKeyCacheSize; ++i) {
+    util::StatusOr<std::string> ciphertext =
+        NewAead(key, 12)->Encrypt(absl::StrCat(kMessage, i), kAssociatedData);
+    ASSERT_THAT(ciphertext, IsOk());
+    ciphertexts.push_back(*ciphertext);
+  }
+  for (int round = 0; round < 2; ++round) {
+    for (size_t i = 0; i < ciphertexts.size(); ++i) {
+      EXPECT_THAT(aead->Decrypt(ciphertexts[i], kAssociatedData),
+                  IsOkAndHolds(Eq(absl::StrCat(kMessage, i))));
+    }
+  }
+}
+
+TEST_F(XAesGcmBoringSslTest, InvalidKeySize) {
+  for (int key_size : {0, 16, 31, 33}) {
+    EXPECT_THAT(XAesGcmBoringSsl::New(util::SecretData(key_size, 'a'), 12)
+                    .status(),
+                StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
+TEST_F(XAesGcmBoringSslTest, InvalidSaltSize) {
+  for (int salt_size : {-1, 0, 7, 13, 16}) {
+    EXPECT_THAT(
+        XAesGcmBoringSsl::New(util::SecretData(kKeySizeInBytes, 'a'), salt_size)
+            .status(),
+        StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
+TEST_F(XAesGcmBoringSslTest, DecryptModifiedCiphertextFails) {
+  std::unique_ptr<Aead> aead =
+      NewAead(subtle::Random::GetRandomBytes(kKeySizeInBytes), 10);
+  util::StatusOr<std::string> ciphertext =
+      aead->Encrypt(kMessage, kAssociatedData);
+  ASSERT_THAT(ciphertext, IsOk());
+  for (size_t i = 0; i < ciphertext->size(); ++i) {
+    std::string modified = *ciphertext;
+    modified[i] ^= 1;
+    EXPECT_THAT(aead->Decrypt(modified, kAssociatedData), Not(IsOk()))
+        << "byte " << i;
+  }
+  EXPECT_THAT(aead->Decrypt(*ciphertext, "other associated data"),
+              Not(IsOk()));
+  EXPECT_THAT(
+      aead->Decrypt(ciphertext->substr(0, ciphertext->size() - 1),
+                    kAssociatedData),
+      Not(IsOk()));
+}
+
+TEST_F(XAesGcmBoringSslTest, DecryptTooShortCiphertextFails) {
+  std::unique_ptr<Aead> aead =
+      NewAead(subtle::Random::GetRandomBytes(kKeySizeInBytes), 12);
+  EXPECT_THAT(aead->Decrypt(std::string(12 + kIvSizeInBytes +
+                                            kTagSizeInBytes - 1, 'a'),
+                            kAssociatedData)
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(XAesGcmBoringSslTest, ConcurrentEncryptDecrypt) {
+  const std::string key = subtle::Random::GetRandomBytes(kKeySizeInBytes);
+  std::unique_ptr<Aead> aead = NewAead(key, 12);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&key, &aead, t] {
+      // Ciphertexts from another instance need their own derived key.
+      std::unique_ptr<Aead> other = NewAead(key, 12);
+      for (int i = 0; i < 100; ++i) {
+        const std::string message = absl::StrCat(kMessage, t, ":", i);
+        const Aead& encrypter = i % 2 == 0 ? *aead : *other;
+        util::StatusOr<std::string> ciphertext =
+            encrypter.Encrypt(message, kAssociatedData);
+        ASSERT_THAT(ciphertext, IsOk());
+        EXPECT_THAT(aead->Decrypt(*ciphertext, kAssociatedData),
+                    IsOkAndHolds(Eq(message)));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(XAesGcmBoringSslFipsTest, FipsOnly) {
+  if (!IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Only supported in FIPS-only mode";
+  }
+  EXPECT_THAT(
+      XAesGcmBoringSsl::New(util::SecretData(kKeySizeInBytes, 'a'), 12)
+          .status(),
+      StatusIs(absl::StatusCode::kInternal));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
@@ -23,6 +23,7 @@
 
 #include "absl/strings/string_view.h"
 #include "tink/crypto_format.h"
+#include "tink/internal/output_prefix_index.h"
 #include "tink/subtle/subtle_util.h"
 
 namespace crypto {
@@ -50,7 +51,7 @@ class ZeroCopyAeadSetWrapper : public Aead {
  public:
   explicit ZeroCopyAeadSetWrapper(
       std::unique_ptr<PrimitiveSet<ZeroCopyAead>> aead_set)
-      : aead_set_(std::move(aead_set)) {}
+      : aead_set_(std::move(aead_set)), prefix_index_(*aead_set_) {}
 
   util::StatusOr<std::string> Encrypt(
       absl::string_view plaintext,
@@ -64,6 +65,7 @@ class ZeroCopyAeadSetWrapper : public Aead {
 
  private:
   std::unique_ptr<PrimitiveSet<ZeroCopyAead>> aead_set_;
+  const OutputPrefixIndex<ZeroCopyAead> prefix_index_;
 };
 
 util::StatusOr<std::string> ZeroCopyAeadSetWrapper::Encrypt(
@@ -87,41 +89,15 @@ util::StatusOr<std::string> ZeroCopyAeadSetWrapper::Encrypt(
 util::StatusOr<std::string> ZeroCopyAeadSetWrapper::Decrypt(
     absl::string_view ciphertext, absl::string_view associated_data) const {
   if (ciphertext.size() > CryptoFormat::kNonRawPrefixSize) {
-    std::string key_id =
-        std::string(ciphertext.substr(0, CryptoFormat::kNonRawPrefixSize));
-    util::StatusOr<const std::vector<std::unique_ptr<ZeroCopyAeadEntry>>*>
-        primitives = aead_set_->get_primitives(key_id);
-
-    if (primitives.ok() && *primitives != nullptr) {
-      absl::string_view raw_ciphertext =
-          ciphertext.substr(key_id.size(), ciphertext.size());
-
-      for (const std::unique_ptr<ZeroCopyAeadEntry>& entry : **primitives) {
-        ZeroCopyAead& aead = entry->get_primitive();
-        std::string plaintext;
-        subtle::ResizeStringUninitialized(
-            &plaintext, aead.MaxDecryptionSize(raw_ciphertext.size()));
-        util::StatusOr<int64_t> plaintext_size = entry->get_primitive().Decrypt(
-            raw_ciphertext, associated_data, absl::MakeSpan(plaintext));
-        if (plaintext_size.ok()) {
-          plaintext.resize(*plaintext_size);
-          return plaintext;
-        }
-      }
-    }
-  }
-
-  // Try raw keys because matching keys failed to decrypt.
-  util::StatusOr<const std::vector<std::unique_ptr<ZeroCopyAeadEntry>>*>
-      raw_primitives = aead_set_->get_raw_primitives();
-  if (raw_primitives.ok() && *raw_primitives != nullptr) {
-    for (const std::unique_ptr<ZeroCopyAeadEntry>& entry : **raw_primitives) {
+    absl::string_view raw_ciphertext =
+        ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
+    for (const ZeroCopyAeadEntry* entry : prefix_index_.Find(ciphertext)) {
       ZeroCopyAead& aead = entry->get_primitive();
       std::string plaintext;
       subtle::ResizeStringUninitialized(
-          &plaintext, aead.MaxDecryptionSize(ciphertext.size()));
-      util::StatusOr<int64_t> plaintext_size =
-          aead.Decrypt(ciphertext, associated_data, absl::MakeSpan(plaintext));
+          &plaintext, aead.MaxDecryptionSize(raw_ciphertext.size()));
+      util::StatusOr<int64_t> plaintext_size = entry->get_primitive().Decrypt(
+          raw_ciphertext, associated_data, absl::MakeSpan(plaintext));
       if (plaintext_size.ok()) {
         plaintext.resize(*plaintext_size);
         return plaintext;
@@ -129,6 +105,20 @@ util::StatusOr<std::string> ZeroCopyAeadSetWrapper::Decrypt(
     }
   }
 
+  // Try raw keys because matching keys failed to decrypt.
+  for (const ZeroCopyAeadEntry* entry : prefix_index_.raw_entries()) {
+    ZeroCopyAead& aead = entry->get_primitive();
+    std::string plaintext;
+    subtle::ResizeStringUninitialized(
+        &plaintext, aead.MaxDecryptionSize(ciphertext.size()));
+    util::StatusOr<int64_t> plaintext_size =
+        aead.Decrypt(ciphertext, associated_data, absl::MakeSpan(plaintext));
+    if (plaintext_size.ok()) {
+      plaintext.resize(*plaintext_size);
+      return plaintext;
+    }
+  }
+
   return util::Status(absl::StatusCode::kInvalidArgument, "Decryption failed");
 }
 
@@ -18,12 +18,15 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/aead/internal/aead_util.h"
 #include "tink/aead/internal/ssl_aead.h"
 #include "tink/aead/internal/zero_copy_aead.h"
@@ -40,8 +43,8 @@ namespace internal {
 constexpr int kIvSizeInBytes = 12;
 constexpr int kTagSizeInBytes = 16;
 
-util::StatusOr<std::unique_ptr<ZeroCopyAead>> ZeroCopyAesGcmBoringSsl::New(
-    const util::SecretData &key) {
+util::StatusOr<std::unique_ptr<ZeroCopyAesGcmBoringSsl>>
+ZeroCopyAesGcmBoringSsl::New(const util::SecretData &key) {
   util::StatusOr<std::unique_ptr<internal::SslOneShotAead>> aead =
       internal::CreateAesGcmOneShotCrypter(key);
   if (!aead.ok()) {
@@ -65,19 +68,17 @@ util::StatusOr<int64_t> ZeroCopyAesGcmBoringSsl::Encrypt(
         absl::StrCat("Encryption buffer too small; expected at least ",
                      max_encryption_size, " bytes, got ", buffer.size()));
   }
-  absl::string_view buffer_string(buffer.data(), buffer.size());
-  if (BuffersOverlap(plaintext, buffer_string)) {
-    return util::Status(
-        absl::StatusCode::kFailedPrecondition,
-        "Plaintext and ciphertext buffers overlap; this is disallowed");
+  util::Status res = ValidateEncryptionBuffersWithPrefixIv(plaintext, buffer,
+                                                           kIvSizeInBytes);
+  if (!res.ok()) {
+    return res;
   }
 
-  util::Status res =
-      subtle::Random::GetRandomBytes(buffer.subspan(0, kIvSizeInBytes));
+  res = subtle::Random::GetRandomNonceBytes(buffer.subspan(0, kIvSizeInBytes));
   if (!res.ok()) {
     return res;
   }
-  absl::string_view iv = buffer_string.substr(0, kIvSizeInBytes);
+  absl::string_view iv(buffer.data(), kIvSizeInBytes);
   absl::Span<char> raw_cipher_and_tag_buffer = buffer.subspan(kIvSizeInBytes);
 
   util::StatusOr<int64_t> written_bytes =
@@ -116,11 +117,10 @@ util::StatusOr<int64_t> ZeroCopyAesGcmBoringSsl::Decrypt(
                      max_decryption_size, " bytes, got ", buffer.size()));
   }
 
-  absl::string_view buffer_string(buffer.data(), buffer.size());
-  if (BuffersOverlap(ciphertext, buffer_string)) {
-    return util::Status(
-        absl::StatusCode::kFailedPrecondition,
-        "Plaintext and ciphertext buffers overlap; this is disallowed");
+  util::Status res = ValidateDecryptionBuffersWithPrefixIv(ciphertext, buffer,
+                                                           kIvSizeInBytes);
+  if (!res.ok()) {
+    return res;
   }
 
   auto iv = ciphertext.substr(0, kIvSizeInBytes);
@@ -129,6 +129,29 @@ util::StatusOr<int64_t> ZeroCopyAesGcmBoringSsl::Decrypt(
   return aead_->Decrypt(ciphertext_and_tag, associated_data, iv, buffer);
 }
 
+int64_t ZeroCopyAesGcmBoringSsl::InPlaceOffset() const {
+  return kIvSizeInBytes;
+}
+
+util::Status ZeroCopyAesGcmBoringSsl::EncryptBatchWithPrefix(
+    absl::string_view output_prefix,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string *ciphertexts, std::vector<int64_t> *offsets) const {
+  return EncryptBatchWithRandomIv(*aead_, kIvSizeInBytes, plaintexts,
+                                  associated_data, output_prefix, ciphertexts,
+                                  offsets);
+}
+
+util::Status ZeroCopyAesGcmBoringSsl::DecryptBatch(
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string *plaintexts, std::vector<int64_t> *offsets) const {
+  return DecryptBatchWithPrefixIv(*aead_, kIvSizeInBytes, kTagSizeInBytes,
+                                  ciphertexts, associated_data, plaintexts,
+                                  offsets);
+}
+
 }  // namespace internal
 }  // namespace tink
 }  // namespace crypto
@@ -19,12 +19,17 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/base/macros.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/aead/internal/ssl_aead.h"
 #include "tink/aead/internal/zero_copy_aead.h"
 #include "tink/util/secret_data.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -33,8 +38,8 @@ namespace internal {
 
 class ZeroCopyAesGcmBoringSsl : public ZeroCopyAead {
  public:
-  static crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>> New(
-      const util::SecretData &key);
+  static crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAesGcmBoringSsl>>
+  New(const util::SecretData &key);
 
   int64_t MaxEncryptionSize(int64_t plaintext_size) const override;
 
@@ -48,6 +53,34 @@ class ZeroCopyAesGcmBoringSsl : public ZeroCopyAead {
       absl::string_view ciphertext, absl::string_view associated_data,
       absl::Span<char> buffer) const override;
 
+  // Encryption and decryption may be done in place after the 12-byte IV.
+  int64_t InPlaceOffset() const override;
+
+  // Encrypts a batch of plaintexts as specified by Aead::EncryptBatch, each
+  // with a fresh random IV. The whole batch goes through a single
+  // SslOneShotAead::EncryptBatch() call, so the cipher is set up once.
+  crypto::tink::util::Status EncryptBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string *ciphertexts, std::vector<int64_t> *offsets) const {
+    return EncryptBatchWithPrefix(/*output_prefix=*/"", plaintexts,
+                                  associated_data, ciphertexts, offsets);
+  }
+
+  // Like EncryptBatch(), with 'output_prefix' in front of every ciphertext;
+  // see Aead::EncryptBatchWithPrefix.
+  crypto::tink::util::Status EncryptBatchWithPrefix(
+      absl::string_view output_prefix,
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string *ciphertexts, std::vector<int64_t> *offsets) const;
+
+  // Decrypts a batch of ciphertexts as specified by Aead::DecryptBatch.
+  crypto::tink::util::Status DecryptBatch(
+      absl::Span<const absl::string_view> ciphertexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string *plaintexts, std::vector<int64_t> *offsets) const;
+
  private:
   explicit ZeroCopyAesGcmBoringSsl(std::unique_ptr<SslOneShotAead> aead)
       : aead_(std::move(aead)) {}
@@ -170,6 +170,48 @@ TEST_F(ZeroCopyAesGcmBoringSslTest, DecryptOverlappingPlaintextCiphertext) {
       StatusIs(absl::StatusCode::kFailedPrecondition));
 }
 
+TEST_F(ZeroCopyAesGcmBoringSslTest, InPlaceEncryptDecrypt) {
+  ASSERT_EQ(cipher_->InPlaceOffset(), kIvSizeInBytes);
+  // Lay out the plaintext where the raw ciphertext is written.
+  std::string buffer(kIvSizeInBytes, '\0');
+  absl::StrAppend(&buffer, kMessage);
+  subtle::ResizeStringUninitialized(&buffer, kMaxEncryptionSize);
+  auto plaintext =
+      absl::string_view(buffer).substr(kIvSizeInBytes, kMessage.size());
+  util::StatusOr<int64_t> ciphertext_size =
+      cipher_->Encrypt(plaintext, kAssociatedData, absl::MakeSpan(buffer));
+  ASSERT_THAT(ciphertext_size, IsOk());
+  EXPECT_EQ(*ciphertext_size, kMaxEncryptionSize);
+
+  // The result is a regular ciphertext.
+  std::string plaintext_copy;
+  subtle::ResizeStringUninitialized(&plaintext_copy, kMaxDecryptionSize);
+  util::StatusOr<int64_t> plaintext_size = cipher_->Decrypt(
+      buffer, kAssociatedData, absl::MakeSpan(plaintext_copy));
+  ASSERT_THAT(plaintext_size, IsOk());
+  EXPECT_EQ(plaintext_copy, kMessage);
+
+  // Decrypt in place, overwriting the raw ciphertext.
+  plaintext_size = cipher_->Decrypt(
+      buffer, kAssociatedData,
+      absl::MakeSpan(buffer).subspan(kIvSizeInBytes, kMaxDecryptionSize));
+  ASSERT_THAT(plaintext_size, IsOk());
+  EXPECT_EQ(absl::string_view(buffer).substr(kIvSizeInBytes, *plaintext_size),
+            kMessage);
+}
+
+TEST_F(ZeroCopyAesGcmBoringSslTest, EncryptPlaintextAtBufferStartFails) {
+  // The plaintext would be overwritten by the IV.
+  std::string buffer(kMessage);
+  subtle::ResizeStringUninitialized(&buffer, kMaxEncryptionSize);
+  EXPECT_THAT(
+      cipher_
+          ->Encrypt(absl::string_view(buffer).substr(0, kMessage.size()),
+                    kAssociatedData, absl::MakeSpan(buffer))
+          .status(),
+      StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
 class ZeroCopyAesGcmBoringSslWycheproofTest
     : public TestWithParam<WycheproofTestVector> {
   void SetUp() override {
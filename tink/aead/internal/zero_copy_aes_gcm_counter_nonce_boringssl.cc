@@ -0,0 +1,299 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/internal/zero_copy_aes_gcm_counter_nonce_boringssl.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/attributes.h"
+#include "absl/base/const_init.h"
+#include "absl/base/internal/endian.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "openssl/evp.h"
+#include "openssl/hmac.h"
+#include "tink/aead/internal/ssl_aead.h"
+#include "tink/aead/internal/zero_copy_aead.h"
+#include "tink/internal/batch_util.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/subtle_util.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+namespace {
+
+constexpr int kIvSizeInBytes = 12;
+constexpr int kNoncePrefixSizeInBytes = 8;
+constexpr int kTagSizeInBytes = 16;
+
+constexpr int kFingerprintKeySizeInBytes = 32;
+
+ABSL_CONST_INIT absl::Mutex key_states_mutex(absl::kConstInit);
+
+// Returns the HMAC-SHA256 of `key` under a random key drawn once per process,
+// so that the lookup of key states does not hold a plain hash of the key.
+util::StatusOr<std::string> KeyFingerprint(const util::SecretData &key) {
+  static const util::SecretData *const fingerprint_key = new util::SecretData(
+      subtle::Random::GetRandomKeyBytes(kFingerprintKeySizeInBytes));
+  uint8_t fingerprint[EVP_MAX_MD_SIZE];
+  unsigned int fingerprint_size;
+  if (HMAC(EVP_sha256(), fingerprint_key->data(), fingerprint_key->size(),
+           key.data(), key.size(), fingerprint, &fingerprint_size) == nullptr) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "HMAC computation failed");
+  }
+  return std::string(reinterpret_cast<const char *>(fingerprint),
+                     fingerprint_size);
+}
+
+}  // namespace
+
+constexpr int64_t ZeroCopyAesGcmCounterNonceBoringSsl::kMaxMessagesPerKey;
+
+util::StatusOr<std::shared_ptr<ZeroCopyAesGcmCounterNonceBoringSsl::KeyState>>
+ZeroCopyAesGcmCounterNonceBoringSsl::GetKeyState(const util::SecretData &key) {
+  util::StatusOr<std::string> fingerprint = KeyFingerprint(key);
+  if (!fingerprint.ok()) {
+    return fingerprint.status();
+  }
+  // Drawn before taking the lock: if anything fails after the state has been
+  // created, its deleter takes the lock.
+  std::string nonce_prefix;
+  subtle::ResizeStringUninitialized(&nonce_prefix, kNoncePrefixSizeInBytes);
+  util::Status status =
+      subtle::Random::GetRandomBytes(absl::MakeSpan(nonce_prefix));
+  if (!status.ok()) {
+    return status;
+  }
+  absl::MutexLock lock(&key_states_mutex);
+  // States of the keys with live instances, by fingerprint. Guarded by
+  // `key_states_mutex`.
+  static auto *key_states =
+      new absl::flat_hash_map<std::string, std::weak_ptr<KeyState>>();
+  auto it = key_states->find(*fingerprint);
+  if (it != key_states->end()) {
+    std::shared_ptr<KeyState> key_state = it->second.lock();
+    if (key_state != nullptr) {
+      return key_state;
+    }
+  }
+  // Removes the entry of the state once the last instance is destroyed, unless
+  // a new state for the key has replaced it in the meantime.
+  auto deleter = [fingerprint = *fingerprint](KeyState *key_state) {
+    {
+      absl::MutexLock lock(&key_states_mutex);
+      auto it = key_states->find(fingerprint);
+      if (it != key_states->end() && it->second.expired()) {
+        key_states->erase(it);
+      }
+    }
+    delete key_state;
+  };
+  std::shared_ptr<KeyState> key_state(new KeyState(), std::move(deleter));
+  key_state->nonce_prefix = std::move(nonce_prefix);
+  (*key_states)[*std::move(fingerprint)] = key_state;
+  return key_state;
+}
+
+util::StatusOr<std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl>>
+ZeroCopyAesGcmCounterNonceBoringSsl::New(const util::SecretData &key,
+                                         const Options &options) {
+  if (options.max_messages < 1 || options.max_messages > kMaxMessagesPerKey) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Invalid message limit ", options.max_messages,
+                     "; must be in [1, ", kMaxMessagesPerKey, "]"));
+  }
+  util::StatusOr<std::unique_ptr<internal::SslOneShotAead>> aead =
+      internal::CreateAesGcmOneShotCrypter(key);
+  if (!aead.ok()) {
+    return aead.status();
+  }
+  util::StatusOr<std::shared_ptr<KeyState>> key_state = GetKeyState(key);
+  if (!key_state.ok()) {
+    return key_state.status();
+  }
+  return {absl::WrapUnique(new ZeroCopyAesGcmCounterNonceBoringSsl(
+      *std::move(aead), *std::move(key_state), options))};
+}
+
+util::StatusOr<int64_t> ZeroCopyAesGcmCounterNonceBoringSsl::ReserveCounters(
+    int64_t num_messages) const {
+  std::atomic<int64_t> &next_counter = key_state_->next_counter;
+  int64_t counter = next_counter.load(std::memory_order_relaxed);
+  do {
+    // `counter` exceeds `max_messages_` if another instance of the key has a
+    // higher limit.
+    const int64_t remaining = std::max<int64_t>(0, max_messages_ - counter);
+    if (num_messages > remaining) {
+      return util::Status(
+          absl::StatusCode::kResourceExhausted,
+          absl::StrCat("Message limit reached; can encrypt ", remaining,
+                       " more messages, requested ", num_messages,
+                       ". Rotate the key."));
+    }
+  } while (!next_counter.compare_exchange_weak(counter, counter + num_messages,
+                                               std::memory_order_relaxed));
+  return counter;
+}
+
+void ZeroCopyAesGcmCounterNonceBoringSsl::WriteIv(int64_t counter,
+                                                  char *iv) const {
+  const std::string &nonce_prefix = key_state_->nonce_prefix;
+  std::copy(nonce_prefix.begin(), nonce_prefix.end(), iv);
+  absl::big_endian::Store32(iv + kNoncePrefixSizeInBytes,
+                            static_cast<uint32_t>(counter));
+}
+
+int64_t ZeroCopyAesGcmCounterNonceBoringSsl::RemainingMessages() const {
+  return std::max<int64_t>(
+      0, max_messages_ -
+             key_state_->next_counter.load(std::memory_order_relaxed));
+}
+
+int64_t ZeroCopyAesGcmCounterNonceBoringSsl::MaxEncryptionSize(
+    int64_t plaintext_size) const {
+  return kIvSizeInBytes + aead_->CiphertextSize(plaintext_size);
+}
+
+util::StatusOr<int64_t> ZeroCopyAesGcmCounterNonceBoringSsl::Encrypt(
+    absl::string_view plaintext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
+  const int64_t max_encryption_size = MaxEncryptionSize(plaintext.size());
+  if (static_cast<int64_t>(buffer.size()) < max_encryption_size) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Encryption buffer too small; expected at least ",
+                     max_encryption_size, " bytes, got ", buffer.size()));
+  }
+  util::Status res = ValidateEncryptionBuffersWithPrefixIv(plaintext, buffer,
+                                                           kIvSizeInBytes);
+  if (!res.ok()) {
+    return res;
+  }
+
+  util::StatusOr<int64_t> counter = ReserveCounters(1);
+  if (!counter.ok()) {
+    return counter.status();
+  }
+  WriteIv(*counter, buffer.data());
+  absl::string_view iv(buffer.data(), kIvSizeInBytes);
+  absl::Span<char> raw_cipher_and_tag_buffer = buffer.subspan(kIvSizeInBytes);
+
+  util::StatusOr<int64_t> written_bytes =
+      aead_->Encrypt(plaintext, associated_data, iv, raw_cipher_and_tag_buffer);
+  if (!written_bytes.ok()) {
+    return written_bytes.status();
+  }
+  return kIvSizeInBytes + *written_bytes;
+}
+
+int64_t ZeroCopyAesGcmCounterNonceBoringSsl::MaxDecryptionSize(
+    int64_t ciphertext_size) const {
+  const int64_t size = ciphertext_size - kIvSizeInBytes - kTagSizeInBytes;
+  if (size <= 0) {
+    return 0;
+  }
+  return size;
+}
+
+util::StatusOr<int64_t> ZeroCopyAesGcmCounterNonceBoringSsl::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
+  const size_t min_ciphertext_size = kIvSizeInBytes + kTagSizeInBytes;
+  if (ciphertext.size() < min_ciphertext_size) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Ciphertext too short; expected at least ",
+                     min_ciphertext_size, " bytes, got ", ciphertext.size()));
+  }
+
+  const int64_t max_decryption_size = MaxDecryptionSize(ciphertext.size());
+  if (static_cast<int64_t>(buffer.size()) < max_decryption_size) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Decryption buffer too small; expected at least ",
+                     max_decryption_size, " bytes, got ", buffer.size()));
+  }
+
+  util::Status res = ValidateDecryptionBuffersWithPrefixIv(ciphertext, buffer,
+                                                           kIvSizeInBytes);
+  if (!res.ok()) {
+    return res;
+  }
+
+  absl::string_view iv = ciphertext.substr(0, kIvSizeInBytes);
+  absl::string_view ciphertext_and_tag = ciphertext.substr(kIvSizeInBytes);
+  return aead_->Decrypt(ciphertext_and_tag, associated_data, iv, buffer);
+}
+
+int64_t ZeroCopyAesGcmCounterNonceBoringSsl::InPlaceOffset() const {
+  return kIvSizeInBytes;
+}
+
+util::Status ZeroCopyAesGcmCounterNonceBoringSsl::EncryptBatchWithPrefix(
+    absl::string_view output_prefix,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string *ciphertexts, std::vector<int64_t> *offsets) const {
+  // Fail early, so that invalid batches do not use up the message budget.
+  util::Status status =
+      ValidateBatchAssociatedData(plaintexts.size(), associated_data);
+  if (!status.ok()) {
+    return status;
+  }
+  util::StatusOr<int64_t> first_counter = ReserveCounters(plaintexts.size());
+  if (!first_counter.ok()) {
+    return first_counter.status();
+  }
+  std::string ivs;
+  subtle::ResizeStringUninitialized(&ivs, plaintexts.size() * kIvSizeInBytes);
+  for (size_t i = 0; i < plaintexts.size(); ++i) {
+    WriteIv(*first_counter + i, &ivs[i * kIvSizeInBytes]);
+  }
+  return EncryptBatchWithPrefixIv(*aead_, kIvSizeInBytes, ivs, plaintexts,
+                                  associated_data, output_prefix, ciphertexts,
+                                  offsets);
+}
+
+util::Status ZeroCopyAesGcmCounterNonceBoringSsl::DecryptBatch(
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string *plaintexts, std::vector<int64_t> *offsets) const {
+  return DecryptBatchWithPrefixIv(*aead_, kIvSizeInBytes, kTagSizeInBytes,
+                                  ciphertexts, associated_data, plaintexts,
+                                  offsets);
+}
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
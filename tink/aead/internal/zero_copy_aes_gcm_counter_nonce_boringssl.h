@@ -0,0 +1,164 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_AEAD_INTERNAL_ZERO_COPY_AES_GCM_COUNTER_NONCE_BORINGSSL_H_
+#define TINK_AEAD_INTERNAL_ZERO_COPY_AES_GCM_COUNTER_NONCE_BORINGSSL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/aead/internal/ssl_aead.h"
+#include "tink/aead/internal/zero_copy_aead.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// AES-GCM with deterministic nonces, for keys that encrypt at a high rate.
+//
+// The 12-byte IV of each message is an 8-byte prefix, drawn at random per key,
+// followed by a 4-byte big-endian message counter. All instances of the same
+// key that are alive at the same time in a process share the prefix and the
+// counter, so their IVs are distinct without drawing randomness per message.
+// Once the last instance of a key is destroyed, the next one draws a new
+// prefix and starts counting from 0 again; IVs of different processes, or of
+// instances that are not alive at the same time, only collide if their
+// prefixes do. This allows far more messages per key than random IVs, which
+// NIST SP 800-38D limits to 2^32 per key. Encryption fails with
+// kResourceExhausted once the key has encrypted `max_messages` messages,
+// counting the messages of all instances sharing the counter, after which the
+// key must be rotated.
+//
+// Ciphertexts have the same format as ZeroCopyAesGcmBoringSsl, and both
+// classes decrypt each other's ciphertexts.
+//
+// This is an internal building block: no key type or keyset wrapper creates
+// it. Callers that use it directly are responsible for rotating the key, and
+// can track the budget with RemainingMessages().
+class ZeroCopyAesGcmCounterNonceBoringSsl : public ZeroCopyAead {
+ public:
+  // Number of messages a key can encrypt at most; the size of the counter.
+  static constexpr int64_t kMaxMessagesPerKey = int64_t{1} << 32;
+
+  struct Options {
+    // Hard limit on the number of messages encrypted with the key, in
+    // [1, kMaxMessagesPerKey].
+    int64_t max_messages = kMaxMessagesPerKey;
+  };
+
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl>>
+  New(const util::SecretData &key, const Options &options);
+
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl>>
+  New(const util::SecretData &key) {
+    return New(key, Options());
+  }
+
+  int64_t MaxEncryptionSize(int64_t plaintext_size) const override;
+
+  crypto::tink::util::StatusOr<int64_t> Encrypt(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> buffer) const override;
+
+  int64_t MaxDecryptionSize(int64_t ciphertext_size) const override;
+
+  crypto::tink::util::StatusOr<int64_t> Decrypt(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> buffer) const override;
+
+  // Encryption and decryption may be done in place after the 12-byte IV.
+  int64_t InPlaceOffset() const override;
+
+  // Encrypts a batch of plaintexts as specified by Aead::EncryptBatch, with
+  // consecutive counter values. Fails without encrypting anything if the batch
+  // does not fit into the remaining message budget.
+  crypto::tink::util::Status EncryptBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string *ciphertexts, std::vector<int64_t> *offsets) const {
+    return EncryptBatchWithPrefix(/*output_prefix=*/"", plaintexts,
+                                  associated_data, ciphertexts, offsets);
+  }
+
+  // Like EncryptBatch(), with 'output_prefix' in front of every ciphertext;
+  // see Aead::EncryptBatchWithPrefix.
+  crypto::tink::util::Status EncryptBatchWithPrefix(
+      absl::string_view output_prefix,
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string *ciphertexts, std::vector<int64_t> *offsets) const;
+
+  // Decrypts a batch of ciphertexts as specified by Aead::DecryptBatch.
+  crypto::tink::util::Status DecryptBatch(
+      absl::Span<const absl::string_view> ciphertexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string *plaintexts, std::vector<int64_t> *offsets) const;
+
+  // Returns how many more messages the key can encrypt.
+  int64_t RemainingMessages() const;
+
+ private:
+  // Nonce prefix and message counter shared by all instances of a key.
+  struct KeyState {
+    std::string nonce_prefix;
+    // Next counter value to use. Values beyond `max_messages_` of an instance
+    // are never used for encryption by that instance.
+    std::atomic<int64_t> next_counter{0};
+  };
+
+  ZeroCopyAesGcmCounterNonceBoringSsl(std::unique_ptr<SslOneShotAead> aead,
+                                      std::shared_ptr<KeyState> key_state,
+                                      const Options &options)
+      : aead_(std::move(aead)),
+        key_state_(std::move(key_state)),
+        max_messages_(options.max_messages) {}
+
+  // Returns the state shared by the live instances of `key`, creating it with
+  // a new random nonce prefix if there are none. States are looked up by an
+  // HMAC of the key under a random per-process key, and are removed from the
+  // lookup once the last instance of the key is destroyed.
+  static crypto::tink::util::StatusOr<std::shared_ptr<KeyState>> GetKeyState(
+      const util::SecretData &key);
+
+  // Reserves `num_messages` consecutive counter values, and returns the first
+  // one.
+  crypto::tink::util::StatusOr<int64_t> ReserveCounters(
+      int64_t num_messages) const;
+
+  // Writes the IV for `counter` to `iv`, which has kIvSizeInBytes bytes.
+  void WriteIv(int64_t counter, char *iv) const;
+
+  const std::unique_ptr<SslOneShotAead> aead_;
+  const std::shared_ptr<KeyState> key_state_;
+  const int64_t max_messages_;
+};
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_AEAD_INTERNAL_ZERO_COPY_AES_GCM_COUNTER_NONCE_BORINGSSL_H_
@@ -0,0 +1,336 @@
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/internal/zero_copy_aes_gcm_counter_nonce_boringssl.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/aead/internal/zero_copy_aes_gcm_boringssl.h"
+#include "tink/internal/batch_util.h"
+#include "tink/subtle/subtle_util.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::testing::SizeIs;
+
+constexpr absl::string_view kKey128Hex = "000102030405060708090a0b0c0d0e0f";
+constexpr absl::string_view kMessage = "Some data to encrypt.";
+constexpr absl::string_view kAssociatedData = "Some data to authenticate.";
+
+constexpr int kIvSizeInBytes = 12;
+constexpr int kNoncePrefixSizeInBytes = 8;
+constexpr int kCounterSizeInBytes = 4;
+
+util::SecretData Key() {
+  return util::SecretDataFromStringView(absl::HexStringToBytes(kKey128Hex));
+}
+
+std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> NewCipher(
+    ZeroCopyAesGcmCounterNonceBoringSsl::Options options) {
+  util::StatusOr<std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl>> cipher =
+      ZeroCopyAesGcmCounterNonceBoringSsl::New(Key(), std::move(options));
+  EXPECT_THAT(cipher, IsOk());
+  return *std::move(cipher);
+}
+
+util::StatusOr<std::string> Encrypt(const ZeroCopyAead& cipher,
+                                    absl::string_view plaintext) {
+  std::string ciphertext;
+  subtle::ResizeStringUninitialized(
+      &ciphertext, cipher.MaxEncryptionSize(plaintext.size()));
+  util::StatusOr<int64_t> ciphertext_size =
+      cipher.Encrypt(plaintext, kAssociatedData, absl::MakeSpan(ciphertext));
+  if (!ciphertext_size.ok()) {
+    return ciphertext_size.status();
+  }
+  ciphertext.resize(*ciphertext_size);
+  return ciphertext;
+}
+
+util::StatusOr<std::string> Decrypt(const ZeroCopyAead& cipher,
+                                    absl::string_view ciphertext) {
+  std::string plaintext;
+  subtle::ResizeStringUninitialized(
+      &plaintext, cipher.MaxDecryptionSize(ciphertext.size()));
+  util::StatusOr<int64_t> plaintext_size =
+      cipher.Decrypt(ciphertext, kAssociatedData, absl::MakeSpan(plaintext));
+  if (!plaintext_size.ok()) {
+    return plaintext_size.status();
+  }
+  plaintext.resize(*plaintext_size);
+  return plaintext;
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, EncryptDecrypt) {
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher =
+      NewCipher(ZeroCopyAesGcmCounterNonceBoringSsl::Options());
+  util::StatusOr<std::string> ciphertext = Encrypt(*cipher, kMessage);
+  ASSERT_THAT(ciphertext, IsOk());
+  EXPECT_THAT(*ciphertext, SizeIs(cipher->MaxEncryptionSize(kMessage.size())));
+  util::StatusOr<std::string> plaintext = Decrypt(*cipher, *ciphertext);
+  ASSERT_THAT(plaintext, IsOk());
+  EXPECT_EQ(*plaintext, kMessage);
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, IvsArePrefixAndCounter) {
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher =
+      NewCipher(ZeroCopyAesGcmCounterNonceBoringSsl::Options());
+  std::vector<std::string> ivs;
+  for (int i = 0; i < 3; ++i) {
+    util::StatusOr<std::string> ciphertext = Encrypt(*cipher, kMessage);
+    ASSERT_THAT(ciphertext, IsOk());
+    ivs.push_back(ciphertext->substr(0, kIvSizeInBytes));
+  }
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(ivs[i].substr(0, kNoncePrefixSizeInBytes),
+              ivs[0].substr(0, kNoncePrefixSizeInBytes));
+    EXPECT_EQ(absl::BytesToHexString(ivs[i].substr(kNoncePrefixSizeInBytes)),
+              absl::StrCat("0000000", i));
+  }
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, InstancesOfAKeyShareTheCounter) {
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher1 =
+      NewCipher(ZeroCopyAesGcmCounterNonceBoringSsl::Options());
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher2 =
+      NewCipher(ZeroCopyAesGcmCounterNonceBoringSsl::Options());
+  util::StatusOr<std::string> ciphertext1 = Encrypt(*cipher1, kMessage);
+  util::StatusOr<std::string> ciphertext2 = Encrypt(*cipher2, kMessage);
+  ASSERT_THAT(ciphertext1, IsOk());
+  ASSERT_THAT(ciphertext2, IsOk());
+  EXPECT_EQ(ciphertext1->substr(0, kNoncePrefixSizeInBytes),
+            ciphertext2->substr(0, kNoncePrefixSizeInBytes));
+  EXPECT_EQ(absl::BytesToHexString(ciphertext2->substr(
+                kNoncePrefixSizeInBytes, kCounterSizeInBytes)),
+            "00000001");
+  EXPECT_EQ(cipher1->RemainingMessages(),
+            ZeroCopyAesGcmCounterNonceBoringSsl::kMaxMessagesPerKey - 2);
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, MessageLimitIsPerKey) {
+  ZeroCopyAesGcmCounterNonceBoringSsl::Options options1;
+  options1.max_messages = 2;
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher1 =
+      NewCipher(std::move(options1));
+  ZeroCopyAesGcmCounterNonceBoringSsl::Options options2;
+  options2.max_messages = 3;
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher2 =
+      NewCipher(std::move(options2));
+  EXPECT_THAT(Encrypt(*cipher1, kMessage), IsOk());
+  EXPECT_THAT(Encrypt(*cipher2, kMessage), IsOk());
+  EXPECT_EQ(cipher1->RemainingMessages(), 0);
+  EXPECT_EQ(cipher2->RemainingMessages(), 1);
+  EXPECT_THAT(Encrypt(*cipher1, kMessage).status(),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+  EXPECT_THAT(Encrypt(*cipher2, kMessage), IsOk());
+  EXPECT_THAT(Encrypt(*cipher2, kMessage).status(),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, DifferentKeysDoNotShareCounters) {
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher1 =
+      NewCipher(ZeroCopyAesGcmCounterNonceBoringSsl::Options());
+  util::StatusOr<std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl>> cipher2 =
+      ZeroCopyAesGcmCounterNonceBoringSsl::New(util::SecretDataFromStringView(
+          absl::HexStringToBytes("0f0e0d0c0b0a09080706050403020100")));
+  ASSERT_THAT(cipher2, IsOk());
+  util::StatusOr<std::string> ciphertext1 = Encrypt(*cipher1, kMessage);
+  util::StatusOr<std::string> ciphertext2 = Encrypt(**cipher2, kMessage);
+  ASSERT_THAT(ciphertext1, IsOk());
+  ASSERT_THAT(ciphertext2, IsOk());
+  EXPECT_NE(ciphertext1->substr(0, kNoncePrefixSizeInBytes),
+            ciphertext2->substr(0, kNoncePrefixSizeInBytes));
+  EXPECT_EQ(absl::BytesToHexString(ciphertext2->substr(
+                kNoncePrefixSizeInBytes, kCounterSizeInBytes)),
+            "00000000");
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, NewPrefixOnceKeyIsUnused) {
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher =
+      NewCipher(ZeroCopyAesGcmCounterNonceBoringSsl::Options());
+  util::StatusOr<std::string> ciphertext1 = Encrypt(*cipher, kMessage);
+  ASSERT_THAT(ciphertext1, IsOk());
+  cipher.reset();
+  cipher = NewCipher(ZeroCopyAesGcmCounterNonceBoringSsl::Options());
+  util::StatusOr<std::string> ciphertext2 = Encrypt(*cipher, kMessage);
+  ASSERT_THAT(ciphertext2, IsOk());
+  EXPECT_NE(ciphertext1->substr(0, kNoncePrefixSizeInBytes),
+            ciphertext2->substr(0, kNoncePrefixSizeInBytes));
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, CompatibleWithAesGcm) {
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher =
+      NewCipher(ZeroCopyAesGcmCounterNonceBoringSsl::Options());
+  util::StatusOr<std::unique_ptr<ZeroCopyAesGcmBoringSsl>> aes_gcm =
+      ZeroCopyAesGcmBoringSsl::New(Key());
+  ASSERT_THAT(aes_gcm, IsOk());
+
+  util::StatusOr<std::string> ciphertext = Encrypt(*cipher, kMessage);
+  ASSERT_THAT(ciphertext, IsOk());
+  util::StatusOr<std::string> plaintext = Decrypt(**aes_gcm, *ciphertext);
+  ASSERT_THAT(plaintext, IsOk());
+  EXPECT_EQ(*plaintext, kMessage);
+
+  ciphertext = Encrypt(**aes_gcm, kMessage);
+  ASSERT_THAT(ciphertext, IsOk());
+  plaintext = Decrypt(*cipher, *ciphertext);
+  ASSERT_THAT(plaintext, IsOk());
+  EXPECT_EQ(*plaintext, kMessage);
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, InvalidMessageLimit) {
+  for (int64_t max_messages :
+       {int64_t{0}, int64_t{-1},
+        ZeroCopyAesGcmCounterNonceBoringSsl::kMaxMessagesPerKey + 1}) {
+    ZeroCopyAesGcmCounterNonceBoringSsl::Options options;
+    options.max_messages = max_messages;
+    EXPECT_THAT(
+        ZeroCopyAesGcmCounterNonceBoringSsl::New(Key(), std::move(options))
+            .status(),
+        StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, FailsAfterMessageLimit) {
+  ZeroCopyAesGcmCounterNonceBoringSsl::Options options;
+  options.max_messages = 3;
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher =
+      NewCipher(std::move(options));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(cipher->RemainingMessages(), 3 - i);
+    EXPECT_THAT(Encrypt(*cipher, kMessage), IsOk());
+  }
+  EXPECT_EQ(cipher->RemainingMessages(), 0);
+  EXPECT_THAT(Encrypt(*cipher, kMessage).status(),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+  EXPECT_EQ(cipher->RemainingMessages(), 0);
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, EncryptBatch) {
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher =
+      NewCipher(ZeroCopyAesGcmCounterNonceBoringSsl::Options());
+  ASSERT_THAT(Encrypt(*cipher, kMessage), IsOk());
+  std::vector<absl::string_view> plaintexts = {"", "a", kMessage};
+  std::string ciphertexts;
+  std::vector<int64_t> ciphertext_offsets;
+  ASSERT_THAT(cipher->EncryptBatch(plaintexts, {kAssociatedData},
+                                   &ciphertexts, &ciphertext_offsets),
+              IsOk());
+  for (size_t i = 0; i < plaintexts.size(); ++i) {
+    absl::string_view ciphertext =
+        BatchOutput(ciphertexts, ciphertext_offsets, i);
+    EXPECT_EQ(absl::BytesToHexString(ciphertext.substr(
+                  kNoncePrefixSizeInBytes, kCounterSizeInBytes)),
+              absl::StrCat("0000000", i + 1));
+    util::StatusOr<std::string> plaintext = Decrypt(*cipher, ciphertext);
+    ASSERT_THAT(plaintext, IsOk());
+    EXPECT_EQ(*plaintext, plaintexts[i]);
+  }
+  EXPECT_EQ(cipher->RemainingMessages(),
+            ZeroCopyAesGcmCounterNonceBoringSsl::kMaxMessagesPerKey - 4);
+
+  std::vector<absl::string_view> ciphertext_views;
+  for (size_t i = 0; i < plaintexts.size(); ++i) {
+    ciphertext_views.push_back(BatchOutput(ciphertexts, ciphertext_offsets, i));
+  }
+  std::string decrypted;
+  std::vector<int64_t> decrypted_offsets;
+  ASSERT_THAT(cipher->DecryptBatch(ciphertext_views, {kAssociatedData},
+                                   &decrypted, &decrypted_offsets),
+              IsOk());
+  for (size_t i = 0; i < plaintexts.size(); ++i) {
+    EXPECT_EQ(BatchOutput(decrypted, decrypted_offsets, i), plaintexts[i]);
+  }
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest, BatchOverLimitUsesNoBudget) {
+  ZeroCopyAesGcmCounterNonceBoringSsl::Options options;
+  options.max_messages = 2;
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher =
+      NewCipher(std::move(options));
+  std::vector<absl::string_view> plaintexts = {"a", "b", "c"};
+  std::string ciphertexts;
+  std::vector<int64_t> offsets;
+  EXPECT_THAT(cipher->EncryptBatch(plaintexts, {}, &ciphertexts, &offsets),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+  std::vector<absl::string_view> associated_data = {"x", "y"};
+  EXPECT_THAT(cipher->EncryptBatch(plaintexts, associated_data, &ciphertexts,
+                                   &offsets),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(cipher->RemainingMessages(), 2);
+  EXPECT_THAT(cipher->EncryptBatch(absl::MakeConstSpan(plaintexts).subspan(1),
+                                   {}, &ciphertexts, &offsets),
+              IsOk());
+  EXPECT_EQ(cipher->RemainingMessages(), 0);
+}
+
+TEST(ZeroCopyAesGcmCounterNonceBoringSslTest,
+     ConcurrentEncryptionsUseDistinctIvs) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumMessages = 200;
+  ZeroCopyAesGcmCounterNonceBoringSsl::Options options;
+  options.max_messages = kNumThreads * kNumMessages;
+  std::unique_ptr<ZeroCopyAesGcmCounterNonceBoringSsl> cipher =
+      NewCipher(std::move(options));
+  std::vector<std::vector<std::string>> ivs(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&cipher, &ivs, t]() {
+      for (int i = 0; i < kNumMessages; ++i) {
+        util::StatusOr<std::string> ciphertext = Encrypt(*cipher, kMessage);
+        ASSERT_THAT(ciphertext, IsOk());
+        ivs[t].push_back(ciphertext->substr(0, kIvSizeInBytes));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  absl::flat_hash_set<std::string> unique_ivs;
+  for (const std::vector<std::string>& thread_ivs : ivs) {
+    unique_ivs.insert(thread_ivs.begin(), thread_ivs.end());
+  }
+  EXPECT_THAT(unique_ivs, SizeIs(kNumThreads * kNumMessages));
+  EXPECT_EQ(cipher->RemainingMessages(), 0);
+  EXPECT_THAT(Encrypt(*cipher, kMessage).status(),
+              StatusIs(absl::StatusCode::kResourceExhausted));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,125 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_AEAD_X_AES_GCM_KEY_MANAGER_H_
+#define TINK_AEAD_X_AES_GCM_KEY_MANAGER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <string>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "tink/aead.h"
+#include "tink/aead/internal/x_aes_gcm_boringssl.h"
+#include "tink/core/key_type_manager.h"
+#include "tink/core/template_util.h"
+#include "tink/subtle/random.h"
+#include "tink/util/constants.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "tink/util/validation.h"
+#include "proto/tink.pb.h"
+#include "proto/x_aes_gcm.pb.h"
+
+namespace crypto {
+namespace tink {
+
+class XAesGcmKeyManager
+    : public KeyTypeManager<google::crypto::tink::XAesGcmKey,
+                            google::crypto::tink::XAesGcmKeyFormat,
+                            List<Aead>> {
+ public:
+  class AeadFactory : public PrimitiveFactory<Aead> {
+    crypto::tink::util::StatusOr<std::unique_ptr<Aead>> Create(
+        const google::crypto::tink::XAesGcmKey& key) const override {
+      return internal::XAesGcmBoringSsl::New(
+          util::SecretDataFromStringView(key.key_value()),
+          key.params().salt_size());
+    }
+  };
+
+  XAesGcmKeyManager() : KeyTypeManager(absl::make_unique<AeadFactory>()) {}
+
+  uint32_t get_version() const override { return 0; }
+
+  google::crypto::tink::KeyData::KeyMaterialType key_material_type()
+      const override {
+    return google::crypto::tink::KeyData::SYMMETRIC;
+  }
+
+  const std::string& get_key_type() const override { return key_type_; }
+
+  crypto::tink::util::Status ValidateKey(
+      const google::crypto::tink::XAesGcmKey& key) const override {
+    crypto::tink::util::Status status =
+        ValidateVersion(key.version(), get_version());
+    if (!status.ok()) return status;
+    if (key.key_value().size() != kKeySizeInBytes) {
+      return crypto::tink::util::Status(
+          absl::StatusCode::kInvalidArgument,
+          absl::StrCat("Invalid key size; expected ", kKeySizeInBytes,
+                       " bytes, got ", key.key_value().size()));
+    }
+    return ValidateParams(key.params());
+  }
+
+  crypto::tink::util::Status ValidateKeyFormat(
+      const google::crypto::tink::XAesGcmKeyFormat& format) const override {
+    crypto::tink::util::Status status =
+        ValidateVersion(format.version(), get_version());
+    if (!status.ok()) return status;
+    return ValidateParams(format.params());
+  }
+
+  crypto::tink::util::StatusOr<google::crypto::tink::XAesGcmKey> CreateKey(
+      const google::crypto::tink::XAesGcmKeyFormat& format) const override {
+    google::crypto::tink::XAesGcmKey key;
+    key.set_version(get_version());
+    *key.mutable_params() = format.params();
+    key.set_key_value(subtle::Random::GetRandomBytes(kKeySizeInBytes));
+    return key;
+  }
+
+ private:
+  static constexpr int kKeySizeInBytes = 32;
+  static constexpr int kMinSaltSizeInBytes = 8;
+  static constexpr int kMaxSaltSizeInBytes = 12;
+
+  static crypto::tink::util::Status ValidateParams(
+      const google::crypto::tink::XAesGcmParams& params) {
+    if (params.salt_size() < kMinSaltSizeInBytes ||
+        params.salt_size() > kMaxSaltSizeInBytes) {
+      return crypto::tink::util::Status(
+          absl::StatusCode::kInvalidArgument,
+          absl::StrCat("Salt size should be between ", kMinSaltSizeInBytes,
+                       " and ", kMaxSaltSizeInBytes, " bytes, got ",
+                       params.salt_size()));
+    }
+    return crypto::tink::util::OkStatus();
+  }
+
+  const std::string key_type_ = absl::StrCat(
+      kTypeGoogleapisCom, google::crypto::tink::XAesGcmKey().GetTypeName());
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_AEAD_X_AES_GCM_KEY_MANAGER_H_
@@ -0,0 +1,147 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/x_aes_gcm_key_manager.h"
+
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "tink/aead.h"
+#include "tink/aead/internal/x_aes_gcm_boringssl.h"
+#include "tink/internal/fips_utils.h"
+#include "tink/subtle/aead_test_util.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+#include "proto/tink.pb.h"
+#include "proto/x_aes_gcm.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::crypto::tink::util::StatusOr;
+using ::google::crypto::tink::XAesGcmKey;
+using ::google::crypto::tink::XAesGcmKeyFormat;
+using ::testing::Eq;
+using ::testing::SizeIs;
+
+XAesGcmKeyFormat KeyFormat(int salt_size) {
+  XAesGcmKeyFormat format;
+  format.set_version(0);
+  format.mutable_params()->set_salt_size(salt_size);
+  return format;
+}
+
+XAesGcmKey Key(int salt_size) {
+  XAesGcmKey key;
+  key.set_version(0);
+  key.mutable_params()->set_salt_size(salt_size);
+  key.set_key_value("01234567890123456789012345678901");
+  return key;
+}
+
+TEST(XAesGcmKeyManagerTest, Basics) {
+  EXPECT_THAT(XAesGcmKeyManager().get_version(), Eq(0));
+  EXPECT_THAT(XAesGcmKeyManager().get_key_type(),
+              Eq("type.googleapis.com/google.crypto.tink.XAesGcmKey"));
+  EXPECT_THAT(XAesGcmKeyManager().key_material_type(),
+              Eq(google::crypto::tink::KeyData::SYMMETRIC));
+}
+
+TEST(XAesGcmKeyManagerTest, ValidateEmptyKey) {
+  EXPECT_THAT(XAesGcmKeyManager().ValidateKey(XAesGcmKey()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(XAesGcmKeyManagerTest, ValidateKey) {
+  for (int salt_size = 8; salt_size <= 12; ++salt_size) {
+    EXPECT_THAT(XAesGcmKeyManager().ValidateKey(Key(salt_size)), IsOk());
+  }
+}
+
+TEST(XAesGcmKeyManagerTest, ValidateKeyWithInvalidSaltSize) {
+  for (int salt_size : {0, 7, 13}) {
+    EXPECT_THAT(XAesGcmKeyManager().ValidateKey(Key(salt_size)),
+                StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
+TEST(XAesGcmKeyManagerTest, ValidateKeyWithInvalidKeySize) {
+  XAesGcmKey key = Key(12);
+  for (int key_size : {0, 16, 31, 33}) {
+    key.set_key_value(std::string(key_size, 'a'));
+    EXPECT_THAT(XAesGcmKeyManager().ValidateKey(key),
+                StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
+TEST(XAesGcmKeyManagerTest, ValidateKeyWithInvalidVersion) {
+  XAesGcmKey key = Key(12);
+  key.set_version(1);
+  EXPECT_THAT(XAesGcmKeyManager().ValidateKey(key),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(XAesGcmKeyManagerTest, ValidateKeyFormat) {
+  for (int salt_size = 8; salt_size <= 12; ++salt_size) {
+    EXPECT_THAT(XAesGcmKeyManager().ValidateKeyFormat(KeyFormat(salt_size)),
+                IsOk());
+  }
+  for (int salt_size : {0, 7, 13}) {
+    EXPECT_THAT(XAesGcmKeyManager().ValidateKeyFormat(KeyFormat(salt_size)),
+                StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
+TEST(XAesGcmKeyManagerTest, CreateKey) {
+  XAesGcmKeyFormat format = KeyFormat(10);
+  StatusOr<XAesGcmKey> key = XAesGcmKeyManager().CreateKey(format);
+  ASSERT_THAT(key, IsOk());
+  EXPECT_THAT(key->version(), Eq(0));
+  EXPECT_THAT(key->key_value(), SizeIs(32));
+  EXPECT_THAT(key->params().salt_size(), Eq(10));
+  EXPECT_THAT(XAesGcmKeyManager().ValidateKey(*key), IsOk());
+}
+
+TEST(XAesGcmKeyManagerTest, CreateAead) {
+  if (internal::IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  StatusOr<XAesGcmKey> key = XAesGcmKeyManager().CreateKey(KeyFormat(12));
+  ASSERT_THAT(key, IsOk());
+
+  StatusOr<std::unique_ptr<Aead>> aead =
+      XAesGcmKeyManager().GetPrimitive<Aead>(*key);
+  ASSERT_THAT(aead, IsOk());
+
+  StatusOr<std::unique_ptr<Aead>> direct_aead =
+      internal::XAesGcmBoringSsl::New(
+          util::SecretDataFromStringView(key->key_value()),
+          key->params().salt_size());
+  ASSERT_THAT(direct_aead, IsOk());
+  EXPECT_THAT(EncryptThenDecrypt(**aead, **direct_aead, "message", "aad"),
+              IsOk());
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,163 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "tink/aead/x_aes_gcm_key.h"
+
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/types/optional.h"
+#include "tink/aead/x_aes_gcm_parameters.h"
+#include "tink/partial_key_access.h"
+#include "tink/restricted_data.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::testing::Eq;
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+struct TestCase {
+  XAesGcmParameters::Variant variant;
+  absl::optional<int> id_requirement;
+  std::string output_prefix;
+};
+
+using XAesGcmKeyTest = TestWithParam<TestCase>;
+
+INSTANTIATE_TEST_SUITE_P(
+    XAesGcmKeyTestSuite, XAesGcmKeyTest,
+    Values(TestCase{XAesGcmParameters::Variant::kTink, 0x02030400,
+                    std::string("\x01\x02\x03\x04\x00", 5)},
+           TestCase{XAesGcmParameters::Variant::kNoPrefix, absl::nullopt,
+                    ""}));
+
+TEST_P(XAesGcmKeyTest, CreateSucceeds) {
+  TestCase test_case = GetParam();
+  util::StatusOr<XAesGcmParameters> params =
+      XAesGcmParameters::Create(test_case.variant, /*salt_size_bytes=*/12);
+  ASSERT_THAT(params, IsOk());
+
+  RestrictedData secret = RestrictedData(/*num_random_bytes=*/32);
+  util::StatusOr<XAesGcmKey> key = XAesGcmKey::Create(
+      *params, secret, test_case.id_requirement, GetPartialKeyAccess());
+  ASSERT_THAT(key, IsOk());
+
+  EXPECT_THAT(key->GetParameters(), Eq(*params));
+  EXPECT_THAT(key->GetIdRequirement(), Eq(test_case.id_requirement));
+  EXPECT_THAT(key->GetOutputPrefix(), Eq(test_case.output_prefix));
+  EXPECT_THAT(key->GetKeyBytes(GetPartialKeyAccess()), Eq(secret));
+}
+
+TEST(XAesGcmKeyTest, CreateKeyWithInvalidKeySizeFails) {
+  util::StatusOr<XAesGcmParameters> params =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kTink, 12);
+  ASSERT_THAT(params, IsOk());
+
+  for (int key_size : {16, 31, 33}) {
+    EXPECT_THAT(XAesGcmKey::Create(*params, RestrictedData(key_size),
+                                   /*id_requirement=*/123,
+                                   GetPartialKeyAccess())
+                    .status(),
+                StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
+TEST(XAesGcmKeyTest, CreateKeyWithInvalidIdRequirementFails) {
+  util::StatusOr<XAesGcmParameters> no_prefix_params =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kNoPrefix, 12);
+  ASSERT_THAT(no_prefix_params, IsOk());
+  util::StatusOr<XAesGcmParameters> tink_params =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kTink, 12);
+  ASSERT_THAT(tink_params, IsOk());
+
+  RestrictedData secret = RestrictedData(/*num_random_bytes=*/32);
+  EXPECT_THAT(XAesGcmKey::Create(*no_prefix_params, secret,
+                                 /*id_requirement=*/123, GetPartialKeyAccess())
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(XAesGcmKey::Create(*tink_params, secret,
+                                 /*id_requirement=*/absl::nullopt,
+                                 GetPartialKeyAccess())
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_P(XAesGcmKeyTest, KeyEquals) {
+  TestCase test_case = GetParam();
+  util::StatusOr<XAesGcmParameters> params =
+      XAesGcmParameters::Create(test_case.variant, 12);
+  ASSERT_THAT(params, IsOk());
+
+  RestrictedData secret = RestrictedData(/*num_random_bytes=*/32);
+  util::StatusOr<XAesGcmKey> key = XAesGcmKey::Create(
+      *params, secret, test_case.id_requirement, GetPartialKeyAccess());
+  ASSERT_THAT(key, IsOk());
+  util::StatusOr<XAesGcmKey> other_key = XAesGcmKey::Create(
+      *params, secret, test_case.id_requirement, GetPartialKeyAccess());
+  ASSERT_THAT(other_key, IsOk());
+
+  EXPECT_TRUE(*key == *other_key);
+  EXPECT_FALSE(*key != *other_key);
+}
+
+TEST(XAesGcmKeyTest, DifferentKeyBytesNotEqual) {
+  util::StatusOr<XAesGcmParameters> params =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kTink, 12);
+  ASSERT_THAT(params, IsOk());
+
+  util::StatusOr<XAesGcmKey> key =
+      XAesGcmKey::Create(*params, RestrictedData(/*num_random_bytes=*/32),
+                         /*id_requirement=*/123, GetPartialKeyAccess());
+  ASSERT_THAT(key, IsOk());
+  util::StatusOr<XAesGcmKey> other_key =
+      XAesGcmKey::Create(*params, RestrictedData(/*num_random_bytes=*/32),
+                         /*id_requirement=*/123, GetPartialKeyAccess());
+  ASSERT_THAT(other_key, IsOk());
+
+  EXPECT_TRUE(*key != *other_key);
+  EXPECT_FALSE(*key == *other_key);
+}
+
+TEST(XAesGcmKeyTest, DifferentSaltSizeNotEqual) {
+  util::StatusOr<XAesGcmParameters> params =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kTink, 12);
+  ASSERT_THAT(params, IsOk());
+  util::StatusOr<XAesGcmParameters> other_params =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kTink, 8);
+  ASSERT_THAT(other_params, IsOk());
+
+  RestrictedData secret = RestrictedData(/*num_random_bytes=*/32);
+  util::StatusOr<XAesGcmKey> key = XAesGcmKey::Create(
+      *params, secret, /*id_requirement=*/123, GetPartialKeyAccess());
+  ASSERT_THAT(key, IsOk());
+  util::StatusOr<XAesGcmKey> other_key = XAesGcmKey::Create(
+      *other_params, secret, /*id_requirement=*/123, GetPartialKeyAccess());
+  ASSERT_THAT(other_key, IsOk());
+
+  EXPECT_TRUE(*key != *other_key);
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
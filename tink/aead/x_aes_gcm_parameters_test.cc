@@ -0,0 +1,116 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "tink/aead/x_aes_gcm_parameters.h"
+
+#include <tuple>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "tink/parameters.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::testing::Combine;
+using ::testing::Eq;
+using ::testing::Range;
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+using XAesGcmParametersCreateTest =
+    TestWithParam<std::tuple<XAesGcmParameters::Variant, int>>;
+
+INSTANTIATE_TEST_SUITE_P(
+    XAesGcmParametersCreateTestSuite, XAesGcmParametersCreateTest,
+    Combine(Values(XAesGcmParameters::Variant::kTink,
+                   XAesGcmParameters::Variant::kNoPrefix),
+            Range(8, 13)));
+
+TEST_P(XAesGcmParametersCreateTest, Create) {
+  XAesGcmParameters::Variant variant;
+  int salt_size;
+  std::tie(variant, salt_size) = GetParam();
+
+  util::StatusOr<XAesGcmParameters> parameters =
+      XAesGcmParameters::Create(variant, salt_size);
+  ASSERT_THAT(parameters, IsOk());
+
+  EXPECT_THAT(parameters->KeySizeInBytes(), Eq(32));
+  EXPECT_THAT(parameters->SaltSizeBytes(), Eq(salt_size));
+  EXPECT_THAT(parameters->GetVariant(), Eq(variant));
+  EXPECT_THAT(parameters->HasIdRequirement(),
+              Eq(variant == XAesGcmParameters::Variant::kTink));
+}
+
+TEST(XAesGcmParametersTest, CreateWithInvalidVariantFails) {
+  EXPECT_THAT(XAesGcmParameters::Create(
+                  XAesGcmParameters::Variant::
+                      kDoNotUseInsteadUseDefaultWhenWritingSwitchStatements,
+                  /*salt_size_bytes=*/12)
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(XAesGcmParametersTest, CreateWithInvalidSaltSizeFails) {
+  for (int salt_size : {-1, 0, 7, 13, 24}) {
+    EXPECT_THAT(XAesGcmParameters::Create(XAesGcmParameters::Variant::kTink,
+                                          salt_size)
+                    .status(),
+                StatusIs(absl::StatusCode::kInvalidArgument));
+  }
+}
+
+TEST(XAesGcmParametersTest, CopyConstructor) {
+  util::StatusOr<XAesGcmParameters> parameters =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kTink, 10);
+  ASSERT_THAT(parameters, IsOk());
+
+  XAesGcmParameters copy(*parameters);
+  EXPECT_THAT(copy.SaltSizeBytes(), Eq(10));
+  EXPECT_THAT(copy.GetVariant(), Eq(XAesGcmParameters::Variant::kTink));
+}
+
+TEST(XAesGcmParametersTest, Equals) {
+  util::StatusOr<XAesGcmParameters> parameters =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kTink, 12);
+  ASSERT_THAT(parameters, IsOk());
+  util::StatusOr<XAesGcmParameters> same =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kTink, 12);
+  ASSERT_THAT(same, IsOk());
+  util::StatusOr<XAesGcmParameters> other_variant =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kNoPrefix, 12);
+  ASSERT_THAT(other_variant, IsOk());
+  util::StatusOr<XAesGcmParameters> other_salt_size =
+      XAesGcmParameters::Create(XAesGcmParameters::Variant::kTink, 8);
+  ASSERT_THAT(other_salt_size, IsOk());
+
+  EXPECT_TRUE(*parameters == *same);
+  EXPECT_FALSE(*parameters != *same);
+  EXPECT_FALSE(*parameters == *other_variant);
+  EXPECT_TRUE(*parameters != *other_variant);
+  EXPECT_FALSE(*parameters == *other_salt_size);
+  EXPECT_TRUE(*parameters != *other_salt_size);
+}
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
@@ -25,6 +25,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "tink/aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/core/key_type_manager.h"
 #include "tink/core/template_util.h"
 #include "tink/input_stream.h"
@@ -45,7 +46,7 @@ namespace tink {
 class XChaCha20Poly1305KeyManager
     : public KeyTypeManager<google::crypto::tink::XChaCha20Poly1305Key,
                             google::crypto::tink::XChaCha20Poly1305KeyFormat,
-                            List<Aead>> {
+                            List<Aead, ZeroCopyAead>> {
  public:
   class AeadFactory : public PrimitiveFactory<Aead> {
     crypto::tink::util::StatusOr<std::unique_ptr<Aead>> Create(
@@ -55,8 +56,17 @@ class XChaCha20Poly1305KeyManager
     }
   };
 
+  class ZeroCopyAeadFactory : public PrimitiveFactory<ZeroCopyAead> {
+    crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>> Create(
+        const google::crypto::tink::XChaCha20Poly1305Key& key) const override {
+      return subtle::XChacha20Poly1305BoringSsl::NewZeroCopy(
+          util::SecretDataFromStringView(key.key_value()));
+    }
+  };
+
   XChaCha20Poly1305KeyManager()
-      : KeyTypeManager(absl::make_unique<AeadFactory>()) {}
+      : KeyTypeManager(absl::make_unique<AeadFactory>(),
+                       absl::make_unique<ZeroCopyAeadFactory>()) {}
 
   uint32_t get_version() const override { return 0; }
 
@@ -0,0 +1,289 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/zero_copy_aead_wrapper.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/aead/zero_copy_aead.h"
+#include "tink/crypto_format.h"
+#include "tink/internal/monitoring_util.h"
+#include "tink/internal/output_prefix_index.h"
+#include "tink/internal/registry_impl.h"
+#include "tink/internal/util.h"
+#include "tink/monitoring/monitoring.h"
+#include "tink/primitive_set.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+namespace {
+
+constexpr absl::string_view kPrimitive = "aead";
+constexpr absl::string_view kEncryptApi = "encrypt";
+constexpr absl::string_view kDecryptApi = "decrypt";
+
+using ZeroCopyAeadEntry = PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>;
+
+util::Status Validate(PrimitiveSet<ZeroCopyAead>* aead_set) {
+  if (aead_set == nullptr) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "aead_set must be non-NULL");
+  }
+  if (aead_set->get_primary() == nullptr) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "aead_set has no primary");
+  }
+  return util::OkStatus();
+}
+
+class ZeroCopyAeadSetWrapper : public ZeroCopyAead {
+ public:
+  explicit ZeroCopyAeadSetWrapper(
+      std::unique_ptr<PrimitiveSet<ZeroCopyAead>> aead_set,
+      std::unique_ptr<MonitoringClient> monitoring_encryption_client = nullptr,
+      std::unique_ptr<MonitoringClient> monitoring_decryption_client = nullptr)
+      : aead_set_(std::move(aead_set)),
+        entries_(aead_set_->get_all()),
+        prefix_index_(*aead_set_),
+        monitoring_encryption_client_(std::move(monitoring_encryption_client)),
+        monitoring_decryption_client_(std::move(monitoring_decryption_client)) {
+  }
+
+  int64_t MaxEncryptionSize(int64_t plaintext_size) const override;
+
+  util::StatusOr<int64_t> Encrypt(absl::string_view plaintext,
+                                  absl::string_view associated_data,
+                                  absl::Span<char> buffer) const override;
+
+  int64_t MaxDecryptionSize(int64_t ciphertext_size) const override;
+
+  util::StatusOr<int64_t> Decrypt(absl::string_view ciphertext,
+                                  absl::string_view associated_data,
+                                  absl::Span<char> buffer) const override;
+
+  int64_t InPlaceOffset() const override;
+
+  ~ZeroCopyAeadSetWrapper() override = default;
+
+ private:
+  // Decrypts `ciphertext` into `buffer` with the matching key, without
+  // logging to monitoring. On success, `key_id` and `raw_ciphertext_size` are
+  // set to the ID of the key that decrypted, and the size of the ciphertext
+  // without the output prefix.
+  util::StatusOr<int64_t> DecryptWithoutMonitoring(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> buffer, uint32_t* key_id,
+      int64_t* raw_ciphertext_size) const;
+
+  std::unique_ptr<PrimitiveSet<ZeroCopyAead>> aead_set_;
+  // All entries of `aead_set_`, to bound the size of any plaintext.
+  const std::vector<ZeroCopyAeadEntry*> entries_;
+  const internal::OutputPrefixIndex<ZeroCopyAead> prefix_index_;
+  std::unique_ptr<MonitoringClient> monitoring_encryption_client_;
+  std::unique_ptr<MonitoringClient> monitoring_decryption_client_;
+};
+
+int64_t ZeroCopyAeadSetWrapper::MaxEncryptionSize(
+    int64_t plaintext_size) const {
+  const ZeroCopyAeadEntry* primary = aead_set_->get_primary();
+  return primary->get_identifier().size() +
+         primary->get_primitive().MaxEncryptionSize(plaintext_size);
+}
+
+util::StatusOr<int64_t> ZeroCopyAeadSetWrapper::Encrypt(
+    absl::string_view plaintext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
+  const ZeroCopyAeadEntry* primary = aead_set_->get_primary();
+  const std::string& prefix = primary->get_identifier();
+  if (buffer.size() < prefix.size()) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Encryption buffer too small; expected at least ",
+                     MaxEncryptionSize(plaintext.size()), " bytes, got ",
+                     buffer.size()));
+  }
+  // The prefix is written before the primary sees the buffer; the primary
+  // checks the overlap with the rest of the buffer, which is allowed for
+  // in-place encryption.
+  if (internal::BuffersOverlap(
+          plaintext, absl::string_view(buffer.data(), prefix.size()))) {
+    return util::Status(
+        absl::StatusCode::kFailedPrecondition,
+        "Plaintext and ciphertext buffers overlap; this is disallowed");
+  }
+  std::memcpy(buffer.data(), prefix.data(), prefix.size());
+  util::StatusOr<int64_t> written_bytes = primary->get_primitive().Encrypt(
+      plaintext, associated_data, buffer.subspan(prefix.size()));
+  if (!written_bytes.ok()) {
+    if (monitoring_encryption_client_ != nullptr) {
+      monitoring_encryption_client_->LogFailure();
+    }
+    return written_bytes.status();
+  }
+  if (monitoring_encryption_client_ != nullptr) {
+    monitoring_encryption_client_->Log(primary->get_key_id(),
+                                       plaintext.size());
+  }
+  return prefix.size() + *written_bytes;
+}
+
+int64_t ZeroCopyAeadSetWrapper::MaxDecryptionSize(
+    int64_t ciphertext_size) const {
+  // Any of the keys may decrypt, in particular RAW keys which see the whole
+  // ciphertext.
+  int64_t max_decryption_size = 0;
+  for (const ZeroCopyAeadEntry* entry : entries_) {
+    max_decryption_size =
+        std::max(max_decryption_size,
+                 entry->get_primitive().MaxDecryptionSize(ciphertext_size));
+  }
+  return max_decryption_size;
+}
+
+util::StatusOr<int64_t> ZeroCopyAeadSetWrapper::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
+  uint32_t key_id;
+  int64_t raw_ciphertext_size;
+  util::StatusOr<int64_t> written_bytes = DecryptWithoutMonitoring(
+      ciphertext, associated_data, buffer, &key_id, &raw_ciphertext_size);
+  if (monitoring_decryption_client_ != nullptr) {
+    if (written_bytes.ok()) {
+      monitoring_decryption_client_->Log(key_id, raw_ciphertext_size);
+    } else {
+      monitoring_decryption_client_->LogFailure();
+    }
+  }
+  return written_bytes;
+}
+
+util::StatusOr<int64_t> ZeroCopyAeadSetWrapper::DecryptWithoutMonitoring(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    absl::Span<char> buffer, uint32_t* key_id,
+    int64_t* raw_ciphertext_size) const {
+  absl::Span<ZeroCopyAeadEntry* const> prefix_entries;
+  if (ciphertext.size() > CryptoFormat::kNonRawPrefixSize) {
+    prefix_entries = prefix_index_.Find(ciphertext);
+  }
+  absl::Span<ZeroCopyAeadEntry* const> raw_entries =
+      prefix_index_.raw_entries();
+
+  // A failed in-place decryption may overwrite the ciphertext, so it can only
+  // be attempted with a single key.
+  if (internal::BuffersOverlap(
+          ciphertext, absl::string_view(buffer.data(), buffer.size()))) {
+    const size_t num_candidates = prefix_entries.size() + raw_entries.size();
+    if (num_candidates != 1) {
+      return util::Status(
+          absl::StatusCode::kFailedPrecondition,
+          absl::StrCat("In-place decryption requires exactly one candidate "
+                       "key, got ",
+                       num_candidates));
+    }
+  }
+
+  if (!prefix_entries.empty()) {
+    absl::string_view raw_ciphertext =
+        ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
+    for (const ZeroCopyAeadEntry* entry : prefix_entries) {
+      util::StatusOr<int64_t> written_bytes = entry->get_primitive().Decrypt(
+          raw_ciphertext, associated_data, buffer);
+      if (written_bytes.ok()) {
+        *key_id = entry->get_key_id();
+        *raw_ciphertext_size = raw_ciphertext.size();
+        return written_bytes;
+      }
+    }
+  }
+
+  // No matching key succeeded with decryption, try all RAW keys.
+  for (const ZeroCopyAeadEntry* entry : raw_entries) {
+    util::StatusOr<int64_t> written_bytes =
+        entry->get_primitive().Decrypt(ciphertext, associated_data, buffer);
+    if (written_bytes.ok()) {
+      *key_id = entry->get_key_id();
+      *raw_ciphertext_size = ciphertext.size();
+      return written_bytes;
+    }
+  }
+  return util::Status(absl::StatusCode::kInvalidArgument, "decryption failed");
+}
+
+int64_t ZeroCopyAeadSetWrapper::InPlaceOffset() const {
+  const ZeroCopyAeadEntry* primary = aead_set_->get_primary();
+  const int64_t offset = primary->get_primitive().InPlaceOffset();
+  if (offset < 0) {
+    return -1;
+  }
+  return primary->get_identifier().size() + offset;
+}
+
+}  // namespace
+
+util::StatusOr<std::unique_ptr<ZeroCopyAead>> ZeroCopyAeadWrapper::Wrap(
+    std::unique_ptr<PrimitiveSet<ZeroCopyAead>> aead_set) const {
+  util::Status status = Validate(aead_set.get());
+  if (!status.ok()) return status;
+
+  MonitoringClientFactory* const monitoring_factory =
+      internal::RegistryImpl::GlobalInstance().GetMonitoringClientFactory();
+
+  // Monitoring is not enabled. Create a wrapper without monitoring clients.
+  if (monitoring_factory == nullptr) {
+    return {absl::make_unique<ZeroCopyAeadSetWrapper>(std::move(aead_set))};
+  }
+
+  util::StatusOr<MonitoringKeySetInfo> keyset_info =
+      internal::MonitoringKeySetInfoFromPrimitiveSet(*aead_set);
+  if (!keyset_info.ok()) {
+    return keyset_info.status();
+  }
+
+  util::StatusOr<std::unique_ptr<MonitoringClient>>
+      monitoring_encryption_client = monitoring_factory->New(
+          MonitoringContext(kPrimitive, kEncryptApi, *keyset_info));
+  if (!monitoring_encryption_client.ok()) {
+    return monitoring_encryption_client.status();
+  }
+
+  util::StatusOr<std::unique_ptr<MonitoringClient>>
+      monitoring_decryption_client = monitoring_factory->New(
+          MonitoringContext(kPrimitive, kDecryptApi, *keyset_info));
+  if (!monitoring_decryption_client.ok()) {
+    return monitoring_decryption_client.status();
+  }
+
+  return {absl::make_unique<ZeroCopyAeadSetWrapper>(
+      std::move(aead_set), *std::move(monitoring_encryption_client),
+      *std::move(monitoring_decryption_client))};
+}
+
+}  // namespace tink
+}  // namespace crypto
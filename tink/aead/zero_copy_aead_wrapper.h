@@ -0,0 +1,53 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_AEAD_ZERO_COPY_AEAD_WRAPPER_H_
+#define TINK_AEAD_ZERO_COPY_AEAD_WRAPPER_H_
+
+#include <memory>
+
+#include "tink/aead/zero_copy_aead.h"
+#include "tink/primitive_set.h"
+#include "tink/primitive_wrapper.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+// Wraps a set of ZeroCopyAead-instances that correspond to a keyset,
+// and combines them into a single ZeroCopyAead-primitive, that uses the
+// provided instances, depending on the context:
+//   * ZeroCopyAead::Encrypt(...) uses the primary instance from the set
+//   * ZeroCopyAead::Decrypt(...) uses the instance that matches the ciphertext
+//   prefix.
+// The output prefix of the primary is written directly into the caller's
+// buffer, followed by the ciphertext of the primary instance. In-place
+// operation is supported if the primary supports it; in-place decryption
+// additionally requires that exactly one key of the set may decrypt the
+// ciphertext, since a failed attempt may overwrite it.
+class ZeroCopyAeadWrapper
+    : public PrimitiveWrapper<ZeroCopyAead, ZeroCopyAead> {
+ public:
+  // Returns a ZeroCopyAead-primitive that uses ZeroCopyAead-instances provided
+  // in 'aead_set', which must be non-NULL and must contain a primary instance.
+  util::StatusOr<std::unique_ptr<ZeroCopyAead>> Wrap(
+      std::unique_ptr<PrimitiveSet<ZeroCopyAead>> aead_set) const override;
+};
+
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_AEAD_ZERO_COPY_AEAD_WRAPPER_H_
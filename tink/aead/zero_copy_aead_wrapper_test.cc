@@ -0,0 +1,462 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead/zero_copy_aead_wrapper.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/aead.h"
+#include "tink/aead/aead_config.h"
+#include "tink/aead/aead_key_templates.h"
+#include "tink/aead/zero_copy_aead.h"
+#include "tink/config/global_registry.h"
+#include "tink/crypto_format.h"
+#include "tink/internal/fips_utils.h"
+#include "tink/internal/registry_impl.h"
+#include "tink/internal/ssl_util.h"
+#include "tink/keyset_handle.h"
+#include "tink/monitoring/monitoring.h"
+#include "tink/monitoring/monitoring_client_mocks.h"
+#include "tink/primitive_set.h"
+#include "tink/registry.h"
+#include "tink/subtle/aes_ctr_boringssl.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/encrypt_then_authenticate.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/stateful_hmac_boringssl.h"
+#include "tink/subtle/subtle_util.h"
+#include "tink/subtle/xchacha20_poly1305_boringssl.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::crypto::tink::util::StatusOr;
+using ::google::crypto::tink::KeysetInfo;
+using ::google::crypto::tink::KeyStatusType;
+using ::google::crypto::tink::KeyTemplate;
+using ::google::crypto::tink::OutputPrefixType;
+using ::testing::_;
+using ::testing::ByMove;
+using ::testing::HasSubstr;
+using ::testing::IsNull;
+using ::testing::Not;
+using ::testing::Return;
+using ::testing::StrictMock;
+using ::testing::Test;
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+constexpr absl::string_view kPlaintext = "Some data to encrypt.";
+constexpr absl::string_view kAad = "Some data to authenticate.";
+
+std::unique_ptr<ZeroCopyAead> NewXChaCha20Poly1305() {
+  StatusOr<std::unique_ptr<ZeroCopyAead>> aead =
+      subtle::XChacha20Poly1305BoringSsl::NewZeroCopy(
+          util::SecretDataFromStringView(subtle::Random::GetRandomBytes(32)));
+  EXPECT_THAT(aead, IsOk());
+  return *std::move(aead);
+}
+
+// AES-CTR-HMAC-SHA256, which is available with any SSL library.
+std::unique_ptr<ZeroCopyAead> NewAesCtrHmac() {
+  StatusOr<std::unique_ptr<subtle::IndCpaCipher>> aes_ctr =
+      subtle::AesCtrBoringSsl::New(
+          util::SecretDataFromStringView(subtle::Random::GetRandomBytes(16)),
+          /*iv_size=*/16);
+  EXPECT_THAT(aes_ctr, IsOk());
+  StatusOr<std::unique_ptr<ZeroCopyAead>> aead =
+      subtle::EncryptThenAuthenticate::NewZeroCopy(
+          *std::move(aes_ctr),
+          absl::make_unique<subtle::StatefulHmacBoringSslFactory>(
+              subtle::HashType::SHA256, /*tag_size=*/16,
+              util::SecretDataFromStringView(
+                  subtle::Random::GetRandomBytes(32))),
+          /*tag_size=*/16);
+  EXPECT_THAT(aead, IsOk());
+  return *std::move(aead);
+}
+
+KeysetInfo::KeyInfo NewKeyInfo(uint32_t key_id,
+                               OutputPrefixType output_prefix_type) {
+  KeysetInfo::KeyInfo key_info;
+  key_info.set_output_prefix_type(output_prefix_type);
+  key_info.set_key_id(key_id);
+  key_info.set_status(KeyStatusType::ENABLED);
+  return key_info;
+}
+
+std::string Encrypt(const ZeroCopyAead& aead, absl::string_view plaintext) {
+  std::string ciphertext;
+  subtle::ResizeStringUninitialized(&ciphertext,
+                                    aead.MaxEncryptionSize(plaintext.size()));
+  StatusOr<int64_t> written =
+      aead.Encrypt(plaintext, kAad, absl::MakeSpan(ciphertext));
+  EXPECT_THAT(written, IsOk());
+  ciphertext.resize(*written);
+  return ciphertext;
+}
+
+StatusOr<std::string> Decrypt(const ZeroCopyAead& aead,
+                              absl::string_view ciphertext) {
+  std::string plaintext;
+  subtle::ResizeStringUninitialized(
+      &plaintext, aead.MaxDecryptionSize(ciphertext.size()));
+  StatusOr<int64_t> written =
+      aead.Decrypt(ciphertext, kAad, absl::MakeSpan(plaintext));
+  if (!written.ok()) return written.status();
+  plaintext.resize(*written);
+  return plaintext;
+}
+
+TEST(ZeroCopyAeadWrapperTest, WrapNullptr) {
+  ZeroCopyAeadWrapper wrapper;
+  EXPECT_THAT(wrapper.Wrap(nullptr).status(),
+              StatusIs(absl::StatusCode::kInternal, HasSubstr("non-NULL")));
+}
+
+TEST(ZeroCopyAeadWrapperTest, WrapEmpty) {
+  ZeroCopyAeadWrapper wrapper;
+  EXPECT_THAT(
+      wrapper.Wrap(absl::make_unique<PrimitiveSet<ZeroCopyAead>>()).status(),
+      StatusIs(absl::StatusCode::kInvalidArgument, HasSubstr("no primary")));
+}
+
+TEST(ZeroCopyAeadWrapperTest, EncryptWritesPrefixIntoBuffer) {
+  if (internal::IsFipsModeEnabled() || !internal::IsBoringSsl()) {
+    GTEST_SKIP() << "Test requires BoringSSL and non-FIPS mode";
+  }
+  auto aead_set = absl::make_unique<PrimitiveSet<ZeroCopyAead>>();
+  StatusOr<PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>*> entry =
+      aead_set->AddPrimitive(NewXChaCha20Poly1305(),
+                             NewKeyInfo(1234543, OutputPrefixType::TINK));
+  ASSERT_THAT(entry, IsOk());
+  ASSERT_THAT(aead_set->set_primary(*entry), IsOk());
+  const std::string prefix = (*entry)->get_identifier();
+  const ZeroCopyAead& primary = (*entry)->get_primitive();
+
+  ZeroCopyAeadWrapper wrapper;
+  StatusOr<std::unique_ptr<ZeroCopyAead>> aead =
+      wrapper.Wrap(std::move(aead_set));
+  ASSERT_THAT(aead, IsOk());
+  EXPECT_EQ((*aead)->MaxEncryptionSize(kPlaintext.size()),
+            prefix.size() + primary.MaxEncryptionSize(kPlaintext.size()));
+
+  std::string ciphertext = Encrypt(**aead, kPlaintext);
+  ASSERT_EQ(ciphertext.size(),
+            (*aead)->MaxEncryptionSize(kPlaintext.size()));
+  EXPECT_EQ(absl::string_view(ciphertext).substr(0, prefix.size()), prefix);
+
+  // The remainder of the buffer is a ciphertext of the primary.
+  StatusOr<std::string> raw_plaintext =
+      Decrypt(primary, absl::string_view(ciphertext).substr(prefix.size()));
+  ASSERT_THAT(raw_plaintext, IsOk());
+  EXPECT_EQ(*raw_plaintext, kPlaintext);
+
+  StatusOr<std::string> plaintext = Decrypt(**aead, ciphertext);
+  ASSERT_THAT(plaintext, IsOk());
+  EXPECT_EQ(*plaintext, kPlaintext);
+}
+
+TEST(ZeroCopyAeadWrapperTest, EncryptBufferTooSmall) {
+  if (internal::IsFipsModeEnabled() || !internal::IsBoringSsl()) {
+    GTEST_SKIP() << "Test requires BoringSSL and non-FIPS mode";
+  }
+  auto aead_set = absl::make_unique<PrimitiveSet<ZeroCopyAead>>();
+  StatusOr<PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>*> entry =
+      aead_set->AddPrimitive(NewXChaCha20Poly1305(),
+                             NewKeyInfo(1234543, OutputPrefixType::TINK));
+  ASSERT_THAT(entry, IsOk());
+  ASSERT_THAT(aead_set->set_primary(*entry), IsOk());
+  ZeroCopyAeadWrapper wrapper;
+  StatusOr<std::unique_ptr<ZeroCopyAead>> aead =
+      wrapper.Wrap(std::move(aead_set));
+  ASSERT_THAT(aead, IsOk());
+
+  std::string buffer(CryptoFormat::kNonRawPrefixSize - 1, '\0');
+  EXPECT_THAT((*aead)->Encrypt(kPlaintext, kAad, absl::MakeSpan(buffer))
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  buffer.resize(CryptoFormat::kNonRawPrefixSize + 1);
+  EXPECT_THAT((*aead)->Encrypt(kPlaintext, kAad, absl::MakeSpan(buffer))
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ZeroCopyAeadWrapperTest, DecryptWithNonPrimaryAndRawKeys) {
+  if (internal::IsFipsModeEnabled() || !internal::IsBoringSsl()) {
+    GTEST_SKIP() << "Test requires BoringSSL and non-FIPS mode";
+  }
+  auto aead_set = absl::make_unique<PrimitiveSet<ZeroCopyAead>>();
+  StatusOr<PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>*> tink_entry =
+      aead_set->AddPrimitive(NewXChaCha20Poly1305(),
+                             NewKeyInfo(42, OutputPrefixType::TINK));
+  ASSERT_THAT(tink_entry, IsOk());
+  StatusOr<PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>*> raw_entry =
+      aead_set->AddPrimitive(NewXChaCha20Poly1305(),
+                             NewKeyInfo(43, OutputPrefixType::RAW));
+  ASSERT_THAT(raw_entry, IsOk());
+  StatusOr<PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>*> primary_entry =
+      aead_set->AddPrimitive(NewXChaCha20Poly1305(),
+                             NewKeyInfo(44, OutputPrefixType::TINK));
+  ASSERT_THAT(primary_entry, IsOk());
+  ASSERT_THAT(aead_set->set_primary(*primary_entry), IsOk());
+
+  std::string tink_ciphertext =
+      absl::StrCat((*tink_entry)->get_identifier(),
+                   Encrypt((*tink_entry)->get_primitive(), kPlaintext));
+  std::string raw_ciphertext =
+      Encrypt((*raw_entry)->get_primitive(), kPlaintext);
+
+  ZeroCopyAeadWrapper wrapper;
+  StatusOr<std::unique_ptr<ZeroCopyAead>> aead =
+      wrapper.Wrap(std::move(aead_set));
+  ASSERT_THAT(aead, IsOk());
+
+  StatusOr<std::string> plaintext = Decrypt(**aead, tink_ciphertext);
+  ASSERT_THAT(plaintext, IsOk());
+  EXPECT_EQ(*plaintext, kPlaintext);
+  plaintext = Decrypt(**aead, raw_ciphertext);
+  ASSERT_THAT(plaintext, IsOk());
+  EXPECT_EQ(*plaintext, kPlaintext);
+
+  raw_ciphertext[0] ^= 1;
+  EXPECT_THAT(Decrypt(**aead, raw_ciphertext).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(ZeroCopyAeadWrapperTest, InPlaceEncryptDecrypt) {
+  if (internal::IsFipsModeEnabled() || !internal::IsBoringSsl()) {
+    GTEST_SKIP() << "Test requires BoringSSL and non-FIPS mode";
+  }
+  auto aead_set = absl::make_unique<PrimitiveSet<ZeroCopyAead>>();
+  StatusOr<PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>*> entry =
+      aead_set->AddPrimitive(NewXChaCha20Poly1305(),
+                             NewKeyInfo(1234543, OutputPrefixType::TINK));
+  ASSERT_THAT(entry, IsOk());
+  ASSERT_THAT(aead_set->set_primary(*entry), IsOk());
+  const int64_t primary_offset = (*entry)->get_primitive().InPlaceOffset();
+  ZeroCopyAeadWrapper wrapper;
+  StatusOr<std::unique_ptr<ZeroCopyAead>> aead =
+      wrapper.Wrap(std::move(aead_set));
+  ASSERT_THAT(aead, IsOk());
+
+  const int64_t offset = (*aead)->InPlaceOffset();
+  ASSERT_EQ(offset, CryptoFormat::kNonRawPrefixSize + primary_offset);
+  std::string buffer(offset, '\0');
+  absl::StrAppend(&buffer, kPlaintext);
+  subtle::ResizeStringUninitialized(
+      &buffer, (*aead)->MaxEncryptionSize(kPlaintext.size()));
+  StatusOr<int64_t> written = (*aead)->Encrypt(
+      absl::string_view(buffer).substr(offset, kPlaintext.size()), kAad,
+      absl::MakeSpan(buffer));
+  ASSERT_THAT(written, IsOk());
+  buffer.resize(*written);
+
+  written = (*aead)->Decrypt(buffer, kAad, absl::MakeSpan(buffer).subspan(
+                                               offset, kPlaintext.size()));
+  ASSERT_THAT(written, IsOk());
+  EXPECT_EQ(absl::string_view(buffer).substr(offset, *written), kPlaintext);
+}
+
+TEST(ZeroCopyAeadWrapperTest, InPlaceDecryptRequiresSingleCandidate) {
+  if (internal::IsFipsModeEnabled() || !internal::IsBoringSsl()) {
+    GTEST_SKIP() << "Test requires BoringSSL and non-FIPS mode";
+  }
+  auto aead_set = absl::make_unique<PrimitiveSet<ZeroCopyAead>>();
+  StatusOr<PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>*> entry =
+      aead_set->AddPrimitive(NewXChaCha20Poly1305(),
+                             NewKeyInfo(42, OutputPrefixType::RAW));
+  ASSERT_THAT(entry, IsOk());
+  ASSERT_THAT(aead_set->set_primary(*entry), IsOk());
+  ASSERT_THAT(aead_set
+                  ->AddPrimitive(NewXChaCha20Poly1305(),
+                                 NewKeyInfo(43, OutputPrefixType::RAW))
+                  .status(),
+              IsOk());
+  ZeroCopyAeadWrapper wrapper;
+  StatusOr<std::unique_ptr<ZeroCopyAead>> aead =
+      wrapper.Wrap(std::move(aead_set));
+  ASSERT_THAT(aead, IsOk());
+
+  std::string ciphertext = Encrypt(**aead, kPlaintext);
+  const int64_t offset = (*aead)->InPlaceOffset();
+  EXPECT_THAT((*aead)
+                  ->Decrypt(ciphertext, kAad,
+                            absl::MakeSpan(ciphertext).subspan(offset))
+                  .status(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+  // The ciphertext is left intact.
+  StatusOr<std::string> plaintext = Decrypt(**aead, ciphertext);
+  ASSERT_THAT(plaintext, IsOk());
+  EXPECT_EQ(*plaintext, kPlaintext);
+}
+
+// Tests with monitoring enabled.
+class ZeroCopyAeadWrapperTestWithMonitoring : public Test {
+ protected:
+  void SetUp() override {
+    Registry::Reset();
+    auto monitoring_client_factory =
+        absl::make_unique<MockMonitoringClientFactory>();
+
+    auto encryption_monitoring_client =
+        absl::make_unique<StrictMock<MockMonitoringClient>>();
+    encryption_monitoring_client_ptr_ = encryption_monitoring_client.get();
+    auto decryption_monitoring_client =
+        absl::make_unique<StrictMock<MockMonitoringClient>>();
+    decryption_monitoring_client_ptr_ = decryption_monitoring_client.get();
+
+    EXPECT_CALL(*monitoring_client_factory, New(_))
+        .WillOnce(
+            Return(ByMove(util::StatusOr<std::unique_ptr<MonitoringClient>>(
+                std::move(encryption_monitoring_client)))))
+        .WillOnce(
+            Return(ByMove(util::StatusOr<std::unique_ptr<MonitoringClient>>(
+                std::move(decryption_monitoring_client)))));
+
+    ASSERT_THAT(internal::RegistryImpl::GlobalInstance()
+                    .RegisterMonitoringClientFactory(
+                        std::move(monitoring_client_factory)),
+                IsOk());
+    ASSERT_THAT(
+        internal::RegistryImpl::GlobalInstance().GetMonitoringClientFactory(),
+        Not(IsNull()));
+  }
+
+  // Cleanup the registry to avoid mock leaks.
+  void TearDown() override { Registry::Reset(); }
+
+  MockMonitoringClient* encryption_monitoring_client_ptr_;
+  MockMonitoringClient* decryption_monitoring_client_ptr_;
+};
+
+TEST_F(ZeroCopyAeadWrapperTestWithMonitoring, EncryptDecryptSuccess) {
+  const absl::flat_hash_map<std::string, std::string> kAnnotations = {
+      {"key1", "value1"}, {"key2", "value2"}};
+  auto aead_set =
+      absl::make_unique<PrimitiveSet<ZeroCopyAead>>(kAnnotations);
+  StatusOr<PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>*> raw_entry =
+      aead_set->AddPrimitive(NewAesCtrHmac(),
+                             NewKeyInfo(42, OutputPrefixType::RAW));
+  ASSERT_THAT(raw_entry, IsOk());
+  StatusOr<PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>*> primary_entry =
+      aead_set->AddPrimitive(NewAesCtrHmac(),
+                             NewKeyInfo(43, OutputPrefixType::TINK));
+  ASSERT_THAT(primary_entry, IsOk());
+  ASSERT_THAT(aead_set->set_primary(*primary_entry), IsOk());
+  std::string raw_ciphertext =
+      Encrypt((*raw_entry)->get_primitive(), kPlaintext);
+
+  StatusOr<std::unique_ptr<ZeroCopyAead>> aead =
+      ZeroCopyAeadWrapper().Wrap(std::move(aead_set));
+  ASSERT_THAT(aead, IsOk());
+
+  EXPECT_CALL(*encryption_monitoring_client_ptr_, Log(43, kPlaintext.size()));
+  std::string ciphertext = Encrypt(**aead, kPlaintext);
+
+  // The size of the ciphertext is logged without the output prefix.
+  EXPECT_CALL(*decryption_monitoring_client_ptr_,
+              Log(43, ciphertext.size() - CryptoFormat::kNonRawPrefixSize));
+  EXPECT_THAT(Decrypt(**aead, ciphertext), IsOk());
+  EXPECT_CALL(*decryption_monitoring_client_ptr_,
+              Log(42, raw_ciphertext.size()));
+  EXPECT_THAT(Decrypt(**aead, raw_ciphertext), IsOk());
+}
+
+TEST_F(ZeroCopyAeadWrapperTestWithMonitoring, EncryptDecryptFailures) {
+  auto aead_set = absl::make_unique<PrimitiveSet<ZeroCopyAead>>();
+  StatusOr<PrimitiveSet<ZeroCopyAead>::Entry<ZeroCopyAead>*> primary_entry =
+      aead_set->AddPrimitive(NewAesCtrHmac(),
+                             NewKeyInfo(42, OutputPrefixType::TINK));
+  ASSERT_THAT(primary_entry, IsOk());
+  ASSERT_THAT(aead_set->set_primary(*primary_entry), IsOk());
+
+  StatusOr<std::unique_ptr<ZeroCopyAead>> aead =
+      ZeroCopyAeadWrapper().Wrap(std::move(aead_set));
+  ASSERT_THAT(aead, IsOk());
+
+  // The buffer has room for the output prefix only.
+  std::string buffer(CryptoFormat::kNonRawPrefixSize, '\0');
+  EXPECT_CALL(*encryption_monitoring_client_ptr_, LogFailure());
+  EXPECT_THAT(
+      (*aead)->Encrypt(kPlaintext, kAad, absl::MakeSpan(buffer)).status(),
+      Not(IsOk()));
+
+  EXPECT_CALL(*encryption_monitoring_client_ptr_, Log(42, kPlaintext.size()));
+  std::string ciphertext = Encrypt(**aead, kPlaintext);
+  ciphertext.back() ^= 1;
+  EXPECT_CALL(*decryption_monitoring_client_ptr_, LogFailure());
+  EXPECT_THAT(Decrypt(**aead, ciphertext).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+using ZeroCopyAeadKeysetTest = TestWithParam<KeyTemplate>;
+
+TEST_P(ZeroCopyAeadKeysetTest, InteroperatesWithAead) {
+  if (internal::IsFipsModeEnabled() || !internal::IsBoringSsl()) {
+    GTEST_SKIP() << "Test requires BoringSSL and non-FIPS mode";
+  }
+  ASSERT_THAT(AeadConfig::Register(), IsOk());
+  StatusOr<std::unique_ptr<KeysetHandle>> handle =
+      KeysetHandle::GenerateNew(GetParam(), KeyGenConfigGlobalRegistry());
+  ASSERT_THAT(handle, IsOk());
+  StatusOr<std::unique_ptr<ZeroCopyAead>> zero_copy_aead =
+      (*handle)->GetPrimitive<ZeroCopyAead>(ConfigGlobalRegistry());
+  ASSERT_THAT(zero_copy_aead, IsOk());
+  StatusOr<std::unique_ptr<Aead>> aead =
+      (*handle)->GetPrimitive<Aead>(ConfigGlobalRegistry());
+  ASSERT_THAT(aead, IsOk());
+
+  std::string ciphertext = Encrypt(**zero_copy_aead, kPlaintext);
+  StatusOr<std::string> plaintext = (*aead)->Decrypt(ciphertext, kAad);
+  ASSERT_THAT(plaintext, IsOk());
+  EXPECT_EQ(*plaintext, kPlaintext);
+
+  StatusOr<std::string> aead_ciphertext = (*aead)->Encrypt(kPlaintext, kAad);
+  ASSERT_THAT(aead_ciphertext, IsOk());
+  plaintext = Decrypt(**zero_copy_aead, *aead_ciphertext);
+  ASSERT_THAT(plaintext, IsOk());
+  EXPECT_EQ(*plaintext, kPlaintext);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ZeroCopyAeadKeysetTestSuite, ZeroCopyAeadKeysetTest,
+    Values(AeadKeyTemplates::Aes128Gcm(), AeadKeyTemplates::Aes256GcmNoPrefix(),
+           AeadKeyTemplates::Aes128GcmSiv(), AeadKeyTemplates::Aes128Eax(),
+           AeadKeyTemplates::Aes128CtrHmacSha256(),
+           AeadKeyTemplates::XChaCha20Poly1305()));
+
+}  // namespace
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,237 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/strings/string_view.h"
+#include "tink/aead.h"
+#include "tink/aead/aead_config.h"
+#include "tink/aead/aead_key_templates.h"
+#include "tink/benchmarks/benchmark_util.h"
+#include "tink/config/global_registry.h"
+#include "tink/keyset_handle.h"
+#include "tink/subtle/aes_ctr_boringssl.h"
+#include "tink/subtle/aes_eax_boringssl.h"
+#include "tink/subtle/aes_gcm_boringssl.h"
+#include "tink/subtle/aes_gcm_siv_boringssl.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/encrypt_then_authenticate.h"
+#include "tink/subtle/hmac_boringssl.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/xchacha20_poly1305_boringssl.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::util::SecretData;
+using ::crypto::tink::util::SecretDataFromStringView;
+using ::crypto::tink::util::StatusOr;
+using ::google::crypto::tink::KeyTemplate;
+
+SecretData RandomKey(int size) {
+  return SecretDataFromStringView(subtle::Random::GetRandomBytes(size));
+}
+
+StatusOr<std::unique_ptr<Aead>> NewAesGcm128() {
+  return subtle::AesGcmBoringSsl::New(RandomKey(16));
+}
+
+StatusOr<std::unique_ptr<Aead>> NewAesGcm256() {
+  return subtle::AesGcmBoringSsl::New(RandomKey(32));
+}
+
+StatusOr<std::unique_ptr<Aead>> NewAesGcmSiv256() {
+  return subtle::AesGcmSivBoringSsl::New(RandomKey(32));
+}
+
+StatusOr<std::unique_ptr<Aead>> NewXChaCha20Poly1305() {
+  return subtle::XChacha20Poly1305BoringSsl::New(RandomKey(32));
+}
+
+StatusOr<std::unique_ptr<Aead>> NewAesEax256() {
+  return subtle::AesEaxBoringSsl::New(RandomKey(32),
+                                     /*nonce_size_in_bytes=*/16);
+}
+
+StatusOr<std::unique_ptr<Aead>> NewAesCtrHmacSha256() {
+  StatusOr<std::unique_ptr<subtle::IndCpaCipher>> ind_cpa_cipher =
+      subtle::AesCtrBoringSsl::New(RandomKey(32), /*iv_size=*/16);
+  if (!ind_cpa_cipher.ok()) {
+    return ind_cpa_cipher.status();
+  }
+  StatusOr<std::unique_ptr<Mac>> mac = subtle::HmacBoringSsl::New(
+      subtle::HashType::SHA256, /*tag_size=*/32, RandomKey(32));
+  if (!mac.ok()) {
+    return mac.status();
+  }
+  return subtle::EncryptThenAuthenticate::New(*std::move(ind_cpa_cipher),
+                                              *std::move(mac),
+                                              /*tag_size=*/32);
+}
+
+// Returns an AEAD primitive obtained through the keyset wrapper, for a keyset
+// with a single key generated from `key_template`.
+StatusOr<std::unique_ptr<Aead>> NewFromKeyset(const KeyTemplate& key_template) {
+  util::Status status = AeadConfig::Register();
+  if (!status.ok()) {
+    return status;
+  }
+  StatusOr<std::unique_ptr<KeysetHandle>> handle =
+      KeysetHandle::GenerateNew(key_template, KeyGenConfigGlobalRegistry());
+  if (!handle.ok()) {
+    return handle.status();
+  }
+  return (*handle)->GetPrimitive<Aead>(ConfigGlobalRegistry());
+}
+
+StatusOr<std::unique_ptr<Aead>> NewKeysetAesGcm256() {
+  return NewFromKeyset(AeadKeyTemplates::Aes256Gcm());
+}
+
+StatusOr<std::unique_ptr<Aead>> NewKeysetAesGcm256Raw() {
+  return NewFromKeyset(AeadKeyTemplates::Aes256GcmNoPrefix());
+}
+
+StatusOr<std::unique_ptr<Aead>> NewKeysetXChaCha20Poly1305() {
+  return NewFromKeyset(AeadKeyTemplates::XChaCha20Poly1305());
+}
+
+template <class Factory>
+void BM_AeadEncrypt(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<Aead>> aead = factory();
+  if (SkipIfError(state, aead.status())) return;
+  std::string plaintext = RandomPayload(state.range(0));
+  for (auto _ : state) {
+    StatusOr<std::string> ciphertext =
+        (*aead)->Encrypt(plaintext, kBenchmarkAssociatedData);
+    CHECK_OK(ciphertext.status());
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+template <class Factory>
+void BM_AeadDecrypt(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<Aead>> aead = factory();
+  if (SkipIfError(state, aead.status())) return;
+  StatusOr<std::string> ciphertext = (*aead)->Encrypt(
+      RandomPayload(state.range(0)), kBenchmarkAssociatedData);
+  if (SkipIfError(state, ciphertext.status())) return;
+  for (auto _ : state) {
+    StatusOr<std::string> plaintext =
+        (*aead)->Decrypt(*ciphertext, kBenchmarkAssociatedData);
+    CHECK_OK(plaintext.status());
+    benchmark::DoNotOptimize(plaintext);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+// Number of messages per batch in the batch benchmarks.
+constexpr int kBatchSize = 64;
+
+// Registers small record sizes, for which per-message setup dominates.
+void RecordSizes(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(64)->Arg(256)->Arg(512);
+}
+
+template <class Factory>
+void BM_AeadEncryptBatch(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<Aead>> aead = factory();
+  if (SkipIfError(state, aead.status())) return;
+  std::vector<std::string> plaintexts;
+  for (int i = 0; i < kBatchSize; ++i) {
+    plaintexts.push_back(RandomPayload(state.range(0)));
+  }
+  std::vector<absl::string_view> plaintext_views(plaintexts.begin(),
+                                                 plaintexts.end());
+  const std::vector<absl::string_view> associated_data = {
+      kBenchmarkAssociatedData};
+  std::string ciphertexts;
+  std::vector<int64_t> offsets;
+  for (auto _ : state) {
+    util::Status status = (*aead)->EncryptBatch(
+        plaintext_views, associated_data, &ciphertexts, &offsets);
+    CHECK_OK(status);
+    benchmark::DoNotOptimize(ciphertexts);
+  }
+  SetThroughput(state, kBatchSize * state.range(0));
+}
+
+template <class Factory>
+void BM_AeadDecryptBatch(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<Aead>> aead = factory();
+  if (SkipIfError(state, aead.status())) return;
+  std::vector<std::string> ciphertexts;
+  for (int i = 0; i < kBatchSize; ++i) {
+    StatusOr<std::string> ciphertext = (*aead)->Encrypt(
+        RandomPayload(state.range(0)), kBenchmarkAssociatedData);
+    if (SkipIfError(state, ciphertext.status())) return;
+    ciphertexts.push_back(*std::move(ciphertext));
+  }
+  std::vector<absl::string_view> ciphertext_views(ciphertexts.begin(),
+                                                  ciphertexts.end());
+  const std::vector<absl::string_view> associated_data = {
+      kBenchmarkAssociatedData};
+  std::string plaintexts;
+  std::vector<int64_t> offsets;
+  for (auto _ : state) {
+    util::Status status = (*aead)->DecryptBatch(
+        ciphertext_views, associated_data, &plaintexts, &offsets);
+    CHECK_OK(status);
+    benchmark::DoNotOptimize(plaintexts);
+  }
+  SetThroughput(state, kBatchSize * state.range(0));
+}
+
+#define TINK_AEAD_BENCHMARK(name, factory)                              \
+  BENCHMARK_CAPTURE(BM_AeadEncrypt, name, factory)->Apply(PayloadSizes); \
+  BENCHMARK_CAPTURE(BM_AeadDecrypt, name, factory)->Apply(PayloadSizes)
+
+TINK_AEAD_BENCHMARK(AesGcm128, NewAesGcm128);
+TINK_AEAD_BENCHMARK(AesGcm256, NewAesGcm256);
+TINK_AEAD_BENCHMARK(AesGcmSiv256, NewAesGcmSiv256);
+TINK_AEAD_BENCHMARK(XChaCha20Poly1305, NewXChaCha20Poly1305);
+TINK_AEAD_BENCHMARK(AesEax256, NewAesEax256);
+TINK_AEAD_BENCHMARK(AesCtrHmacSha256, NewAesCtrHmacSha256);
+TINK_AEAD_BENCHMARK(KeysetAesGcm256, NewKeysetAesGcm256);
+TINK_AEAD_BENCHMARK(KeysetAesGcm256Raw, NewKeysetAesGcm256Raw);
+TINK_AEAD_BENCHMARK(KeysetXChaCha20Poly1305, NewKeysetXChaCha20Poly1305);
+
+#define TINK_AEAD_BATCH_BENCHMARK(name, factory)                    \
+  BENCHMARK_CAPTURE(BM_AeadEncryptBatch, name, factory)             \
+      ->Apply(RecordSizes);                                         \
+  BENCHMARK_CAPTURE(BM_AeadDecryptBatch, name, factory)->Apply(RecordSizes)
+
+TINK_AEAD_BATCH_BENCHMARK(AesGcm128, NewAesGcm128);
+TINK_AEAD_BATCH_BENCHMARK(AesGcm256, NewAesGcm256);
+TINK_AEAD_BATCH_BENCHMARK(XChaCha20Poly1305, NewXChaCha20Poly1305);
+TINK_AEAD_BATCH_BENCHMARK(KeysetAesGcm256, NewKeysetAesGcm256);
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,47 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+// Entry point shared by all Tink benchmarks. It behaves like
+// benchmark::benchmark_main, except that results are reported as JSON unless
+// --benchmark_format is given explicitly, so that they can be stored and
+// compared across releases (e.g., with benchmark's tools/compare.py).
+int main(int argc, char** argv) {
+  static char kJsonFormatFlag[] = "--benchmark_format=json";
+  std::vector<char*> args(argv, argv + argc);
+  bool has_format = false;
+  for (int i = 1; i < argc; ++i) {
+    if (std::strncmp(argv[i], "--benchmark_format",
+                     std::strlen("--benchmark_format")) == 0) {
+      has_format = true;
+    }
+  }
+  if (!has_format) {
+    args.push_back(kJsonFormatFlag);
+  }
+  int args_size = args.size();
+  ::benchmark::Initialize(&args_size, args.data());
+  if (::benchmark::ReportUnrecognizedArguments(args_size, args.data())) {
+    return 1;
+  }
+  ::benchmark::RunSpecifiedBenchmarks();
+  ::benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,56 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/benchmarks/benchmark_util.h"
+
+#include <cstdint>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "tink/subtle/random.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+void PayloadSizes(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(4)->Range(16, 1 << 20);
+}
+
+void SmallPayloadSizes(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(32)->Arg(1 << 10)->Arg(16 << 10);
+}
+
+std::string RandomPayload(int64_t size) {
+  return subtle::Random::GetRandomBytes(size);
+}
+
+void SetThroughput(::benchmark::State& state, int64_t bytes_per_iteration) {
+  state.SetBytesProcessed(state.iterations() * bytes_per_iteration);
+}
+
+bool SkipIfError(::benchmark::State& state, const util::Status& status) {
+  if (status.ok()) {
+    return false;
+  }
+  state.SkipWithError(std::string(status.message()).c_str());
+  return true;
+}
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
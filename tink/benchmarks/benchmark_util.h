@@ -0,0 +1,59 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_BENCHMARKS_BENCHMARK_UTIL_H_
+#define TINK_BENCHMARKS_BENCHMARK_UTIL_H_
+
+#include <cstdint>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/strings/string_view.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// Associated data used by all AEAD-like benchmarks.
+constexpr absl::string_view kBenchmarkAssociatedData =
+    "benchmark associated data";
+
+// Registers payload sizes from 16 bytes to 1 MiB, in steps of 4x. Used by
+// throughput benchmarks of symmetric primitives.
+void PayloadSizes(::benchmark::internal::Benchmark* benchmark);
+
+// Registers a small set of payload sizes (32 bytes, 1 KiB and 16 KiB). Used by
+// benchmarks of public-key primitives, whose cost is dominated by a fixed
+// per-call overhead.
+void SmallPayloadSizes(::benchmark::internal::Benchmark* benchmark);
+
+// Returns `size` random bytes.
+std::string RandomPayload(int64_t size);
+
+// Reports `bytes_per_iteration` processed bytes for each iteration of
+// `state`, so that throughput is included in the output.
+void SetThroughput(::benchmark::State& state, int64_t bytes_per_iteration);
+
+// Marks `state` as failed with the message of `status`. Returns true if
+// `status` is not OK, so that callers can return early.
+bool SkipIfError(::benchmark::State& state, const util::Status& status);
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_BENCHMARKS_BENCHMARK_UTIL_H_
@@ -0,0 +1,195 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/strings/string_view.h"
+#include "tink/benchmarks/benchmark_util.h"
+#include "tink/config/global_registry.h"
+#include "tink/daead/deterministic_aead_config.h"
+#include "tink/daead/deterministic_aead_key_templates.h"
+#include "tink/deterministic_aead.h"
+#include "tink/keyset_handle.h"
+#include "tink/subtle/aes_siv_boringssl.h"
+#include "tink/subtle/random.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::util::StatusOr;
+
+StatusOr<std::unique_ptr<DeterministicAead>> NewAesSiv() {
+  return subtle::AesSivBoringSsl::New(
+      util::SecretDataFromStringView(subtle::Random::GetRandomBytes(64)));
+}
+
+StatusOr<std::unique_ptr<DeterministicAead>> NewKeysetAesSiv() {
+  util::Status status = DeterministicAeadConfig::Register();
+  if (!status.ok()) {
+    return status;
+  }
+  StatusOr<std::unique_ptr<KeysetHandle>> handle = KeysetHandle::GenerateNew(
+      DeterministicAeadKeyTemplates::Aes256Siv(), KeyGenConfigGlobalRegistry());
+  if (!handle.ok()) {
+    return handle.status();
+  }
+  return (*handle)->GetPrimitive<DeterministicAead>(ConfigGlobalRegistry());
+}
+
+template <class Factory>
+void BM_EncryptDeterministically(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<DeterministicAead>> daead = factory();
+  if (SkipIfError(state, daead.status())) return;
+  std::string plaintext = RandomPayload(state.range(0));
+  for (auto _ : state) {
+    StatusOr<std::string> ciphertext =
+        (*daead)->EncryptDeterministically(plaintext, kBenchmarkAssociatedData);
+    CHECK_OK(ciphertext.status());
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+template <class Factory>
+void BM_DecryptDeterministically(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<DeterministicAead>> daead = factory();
+  if (SkipIfError(state, daead.status())) return;
+  StatusOr<std::string> ciphertext = (*daead)->EncryptDeterministically(
+      RandomPayload(state.range(0)), kBenchmarkAssociatedData);
+  if (SkipIfError(state, ciphertext.status())) return;
+  for (auto _ : state) {
+    StatusOr<std::string> plaintext = (*daead)->DecryptDeterministically(
+        *ciphertext, kBenchmarkAssociatedData);
+    CHECK_OK(plaintext.status());
+    benchmark::DoNotOptimize(plaintext);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+// Associated data as long as the plaintext, so that the CMAC chains over both
+// inputs have the same length.
+template <class Factory>
+void BM_EncryptDeterministicallyLongAd(benchmark::State& state,
+                                       Factory factory) {
+  StatusOr<std::unique_ptr<DeterministicAead>> daead = factory();
+  if (SkipIfError(state, daead.status())) return;
+  std::string plaintext = RandomPayload(state.range(0));
+  std::string associated_data = RandomPayload(state.range(0));
+  for (auto _ : state) {
+    StatusOr<std::string> ciphertext =
+        (*daead)->EncryptDeterministically(plaintext, associated_data);
+    CHECK_OK(ciphertext.status());
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  SetThroughput(state, 2 * state.range(0));
+}
+
+// Number of values per batch in the batch benchmarks, e.g. the cells of a
+// column.
+constexpr int kBatchSize = 64;
+
+// Registers small cell sizes, for which per-value overhead dominates.
+void CellSizes(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(16)->Arg(64)->Arg(256);
+}
+
+template <class Factory>
+void BM_EncryptDeterministicallyBatch(benchmark::State& state,
+                                      Factory factory) {
+  StatusOr<std::unique_ptr<DeterministicAead>> daead = factory();
+  if (SkipIfError(state, daead.status())) return;
+  std::vector<std::string> plaintexts;
+  for (int i = 0; i < kBatchSize; ++i) {
+    plaintexts.push_back(RandomPayload(state.range(0)));
+  }
+  std::vector<absl::string_view> plaintext_views(plaintexts.begin(),
+                                                 plaintexts.end());
+  const std::vector<absl::string_view> associated_data = {
+      kBenchmarkAssociatedData};
+  std::string ciphertexts;
+  std::vector<int64_t> offsets;
+  for (auto _ : state) {
+    util::Status status = (*daead)->EncryptDeterministicallyBatch(
+        plaintext_views, associated_data, &ciphertexts, &offsets);
+    CHECK_OK(status);
+    benchmark::DoNotOptimize(ciphertexts);
+  }
+  SetThroughput(state, kBatchSize * state.range(0));
+}
+
+template <class Factory>
+void BM_DecryptDeterministicallyBatch(benchmark::State& state,
+                                      Factory factory) {
+  StatusOr<std::unique_ptr<DeterministicAead>> daead = factory();
+  if (SkipIfError(state, daead.status())) return;
+  std::vector<std::string> ciphertexts;
+  for (int i = 0; i < kBatchSize; ++i) {
+    StatusOr<std::string> ciphertext = (*daead)->EncryptDeterministically(
+        RandomPayload(state.range(0)), kBenchmarkAssociatedData);
+    if (SkipIfError(state, ciphertext.status())) return;
+    ciphertexts.push_back(*std::move(ciphertext));
+  }
+  std::vector<absl::string_view> ciphertext_views(ciphertexts.begin(),
+                                                  ciphertexts.end());
+  const std::vector<absl::string_view> associated_data = {
+      kBenchmarkAssociatedData};
+  std::string plaintexts;
+  std::vector<int64_t> offsets;
+  for (auto _ : state) {
+    util::Status status = (*daead)->DecryptDeterministicallyBatch(
+        ciphertext_views, associated_data, &plaintexts, &offsets);
+    CHECK_OK(status);
+    benchmark::DoNotOptimize(plaintexts);
+  }
+  SetThroughput(state, kBatchSize * state.range(0));
+}
+
+BENCHMARK_CAPTURE(BM_EncryptDeterministically, AesSiv, NewAesSiv)
+    ->Apply(PayloadSizes);
+BENCHMARK_CAPTURE(BM_DecryptDeterministically, AesSiv, NewAesSiv)
+    ->Apply(PayloadSizes);
+BENCHMARK_CAPTURE(BM_EncryptDeterministicallyLongAd, AesSiv, NewAesSiv)
+    ->Apply(PayloadSizes);
+BENCHMARK_CAPTURE(BM_EncryptDeterministicallyBatch, AesSiv, NewAesSiv)
+    ->Apply(CellSizes);
+BENCHMARK_CAPTURE(BM_DecryptDeterministicallyBatch, AesSiv, NewAesSiv)
+    ->Apply(CellSizes);
+BENCHMARK_CAPTURE(BM_EncryptDeterministicallyBatch, KeysetAesSiv,
+                  NewKeysetAesSiv)
+    ->Apply(CellSizes);
+BENCHMARK_CAPTURE(BM_DecryptDeterministicallyBatch, KeysetAesSiv,
+                  NewKeysetAesSiv)
+    ->Apply(CellSizes);
+BENCHMARK_CAPTURE(BM_EncryptDeterministically, KeysetAesSiv, NewKeysetAesSiv)
+    ->Apply(PayloadSizes);
+BENCHMARK_CAPTURE(BM_DecryptDeterministically, KeysetAesSiv, NewKeysetAesSiv)
+    ->Apply(PayloadSizes);
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
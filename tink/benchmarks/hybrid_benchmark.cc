@@ -0,0 +1,127 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "tink/benchmarks/benchmark_util.h"
+#include "tink/config/global_registry.h"
+#include "tink/hybrid/hybrid_config.h"
+#include "tink/hybrid/hybrid_key_templates.h"
+#include "tink/hybrid_decrypt.h"
+#include "tink/hybrid_encrypt.h"
+#include "tink/keyset_handle.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::util::StatusOr;
+using ::google::crypto::tink::KeyTemplate;
+
+struct HybridPair {
+  std::unique_ptr<HybridEncrypt> encrypt;
+  std::unique_ptr<HybridDecrypt> decrypt;
+};
+
+StatusOr<HybridPair> NewHybridPair(const KeyTemplate& key_template) {
+  util::Status status = HybridConfig::Register();
+  if (!status.ok()) {
+    return status;
+  }
+  StatusOr<std::unique_ptr<KeysetHandle>> private_handle =
+      KeysetHandle::GenerateNew(key_template, KeyGenConfigGlobalRegistry());
+  if (!private_handle.ok()) {
+    return private_handle.status();
+  }
+  StatusOr<std::unique_ptr<KeysetHandle>> public_handle =
+      (*private_handle)->GetPublicKeysetHandle(KeyGenConfigGlobalRegistry());
+  if (!public_handle.ok()) {
+    return public_handle.status();
+  }
+  HybridPair pair;
+  StatusOr<std::unique_ptr<HybridEncrypt>> encrypt =
+      (*public_handle)->GetPrimitive<HybridEncrypt>(ConfigGlobalRegistry());
+  if (!encrypt.ok()) {
+    return encrypt.status();
+  }
+  pair.encrypt = *std::move(encrypt);
+  StatusOr<std::unique_ptr<HybridDecrypt>> decrypt =
+      (*private_handle)->GetPrimitive<HybridDecrypt>(ConfigGlobalRegistry());
+  if (!decrypt.ok()) {
+    return decrypt.status();
+  }
+  pair.decrypt = *std::move(decrypt);
+  return pair;
+}
+
+void BM_HybridEncrypt(benchmark::State& state,
+                      const KeyTemplate& key_template) {
+  StatusOr<HybridPair> hybrid = NewHybridPair(key_template);
+  if (SkipIfError(state, hybrid.status())) return;
+  std::string plaintext = RandomPayload(state.range(0));
+  for (auto _ : state) {
+    StatusOr<std::string> ciphertext =
+        hybrid->encrypt->Encrypt(plaintext, kBenchmarkAssociatedData);
+    CHECK_OK(ciphertext.status());
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+void BM_HybridDecrypt(benchmark::State& state,
+                      const KeyTemplate& key_template) {
+  StatusOr<HybridPair> hybrid = NewHybridPair(key_template);
+  if (SkipIfError(state, hybrid.status())) return;
+  StatusOr<std::string> ciphertext = hybrid->encrypt->Encrypt(
+      RandomPayload(state.range(0)), kBenchmarkAssociatedData);
+  if (SkipIfError(state, ciphertext.status())) return;
+  for (auto _ : state) {
+    StatusOr<std::string> plaintext =
+        hybrid->decrypt->Decrypt(*ciphertext, kBenchmarkAssociatedData);
+    CHECK_OK(plaintext.status());
+    benchmark::DoNotOptimize(plaintext);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+#define TINK_HYBRID_BENCHMARK(name)                                    \
+  BENCHMARK_CAPTURE(BM_HybridEncrypt, name, HybridKeyTemplates::name()) \
+      ->Apply(SmallPayloadSizes);                                      \
+  BENCHMARK_CAPTURE(BM_HybridDecrypt, name, HybridKeyTemplates::name()) \
+      ->Apply(SmallPayloadSizes)
+
+TINK_HYBRID_BENCHMARK(EciesP256HkdfHmacSha256Aes128Gcm);
+TINK_HYBRID_BENCHMARK(EciesP256HkdfHmacSha256Aes128CtrHmacSha256);
+TINK_HYBRID_BENCHMARK(EciesP256CompressedHkdfHmacSha256Aes128Gcm);
+TINK_HYBRID_BENCHMARK(EciesX25519HkdfHmacSha256Aes128Gcm);
+TINK_HYBRID_BENCHMARK(EciesX25519HkdfHmacSha256Aes256Gcm);
+TINK_HYBRID_BENCHMARK(EciesX25519HkdfHmacSha256XChaCha20Poly1305);
+TINK_HYBRID_BENCHMARK(EciesX25519HkdfHmacSha256DeterministicAesSiv);
+TINK_HYBRID_BENCHMARK(HpkeX25519HkdfSha256Aes128Gcm);
+TINK_HYBRID_BENCHMARK(HpkeX25519HkdfSha256Aes256Gcm);
+TINK_HYBRID_BENCHMARK(HpkeX25519HkdfSha256ChaCha20Poly1305);
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,181 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/strings/string_view.h"
+#include "tink/benchmarks/benchmark_util.h"
+#include "tink/config/global_registry.h"
+#include "tink/jwt/jwt_key_templates.h"
+#include "tink/jwt/jwt_mac.h"
+#include "tink/jwt/jwt_mac_config.h"
+#include "tink/jwt/jwt_public_key_sign.h"
+#include "tink/jwt/jwt_public_key_verify.h"
+#include "tink/jwt/jwt_signature_config.h"
+#include "tink/jwt/jwt_validator.h"
+#include "tink/jwt/raw_jwt.h"
+#include "tink/jwt/verified_jwt.h"
+#include "tink/keyset_handle.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::util::StatusOr;
+using ::google::crypto::tink::KeyTemplate;
+
+constexpr absl::string_view kIssuer = "https://issuer.example.com";
+
+StatusOr<RawJwt> NewRawJwt() {
+  return RawJwtBuilder()
+      .SetIssuer(kIssuer)
+      .SetSubject("benchmark")
+      .SetJwtId("id")
+      .WithoutExpiration()
+      .Build();
+}
+
+StatusOr<JwtValidator> NewValidator() {
+  return JwtValidatorBuilder()
+      .ExpectIssuer(kIssuer)
+      .AllowMissingExpiration()
+      .Build();
+}
+
+StatusOr<std::unique_ptr<KeysetHandle>> NewKeysetHandle(
+    const KeyTemplate& key_template) {
+  util::Status status = JwtMacRegister();
+  if (!status.ok()) {
+    return status;
+  }
+  status = JwtSignatureRegister();
+  if (!status.ok()) {
+    return status;
+  }
+  return KeysetHandle::GenerateNew(key_template, KeyGenConfigGlobalRegistry());
+}
+
+void BM_JwtComputeMac(benchmark::State& state,
+                      const KeyTemplate& key_template) {
+  StatusOr<std::unique_ptr<KeysetHandle>> handle =
+      NewKeysetHandle(key_template);
+  if (SkipIfError(state, handle.status())) return;
+  StatusOr<std::unique_ptr<JwtMac>> jwt_mac =
+      (*handle)->GetPrimitive<JwtMac>(ConfigGlobalRegistry());
+  if (SkipIfError(state, jwt_mac.status())) return;
+  StatusOr<RawJwt> raw_jwt = NewRawJwt();
+  if (SkipIfError(state, raw_jwt.status())) return;
+  for (auto _ : state) {
+    StatusOr<std::string> compact = (*jwt_mac)->ComputeMacAndEncode(*raw_jwt);
+    CHECK_OK(compact.status());
+    benchmark::DoNotOptimize(compact);
+  }
+}
+
+void BM_JwtVerifyMac(benchmark::State& state,
+                     const KeyTemplate& key_template) {
+  StatusOr<std::unique_ptr<KeysetHandle>> handle =
+      NewKeysetHandle(key_template);
+  if (SkipIfError(state, handle.status())) return;
+  StatusOr<std::unique_ptr<JwtMac>> jwt_mac =
+      (*handle)->GetPrimitive<JwtMac>(ConfigGlobalRegistry());
+  if (SkipIfError(state, jwt_mac.status())) return;
+  StatusOr<RawJwt> raw_jwt = NewRawJwt();
+  if (SkipIfError(state, raw_jwt.status())) return;
+  StatusOr<JwtValidator> validator = NewValidator();
+  if (SkipIfError(state, validator.status())) return;
+  StatusOr<std::string> compact = (*jwt_mac)->ComputeMacAndEncode(*raw_jwt);
+  if (SkipIfError(state, compact.status())) return;
+  for (auto _ : state) {
+    StatusOr<VerifiedJwt> verified =
+        (*jwt_mac)->VerifyMacAndDecode(*compact, *validator);
+    CHECK_OK(verified.status());
+    benchmark::DoNotOptimize(verified);
+  }
+}
+
+void BM_JwtSign(benchmark::State& state, const KeyTemplate& key_template) {
+  StatusOr<std::unique_ptr<KeysetHandle>> handle =
+      NewKeysetHandle(key_template);
+  if (SkipIfError(state, handle.status())) return;
+  StatusOr<std::unique_ptr<JwtPublicKeySign>> sign =
+      (*handle)->GetPrimitive<JwtPublicKeySign>(ConfigGlobalRegistry());
+  if (SkipIfError(state, sign.status())) return;
+  StatusOr<RawJwt> raw_jwt = NewRawJwt();
+  if (SkipIfError(state, raw_jwt.status())) return;
+  for (auto _ : state) {
+    StatusOr<std::string> compact = (*sign)->SignAndEncode(*raw_jwt);
+    CHECK_OK(compact.status());
+    benchmark::DoNotOptimize(compact);
+  }
+}
+
+void BM_JwtVerify(benchmark::State& state, const KeyTemplate& key_template) {
+  StatusOr<std::unique_ptr<KeysetHandle>> handle =
+      NewKeysetHandle(key_template);
+  if (SkipIfError(state, handle.status())) return;
+  StatusOr<std::unique_ptr<KeysetHandle>> public_handle =
+      (*handle)->GetPublicKeysetHandle(KeyGenConfigGlobalRegistry());
+  if (SkipIfError(state, public_handle.status())) return;
+  StatusOr<std::unique_ptr<JwtPublicKeySign>> sign =
+      (*handle)->GetPrimitive<JwtPublicKeySign>(ConfigGlobalRegistry());
+  if (SkipIfError(state, sign.status())) return;
+  StatusOr<std::unique_ptr<JwtPublicKeyVerify>> verify =
+      (*public_handle)->GetPrimitive<JwtPublicKeyVerify>(
+          ConfigGlobalRegistry());
+  if (SkipIfError(state, verify.status())) return;
+  StatusOr<RawJwt> raw_jwt = NewRawJwt();
+  if (SkipIfError(state, raw_jwt.status())) return;
+  StatusOr<JwtValidator> validator = NewValidator();
+  if (SkipIfError(state, validator.status())) return;
+  StatusOr<std::string> compact = (*sign)->SignAndEncode(*raw_jwt);
+  if (SkipIfError(state, compact.status())) return;
+  for (auto _ : state) {
+    StatusOr<VerifiedJwt> verified =
+        (*verify)->VerifyAndDecode(*compact, *validator);
+    CHECK_OK(verified.status());
+    benchmark::DoNotOptimize(verified);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_JwtComputeMac, Hs256, JwtHs256Template());
+BENCHMARK_CAPTURE(BM_JwtVerifyMac, Hs256, JwtHs256Template());
+BENCHMARK_CAPTURE(BM_JwtComputeMac, Hs512, JwtHs512Template());
+BENCHMARK_CAPTURE(BM_JwtVerifyMac, Hs512, JwtHs512Template());
+
+#define TINK_JWT_SIGNATURE_BENCHMARK(name, key_template)   \
+  BENCHMARK_CAPTURE(BM_JwtSign, name, key_template());     \
+  BENCHMARK_CAPTURE(BM_JwtVerify, name, key_template())
+
+TINK_JWT_SIGNATURE_BENCHMARK(Es256, JwtEs256Template);
+TINK_JWT_SIGNATURE_BENCHMARK(Es384, JwtEs384Template);
+TINK_JWT_SIGNATURE_BENCHMARK(Es512, JwtEs512Template);
+TINK_JWT_SIGNATURE_BENCHMARK(Rs256_2048, JwtRs256_2048_F4_Template);
+TINK_JWT_SIGNATURE_BENCHMARK(Rs256_3072, JwtRs256_3072_F4_Template);
+TINK_JWT_SIGNATURE_BENCHMARK(Ps256_2048, JwtPs256_2048_F4_Template);
+TINK_JWT_SIGNATURE_BENCHMARK(Ps256_3072, JwtPs256_3072_F4_Template);
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
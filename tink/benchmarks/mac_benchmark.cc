@@ -0,0 +1,189 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/strings/string_view.h"
+#include "tink/benchmarks/benchmark_util.h"
+#include "tink/config/global_registry.h"
+#include "tink/keyset_handle.h"
+#include "tink/mac.h"
+#include "tink/mac/mac_config.h"
+#include "tink/mac/mac_key_templates.h"
+#include "tink/subtle/aes_cmac_boringssl.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/hmac_boringssl.h"
+#include "tink/subtle/random.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::util::SecretData;
+using ::crypto::tink::util::SecretDataFromStringView;
+using ::crypto::tink::util::StatusOr;
+using ::google::crypto::tink::KeyTemplate;
+
+SecretData RandomKey(int size) {
+  return SecretDataFromStringView(subtle::Random::GetRandomBytes(size));
+}
+
+StatusOr<std::unique_ptr<Mac>> NewHmacSha256() {
+  return subtle::HmacBoringSsl::New(subtle::HashType::SHA256, /*tag_size=*/32,
+                                    RandomKey(32));
+}
+
+StatusOr<std::unique_ptr<Mac>> NewHmacSha512() {
+  return subtle::HmacBoringSsl::New(subtle::HashType::SHA512, /*tag_size=*/64,
+                                    RandomKey(64));
+}
+
+StatusOr<std::unique_ptr<Mac>> NewAesCmac() {
+  return subtle::AesCmacBoringSsl::New(RandomKey(32), /*tag_size=*/16);
+}
+
+StatusOr<std::unique_ptr<Mac>> NewFromKeyset(const KeyTemplate& key_template) {
+  util::Status status = MacConfig::Register();
+  if (!status.ok()) {
+    return status;
+  }
+  StatusOr<std::unique_ptr<KeysetHandle>> handle =
+      KeysetHandle::GenerateNew(key_template, KeyGenConfigGlobalRegistry());
+  if (!handle.ok()) {
+    return handle.status();
+  }
+  return (*handle)->GetPrimitive<Mac>(ConfigGlobalRegistry());
+}
+
+StatusOr<std::unique_ptr<Mac>> NewKeysetHmacSha256() {
+  return NewFromKeyset(MacKeyTemplates::HmacSha256());
+}
+
+StatusOr<std::unique_ptr<Mac>> NewKeysetAesCmac() {
+  return NewFromKeyset(MacKeyTemplates::AesCmac());
+}
+
+template <class Factory>
+void BM_ComputeMac(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<Mac>> mac = factory();
+  if (SkipIfError(state, mac.status())) return;
+  std::string data = RandomPayload(state.range(0));
+  for (auto _ : state) {
+    StatusOr<std::string> tag = (*mac)->ComputeMac(data);
+    CHECK_OK(tag.status());
+    benchmark::DoNotOptimize(tag);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+template <class Factory>
+void BM_VerifyMac(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<Mac>> mac = factory();
+  if (SkipIfError(state, mac.status())) return;
+  std::string data = RandomPayload(state.range(0));
+  StatusOr<std::string> tag = (*mac)->ComputeMac(data);
+  if (SkipIfError(state, tag.status())) return;
+  for (auto _ : state) {
+    util::Status status = (*mac)->VerifyMac(*tag, data);
+    CHECK_OK(status);
+    benchmark::DoNotOptimize(status);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+constexpr int kBatchSize = 64;
+
+// Registers small message sizes, for which per-message overhead dominates.
+void MessageSizes(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(16)->Arg(64)->Arg(256);
+}
+
+template <class Factory>
+void BM_ComputeMacBatch(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<Mac>> mac = factory();
+  if (SkipIfError(state, mac.status())) return;
+  std::vector<std::string> data;
+  for (int i = 0; i < kBatchSize; ++i) {
+    data.push_back(RandomPayload(state.range(0)));
+  }
+  std::vector<absl::string_view> data_views(data.begin(), data.end());
+  std::string tags;
+  std::vector<int64_t> offsets;
+  for (auto _ : state) {
+    util::Status status = (*mac)->ComputeMacBatch(data_views, &tags, &offsets);
+    CHECK_OK(status);
+    benchmark::DoNotOptimize(tags);
+  }
+  SetThroughput(state, kBatchSize * state.range(0));
+}
+
+template <class Factory>
+void BM_VerifyMacBatch(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<Mac>> mac = factory();
+  if (SkipIfError(state, mac.status())) return;
+  std::vector<std::string> data;
+  std::vector<std::string> tags;
+  for (int i = 0; i < kBatchSize; ++i) {
+    data.push_back(RandomPayload(state.range(0)));
+    StatusOr<std::string> tag = (*mac)->ComputeMac(data.back());
+    if (SkipIfError(state, tag.status())) return;
+    tags.push_back(*std::move(tag));
+  }
+  std::vector<absl::string_view> data_views(data.begin(), data.end());
+  std::vector<absl::string_view> tag_views(tags.begin(), tags.end());
+  std::vector<bool> verified;
+  for (auto _ : state) {
+    util::Status status = (*mac)->VerifyMacBatch(tag_views, data_views,
+                                                 &verified);
+    CHECK_OK(status);
+    benchmark::DoNotOptimize(verified);
+  }
+  SetThroughput(state, kBatchSize * state.range(0));
+}
+
+#define TINK_MAC_BENCHMARK(name, factory)                              \
+  BENCHMARK_CAPTURE(BM_ComputeMac, name, factory)->Apply(PayloadSizes); \
+  BENCHMARK_CAPTURE(BM_VerifyMac, name, factory)->Apply(PayloadSizes)
+
+TINK_MAC_BENCHMARK(HmacSha256, NewHmacSha256);
+TINK_MAC_BENCHMARK(HmacSha512, NewHmacSha512);
+TINK_MAC_BENCHMARK(AesCmac, NewAesCmac);
+TINK_MAC_BENCHMARK(KeysetHmacSha256, NewKeysetHmacSha256);
+TINK_MAC_BENCHMARK(KeysetAesCmac, NewKeysetAesCmac);
+BENCHMARK_CAPTURE(BM_ComputeMacBatch, HmacSha256, NewHmacSha256)
+    ->Apply(MessageSizes);
+BENCHMARK_CAPTURE(BM_VerifyMacBatch, HmacSha256, NewHmacSha256)
+    ->Apply(MessageSizes);
+BENCHMARK_CAPTURE(BM_ComputeMacBatch, KeysetHmacSha256, NewKeysetHmacSha256)
+    ->Apply(MessageSizes);
+BENCHMARK_CAPTURE(BM_VerifyMacBatch, KeysetHmacSha256, NewKeysetHmacSha256)
+    ->Apply(MessageSizes);
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
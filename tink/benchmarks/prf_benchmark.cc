@@ -0,0 +1,120 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Compares computing the primary PRF of a keyset input by input with
+// computing it on a batch of inputs, for short inputs such as identifiers.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/strings/string_view.h"
+#include "tink/benchmarks/benchmark_util.h"
+#include "tink/config/global_registry.h"
+#include "tink/keyset_handle.h"
+#include "tink/prf/prf_config.h"
+#include "tink/prf/prf_key_templates.h"
+#include "tink/prf/prf_set.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::util::StatusOr;
+using ::google::crypto::tink::KeyTemplate;
+
+constexpr int kBatchSize = 64;
+constexpr int kOutputLength = 16;
+
+StatusOr<std::unique_ptr<PrfSet>> NewPrfSet(
+    const KeyTemplate& (*key_template)()) {
+  util::Status status = PrfConfig::Register();
+  if (!status.ok()) {
+    return status;
+  }
+  StatusOr<std::unique_ptr<KeysetHandle>> handle =
+      KeysetHandle::GenerateNew(key_template(), KeyGenConfigGlobalRegistry());
+  if (!handle.ok()) {
+    return handle.status();
+  }
+  return (*handle)->GetPrimitive<PrfSet>(ConfigGlobalRegistry());
+}
+
+std::vector<std::string> RandomInputs(int input_size) {
+  std::vector<std::string> inputs;
+  for (int i = 0; i < kBatchSize; ++i) {
+    inputs.push_back(RandomPayload(input_size));
+  }
+  return inputs;
+}
+
+void BM_ComputePrimary(benchmark::State& state,
+                       const KeyTemplate& (*key_template)()) {
+  StatusOr<std::unique_ptr<PrfSet>> prf_set = NewPrfSet(key_template);
+  if (SkipIfError(state, prf_set.status())) return;
+  std::vector<std::string> inputs = RandomInputs(state.range(0));
+  for (auto _ : state) {
+    for (const std::string& input : inputs) {
+      StatusOr<std::string> output =
+          (*prf_set)->ComputePrimary(input, kOutputLength);
+      CHECK_OK(output.status());
+      benchmark::DoNotOptimize(output);
+    }
+  }
+  SetThroughput(state, kBatchSize * state.range(0));
+}
+
+void BM_ComputePrimaryBatch(benchmark::State& state,
+                            const KeyTemplate& (*key_template)()) {
+  StatusOr<std::unique_ptr<PrfSet>> prf_set = NewPrfSet(key_template);
+  if (SkipIfError(state, prf_set.status())) return;
+  std::vector<std::string> inputs = RandomInputs(state.range(0));
+  std::vector<absl::string_view> input_views(inputs.begin(), inputs.end());
+  std::string outputs;
+  for (auto _ : state) {
+    util::Status status =
+        (*prf_set)->ComputePrimaryBatch(input_views, kOutputLength, &outputs);
+    CHECK_OK(status);
+    benchmark::DoNotOptimize(outputs);
+  }
+  SetThroughput(state, kBatchSize * state.range(0));
+}
+
+// Registers input sizes typical of identifiers.
+void InputSizes(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(16)->Arg(64);
+}
+
+#define TINK_PRF_BENCHMARK(name, key_template)                  \
+  BENCHMARK_CAPTURE(BM_ComputePrimary, name, key_template)      \
+      ->Apply(InputSizes);                                      \
+  BENCHMARK_CAPTURE(BM_ComputePrimaryBatch, name, key_template) \
+      ->Apply(InputSizes)
+
+TINK_PRF_BENCHMARK(HmacSha256, &PrfKeyTemplates::HmacSha256);
+TINK_PRF_BENCHMARK(HkdfSha256, &PrfKeyTemplates::HkdfSha256);
+TINK_PRF_BENCHMARK(AesCmac, &PrfKeyTemplates::AesCmac);
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
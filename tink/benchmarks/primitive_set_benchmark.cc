@@ -0,0 +1,167 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Measures how the per-call key lookup of the keyset wrappers scales with the
+// number of threads. The primitives do no cryptographic work, so that only
+// the lookup cost is measured.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tink/aead.h"
+#include "tink/aead/aead_wrapper.h"
+#include "tink/crypto_format.h"
+#include "tink/internal/output_prefix_index.h"
+#include "tink/primitive_set.h"
+#include "tink/util/statusor.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::util::StatusOr;
+using ::google::crypto::tink::KeysetInfo;
+using ::google::crypto::tink::KeyStatusType;
+using ::google::crypto::tink::OutputPrefixType;
+
+constexpr int kNumKeys = 8;
+constexpr int kMaxThreads = 64;
+
+// Aead which "decrypts" by returning its input.
+class NullAead : public Aead {
+ public:
+  StatusOr<std::string> Encrypt(
+      absl::string_view plaintext,
+      absl::string_view associated_data) const override {
+    return std::string(plaintext);
+  }
+
+  StatusOr<std::string> Decrypt(
+      absl::string_view ciphertext,
+      absl::string_view associated_data) const override {
+    return std::string(ciphertext);
+  }
+};
+
+KeysetInfo::KeyInfo TinkKeyInfo(uint32_t key_id) {
+  KeysetInfo::KeyInfo key_info;
+  key_info.set_type_url("type.googleapis.com/google.crypto.tink.AesGcmKey");
+  key_info.set_key_id(key_id);
+  key_info.set_status(KeyStatusType::ENABLED);
+  key_info.set_output_prefix_type(OutputPrefixType::TINK);
+  return key_info;
+}
+
+// Output prefix of the last key, so that lookups see a full keyset.
+std::string LastKeyPrefix() {
+  StatusOr<std::string> prefix =
+      CryptoFormat::GetOutputPrefix(TinkKeyInfo(kNumKeys));
+  CHECK_OK(prefix.status());
+  return *prefix;
+}
+
+std::unique_ptr<PrimitiveSet<Aead>> NewImmutableSet() {
+  PrimitiveSet<Aead>::Builder builder;
+  builder.AddPrimaryPrimitive(absl::make_unique<NullAead>(), TinkKeyInfo(1));
+  for (int i = 2; i <= kNumKeys; ++i) {
+    builder.AddPrimitive(absl::make_unique<NullAead>(), TinkKeyInfo(i));
+  }
+  StatusOr<PrimitiveSet<Aead>> set = std::move(builder).Build();
+  CHECK_OK(set.status());
+  return absl::make_unique<PrimitiveSet<Aead>>(*std::move(set));
+}
+
+// Set assembled with the deprecated mutable API, which locks on every read.
+std::unique_ptr<PrimitiveSet<Aead>> NewMutableSet() {
+  auto set = absl::make_unique<PrimitiveSet<Aead>>();
+  for (int i = 1; i <= kNumKeys; ++i) {
+    StatusOr<PrimitiveSet<Aead>::Entry<Aead>*> entry =
+        set->AddPrimitive(absl::make_unique<NullAead>(), TinkKeyInfo(i));
+    CHECK_OK(entry.status());
+    if (i == 1) {
+      CHECK_OK(set->set_primary(*entry));
+    }
+  }
+  return set;
+}
+
+const PrimitiveSet<Aead>& ImmutableSet() {
+  static const PrimitiveSet<Aead>* set = NewImmutableSet().release();
+  return *set;
+}
+
+const PrimitiveSet<Aead>& MutableSet() {
+  static const PrimitiveSet<Aead>* set = NewMutableSet().release();
+  return *set;
+}
+
+void BM_GetPrimitives(benchmark::State& state,
+                      const PrimitiveSet<Aead>& (*primitive_set)()) {
+  const PrimitiveSet<Aead>& set = primitive_set();
+  const std::string prefix = LastKeyPrefix();
+  for (auto _ : state) {
+    auto primitives = set.get_primitives(prefix);
+    benchmark::DoNotOptimize(primitives);
+  }
+}
+
+void BM_OutputPrefixIndexFind(benchmark::State& state) {
+  static const OutputPrefixIndex<Aead>* index =
+      new OutputPrefixIndex<Aead>(ImmutableSet());
+  const std::string ciphertext = absl::StrCat(LastKeyPrefix(), "payload");
+  for (auto _ : state) {
+    auto entries = index->Find(ciphertext);
+    benchmark::DoNotOptimize(entries);
+  }
+}
+
+void BM_WrappedAeadDecrypt(benchmark::State& state) {
+  static const Aead* aead = [] {
+    StatusOr<std::unique_ptr<Aead>> aead =
+        AeadWrapper().Wrap(NewImmutableSet());
+    CHECK_OK(aead.status());
+    return aead->release();
+  }();
+  const std::string ciphertext = absl::StrCat(LastKeyPrefix(), "payload");
+  for (auto _ : state) {
+    StatusOr<std::string> plaintext = aead->Decrypt(ciphertext, "");
+    CHECK_OK(plaintext.status());
+    benchmark::DoNotOptimize(plaintext);
+  }
+}
+
+BENCHMARK_CAPTURE(BM_GetPrimitives, Mutable, &MutableSet)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_GetPrimitives, Immutable, &ImmutableSet)
+    ->ThreadRange(1, kMaxThreads)
+    ->UseRealTime();
+BENCHMARK(BM_OutputPrefixIndexFind)->ThreadRange(1, kMaxThreads)->UseRealTime();
+BENCHMARK(BM_WrappedAeadDecrypt)->ThreadRange(1, kMaxThreads)->UseRealTime();
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
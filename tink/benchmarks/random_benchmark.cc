@@ -0,0 +1,63 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Compares drawing nonces with RAND_bytes on every call against drawing them
+// from the per-thread buffer of Random::GetRandomNonceBytes, which the
+// benchmark enables with Random::EnableNonceBuffering.
+
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/types/span.h"
+#include "tink/subtle/random.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+void BM_GetRandomBytes(benchmark::State& state) {
+  std::string nonce(state.range(0), '\0');
+  for (auto _ : state) {
+    CHECK_OK(Random::GetRandomBytes(absl::MakeSpan(nonce)));
+    benchmark::DoNotOptimize(nonce);
+  }
+}
+
+void BM_GetRandomNonceBytes(benchmark::State& state) {
+  Random::EnableNonceBuffering(true);
+  std::string nonce(state.range(0), '\0');
+  for (auto _ : state) {
+    CHECK_OK(Random::GetRandomNonceBytes(absl::MakeSpan(nonce)));
+    benchmark::DoNotOptimize(nonce);
+  }
+}
+
+// Nonce sizes of AES-GCM, AES-EAX and XChaCha20-Poly1305.
+void NonceSizes(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(12)->Arg(16)->Arg(24);
+}
+
+BENCHMARK(BM_GetRandomBytes)->Apply(NonceSizes);
+BENCHMARK(BM_GetRandomNonceBytes)->Apply(NonceSizes);
+BENCHMARK(BM_GetRandomBytes)->Arg(12)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_GetRandomNonceBytes)->Arg(12)->ThreadRange(1, 16)->UseRealTime();
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
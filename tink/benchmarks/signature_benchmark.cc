@@ -0,0 +1,123 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "tink/benchmarks/benchmark_util.h"
+#include "tink/config/global_registry.h"
+#include "tink/keyset_handle.h"
+#include "tink/public_key_sign.h"
+#include "tink/public_key_verify.h"
+#include "tink/signature/signature_config.h"
+#include "tink/signature/signature_key_templates.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::util::StatusOr;
+using ::google::crypto::tink::KeyTemplate;
+
+struct SignaturePair {
+  std::unique_ptr<PublicKeySign> sign;
+  std::unique_ptr<PublicKeyVerify> verify;
+};
+
+StatusOr<SignaturePair> NewSignaturePair(const KeyTemplate& key_template) {
+  util::Status status = SignatureConfig::Register();
+  if (!status.ok()) {
+    return status;
+  }
+  StatusOr<std::unique_ptr<KeysetHandle>> private_handle =
+      KeysetHandle::GenerateNew(key_template, KeyGenConfigGlobalRegistry());
+  if (!private_handle.ok()) {
+    return private_handle.status();
+  }
+  StatusOr<std::unique_ptr<KeysetHandle>> public_handle =
+      (*private_handle)->GetPublicKeysetHandle(KeyGenConfigGlobalRegistry());
+  if (!public_handle.ok()) {
+    return public_handle.status();
+  }
+  SignaturePair pair;
+  StatusOr<std::unique_ptr<PublicKeySign>> sign =
+      (*private_handle)->GetPrimitive<PublicKeySign>(ConfigGlobalRegistry());
+  if (!sign.ok()) {
+    return sign.status();
+  }
+  pair.sign = *std::move(sign);
+  StatusOr<std::unique_ptr<PublicKeyVerify>> verify =
+      (*public_handle)->GetPrimitive<PublicKeyVerify>(ConfigGlobalRegistry());
+  if (!verify.ok()) {
+    return verify.status();
+  }
+  pair.verify = *std::move(verify);
+  return pair;
+}
+
+void BM_Sign(benchmark::State& state, const KeyTemplate& key_template) {
+  StatusOr<SignaturePair> signature = NewSignaturePair(key_template);
+  if (SkipIfError(state, signature.status())) return;
+  std::string data = RandomPayload(state.range(0));
+  for (auto _ : state) {
+    StatusOr<std::string> sig = signature->sign->Sign(data);
+    CHECK_OK(sig.status());
+    benchmark::DoNotOptimize(sig);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+void BM_Verify(benchmark::State& state, const KeyTemplate& key_template) {
+  StatusOr<SignaturePair> signature = NewSignaturePair(key_template);
+  if (SkipIfError(state, signature.status())) return;
+  std::string data = RandomPayload(state.range(0));
+  StatusOr<std::string> sig = signature->sign->Sign(data);
+  if (SkipIfError(state, sig.status())) return;
+  for (auto _ : state) {
+    util::Status status = signature->verify->Verify(*sig, data);
+    CHECK_OK(status);
+    benchmark::DoNotOptimize(status);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+#define TINK_SIGNATURE_BENCHMARK(name)                                    \
+  BENCHMARK_CAPTURE(BM_Sign, name, SignatureKeyTemplates::name())         \
+      ->Apply(SmallPayloadSizes);                                         \
+  BENCHMARK_CAPTURE(BM_Verify, name, SignatureKeyTemplates::name())       \
+      ->Apply(SmallPayloadSizes)
+
+TINK_SIGNATURE_BENCHMARK(EcdsaP256);
+TINK_SIGNATURE_BENCHMARK(EcdsaP384Sha384);
+TINK_SIGNATURE_BENCHMARK(EcdsaP384Sha512);
+TINK_SIGNATURE_BENCHMARK(EcdsaP521);
+TINK_SIGNATURE_BENCHMARK(EcdsaP256Ieee);
+TINK_SIGNATURE_BENCHMARK(RsaSsaPkcs13072Sha256F4);
+TINK_SIGNATURE_BENCHMARK(RsaSsaPkcs14096Sha512F4);
+TINK_SIGNATURE_BENCHMARK(RsaSsaPss3072Sha256Sha256F4);
+TINK_SIGNATURE_BENCHMARK(RsaSsaPss4096Sha512Sha512F4);
+TINK_SIGNATURE_BENCHMARK(Ed25519);
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
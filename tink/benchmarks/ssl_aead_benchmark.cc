@@ -0,0 +1,135 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+// Measures the per-call setup cost of the one-shot AEAD crypters. The
+// BM_*Context benchmarks compare keying a fresh EVP_CIPHER_CTX for every
+// message with copying a context whose key schedule was expanded once.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/evp.h"
+#include "tink/aead/internal/aead_util.h"
+#include "tink/aead/internal/ssl_aead.h"
+#include "tink/benchmarks/benchmark_util.h"
+#include "tink/internal/ssl_unique_ptr.h"
+#include "tink/subtle/random.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::util::SecretData;
+using ::crypto::tink::util::StatusOr;
+
+constexpr int kIvSizeInBytes = 12;
+
+const EVP_CIPHER* Aes128GcmCipher() {
+  StatusOr<const EVP_CIPHER*> cipher = GetAesGcmCipherForKeySize(16);
+  CHECK_OK(cipher.status());
+  return *cipher;
+}
+
+// Keys a new context for every message, as done before the key schedule was
+// cached.
+void BM_KeyedContextSetup(benchmark::State& state) {
+  const EVP_CIPHER* cipher = Aes128GcmCipher();
+  const SecretData key = subtle::Random::GetRandomKeyBytes(16);
+  for (auto _ : state) {
+    SslUniquePtr<EVP_CIPHER_CTX> context(EVP_CIPHER_CTX_new());
+    CHECK(EVP_CipherInit_ex(context.get(), cipher, /*impl=*/nullptr,
+                            key.data(), /*iv=*/nullptr, /*enc=*/1) > 0);
+    benchmark::DoNotOptimize(context);
+  }
+}
+
+// Copies a context keyed once up front.
+void BM_KeyedContextCopy(benchmark::State& state) {
+  const SecretData key = subtle::Random::GetRandomKeyBytes(16);
+  SslUniquePtr<EVP_CIPHER_CTX> keyed_context(EVP_CIPHER_CTX_new());
+  CHECK(EVP_CipherInit_ex(keyed_context.get(), Aes128GcmCipher(),
+                          /*impl=*/nullptr, key.data(), /*iv=*/nullptr,
+                          /*enc=*/1) > 0);
+  for (auto _ : state) {
+    SslUniquePtr<EVP_CIPHER_CTX> context(EVP_CIPHER_CTX_new());
+    CHECK(EVP_CIPHER_CTX_copy(context.get(), keyed_context.get()) > 0);
+    benchmark::DoNotOptimize(context);
+  }
+}
+
+// One-shot encryption of a single message, including the per-call setup.
+void BM_OneShotEncrypt(
+    benchmark::State& state,
+    StatusOr<std::unique_ptr<SslOneShotAead>> (*create)(const SecretData&),
+    int key_size) {
+  StatusOr<std::unique_ptr<SslOneShotAead>> aead =
+      create(subtle::Random::GetRandomKeyBytes(key_size));
+  if (SkipIfError(state, aead.status())) {
+    return;
+  }
+  const std::string plaintext = RandomPayload(state.range(0));
+  const std::string iv = subtle::Random::GetRandomBytes(kIvSizeInBytes);
+  std::string ciphertext((*aead)->CiphertextSize(plaintext.size()), '\0');
+  for (auto _ : state) {
+    StatusOr<int64_t> written_bytes =
+        (*aead)->Encrypt(plaintext, kBenchmarkAssociatedData, iv,
+                         absl::MakeSpan(ciphertext));
+    if (SkipIfError(state, written_bytes.status())) {
+      return;
+    }
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  SetThroughput(state, plaintext.size());
+}
+
+// Small messages, where the per-call setup dominates.
+void SetupBoundPayloadSizes(::benchmark::internal::Benchmark* benchmark) {
+  benchmark->Arg(16)->Arg(64)->Arg(256)->Arg(1024);
+}
+
+BENCHMARK(BM_KeyedContextSetup);
+BENCHMARK(BM_KeyedContextCopy);
+BENCHMARK_CAPTURE(BM_OneShotEncrypt, AesGcm128, &CreateAesGcmOneShotCrypter,
+                  16)
+    ->Apply(SetupBoundPayloadSizes);
+BENCHMARK_CAPTURE(BM_OneShotEncrypt, AesGcm256, &CreateAesGcmOneShotCrypter,
+                  32)
+    ->Apply(SetupBoundPayloadSizes);
+BENCHMARK_CAPTURE(BM_OneShotEncrypt, AesGcmSiv256,
+                  &CreateAesGcmSivOneShotCrypter, 32)
+    ->Apply(SetupBoundPayloadSizes);
+BENCHMARK_CAPTURE(BM_OneShotEncrypt, XChaCha20Poly1305,
+                  &CreateXchacha20Poly1305OneShotCrypter, 32)
+    ->Apply(SetupBoundPayloadSizes);
+// Calls from many threads share the same cached key schedule.
+BENCHMARK_CAPTURE(BM_OneShotEncrypt, AesGcm128Threads,
+                  &CreateAesGcmOneShotCrypter, 16)
+    ->Arg(64)
+    ->ThreadRange(1, 16)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
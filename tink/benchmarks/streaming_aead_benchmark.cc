@@ -0,0 +1,183 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "absl/log/check.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tink/benchmarks/benchmark_util.h"
+#include "tink/input_stream.h"
+#include "tink/output_stream.h"
+#include "tink/streaming_aead.h"
+#include "tink/subtle/aes_ctr_hmac_streaming.h"
+#include "tink/subtle/aes_gcm_hkdf_streaming.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/random.h"
+#include "tink/util/istream_input_stream.h"
+#include "tink/util/ostream_output_stream.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::util::IstreamInputStream;
+using ::crypto::tink::util::OstreamOutputStream;
+using ::crypto::tink::util::SecretDataFromStringView;
+using ::crypto::tink::util::Status;
+using ::crypto::tink::util::StatusOr;
+
+constexpr int kSegmentSize = 1 << 20;
+
+StatusOr<std::unique_ptr<StreamingAead>> NewAesGcmHkdfStreaming() {
+  subtle::AesGcmHkdfStreaming::Params params;
+  params.ikm = SecretDataFromStringView(subtle::Random::GetRandomBytes(32));
+  params.hkdf_hash = subtle::HashType::SHA256;
+  params.derived_key_size = 32;
+  params.ciphertext_segment_size = kSegmentSize;
+  params.ciphertext_offset = 0;
+  return subtle::AesGcmHkdfStreaming::New(std::move(params));
+}
+
+StatusOr<std::unique_ptr<StreamingAead>> NewAesCtrHmacStreaming() {
+  subtle::AesCtrHmacStreaming::Params params;
+  params.ikm = SecretDataFromStringView(subtle::Random::GetRandomBytes(32));
+  params.hkdf_algo = subtle::HashType::SHA256;
+  params.key_size = 32;
+  params.ciphertext_segment_size = kSegmentSize;
+  params.ciphertext_offset = 0;
+  params.tag_algo = subtle::HashType::SHA256;
+  params.tag_size = 32;
+  return subtle::AesCtrHmacStreaming::New(std::move(params));
+}
+
+// Encrypts `plaintext` with `streaming_aead` and returns the ciphertext.
+StatusOr<std::string> Encrypt(const StreamingAead& streaming_aead,
+                              absl::string_view plaintext) {
+  auto ciphertext_stream = absl::make_unique<std::stringstream>();
+  std::stringstream* ciphertext = ciphertext_stream.get();
+  StatusOr<std::unique_ptr<OutputStream>> encrypting_stream =
+      streaming_aead.NewEncryptingStream(
+          absl::make_unique<OstreamOutputStream>(std::move(ciphertext_stream)),
+          kBenchmarkAssociatedData);
+  if (!encrypting_stream.ok()) {
+    return encrypting_stream.status();
+  }
+  while (!plaintext.empty()) {
+    void* buffer;
+    StatusOr<int> next = (*encrypting_stream)->Next(&buffer);
+    if (!next.ok()) {
+      return next.status();
+    }
+    int written = std::min<int>(*next, plaintext.size());
+    std::memcpy(buffer, plaintext.data(), written);
+    plaintext.remove_prefix(written);
+    if (written < *next) {
+      (*encrypting_stream)->BackUp(*next - written);
+    }
+  }
+  Status status = (*encrypting_stream)->Close();
+  if (!status.ok()) {
+    return status;
+  }
+  return ciphertext->str();
+}
+
+// Decrypts `ciphertext` with `streaming_aead` and returns the number of
+// plaintext bytes.
+StatusOr<int64_t> Decrypt(const StreamingAead& streaming_aead,
+                          absl::string_view ciphertext) {
+  StatusOr<std::unique_ptr<InputStream>> decrypting_stream =
+      streaming_aead.NewDecryptingStream(
+          absl::make_unique<IstreamInputStream>(
+              absl::make_unique<std::stringstream>(std::string(ciphertext))),
+          kBenchmarkAssociatedData);
+  if (!decrypting_stream.ok()) {
+    return decrypting_stream.status();
+  }
+  int64_t plaintext_size = 0;
+  while (true) {
+    const void* buffer;
+    StatusOr<int> next = (*decrypting_stream)->Next(&buffer);
+    if (next.status().code() == absl::StatusCode::kOutOfRange) {
+      return plaintext_size;
+    }
+    if (!next.ok()) {
+      return next.status();
+    }
+    benchmark::DoNotOptimize(buffer);
+    plaintext_size += *next;
+  }
+}
+
+template <class Factory>
+void BM_StreamingEncrypt(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<StreamingAead>> streaming_aead = factory();
+  if (SkipIfError(state, streaming_aead.status())) return;
+  std::string plaintext = RandomPayload(state.range(0));
+  for (auto _ : state) {
+    StatusOr<std::string> ciphertext = Encrypt(**streaming_aead, plaintext);
+    CHECK_OK(ciphertext.status());
+    benchmark::DoNotOptimize(ciphertext);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+template <class Factory>
+void BM_StreamingDecrypt(benchmark::State& state, Factory factory) {
+  StatusOr<std::unique_ptr<StreamingAead>> streaming_aead = factory();
+  if (SkipIfError(state, streaming_aead.status())) return;
+  StatusOr<std::string> ciphertext =
+      Encrypt(**streaming_aead, RandomPayload(state.range(0)));
+  if (SkipIfError(state, ciphertext.status())) return;
+  for (auto _ : state) {
+    StatusOr<int64_t> plaintext_size = Decrypt(**streaming_aead, *ciphertext);
+    CHECK_OK(plaintext_size.status());
+    benchmark::DoNotOptimize(plaintext_size);
+  }
+  SetThroughput(state, state.range(0));
+}
+
+// Streams are benchmarked from one segment up to 64 segments.
+void StreamSizes(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(8)->Range(1 << 10, 64 << 20);
+}
+
+BENCHMARK_CAPTURE(BM_StreamingEncrypt, AesGcmHkdf1MB, NewAesGcmHkdfStreaming)
+    ->Apply(StreamSizes);
+BENCHMARK_CAPTURE(BM_StreamingDecrypt, AesGcmHkdf1MB, NewAesGcmHkdfStreaming)
+    ->Apply(StreamSizes);
+BENCHMARK_CAPTURE(BM_StreamingEncrypt, AesCtrHmac1MB, NewAesCtrHmacStreaming)
+    ->Apply(StreamSizes);
+BENCHMARK_CAPTURE(BM_StreamingDecrypt, AesCtrHmac1MB, NewAesCtrHmacStreaming)
+    ->Apply(StreamSizes);
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,93 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/aead.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/internal/batch_util.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+util::Status Aead::EncryptBatch(
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* ciphertexts, std::vector<int64_t>* offsets) const {
+  return EncryptBatchWithPrefix(/*output_prefix=*/"", plaintexts,
+                                associated_data, ciphertexts, offsets);
+}
+
+util::Status Aead::EncryptBatchWithPrefix(
+    absl::string_view output_prefix,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* ciphertexts, std::vector<int64_t>* offsets) const {
+  util::Status status = internal::ValidateBatchAssociatedData(
+      plaintexts.size(), associated_data);
+  if (!status.ok()) {
+    return status;
+  }
+  ciphertexts->clear();
+  offsets->assign(1, 0);
+  offsets->reserve(plaintexts.size() + 1);
+  for (int64_t i = 0; i < plaintexts.size(); ++i) {
+    util::StatusOr<std::string> ciphertext = Encrypt(
+        plaintexts[i], internal::BatchAssociatedData(associated_data, i));
+    if (!ciphertext.ok()) {
+      return ciphertext.status();
+    }
+    absl::StrAppend(ciphertexts, output_prefix, *ciphertext);
+    offsets->push_back(ciphertexts->size());
+  }
+  return util::OkStatus();
+}
+
+util::Status Aead::DecryptBatch(
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* plaintexts, std::vector<int64_t>* offsets) const {
+  util::Status status = internal::ValidateBatchAssociatedData(
+      ciphertexts.size(), associated_data);
+  if (!status.ok()) {
+    internal::ClearFailedBatchOutputs(plaintexts, offsets);
+    return status;
+  }
+  plaintexts->clear();
+  offsets->assign(1, 0);
+  offsets->reserve(ciphertexts.size() + 1);
+  for (int64_t i = 0; i < ciphertexts.size(); ++i) {
+    util::StatusOr<std::string> plaintext = Decrypt(
+        ciphertexts[i], internal::BatchAssociatedData(associated_data, i));
+    if (!plaintext.ok()) {
+      internal::ClearFailedBatchOutputs(plaintexts, offsets);
+      return plaintext.status();
+    }
+    plaintexts->append(*plaintext);
+    offsets->push_back(plaintexts->size());
+  }
+  return util::OkStatus();
+}
+
+}  // namespace tink
+}  // namespace crypto
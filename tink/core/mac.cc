@@ -0,0 +1,90 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/mac.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+
+util::StatusOr<std::string> Mac::ComputeMacFromParts(
+    absl::Span<const absl::string_view> data_parts) const {
+  if (data_parts.size() == 1) {
+    return ComputeMac(data_parts[0]);
+  }
+  return ComputeMac(absl::StrJoin(data_parts, ""));
+}
+
+util::Status Mac::VerifyMacFromParts(
+    absl::string_view mac_value,
+    absl::Span<const absl::string_view> data_parts) const {
+  if (data_parts.size() == 1) {
+    return VerifyMac(mac_value, data_parts[0]);
+  }
+  return VerifyMac(mac_value, absl::StrJoin(data_parts, ""));
+}
+
+util::Status Mac::ComputeMacBatch(absl::Span<const absl::string_view> data,
+                                  std::string* mac_values,
+                                  std::vector<int64_t>* offsets) const {
+  return ComputeMacBatchWithPrefix(/*output_prefix=*/"", data, mac_values,
+                                   offsets);
+}
+
+util::Status Mac::ComputeMacBatchWithPrefix(
+    absl::string_view output_prefix, absl::Span<const absl::string_view> data,
+    std::string* mac_values, std::vector<int64_t>* offsets) const {
+  mac_values->clear();
+  offsets->assign(1, 0);
+  offsets->reserve(data.size() + 1);
+  for (absl::string_view element : data) {
+    util::StatusOr<std::string> mac_value = ComputeMac(element);
+    if (!mac_value.ok()) {
+      return mac_value.status();
+    }
+    absl::StrAppend(mac_values, output_prefix, *mac_value);
+    offsets->push_back(mac_values->size());
+  }
+  return util::OkStatus();
+}
+
+util::Status Mac::VerifyMacBatch(absl::Span<const absl::string_view> mac_values,
+                                 absl::Span<const absl::string_view> data,
+                                 std::vector<bool>* verified) const {
+  if (mac_values.size() != data.size()) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "mac_values and data must have the same size");
+  }
+  verified->assign(data.size(), false);
+  for (int64_t i = 0; i < data.size(); ++i) {
+    (*verified)[i] = VerifyMac(mac_values[i], data[i]).ok();
+  }
+  return util::OkStatus();
+}
+
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,36 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+#include "tink/public_key_verify.h"
+
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+
+util::Status PublicKeyVerify::VerifyFromParts(
+    absl::string_view signature,
+    absl::Span<const absl::string_view> data_parts) const {
+  if (data_parts.size() == 1) {
+    return Verify(signature, data_parts[0]);
+  }
+  return Verify(signature, absl::StrJoin(data_parts, ""));
+}
+
+}  // namespace tink
+}  // namespace crypto
@@ -16,14 +16,22 @@
 
 #include "tink/daead/deterministic_aead_wrapper.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/strings/match.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/crypto_format.h"
 #include "tink/deterministic_aead.h"
+#include "tink/internal/batch_util.h"
 #include "tink/internal/monitoring_util.h"
+#include "tink/internal/output_prefix_index.h"
 #include "tink/internal/registry_impl.h"
 #include "tink/internal/util.h"
 #include "tink/monitoring/monitoring.h"
@@ -59,6 +67,7 @@ class  DeterministicAeadSetWrapper : public DeterministicAead {
       std::unique_ptr<MonitoringClient> monitoring_encryption_client = nullptr,
       std::unique_ptr<MonitoringClient> monitoring_decryption_client = nullptr)
       : daead_set_(std::move(daead_set)),
+        prefix_index_(*daead_set_),
         monitoring_encryption_client_(std::move(monitoring_encryption_client)),
         monitoring_decryption_client_(std::move(monitoring_decryption_client))
         {}
@@ -71,10 +80,29 @@ class  DeterministicAeadSetWrapper : public DeterministicAead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const override;
 
+  util::Status EncryptDeterministicallyBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* ciphertexts, std::vector<int64_t>* offsets) const override;
+
+  util::Status DecryptDeterministicallyBatch(
+      absl::Span<const absl::string_view> ciphertexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* plaintexts, std::vector<int64_t>* offsets) const override;
+
   ~DeterministicAeadSetWrapper() override = default;
 
  private:
+  // Decrypts `ciphertext` with the first matching key in the set, without
+  // logging to monitoring. On success, `key_id` and `raw_ciphertext_size` are
+  // set to the ID of the key used and the size of the ciphertext without the
+  // output prefix.
+  util::StatusOr<std::string> DecryptWithoutMonitoring(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      uint32_t* key_id, int64_t* raw_ciphertext_size) const;
+
   std::unique_ptr<PrimitiveSet<DeterministicAead>> daead_set_;
+  const internal::OutputPrefixIndex<DeterministicAead> prefix_index_;
   std::unique_ptr<MonitoringClient> monitoring_encryption_client_;
   std::unique_ptr<MonitoringClient> monitoring_decryption_client_;
 };
@@ -107,54 +135,163 @@ DeterministicAeadSetWrapper::EncryptDeterministically(
 util::StatusOr<std::string>
 DeterministicAeadSetWrapper::DecryptDeterministically(
     absl::string_view ciphertext, absl::string_view associated_data) const {
+  uint32_t key_id;
+  int64_t raw_ciphertext_size;
+  util::StatusOr<std::string> plaintext = DecryptWithoutMonitoring(
+      ciphertext, associated_data, &key_id, &raw_ciphertext_size);
+  if (monitoring_decryption_client_ != nullptr) {
+    if (plaintext.ok()) {
+      monitoring_decryption_client_->Log(key_id, raw_ciphertext_size);
+    } else {
+      monitoring_decryption_client_->LogFailure();
+    }
+  }
+  return plaintext;
+}
+
+util::StatusOr<std::string>
+DeterministicAeadSetWrapper::DecryptWithoutMonitoring(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    uint32_t* key_id, int64_t* raw_ciphertext_size) const {
   // BoringSSL expects a non-null pointer for plaintext and associated_data,
   // regardless of whether the size is 0.
   associated_data = internal::EnsureStringNonNull(associated_data);
 
   if (ciphertext.length() > CryptoFormat::kNonRawPrefixSize) {
-    absl::string_view key_id =
-        ciphertext.substr(0, CryptoFormat::kNonRawPrefixSize);
-    auto primitives_result = daead_set_->get_primitives(key_id);
-    if (primitives_result.ok()) {
-      absl::string_view raw_ciphertext =
-          ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
-      for (const auto& daead_entry : *(primitives_result.value())) {
-        DeterministicAead& daead = daead_entry->get_primitive();
-        auto decrypt_result =
-            daead.DecryptDeterministically(raw_ciphertext, associated_data);
-        if (decrypt_result.ok()) {
-          if (monitoring_decryption_client_ != nullptr) {
-            monitoring_decryption_client_->Log(daead_entry->get_key_id(),
-                                               raw_ciphertext.size());
-          }
-          return std::move(decrypt_result.value());
-        } else {
-          // LOG that a matching key didn't decrypt the ciphertext.
-        }
+    absl::string_view raw_ciphertext =
+        ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
+    for (const auto* daead_entry : prefix_index_.Find(ciphertext)) {
+      DeterministicAead& daead = daead_entry->get_primitive();
+      auto decrypt_result =
+          daead.DecryptDeterministically(raw_ciphertext, associated_data);
+      if (decrypt_result.ok()) {
+        *key_id = daead_entry->get_key_id();
+        *raw_ciphertext_size = raw_ciphertext.size();
+        return std::move(decrypt_result.value());
+      } else {
+        // LOG that a matching key didn't decrypt the ciphertext.
       }
     }
   }
 
   // No matching key succeeded with decryption, try all RAW keys.
-  auto raw_primitives_result = daead_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (const auto& daead_entry : *(raw_primitives_result.value())) {
-      DeterministicAead& daead = daead_entry->get_primitive();
-      auto decrypt_result =
-          daead.DecryptDeterministically(ciphertext, associated_data);
-      if (decrypt_result.ok()) {
-        if (monitoring_decryption_client_ != nullptr) {
-          monitoring_decryption_client_->Log(daead_entry->get_key_id(),
-                                             ciphertext.size());
-        }
-        return std::move(decrypt_result.value());
+  for (const auto* daead_entry : prefix_index_.raw_entries()) {
+    DeterministicAead& daead = daead_entry->get_primitive();
+    auto decrypt_result =
+        daead.DecryptDeterministically(ciphertext, associated_data);
+    if (decrypt_result.ok()) {
+      *key_id = daead_entry->get_key_id();
+      *raw_ciphertext_size = ciphertext.size();
+      return std::move(decrypt_result.value());
+    }
+  }
+  return util::Status(absl::StatusCode::kInvalidArgument, "decryption failed");
+}
+
+util::Status DeterministicAeadSetWrapper::EncryptDeterministicallyBatch(
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* ciphertexts, std::vector<int64_t>* offsets) const {
+  // The primary is resolved once for the whole batch, and writes each
+  // ciphertext right after its output prefix.
+  const PrimitiveSet<DeterministicAead>::Entry<DeterministicAead>* primary =
+      daead_set_->get_primary();
+  util::Status status =
+      primary->get_primitive().EncryptDeterministicallyBatchWithPrefix(
+          primary->get_identifier(), plaintexts, associated_data, ciphertexts,
+          offsets);
+  if (!status.ok()) {
+    if (monitoring_encryption_client_ != nullptr) {
+      monitoring_encryption_client_->LogFailure();
+    }
+    return status;
+  }
+  if (monitoring_encryption_client_ != nullptr) {
+    int64_t plaintexts_size = 0;
+    for (absl::string_view plaintext : plaintexts) {
+      plaintexts_size += plaintext.size();
+    }
+    monitoring_encryption_client_->Log(primary->get_key_id(), plaintexts_size);
+  }
+  return util::OkStatus();
+}
+
+util::Status DeterministicAeadSetWrapper::DecryptDeterministicallyBatch(
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* plaintexts, std::vector<int64_t>* offsets) const {
+  util::Status status = internal::ValidateBatchAssociatedData(
+      ciphertexts.size(), associated_data);
+  if (!status.ok()) {
+    internal::ClearFailedBatchOutputs(plaintexts, offsets);
+    if (monitoring_decryption_client_ != nullptr) {
+      monitoring_decryption_client_->LogFailure();
+    }
+    return status;
+  }
+
+  // Fast path: all ciphertexts carry the output prefix of the primary, as is
+  // typical for a column encrypted since the last key rotation. The batch is
+  // then decrypted by the primary in a single call.
+  const PrimitiveSet<DeterministicAead>::Entry<DeterministicAead>* primary =
+      daead_set_->get_primary();
+  const std::string& primary_prefix = primary->get_identifier();
+  bool all_primary = true;
+  for (absl::string_view ciphertext : ciphertexts) {
+    if (!absl::StartsWith(ciphertext, primary_prefix)) {
+      all_primary = false;
+      break;
+    }
+  }
+  if (all_primary) {
+    std::vector<absl::string_view> raw_ciphertexts;
+    raw_ciphertexts.reserve(ciphertexts.size());
+    int64_t raw_ciphertexts_size = 0;
+    for (absl::string_view ciphertext : ciphertexts) {
+      raw_ciphertexts.push_back(ciphertext.substr(primary_prefix.size()));
+      raw_ciphertexts_size += raw_ciphertexts.back().size();
+    }
+    status = primary->get_primitive().DecryptDeterministicallyBatch(
+        raw_ciphertexts, associated_data, plaintexts, offsets);
+    if (status.ok()) {
+      if (monitoring_decryption_client_ != nullptr) {
+        monitoring_decryption_client_->Log(primary->get_key_id(),
+                                           raw_ciphertexts_size);
       }
+      return util::OkStatus();
     }
   }
+
+  // Otherwise, decrypt the ciphertexts one by one with the matching keys, and
+  // log once per key used.
+  internal::ClearFailedBatchOutputs(plaintexts, offsets);
+  offsets->assign(1, 0);
+  offsets->reserve(ciphertexts.size() + 1);
+  absl::flat_hash_map<uint32_t, int64_t> raw_ciphertexts_size_per_key;
+  for (int64_t i = 0; i < ciphertexts.size(); ++i) {
+    uint32_t key_id;
+    int64_t raw_ciphertext_size;
+    util::StatusOr<std::string> plaintext = DecryptWithoutMonitoring(
+        ciphertexts[i], internal::BatchAssociatedData(associated_data, i),
+        &key_id, &raw_ciphertext_size);
+    if (!plaintext.ok()) {
+      internal::ClearFailedBatchOutputs(plaintexts, offsets);
+      if (monitoring_decryption_client_ != nullptr) {
+        monitoring_decryption_client_->LogFailure();
+      }
+      return plaintext.status();
+    }
+    plaintexts->append(*plaintext);
+    offsets->push_back(plaintexts->size());
+    raw_ciphertexts_size_per_key[key_id] += raw_ciphertext_size;
+  }
   if (monitoring_decryption_client_ != nullptr) {
-    monitoring_decryption_client_->LogFailure();
+    for (const auto& key_and_size : raw_ciphertexts_size_per_key) {
+      monitoring_decryption_client_->Log(key_and_size.first,
+                                         key_and_size.second);
+    }
   }
-  return util::Status(absl::StatusCode::kInvalidArgument, "decryption failed");
+  return util::OkStatus();
 }
 
 }  // anonymous namespace
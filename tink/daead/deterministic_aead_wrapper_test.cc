@@ -16,13 +16,20 @@
 
 #include "tink/daead/deterministic_aead_wrapper.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/crypto_format.h"
 #include "tink/daead/failing_daead.h"
 #include "tink/deterministic_aead.h"
 #include "tink/internal/registry_impl.h"
@@ -30,6 +37,7 @@
 #include "tink/monitoring/monitoring_client_mocks.h"
 #include "tink/primitive_set.h"
 #include "tink/util/status.h"
+#include "tink/util/statusor.h"
 #include "tink/util/test_matchers.h"
 #include "tink/util/test_util.h"
 
@@ -42,11 +50,13 @@ using ::google::crypto::tink::KeyStatusType;
 using ::google::crypto::tink::OutputPrefixType;
 using ::testing::_;
 using ::testing::ByMove;
+using ::testing::ElementsAre;
 using ::testing::IsNull;
 using ::testing::NiceMock;
 using ::testing::Not;
 using ::testing::NotNull;
 using ::testing::Return;
+using ::testing::SizeIs;
 using ::testing::Test;
 
 namespace crypto {
@@ -180,6 +190,110 @@ KeysetInfo CreateTestKeysetInfo() {
   return keyset_info;
 }
 
+TEST(DeterministicAeadSetWrapperBatchTest, EncryptDecryptBatch) {
+  KeysetInfo keyset_info = CreateTestKeysetInfo();
+  auto daead_set = absl::make_unique<PrimitiveSet<DeterministicAead>>();
+  for (int i = 0; i < keyset_info.key_info_size(); ++i) {
+    util::StatusOr<PrimitiveSet<DeterministicAead>::Entry<DeterministicAead>*>
+        entry = daead_set->AddPrimitive(
+            absl::make_unique<DummyDeterministicAead>(
+                absl::StrCat("daead", i)),
+            keyset_info.key_info(i));
+    ASSERT_THAT(entry, IsOk());
+    ASSERT_THAT(daead_set->set_primary(*entry), IsOk());
+  }
+  util::StatusOr<std::unique_ptr<DeterministicAead>> daead =
+      DeterministicAeadWrapper().Wrap(std::move(daead_set));
+  ASSERT_THAT(daead, IsOk());
+
+  std::vector<absl::string_view> plaintexts = {"plaintext 0", "",
+                                               "plaintext 2"};
+  std::vector<absl::string_view> associated_data = {"ad 0", "ad 1", "ad 2"};
+  std::string ciphertexts;
+  std::vector<int64_t> ciphertext_offsets;
+  ASSERT_THAT((*daead)->EncryptDeterministicallyBatch(
+                  plaintexts, associated_data, &ciphertexts,
+                  &ciphertext_offsets),
+              IsOk());
+  ASSERT_THAT(ciphertext_offsets, SizeIs(plaintexts.size() + 1));
+
+  // Every ciphertext of the batch is the regular ciphertext of the primary.
+  std::vector<absl::string_view> ciphertext_views;
+  for (int i = 0; i < plaintexts.size(); ++i) {
+    absl::string_view ciphertext = absl::string_view(ciphertexts).substr(
+        ciphertext_offsets[i],
+        ciphertext_offsets[i + 1] - ciphertext_offsets[i]);
+    EXPECT_THAT((*daead)->EncryptDeterministically(plaintexts[i],
+                                                   associated_data[i]),
+                IsOkAndHolds(std::string(ciphertext)));
+    ciphertext_views.push_back(ciphertext);
+  }
+
+  std::string decrypted;
+  std::vector<int64_t> plaintext_offsets;
+  ASSERT_THAT((*daead)->DecryptDeterministicallyBatch(
+                  ciphertext_views, associated_data, &decrypted,
+                  &plaintext_offsets),
+              IsOk());
+  EXPECT_EQ(decrypted, absl::StrJoin(plaintexts, ""));
+  EXPECT_THAT(plaintext_offsets, ElementsAre(0, 11, 11, 22));
+
+  // Any other number of associated data values is rejected.
+  EXPECT_THAT((*daead)->EncryptDeterministicallyBatch(
+                  plaintexts,
+                  absl::MakeConstSpan(associated_data).subspan(0, 2),
+                  &ciphertexts, &ciphertext_offsets),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(DeterministicAeadSetWrapperBatchTest, DecryptBatchWithMixedKeys) {
+  KeysetInfo keyset_info = CreateTestKeysetInfo();
+  auto daead_set = absl::make_unique<PrimitiveSet<DeterministicAead>>();
+  for (int i = 0; i < keyset_info.key_info_size(); ++i) {
+    util::StatusOr<PrimitiveSet<DeterministicAead>::Entry<DeterministicAead>*>
+        entry = daead_set->AddPrimitive(
+            absl::make_unique<DummyDeterministicAead>(
+                absl::StrCat("daead", i)),
+            keyset_info.key_info(i));
+    ASSERT_THAT(entry, IsOk());
+    ASSERT_THAT(daead_set->set_primary(*entry), IsOk());
+  }
+  util::StatusOr<std::unique_ptr<DeterministicAead>> daead =
+      DeterministicAeadWrapper().Wrap(std::move(daead_set));
+  ASSERT_THAT(daead, IsOk());
+
+  // Encrypt with a non-primary key, then with the primary.
+  constexpr absl::string_view kAssociatedData = "ad";
+  util::StatusOr<std::string> prefix =
+      CryptoFormat::GetOutputPrefix(keyset_info.key_info(0));
+  ASSERT_THAT(prefix, IsOk());
+  util::StatusOr<std::string> old_ciphertext =
+      DummyDeterministicAead("daead0").EncryptDeterministically(
+          "old", kAssociatedData);
+  ASSERT_THAT(old_ciphertext, IsOk());
+  std::string old_complete_ciphertext = absl::StrCat(*prefix, *old_ciphertext);
+  util::StatusOr<std::string> new_ciphertext =
+      (*daead)->EncryptDeterministically("new", kAssociatedData);
+  ASSERT_THAT(new_ciphertext, IsOk());
+
+  std::vector<absl::string_view> ciphertexts = {old_complete_ciphertext,
+                                                *new_ciphertext};
+  std::vector<absl::string_view> associated_data = {kAssociatedData};
+  std::string plaintexts;
+  std::vector<int64_t> offsets;
+  ASSERT_THAT((*daead)->DecryptDeterministicallyBatch(
+                  ciphertexts, associated_data, &plaintexts, &offsets),
+              IsOk());
+  EXPECT_EQ(plaintexts, "oldnew");
+  EXPECT_THAT(offsets, ElementsAre(0, 3, 6));
+
+  // The whole batch fails if any ciphertext is invalid.
+  ciphertexts.push_back("some bad ciphertext");
+  EXPECT_THAT((*daead)->DecryptDeterministicallyBatch(
+                  ciphertexts, associated_data, &plaintexts, &offsets),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 // Tests for the monitoring behavior.
 class DeterministicAeadSetWrapperWithMonitoringTest : public Test {
  protected:
@@ -17,9 +17,13 @@
 #ifndef TINK_DETERMINISTIC_AEAD_H_
 #define TINK_DETERMINISTIC_AEAD_H_
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -53,6 +57,48 @@ class DeterministicAead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const = 0;
 
+  // Encrypts each element of 'plaintexts' deterministically and writes the
+  // resulting ciphertexts back to back into 'ciphertexts', replacing its
+  // contents. 'associated_data' is either empty, a single value used for all
+  // plaintexts, or holds one value per plaintext. On success, 'offsets' holds
+  // plaintexts.size() + 1 entries, and the i-th ciphertext is the range
+  // [offsets[i], offsets[i + 1]) of 'ciphertexts'.
+  //
+  // Reusing 'ciphertexts' and 'offsets' across calls avoids reallocations.
+  // The default implementation calls EncryptDeterministicallyBatchWithPrefix()
+  // with an empty prefix, which is what implementations should override.
+  virtual crypto::tink::util::Status EncryptDeterministicallyBatch(
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* ciphertexts, std::vector<int64_t>* offsets) const;
+
+  // Like EncryptDeterministicallyBatch(), but each ciphertext range of
+  // 'ciphertexts' starts with 'output_prefix'. This lets keyset wrappers add
+  // the key prefix while the ciphertexts are written, rather than moving them
+  // afterwards.
+  //
+  // The default implementation calls EncryptDeterministically() for each
+  // plaintext.
+  virtual crypto::tink::util::Status EncryptDeterministicallyBatchWithPrefix(
+      absl::string_view output_prefix,
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* ciphertexts, std::vector<int64_t>* offsets) const;
+
+  // Decrypts each element of 'ciphertexts' and writes the resulting
+  // plaintexts back to back into 'plaintexts', with 'associated_data' and
+  // 'offsets' as in EncryptDeterministicallyBatch(). Fails if any ciphertext
+  // fails to decrypt, in which case 'plaintexts' is wiped and both
+  // 'plaintexts' and 'offsets' are left empty; implementations must not leave
+  // partial results behind.
+  //
+  // The default implementation calls DecryptDeterministically() for each
+  // ciphertext.
+  virtual crypto::tink::util::Status DecryptDeterministicallyBatch(
+      absl::Span<const absl::string_view> ciphertexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* plaintexts, std::vector<int64_t>* offsets) const;
+
   virtual ~DeterministicAead() = default;
 };
 
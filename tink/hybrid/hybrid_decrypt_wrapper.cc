@@ -24,6 +24,7 @@
 #include "tink/crypto_format.h"
 #include "tink/hybrid_decrypt.h"
 #include "tink/internal/monitoring_util.h"
+#include "tink/internal/output_prefix_index.h"
 #include "tink/internal/registry_impl.h"
 #include "tink/internal/util.h"
 #include "tink/monitoring/monitoring.h"
@@ -45,6 +46,7 @@ class HybridDecryptSetWrapper : public HybridDecrypt {
       std::unique_ptr<PrimitiveSet<HybridDecrypt>> hybrid_decrypt_set,
       std::unique_ptr<MonitoringClient> monitoring_decryption_client = nullptr)
       : hybrid_decrypt_set_(std::move(hybrid_decrypt_set)),
+        prefix_index_(*hybrid_decrypt_set_),
         monitoring_decryption_client_(std::move(monitoring_decryption_client)) {
   }
 
@@ -56,6 +58,7 @@ class HybridDecryptSetWrapper : public HybridDecrypt {
 
  private:
   std::unique_ptr<PrimitiveSet<HybridDecrypt>> hybrid_decrypt_set_;
+  const internal::OutputPrefixIndex<HybridDecrypt> prefix_index_;
   std::unique_ptr<MonitoringClient> monitoring_decryption_client_;
 };
 
@@ -66,36 +69,28 @@ util::StatusOr<std::string> HybridDecryptSetWrapper::Decrypt(
   context_info = internal::EnsureStringNonNull(context_info);
 
   if (ciphertext.length() > CryptoFormat::kNonRawPrefixSize) {
-    absl::string_view key_id =
-        ciphertext.substr(0, CryptoFormat::kNonRawPrefixSize);
-    auto primitives_result = hybrid_decrypt_set_->get_primitives(key_id);
-    if (primitives_result.ok()) {
-      absl::string_view raw_ciphertext =
-          ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
-      for (auto& hybrid_decrypt_entry : *(primitives_result.value())) {
-        HybridDecrypt& hybrid_decrypt = hybrid_decrypt_entry->get_primitive();
-        auto decrypt_result =
-            hybrid_decrypt.Decrypt(raw_ciphertext, context_info);
-        if (decrypt_result.ok()) {
-          if (monitoring_decryption_client_ != nullptr) {
-            monitoring_decryption_client_->Log(
-                hybrid_decrypt_entry->get_key_id(), ciphertext.size());
-          }
-          return std::move(decrypt_result.value());
+    absl::string_view raw_ciphertext =
+        ciphertext.substr(CryptoFormat::kNonRawPrefixSize);
+    for (const auto* hybrid_decrypt_entry : prefix_index_.Find(ciphertext)) {
+      HybridDecrypt& hybrid_decrypt = hybrid_decrypt_entry->get_primitive();
+      auto decrypt_result =
+          hybrid_decrypt.Decrypt(raw_ciphertext, context_info);
+      if (decrypt_result.ok()) {
+        if (monitoring_decryption_client_ != nullptr) {
+          monitoring_decryption_client_->Log(
+              hybrid_decrypt_entry->get_key_id(), ciphertext.size());
         }
+        return std::move(decrypt_result.value());
       }
     }
   }
 
   // No matching key succeeded with decryption, try all RAW keys.
-  auto raw_primitives_result = hybrid_decrypt_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (auto& hybrid_decrypt_entry : *(raw_primitives_result.value())) {
-      HybridDecrypt& hybrid_decrypt = hybrid_decrypt_entry->get_primitive();
-      auto decrypt_result = hybrid_decrypt.Decrypt(ciphertext, context_info);
-      if (decrypt_result.ok()) {
-        return std::move(decrypt_result.value());
-      }
+  for (const auto* hybrid_decrypt_entry : prefix_index_.raw_entries()) {
+    HybridDecrypt& hybrid_decrypt = hybrid_decrypt_entry->get_primitive();
+    auto decrypt_result = hybrid_decrypt.Decrypt(ciphertext, context_info);
+    if (decrypt_result.ok()) {
+      return std::move(decrypt_result.value());
     }
   }
   if (monitoring_decryption_client_ != nullptr) {
@@ -15,10 +15,12 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "tink/internal/aes_util.h"
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <string>
-#include <vector>
 
+#include "absl/functional/function_ref.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
@@ -55,7 +57,7 @@ util::Status AesCtr128Crypt(absl::string_view data, uint8_t iv[AesBlockSize()],
   }
 
   unsigned int num = 0;
-  std::vector<uint8_t> ecount_buf(AesBlockSize(), 0);
+  std::array<uint8_t, AesBlockSize()> ecount_buf = {};
   // OpenSSL >= v1.1.0 public APIs no longer exposes an AES_ctr128_encrypt
   // function; as an alternative we use CRYPTO_ctr128_encrypt when OpenSSL is
   // used as a backend. The latter is not part of the public API of BoringSSL,
@@ -73,6 +75,50 @@ util::Status AesCtr128Crypt(absl::string_view data, uint8_t iv[AesBlockSize()],
   return util::OkStatus();
 }
 
+util::Status AesCtrCryptInterleaved(
+    EVP_CIPHER_CTX* context, absl::string_view data, absl::Span<char> out,
+    absl::FunctionRef<util::Status(absl::string_view)> visit_ciphertext) {
+  if (out.size() < data.size()) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Invalid size for output buffer; expected at least ",
+                     data.size(), " got ", out.size()));
+  }
+  if (BuffersPartiallyOverlap(data,
+                              absl::string_view(out.data(), out.size()))) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "Buffers must not partially overlap");
+  }
+
+  const bool is_encrypting = EVP_CIPHER_CTX_encrypting(context) == 1;
+  for (size_t position = 0; position < data.size();
+       position += AesCtrInterleavedChunkSize()) {
+    absl::string_view chunk =
+        data.substr(position, AesCtrInterleavedChunkSize());
+    uint8_t* chunk_out = reinterpret_cast<uint8_t*>(out.data() + position);
+    int written_bytes = 0;
+    if (EVP_CipherUpdate(context, chunk_out, &written_bytes,
+                         reinterpret_cast<const uint8_t*>(chunk.data()),
+                         chunk.size()) != 1) {
+      return util::Status(
+          absl::StatusCode::kInternal,
+          absl::StrCat(is_encrypting ? "Encryption" : "Decryption", " failed"));
+    }
+    if (written_bytes != static_cast<int>(chunk.size())) {
+      return util::Status(absl::StatusCode::kInternal,
+                          "Incorrect output size");
+    }
+    if (is_encrypting) {
+      util::Status status = visit_ciphertext(absl::string_view(
+          reinterpret_cast<const char*>(chunk_out), chunk.size()));
+      if (!status.ok()) {
+        return status;
+      }
+    }
+  }
+  return util::OkStatus();
+}
+
 util::StatusOr<const EVP_CIPHER*> GetAesCtrCipherForKeySize(
     uint32_t key_size_in_bytes) {
   switch (key_size_in_bytes) {
@@ -19,9 +19,11 @@
 #include <cstdint>
 #include <memory>
 
+#include "absl/functional/function_ref.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "openssl/aes.h"
+#include "openssl/evp.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -43,6 +45,27 @@ crypto::tink::util::Status AesCtr128Crypt(absl::string_view data,
                                           const AES_KEY* key,
                                           absl::Span<char> out);
 
+// Size of the pieces processed by AesCtrCryptInterleaved(). Small enough for
+// the input and the output of a piece to stay in the L1 data cache.
+constexpr int AesCtrInterleavedChunkSize() { return 4096; }
+
+// Encrypts or decrypts (same operation in CTR mode) `data` into `out` with
+// `context`, an AES-CTR EVP_CIPHER_CTX with key and IV already set, one piece
+// of AesCtrInterleavedChunkSize() bytes at a time. When encrypting,
+// `visit_ciphertext` is called with each piece of ciphertext after it is
+// written to `out`. This lets callers MAC the ciphertext in the same pass over
+// the data, while it is still in cache. Processing stops at the first error
+// returned by `visit_ciphertext`. When decrypting, `visit_ciphertext` is not
+// called: the ciphertext must be authenticated as a whole before any of it is
+// decrypted.
+//
+// `out` may fully overlap with `data`; partial overlaps result in a
+// kInvalidArgument error.
+crypto::tink::util::Status AesCtrCryptInterleaved(
+    EVP_CIPHER_CTX* context, absl::string_view data, absl::Span<char> out,
+    absl::FunctionRef<crypto::tink::util::Status(absl::string_view)>
+        visit_ciphertext);
+
 // Returns a pointer to an AES-CTR EVP_CIPHER for the given key size
 // `key_size_in_bytes`.
 util::StatusOr<const EVP_CIPHER*> GetAesCtrCipherForKeySize(
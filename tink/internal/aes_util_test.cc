@@ -23,10 +23,12 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "openssl/aes.h"
 #include "openssl/evp.h"
+#include "tink/internal/ssl_unique_ptr.h"
 #include "tink/subtle/subtle_util.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/status.h"
@@ -152,6 +154,88 @@ TEST_F(AesCtrTest, AesCtrDecryptInPlace) {
   EXPECT_EQ(inout, test_vector_.plaintext);
 }
 
+// Returns an AES-128-CTR context keyed with `key` and `iv`.
+SslUniquePtr<EVP_CIPHER_CTX> NewAesCtrContext(absl::string_view key,
+                                              absl::string_view iv,
+                                              bool encryption) {
+  SslUniquePtr<EVP_CIPHER_CTX> context(EVP_CIPHER_CTX_new());
+  EXPECT_EQ(EVP_CipherInit_ex(context.get(), EVP_aes_128_ctr(),
+                              /*impl=*/nullptr,
+                              reinterpret_cast<const uint8_t*>(key.data()),
+                              reinterpret_cast<const uint8_t*>(iv.data()),
+                              encryption ? 1 : 0),
+            1);
+  return context;
+}
+
+TEST_F(AesCtrTest, AesCtrCryptInterleavedVisitsCiphertext) {
+  // Spans several chunks and ends in a partial one.
+  std::string plaintext(3 * AesCtrInterleavedChunkSize() + 100, '\0');
+  for (size_t i = 0; i < plaintext.size(); i++) {
+    plaintext[i] = static_cast<char>(i * 31);
+  }
+  std::string expected_ciphertext(plaintext.size(), '\0');
+  std::string iv = test_vector_.iv;
+  ASSERT_THAT(AesCtr128Crypt(plaintext, reinterpret_cast<uint8_t*>(&iv[0]),
+                             aes_key_.get(),
+                             absl::MakeSpan(expected_ciphertext)),
+              IsOk());
+
+  SslUniquePtr<EVP_CIPHER_CTX> context = NewAesCtrContext(
+      test_vector_.key, test_vector_.iv, /*encryption=*/true);
+  std::string ciphertext(plaintext.size(), '\0');
+  std::string visited;
+  ASSERT_THAT(AesCtrCryptInterleaved(context.get(), plaintext,
+                                     absl::MakeSpan(ciphertext),
+                                     [&](absl::string_view piece) {
+                                       absl::StrAppend(&visited, piece);
+                                       return util::OkStatus();
+                                     }),
+              IsOk());
+  EXPECT_EQ(ciphertext, expected_ciphertext);
+  EXPECT_EQ(visited, expected_ciphertext);
+
+  // Decrypt in place. The ciphertext is not visited when decrypting.
+  context = NewAesCtrContext(test_vector_.key, test_vector_.iv,
+                             /*encryption=*/false);
+  visited.clear();
+  ASSERT_THAT(AesCtrCryptInterleaved(context.get(), ciphertext,
+                                     absl::MakeSpan(ciphertext),
+                                     [&](absl::string_view piece) {
+                                       absl::StrAppend(&visited, piece);
+                                       return util::OkStatus();
+                                     }),
+              IsOk());
+  EXPECT_EQ(ciphertext, plaintext);
+  EXPECT_EQ(visited, "");
+}
+
+TEST_F(AesCtrTest, AesCtrCryptInterleavedStopsOnVisitorError) {
+  std::string plaintext(2 * AesCtrInterleavedChunkSize(), 'a');
+  std::string ciphertext(plaintext.size(), '\0');
+  SslUniquePtr<EVP_CIPHER_CTX> context = NewAesCtrContext(
+      test_vector_.key, test_vector_.iv, /*encryption=*/true);
+  int visits = 0;
+  EXPECT_THAT(AesCtrCryptInterleaved(
+                  context.get(), plaintext, absl::MakeSpan(ciphertext),
+                  [&](absl::string_view piece) {
+                    ++visits;
+                    return util::Status(absl::StatusCode::kInternal, "stop");
+                  }),
+              StatusIs(absl::StatusCode::kInternal));
+  EXPECT_EQ(visits, 1);
+}
+
+TEST_F(AesCtrTest, AesCtrCryptInterleavedInvalidOutSize) {
+  SslUniquePtr<EVP_CIPHER_CTX> context = NewAesCtrContext(
+      test_vector_.key, test_vector_.iv, /*encryption=*/true);
+  std::string out(test_vector_.plaintext.size() - 1, '\0');
+  EXPECT_THAT(AesCtrCryptInterleaved(
+                  context.get(), test_vector_.plaintext, absl::MakeSpan(out),
+                  [](absl::string_view) { return util::OkStatus(); }),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(AesUtilTest, GetAesCtrCipherForKeySize) {
   for (int i = 0; i < 64; i++) {
     util::StatusOr<const EVP_CIPHER*> cipher = GetAesCtrCipherForKeySize(i);
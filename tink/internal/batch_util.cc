@@ -0,0 +1,73 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/batch_util.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+util::Status ValidateBatchAssociatedData(
+    int64_t batch_size, absl::Span<const absl::string_view> associated_data) {
+  if (associated_data.size() <= 1 || associated_data.size() == batch_size) {
+    return util::OkStatus();
+  }
+  return util::Status(
+      absl::StatusCode::kInvalidArgument,
+      absl::StrCat("Expected 0, 1 or ", batch_size,
+                   " associated data values for the batch, got ",
+                   associated_data.size()));
+}
+
+absl::string_view BatchAssociatedData(
+    absl::Span<const absl::string_view> associated_data, int64_t index) {
+  switch (associated_data.size()) {
+    case 0:
+      return "";
+    case 1:
+      return associated_data[0];
+    default:
+      return associated_data[index];
+  }
+}
+
+absl::string_view BatchOutput(absl::string_view outputs,
+                              const std::vector<int64_t>& offsets,
+                              int64_t index) {
+  return outputs.substr(offsets[index], offsets[index + 1] - offsets[index]);
+}
+
+void ClearFailedBatchOutputs(std::string* outputs,
+                             std::vector<int64_t>* offsets) {
+  util::SafeZeroString(outputs);
+  outputs->clear();
+  offsets->clear();
+}
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
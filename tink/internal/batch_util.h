@@ -0,0 +1,59 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_INTERNAL_BATCH_UTIL_H_
+#define TINK_INTERNAL_BATCH_UTIL_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// Checks that `associated_data` is valid for a batch of `batch_size` inputs.
+// It must either be empty (no associated data), hold a single value shared by
+// all inputs, or hold exactly one value per input.
+util::Status ValidateBatchAssociatedData(
+    int64_t batch_size, absl::Span<const absl::string_view> associated_data);
+
+// Returns the associated data of the `index`-th input of a batch, given
+// `associated_data` accepted by ValidateBatchAssociatedData.
+absl::string_view BatchAssociatedData(
+    absl::Span<const absl::string_view> associated_data, int64_t index);
+
+// Returns the `index`-th output of a batch stored back to back in `outputs`,
+// where `offsets` holds one more entry than there are outputs.
+absl::string_view BatchOutput(absl::string_view outputs,
+                              const std::vector<int64_t>& offsets,
+                              int64_t index);
+
+// Wipes the memory of `outputs` and clears both `outputs` and `offsets`.
+// Called when decrypting a batch fails, so that the plaintexts of the
+// messages that were decrypted before the failure are not left behind.
+void ClearFailedBatchOutputs(std::string* outputs,
+                             std::vector<int64_t>* offsets);
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_INTERNAL_BATCH_UTIL_H_
@@ -0,0 +1,60 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/batch_util.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+
+TEST(BatchUtilTest, ValidateBatchAssociatedData) {
+  std::vector<absl::string_view> associated_data = {"a", "b", "c"};
+  EXPECT_THAT(ValidateBatchAssociatedData(3, {}), IsOk());
+  EXPECT_THAT(ValidateBatchAssociatedData(
+                  3, absl::MakeConstSpan(associated_data).subspan(0, 1)),
+              IsOk());
+  EXPECT_THAT(ValidateBatchAssociatedData(3, associated_data), IsOk());
+  EXPECT_THAT(ValidateBatchAssociatedData(2, associated_data),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(BatchUtilTest, BatchAssociatedData) {
+  std::vector<absl::string_view> associated_data = {"a", "b", "c"};
+  EXPECT_EQ(BatchAssociatedData({}, 2), "");
+  EXPECT_EQ(BatchAssociatedData(
+                absl::MakeConstSpan(associated_data).subspan(0, 1), 2),
+            "a");
+  EXPECT_EQ(BatchAssociatedData(associated_data, 2), "c");
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,109 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/hkdf_util.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/crypto.h"
+#include "openssl/evp.h"
+#include "openssl/hmac.h"
+#include "tink/internal/util.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+// RFC 5869 limits the output of HKDF-Expand to 255 hash outputs.
+constexpr size_t kMaxNumBlocks = 255;
+
+bool HmacUpdate(HMAC_CTX* context, absl::string_view data) {
+  // BoringSSL expects a non-null pointer for data,
+  // regardless of whether the size is 0.
+  data = EnsureStringNonNull(data);
+  return HMAC_Update(context, reinterpret_cast<const uint8_t*>(data.data()),
+                     data.size());
+}
+
+}  // namespace
+
+// PRK = HMAC-Hash(salt, IKM) as in RFC 5869, Section 2.2.
+util::Status HkdfExtract(const EVP_MD* md,
+                         absl::Span<const absl::string_view> ikm_parts,
+                         absl::string_view salt, HMAC_CTX* context) {
+  // A null key would make HMAC_Init_ex reuse the previous key, so an empty
+  // salt must be passed as a non-null pointer. HMAC pads the key with zeros,
+  // which gives the all-zero salt that RFC 5869 prescribes for this case.
+  salt = EnsureStringNonNull(salt);
+  bool ok = HMAC_Init_ex(context, salt.data(), salt.size(), md,
+                         /*impl=*/nullptr);
+  for (int i = 0; ok && i < ikm_parts.size(); ++i) {
+    ok = HmacUpdate(context, ikm_parts[i]);
+  }
+  uint8_t prk[EVP_MAX_MD_SIZE];
+  unsigned int prk_len;
+  ok = ok && HMAC_Final(context, prk, &prk_len) &&
+       HMAC_Init_ex(context, prk, prk_len, md, /*impl=*/nullptr);
+  OPENSSL_cleanse(prk, sizeof(prk));
+  if (!ok) {
+    return util::Status(absl::StatusCode::kInternal, "HKDF-Extract failed");
+  }
+  return util::OkStatus();
+}
+
+// T(i) = HMAC-Hash(PRK, T(i-1) | info | i) as in RFC 5869, Section 2.3. The
+// output is T(1) | T(2) | ... truncated to out.size() bytes.
+util::Status HkdfExpand(HMAC_CTX* context, absl::string_view info,
+                        absl::Span<uint8_t> out) {
+  const size_t digest_size = HMAC_size(context);
+  if (digest_size == 0 || out.size() > kMaxNumBlocks * digest_size) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "Invalid HKDF output length");
+  }
+  uint8_t block[EVP_MAX_MD_SIZE];
+  size_t written = 0;
+  for (uint8_t i = 1; written < out.size(); ++i) {
+    // Without a key and hash function, HMAC_Init_ex restores the state after
+    // keying with PRK.
+    bool ok = HMAC_Init_ex(context, /*key=*/nullptr, /*key_len=*/0,
+                           /*md=*/nullptr, /*impl=*/nullptr);
+    if (ok && i > 1) {
+      ok = HMAC_Update(context, block, digest_size);
+    }
+    ok = ok && HmacUpdate(context, info) && HMAC_Update(context, &i, 1) &&
+         HMAC_Final(context, block, /*len=*/nullptr);
+    if (!ok) {
+      OPENSSL_cleanse(block, sizeof(block));
+      return util::Status(absl::StatusCode::kInternal, "HKDF-Expand failed");
+    }
+    size_t block_size = std::min(digest_size, out.size() - written);
+    std::copy_n(block, block_size, out.data() + written);
+    written += block_size;
+  }
+  OPENSSL_cleanse(block, sizeof(block));
+  return util::OkStatus();
+}
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
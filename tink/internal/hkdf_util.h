@@ -0,0 +1,54 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_INTERNAL_HKDF_UTIL_H_
+#define TINK_INTERNAL_HKDF_UTIL_H_
+
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/evp.h"
+#include "openssl/hmac.h"
+#include "tink/util/status.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// HKDF (RFC 5869) on top of a caller-owned HMAC context. Both steps work the
+// same with BoringSSL and OpenSSL and allocate nothing themselves. Callers
+// which derive many keys can reuse a single context, and callers with a fixed
+// key and salt can run HKDF-Extract only once.
+
+// Runs HKDF-Extract with `salt` on the concatenation of `ikm_parts`, and keys
+// `context` with the resulting pseudorandom key for hash function `md`.
+util::Status HkdfExtract(const EVP_MD* md,
+                         absl::Span<const absl::string_view> ikm_parts,
+                         absl::string_view salt, HMAC_CTX* context);
+
+// Runs HKDF-Expand with `info` and writes `out.size()` bytes to `out`.
+// `context` must have been keyed by HkdfExtract, and stays keyed with the same
+// pseudorandom key, so it can be used for further calls. Fails if `out` is
+// longer than 255 hash outputs.
+util::Status HkdfExpand(HMAC_CTX* context, absl::string_view info,
+                        absl::Span<uint8_t> out);
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_INTERNAL_HKDF_UTIL_H_
@@ -0,0 +1,137 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/hkdf_util.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/evp.h"
+#include "openssl/hmac.h"
+#include "tink/internal/ssl_unique_ptr.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+
+// Test case 1 of RFC 5869.
+constexpr absl::string_view kIkmHex =
+    "0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b";
+constexpr absl::string_view kSaltHex = "000102030405060708090a0b0c";
+constexpr absl::string_view kInfoHex = "f0f1f2f3f4f5f6f7f8f9";
+constexpr absl::string_view kOkmHex =
+    "3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf34007208"
+    "d5b887185865";
+
+// Test case 3 of RFC 5869, which uses an empty salt and info.
+constexpr absl::string_view kEmptySaltOkmHex =
+    "8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d9d201395"
+    "faa4b61a96c8";
+
+std::string Expand(HMAC_CTX* context, absl::string_view info, size_t size) {
+  std::string out(size, '\0');
+  EXPECT_THAT(HkdfExpand(context, info,
+                         absl::MakeSpan(reinterpret_cast<uint8_t*>(&out[0]),
+                                        out.size())),
+              IsOk());
+  return out;
+}
+
+TEST(HkdfUtilTest, Rfc5869TestVector) {
+  SslUniquePtr<HMAC_CTX> context(HMAC_CTX_new());
+  std::string ikm = absl::HexStringToBytes(kIkmHex);
+  std::vector<absl::string_view> ikm_parts = {ikm};
+  ASSERT_THAT(HkdfExtract(EVP_sha256(), ikm_parts,
+                          absl::HexStringToBytes(kSaltHex), context.get()),
+              IsOk());
+  EXPECT_EQ(absl::BytesToHexString(Expand(
+                context.get(), absl::HexStringToBytes(kInfoHex), 42)),
+            kOkmHex);
+}
+
+TEST(HkdfUtilTest, EmptySalt) {
+  SslUniquePtr<HMAC_CTX> context(HMAC_CTX_new());
+  std::string ikm = absl::HexStringToBytes(kIkmHex);
+  std::vector<absl::string_view> ikm_parts = {ikm};
+  ASSERT_THAT(HkdfExtract(EVP_sha256(), ikm_parts, /*salt=*/"", context.get()),
+              IsOk());
+  EXPECT_EQ(absl::BytesToHexString(Expand(context.get(), /*info=*/"", 42)),
+            kEmptySaltOkmHex);
+}
+
+TEST(HkdfUtilTest, SplitIkmMatchesConcatenatedIkm) {
+  std::string ikm = absl::HexStringToBytes(kIkmHex);
+  std::string salt = absl::HexStringToBytes(kSaltHex);
+  std::string info = absl::HexStringToBytes(kInfoHex);
+  for (int split = 0; split <= ikm.size(); ++split) {
+    SCOPED_TRACE(split);
+    absl::string_view ikm_view = ikm;
+    std::vector<absl::string_view> ikm_parts = {ikm_view.substr(0, split),
+                                                ikm_view.substr(split)};
+    SslUniquePtr<HMAC_CTX> context(HMAC_CTX_new());
+    ASSERT_THAT(HkdfExtract(EVP_sha256(), ikm_parts, salt, context.get()),
+                IsOk());
+    EXPECT_EQ(absl::BytesToHexString(Expand(context.get(), info, 42)),
+              kOkmHex);
+  }
+}
+
+TEST(HkdfUtilTest, ExpandCanBeRepeated) {
+  SslUniquePtr<HMAC_CTX> context(HMAC_CTX_new());
+  std::string ikm = absl::HexStringToBytes(kIkmHex);
+  std::vector<absl::string_view> ikm_parts = {ikm};
+  ASSERT_THAT(HkdfExtract(EVP_sha256(), ikm_parts,
+                          absl::HexStringToBytes(kSaltHex), context.get()),
+              IsOk());
+  std::string info = absl::HexStringToBytes(kInfoHex);
+  std::string other = Expand(context.get(), "other info", 42);
+  EXPECT_EQ(absl::BytesToHexString(Expand(context.get(), info, 42)), kOkmHex);
+  EXPECT_EQ(Expand(context.get(), "other info", 42), other);
+  // Shorter outputs are prefixes of longer ones.
+  EXPECT_EQ(absl::BytesToHexString(Expand(context.get(), info, 7)),
+            kOkmHex.substr(0, 14));
+  EXPECT_EQ(Expand(context.get(), info, 0), "");
+}
+
+TEST(HkdfUtilTest, OutputTooLong) {
+  SslUniquePtr<HMAC_CTX> context(HMAC_CTX_new());
+  std::vector<absl::string_view> ikm_parts = {"ikm"};
+  ASSERT_THAT(HkdfExtract(EVP_sha256(), ikm_parts, "salt", context.get()),
+              IsOk());
+  std::string out(255 * 32 + 1, '\0');
+  absl::Span<uint8_t> out_span =
+      absl::MakeSpan(reinterpret_cast<uint8_t*>(&out[0]), out.size());
+  EXPECT_THAT(HkdfExpand(context.get(), "info", out_span),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(HkdfExpand(context.get(), "info", out_span.subspan(1)), IsOk());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
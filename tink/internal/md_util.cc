@@ -22,8 +22,10 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
 #include "tink/internal/err_util.h"
+#include "tink/internal/ssl_unique_ptr.h"
 #include "tink/internal/util.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/subtle_util.h"
@@ -88,6 +90,47 @@ util::StatusOr<std::string> ComputeHash(absl::string_view input,
   return digest;
 }
 
+util::StatusOr<std::string> ComputeHashFromParts(
+    absl::Span<const absl::string_view> input_parts, const EVP_MD &hasher) {
+  if (input_parts.size() == 1) {
+    return ComputeHash(input_parts[0], hasher);
+  }
+  std::string digest;
+  subtle::ResizeStringUninitialized(&digest, EVP_MAX_MD_SIZE);
+  util::StatusOr<uint32_t> digest_length = ComputeHashFromPartsInto(
+      input_parts, hasher,
+      absl::MakeSpan(reinterpret_cast<uint8_t *>(&digest[0]), digest.size()));
+  if (!digest_length.ok()) {
+    return digest_length.status();
+  }
+  digest.resize(*digest_length);
+  return digest;
+}
+
+util::StatusOr<uint32_t> ComputeHashFromPartsInto(
+    absl::Span<const absl::string_view> input_parts, const EVP_MD &hasher,
+    absl::Span<uint8_t> digest) {
+  if (digest.size() < EVP_MAX_MD_SIZE) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "Digest buffer too small");
+  }
+  SslUniquePtr<EVP_MD_CTX> context(EVP_MD_CTX_new());
+  bool ok = context != nullptr &&
+            EVP_DigestInit_ex(context.get(), &hasher, /*impl=*/nullptr) == 1;
+  for (size_t i = 0; ok && i < input_parts.size(); ++i) {
+    absl::string_view input = EnsureStringNonNull(input_parts[i]);
+    ok = EVP_DigestUpdate(context.get(), input.data(), input.length()) == 1;
+  }
+  uint32_t digest_length = 0;
+  if (!ok ||
+      EVP_DigestFinal_ex(context.get(), digest.data(), &digest_length) != 1) {
+    return util::Status(absl::StatusCode::kInternal,
+                        absl::StrCat("Openssl internal error computing hash: ",
+                                     internal::GetSslErrors()));
+  }
+  return digest_length;
+}
+
 }  // namespace internal
 }  // namespace tink
 }  // namespace crypto
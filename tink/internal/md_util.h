@@ -16,10 +16,12 @@
 #ifndef TINK_INTERNAL_MD_UTIL_H_
 #define TINK_INTERNAL_MD_UTIL_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/util/status.h"
@@ -42,6 +44,17 @@ crypto::tink::util::Status IsHashTypeSafeForSignature(
 crypto::tink::util::StatusOr<std::string> ComputeHash(absl::string_view input,
                                                       const EVP_MD &hasher);
 
+// Returns the hash of the concatenation of `input_parts` using the hash
+// function `hasher`, without concatenating the parts.
+crypto::tink::util::StatusOr<std::string> ComputeHashFromParts(
+    absl::Span<const absl::string_view> input_parts, const EVP_MD &hasher);
+
+// Same as ComputeHashFromParts(), but writes the hash to `digest`, which must
+// hold at least EVP_MAX_MD_SIZE bytes. Returns the length of the hash.
+crypto::tink::util::StatusOr<uint32_t> ComputeHashFromPartsInto(
+    absl::Span<const absl::string_view> input_parts, const EVP_MD &hasher,
+    absl::Span<uint8_t> digest);
+
 }  // namespace internal
 }  // namespace tink
 }  // namespace crypto
@@ -15,13 +15,16 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "tink/internal/md_util.h"
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/status/status.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/util/status.h"
@@ -36,6 +39,7 @@ namespace {
 using ::crypto::tink::subtle::HashType;
 using ::crypto::tink::test::IsOk;
 using ::crypto::tink::test::IsOkAndHolds;
+using ::crypto::tink::test::StatusIs;
 using ::testing::Not;
 using ::testing::TestWithParam;
 using ::testing::ValuesIn;
@@ -128,6 +132,46 @@ TEST_P(MdUtilComputeHashSamplesTest, ComputesHash) {
   EXPECT_THAT(ComputeHash(data, **hasher), IsOkAndHolds(expected_digest));
 }
 
+TEST_P(MdUtilComputeHashSamplesTest, ComputesHashFromParts) {
+  const MdUtilComputeHashSamplesTestParam& params = GetParam();
+  util::StatusOr<const EVP_MD*> hasher = EvpHashFromHashType(params.hash_type);
+  ASSERT_THAT(hasher, IsOk());
+  std::string data = absl::HexStringToBytes(params.data_hex);
+  std::string expected_digest =
+      absl::HexStringToBytes(params.expected_digest_hex);
+  for (int split = 0; split <= data.size(); ++split) {
+    absl::string_view data_view = data;
+    std::vector<absl::string_view> parts = {data_view.substr(0, split),
+                                            absl::string_view(),
+                                            data_view.substr(split)};
+    EXPECT_THAT(ComputeHashFromParts(parts, **hasher),
+                IsOkAndHolds(expected_digest));
+  }
+  EXPECT_THAT(ComputeHashFromParts({data}, **hasher),
+              IsOkAndHolds(expected_digest));
+}
+
+TEST_P(MdUtilComputeHashSamplesTest, ComputesHashFromPartsInto) {
+  const MdUtilComputeHashSamplesTestParam& params = GetParam();
+  util::StatusOr<const EVP_MD*> hasher = EvpHashFromHashType(params.hash_type);
+  ASSERT_THAT(hasher, IsOk());
+  std::string data = absl::HexStringToBytes(params.data_hex);
+  std::string expected_digest =
+      absl::HexStringToBytes(params.expected_digest_hex);
+
+  uint8_t digest[EVP_MAX_MD_SIZE];
+  util::StatusOr<uint32_t> digest_length = ComputeHashFromPartsInto(
+      {absl::string_view(data).substr(0, 1), absl::string_view(data).substr(1)},
+      **hasher, absl::MakeSpan(digest));
+  ASSERT_THAT(digest_length, IsOk());
+  EXPECT_EQ(std::string(reinterpret_cast<const char*>(digest), *digest_length),
+            expected_digest);
+  EXPECT_THAT(
+      ComputeHashFromPartsInto({data}, **hasher, absl::MakeSpan(digest, 16))
+          .status(),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 INSTANTIATE_TEST_SUITE_P(MdUtilComputeHashSamplesTests,
                          MdUtilComputeHashSamplesTest,
                          ValuesIn(GetMdUtilComputeHashSamplesTestParams()));
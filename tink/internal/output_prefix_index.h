@@ -0,0 +1,116 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_INTERNAL_OUTPUT_PREFIX_INDEX_H_
+#define TINK_INTERNAL_OUTPUT_PREFIX_INDEX_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/crypto_format.h"
+#include "tink/primitive_set.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// Immutable snapshot of the entries of a PrimitiveSet, indexed by output
+// prefix. It is built once when a keyset is wrapped; since the wrapper owns
+// the PrimitiveSet from then on, the snapshot stays valid for the lifetime of
+// the wrapper and reads need no lock, even if the set was assembled with the
+// deprecated mutable API.
+//
+// Non-RAW entries are stored contiguously, grouped by output prefix and in
+// keyset order within a group. Prefixes are keyed by their start byte and
+// 32-bit key ID, so lookups do not allocate. The index does not own the
+// entries, so it must not outlive the PrimitiveSet it was built from.
+template <class P>
+class OutputPrefixIndex {
+ public:
+  using Entry = typename PrimitiveSet<P>::template Entry<P>;
+
+  explicit OutputPrefixIndex(const PrimitiveSet<P>& primitive_set) {
+    std::vector<Entry*> entries = primitive_set.get_all_in_keyset_order();
+    // Count the entries per prefix, then lay the groups out back to back and
+    // fill them, advancing each range's end as entries are placed.
+    for (Entry* entry : entries) {
+      const std::string& identifier = entry->get_identifier();
+      if (identifier.size() == CryptoFormat::kNonRawPrefixSize) {
+        ranges_[Key(identifier)].second++;
+      } else {
+        raw_entries_.push_back(entry);
+      }
+    }
+    uint32_t offset = 0;
+    for (auto& key_and_range : ranges_) {
+      std::pair<uint32_t, uint32_t>& range = key_and_range.second;
+      range.first = offset;
+      offset += range.second;
+      range.second = range.first;
+    }
+    entries_.resize(offset);
+    for (Entry* entry : entries) {
+      const std::string& identifier = entry->get_identifier();
+      if (identifier.size() == CryptoFormat::kNonRawPrefixSize) {
+        entries_[ranges_[Key(identifier)].second++] = entry;
+      }
+    }
+  }
+
+  // Returns the non-RAW entries whose output prefix starts `ciphertext`, or an
+  // empty span if there are none.
+  absl::Span<Entry* const> Find(absl::string_view ciphertext) const {
+    if (ciphertext.size() < CryptoFormat::kNonRawPrefixSize) {
+      return {};
+    }
+    auto it = ranges_.find(Key(ciphertext));
+    if (it == ranges_.end()) {
+      return {};
+    }
+    return absl::MakeConstSpan(entries_).subspan(
+        it->second.first, it->second.second - it->second.first);
+  }
+
+  // Returns the RAW entries, in keyset order.
+  absl::Span<Entry* const> raw_entries() const { return raw_entries_; }
+
+ private:
+  // Packs the start byte and the big-endian key ID of the output prefix at the
+  // beginning of `data` into an integer.
+  static uint64_t Key(absl::string_view data) {
+    uint64_t key = 0;
+    for (int i = 0; i < CryptoFormat::kNonRawPrefixSize; ++i) {
+      key = (key << 8) | static_cast<uint8_t>(data[i]);
+    }
+    return key;
+  }
+
+  // Maps each output prefix to its [begin, end) range in `entries_`.
+  absl::flat_hash_map<uint64_t, std::pair<uint32_t, uint32_t>> ranges_;
+  std::vector<Entry*> entries_;
+  std::vector<Entry*> raw_entries_;
+};
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_INTERNAL_OUTPUT_PREFIX_INDEX_H_
@@ -0,0 +1,96 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/output_prefix_index.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "tink/aead.h"
+#include "tink/primitive_set.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+#include "proto/tink.pb.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::crypto::tink::test::DummyAead;
+using ::crypto::tink::test::IsOk;
+using ::google::crypto::tink::KeysetInfo;
+using ::google::crypto::tink::KeyStatusType;
+using ::google::crypto::tink::OutputPrefixType;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+using AeadEntry = PrimitiveSet<Aead>::Entry<Aead>;
+
+AeadEntry* AddKey(PrimitiveSet<Aead>& aead_set, uint32_t key_id,
+                  OutputPrefixType output_prefix_type) {
+  KeysetInfo::KeyInfo key_info;
+  key_info.set_output_prefix_type(output_prefix_type);
+  key_info.set_key_id(key_id);
+  key_info.set_status(KeyStatusType::ENABLED);
+  util::StatusOr<AeadEntry*> entry = aead_set.AddPrimitive(
+      absl::make_unique<DummyAead>(absl::StrCat(key_id)), key_info);
+  EXPECT_THAT(entry, IsOk());
+  return *entry;
+}
+
+TEST(OutputPrefixIndexTest, FindsEntriesByPrefix) {
+  PrimitiveSet<Aead> aead_set;
+  AeadEntry* tink = AddKey(aead_set, 0x01020304, OutputPrefixType::TINK);
+  AeadEntry* legacy = AddKey(aead_set, 0x01020304, OutputPrefixType::LEGACY);
+  AeadEntry* crunchy = AddKey(aead_set, 0x01020304, OutputPrefixType::CRUNCHY);
+  AeadEntry* other = AddKey(aead_set, 42, OutputPrefixType::TINK);
+  AeadEntry* raw1 = AddKey(aead_set, 43, OutputPrefixType::RAW);
+  AeadEntry* raw2 = AddKey(aead_set, 44, OutputPrefixType::RAW);
+
+  OutputPrefixIndex<Aead> index(aead_set);
+  EXPECT_THAT(index.Find(absl::StrCat(tink->get_identifier(), "ciphertext")),
+              ElementsAre(tink));
+  // LEGACY and CRUNCHY keys share the same output prefix.
+  EXPECT_THAT(index.Find(absl::StrCat(legacy->get_identifier(), "ciphertext")),
+              ElementsAre(legacy, crunchy));
+  EXPECT_THAT(index.Find(other->get_identifier()), ElementsAre(other));
+  EXPECT_THAT(index.raw_entries(), ElementsAre(raw1, raw2));
+}
+
+TEST(OutputPrefixIndexTest, NoMatch) {
+  PrimitiveSet<Aead> aead_set;
+  AeadEntry* tink = AddKey(aead_set, 0x01020304, OutputPrefixType::TINK);
+
+  OutputPrefixIndex<Aead> index(aead_set);
+  EXPECT_THAT(index.Find(""), IsEmpty());
+  EXPECT_THAT(index.Find(tink->get_identifier().substr(0, 4)), IsEmpty());
+  EXPECT_THAT(index.Find(std::string("\x01\x01\x02\x03\x05", 5)), IsEmpty());
+  // Same key ID, but LEGACY start byte.
+  EXPECT_THAT(index.Find(std::string("\x00\x01\x02\x03\x04", 5)), IsEmpty());
+  EXPECT_THAT(index.raw_entries(), IsEmpty());
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
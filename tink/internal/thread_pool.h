@@ -0,0 +1,68 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_INTERNAL_THREAD_POOL_H_
+#define TINK_INTERNAL_THREAD_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+
+// A fixed set of worker threads that run scheduled tasks in FIFO order.
+//
+// Used by the streaming AEAD streams that process several segments
+// concurrently. Tasks must not throw and must not block on other tasks of the
+// same pool.
+class ThreadPool {
+ public:
+  // Starts `num_threads` worker threads; at least one thread is started.
+  explicit ThreadPool(int num_threads);
+
+  // Not copyable or movable.
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Runs all tasks scheduled so far, then joins the worker threads.
+  ~ThreadPool();
+
+  // Schedules `task` to run on one of the worker threads.
+  void Schedule(std::function<void()> task);
+
+  int NumThreads() const { return threads_.size(); }
+
+ private:
+  bool HasWorkOrStopping() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  void WorkerLoop();
+
+  mutable absl::Mutex mutex_;
+  std::deque<std::function<void()>> tasks_ ABSL_GUARDED_BY(mutex_);
+  bool stopping_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_INTERNAL_THREAD_POOL_H_
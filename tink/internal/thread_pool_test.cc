@@ -0,0 +1,85 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/internal/thread_pool.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+
+namespace crypto {
+namespace tink {
+namespace internal {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::Eq;
+
+TEST(ThreadPoolTest, RunsAllTasksBeforeDestruction) {
+  std::atomic<int> counter(0);
+  {
+    ThreadPool pool(4);
+    for (int i = 0; i < 1000; ++i) {
+      pool.Schedule([&counter] { counter.fetch_add(1); });
+    }
+  }
+  EXPECT_THAT(counter.load(), Eq(1000));
+}
+
+TEST(ThreadPoolTest, SingleThreadRunsTasksInOrder) {
+  absl::Mutex mutex;
+  std::vector<int> order;
+  {
+    ThreadPool pool(1);
+    for (int i = 0; i < 5; ++i) {
+      pool.Schedule([&mutex, &order, i] {
+        absl::MutexLock lock(&mutex);
+        order.push_back(i);
+      });
+    }
+  }
+  EXPECT_THAT(order, ElementsAre(0, 1, 2, 3, 4));
+}
+
+TEST(ThreadPoolTest, TasksRunConcurrently) {
+  ThreadPool pool(2);
+  absl::Notification first_started;
+  absl::Notification second_done;
+  // The first task can only finish once the second one ran, which requires a
+  // second worker thread.
+  pool.Schedule([&first_started, &second_done] {
+    first_started.Notify();
+    second_done.WaitForNotification();
+  });
+  first_started.WaitForNotification();
+  pool.Schedule([&second_done] { second_done.Notify(); });
+  second_done.WaitForNotification();
+}
+
+TEST(ThreadPoolTest, AtLeastOneThread) {
+  EXPECT_THAT(ThreadPool(0).NumThreads(), Eq(1));
+  EXPECT_THAT(ThreadPool(-3).NumThreads(), Eq(1));
+  EXPECT_THAT(ThreadPool(3).NumThreads(), Eq(3));
+}
+
+}  // namespace
+}  // namespace internal
+}  // namespace tink
+}  // namespace crypto
@@ -59,6 +59,12 @@ bool BuffersAreIdentical(absl::string_view first, absl::string_view second) {
              std::prev(first.end()), std::prev(second.end()));
 }
 
+bool BuffersPartiallyOverlap(absl::string_view in, absl::string_view out) {
+  return BuffersOverlap(in, out) &&
+         !std::equal_to<absl::string_view::const_iterator>{}(in.begin(),
+                                                             out.begin());
+}
+
 bool IsPrintableAscii(absl::string_view input) {
   for (char c : input) {
     if (!absl::ascii_isprint(c) || absl::ascii_isspace(c)) {
@@ -32,6 +32,11 @@ bool BuffersOverlap(absl::string_view first, absl::string_view second);
 // Returns true if `first` fully overlaps with `second`.
 bool BuffersAreIdentical(absl::string_view first, absl::string_view second);
 
+// Returns true if `in` overlaps with `out` and does not start at the same
+// address as `out`. Ciphers that support in-place operation accept an exact
+// overlap (`in.data() == out.data()`), but no other overlap.
+bool BuffersPartiallyOverlap(absl::string_view in, absl::string_view out);
+
 // Returns true if `input` only contains printable ASCII characters (whitespace
 // is not allowed).
 bool IsPrintableAscii(absl::string_view input);
@@ -100,6 +100,23 @@ TEST(BuffersAreIdenticalTest, PartialOverlapFails) {
   EXPECT_FALSE(BuffersAreIdentical(buffer.substr(10, 5), buffer.substr(0, 10)));
 }
 
+TEST(BuffersPartiallyOverlapTest, SameStartIsAllowed) {
+  std::string buffer = "Some buffer";
+  absl::string_view view(buffer);
+  EXPECT_FALSE(BuffersPartiallyOverlap(view, view));
+  EXPECT_FALSE(BuffersPartiallyOverlap(view.substr(0, 4), view));
+  EXPECT_FALSE(BuffersPartiallyOverlap(view, view.substr(0, 4)));
+  EXPECT_FALSE(BuffersPartiallyOverlap(view.substr(0, 4), view.substr(5)));
+}
+
+TEST(BuffersPartiallyOverlapTest, PartialOverlap) {
+  std::string buffer = "Some buffer";
+  absl::string_view view(buffer);
+  EXPECT_TRUE(BuffersPartiallyOverlap(view.substr(1), view));
+  EXPECT_TRUE(BuffersPartiallyOverlap(view, view.substr(1)));
+  EXPECT_TRUE(BuffersPartiallyOverlap(view.substr(0, 5), view.substr(4, 2)));
+}
+
 TEST(UtilTest, IsPrintableAscii) {
   const std::string input =
       "!\"#$%&'()*+,-./"
@@ -17,9 +17,12 @@
 #ifndef TINK_MAC_H_
 #define TINK_MAC_H_
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -42,6 +45,56 @@ class Mac {
       absl::string_view mac_value,
       absl::string_view data) const = 0;
 
+  // Computes the MAC of the concatenation of 'data_parts'. This allows to
+  // authenticate data which is not contiguous in memory, or to append a
+  // short suffix to it, without copying the data.
+  //
+  // The default implementation concatenates the parts and calls
+  // ComputeMac().
+  virtual crypto::tink::util::StatusOr<std::string> ComputeMacFromParts(
+      absl::Span<const absl::string_view> data_parts) const;
+
+  // Verifies if 'mac_value' is a correct MAC for the concatenation of
+  // 'data_parts'; see ComputeMacFromParts().
+  //
+  // The default implementation concatenates the parts and calls VerifyMac().
+  virtual crypto::tink::util::Status VerifyMacFromParts(
+      absl::string_view mac_value,
+      absl::Span<const absl::string_view> data_parts) const;
+
+  // Computes the MAC of each element of 'data' and writes the MACs back to
+  // back into 'mac_values', replacing its contents. On success, 'offsets'
+  // holds data.size() + 1 entries, and the MAC of data[i] is the range
+  // [offsets[i], offsets[i + 1]) of 'mac_values'.
+  //
+  // Reusing 'mac_values' and 'offsets' across calls avoids reallocations.
+  // The default implementation calls ComputeMacBatchWithPrefix() with an
+  // empty prefix, which is what implementations should override.
+  virtual crypto::tink::util::Status ComputeMacBatch(
+      absl::Span<const absl::string_view> data, std::string* mac_values,
+      std::vector<int64_t>* offsets) const;
+
+  // Like ComputeMacBatch(), but each MAC range of 'mac_values' starts with
+  // 'output_prefix'. This lets keyset wrappers add the key prefix while the
+  // MACs are written, rather than moving them afterwards.
+  //
+  // The default implementation calls ComputeMac() for each element.
+  virtual crypto::tink::util::Status ComputeMacBatchWithPrefix(
+      absl::string_view output_prefix, absl::Span<const absl::string_view> data,
+      std::string* mac_values, std::vector<int64_t>* offsets) const;
+
+  // Verifies each element of 'mac_values' against the element of 'data' at
+  // the same position. On success, 'verified' holds one entry per element,
+  // which is true if and only if the MAC is correct. An incorrect MAC is not
+  // an error: a non-OK status is returned only if 'mac_values' and 'data'
+  // differ in size, or if the batch could not be processed.
+  //
+  // The default implementation calls VerifyMac() for each element.
+  virtual crypto::tink::util::Status VerifyMacBatch(
+      absl::Span<const absl::string_view> mac_values,
+      absl::Span<const absl::string_view> data,
+      std::vector<bool>* verified) const;
+
   virtual ~Mac() = default;
 };
 
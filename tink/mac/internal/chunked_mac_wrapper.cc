@@ -25,6 +25,7 @@
 #include "absl/strings/str_cat.h"
 #include "tink/chunked_mac.h"
 #include "tink/crypto_format.h"
+#include "tink/internal/output_prefix_index.h"
 #include "tink/internal/util.h"
 #include "tink/primitive_set.h"
 #include "tink/util/status.h"
@@ -147,7 +148,7 @@ class ChunkedMacSetWrapper : public ChunkedMac {
  public:
   explicit ChunkedMacSetWrapper(
       std::unique_ptr<PrimitiveSet<ChunkedMac>> mac_set)
-      : mac_set_(std::move(mac_set)) {}
+      : mac_set_(std::move(mac_set)), prefix_index_(*mac_set_) {}
 
   util::StatusOr<std::unique_ptr<ChunkedMacComputation>> CreateComputation()
       const override;
@@ -159,6 +160,7 @@ class ChunkedMacSetWrapper : public ChunkedMac {
 
  private:
   std::unique_ptr<PrimitiveSet<ChunkedMac>> mac_set_;
+  const internal::OutputPrefixIndex<ChunkedMac> prefix_index_;
 };
 
 util::Status Validate(PrimitiveSet<ChunkedMac>* mac_set) {
@@ -195,39 +197,32 @@ ChunkedMacSetWrapper::CreateVerification(absl::string_view tag) const {
   // Create verifications for all non-RAW keys with matching identifiers by
   // removing prefix.
   if (tag.length() > CryptoFormat::kNonRawPrefixSize) {
-    absl::string_view key_id = tag.substr(0, CryptoFormat::kNonRawPrefixSize);
-    auto primitives_result = mac_set_->get_primitives(key_id);
-    if (primitives_result.ok()) {
-      absl::string_view raw_tag = tag.substr(CryptoFormat::kNonRawPrefixSize);
-      for (auto& mac_entry : *(primitives_result.value())) {
-        util::StatusOr<std::unique_ptr<ChunkedMacVerification>> verification =
-            mac_entry->get_primitive().CreateVerification(raw_tag);
-        if (verification.ok()) {
-          auto verification_with_prefix =
-              absl::make_unique<ChunkedMacVerificationWithPrefixType>(
-                  *std::move(verification),
-                  mac_entry->get_output_prefix_type());
-          verifications->push_back(std::move(verification_with_prefix));
-        }
-      }
-    }
-  }
-
-  // Create verifications for all RAW keys by including prefix.
-  auto raw_primitives_result = mac_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (auto& mac_entry : *(raw_primitives_result.value())) {
+    absl::string_view raw_tag = tag.substr(CryptoFormat::kNonRawPrefixSize);
+    for (const auto* mac_entry : prefix_index_.Find(tag)) {
       util::StatusOr<std::unique_ptr<ChunkedMacVerification>> verification =
-          mac_entry->get_primitive().CreateVerification(tag);
+          mac_entry->get_primitive().CreateVerification(raw_tag);
       if (verification.ok()) {
         auto verification_with_prefix =
             absl::make_unique<ChunkedMacVerificationWithPrefixType>(
-                *std::move(verification), mac_entry->get_output_prefix_type());
+                *std::move(verification),
+                mac_entry->get_output_prefix_type());
         verifications->push_back(std::move(verification_with_prefix));
       }
     }
   }
 
+  // Create verifications for all RAW keys by including prefix.
+  for (const auto* mac_entry : prefix_index_.raw_entries()) {
+    util::StatusOr<std::unique_ptr<ChunkedMacVerification>> verification =
+        mac_entry->get_primitive().CreateVerification(tag);
+    if (verification.ok()) {
+      auto verification_with_prefix =
+          absl::make_unique<ChunkedMacVerificationWithPrefixType>(
+              *std::move(verification), mac_entry->get_output_prefix_type());
+      verifications->push_back(std::move(verification_with_prefix));
+    }
+  }
+
   return {absl::make_unique<ChunkedMacVerificationSetWrapper>(
       std::move(verifications))};
 }
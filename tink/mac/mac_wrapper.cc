@@ -16,14 +16,22 @@
 
 #include "tink/mac/mac_wrapper.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/crypto_format.h"
+#include "tink/internal/batch_util.h"
 #include "tink/internal/monitoring_util.h"
+#include "tink/internal/output_prefix_index.h"
 #include "tink/internal/registry_impl.h"
 #include "tink/internal/util.h"
 #include "tink/mac.h"
@@ -44,6 +52,39 @@ constexpr absl::string_view kPrimitive = "mac";
 constexpr absl::string_view kComputeApi = "compute";
 constexpr absl::string_view kVerifyApi = "verify";
 
+// Appended to the data before computing or verifying the MAC of LEGACY keys.
+constexpr absl::string_view kLegacySuffix("\x00", 1);
+
+int64_t TotalSize(absl::Span<const absl::string_view> data_parts) {
+  int64_t size = 0;
+  for (absl::string_view part : data_parts) {
+    size += part.size();
+  }
+  return size;
+}
+
+// ComputeMacBatchWithPrefix() for a LEGACY key. The trailing byte is
+// authenticated as one more part of each element, so that the data is not
+// copied.
+util::Status ComputeLegacyMacBatch(const PrimitiveSet<Mac>::Entry<Mac>& entry,
+                                   absl::Span<const absl::string_view> data,
+                                   std::string* mac_values,
+                                   std::vector<int64_t>* offsets) {
+  mac_values->clear();
+  offsets->assign(1, 0);
+  offsets->reserve(data.size() + 1);
+  for (absl::string_view element : data) {
+    util::StatusOr<std::string> mac_value =
+        entry.get_primitive().ComputeMacFromParts({element, kLegacySuffix});
+    if (!mac_value.ok()) {
+      return mac_value.status();
+    }
+    absl::StrAppend(mac_values, entry.get_identifier(), *mac_value);
+    offsets->push_back(mac_values->size());
+  }
+  return util::OkStatus();
+}
+
 class MacSetWrapper : public Mac {
  public:
   explicit MacSetWrapper(
@@ -51,6 +92,7 @@ class MacSetWrapper : public Mac {
       std::unique_ptr<MonitoringClient> monitoring_compute_client = nullptr,
       std::unique_ptr<MonitoringClient> monitoring_verify_client = nullptr)
       : mac_set_(std::move(mac_set)),
+        prefix_index_(*mac_set_),
         monitoring_compute_client_(std::move(monitoring_compute_client)),
         monitoring_verify_client_(std::move(monitoring_verify_client)) {}
 
@@ -60,10 +102,36 @@ class MacSetWrapper : public Mac {
   crypto::tink::util::Status VerifyMac(absl::string_view mac_value,
                                        absl::string_view data) const override;
 
+  crypto::tink::util::StatusOr<std::string> ComputeMacFromParts(
+      absl::Span<const absl::string_view> data_parts) const override;
+
+  crypto::tink::util::Status VerifyMacFromParts(
+      absl::string_view mac_value,
+      absl::Span<const absl::string_view> data_parts) const override;
+
+  crypto::tink::util::Status ComputeMacBatch(
+      absl::Span<const absl::string_view> data, std::string* mac_values,
+      std::vector<int64_t>* offsets) const override;
+
+  crypto::tink::util::Status VerifyMacBatch(
+      absl::Span<const absl::string_view> mac_values,
+      absl::Span<const absl::string_view> data,
+      std::vector<bool>* verified) const override;
+
   ~MacSetWrapper() override = default;
 
  private:
+  // Verifies `mac_value` with the first matching key in the set, without
+  // logging to monitoring. `skipped_entry`, if non-null, is not tried, since
+  // the caller already did. On success, `key_id` is set to the ID of the key
+  // used.
+  crypto::tink::util::Status VerifyMacWithoutMonitoring(
+      absl::string_view mac_value,
+      absl::Span<const absl::string_view> data_parts, uint32_t* key_id,
+      const PrimitiveSet<Mac>::Entry<Mac>* skipped_entry = nullptr) const;
+
   std::unique_ptr<PrimitiveSet<Mac>> mac_set_;
+  const internal::OutputPrefixIndex<Mac> prefix_index_;
   std::unique_ptr<MonitoringClient> monitoring_compute_client_;
   std::unique_ptr<MonitoringClient> monitoring_verify_client_;
 };
@@ -82,18 +150,28 @@ util::Status Validate(PrimitiveSet<Mac>* mac_set) {
 
 util::StatusOr<std::string> MacSetWrapper::ComputeMac(
     absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = internal::EnsureStringNonNull(data);
+  return ComputeMacFromParts({data});
+}
+
+util::Status MacSetWrapper::VerifyMac(
+    absl::string_view mac_value,
+    absl::string_view data) const {
+  return VerifyMacFromParts(mac_value, {data});
+}
 
+util::StatusOr<std::string> MacSetWrapper::ComputeMacFromParts(
+    absl::Span<const absl::string_view> data_parts) const {
   auto primary = mac_set_->get_primary();
-  std::string local_data;
+  std::vector<absl::string_view> legacy_data_parts;
   if (primary->get_output_prefix_type() == OutputPrefixType::LEGACY) {
-    local_data = std::string(data);
-    local_data.push_back(CryptoFormat::kLegacyStartByte);
-    data = local_data;
+    // The trailing byte is authenticated as one more part, so that the data
+    // is not copied.
+    legacy_data_parts.assign(data_parts.begin(), data_parts.end());
+    legacy_data_parts.push_back(kLegacySuffix);
+    data_parts = legacy_data_parts;
   }
-  auto compute_mac_result = primary->get_primitive().ComputeMac(data);
+  auto compute_mac_result =
+      primary->get_primitive().ComputeMacFromParts(data_parts);
   if (!compute_mac_result.ok()) {
     if (monitoring_compute_client_ != nullptr) {
       monitoring_compute_client_->LogFailure();
@@ -102,68 +180,206 @@ util::StatusOr<std::string> MacSetWrapper::ComputeMac(
   }
   if (monitoring_compute_client_ != nullptr) {
     monitoring_compute_client_->Log(mac_set_->get_primary()->get_key_id(),
-                                    data.size());
+                                    TotalSize(data_parts));
   }
   const std::string& key_id = primary->get_identifier();
   return key_id + compute_mac_result.value();
 }
 
-util::Status MacSetWrapper::VerifyMac(
+util::Status MacSetWrapper::VerifyMacFromParts(
     absl::string_view mac_value,
-    absl::string_view data) const {
-  data = internal::EnsureStringNonNull(data);
+    absl::Span<const absl::string_view> data_parts) const {
+  uint32_t key_id;
+  util::Status status =
+      VerifyMacWithoutMonitoring(mac_value, data_parts, &key_id);
+  if (monitoring_verify_client_ != nullptr) {
+    if (status.ok()) {
+      monitoring_verify_client_->Log(key_id, TotalSize(data_parts));
+    } else {
+      monitoring_verify_client_->LogFailure();
+    }
+  }
+  return status;
+}
+
+util::Status MacSetWrapper::VerifyMacWithoutMonitoring(
+    absl::string_view mac_value,
+    absl::Span<const absl::string_view> data_parts, uint32_t* key_id,
+    const PrimitiveSet<Mac>::Entry<Mac>* skipped_entry) const {
   mac_value = internal::EnsureStringNonNull(mac_value);
 
   if (mac_value.length() > CryptoFormat::kNonRawPrefixSize) {
-    absl::string_view key_id =
-        mac_value.substr(0, CryptoFormat::kNonRawPrefixSize);
-    auto primitives_result = mac_set_->get_primitives(key_id);
-    if (primitives_result.ok()) {
-      absl::string_view raw_mac_value =
-          mac_value.substr(CryptoFormat::kNonRawPrefixSize);
-      for (auto& mac_entry : *(primitives_result.value())) {
-        std::string legacy_data;
-        absl::string_view view_on_data_or_legacy_data = data;
-        if (mac_entry->get_output_prefix_type() == OutputPrefixType::LEGACY) {
-          legacy_data = absl::StrCat(data, std::string("\x00", 1));
-          view_on_data_or_legacy_data = legacy_data;
-        }
-        Mac& mac = mac_entry->get_primitive();
-        util::Status status =
-            mac.VerifyMac(raw_mac_value, view_on_data_or_legacy_data);
-        if (status.ok()) {
-          if (monitoring_verify_client_ != nullptr) {
-            monitoring_verify_client_->Log(mac_entry->get_key_id(),
-                                           data.size());
-          }
-          return status;
+    absl::string_view raw_mac_value =
+        mac_value.substr(CryptoFormat::kNonRawPrefixSize);
+    std::vector<absl::string_view> legacy_data_parts;
+    for (const auto* mac_entry : prefix_index_.Find(mac_value)) {
+      if (mac_entry == skipped_entry) {
+        continue;
+      }
+      absl::Span<const absl::string_view> parts_or_legacy_parts = data_parts;
+      if (mac_entry->get_output_prefix_type() == OutputPrefixType::LEGACY) {
+        if (legacy_data_parts.empty()) {
+          legacy_data_parts.assign(data_parts.begin(), data_parts.end());
+          legacy_data_parts.push_back(kLegacySuffix);
         }
+        parts_or_legacy_parts = legacy_data_parts;
       }
-    }
-  }
-
-  // No matching key succeeded with verification, try all RAW keys.
-  auto raw_primitives_result = mac_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (auto& mac_entry : *(raw_primitives_result.value())) {
       Mac& mac = mac_entry->get_primitive();
-      util::Status status = mac.VerifyMac(mac_value, data);
+      util::Status status =
+          mac.VerifyMacFromParts(raw_mac_value, parts_or_legacy_parts);
       if (status.ok()) {
-        if (monitoring_verify_client_ != nullptr) {
-          monitoring_verify_client_->Log(mac_entry->get_key_id(), data.size());
-        }
+        *key_id = mac_entry->get_key_id();
         return status;
       }
     }
   }
-  if (monitoring_verify_client_ != nullptr) {
-    monitoring_verify_client_->LogFailure();
-  }
 
+  // No matching key succeeded with verification, try all RAW keys.
+  for (const auto* mac_entry : prefix_index_.raw_entries()) {
+    if (mac_entry == skipped_entry) {
+      continue;
+    }
+    Mac& mac = mac_entry->get_primitive();
+    util::Status status = mac.VerifyMacFromParts(mac_value, data_parts);
+    if (status.ok()) {
+      *key_id = mac_entry->get_key_id();
+      return status;
+    }
+  }
   return util::Status(absl::StatusCode::kInvalidArgument,
                       "verification failed");
 }
 
+util::Status MacSetWrapper::ComputeMacBatch(
+    absl::Span<const absl::string_view> data, std::string* mac_values,
+    std::vector<int64_t>* offsets) const {
+  // The primary is resolved once for the whole batch, and writes each MAC
+  // right after its output prefix.
+  const PrimitiveSet<Mac>::Entry<Mac>* primary = mac_set_->get_primary();
+  const bool primary_is_legacy =
+      primary->get_output_prefix_type() == OutputPrefixType::LEGACY;
+  util::Status status;
+  if (primary_is_legacy) {
+    status = ComputeLegacyMacBatch(*primary, data, mac_values, offsets);
+  } else {
+    status = primary->get_primitive().ComputeMacBatchWithPrefix(
+        primary->get_identifier(), data, mac_values, offsets);
+  }
+  if (!status.ok()) {
+    if (monitoring_compute_client_ != nullptr) {
+      monitoring_compute_client_->LogFailure();
+    }
+    return status;
+  }
+  if (monitoring_compute_client_ != nullptr) {
+    // As in ComputeMacFromParts(), the trailing byte of LEGACY keys is counted.
+    monitoring_compute_client_->Log(
+        primary->get_key_id(),
+        TotalSize(data) +
+            (primary_is_legacy ? data.size() * kLegacySuffix.size() : 0));
+  }
+  return util::OkStatus();
+}
+
+util::Status MacSetWrapper::VerifyMacBatch(
+    absl::Span<const absl::string_view> mac_values,
+    absl::Span<const absl::string_view> data,
+    std::vector<bool>* verified) const {
+  if (mac_values.size() != data.size()) {
+    if (monitoring_verify_client_ != nullptr) {
+      monitoring_verify_client_->LogFailure();
+    }
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "mac_values and data must have the same size");
+  }
+  verified->assign(data.size(), false);
+
+  // Fast path: the MACs carrying the output prefix of the primary, which is
+  // typical for tags issued since the last key rotation, are verified by the
+  // primary in a single call.
+  const PrimitiveSet<Mac>::Entry<Mac>* primary = mac_set_->get_primary();
+  const std::string& primary_prefix = primary->get_identifier();
+  const bool primary_is_legacy =
+      primary->get_output_prefix_type() == OutputPrefixType::LEGACY;
+  std::vector<size_t> primary_indices;
+  std::vector<absl::string_view> primary_mac_values;
+  std::vector<absl::string_view> primary_data;
+  for (size_t i = 0; i < data.size(); ++i) {
+    if (!absl::StartsWith(mac_values[i], primary_prefix)) {
+      continue;
+    }
+    primary_indices.push_back(i);
+    primary_mac_values.push_back(
+        mac_values[i].substr(primary_prefix.size()));
+    primary_data.push_back(internal::EnsureStringNonNull(data[i]));
+  }
+  std::vector<bool> primary_verified;
+  util::Status status;
+  if (primary_is_legacy) {
+    // The trailing byte is authenticated as one more part, so that the data
+    // is not copied.
+    primary_verified.reserve(primary_data.size());
+    for (size_t j = 0; j < primary_data.size(); ++j) {
+      primary_verified.push_back(
+          primary->get_primitive()
+              .VerifyMacFromParts(primary_mac_values[j],
+                                  {primary_data[j], kLegacySuffix})
+              .ok());
+    }
+  } else {
+    status = primary->get_primitive().VerifyMacBatch(
+        primary_mac_values, primary_data, &primary_verified);
+  }
+  if (!status.ok()) {
+    if (monitoring_verify_client_ != nullptr) {
+      monitoring_verify_client_->LogFailure();
+    }
+    return status;
+  }
+  absl::flat_hash_map<uint32_t, int64_t> data_size_per_key;
+  for (size_t j = 0; j < primary_indices.size(); ++j) {
+    if (primary_verified[j]) {
+      (*verified)[primary_indices[j]] = true;
+      data_size_per_key[primary->get_key_id()] +=
+          data[primary_indices[j]].size();
+    }
+  }
+
+  // The remaining MACs are verified one by one with the matching keys. Those
+  // the primary already rejected are not verified with it again.
+  bool any_failed = false;
+  size_t next_primary_index = 0;
+  for (size_t i = 0; i < data.size(); ++i) {
+    const bool tried_by_primary =
+        next_primary_index < primary_indices.size() &&
+        primary_indices[next_primary_index] == i;
+    if (tried_by_primary) {
+      ++next_primary_index;
+    }
+    if ((*verified)[i]) {
+      continue;
+    }
+    uint32_t key_id;
+    if (VerifyMacWithoutMonitoring(mac_values[i], {data[i]}, &key_id,
+                                   tried_by_primary ? primary : nullptr)
+            .ok()) {
+      (*verified)[i] = true;
+      data_size_per_key[key_id] += data[i].size();
+    } else {
+      any_failed = true;
+    }
+  }
+  if (monitoring_verify_client_ != nullptr) {
+    for (const auto& key_and_size : data_size_per_key) {
+      monitoring_verify_client_->Log(key_and_size.first, key_and_size.second);
+    }
+    if (any_failed) {
+      monitoring_verify_client_->LogFailure();
+    }
+  }
+  return util::OkStatus();
+}
+
 }  // namespace
 
 util::StatusOr<std::unique_ptr<Mac>> MacWrapper::Wrap(
@@ -16,12 +16,18 @@
 
 #include "tink/mac/mac_wrapper.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/crypto_format.h"
 #include "tink/internal/registry_impl.h"
 #include "tink/mac.h"
@@ -47,11 +53,13 @@ using ::google::crypto::tink::KeyStatusType;
 using ::google::crypto::tink::OutputPrefixType;
 using ::testing::_;
 using ::testing::ByMove;
+using ::testing::ElementsAre;
 using ::testing::IsNull;
 using ::testing::NiceMock;
 using ::testing::Not;
 using ::testing::NotNull;
 using ::testing::Return;
+using ::testing::SizeIs;
 using ::testing::Test;
 
 TEST(MacWrapperTest, WrapNullptr) {
@@ -248,6 +256,228 @@ KeysetInfo CreateTestKeysetInfo() {
   return keyset_info;
 }
 
+// Wraps the keys of CreateTestKeysetInfo(), with the key at `primary_index`
+// as the primary.
+util::StatusOr<std::unique_ptr<Mac>> WrapTestKeyset(int primary_index) {
+  KeysetInfo keyset_info = CreateTestKeysetInfo();
+  auto mac_set = absl::make_unique<PrimitiveSet<Mac>>();
+  for (int i = 0; i < keyset_info.key_info_size(); ++i) {
+    util::StatusOr<PrimitiveSet<Mac>::Entry<Mac>*> entry =
+        mac_set->AddPrimitive(
+            absl::make_unique<DummyMac>(absl::StrCat("mac", i)),
+            keyset_info.key_info(i));
+    if (!entry.ok()) {
+      return entry.status();
+    }
+    if (i == primary_index) {
+      util::Status status = mac_set->set_primary(*entry);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+  }
+  return MacWrapper().Wrap(std::move(mac_set));
+}
+
+class MacSetWrapperBatchTest : public testing::TestWithParam<int> {};
+
+INSTANTIATE_TEST_SUITE_P(MacSetWrapperBatchTestSuite, MacSetWrapperBatchTest,
+                         testing::Values(0, 1, 2));
+
+TEST_P(MacSetWrapperBatchTest, ComputeAndVerifyBatch) {
+  util::StatusOr<std::unique_ptr<Mac>> mac = WrapTestKeyset(GetParam());
+  ASSERT_THAT(mac, IsOk());
+
+  std::vector<absl::string_view> data = {"data 0", "", "data 2"};
+  std::string mac_values;
+  std::vector<int64_t> offsets;
+  ASSERT_THAT((*mac)->ComputeMacBatch(data, &mac_values, &offsets), IsOk());
+  ASSERT_THAT(offsets, SizeIs(data.size() + 1));
+
+  // Every tag of the batch is the regular tag of the primary.
+  std::vector<absl::string_view> mac_value_views;
+  for (int i = 0; i < data.size(); ++i) {
+    absl::string_view mac_value = absl::string_view(mac_values).substr(
+        offsets[i], offsets[i + 1] - offsets[i]);
+    EXPECT_THAT((*mac)->ComputeMac(data[i]),
+                IsOkAndHolds(std::string(mac_value)));
+    mac_value_views.push_back(mac_value);
+  }
+
+  std::vector<bool> verified;
+  ASSERT_THAT((*mac)->VerifyMacBatch(mac_value_views, data, &verified), IsOk());
+  EXPECT_THAT(verified, ElementsAre(true, true, true));
+
+  // Tags which do not match their data are reported, not failed.
+  std::swap(mac_value_views[0], mac_value_views[2]);
+  ASSERT_THAT((*mac)->VerifyMacBatch(mac_value_views, data, &verified), IsOk());
+  EXPECT_THAT(verified, ElementsAre(false, true, false));
+
+  // The number of tags must match the amount of data.
+  EXPECT_THAT((*mac)->VerifyMacBatch(
+                  absl::MakeConstSpan(mac_value_views).subspan(0, 2), data,
+                  &verified),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(MacSetWrapperBatchTest, VerifyBatchWithMixedKeys) {
+  util::StatusOr<std::unique_ptr<Mac>> mac =
+      WrapTestKeyset(/*primary_index=*/2);
+  ASSERT_THAT(mac, IsOk());
+  util::StatusOr<std::unique_ptr<Mac>> old_mac =
+      WrapTestKeyset(/*primary_index=*/1);
+  ASSERT_THAT(old_mac, IsOk());
+
+  // Tags of a previous (LEGACY) primary and of the current primary.
+  util::StatusOr<std::string> old_mac_value = (*old_mac)->ComputeMac("old");
+  ASSERT_THAT(old_mac_value, IsOk());
+  util::StatusOr<std::string> new_mac_value = (*mac)->ComputeMac("new");
+  ASSERT_THAT(new_mac_value, IsOk());
+
+  std::vector<absl::string_view> mac_values = {*old_mac_value, *new_mac_value,
+                                               "some bad mac"};
+  std::vector<absl::string_view> data = {"old", "new", "new"};
+  std::vector<bool> verified;
+  ASSERT_THAT((*mac)->VerifyMacBatch(mac_values, data, &verified), IsOk());
+  EXPECT_THAT(verified, ElementsAre(true, true, false));
+}
+
+// Forwards to another Mac, and counts the verifications.
+class VerificationCountingMac : public Mac {
+ public:
+  VerificationCountingMac(std::unique_ptr<Mac> mac, int* verifications)
+      : mac_(std::move(mac)), verifications_(verifications) {}
+
+  util::StatusOr<std::string> ComputeMac(
+      absl::string_view data) const override {
+    return mac_->ComputeMac(data);
+  }
+
+  util::Status VerifyMac(absl::string_view mac_value,
+                         absl::string_view data) const override {
+    ++*verifications_;
+    return mac_->VerifyMac(mac_value, data);
+  }
+
+ private:
+  const std::unique_ptr<Mac> mac_;
+  int* const verifications_;
+};
+
+TEST(MacSetWrapperBatchTest, VerifyBatchTriesPrimaryOnce) {
+  for (OutputPrefixType prefix_type :
+       {OutputPrefixType::TINK, OutputPrefixType::RAW}) {
+    SCOPED_TRACE(prefix_type);
+    KeysetInfo::KeyInfo primary_key_info =
+        PopulateKeyInfo(/*key_id=*/1234543, prefix_type,
+                        /*status=*/KeyStatusType::ENABLED);
+    KeysetInfo::KeyInfo raw_key_info =
+        PopulateKeyInfo(/*key_id=*/726329, OutputPrefixType::RAW,
+                        /*status=*/KeyStatusType::ENABLED);
+    int primary_verifications = 0;
+    auto mac_set = absl::make_unique<PrimitiveSet<Mac>>();
+    util::StatusOr<PrimitiveSet<Mac>::Entry<Mac>*> primary =
+        mac_set->AddPrimitive(
+            absl::make_unique<VerificationCountingMac>(
+                absl::make_unique<DummyMac>("mac0"), &primary_verifications),
+            primary_key_info);
+    ASSERT_THAT(primary, IsOk());
+    ASSERT_THAT(mac_set->set_primary(*primary), IsOk());
+    ASSERT_THAT(
+        mac_set->AddPrimitive(absl::make_unique<DummyMac>("mac1"), raw_key_info)
+            .status(),
+        IsOk());
+    util::StatusOr<std::unique_ptr<Mac>> mac =
+        MacWrapper().Wrap(std::move(mac_set));
+    ASSERT_THAT(mac, IsOk());
+
+    // A bad tag with the output prefix of the primary is rejected by the
+    // primary in the batch, and then only tried with the other keys.
+    std::string bad_mac_value =
+        absl::StrCat((*primary)->get_identifier(), "some bad mac");
+    std::vector<absl::string_view> mac_values = {bad_mac_value};
+    std::vector<absl::string_view> data = {"data"};
+    std::vector<bool> verified;
+    ASSERT_THAT((*mac)->VerifyMacBatch(mac_values, data, &verified), IsOk());
+    EXPECT_THAT(verified, ElementsAre(false));
+    EXPECT_EQ(primary_verifications, 1);
+  }
+}
+
+// Computes the MAC by returning the concatenated parts, and records the parts.
+class PartsRecordingMac : public Mac {
+ public:
+  explicit PartsRecordingMac(std::vector<absl::string_view>* parts)
+      : parts_(parts) {}
+
+  util::StatusOr<std::string> ComputeMac(
+      absl::string_view data) const override {
+    return ComputeMacFromParts({data});
+  }
+
+  util::Status VerifyMac(absl::string_view mac_value,
+                         absl::string_view data) const override {
+    return VerifyMacFromParts(mac_value, {data});
+  }
+
+  util::StatusOr<std::string> ComputeMacFromParts(
+      absl::Span<const absl::string_view> data_parts) const override {
+    parts_->assign(data_parts.begin(), data_parts.end());
+    return absl::StrJoin(data_parts, "");
+  }
+
+  util::Status VerifyMacFromParts(
+      absl::string_view mac_value,
+      absl::Span<const absl::string_view> data_parts) const override {
+    parts_->assign(data_parts.begin(), data_parts.end());
+    if (mac_value != absl::StrJoin(data_parts, "")) {
+      return absl::InvalidArgumentError("Wrong mac");
+    }
+    return util::OkStatus();
+  }
+
+ private:
+  std::vector<absl::string_view>* parts_;
+};
+
+TEST(MacWrapperTest, LegacyMacDoesNotCopyData) {
+  KeysetInfo::KeyInfo key_info;
+  key_info.set_output_prefix_type(OutputPrefixType::LEGACY);
+  key_info.set_key_id(1234543);
+  key_info.set_status(KeyStatusType::ENABLED);
+  std::vector<absl::string_view> parts;
+  auto mac_set = absl::make_unique<PrimitiveSet<Mac>>();
+  util::StatusOr<PrimitiveSet<Mac>::Entry<Mac>*> entry =
+      mac_set->AddPrimitive(absl::make_unique<PartsRecordingMac>(&parts),
+                            key_info);
+  ASSERT_THAT(entry, IsOk());
+  ASSERT_THAT(mac_set->set_primary(*entry), IsOk());
+  util::StatusOr<std::unique_ptr<Mac>> mac =
+      MacWrapper().Wrap(std::move(mac_set));
+  ASSERT_THAT(mac, IsOk());
+  const std::string legacy_suffix(1, CryptoFormat::kLegacyStartByte);
+
+  // The trailing byte is passed as a separate part next to the caller's data.
+  std::string data = "Some data to authenticate";
+  util::StatusOr<std::string> mac_value = (*mac)->ComputeMac(data);
+  ASSERT_THAT(mac_value, IsOk());
+  ASSERT_THAT(parts, SizeIs(2));
+  EXPECT_EQ(parts[0].data(), data.data());
+  EXPECT_EQ(parts[1], legacy_suffix);
+  EXPECT_EQ(*mac_value,
+            absl::StrCat((*entry)->get_identifier(), data, legacy_suffix));
+
+  EXPECT_THAT((*mac)->VerifyMac(*mac_value, data), IsOk());
+  ASSERT_THAT(parts, SizeIs(2));
+  EXPECT_EQ(parts[0].data(), data.data());
+
+  std::vector<absl::string_view> data_parts = {"Some data", " to authenticate"};
+  EXPECT_THAT((*mac)->ComputeMacFromParts(data_parts),
+              IsOkAndHolds(*mac_value));
+  EXPECT_THAT((*mac)->VerifyMacFromParts(*mac_value, data_parts), IsOk());
+  EXPECT_THAT(parts, SizeIs(3));
+}
+
 // Tests for the monitoring behavior.
 class MacSetWrapperWithMonitoringTest : public Test {
  protected:
@@ -450,6 +680,40 @@ TEST_F(MacSetWrapperWithMonitoringTest,
               StatusIs(absl::StatusCode::kInvalidArgument));
 }
 
+// Tests that a batch is logged once per key, not once per element.
+TEST_F(MacSetWrapperWithMonitoringTest, WrapKeysetWithMonitoringBatch) {
+  KeysetInfo keyset_info = CreateTestKeysetInfo();
+  auto mac_primitive_set = absl::make_unique<PrimitiveSet<Mac>>();
+  util::StatusOr<PrimitiveSet<Mac>::Entry<Mac>*> entry;
+  for (int i = 0; i < keyset_info.key_info_size(); ++i) {
+    entry = mac_primitive_set->AddPrimitive(
+        absl::make_unique<DummyMac>(absl::StrCat("mac", i)),
+        keyset_info.key_info(i));
+    ASSERT_THAT(entry, IsOk());
+  }
+  ASSERT_THAT(mac_primitive_set->set_primary(*entry), IsOk());
+  const uint32_t primary_key_id = keyset_info.key_info(2).key_id();
+  util::StatusOr<std::unique_ptr<Mac>> mac =
+      MacWrapper().Wrap(std::move(mac_primitive_set));
+  ASSERT_THAT(mac, IsOkAndHolds(NotNull()));
+
+  std::vector<absl::string_view> data = {"message 0", "message 1"};
+  std::string mac_values;
+  std::vector<int64_t> offsets;
+  EXPECT_CALL(*compute_monitoring_client_, Log(primary_key_id, 18));
+  ASSERT_THAT((*mac)->ComputeMacBatch(data, &mac_values, &offsets), IsOk());
+
+  std::vector<absl::string_view> mac_value_views = {
+      absl::string_view(mac_values).substr(0, offsets[1]),
+      "some invalid tag!"};
+  std::vector<bool> verified;
+  EXPECT_CALL(*verify_monitoring_client_, Log(primary_key_id, 9));
+  EXPECT_CALL(*verify_monitoring_client_, LogFailure());
+  EXPECT_THAT((*mac)->VerifyMacBatch(mac_value_views, data, &verified),
+              IsOk());
+  EXPECT_THAT(verified, ElementsAre(true, false));
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
@@ -26,9 +26,10 @@
 #include "absl/strings/string_view.h"
 #include "tink/core/key_type_manager.h"
 #include "tink/key_manager.h"
+#include "tink/mac.h"
+#include "tink/subtle/aes_cmac_boringssl.h"
 #include "tink/subtle/prf/prf_set_util.h"
 #include "tink/subtle/random.h"
-#include "tink/subtle/stateful_cmac_boringssl.h"
 #include "tink/util/constants.h"
 #include "tink/util/errors.h"
 #include "tink/util/input_stream_util.h"
@@ -51,10 +52,13 @@ class AesCmacPrfKeyManager
   class PrfSetFactory : public PrimitiveFactory<Prf> {
     crypto::tink::util::StatusOr<std::unique_ptr<Prf>> Create(
         const google::crypto::tink::AesCmacPrfKey& key) const override {
-      return subtle::CreatePrfFromStatefulMacFactory(
-          absl::make_unique<subtle::StatefulCmacBoringSslFactory>(
-              AesCmacPrfKeyManager::MaxOutputLength(),
-              util::SecretDataFromStringView(key.key_value())));
+      util::StatusOr<std::unique_ptr<Mac>> cmac = subtle::AesCmacBoringSsl::New(
+          util::SecretDataFromStringView(key.key_value()),
+          AesCmacPrfKeyManager::MaxOutputLength());
+      if (!cmac.ok()) {
+        return cmac.status();
+      }
+      return subtle::CreatePrfFromMac(*std::move(cmac));
     }
   };
 
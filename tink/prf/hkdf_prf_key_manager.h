@@ -27,8 +27,8 @@
 #include "tink/core/key_type_manager.h"
 #include "tink/input_stream.h"
 #include "tink/prf/prf_set.h"
+#include "tink/subtle/prf/hkdf_prf.h"
 #include "tink/subtle/prf/hkdf_streaming_prf.h"
-#include "tink/subtle/prf/prf_set_util.h"
 #include "tink/subtle/prf/streaming_prf.h"
 #include "tink/subtle/random.h"
 #include "tink/util/constants.h"
@@ -62,13 +62,9 @@ class HkdfPrfKeyManager
   class PrfSetFactory : public PrimitiveFactory<Prf> {
     crypto::tink::util::StatusOr<std::unique_ptr<Prf>> Create(
         const google::crypto::tink::HkdfPrfKey& key) const override {
-      auto hkdf_result = subtle::HkdfStreamingPrf::New(
+      return subtle::HkdfPrf::New(
           crypto::tink::util::Enums::ProtoToSubtle(key.params().hash()),
           util::SecretDataFromStringView(key.key_value()), key.params().salt());
-      if (!hkdf_result.ok()) {
-        return hkdf_result.status();
-      }
-      return subtle::CreatePrfFromStreamingPrf(std::move(hkdf_result.value()));
     }
   };
 
@@ -27,10 +27,11 @@
 #include "tink/core/key_type_manager.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/key_manager.h"
+#include "tink/mac.h"
 #include "tink/subtle/common_enums.h"
+#include "tink/subtle/hmac_boringssl.h"
 #include "tink/subtle/prf/prf_set_util.h"
 #include "tink/subtle/random.h"
-#include "tink/subtle/stateful_hmac_boringssl.h"
 #include "tink/util/constants.h"
 #include "tink/util/enums.h"
 #include "tink/util/errors.h"
@@ -52,11 +53,14 @@ class HmacPrfKeyManager
   class PrfFactory : public PrimitiveFactory<Prf> {
     crypto::tink::util::StatusOr<std::unique_ptr<Prf>> Create(
         const google::crypto::tink::HmacPrfKey& key) const override {
-      return subtle::CreatePrfFromStatefulMacFactory(
-          absl::make_unique<subtle::StatefulHmacBoringSslFactory>(
-              util::Enums::ProtoToSubtle(key.params().hash()),
-              MaxOutputLength(util::Enums::ProtoToSubtle(key.params().hash())),
-              util::SecretDataFromStringView(key.key_value())));
+      subtle::HashType hash = util::Enums::ProtoToSubtle(key.params().hash());
+      util::StatusOr<std::unique_ptr<Mac>> hmac = subtle::HmacBoringSsl::New(
+          hash, MaxOutputLength(hash),
+          util::SecretDataFromStringView(key.key_value()));
+      if (!hmac.ok()) {
+        return hmac.status();
+      }
+      return subtle::CreatePrfFromMac(*std::move(hmac));
     }
   };
 
@@ -16,22 +16,62 @@
 
 #include "tink/prf/prf_set.h"
 
+#include <cstdint>
+#include <map>
 #include <string>
 
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
 
 namespace crypto {
 namespace tink {
 
+util::Status Prf::ComputeBatch(absl::Span<const absl::string_view> inputs,
+                               size_t output_length,
+                               std::string* outputs) const {
+  outputs->clear();
+  outputs->reserve(inputs.size() * output_length);
+  for (absl::string_view input : inputs) {
+    util::StatusOr<std::string> output = Compute(input, output_length);
+    if (!output.ok()) {
+      return output.status();
+    }
+    outputs->append(*output);
+  }
+  return util::OkStatus();
+}
+
+const Prf* PrfSet::GetPrf(uint32_t key_id) const {
+  const std::map<uint32_t, Prf*>& prfs = GetPrfs();
+  auto prf_it = prfs.find(key_id);
+  if (prf_it == prfs.end()) {
+    return nullptr;
+  }
+  return prf_it->second;
+}
+
 util::StatusOr<std::string> PrfSet::ComputePrimary(absl::string_view input,
                                                    size_t output_length) const {
-  auto prfs = GetPrfs();
-  auto prf_it = prfs.find(GetPrimaryId());
-  if (prf_it == prfs.end()) {
+  const Prf* prf = GetPrf(GetPrimaryId());
+  if (prf == nullptr) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "PrfSet has no PRF for primary ID.");
+  }
+  return prf->Compute(input, output_length);
+}
+
+util::Status PrfSet::ComputePrimaryBatch(
+    absl::Span<const absl::string_view> inputs, size_t output_length,
+    std::string* outputs) const {
+  const Prf* prf = GetPrf(GetPrimaryId());
+  if (prf == nullptr) {
     return util::Status(absl::StatusCode::kInternal,
                         "PrfSet has no PRF for primary ID.");
   }
-  return prf_it->second->Compute(input, output_length);
+  return prf->ComputeBatch(inputs, output_length, outputs);
 }
 
 }  // namespace tink
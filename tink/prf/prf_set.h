@@ -17,10 +17,13 @@
 #ifndef TINK_PRF_PRF_SET_H_
 #define TINK_PRF_PRF_SET_H_
 
+#include <cstdint>
 #include <map>
 #include <string>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -59,6 +62,17 @@ class Prf {
   // algorithm is less than outputLength.
   virtual util::StatusOr<std::string> Compute(absl::string_view input,
                                               size_t output_length) const = 0;
+
+  // Computes the PRF on each element of 'inputs' and writes the outputs back
+  // to back into 'outputs', replacing its contents. Every output is exactly
+  // 'output_length' bytes long, so the output for inputs[i] starts at
+  // i * output_length. Fails if any single computation fails.
+  //
+  // Reusing 'outputs' across calls avoids reallocations.
+  // The default implementation calls Compute() for each element.
+  virtual util::Status ComputeBatch(absl::Span<const absl::string_view> inputs,
+                                    size_t output_length,
+                                    std::string* outputs) const;
 };
 
 // A Tink Keyset can be converted into a set of PRFs using this primitive. Every
@@ -73,10 +87,18 @@ class PrfSet {
   // A map of the PRFs represented by the keys in this keyset.
   // The map is guaranteed to contain getPrimaryId() as a key.
   virtual const std::map<uint32_t, Prf*>& GetPrfs() const = 0;
+  // Returns the PRF with ID 'key_id', or nullptr if there is none.
+  // The default implementation looks up 'key_id' in GetPrfs().
+  virtual const Prf* GetPrf(uint32_t key_id) const;
   // Convenience method to compute the primary PRF on a given input.
   // See PRF.compute for details of the parameters.
   util::StatusOr<std::string> ComputePrimary(absl::string_view input,
                                              size_t output_length) const;
+  // Convenience method to compute the primary PRF on a batch of inputs.
+  // See Prf::ComputeBatch for details of the parameters.
+  util::Status ComputePrimaryBatch(absl::Span<const absl::string_view> inputs,
+                                   size_t output_length,
+                                   std::string* outputs) const;
 };
 
 }  // namespace tink
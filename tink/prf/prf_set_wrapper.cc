@@ -15,6 +15,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include "tink/prf/prf_set_wrapper.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -25,6 +26,8 @@
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/internal/monitoring_util.h"
 #include "tink/internal/registry_impl.h"
 #include "tink/monitoring/monitoring.h"
@@ -71,6 +74,25 @@ class MonitoredPrf : public Prf {
     return result.value();
   }
 
+  util::Status ComputeBatch(absl::Span<const absl::string_view> inputs,
+                            size_t output_length,
+                            std::string* outputs) const override {
+    util::Status status = prf_->ComputeBatch(inputs, output_length, outputs);
+    if (monitoring_client_ == nullptr) {
+      return status;
+    }
+    if (!status.ok()) {
+      monitoring_client_->LogFailure();
+      return status;
+    }
+    int64_t input_size = 0;
+    for (absl::string_view input : inputs) {
+      input_size += input.size();
+    }
+    monitoring_client_->Log(key_id_, input_size);
+    return status;
+  }
+
  private:
   uint32_t key_id_;
   const Prf* prf_;
@@ -83,7 +105,8 @@ class PrfSetPrimitiveWrapper : public PrfSet {
       std::unique_ptr<PrimitiveSet<Prf>> prf_set,
       std::unique_ptr<MonitoringClient> monitoring_client = nullptr)
       : prf_set_(std::move(prf_set)),
-        monitoring_client_(std::move(monitoring_client)) {
+        monitoring_client_(std::move(monitoring_client)),
+        primary_id_(prf_set_->get_primary()->get_key_id()) {
     wrapped_prfs_.reserve(prf_set_->get_raw_primitives().value()->size());
     for (const auto& prf : *prf_set_->get_raw_primitives().value()) {
       std::unique_ptr<Prf> wrapped_prf = std::make_unique<MonitoredPrf>(
@@ -93,20 +116,37 @@ class PrfSetPrimitiveWrapper : public PrfSet {
       prfs_.insert({prf->get_key_id(), wrapped_prf.get()});
       wrapped_prfs_.push_back(std::move(wrapped_prf));
     }
+    // prfs_ holds a single PRF per ID, the first one added, sorted by ID.
+    prfs_by_id_.assign(prfs_.begin(), prfs_.end());
   }
 
-  uint32_t GetPrimaryId() const override {
-    return prf_set_->get_primary()->get_key_id();
-  }
+  uint32_t GetPrimaryId() const override { return primary_id_; }
   const std::map<uint32_t, Prf*>& GetPrfs() const override { return prfs_; }
 
+  // Binary search in a flat array, which avoids chasing the pointers of the
+  // std::map nodes.
+  const Prf* GetPrf(uint32_t key_id) const override {
+    auto prf_it = std::lower_bound(
+        prfs_by_id_.begin(), prfs_by_id_.end(), key_id,
+        [](const std::pair<uint32_t, Prf*>& entry, uint32_t id) {
+          return entry.first < id;
+        });
+    if (prf_it == prfs_by_id_.end() || prf_it->first != key_id) {
+      return nullptr;
+    }
+    return prf_it->second;
+  }
+
   ~PrfSetPrimitiveWrapper() override = default;
 
  private:
   std::unique_ptr<PrimitiveSet<Prf>> prf_set_;
   std::unique_ptr<MonitoringClient> monitoring_client_;
+  const uint32_t primary_id_;
   std::vector<std::unique_ptr<Prf>> wrapped_prfs_;
   std::map<uint32_t, Prf*> prfs_;
+  // Same entries as prfs_, sorted by ID.
+  std::vector<std::pair<uint32_t, Prf*>> prfs_by_id_;
 };
 
 util::Status Validate(PrimitiveSet<Prf>* prf_set) {
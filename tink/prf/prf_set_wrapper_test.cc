@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -47,6 +48,7 @@ using ::testing::_;
 using ::testing::ByMove;
 using ::testing::Key;
 using ::testing::NiceMock;
+using ::testing::IsNull;
 using ::testing::Not;
 using ::testing::Return;
 using ::testing::StrEq;
@@ -144,6 +146,43 @@ TEST_F(PrfSetWrapperTest, WrapTwo) {
               IsOkAndHolds(StrEq("different")));
 }
 
+TEST_F(PrfSetWrapperTest, GetPrf) {
+  auto entry = AddPrf("output", MakeKey(3));
+  ASSERT_THAT(entry, IsOk());
+  ASSERT_THAT(PrfSet()->set_primary(entry.value()), IsOk());
+  ASSERT_THAT(AddPrf("different", MakeKey(1)), IsOk());
+  ASSERT_THAT(AddPrf("another", MakeKey(3)), IsOk());
+  ASSERT_THAT(AddPrf("last", MakeKey(7)), IsOk());
+  util::StatusOr<std::unique_ptr<crypto::tink::PrfSet>> wrapped =
+      PrfSetWrapper().Wrap(std::move(PrfSet()));
+  ASSERT_THAT(wrapped, IsOk());
+
+  for (const auto& id_and_prf : (*wrapped)->GetPrfs()) {
+    EXPECT_EQ((*wrapped)->GetPrf(id_and_prf.first), id_and_prf.second);
+  }
+  ASSERT_THAT((*wrapped)->GetPrf(3), Not(IsNull()));
+  EXPECT_THAT((*wrapped)->GetPrf(3)->Compute("input", 6),
+              IsOkAndHolds(StrEq("output")));
+  EXPECT_THAT((*wrapped)->GetPrf(0), IsNull());
+  EXPECT_THAT((*wrapped)->GetPrf(2), IsNull());
+  EXPECT_THAT((*wrapped)->GetPrf(8), IsNull());
+}
+
+TEST_F(PrfSetWrapperTest, ComputePrimaryBatch) {
+  auto entry = AddPrf("output", MakeKey(1));
+  ASSERT_THAT(entry, IsOk());
+  ASSERT_THAT(PrfSet()->set_primary(entry.value()), IsOk());
+  ASSERT_THAT(AddPrf("different", MakeKey(2)), IsOk());
+  util::StatusOr<std::unique_ptr<crypto::tink::PrfSet>> wrapped =
+      PrfSetWrapper().Wrap(std::move(PrfSet()));
+  ASSERT_THAT(wrapped, IsOk());
+
+  std::vector<absl::string_view> inputs = {"a", "b", "c"};
+  std::string outputs = "previous contents";
+  ASSERT_THAT((*wrapped)->ComputePrimaryBatch(inputs, 6, &outputs), IsOk());
+  EXPECT_THAT(outputs, StrEq("outputoutputoutput"));
+}
+
 // Tests for the monitoring behavior.
 class PrfSetWrapperWithMonitoringTest : public Test {
  protected:
@@ -242,6 +281,35 @@ TEST_F(PrfSetWrapperWithMonitoringTest, WrapKeysetWithMonitoringVerifySuccess) {
   EXPECT_THAT((*prf_set)->ComputePrimary(input, /*output_length=*/16), IsOk());
 }
 
+TEST_F(PrfSetWrapperWithMonitoringTest, ComputeBatchWithMonitoring) {
+  auto primitive_set = absl::make_unique<PrimitiveSet<Prf>>();
+  util::StatusOr<PrimitiveSet<Prf>::Entry<Prf>*> entry =
+      primitive_set->AddPrimitive(absl::make_unique<FakePrf>("output"),
+                                  MakeKey(/*id=*/1));
+  ASSERT_THAT(entry, IsOk());
+  ASSERT_THAT(primitive_set->set_primary(entry.value()), IsOk());
+  ASSERT_THAT(primitive_set
+                  ->AddPrimitive(absl::make_unique<AlwaysFailingPrf>(),
+                                 MakeKey(/*id=*/2))
+                  .status(),
+              IsOk());
+  util::StatusOr<std::unique_ptr<PrfSet>> prf_set =
+      PrfSetWrapper().Wrap(std::move(primitive_set));
+  ASSERT_THAT(prf_set, IsOk());
+
+  // A batch is logged once, with the total size of the inputs.
+  std::vector<absl::string_view> inputs = {"a", "bc", "def"};
+  std::string outputs;
+  EXPECT_CALL(*monitoring_client_ref_, Log(1, 6));
+  EXPECT_THAT((*prf_set)->ComputePrimaryBatch(inputs, /*output_length=*/6,
+                                              &outputs),
+              IsOk());
+  EXPECT_CALL(*monitoring_client_ref_, LogFailure());
+  EXPECT_THAT((*prf_set)->GetPrf(2)->ComputeBatch(
+                  inputs, /*output_length=*/6, &outputs),
+              Not(IsOk()));
+}
+
 }  // namespace
 }  // namespace tink
 }  // namespace crypto
@@ -20,6 +20,7 @@
 #include <string>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -39,6 +40,14 @@ class PublicKeySign {
   virtual crypto::tink::util::StatusOr<std::string> Sign(
       absl::string_view data) const = 0;
 
+  // Computes the signature for the concatenation of 'data_parts'. This allows
+  // to sign data which is not contiguous in memory, or to append a short
+  // suffix to it, without copying the data.
+  //
+  // The default implementation concatenates the parts and calls Sign().
+  virtual crypto::tink::util::StatusOr<std::string> SignFromParts(
+      absl::Span<const absl::string_view> data_parts) const;
+
   virtual ~PublicKeySign() = default;
 };
 
@@ -18,6 +18,7 @@
 #define TINK_PUBLIC_KEY_VERIFY_H_
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/util/status.h"
 
 namespace crypto {
@@ -38,6 +39,14 @@ class PublicKeyVerify {
       absl::string_view signature,
       absl::string_view data) const = 0;
 
+  // Verifies that 'signature' is a digital signature for the concatenation of
+  // 'data_parts'; see PublicKeySign::SignFromParts().
+  //
+  // The default implementation concatenates the parts and calls Verify().
+  virtual crypto::tink::util::Status VerifyFromParts(
+      absl::string_view signature,
+      absl::Span<const absl::string_view> data_parts) const;
+
   virtual ~PublicKeyVerify() = default;
 };
 
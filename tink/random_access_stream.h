@@ -17,6 +17,10 @@
 #ifndef TINK_RANDOM_ACCESS_STREAM_H_
 #define TINK_RANDOM_ACCESS_STREAM_H_
 
+#include <cstdint>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "tink/util/buffer.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -60,6 +64,26 @@ class RandomAccessStream {
   // For a successful PRead-operation the starting position should be
   // in the range 0..size()-1 (otherwise PRead may return a non-Ok status).
   virtual crypto::tink::util::StatusOr<int64_t> size() = 0;
+
+  // Returns a view of up to 'count' bytes starting at 'position', without
+  // copying them.  This is an optional extension for streams whose contents
+  // are already in memory (like memory-mapped files); the view remains valid
+  // as long as the stream is alive.  'position' must be non-negative and
+  // 'count' must be positive.
+  //
+  // Return values:
+  //  OK: the view contains exactly 'count' bytes, or fewer if the end of
+  //      the stream is reached before.
+  //  OUT_OF_RANGE: if 'position' is not smaller than the size of the stream.
+  //  UNIMPLEMENTED: if the stream does not support views; in this case
+  //      callers should read via PRead() instead.
+  //  INVALID_ARGUMENT: if some of the arguments are not valid.
+  //  other: if some other error occurred.
+  virtual crypto::tink::util::StatusOr<absl::string_view> View(
+      int64_t position, int count) {
+    return crypto::tink::util::Status(absl::StatusCode::kUnimplemented,
+                                      "View is not supported");
+  }
 };
 
 }  // namespace tink
@@ -16,15 +16,18 @@
 
 #include "tink/signature/public_key_sign_wrapper.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/crypto_format.h"
 #include "tink/internal/monitoring_util.h"
 #include "tink/internal/registry_impl.h"
-#include "tink/internal/util.h"
 #include "tink/monitoring/monitoring.h"
 #include "tink/primitive_set.h"
 #include "tink/public_key_sign.h"
@@ -41,6 +44,9 @@ namespace {
 constexpr absl::string_view kPrimitive = "public_key_sign";
 constexpr absl::string_view kSignApi = "sign";
 
+// Appended to the data before signing with LEGACY keys.
+constexpr absl::string_view kLegacySuffix("\x00", 1);
+
 util::Status Validate(PrimitiveSet<PublicKeySign>* public_key_sign_set) {
   if (public_key_sign_set == nullptr) {
     return util::Status(absl::StatusCode::kInternal,
@@ -64,6 +70,9 @@ class PublicKeySignSetWrapper : public PublicKeySign {
   crypto::tink::util::StatusOr<std::string> Sign(
       absl::string_view data) const override;
 
+  crypto::tink::util::StatusOr<std::string> SignFromParts(
+      absl::Span<const absl::string_view> data_parts) const override;
+
   ~PublicKeySignSetWrapper() override = default;
 
  private:
@@ -73,18 +82,21 @@ class PublicKeySignSetWrapper : public PublicKeySign {
 
 util::StatusOr<std::string> PublicKeySignSetWrapper::Sign(
     absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = internal::EnsureStringNonNull(data);
+  return SignFromParts({data});
+}
 
+util::StatusOr<std::string> PublicKeySignSetWrapper::SignFromParts(
+    absl::Span<const absl::string_view> data_parts) const {
   auto primary = public_key_sign_set_->get_primary();
-  std::string local_data;
+  std::vector<absl::string_view> legacy_data_parts;
   if (primary->get_output_prefix_type() == OutputPrefixType::LEGACY) {
-    local_data = std::string(data);
-    local_data.append(1, CryptoFormat::kLegacyStartByte);
-    data = local_data;
+    // The trailing byte is signed as one more part, so that the data is not
+    // copied.
+    legacy_data_parts.assign(data_parts.begin(), data_parts.end());
+    legacy_data_parts.push_back(kLegacySuffix);
+    data_parts = legacy_data_parts;
   }
-  auto sign_result = primary->get_primitive().Sign(data);
+  auto sign_result = primary->get_primitive().SignFromParts(data_parts);
   if (!sign_result.ok()) {
     if (monitoring_sign_client_ != nullptr) {
       monitoring_sign_client_->LogFailure();
@@ -92,8 +104,12 @@ util::StatusOr<std::string> PublicKeySignSetWrapper::Sign(
     return sign_result.status();
   }
   if (monitoring_sign_client_ != nullptr) {
+    int64_t data_size = 0;
+    for (absl::string_view part : data_parts) {
+      data_size += part.size();
+    }
     monitoring_sign_client_->Log(
-        public_key_sign_set_->get_primary()->get_key_id(), data.size());
+        public_key_sign_set_->get_primary()->get_key_id(), data_size);
   }
   const std::string& key_id = primary->get_identifier();
   return key_id + sign_result.value();
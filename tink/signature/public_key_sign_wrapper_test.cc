@@ -19,11 +19,16 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/crypto_format.h"
 #include "tink/internal/registry_impl.h"
 #include "tink/monitoring/monitoring.h"
@@ -50,6 +55,7 @@ using ::testing::StrictMock;
 using ::testing::Not;
 using ::testing::NotNull;
 using ::testing::Return;
+using ::testing::SizeIs;
 using ::testing::Test;
 
 namespace crypto {
@@ -182,6 +188,59 @@ TEST(PublicKeySignSetWrapperTest, TestLegacySignatures) {
   EXPECT_TRUE(status.ok()) << status;
 }
 
+// Signs by returning the concatenated parts, and records the parts.
+class PartsRecordingSign : public PublicKeySign {
+ public:
+  explicit PartsRecordingSign(std::vector<absl::string_view>* parts)
+      : parts_(parts) {}
+
+  util::StatusOr<std::string> Sign(absl::string_view data) const override {
+    return SignFromParts({data});
+  }
+
+  util::StatusOr<std::string> SignFromParts(
+      absl::Span<const absl::string_view> data_parts) const override {
+    parts_->assign(data_parts.begin(), data_parts.end());
+    return absl::StrJoin(data_parts, "");
+  }
+
+ private:
+  std::vector<absl::string_view>* parts_;
+};
+
+TEST(PublicKeySignSetWrapperTest, LegacySignatureDoesNotCopyData) {
+  KeysetInfo::KeyInfo key;
+  key.set_output_prefix_type(OutputPrefixType::LEGACY);
+  key.set_key_id(1234543);
+  key.set_status(KeyStatusType::ENABLED);
+  std::vector<absl::string_view> parts;
+  auto pk_sign_set = absl::make_unique<PrimitiveSet<PublicKeySign>>();
+  util::StatusOr<PrimitiveSet<PublicKeySign>::Entry<PublicKeySign>*> entry =
+      pk_sign_set->AddPrimitive(absl::make_unique<PartsRecordingSign>(&parts),
+                                key);
+  ASSERT_THAT(entry, IsOk());
+  ASSERT_THAT(pk_sign_set->set_primary(*entry), IsOk());
+  util::StatusOr<std::unique_ptr<PublicKeySign>> pk_sign =
+      PublicKeySignWrapper().Wrap(std::move(pk_sign_set));
+  ASSERT_THAT(pk_sign, IsOk());
+
+  // The trailing byte is passed as a separate part next to the caller's data.
+  std::string data = "Some data to sign";
+  util::StatusOr<std::string> signature = (*pk_sign)->Sign(data);
+  ASSERT_THAT(signature, IsOk());
+  ASSERT_THAT(parts, SizeIs(2));
+  EXPECT_EQ(parts[0].data(), data.data());
+  EXPECT_EQ(parts[0], data);
+  EXPECT_EQ(parts[1], std::string(1, CryptoFormat::kLegacyStartByte));
+  EXPECT_EQ(*signature,
+            absl::StrCat((*entry)->get_identifier(), data,
+                         std::string(1, CryptoFormat::kLegacyStartByte)));
+
+  std::vector<absl::string_view> data_parts = {"Some data", " to sign"};
+  EXPECT_THAT((*pk_sign)->SignFromParts(data_parts), IsOkAndHolds(*signature));
+  EXPECT_THAT(parts, SizeIs(3));
+}
+
 KeysetInfo::KeyInfo PopulateKeyInfo(uint32_t key_id,
                                     OutputPrefixType out_prefix_type,
                                     KeyStatusType status) {
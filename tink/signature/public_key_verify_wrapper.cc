@@ -16,14 +16,18 @@
 
 #include "tink/signature/public_key_verify_wrapper.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
-#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/crypto_format.h"
 #include "tink/internal/monitoring_util.h"
+#include "tink/internal/output_prefix_index.h"
 #include "tink/internal/registry_impl.h"
 #include "tink/internal/util.h"
 #include "tink/monitoring/monitoring.h"
@@ -41,6 +45,9 @@ namespace {
 constexpr absl::string_view kPrimitive = "public_key_verify";
 constexpr absl::string_view kVerifyApi = "verify";
 
+// Appended to the data before verifying with LEGACY keys.
+constexpr absl::string_view kLegacySuffix("\x00", 1);
+
 using ::google::crypto::tink::OutputPrefixType;
 
 util::Status Validate(PrimitiveSet<PublicKeyVerify>* public_key_verify_set) {
@@ -61,23 +68,32 @@ class PublicKeyVerifySetWrapper : public PublicKeyVerify {
       std::unique_ptr<PrimitiveSet<PublicKeyVerify>> public_key_verify_set,
       std::unique_ptr<MonitoringClient> monitoring_verify_client = nullptr)
       : public_key_verify_set_(std::move(public_key_verify_set)),
+      prefix_index_(*public_key_verify_set_),
       monitoring_verify_client_(std::move(monitoring_verify_client)) {}
 
   crypto::tink::util::Status Verify(absl::string_view signature,
                                     absl::string_view data) const override;
 
+  crypto::tink::util::Status VerifyFromParts(
+      absl::string_view signature,
+      absl::Span<const absl::string_view> data_parts) const override;
+
   ~PublicKeyVerifySetWrapper() override = default;
 
  private:
   std::unique_ptr<PrimitiveSet<PublicKeyVerify>> public_key_verify_set_;
+  const internal::OutputPrefixIndex<PublicKeyVerify> prefix_index_;
   std::unique_ptr<MonitoringClient> monitoring_verify_client_;
 };
 
 util::Status PublicKeyVerifySetWrapper::Verify(absl::string_view signature,
                                                absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = internal::EnsureStringNonNull(data);
+  return VerifyFromParts(signature, {data});
+}
+
+util::Status PublicKeyVerifySetWrapper::VerifyFromParts(
+    absl::string_view signature,
+    absl::Span<const absl::string_view> data_parts) const {
   signature = internal::EnsureStringNonNull(signature);
 
   if (signature.length() <= CryptoFormat::kNonRawPrefixSize) {
@@ -86,46 +102,46 @@ util::Status PublicKeyVerifySetWrapper::Verify(absl::string_view signature,
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "Signature too short.");
   }
-  absl::string_view key_id =
-      signature.substr(0, CryptoFormat::kNonRawPrefixSize);
-  auto primitives_result = public_key_verify_set_->get_primitives(key_id);
-  if (primitives_result.ok()) {
-    absl::string_view raw_signature =
-        signature.substr(CryptoFormat::kNonRawPrefixSize);
-    for (auto& entry : *(primitives_result.value())) {
-      std::string legacy_data;
-      absl::string_view view_on_data_or_legacy_data = data;
-      if (entry->get_output_prefix_type() == OutputPrefixType::LEGACY) {
-        legacy_data = absl::StrCat(data, std::string("\x00", 1));
-        view_on_data_or_legacy_data = legacy_data;
+  int64_t data_size = 0;
+  for (absl::string_view part : data_parts) {
+    data_size += part.size();
+  }
+  absl::string_view raw_signature =
+      signature.substr(CryptoFormat::kNonRawPrefixSize);
+  std::vector<absl::string_view> legacy_data_parts;
+  for (const auto* entry : prefix_index_.Find(signature)) {
+    absl::Span<const absl::string_view> parts_or_legacy_parts = data_parts;
+    if (entry->get_output_prefix_type() == OutputPrefixType::LEGACY) {
+      if (legacy_data_parts.empty()) {
+        legacy_data_parts.assign(data_parts.begin(), data_parts.end());
+        legacy_data_parts.push_back(kLegacySuffix);
       }
-      auto& public_key_verify = entry->get_primitive();
-      auto verify_result =
-          public_key_verify.Verify(raw_signature, view_on_data_or_legacy_data);
-      if (verify_result.ok()) {
-        if (monitoring_verify_client_ != nullptr) {
-          monitoring_verify_client_->Log(entry->get_key_id(), data.size());
-        }
-        return util::OkStatus();
-      } else {
-        // LOG that a matching key didn't verify the signature.
+      parts_or_legacy_parts = legacy_data_parts;
+    }
+    auto& public_key_verify = entry->get_primitive();
+    auto verify_result =
+        public_key_verify.VerifyFromParts(raw_signature, parts_or_legacy_parts);
+    if (verify_result.ok()) {
+      if (monitoring_verify_client_ != nullptr) {
+        monitoring_verify_client_->Log(entry->get_key_id(), data_size);
       }
+      return util::OkStatus();
+    } else {
+      // LOG that a matching key didn't verify the signature.
     }
   }
 
   // No matching key succeeded with verification, try all RAW keys.
-  auto raw_primitives_result = public_key_verify_set_->get_raw_primitives();
-  if (raw_primitives_result.ok()) {
-    for (auto& public_key_verify_entry : *(raw_primitives_result.value())) {
-      auto& public_key_verify = public_key_verify_entry->get_primitive();
-      auto verify_result = public_key_verify.Verify(signature, data);
-      if (verify_result.ok()) {
-        if (monitoring_verify_client_ != nullptr) {
-          monitoring_verify_client_->Log(public_key_verify_entry->get_key_id(),
-                                         data.size());
-        }
-        return util::OkStatus();
+  for (const auto* public_key_verify_entry : prefix_index_.raw_entries()) {
+    auto& public_key_verify = public_key_verify_entry->get_primitive();
+    auto verify_result =
+        public_key_verify.VerifyFromParts(signature, data_parts);
+    if (verify_result.ok()) {
+      if (monitoring_verify_client_ != nullptr) {
+        monitoring_verify_client_->Log(public_key_verify_entry->get_key_id(),
+                                       data_size);
       }
+      return util::OkStatus();
     }
   }
   if (monitoring_verify_client_ != nullptr) {
@@ -19,8 +19,13 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tink/crypto_format.h"
 #include "tink/primitive_set.h"
 #include "tink/public_key_verify.h"
 #include "tink/internal/registry_impl.h"
@@ -142,6 +147,39 @@ TEST_F(PublicKeyVerifySetWrapperTest, testBasic) {
   }
 }
 
+TEST_F(PublicKeyVerifySetWrapperTest, VerifyLegacySignatureFromParts) {
+  KeysetInfo::KeyInfo key;
+  key.set_output_prefix_type(OutputPrefixType::LEGACY);
+  key.set_key_id(726329);
+  key.set_status(KeyStatusType::ENABLED);
+  std::string signature_name = "signature_legacy";
+  auto pk_verify_set = absl::make_unique<PrimitiveSet<PublicKeyVerify>>();
+  auto entry = pk_verify_set->AddPrimitive(
+      absl::make_unique<DummyPublicKeyVerify>(signature_name), key);
+  ASSERT_THAT(entry, IsOk());
+  ASSERT_THAT(pk_verify_set->set_primary(*entry), IsOk());
+  const std::string prefix = (*entry)->get_identifier();
+  util::StatusOr<std::unique_ptr<PublicKeyVerify>> pk_verify =
+      PublicKeyVerifyWrapper().Wrap(std::move(pk_verify_set));
+  ASSERT_THAT(pk_verify, IsOk());
+
+  // LEGACY signatures are computed over the data followed by a zero byte.
+  std::string data = "some data to sign";
+  util::StatusOr<std::string> raw_signature =
+      DummyPublicKeySign(signature_name)
+          .Sign(absl::StrCat(data,
+                             std::string(1, CryptoFormat::kLegacyStartByte)));
+  ASSERT_THAT(raw_signature, IsOk());
+  std::string signature = absl::StrCat(prefix, *raw_signature);
+
+  std::vector<absl::string_view> data_parts = {"some data", "", " to sign"};
+  EXPECT_THAT((*pk_verify)->VerifyFromParts(signature, data_parts), IsOk());
+  EXPECT_THAT((*pk_verify)->Verify(signature, data), IsOk());
+  std::vector<absl::string_view> other_parts = {"some data", " to sig"};
+  EXPECT_THAT((*pk_verify)->VerifyFromParts(signature, other_parts),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 KeysetInfo::KeyInfo PopulateKeyInfo(uint32_t key_id,
                                     OutputPrefixType out_prefix_type,
                                     KeyStatusType status) {
@@ -32,6 +32,15 @@
 namespace crypto {
 namespace tink {
 namespace streamingaead {
+namespace {
+
+// The maximal number of bytes buffered per Next()-call while rewinding is
+// enabled. Streams like util::MmapInputStream return very large buffers,
+// of which only the header and the first segment are needed for matching;
+// the rest is backed up, and later read directly after rewinding is disabled.
+constexpr int kMaxBufferedReadSize = 64 * 1024;
+
+}  // namespace
 
 using util::Status;
 using util::StatusOr;
@@ -90,6 +99,10 @@ crypto::tink::util::StatusOr<int> BufferedInputStream::Next(const void** data) {
     return status_;
   }
   size_t count_read = next_result.value();
+  if (count_read > kMaxBufferedReadSize) {
+    input_stream_->BackUp(count_read - kMaxBufferedReadSize);
+    count_read = kMaxBufferedReadSize;
+  }
   if (buffer_.size() < count_in_buffer_ + count_read) {
     buffer_.resize(buffer_.size() + std::max(buffer_.size(), count_read));
   }
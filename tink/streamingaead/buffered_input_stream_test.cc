@@ -246,6 +246,33 @@ TEST(BufferedInputStreamTest, MultipleBackups) {
             std::string(static_cast<const char*>(buffer), total_backup_size));
 }
 
+TEST(BufferedInputStreamTest, LargeBuffersAreBufferedPartially) {
+  int input_size = 300000;
+  std::string contents = subtle::Random::GetRandomBytes(input_size);
+  auto string_stream = absl::make_unique<std::stringstream>(contents);
+  auto buf_stream = absl::make_unique<BufferedInputStream>(
+      absl::make_unique<util::IstreamInputStream>(std::move(string_stream),
+                                                  input_size));
+  const void* buffer;
+
+  // Only a prefix of the large buffer of the wrapped stream is buffered.
+  auto next_result = buf_stream->Next(&buffer);
+  ASSERT_THAT(next_result, IsOk());
+  int next_size = next_result.value();
+  EXPECT_LT(next_size, input_size);
+  EXPECT_EQ(next_size, buf_stream->Position());
+  EXPECT_EQ(contents.substr(0, next_size),
+            std::string(static_cast<const char*>(buffer), next_size));
+
+  // After rewinding and disabling rewinding, the rest is read unbuffered.
+  ASSERT_THAT(buf_stream->Rewind(), IsOk());
+  buf_stream->DisableRewinding();
+  std::string read_contents;
+  ASSERT_THAT(ReadFromStream(buf_stream.get(), &read_contents), IsOk());
+  EXPECT_EQ(contents, read_contents);
+  EXPECT_EQ(input_size, buf_stream->Position());
+}
+
 TEST(BufferedInputStreamTest, DisableRewindingInitially) {
   for (auto input_size : {0, 10, 100, 1000, 10000}) {
     std::string contents = subtle::Random::GetRandomBytes(input_size);
@@ -26,10 +26,12 @@
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "tink/input_stream.h"
+#include "tink/internal/thread_pool.h"
 #include "tink/primitive_set.h"
 #include "tink/streaming_aead.h"
 #include "tink/streamingaead/buffered_input_stream.h"
 #include "tink/streamingaead/shared_input_stream.h"
+#include "tink/subtle/nonce_based_streaming_aead.h"
 #include "tink/util/errors.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -60,6 +62,54 @@ StatusOr<std::unique_ptr<InputStream>> DecryptingInputStream::New(
   return {std::move(dec_stream)};
 }
 
+// static
+StatusOr<std::unique_ptr<InputStream>> DecryptingInputStream::New(
+    std::shared_ptr<PrimitiveSet<StreamingAead>> primitives,
+    std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
+    absl::string_view associated_data,
+    const ReadAheadOptions& read_ahead_options) {
+  if ((read_ahead_options.thread_pool == nullptr &&
+       read_ahead_options.num_threads < 1) ||
+      read_ahead_options.max_segments_in_flight < 1) {
+    return Status(absl::StatusCode::kInvalidArgument,
+                  "num_threads and max_segments_in_flight must be positive");
+  }
+  auto dec_stream = absl::WrapUnique(new DecryptingInputStream());
+  dec_stream->primitives_ = primitives;
+  dec_stream->buffered_ct_source_ =
+      std::make_shared<BufferedInputStream>(std::move(ciphertext_source));
+  dec_stream->associated_data_ = std::string(associated_data);
+  dec_stream->attempted_matching_ = false;
+  dec_stream->matching_stream_ = nullptr;
+  dec_stream->read_ahead_options_ = read_ahead_options;
+  return {std::move(dec_stream)};
+}
+
+StatusOr<std::unique_ptr<InputStream>>
+DecryptingInputStream::NewDecryptingStream(
+    const StreamingAead& streaming_aead,
+    std::unique_ptr<InputStream> ciphertext_source) {
+  // Read-ahead streams only read from 'ciphertext_source' on the worker
+  // threads from their second Next()-call on, i.e. after the matching below
+  // has disabled rewinding of buffered_ct_source_.
+  if (read_ahead_options_.has_value()) {
+    const auto* nonce_based_streaming_aead =
+        dynamic_cast<const subtle::NonceBasedStreamingAead*>(&streaming_aead);
+    if (nonce_based_streaming_aead != nullptr) {
+      if (read_ahead_options_->thread_pool == nullptr) {
+        read_ahead_options_->thread_pool =
+            std::make_shared<internal::ThreadPool>(
+                read_ahead_options_->num_threads);
+      }
+      return nonce_based_streaming_aead->NewParallelDecryptingStream(
+          std::move(ciphertext_source), associated_data_,
+          *read_ahead_options_);
+    }
+  }
+  return streaming_aead.NewDecryptingStream(std::move(ciphertext_source),
+                                            associated_data_);
+}
+
 util::StatusOr<int> DecryptingInputStream::Next(const void** data) {
   if (matching_stream_ != nullptr) {
     return matching_stream_->Next(data);
@@ -76,8 +126,8 @@ util::StatusOr<int> DecryptingInputStream::Next(const void** data) {
     StreamingAead& streaming_aead = entry->get_primitive();
     auto shared_ct =
         std::make_unique<SharedInputStream>(buffered_ct_source_.get());
-    auto decrypting_stream_result = streaming_aead.NewDecryptingStream(
-        std::move(shared_ct), associated_data_);
+    auto decrypting_stream_result =
+        NewDecryptingStream(streaming_aead, std::move(shared_ct));
     if (decrypting_stream_result.ok()) {
       auto next_result = decrypting_stream_result.value()->Next(data);
       if (next_result.status().code() == absl::StatusCode::kOutOfRange ||
@@ -21,10 +21,12 @@
 #include <string>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "tink/input_stream.h"
 #include "tink/primitive_set.h"
 #include "tink/streaming_aead.h"
 #include "tink/streamingaead/buffered_input_stream.h"
+#include "tink/subtle/parallel_streaming_aead_decrypting_stream.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -48,6 +50,20 @@ class DecryptingInputStream : public crypto::tink::InputStream {
       std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
       absl::string_view associated_data);
 
+  using ReadAheadOptions =
+      crypto::tink::subtle::ParallelStreamingAeadDecryptingStream::Options;
+
+  // Like New() above, but if the matching primitive is a
+  // subtle::NonceBasedStreamingAead, reads and decrypts segments ahead of the
+  // caller on worker threads, as configured by 'read_ahead_options'. Other
+  // primitives decrypt as usual.
+  static util::StatusOr<std::unique_ptr<InputStream>> New(
+      std::shared_ptr<
+          crypto::tink::PrimitiveSet<crypto::tink::StreamingAead>> primitives,
+      std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
+      absl::string_view associated_data,
+      const ReadAheadOptions& read_ahead_options);
+
   ~DecryptingInputStream() override = default;
   util::StatusOr<int> Next(const void** data) override;
   void BackUp(int count) override;
@@ -55,12 +71,23 @@ class DecryptingInputStream : public crypto::tink::InputStream {
 
  private:
   DecryptingInputStream() {}
+
+  // Returns a decrypting stream of 'streaming_aead' for 'ciphertext_source',
+  // which reads ahead if read_ahead_options_ is set. All read-ahead streams
+  // share one thread pool, so that probing the primitives starts the worker
+  // threads only once.
+  util::StatusOr<std::unique_ptr<crypto::tink::InputStream>>
+  NewDecryptingStream(
+      const crypto::tink::StreamingAead& streaming_aead,
+      std::unique_ptr<crypto::tink::InputStream> ciphertext_source);
+
   std::shared_ptr<
       crypto::tink::PrimitiveSet<crypto::tink::StreamingAead>> primitives_;
   std::shared_ptr<BufferedInputStream> buffered_ct_source_;
   std::string associated_data_;
   std::unique_ptr<crypto::tink::InputStream> matching_stream_;
   bool attempted_matching_;
+  absl::optional<ReadAheadOptions> read_ahead_options_;
 };
 
 }  // namespace streamingaead
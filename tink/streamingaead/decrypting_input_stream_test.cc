@@ -230,6 +230,43 @@ TEST(DecryptingInputStreamTest, WrongCiphertext) {
   }
 }
 
+TEST(DecryptingInputStreamTest, ReadAheadDecryption) {
+  // A non-matching primitive first, so that the read-ahead stream is created
+  // only after rewinding the ciphertext.
+  auto saead_set = GetTestStreamingAeadSet({{1234543, "streaming_aead0"}});
+  KeysetInfo::KeyInfo key_info;
+  key_info.set_output_prefix_type(OutputPrefixType::RAW);
+  key_info.set_key_id(726329);
+  key_info.set_status(KeyStatusType::ENABLED);
+  auto entry_result = saead_set->AddPrimitive(
+      absl::make_unique<subtle::test::DummyStreamingAead>(
+          /*pt_segment_size=*/256, /*header_size=*/32, /*ct_offset=*/0),
+      key_info);
+  ASSERT_THAT(entry_result, IsOk());
+  StreamingAead& saead = entry_result.value()->get_primitive();
+
+  DecryptingInputStream::ReadAheadOptions options;
+  options.num_threads = 4;
+  options.max_segments_in_flight = 8;
+  for (int pt_size : {0, 1, 10, 100, 10000}) {
+    SCOPED_TRACE(absl::StrCat("pt_size = ", pt_size));
+    std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
+    std::string aad = "some_aad";
+    auto dec_stream_result = DecryptingInputStream::New(
+        saead_set, GetCiphertextSource(&saead, plaintext, aad), aad, options);
+    ASSERT_THAT(dec_stream_result, IsOk());
+    std::string decrypted;
+    auto status = ReadFromStream(dec_stream_result.value().get(), &decrypted);
+    EXPECT_THAT(status, IsOk());
+    EXPECT_EQ(plaintext, decrypted);
+  }
+
+  options.num_threads = 0;
+  EXPECT_THAT(DecryptingInputStream::New(saead_set, GetInputStream("ct"),
+                                         "some_aad", options)
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
 
 }  // namespace
 }  // namespace streamingaead
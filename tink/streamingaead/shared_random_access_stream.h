@@ -17,6 +17,9 @@
 #ifndef TINK_STREAMINGAEAD_SHARED_RANDOM_ACCESS_STREAM_H_
 #define TINK_STREAMINGAEAD_SHARED_RANDOM_ACCESS_STREAM_H_
 
+#include <cstdint>
+
+#include "absl/strings/string_view.h"
 #include "tink/random_access_stream.h"
 #include "tink/util/buffer.h"
 #include "tink/util/status.h"
@@ -50,6 +53,11 @@ class SharedRandomAccessStream : public crypto::tink::RandomAccessStream {
     return random_access_stream_->size();
   }
 
+  crypto::tink::util::StatusOr<absl::string_view> View(int64_t position,
+                                                       int count) override {
+    return random_access_stream_->View(position, count);
+  }
+
  private:
   crypto::tink::RandomAccessStream* random_access_stream_;
 };
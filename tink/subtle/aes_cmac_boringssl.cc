@@ -23,12 +23,14 @@
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/cmac.h"
+#include "openssl/crypto.h"
 #include "openssl/evp.h"
 #include "tink/internal/aes_util.h"
 #include "tink/internal/ssl_unique_ptr.h"
 #include "tink/internal/util.h"
-#include "tink/subtle/subtle_util.h"
 #include "tink/util/errors.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -61,47 +63,74 @@ util::StatusOr<std::unique_ptr<Mac>> AesCmacBoringSsl::New(util::SecretData key,
                      "Invalid tag size: expected lower than %d, found %d",
                      kMaxTagSize, tag_size);
   }
-  return {absl::WrapUnique(new AesCmacBoringSsl(std::move(key), tag_size))};
-}
-
-util::StatusOr<std::string> AesCmacBoringSsl::ComputeMac(
-    absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = internal::EnsureStringNonNull(data);
-
-  std::string result;
-  ResizeStringUninitialized(&result, kMaxTagSize);
-  internal::SslUniquePtr<CMAC_CTX> context(CMAC_CTX_new());
   util::StatusOr<const EVP_CIPHER*> cipher =
-      internal::GetAesCbcCipherForKeySize(key_.size());
+      internal::GetAesCbcCipherForKeySize(key.size());
   if (!cipher.ok()) {
     return cipher.status();
   }
+  internal::SslUniquePtr<CMAC_CTX> keyed_context(CMAC_CTX_new());
+  if (keyed_context == nullptr ||
+      CMAC_Init(keyed_context.get(), key.data(), key.size(), *cipher,
+                nullptr) <= 0) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "Failed to initialize CMAC");
+  }
+  return {absl::WrapUnique(
+      new AesCmacBoringSsl(std::move(keyed_context), tag_size))};
+}
+
+util::Status AesCmacBoringSsl::ComputeFullMac(
+    absl::Span<const absl::string_view> data_parts, uint8_t* mac) const {
+  internal::SslUniquePtr<CMAC_CTX> context(CMAC_CTX_new());
+  bool ok = context != nullptr &&
+            CMAC_CTX_copy(context.get(), keyed_context_.get()) > 0;
+  for (int i = 0; ok && i < data_parts.size(); ++i) {
+    // BoringSSL expects a non-null pointer for data,
+    // regardless of whether the size is 0.
+    absl::string_view data = internal::EnsureStringNonNull(data_parts[i]);
+    ok = CMAC_Update(context.get(),
+                     reinterpret_cast<const uint8_t*>(data.data()),
+                     data.size()) > 0;
+  }
   size_t len = 0;
-  const uint8_t* key_ptr = reinterpret_cast<const uint8_t*>(&key_[0]);
-  const uint8_t* data_ptr = reinterpret_cast<const uint8_t*>(data.data());
-  uint8_t* result_ptr = reinterpret_cast<uint8_t*>(&result[0]);
-  if (CMAC_Init(context.get(), key_ptr, key_.size(), *cipher, nullptr) <= 0 ||
-      CMAC_Update(context.get(), data_ptr, data.size()) <= 0 ||
-      CMAC_Final(context.get(), result_ptr, &len) == 0) {
+  if (!ok || CMAC_Final(context.get(), mac, &len) == 0) {
     return util::Status(absl::StatusCode::kInternal, "Failed to compute CMAC");
   }
+  return util::OkStatus();
+}
 
-  result.resize(tag_size_);
-  return result;
+util::StatusOr<std::string> AesCmacBoringSsl::ComputeMac(
+    absl::string_view data) const {
+  return ComputeMacFromParts({data});
 }
 
 util::Status AesCmacBoringSsl::VerifyMac(absl::string_view mac,
                                          absl::string_view data) const {
-  if (mac.size() != tag_size_) {
+  return VerifyMacFromParts(mac, {data});
+}
+
+util::StatusOr<std::string> AesCmacBoringSsl::ComputeMacFromParts(
+    absl::Span<const absl::string_view> data_parts) const {
+  uint8_t mac[kMaxTagSize];
+  util::Status status = ComputeFullMac(data_parts, mac);
+  if (!status.ok()) {
+    return status;
+  }
+  return std::string(reinterpret_cast<char*>(mac), tag_size_);
+}
+
+util::Status AesCmacBoringSsl::VerifyMacFromParts(
+    absl::string_view mac_value,
+    absl::Span<const absl::string_view> data_parts) const {
+  if (mac_value.size() != tag_size_) {
     return ToStatusF(absl::StatusCode::kInvalidArgument,
                      "Incorrect tag size: expected %d, found %d", tag_size_,
-                     mac.size());
+                     mac_value.size());
   }
-  util::StatusOr<std::string> computed_mac = ComputeMac(data);
-  if (!computed_mac.ok()) return computed_mac.status();
-  if (CRYPTO_memcmp(computed_mac->data(), mac.data(), tag_size_) != 0) {
+  uint8_t computed_mac[kMaxTagSize];
+  util::Status status = ComputeFullMac(data_parts, computed_mac);
+  if (!status.ok()) return status;
+  if (CRYPTO_memcmp(computed_mac, mac_value.data(), tag_size_) != 0) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "CMAC verification failed");
   }
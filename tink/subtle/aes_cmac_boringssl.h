@@ -17,13 +17,19 @@
 #ifndef TINK_SUBTLE_AES_CMAC_BORINGSSL_H_
 #define TINK_SUBTLE_AES_CMAC_BORINGSSL_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/cmac.h"
 #include "tink/internal/fips_utils.h"
+#include "tink/internal/ssl_unique_ptr.h"
 #include "tink/mac.h"
 #include "tink/util/secret_data.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -44,14 +50,32 @@ class AesCmacBoringSsl : public Mac {
   crypto::tink::util::Status VerifyMac(absl::string_view mac,
                                        absl::string_view data) const override;
 
+  // Feeds the parts to the CMAC one after the other, without concatenating
+  // them; see Mac::ComputeMacFromParts.
+  crypto::tink::util::StatusOr<std::string> ComputeMacFromParts(
+      absl::Span<const absl::string_view> data_parts) const override;
+
+  crypto::tink::util::Status VerifyMacFromParts(
+      absl::string_view mac_value,
+      absl::Span<const absl::string_view> data_parts) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kNotFips;
 
  private:
-  AesCmacBoringSsl(util::SecretData key, uint32_t tag_size)
-      : key_(std::move(key)), tag_size_(tag_size) {}
+  AesCmacBoringSsl(internal::SslUniquePtr<CMAC_CTX> keyed_context,
+                   uint32_t tag_size)
+      : keyed_context_(std::move(keyed_context)), tag_size_(tag_size) {}
+
+  // Computes the untruncated CMAC of the concatenation of 'data_parts' and
+  // writes it to 'mac', which must hold at least 16 bytes.
+  crypto::tink::util::Status ComputeFullMac(
+      absl::Span<const absl::string_view> data_parts, uint8_t* mac) const;
 
-  const util::SecretData key_;
+  // Context on which CMAC_Init ran once with the key. It is copied for every
+  // message, so that the AES key schedule and the CMAC subkeys are not
+  // recomputed, and is never modified after construction.
+  const internal::SslUniquePtr<CMAC_CTX> keyed_context_;
   const uint32_t tag_size_;
 };
 
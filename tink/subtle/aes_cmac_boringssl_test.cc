@@ -18,12 +18,15 @@
 
 #include <memory>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "tink/config/tink_fips.h"
 #include "tink/mac.h"
@@ -39,7 +42,9 @@ namespace subtle {
 namespace {
 
 using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::IsOkAndHolds;
 using ::crypto::tink::test::StatusIs;
+using ::testing::Each;
 using ::testing::Not;
 using ::testing::SizeIs;
 
@@ -201,6 +206,70 @@ TEST(AesCmacBoringSslTest, TruncationOrAdditionSmallTag) {
   }
 }
 
+// The keyed CMAC context is shared by all calls; check that concurrent calls
+// neither interfere with each other nor modify it.
+TEST(AesCmacBoringSslTest, ComputeAndVerifyFromParts) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  util::SecretData key =
+      util::SecretDataFromStringView(absl::HexStringToBytes(kKey256Hex));
+  util::StatusOr<std::unique_ptr<Mac>> cmac =
+      AesCmacBoringSsl::New(key, kTagSize);
+  ASSERT_THAT(cmac, IsOk());
+  util::StatusOr<std::string> expected_tag = (*cmac)->ComputeMac(kMessage);
+  ASSERT_THAT(expected_tag, IsOk());
+
+  // Split the message at every position, including at block boundaries.
+  for (int i = 0; i <= kMessage.size(); ++i) {
+    std::vector<absl::string_view> parts = {
+        kMessage.substr(0, i), absl::string_view(), kMessage.substr(i)};
+    EXPECT_THAT((*cmac)->ComputeMacFromParts(parts),
+                IsOkAndHolds(*expected_tag));
+    EXPECT_THAT((*cmac)->VerifyMacFromParts(*expected_tag, parts), IsOk());
+  }
+  std::vector<absl::string_view> other_parts = {kMessage, "!"};
+  EXPECT_THAT((*cmac)->VerifyMacFromParts(*expected_tag, other_parts),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(AesCmacBoringSslTest, ConcurrentComputeAndVerify) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  util::SecretData key =
+      util::SecretDataFromStringView(absl::HexStringToBytes(kKey256Hex));
+  util::StatusOr<std::unique_ptr<Mac>> cmac =
+      AesCmacBoringSsl::New(key, kTagSize);
+  ASSERT_THAT(cmac, IsOk());
+  util::StatusOr<std::string> expected_tag = (*cmac)->ComputeMac(kMessage);
+  ASSERT_THAT(expected_tag, IsOk());
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumMessages = 50;
+  std::vector<int> failures(kNumThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t] {
+      const std::string message = absl::StrCat(kMessage, t);
+      for (int i = 0; i < kNumMessages; ++i) {
+        util::StatusOr<std::string> tag = (*cmac)->ComputeMac(message);
+        if (!tag.ok() || !(*cmac)->VerifyMac(*tag, message).ok() ||
+            (*cmac)->VerifyMac(*tag, kMessage).ok()) {
+          ++failures[t];
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_THAT(failures, Each(0));
+  EXPECT_THAT((*cmac)->ComputeMac(kMessage), IsOkAndHolds(*expected_tag));
+}
+
 TEST(AesCmacBoringSslTest, InvalidKeySizes) {
   if (IsFipsModeEnabled()) {
     GTEST_SKIP() << "Not supported in FIPS-only mode";
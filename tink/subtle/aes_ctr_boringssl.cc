@@ -16,12 +16,16 @@
 
 #include "tink/subtle/aes_ctr_boringssl.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
 #include "tink/internal/aes_util.h"
 #include "tink/internal/ssl_unique_ptr.h"
@@ -34,6 +38,14 @@ namespace crypto {
 namespace tink {
 namespace subtle {
 
+namespace {
+
+util::Status IgnoreCiphertext(absl::string_view ciphertext) {
+  return util::OkStatus();
+}
+
+}  // namespace
+
 util::StatusOr<std::unique_ptr<IndCpaCipher>> AesCtrBoringSsl::New(
     util::SecretData key, int iv_size) {
   auto status = internal::CheckFipsCompatibility<AesCtrBoringSsl>();
@@ -54,51 +66,102 @@ util::StatusOr<std::unique_ptr<IndCpaCipher>> AesCtrBoringSsl::New(
 
 util::StatusOr<std::string> AesCtrBoringSsl::Encrypt(
     absl::string_view plaintext) const {
+  std::string ciphertext;
+  ResizeStringUninitialized(&ciphertext, CiphertextSize(plaintext.size()));
+  util::Status status =
+      EncryptToBuffer(plaintext, absl::MakeSpan(&ciphertext[0],
+                                                ciphertext.size()));
+  if (!status.ok()) {
+    return status;
+  }
+  return ciphertext;
+}
+
+util::Status AesCtrBoringSsl::EncryptToBuffer(
+    absl::string_view plaintext, absl::Span<char> ciphertext_buffer) const {
+  return EncryptToBufferAndVisit(plaintext, ciphertext_buffer,
+                                 IgnoreCiphertext);
+}
+
+util::Status AesCtrBoringSsl::EncryptToBufferAndVisit(
+    absl::string_view plaintext, absl::Span<char> ciphertext_buffer,
+    CiphertextVisitor visit_ciphertext) const {
   // BoringSSL expects a non-null pointer for plaintext, regardless of whether
   // the size is 0.
   plaintext = internal::EnsureStringNonNull(plaintext);
 
+  if (static_cast<int64_t>(ciphertext_buffer.size()) !=
+      CiphertextSize(plaintext.size())) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "invalid ciphertext buffer size");
+  }
+  if (internal::BuffersOverlap(
+          plaintext, absl::string_view(ciphertext_buffer.data(),
+                                       ciphertext_buffer.size()))) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "plaintext and ciphertext buffer overlap");
+  }
+
   internal::SslUniquePtr<EVP_CIPHER_CTX> ctx(EVP_CIPHER_CTX_new());
   if (ctx.get() == nullptr) {
     return util::Status(absl::StatusCode::kInternal,
                         "could not initialize EVP_CIPHER_CTX");
   }
-  std::string ciphertext = Random::GetRandomBytes(iv_size_);
+  absl::Span<char> iv = ciphertext_buffer.subspan(0, iv_size_);
+  util::Status status = Random::GetRandomNonceBytes(iv);
+  if (!status.ok()) {
+    return status;
+  }
+  status = visit_ciphertext(absl::string_view(iv.data(), iv.size()));
+  if (!status.ok()) {
+    return status;
+  }
   // OpenSSL expects that the IV must be a full block. We pad with zeros.
-  std::string iv_block = ciphertext;
+  uint8_t iv_block[kBlockSize] = {0};
   // Note that kBlockSize >= iv_size_ is checked in the factory method.
-  // We explicitly add the '\0' argument to stress that we need to initialize
-  // the new memory.
-  iv_block.resize(kBlockSize, '\0');
+  std::copy_n(iv.data(), iv_size_, iv_block);
 
-  int ret =
-      EVP_EncryptInit_ex(ctx.get(), cipher_, nullptr /* engine */, key_.data(),
-                         reinterpret_cast<const uint8_t*>(&iv_block[0]));
+  int ret = EVP_EncryptInit_ex(ctx.get(), cipher_, nullptr /* engine */,
+                               key_.data(), iv_block);
   if (ret != 1) {
     return util::Status(absl::StatusCode::kInternal,
                         "could not initialize ctx");
   }
-  ResizeStringUninitialized(&ciphertext, iv_size_ + plaintext.size());
-  int len;
-  ret = EVP_EncryptUpdate(
-      ctx.get(), reinterpret_cast<uint8_t*>(&ciphertext[iv_size_]), &len,
-      reinterpret_cast<const uint8_t*>(plaintext.data()), plaintext.size());
-  if (ret != 1) {
-    return util::Status(absl::StatusCode::kInternal, "encryption failed");
-  }
-  if (len != plaintext.size()) {
-    return util::Status(absl::StatusCode::kInternal,
-                        "incorrect ciphertext size");
-  }
-  return ciphertext;
+  // The ciphertext is visited piece by piece while it is still in cache.
+  return internal::AesCtrCryptInterleaved(
+      ctx.get(), plaintext, ciphertext_buffer.subspan(iv_size_),
+      visit_ciphertext);
 }
 
 util::StatusOr<std::string> AesCtrBoringSsl::Decrypt(
     absl::string_view ciphertext) const {
-  if (ciphertext.size() < iv_size_) {
+  std::string plaintext;
+  ResizeStringUninitialized(&plaintext, PlaintextSize(ciphertext.size()));
+  util::Status status = DecryptToBuffer(
+      ciphertext, absl::MakeSpan(&plaintext[0], plaintext.size()));
+  if (!status.ok()) {
+    return status;
+  }
+  return plaintext;
+}
+
+util::Status AesCtrBoringSsl::DecryptToBuffer(
+    absl::string_view ciphertext, absl::Span<char> plaintext_buffer) const {
+  if (static_cast<int64_t>(ciphertext.size()) < iv_size_) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "ciphertext too short");
   }
+  if (static_cast<int64_t>(plaintext_buffer.size()) !=
+      PlaintextSize(ciphertext.size())) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "invalid plaintext buffer size");
+  }
+  if (internal::BuffersOverlap(
+          ciphertext, absl::string_view(plaintext_buffer.data(),
+                                        plaintext_buffer.size()))) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "ciphertext and plaintext buffer overlap");
+  }
 
   internal::SslUniquePtr<EVP_CIPHER_CTX> ctx(EVP_CIPHER_CTX_new());
   if (ctx.get() == nullptr) {
@@ -106,35 +169,19 @@ util::StatusOr<std::string> AesCtrBoringSsl::Decrypt(
                         "could not initialize EVP_CIPHER_CTX");
   }
 
-  // Initialise key and IV
-  std::string iv_block = std::string(ciphertext.substr(0, iv_size_));
-  iv_block.resize(kBlockSize, '\0');
+  absl::string_view iv = ciphertext.substr(0, iv_size_);
+  // OpenSSL expects that the IV must be a full block. We pad with zeros.
+  uint8_t iv_block[kBlockSize] = {0};
+  std::copy_n(iv.data(), iv_size_, iv_block);
   int ret = EVP_DecryptInit_ex(ctx.get(), cipher_, nullptr /* engine */,
-                               reinterpret_cast<const uint8_t*>(key_.data()),
-                               reinterpret_cast<const uint8_t*>(&iv_block[0]));
+                               key_.data(), iv_block);
   if (ret != 1) {
     return util::Status(absl::StatusCode::kInternal,
                         "could not initialize key or iv");
   }
-
-  size_t plaintext_size = ciphertext.size() - iv_size_;
-  std::string plaintext;
-  ResizeStringUninitialized(&plaintext, plaintext_size);
-  size_t read = iv_size_;
-  int len;
-  ret = EVP_DecryptUpdate(
-      ctx.get(), reinterpret_cast<uint8_t*>(&plaintext[0]), &len,
-      reinterpret_cast<const uint8_t*>(&ciphertext.data()[read]),
-      plaintext_size);
-  if (ret != 1) {
-    return util::Status(absl::StatusCode::kInternal, "decryption failed");
-  }
-
-  if (len != plaintext_size) {
-    return util::Status(absl::StatusCode::kInternal,
-                        "incorrect plaintext size");
-  }
-  return plaintext;
+  return internal::AesCtrCryptInterleaved(
+      ctx.get(), ciphertext.substr(iv_size_), plaintext_buffer,
+      IgnoreCiphertext);
 }
 
 }  // namespace subtle
@@ -17,14 +17,19 @@
 #ifndef TINK_SUBTLE_AES_CTR_BORINGSSL_H_
 #define TINK_SUBTLE_AES_CTR_BORINGSSL_H_
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/subtle/ind_cpa_cipher.h"
 #include "tink/util/secret_data.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -42,6 +47,26 @@ class AesCtrBoringSsl : public IndCpaCipher {
   crypto::tink::util::StatusOr<std::string> Decrypt(
       absl::string_view ciphertext) const override;
 
+  int64_t CiphertextSize(int64_t plaintext_size) const override {
+    return iv_size_ + plaintext_size;
+  }
+
+  crypto::tink::util::Status EncryptToBuffer(
+      absl::string_view plaintext,
+      absl::Span<char> ciphertext_buffer) const override;
+
+  crypto::tink::util::Status EncryptToBufferAndVisit(
+      absl::string_view plaintext, absl::Span<char> ciphertext_buffer,
+      CiphertextVisitor visit_ciphertext) const override;
+
+  int64_t PlaintextSize(int64_t ciphertext_size) const override {
+    return std::max<int64_t>(ciphertext_size - iv_size_, 0);
+  }
+
+  crypto::tink::util::Status DecryptToBuffer(
+      absl::string_view ciphertext,
+      absl::Span<char> plaintext_buffer) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kRequiresBoringCrypto;
 
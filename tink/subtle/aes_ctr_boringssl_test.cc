@@ -16,12 +16,14 @@
 
 #include "tink/subtle/aes_ctr_boringssl.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/subtle/random.h"
 #include "tink/util/secret_data.h"
@@ -159,6 +161,77 @@ TEST(AesCtrBoringSslTest, TestMultipleEncrypt) {
   EXPECT_NE(ct1.value(), ct2.value());
 }
 
+TEST(AesCtrBoringSslTest, TestEncryptToBuffer) {
+  if (internal::IsFipsModeEnabled() && !internal::IsFipsEnabledInSsl()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = Random::GetRandomKeyBytes(16);
+  int iv_size = 12;
+  util::StatusOr<std::unique_ptr<IndCpaCipher>> cipher =
+      AesCtrBoringSsl::New(key, iv_size);
+  ASSERT_THAT(cipher, IsOk());
+  for (int i = 0; i < 64; i++) {
+    std::string message = Random::GetRandomBytes(i);
+    std::string ciphertext((*cipher)->CiphertextSize(message.size()), '\0');
+    ASSERT_EQ(ciphertext.size(), message.size() + iv_size);
+    ASSERT_THAT((*cipher)->EncryptToBuffer(message, absl::MakeSpan(ciphertext)),
+                IsOk());
+    util::StatusOr<std::string> plaintext = (*cipher)->Decrypt(ciphertext);
+    ASSERT_THAT(plaintext, IsOk());
+    EXPECT_EQ(*plaintext, message);
+  }
+
+  std::string message = "Some data to encrypt.";
+  std::string ciphertext((*cipher)->CiphertextSize(message.size()) + 1, '\0');
+  EXPECT_THAT((*cipher)->EncryptToBuffer(message, absl::MakeSpan(ciphertext)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  ciphertext.resize(ciphertext.size() - 2);
+  EXPECT_THAT((*cipher)->EncryptToBuffer(message, absl::MakeSpan(ciphertext)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(AesCtrBoringSslTest, TestDecryptToBuffer) {
+  if (internal::IsFipsModeEnabled() && !internal::IsFipsEnabledInSsl()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = Random::GetRandomKeyBytes(16);
+  int iv_size = 12;
+  util::StatusOr<std::unique_ptr<IndCpaCipher>> cipher =
+      AesCtrBoringSsl::New(key, iv_size);
+  ASSERT_THAT(cipher, IsOk());
+  for (int i = 0; i < 64; i++) {
+    std::string message = Random::GetRandomBytes(i);
+    util::StatusOr<std::string> ciphertext = (*cipher)->Encrypt(message);
+    ASSERT_THAT(ciphertext, IsOk());
+    std::string plaintext((*cipher)->PlaintextSize(ciphertext->size()), '\0');
+    ASSERT_EQ(plaintext.size(), message.size());
+    ASSERT_THAT(
+        (*cipher)->DecryptToBuffer(*ciphertext, absl::MakeSpan(plaintext)),
+        IsOk());
+    EXPECT_EQ(plaintext, message);
+  }
+
+  util::StatusOr<std::string> ciphertext =
+      (*cipher)->Encrypt("Some data to encrypt.");
+  ASSERT_THAT(ciphertext, IsOk());
+  std::string plaintext((*cipher)->PlaintextSize(ciphertext->size()) + 1,
+                        '\0');
+  EXPECT_THAT(
+      (*cipher)->DecryptToBuffer(*ciphertext, absl::MakeSpan(plaintext)),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+  plaintext.resize(plaintext.size() - 2);
+  EXPECT_THAT(
+      (*cipher)->DecryptToBuffer(*ciphertext, absl::MakeSpan(plaintext)),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT((*cipher)->DecryptToBuffer(ciphertext->substr(0, iv_size - 1),
+                                         absl::Span<char>()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(AesCtrBoringSslTest, TestFipsOnly) {
   if (internal::IsFipsModeEnabled() && !internal::IsFipsEnabledInSsl()) {
     GTEST_SKIP()
@@ -27,14 +27,17 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/crypto.h"
 #include "openssl/err.h"
 #include "openssl/evp.h"
 #include "tink/internal/aes_util.h"
 #include "tink/internal/ssl_unique_ptr.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/hkdf.h"
-#include "tink/subtle/hmac_boringssl.h"
+#include "tink/subtle/mac/stateful_mac.h"
 #include "tink/subtle/random.h"
+#include "tink/subtle/stateful_hmac_boringssl.h"
 #include "tink/subtle/stream_segment_decrypter.h"
 #include "tink/subtle/stream_segment_encrypter.h"
 #include "tink/subtle/subtle_util.h"
@@ -74,6 +77,62 @@ static util::Status DeriveKeys(const util::SecretData& ikm, HashType hkdf_algo,
   return util::OkStatus();
 }
 
+// Returns an AES-CTR context with `key`, starting at the counter block
+// `nonce`.
+static util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> NewSegmentContext(
+    const EVP_CIPHER* cipher, const util::SecretData& key,
+    absl::string_view nonce, bool encryption) {
+  internal::SslUniquePtr<EVP_CIPHER_CTX> ctx(EVP_CIPHER_CTX_new());
+  if (ctx == nullptr) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "could not initialize EVP_CIPHER_CTX");
+  }
+  if (EVP_CipherInit_ex(ctx.get(), cipher, nullptr /* engine */,
+                        reinterpret_cast<const uint8_t*>(key.data()),
+                        reinterpret_cast<const uint8_t*>(nonce.data()),
+                        encryption ? 1 : 0) != 1) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "could not initialize ctx");
+  }
+  return std::move(ctx);
+}
+
+// Encrypts `plaintext` into `ciphertext` and returns the tag over the nonce and
+// the ciphertext. Each piece of ciphertext is MACed right after it is written,
+// while it is still in cache.
+static util::StatusOr<std::string> EncryptAndMacSegment(
+    const EVP_CIPHER* cipher, const util::SecretData& key,
+    absl::string_view nonce, const StatefulMacFactory& mac_factory,
+    absl::string_view plaintext, absl::Span<char> ciphertext) {
+  util::StatusOr<std::unique_ptr<StatefulMac>> mac = mac_factory.Create();
+  if (!mac.ok()) return mac.status();
+  util::Status status = (*mac)->Update(nonce);
+  if (!status.ok()) return status;
+  util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> ctx =
+      NewSegmentContext(cipher, key, nonce, /*encryption=*/true);
+  if (!ctx.ok()) return ctx.status();
+  status = internal::AesCtrCryptInterleaved(
+      ctx->get(), plaintext, ciphertext,
+      [&mac](absl::string_view ciphertext_piece) {
+        return (*mac)->Update(ciphertext_piece);
+      });
+  if (!status.ok()) return status;
+  return (*mac)->Finalize();
+}
+
+// Returns the tag over the nonce and `ciphertext`.
+static util::StatusOr<std::string> MacSegment(
+    absl::string_view nonce, const StatefulMacFactory& mac_factory,
+    absl::string_view ciphertext) {
+  util::StatusOr<std::unique_ptr<StatefulMac>> mac = mac_factory.Create();
+  if (!mac.ok()) return mac.status();
+  util::Status status = (*mac)->Update(nonce);
+  if (!status.ok()) return status;
+  status = (*mac)->Update(ciphertext);
+  if (!status.ok()) return status;
+  return (*mac)->Finalize();
+}
+
 static util::Status Validate(const AesCtrHmacStreaming::Params& params) {
   if (params.ikm.size() < std::max(16, params.key_size)) {
     return util::Status(absl::StatusCode::kInvalidArgument,
@@ -160,7 +219,7 @@ AesCtrHmacStreamSegmentEncrypter::New(const AesCtrHmacStreaming::Params& params,
 
   std::string salt = Random::GetRandomBytes(params.key_size);
   std::string nonce_prefix =
-      Random::GetRandomBytes(AesCtrHmacStreaming::kNoncePrefixSizeInBytes);
+      Random::GetRandomNonceBytes(AesCtrHmacStreaming::kNoncePrefixSizeInBytes);
   std::string header = MakeHeader(salt, nonce_prefix);
 
   util::SecretData key_value;
@@ -175,10 +234,8 @@ AesCtrHmacStreamSegmentEncrypter::New(const AesCtrHmacStreaming::Params& params,
     return cipher.status();
   }
 
-  auto hmac_result = HmacBoringSsl::New(params.tag_algo, params.tag_size,
-                                        std::move(hmac_key_value));
-  if (!hmac_result.ok()) return hmac_result.status();
-  auto mac = std::move(hmac_result.value());
+  auto mac = absl::make_unique<StatefulHmacBoringSslFactory>(
+      params.tag_algo, params.tag_size, hmac_key_value);
 
   return {absl::WrapUnique(new AesCtrHmacStreamSegmentEncrypter(
       std::move(key_value), header, nonce_prefix,
@@ -197,53 +254,51 @@ util::Status AesCtrHmacStreamSegmentEncrypter::EncryptSegment(
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "ciphertext_buffer must be non-null");
   }
-  if (get_segment_number() > std::numeric_limits<uint32_t>::max() ||
-      (get_segment_number() == std::numeric_limits<uint32_t>::max() &&
-       !is_last_segment)) {
-    return util::Status(absl::StatusCode::kInvalidArgument,
-                        "too many segments");
-  }
-
-  int ct_size = plaintext.size() + tag_size_;
-  ciphertext_buffer->resize(ct_size);
+  ciphertext_buffer->resize(plaintext.size() + tag_size_);
+  return EncryptSegmentInto(plaintext, is_last_segment,
+                            absl::MakeSpan(*ciphertext_buffer));
+}
 
-  std::string nonce =
-      NonceForSegment(nonce_prefix_, segment_number_, is_last_segment);
+util::Status AesCtrHmacStreamSegmentEncrypter::EncryptSegmentInto(
+    absl::Span<const uint8_t> plaintext, bool is_last_segment,
+    absl::Span<uint8_t> ciphertext) {
+  util::Status status = EncryptSegmentAt(plaintext, get_segment_number(),
+                                         is_last_segment, ciphertext);
+  if (!status.ok()) return status;
+  IncSegmentNumber();
+  return util::OkStatus();
+}
 
-  // Encrypt.
-  internal::SslUniquePtr<EVP_CIPHER_CTX> ctx(EVP_CIPHER_CTX_new());
-  if (ctx == nullptr) {
-    return util::Status(absl::StatusCode::kInternal,
-                        "could not initialize EVP_CIPHER_CTX");
-  }
-  if (EVP_EncryptInit_ex(ctx.get(), cipher_, nullptr /* engine */,
-                         reinterpret_cast<const uint8_t*>(key_value_.data()),
-                         reinterpret_cast<const uint8_t*>(nonce.data())) != 1) {
-    return util::Status(absl::StatusCode::kInternal,
-                        "could not initialize ctx");
+util::Status AesCtrHmacStreamSegmentEncrypter::EncryptSegmentAt(
+    absl::Span<const uint8_t> plaintext, int64_t segment_number,
+    bool is_last_segment, absl::Span<uint8_t> ciphertext) const {
+  if (static_cast<int64_t>(plaintext.size()) > get_plaintext_segment_size()) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "plaintext too long");
   }
-
-  int out_len;
-  if (EVP_EncryptUpdate(ctx.get(), ciphertext_buffer->data(), &out_len,
-                        plaintext.data(), plaintext.size()) != 1) {
-    return util::Status(absl::StatusCode::kInternal, "encryption failed");
+  if (ciphertext.size() != plaintext.size() + tag_size_) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "wrong ciphertext size");
   }
-  if (out_len != plaintext.size()) {
-    return util::Status(absl::StatusCode::kInternal,
-                        "incorrect ciphertext size");
+  if (segment_number < 0 ||
+      segment_number > std::numeric_limits<uint32_t>::max() ||
+      (segment_number == std::numeric_limits<uint32_t>::max() &&
+       !is_last_segment)) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "too many segments");
   }
 
-  // Add MAC tag.
-  absl::string_view ciphertext_string(
-      reinterpret_cast<const char*>(ciphertext_buffer->data()),
-      plaintext.size());
-  auto tag_result = mac_->ComputeMac(absl::StrCat(nonce, ciphertext_string));
-  if (!tag_result.ok()) return tag_result.status();
-  std::string tag = tag_result.value();
-  memcpy(ciphertext_buffer->data() + plaintext.size(),
-         reinterpret_cast<const uint8_t*>(tag.data()), tag_size_);
+  std::string nonce =
+      NonceForSegment(nonce_prefix_, segment_number, is_last_segment);
 
-  IncSegmentNumber();
+  util::StatusOr<std::string> tag = EncryptAndMacSegment(
+      cipher_, key_value_, nonce, *mac_factory_,
+      absl::string_view(reinterpret_cast<const char*>(plaintext.data()),
+                        plaintext.size()),
+      absl::MakeSpan(reinterpret_cast<char*>(ciphertext.data()),
+                     plaintext.size()));
+  if (!tag.ok()) return tag.status();
+  memcpy(ciphertext.data() + plaintext.size(), tag->data(), tag_size_);
   return util::OkStatus();
 }
 
@@ -295,10 +350,8 @@ util::Status AesCtrHmacStreamSegmentDecrypter::Init(
 
   cipher_ = *cipher;
 
-  auto hmac_result =
-      HmacBoringSsl::New(tag_algo_, tag_size_, std::move(hmac_key_value));
-  if (!hmac_result.ok()) return hmac_result.status();
-  mac_ = std::move(hmac_result.value());
+  mac_factory_ = absl::make_unique<StatefulHmacBoringSslFactory>(
+      tag_algo_, tag_size_, hmac_key_value);
 
   is_initialized_ = true;
   return util::OkStatus();
@@ -307,67 +360,77 @@ util::Status AesCtrHmacStreamSegmentDecrypter::Init(
 util::Status AesCtrHmacStreamSegmentDecrypter::DecryptSegment(
     const std::vector<uint8_t>& ciphertext, int64_t segment_number,
     bool is_last_segment, std::vector<uint8_t>* plaintext_buffer) {
+  util::Status status = CheckCiphertextSegment(ciphertext.size());
+  if (!status.ok()) return status;
+  if (plaintext_buffer == nullptr) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "plaintext_buffer must be non-null");
+  }
+  plaintext_buffer->resize(ciphertext.size() - tag_size_);
+  return DecryptSegmentInto(ciphertext, segment_number, is_last_segment,
+                            absl::MakeSpan(*plaintext_buffer));
+}
+
+util::Status AesCtrHmacStreamSegmentDecrypter::CheckCiphertextSegment(
+    size_t ciphertext_size) const {
   if (!is_initialized_) {
     return util::Status(absl::StatusCode::kFailedPrecondition,
                         "decrypter not initialized");
   }
-  if (ciphertext.size() > get_ciphertext_segment_size()) {
+  if (ciphertext_size > get_ciphertext_segment_size()) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "ciphertext too long");
   }
-  if (ciphertext.size() < tag_size_) {
+  if (ciphertext_size < tag_size_) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "ciphertext too short");
   }
-  if (plaintext_buffer == nullptr) {
+  return util::OkStatus();
+}
+
+util::Status AesCtrHmacStreamSegmentDecrypter::DecryptSegmentInto(
+    absl::Span<const uint8_t> ciphertext, int64_t segment_number,
+    bool is_last_segment, absl::Span<uint8_t> plaintext) const {
+  util::Status status = CheckCiphertextSegment(ciphertext.size());
+  if (!status.ok()) return status;
+  int pt_size = ciphertext.size() - tag_size_;
+  if (static_cast<int64_t>(plaintext.size()) != pt_size) {
     return util::Status(absl::StatusCode::kInvalidArgument,
-                        "plaintext_buffer must be non-null");
+                        "wrong plaintext size");
   }
-  if (segment_number > std::numeric_limits<uint32_t>::max() ||
+  if (segment_number < 0 ||
+      segment_number > std::numeric_limits<uint32_t>::max() ||
       (segment_number == std::numeric_limits<uint32_t>::max() &&
        !is_last_segment)) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "too many segments");
   }
 
-  int pt_size = ciphertext.size() - tag_size_;
-  plaintext_buffer->resize(pt_size);
-
   std::string nonce =
       NonceForSegment(nonce_prefix_, segment_number, is_last_segment);
 
-  // Verify MAC tag.
-  absl::string_view tag(
-      reinterpret_cast<const char*>(ciphertext.data() + pt_size), tag_size_);
-  absl::string_view ciphertext_string(
+  absl::string_view raw_ciphertext(
       reinterpret_cast<const char*>(ciphertext.data()), pt_size);
-  auto status = mac_->VerifyMac(tag, absl::StrCat(nonce, ciphertext_string));
-  if (!status.ok()) return status;
 
-  // Decrypt.
-  internal::SslUniquePtr<EVP_CIPHER_CTX> ctx(EVP_CIPHER_CTX_new());
-  if (ctx.get() == nullptr) {
-    return util::Status(absl::StatusCode::kInternal,
-                        "could not initialize EVP_CIPHER_CTX");
-  }
-  if (EVP_DecryptInit_ex(ctx.get(), cipher_, nullptr /* engine */,
-                         reinterpret_cast<const uint8_t*>(key_value_.data()),
-                         reinterpret_cast<const uint8_t*>(nonce.data())) != 1) {
-    return util::Status(absl::StatusCode::kInternal,
-                        "could not initialize ctx");
-  }
-
-  int out_len;
-  if (EVP_DecryptUpdate(ctx.get(), plaintext_buffer->data(), &out_len,
-                        ciphertext.data(), pt_size) != 1) {
-    return util::Status(absl::StatusCode::kInternal, "decryption failed");
-  }
-  if (out_len != pt_size) {
-    return util::Status(absl::StatusCode::kInternal,
-                        "incorrect plaintext size");
+  // Verify MAC tag before decrypting, so that no plaintext of a forged
+  // segment is ever written.
+  util::StatusOr<std::string> expected_tag =
+      MacSegment(nonce, *mac_factory_, raw_ciphertext);
+  if (!expected_tag.ok()) return expected_tag.status();
+  if (CRYPTO_memcmp(expected_tag->data(), ciphertext.data() + pt_size,
+                    tag_size_) != 0) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "verification failed");
   }
 
-  return util::OkStatus();
+  // Decrypt.
+  util::StatusOr<internal::SslUniquePtr<EVP_CIPHER_CTX>> ctx =
+      NewSegmentContext(cipher_, key_value_, nonce, /*encryption=*/false);
+  if (!ctx.ok()) return ctx.status();
+  return internal::AesCtrCryptInterleaved(
+      ctx->get(), raw_ciphertext,
+      absl::MakeSpan(reinterpret_cast<char*>(plaintext.data()), pt_size),
+      [](absl::string_view) { return util::OkStatus(); });
 }
 
 }  // namespace subtle
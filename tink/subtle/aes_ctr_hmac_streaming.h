@@ -23,10 +23,11 @@
 #include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
 #include "tink/internal/fips_utils.h"
-#include "tink/mac.h"
 #include "tink/subtle/common_enums.h"
+#include "tink/subtle/mac/stateful_mac.h"
 #include "tink/subtle/nonce_based_streaming_aead.h"
 #include "tink/subtle/stream_segment_decrypter.h"
 #include "tink/subtle/stream_segment_encrypter.h"
@@ -117,6 +118,14 @@ class AesCtrHmacStreamSegmentEncrypter : public StreamSegmentEncrypter {
                               bool is_last_segment,
                               std::vector<uint8_t>* ciphertext_buffer) override;
 
+  util::Status EncryptSegmentAt(absl::Span<const uint8_t> plaintext,
+                                int64_t segment_number, bool is_last_segment,
+                                absl::Span<uint8_t> ciphertext) const override;
+
+  util::Status EncryptSegmentInto(absl::Span<const uint8_t> plaintext,
+                                  bool is_last_segment,
+                                  absl::Span<uint8_t> ciphertext) override;
+
   const std::vector<uint8_t>& get_header() const override { return header_; }
   int64_t get_segment_number() const override { return segment_number_; }
   int get_plaintext_segment_size() const override {
@@ -137,7 +146,7 @@ class AesCtrHmacStreamSegmentEncrypter : public StreamSegmentEncrypter {
                                    int ciphertext_segment_size,
                                    int ciphertext_offset, int tag_size,
                                    const EVP_CIPHER* cipher,
-                                   std::unique_ptr<Mac> mac)
+                                   std::unique_ptr<StatefulMacFactory> mac)
       : key_value_(std::move(key_value)),
         header_(header.begin(), header.end()),
         nonce_prefix_(nonce_prefix),
@@ -145,7 +154,7 @@ class AesCtrHmacStreamSegmentEncrypter : public StreamSegmentEncrypter {
         ciphertext_offset_(ciphertext_offset),
         tag_size_(tag_size),
         cipher_(cipher),
-        mac_(std::move(mac)),
+        mac_factory_(std::move(mac)),
         segment_number_(0) {}
 
   const util::SecretData key_value_;
@@ -155,7 +164,7 @@ class AesCtrHmacStreamSegmentEncrypter : public StreamSegmentEncrypter {
   const int ciphertext_offset_;
   const int tag_size_;
   const EVP_CIPHER* cipher_;
-  const std::unique_ptr<Mac> mac_;
+  const std::unique_ptr<StatefulMacFactory> mac_factory_;
   int64_t segment_number_;
 };
 
@@ -173,6 +182,10 @@ class AesCtrHmacStreamSegmentDecrypter : public StreamSegmentDecrypter {
                               int64_t segment_number, bool is_last_segment,
                               std::vector<uint8_t>* plaintext_buffer) override;
 
+  util::Status DecryptSegmentInto(absl::Span<const uint8_t> ciphertext,
+                                  int64_t segment_number, bool is_last_segment,
+                                  absl::Span<uint8_t> plaintext) const override;
+
   int get_header_size() const override {
     return 1 + key_size_ + AesCtrHmacStreaming::kNoncePrefixSizeInBytes;
   }
@@ -201,6 +214,10 @@ class AesCtrHmacStreamSegmentDecrypter : public StreamSegmentDecrypter {
         tag_algo_(tag_algo),
         tag_size_(tag_size) {}
 
+  // Checks that this decrypter is initialized and that 'ciphertext_size' is
+  // a valid size of a ciphertext segment.
+  util::Status CheckCiphertextSegment(size_t ciphertext_size) const;
+
   // Parameters set upon decrypter creation.
   const util::SecretData ikm_;
   const HashType hkdf_algo_;
@@ -216,7 +233,7 @@ class AesCtrHmacStreamSegmentDecrypter : public StreamSegmentDecrypter {
   util::SecretData key_value_;
   std::string nonce_prefix_;
   const EVP_CIPHER* cipher_;
-  std::unique_ptr<Mac> mac_;
+  std::unique_ptr<StatefulMacFactory> mac_factory_;
 };
 
 }  // namespace subtle
@@ -28,6 +28,7 @@
 #include "absl/status/statusor.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "tink/config/tink_fips.h"
 #include "tink/internal/test_random_access_stream.h"
 #include "tink/random_access_stream.h"
@@ -388,6 +389,110 @@ TEST(AesCtrHmacStreamSegmentDecrypterTest, DecryptNullPtBuffer) {
                        HasSubstr("must be non-null")));
 }
 
+// Segments larger than the chunks in which AES-CTR and HMAC are interleaved.
+TEST(AesCtrHmacStreamSegmentDecrypterTest, LargeSegmentRoundTripAndTamper) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  AesCtrHmacStreaming::Params params = ValidParams();
+  params.ciphertext_segment_size = 3 * 4096 + 100;
+  std::string associated_data = "associated data";
+
+  auto enc_result =
+      AesCtrHmacStreamSegmentEncrypter::New(params, associated_data);
+  ASSERT_THAT(enc_result, IsOk());
+  auto enc = std::move(enc_result.value());
+  auto dec_result =
+      AesCtrHmacStreamSegmentDecrypter::New(params, associated_data);
+  ASSERT_THAT(dec_result, IsOk());
+  auto dec = std::move(dec_result.value());
+  ASSERT_THAT(dec->Init(enc->get_header()), IsOk());
+
+  std::string plaintext_string =
+      Random::GetRandomBytes(enc->get_plaintext_segment_size());
+  std::vector<uint8_t> plaintext(plaintext_string.begin(),
+                                 plaintext_string.end());
+  std::vector<uint8_t> ciphertext;
+  ASSERT_THAT(enc->EncryptSegment(plaintext, /*is_last_segment=*/true,
+                                  &ciphertext),
+              IsOk());
+  std::vector<uint8_t> decrypted;
+  ASSERT_THAT(dec->DecryptSegment(ciphertext, /*segment_number=*/0,
+                                  /*is_last_segment=*/true, &decrypted),
+              IsOk());
+  EXPECT_EQ(decrypted, plaintext);
+
+  // A modified segment fails before any of it is decrypted.
+  ciphertext[ciphertext.size() / 2] ^= 1;
+  std::vector<uint8_t> forged_decrypted;
+  EXPECT_THAT(dec->DecryptSegment(ciphertext, /*segment_number=*/0,
+                                  /*is_last_segment=*/true, &forged_decrypted),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(forged_decrypted,
+            std::vector<uint8_t>(forged_decrypted.size(), 0));
+}
+
+TEST(AesCtrHmacStreamSegmentDecrypterTest, SpanRoundTripAndTamper) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  AesCtrHmacStreaming::Params params = ValidParams();
+  std::string associated_data = "associated data";
+
+  auto enc_result =
+      AesCtrHmacStreamSegmentEncrypter::New(params, associated_data);
+  ASSERT_THAT(enc_result, IsOk());
+  auto enc = std::move(enc_result.value());
+  auto dec_result =
+      AesCtrHmacStreamSegmentDecrypter::New(params, associated_data);
+  ASSERT_THAT(dec_result, IsOk());
+  auto dec = std::move(dec_result.value());
+  ASSERT_THAT(dec->Init(enc->get_header()), IsOk());
+
+  int tag_size = params.tag_size;
+  std::string plaintext_string = Random::GetRandomBytes(100);
+  std::vector<uint8_t> plaintext(plaintext_string.begin(),
+                                 plaintext_string.end());
+  std::vector<uint8_t> ciphertext(plaintext.size() + tag_size);
+  EXPECT_THAT(enc->EncryptSegmentInto(
+                  plaintext, /*is_last_segment=*/false,
+                  absl::MakeSpan(ciphertext.data(), ciphertext.size() - 1)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(enc->get_segment_number(), Eq(0));
+  ASSERT_THAT(enc->EncryptSegmentInto(plaintext, /*is_last_segment=*/false,
+                                      absl::MakeSpan(ciphertext)),
+              IsOk());
+  EXPECT_THAT(enc->get_segment_number(), Eq(1));
+
+  // The segment decrypts the same way as one encrypted into a vector.
+  std::vector<uint8_t> decrypted;
+  ASSERT_THAT(dec->DecryptSegment(ciphertext, /*segment_number=*/0,
+                                  /*is_last_segment=*/false, &decrypted),
+              IsOk());
+  EXPECT_EQ(decrypted, plaintext);
+  std::vector<uint8_t> decrypted_into(plaintext.size());
+  ASSERT_THAT(dec->DecryptSegmentInto(ciphertext, /*segment_number=*/0,
+                                      /*is_last_segment=*/false,
+                                      absl::MakeSpan(decrypted_into)),
+              IsOk());
+  EXPECT_EQ(decrypted_into, plaintext);
+  EXPECT_THAT(dec->DecryptSegmentInto(
+                  ciphertext, /*segment_number=*/0,
+                  /*is_last_segment=*/false,
+                  absl::MakeSpan(decrypted_into.data(), plaintext.size() - 1)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // A modified segment fails before any of it is decrypted, so the output is
+  // left untouched.
+  ciphertext[0] ^= 1;
+  std::vector<uint8_t> forged_decrypted(plaintext.size(), 0xaa);
+  EXPECT_THAT(dec->DecryptSegmentInto(ciphertext, /*segment_number=*/0,
+                                      /*is_last_segment=*/false,
+                                      absl::MakeSpan(forged_decrypted)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(forged_decrypted, std::vector<uint8_t>(plaintext.size(), 0xaa));
+}
+
 TEST(AesCtrHmacStreamingTest, Basic) {
   if (IsFipsModeEnabled()) {
     GTEST_SKIP() << "Not supported in FIPS-only mode";
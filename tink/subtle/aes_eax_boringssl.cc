@@ -17,6 +17,7 @@
 #include "tink/subtle/aes_eax_boringssl.h"
 
 #include <algorithm>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <string>
@@ -27,10 +28,13 @@
 #include "absl/base/config.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "openssl/err.h"
 #include "openssl/evp.h"
 #include "tink/aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/internal/aes_util.h"
 #include "tink/internal/util.h"
 #include "tink/subtle/random.h"
@@ -144,7 +148,7 @@ util::SecretData AesEaxBoringSsl::ComputeP() const {
   return rv;
 }
 
-crypto::tink::util::StatusOr<std::unique_ptr<Aead>> AesEaxBoringSsl::New(
+util::StatusOr<std::unique_ptr<AesEaxBoringSsl>> AesEaxBoringSsl::Create(
     const util::SecretData& key, size_t nonce_size_in_bytes) {
   auto status = internal::CheckFipsCompatibility<AesEaxBoringSsl>();
   if (!status.ok()) return status;
@@ -164,6 +168,21 @@ crypto::tink::util::StatusOr<std::unique_ptr<Aead>> AesEaxBoringSsl::New(
       new AesEaxBoringSsl(std::move(aeskey_or).value(), nonce_size_in_bytes))};
 }
 
+crypto::tink::util::StatusOr<std::unique_ptr<Aead>> AesEaxBoringSsl::New(
+    const util::SecretData& key, size_t nonce_size_in_bytes) {
+  auto aead = Create(key, nonce_size_in_bytes);
+  if (!aead.ok()) return aead.status();
+  return {std::unique_ptr<Aead>(*std::move(aead))};
+}
+
+crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>>
+AesEaxBoringSsl::NewZeroCopy(const util::SecretData& key,
+                             size_t nonce_size_in_bytes) {
+  auto aead = Create(key, nonce_size_in_bytes);
+  if (!aead.ok()) return aead.status();
+  return {std::unique_ptr<ZeroCopyAead>(*std::move(aead))};
+}
+
 AesEaxBoringSsl::Block AesEaxBoringSsl::Pad(
     absl::Span<const uint8_t> data) const {
   // TODO(bleichen): What are we using in tink to encode assertions?
@@ -229,33 +248,83 @@ util::Status AesEaxBoringSsl::CtrCrypt(const Block& N, absl::string_view in,
 
 crypto::tink::util::StatusOr<std::string> AesEaxBoringSsl::Encrypt(
     absl::string_view plaintext, absl::string_view associated_data) const {
+  std::string ciphertext;
+  ResizeStringUninitialized(&ciphertext, MaxEncryptionSize(plaintext.size()));
+  util::StatusOr<int64_t> written_bytes =
+      Encrypt(plaintext, associated_data, absl::MakeSpan(ciphertext));
+  if (!written_bytes.ok()) {
+    return written_bytes.status();
+  }
+  return ciphertext;
+}
+
+crypto::tink::util::StatusOr<std::string> AesEaxBoringSsl::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data) const {
+  std::string plaintext;
+  ResizeStringUninitialized(&plaintext, MaxDecryptionSize(ciphertext.size()));
+  util::StatusOr<int64_t> written_bytes =
+      Decrypt(ciphertext, associated_data, absl::MakeSpan(plaintext));
+  if (!written_bytes.ok()) {
+    return written_bytes.status();
+  }
+  return plaintext;
+}
+
+int64_t AesEaxBoringSsl::MaxEncryptionSize(int64_t plaintext_size) const {
+  return plaintext_size + nonce_size_ + kTagSize;
+}
+
+crypto::tink::util::StatusOr<int64_t> AesEaxBoringSsl::Encrypt(
+    absl::string_view plaintext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
   // BoringSSL expects a non-null pointer for plaintext and associated_data,
   // regardless of whether the size is 0.
   plaintext = internal::EnsureStringNonNull(plaintext);
   associated_data = internal::EnsureStringNonNull(associated_data);
 
-  size_t ciphertext_size = plaintext.size() + nonce_size_ + kTagSize;
-  std::string ciphertext;
-  ResizeStringUninitialized(&ciphertext, ciphertext_size);
-  const std::string nonce = Random::GetRandomBytes(nonce_size_);
-  const Block N = Omac(nonce, 0);
-  const Block H = Omac(associated_data, 1);
-  uint8_t* ct_start = reinterpret_cast<uint8_t*>(&ciphertext[nonce_size_]);
+  const int64_t ciphertext_size = MaxEncryptionSize(plaintext.size());
+  if (buffer.size() < ciphertext_size) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Encryption buffer too small; expected at least ",
+                     ciphertext_size, " bytes, got ", buffer.size()));
+  }
+  if (internal::BuffersOverlap(
+          plaintext, absl::string_view(buffer.data(), buffer.size()))) {
+    return util::Status(
+        absl::StatusCode::kFailedPrecondition,
+        "Plaintext and ciphertext buffers overlap; this is disallowed");
+  }
   util::Status res =
-      CtrCrypt(N, plaintext, absl::MakeSpan(ciphertext).subspan(nonce_size_));
+      Random::GetRandomNonceBytes(buffer.subspan(0, nonce_size_));
+  if (!res.ok()) {
+    return res;
+  }
+  const Block N = Omac(absl::string_view(buffer.data(), nonce_size_), 0);
+  const Block H = Omac(associated_data, 1);
+  uint8_t* ct_start = reinterpret_cast<uint8_t*>(&buffer[nonce_size_]);
+  res = CtrCrypt(N, plaintext, buffer.subspan(nonce_size_, plaintext.size()));
   if (!res.ok()) {
     return res;
   }
   Block mac = Omac(absl::MakeSpan(ct_start, plaintext.size()), 2);
   XorBlock(N.data(), &mac);
   XorBlock(H.data(), &mac);
-  absl::c_copy(nonce, ciphertext.begin());
-  std::copy_n(mac.begin(), kTagSize, &ciphertext[ciphertext_size - kTagSize]);
-  return ciphertext;
+  std::copy_n(mac.begin(), kTagSize, &buffer[ciphertext_size - kTagSize]);
+  return ciphertext_size;
 }
 
-crypto::tink::util::StatusOr<std::string> AesEaxBoringSsl::Decrypt(
-    absl::string_view ciphertext, absl::string_view associated_data) const {
+int64_t AesEaxBoringSsl::MaxDecryptionSize(int64_t ciphertext_size) const {
+  const int64_t size = ciphertext_size - nonce_size_ - kTagSize;
+  if (size <= 0) {
+    return 0;
+  }
+  return size;
+}
+
+crypto::tink::util::StatusOr<int64_t> AesEaxBoringSsl::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
   // BoringSSL expects a non-null pointer for associated_data,
   // regardless of whether the size is 0.
   associated_data = internal::EnsureStringNonNull(associated_data);
@@ -266,6 +335,18 @@ crypto::tink::util::StatusOr<std::string> AesEaxBoringSsl::Decrypt(
                         "Ciphertext too short");
   }
   size_t out_size = ct_size - kTagSize - nonce_size_;
+  if (buffer.size() < out_size) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Decryption buffer too small; expected at least ",
+                     out_size, " bytes, got ", buffer.size()));
+  }
+  if (internal::BuffersOverlap(
+          ciphertext, absl::string_view(buffer.data(), buffer.size()))) {
+    return util::Status(
+        absl::StatusCode::kFailedPrecondition,
+        "Plaintext and ciphertext buffers overlap; this is disallowed");
+  }
   absl::string_view nonce = ciphertext.substr(0, nonce_size_);
   absl::string_view encrypted = ciphertext.substr(nonce_size_, out_size);
   absl::string_view tag = ciphertext.substr(ct_size - kTagSize, kTagSize);
@@ -278,13 +359,11 @@ crypto::tink::util::StatusOr<std::string> AesEaxBoringSsl::Decrypt(
   if (!EqualBlocks(mac.data(), sig)) {
     return util::Status(absl::StatusCode::kInvalidArgument, "Tag mismatch");
   }
-  std::string plaintext;
-  ResizeStringUninitialized(&plaintext, out_size);
-  util::Status res = CtrCrypt(N, encrypted, absl::MakeSpan(plaintext));
+  util::Status res = CtrCrypt(N, encrypted, buffer.subspan(0, out_size));
   if (!res.ok()) {
     return res;
   }
-  return plaintext;
+  return out_size;
 }
 
 }  // namespace subtle
@@ -18,6 +18,7 @@
 #define TINK_SUBTLE_AES_EAX_BORINGSSL_H_
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -27,6 +28,7 @@
 #include "openssl/aes.h"
 #include "openssl/evp.h"
 #include "tink/aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/status.h"
@@ -36,7 +38,7 @@ namespace crypto {
 namespace tink {
 namespace subtle {
 
-class AesEaxBoringSsl : public Aead {
+class AesEaxBoringSsl : public Aead, public ZeroCopyAead {
  public:
   // Constructs a new Aead cipher for Aes-EAX.
   // Currently supported key sizes are 128 and 256 bits.
@@ -45,6 +47,10 @@ class AesEaxBoringSsl : public Aead {
   static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
       const util::SecretData& key, size_t nonce_size_in_bytes);
 
+  // Same as New(), but returns the ZeroCopyAead view of the primitive.
+  static crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>>
+  NewZeroCopy(const util::SecretData& key, size_t nonce_size_in_bytes);
+
   crypto::tink::util::StatusOr<std::string> Encrypt(
       absl::string_view plaintext,
       absl::string_view associated_data) const override;
@@ -53,6 +59,20 @@ class AesEaxBoringSsl : public Aead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const override;
 
+  // ZeroCopyAead: same ciphertext format as Encrypt() above, written into the
+  // caller's `buffer`.
+  int64_t MaxEncryptionSize(int64_t plaintext_size) const override;
+
+  crypto::tink::util::StatusOr<int64_t> Encrypt(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> buffer) const override;
+
+  int64_t MaxDecryptionSize(int64_t ciphertext_size) const override;
+
+  crypto::tink::util::StatusOr<int64_t> Decrypt(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> buffer) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kNotFips;
 
@@ -62,6 +82,9 @@ class AesEaxBoringSsl : public Aead {
 
   using Block = std::array<uint8_t, kBlockSize>;
 
+  static crypto::tink::util::StatusOr<std::unique_ptr<AesEaxBoringSsl>> Create(
+      const util::SecretData& key, size_t nonce_size_in_bytes);
+
   AesEaxBoringSsl(util::SecretUniquePtr<AES_KEY> aeskey, size_t nonce_size)
       : aeskey_(std::move(aeskey)),
         nonce_size_(nonce_size),
@@ -24,6 +24,7 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "openssl/err.h"
 #include "tink/config/tink_fips.h"
 #include "tink/subtle/wycheproof_util.h"
@@ -61,6 +62,49 @@ TEST(AesEaxBoringSslTest, TestBasic) {
   EXPECT_EQ(pt.value(), message);
 }
 
+TEST(AesEaxBoringSslTest, TestZeroCopy) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      test::HexDecodeOrDie("000102030405060708090a0b0c0d0e0f"));
+  size_t nonce_size = 12;
+  auto zero_copy_res = AesEaxBoringSsl::NewZeroCopy(key, nonce_size);
+  ASSERT_TRUE(zero_copy_res.ok()) << zero_copy_res.status();
+  auto zero_copy_cipher = std::move(zero_copy_res.value());
+  auto res = AesEaxBoringSsl::New(key, nonce_size);
+  ASSERT_TRUE(res.ok()) << res.status();
+  auto cipher = std::move(res.value());
+
+  std::string message = "Some data to encrypt.";
+  std::string associated_data = "Some data to authenticate.";
+  std::string ct(zero_copy_cipher->MaxEncryptionSize(message.size()), '\0');
+  EXPECT_EQ(ct.size(), message.size() + nonce_size + 16);
+  auto written =
+      zero_copy_cipher->Encrypt(message, associated_data, absl::MakeSpan(ct));
+  ASSERT_TRUE(written.ok()) << written.status();
+  EXPECT_EQ(written.value(), ct.size());
+  auto pt = cipher->Decrypt(ct, associated_data);
+  ASSERT_TRUE(pt.ok()) << pt.status();
+  EXPECT_EQ(pt.value(), message);
+
+  auto aead_ct = cipher->Encrypt(message, associated_data);
+  ASSERT_TRUE(aead_ct.ok()) << aead_ct.status();
+  std::string buffer(
+      zero_copy_cipher->MaxDecryptionSize(aead_ct.value().size()), '\0');
+  written = zero_copy_cipher->Decrypt(aead_ct.value(), associated_data,
+                                      absl::MakeSpan(buffer));
+  ASSERT_TRUE(written.ok()) << written.status();
+  EXPECT_EQ(buffer.substr(0, written.value()), message);
+
+  // Modified ciphertexts are rejected before any plaintext is released.
+  aead_ct.value()[nonce_size] ^= 1;
+  written = zero_copy_cipher->Decrypt(aead_ct.value(), associated_data,
+                                      absl::MakeSpan(buffer));
+  EXPECT_FALSE(written.ok());
+}
+
 TEST(AesEaxBoringSslTest, TestMessageSize) {
   if (IsFipsModeEnabled()) {
     GTEST_SKIP() << "Not supported in FIPS-only mode";
@@ -16,10 +16,16 @@
 
 #include "tink/subtle/aes_gcm_boringssl.h"
 
+#include <cstdint>
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/aead.h"
 #include "tink/aead/internal/aead_from_zero_copy.h"
 #include "tink/aead/internal/zero_copy_aead.h"
 #include "tink/aead/internal/zero_copy_aes_gcm_boringssl.h"
@@ -32,6 +38,42 @@ namespace crypto {
 namespace tink {
 namespace subtle {
 
+namespace {
+
+// AES-GCM Aead. Single messages go through the zero-copy interface; batches
+// are handed to ZeroCopyAesGcmBoringSsl as a whole, so that the cipher is set
+// up once per batch rather than once per message.
+class AesGcmBoringSslAead : public internal::AeadFromZeroCopy {
+ public:
+  // `batch_aead` is the object owned by `aead`.
+  AesGcmBoringSslAead(std::unique_ptr<internal::ZeroCopyAead> aead,
+                      const internal::ZeroCopyAesGcmBoringSsl& batch_aead)
+      : internal::AeadFromZeroCopy(std::move(aead)), batch_aead_(batch_aead) {}
+
+  util::Status EncryptBatchWithPrefix(
+      absl::string_view output_prefix,
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* ciphertexts, std::vector<int64_t>* offsets) const override {
+    return batch_aead_.EncryptBatchWithPrefix(output_prefix, plaintexts,
+                                              associated_data, ciphertexts,
+                                              offsets);
+  }
+
+  util::Status DecryptBatch(absl::Span<const absl::string_view> ciphertexts,
+                            absl::Span<const absl::string_view> associated_data,
+                            std::string* plaintexts,
+                            std::vector<int64_t>* offsets) const override {
+    return batch_aead_.DecryptBatch(ciphertexts, associated_data, plaintexts,
+                                    offsets);
+  }
+
+ private:
+  const internal::ZeroCopyAesGcmBoringSsl& batch_aead_;
+};
+
+}  // namespace
+
 util::StatusOr<std::unique_ptr<Aead>> AesGcmBoringSsl::New(
     const util::SecretData& key) {
   util::Status status = internal::CheckFipsCompatibility<AesGcmBoringSsl>();
@@ -39,13 +81,14 @@ util::StatusOr<std::unique_ptr<Aead>> AesGcmBoringSsl::New(
     return status;
   }
 
-  util::StatusOr<std::unique_ptr<internal::ZeroCopyAead>> zero_copy_aead =
-      internal::ZeroCopyAesGcmBoringSsl::New(key);
+  util::StatusOr<std::unique_ptr<internal::ZeroCopyAesGcmBoringSsl>>
+      zero_copy_aead = internal::ZeroCopyAesGcmBoringSsl::New(key);
   if (!zero_copy_aead.ok()) {
     return zero_copy_aead.status();
   }
-  return {absl::make_unique<internal::AeadFromZeroCopy>(
-      *std::move(zero_copy_aead))};
+  const internal::ZeroCopyAesGcmBoringSsl& batch_aead = **zero_copy_aead;
+  return {absl::make_unique<AesGcmBoringSslAead>(*std::move(zero_copy_aead),
+                                                 batch_aead)};
 }
 
 }  // namespace subtle
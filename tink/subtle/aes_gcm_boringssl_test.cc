@@ -16,6 +16,7 @@
 
 #include "tink/subtle/aes_gcm_boringssl.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
@@ -25,7 +26,9 @@
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tink/aead/internal/wycheproof_aead.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/util/secret_data.h"
@@ -44,10 +47,13 @@ constexpr absl::string_view kKey256 =
     "000102030405060708090a0b0c0d0e0f000102030405060708090a0b0c0d0e0f";
 
 using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::IsOkAndHolds;
 using ::crypto::tink::test::StatusIs;
 using ::testing::AllOf;
 using ::testing::Eq;
+using ::testing::IsEmpty;
 using ::testing::Not;
+using ::testing::SizeIs;
 using ::testing::Test;
 using ::testing::TestWithParam;
 using ::testing::ValuesIn;
@@ -80,6 +86,76 @@ TEST_F(AesGcmBoringSslTest, BasicEncryptDecrypt) {
   EXPECT_EQ(*plaintext, kMessage);
 }
 
+TEST_F(AesGcmBoringSslTest, BatchEncryptDecrypt) {
+  const std::vector<absl::string_view> plaintexts = {kMessage, "", "x",
+                                                     kAssociatedData};
+  const std::vector<absl::string_view> associated_data = {
+      kAssociatedData, "", "ad", kMessage};
+  std::string ciphertexts;
+  std::vector<int64_t> offsets;
+  ASSERT_THAT(cipher_->EncryptBatch(plaintexts, associated_data, &ciphertexts,
+                                    &offsets),
+              IsOk());
+  ASSERT_THAT(offsets, SizeIs(plaintexts.size() + 1));
+  std::vector<absl::string_view> ciphertext_views;
+  for (int i = 0; i < plaintexts.size(); ++i) {
+    absl::string_view ciphertext = absl::string_view(ciphertexts).substr(
+        offsets[i], offsets[i + 1] - offsets[i]);
+    EXPECT_EQ(ciphertext.size(), plaintexts[i].size() + 12 + 16);
+    EXPECT_THAT(cipher_->Decrypt(ciphertext, associated_data[i]),
+                IsOkAndHolds(plaintexts[i]));
+    ciphertext_views.push_back(ciphertext);
+  }
+
+  std::string decrypted;
+  ASSERT_THAT(cipher_->DecryptBatch(ciphertext_views, associated_data,
+                                    &decrypted, &offsets),
+              IsOk());
+  EXPECT_EQ(decrypted, absl::StrCat(kMessage, "x", kAssociatedData));
+
+  // Associated data of another message fails the batch.
+  std::swap(ciphertext_views[0], ciphertext_views[3]);
+  EXPECT_THAT(cipher_->DecryptBatch(ciphertext_views, associated_data,
+                                    &decrypted, &offsets),
+              Not(IsOk()));
+  EXPECT_THAT(decrypted, IsEmpty());
+  EXPECT_THAT(offsets, IsEmpty());
+
+  // A failure in the middle of the batch does not leave the plaintexts of the
+  // messages before it behind.
+  std::swap(ciphertext_views[0], ciphertext_views[3]);
+  std::string modified_ciphertext(ciphertext_views[2]);
+  modified_ciphertext.back() ^= 1;
+  ciphertext_views[2] = modified_ciphertext;
+  EXPECT_THAT(cipher_->DecryptBatch(ciphertext_views, associated_data,
+                                    &decrypted, &offsets),
+              Not(IsOk()));
+  EXPECT_THAT(decrypted, IsEmpty());
+  EXPECT_THAT(offsets, IsEmpty());
+}
+
+TEST_F(AesGcmBoringSslTest, BatchEncryptWithPrefix) {
+  const std::vector<absl::string_view> plaintexts = {kMessage, "", "x"};
+  constexpr absl::string_view kPrefix = "prefix";
+  std::string ciphertexts;
+  std::vector<int64_t> offsets;
+  ASSERT_THAT(cipher_->EncryptBatchWithPrefix(kPrefix, plaintexts,
+                                              {kAssociatedData}, &ciphertexts,
+                                              &offsets),
+              IsOk());
+  ASSERT_THAT(offsets, SizeIs(plaintexts.size() + 1));
+  for (int i = 0; i < plaintexts.size(); ++i) {
+    absl::string_view ciphertext = absl::string_view(ciphertexts).substr(
+        offsets[i], offsets[i + 1] - offsets[i]);
+    EXPECT_EQ(ciphertext.size(),
+              kPrefix.size() + plaintexts[i].size() + 12 + 16);
+    ASSERT_TRUE(absl::StartsWith(ciphertext, kPrefix));
+    EXPECT_THAT(cipher_->Decrypt(ciphertext.substr(kPrefix.size()),
+                                 kAssociatedData),
+                IsOkAndHolds(plaintexts[i]));
+  }
+}
+
 TEST_F(AesGcmBoringSslTest, ModifyMessageAndAssociatedData) {
   util::StatusOr<std::string> ciphertext =
       cipher_->Encrypt(kMessage, kAssociatedData);
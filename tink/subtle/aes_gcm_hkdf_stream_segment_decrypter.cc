@@ -166,33 +166,53 @@ int AesGcmHkdfStreamSegmentDecrypter::get_plaintext_segment_size() const {
 util::Status AesGcmHkdfStreamSegmentDecrypter::DecryptSegment(
     const std::vector<uint8_t>& ciphertext, int64_t segment_number,
     bool is_last_segment, std::vector<uint8_t>* plaintext_buffer) {
+  util::Status status = CheckCiphertextSegment(ciphertext.size());
+  if (!status.ok()) return status;
+  if (plaintext_buffer == nullptr) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "plaintext_buffer must be non-null");
+  }
+  plaintext_buffer->resize(ciphertext.size() -
+                           AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes);
+  return DecryptSegmentInto(ciphertext, segment_number, is_last_segment,
+                            absl::MakeSpan(*plaintext_buffer));
+}
+
+util::Status AesGcmHkdfStreamSegmentDecrypter::CheckCiphertextSegment(
+    size_t ciphertext_size) const {
   if (!is_initialized_) {
     return util::Status(absl::StatusCode::kFailedPrecondition,
                         "decrypter not initialized");
   }
-  if (ciphertext.size() > get_ciphertext_segment_size()) {
+  if (ciphertext_size > get_ciphertext_segment_size()) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "ciphertext too long");
   }
-  if (ciphertext.size() < AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes) {
+  if (ciphertext_size < AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "ciphertext too short");
   }
-  if (plaintext_buffer == nullptr) {
+  return util::OkStatus();
+}
+
+util::Status AesGcmHkdfStreamSegmentDecrypter::DecryptSegmentInto(
+    absl::Span<const uint8_t> ciphertext, int64_t segment_number,
+    bool is_last_segment, absl::Span<uint8_t> plaintext) const {
+  util::Status status = CheckCiphertextSegment(ciphertext.size());
+  if (!status.ok()) return status;
+  if (plaintext.size() !=
+      ciphertext.size() - AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes) {
     return util::Status(absl::StatusCode::kInvalidArgument,
-                        "plaintext_buffer must be non-null");
+                        "wrong plaintext size");
   }
-  if (segment_number > std::numeric_limits<uint32_t>::max() ||
+  if (segment_number < 0 ||
+      segment_number > std::numeric_limits<uint32_t>::max() ||
       (segment_number == std::numeric_limits<uint32_t>::max() &&
        !is_last_segment)) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "too many segments");
   }
 
-  const int64_t kPlaintextSize =
-      ciphertext.size() - AesGcmHkdfStreamSegmentEncrypter::kTagSizeInBytes;
-  plaintext_buffer->resize(kPlaintextSize);
-
   // Construct IV.
   std::vector<uint8_t> iv(AesGcmHkdfStreamSegmentEncrypter::kNonceSizeInBytes);
   absl::c_copy(nonce_prefix_, iv.begin());
@@ -206,8 +226,8 @@ util::Status AesGcmHkdfStreamSegmentDecrypter::DecryptSegment(
                         ciphertext.size()),
       /*associated_data=*/absl::string_view(""),
       absl::string_view(reinterpret_cast<const char*>(iv.data()), iv.size()),
-      absl::Span<char>(reinterpret_cast<char*>(plaintext_buffer->data()),
-                       plaintext_buffer->size()));
+      absl::Span<char>(reinterpret_cast<char*>(plaintext.data()),
+                       plaintext.size()));
   if (!written_bytes.ok()) {
     return written_bytes.status();
   }
@@ -22,6 +22,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "tink/aead/internal/ssl_aead.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/stream_segment_decrypter.h"
@@ -80,6 +81,10 @@ class AesGcmHkdfStreamSegmentDecrypter : public StreamSegmentDecrypter {
       bool is_last_segment,
       std::vector<uint8_t>* plaintext_buffer) override;
 
+  util::Status DecryptSegmentInto(absl::Span<const uint8_t> ciphertext,
+                                  int64_t segment_number, bool is_last_segment,
+                                  absl::Span<uint8_t> plaintext) const override;
+
   int get_header_size() const override {
     return header_size_;
   }
@@ -96,6 +101,10 @@ class AesGcmHkdfStreamSegmentDecrypter : public StreamSegmentDecrypter {
  private:
   explicit AesGcmHkdfStreamSegmentDecrypter(Params params);
 
+  // Checks that this decrypter is initialized and that 'ciphertext_size' is
+  // a valid size of a ciphertext segment.
+  util::Status CheckCiphertextSegment(size_t ciphertext_size) const;
+
   // Parameters set upon decrypter creation.
   // All sizes are in bytes.
   const util::SecretData ikm_;
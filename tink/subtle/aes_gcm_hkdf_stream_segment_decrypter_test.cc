@@ -23,6 +23,7 @@
 
 #include "gtest/gtest.h"
 #include "absl/strings/str_cat.h"
+#include "absl/types/span.h"
 #include "tink/subtle/aes_gcm_hkdf_stream_segment_encrypter.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/hkdf.h"
@@ -149,6 +150,62 @@ TEST(AesGcmHkdfStreamSegmentDecrypterTest, testBasic) {
 }
 
 
+TEST(AesGcmHkdfStreamSegmentDecrypterTest, testSpanRoundTrip) {
+  AesGcmHkdfStreamSegmentDecrypter::Params params;
+  params.ikm = Random::GetRandomKeyBytes(32);
+  params.hkdf_hash = SHA256;
+  params.derived_key_size = 32;
+  params.ciphertext_offset = 0;
+  params.ciphertext_segment_size = 128;
+  params.associated_data = "associated data";
+  auto result = AesGcmHkdfStreamSegmentDecrypter::New(params);
+  ASSERT_TRUE(result.ok()) << result.status();
+  auto dec = std::move(result.value());
+  auto enc = std::move(GetEncrypter(params.ikm, params.hkdf_hash,
+                                    params.derived_key_size,
+                                    params.ciphertext_offset,
+                                    params.ciphertext_segment_size,
+                                    params.associated_data)
+                           .value());
+  ASSERT_TRUE(dec->Init(enc->get_header()).ok());
+
+  int tag_size = dec->get_ciphertext_segment_size() -
+                 dec->get_plaintext_segment_size();
+  for (int pt_size : {0, 1, dec->get_plaintext_segment_size()}) {
+    SCOPED_TRACE(absl::StrCat("plaintext_size = ", pt_size));
+    int64_t segment_number = enc->get_segment_number();
+    std::vector<uint8_t> pt(pt_size, 'p');
+    std::vector<uint8_t> ct(pt_size + tag_size);
+    auto status =
+        enc->EncryptSegmentInto(pt, /*is_last_segment=*/false,
+                                absl::MakeSpan(ct.data(), ct.size() - 1));
+    EXPECT_FALSE(status.ok());
+    EXPECT_EQ(segment_number, enc->get_segment_number());
+    status = enc->EncryptSegmentInto(pt, /*is_last_segment=*/false,
+                                     absl::MakeSpan(ct));
+    EXPECT_TRUE(status.ok()) << status;
+    EXPECT_EQ(segment_number + 1, enc->get_segment_number());
+
+    std::vector<uint8_t> decrypted(pt_size, 'x');
+    status = dec->DecryptSegmentInto(ct, segment_number,
+                                     /*is_last_segment=*/false,
+                                     absl::MakeSpan(decrypted));
+    EXPECT_TRUE(status.ok()) << status;
+    EXPECT_EQ(pt, decrypted);
+    status = dec->DecryptSegmentInto(ct, segment_number,
+                                     /*is_last_segment=*/true,
+                                     absl::MakeSpan(decrypted));
+    EXPECT_FALSE(status.ok());
+    std::vector<uint8_t> too_long(pt_size + 1);
+    status = dec->DecryptSegmentInto(ct, segment_number,
+                                     /*is_last_segment=*/false,
+                                     absl::MakeSpan(too_long));
+    EXPECT_FALSE(status.ok());
+    EXPECT_PRED_FORMAT2(testing::IsSubstring, "wrong plaintext size",
+                        std::string(status.message()));
+  }
+}
+
 TEST(AesGcmHkdfStreamSegmentDecrypterTest, testWrongDerivedKeySize) {
   for (int derived_key_size : {12, 24, 64}) {
     for (HashType hkdf_hash : {SHA1, SHA256, SHA512}) {
@@ -119,7 +119,7 @@ int AesGcmHkdfStreamSegmentEncrypter::get_plaintext_segment_size() const {
 AesGcmHkdfStreamSegmentEncrypter::AesGcmHkdfStreamSegmentEncrypter(
     std::unique_ptr<internal::SslOneShotAead> aead, const Params& params)
     : aead_(std::move(aead)),
-      nonce_prefix_(Random::GetRandomBytes(kNoncePrefixSizeInBytes)),
+      nonce_prefix_(Random::GetRandomNonceBytes(kNoncePrefixSizeInBytes)),
       header_(CreateHeader(params.salt, nonce_prefix_)),
       ciphertext_segment_size_(params.ciphertext_segment_size),
       ciphertext_offset_(params.ciphertext_offset) {}
@@ -150,33 +150,56 @@ util::Status AesGcmHkdfStreamSegmentEncrypter::EncryptSegment(
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "ciphertext_buffer must be non-null");
   }
-  if (get_segment_number() > std::numeric_limits<uint32_t>::max() ||
-      (get_segment_number() == std::numeric_limits<uint32_t>::max() &&
+  ciphertext_buffer->resize(plaintext.size() + kTagSizeInBytes);
+  return EncryptSegmentInto(plaintext, is_last_segment,
+                            absl::MakeSpan(*ciphertext_buffer));
+}
+
+util::Status AesGcmHkdfStreamSegmentEncrypter::EncryptSegmentInto(
+    absl::Span<const uint8_t> plaintext, bool is_last_segment,
+    absl::Span<uint8_t> ciphertext) {
+  util::Status status = EncryptSegmentAt(plaintext, get_segment_number(),
+                                         is_last_segment, ciphertext);
+  if (!status.ok()) {
+    return status;
+  }
+  IncSegmentNumber();
+  return util::OkStatus();
+}
+
+util::Status AesGcmHkdfStreamSegmentEncrypter::EncryptSegmentAt(
+    absl::Span<const uint8_t> plaintext, int64_t segment_number,
+    bool is_last_segment, absl::Span<uint8_t> ciphertext) const {
+  if (plaintext.size() > get_plaintext_segment_size()) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "plaintext too long");
+  }
+  if (ciphertext.size() != plaintext.size() + kTagSizeInBytes) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "wrong ciphertext size");
+  }
+  if (segment_number < 0 ||
+      segment_number > std::numeric_limits<uint32_t>::max() ||
+      (segment_number == std::numeric_limits<uint32_t>::max() &&
        !is_last_segment)) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "too many segments");
   }
 
-  const int64_t kCiphertextSize = plaintext.size() + kTagSizeInBytes;
-  ciphertext_buffer->resize(kCiphertextSize);
-
   // Construct IV.
-  std::string iv =
-      ConstructNonce(nonce_prefix_, static_cast<uint32_t>(get_segment_number()),
-                     is_last_segment);
+  std::string iv = ConstructNonce(
+      nonce_prefix_, static_cast<uint32_t>(segment_number), is_last_segment);
 
   util::StatusOr<uint64_t> written_bytes = aead_->Encrypt(
       absl::string_view(reinterpret_cast<const char*>(plaintext.data()),
                         plaintext.size()),
       /*associated_data=*/absl::string_view(""), iv,
-      absl::MakeSpan(reinterpret_cast<char*>(ciphertext_buffer->data()),
-                     ciphertext_buffer->size()));
+      absl::MakeSpan(reinterpret_cast<char*>(ciphertext.data()),
+                     ciphertext.size()));
 
   if (!written_bytes.ok()) {
     return written_bytes.status();
   }
-
-  IncSegmentNumber();
   return util::OkStatus();
 }
 
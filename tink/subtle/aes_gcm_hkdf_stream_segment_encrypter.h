@@ -21,6 +21,7 @@
 #include <string>
 #include <vector>
 
+#include "absl/types/span.h"
 #include "tink/aead/internal/ssl_aead.h"
 #include "tink/subtle/stream_segment_encrypter.h"
 #include "tink/util/secret_data.h"
@@ -85,6 +86,14 @@ class AesGcmHkdfStreamSegmentEncrypter : public StreamSegmentEncrypter {
                               bool is_last_segment,
                               std::vector<uint8_t>* ciphertext_buffer) override;
 
+  util::Status EncryptSegmentAt(absl::Span<const uint8_t> plaintext,
+                                int64_t segment_number, bool is_last_segment,
+                                absl::Span<uint8_t> ciphertext) const override;
+
+  util::Status EncryptSegmentInto(absl::Span<const uint8_t> plaintext,
+                                  bool is_last_segment,
+                                  absl::Span<uint8_t> ciphertext) override;
+
   const std::vector<uint8_t>& get_header() const override { return header_; }
   int64_t get_segment_number() const override { return segment_number_; }
   int get_plaintext_segment_size() const override;
@@ -28,6 +28,7 @@
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "tink/aead/internal/ssl_aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/subtle/random.h"
 #include "tink/subtle/subtle_util.h"
 #include "tink/util/status.h"
@@ -39,8 +40,8 @@ namespace subtle {
 constexpr int kIvSizeInBytes = 12;
 constexpr int kTagSizeInBytes = 16;
 
-util::StatusOr<std::unique_ptr<Aead>> AesGcmSivBoringSsl::New(
-    const util::SecretData& key) {
+util::StatusOr<std::unique_ptr<AesGcmSivBoringSsl>>
+AesGcmSivBoringSsl::Create(const util::SecretData& key) {
   auto status = internal::CheckFipsCompatibility<AesGcmSivBoringSsl>();
   if (!status.ok()) {
     return status;
@@ -55,47 +56,134 @@ util::StatusOr<std::unique_ptr<Aead>> AesGcmSivBoringSsl::New(
   return {absl::WrapUnique(new AesGcmSivBoringSsl(*std::move(aead)))};
 }
 
+util::StatusOr<std::unique_ptr<Aead>> AesGcmSivBoringSsl::New(
+    const util::SecretData& key) {
+  util::StatusOr<std::unique_ptr<AesGcmSivBoringSsl>> aead =
+      Create(key);
+  if (!aead.ok()) {
+    return aead.status();
+  }
+  return {std::unique_ptr<Aead>(*std::move(aead))};
+}
+
+util::StatusOr<std::unique_ptr<ZeroCopyAead>>
+AesGcmSivBoringSsl::NewZeroCopy(const util::SecretData& key) {
+  util::StatusOr<std::unique_ptr<AesGcmSivBoringSsl>> aead =
+      Create(key);
+  if (!aead.ok()) {
+    return aead.status();
+  }
+  return {std::unique_ptr<ZeroCopyAead>(*std::move(aead))};
+}
+
 util::StatusOr<std::string> AesGcmSivBoringSsl::Encrypt(
     absl::string_view plaintext, absl::string_view associated_data) const {
-  const int64_t kCiphertextSize =
-      kIvSizeInBytes + aead_->CiphertextSize(plaintext.size());
-  std::string ct;
-  ResizeStringUninitialized(&ct, kCiphertextSize);
-  util::Status res =
-      Random::GetRandomBytes(absl::MakeSpan(ct).subspan(0, kIvSizeInBytes));
+  std::string ciphertext;
+  ResizeStringUninitialized(&ciphertext, MaxEncryptionSize(plaintext.size()));
+  util::StatusOr<int64_t> written_bytes =
+      Encrypt(plaintext, associated_data, absl::MakeSpan(ciphertext));
+  if (!written_bytes.ok()) {
+    return written_bytes.status();
+  }
+  ciphertext.resize(*written_bytes);
+  return ciphertext;
+}
+
+util::StatusOr<std::string> AesGcmSivBoringSsl::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data) const {
+  std::string plaintext;
+  ResizeStringUninitialized(&plaintext, MaxDecryptionSize(ciphertext.size()));
+  util::StatusOr<int64_t> written_bytes =
+      Decrypt(ciphertext, associated_data, absl::MakeSpan(plaintext));
+  if (!written_bytes.ok()) {
+    return written_bytes.status();
+  }
+  plaintext.resize(*written_bytes);
+  return plaintext;
+}
+
+int64_t AesGcmSivBoringSsl::MaxEncryptionSize(
+    int64_t plaintext_size) const {
+  return kIvSizeInBytes + aead_->CiphertextSize(plaintext_size);
+}
+
+util::StatusOr<int64_t> AesGcmSivBoringSsl::Encrypt(
+    absl::string_view plaintext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
+  if (buffer.size() < kIvSizeInBytes) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Encryption buffer too small; expected at least ",
+                     MaxEncryptionSize(plaintext.size()), " bytes, got ",
+                     buffer.size()));
+  }
+  util::Status res = internal::ValidateEncryptionBuffersWithPrefixIv(
+      plaintext, buffer, kIvSizeInBytes);
+  if (!res.ok()) {
+    return res;
+  }
+  res = Random::GetRandomNonceBytes(buffer.subspan(0, kIvSizeInBytes));
   if (!res.ok()) {
     return res;
   }
-  auto nonce = absl::string_view(ct).substr(0, kIvSizeInBytes);
-  auto ciphertext_and_tag_buffer = absl::MakeSpan(ct).subspan(kIvSizeInBytes);
+  auto nonce = absl::string_view(buffer.data(), kIvSizeInBytes);
   util::StatusOr<int64_t> written_bytes = aead_->Encrypt(
-      plaintext, associated_data, nonce, ciphertext_and_tag_buffer);
+      plaintext, associated_data, nonce, buffer.subspan(kIvSizeInBytes));
   if (!written_bytes.ok()) {
     return written_bytes.status();
   }
-  return ct;
+  return kIvSizeInBytes + *written_bytes;
 }
 
-util::StatusOr<std::string> AesGcmSivBoringSsl::Decrypt(
-    absl::string_view ciphertext, absl::string_view associated_data) const {
+int64_t AesGcmSivBoringSsl::MaxDecryptionSize(
+    int64_t ciphertext_size) const {
+  if (ciphertext_size < kIvSizeInBytes + kTagSizeInBytes) {
+    return 0;
+  }
+  return aead_->PlaintextSize(ciphertext_size - kIvSizeInBytes);
+}
+
+util::StatusOr<int64_t> AesGcmSivBoringSsl::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
   if (ciphertext.size() < kIvSizeInBytes + kTagSizeInBytes) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         absl::StrCat("Ciphertext too short; expected at least ",
-                                     kIvSizeInBytes + kTagSizeInBytes, " got ",
-                                     ciphertext.size()));
+                                     kIvSizeInBytes + kTagSizeInBytes,
+                                     " got ", ciphertext.size()));
+  }
+  util::Status res = internal::ValidateDecryptionBuffersWithPrefixIv(
+      ciphertext, buffer, kIvSizeInBytes);
+  if (!res.ok()) {
+    return res;
   }
-  const int64_t kPlaintextSize =
-      aead_->PlaintextSize(ciphertext.size() - kIvSizeInBytes);
-  std::string plaintext;
-  ResizeStringUninitialized(&plaintext, kPlaintextSize);
   auto nonce = ciphertext.substr(0, kIvSizeInBytes);
   auto encrypted = ciphertext.substr(kIvSizeInBytes);
-  util::StatusOr<int64_t> written_bytes = aead_->Decrypt(
-      encrypted, associated_data, nonce, absl::MakeSpan(plaintext));
-  if (!written_bytes.ok()) {
-    return written_bytes.status();
-  }
-  return plaintext;
+  return aead_->Decrypt(encrypted, associated_data, nonce, buffer);
+}
+
+int64_t AesGcmSivBoringSsl::InPlaceOffset() const {
+  return kIvSizeInBytes;
+}
+
+util::Status AesGcmSivBoringSsl::EncryptBatchWithPrefix(
+    absl::string_view output_prefix,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* ciphertexts, std::vector<int64_t>* offsets) const {
+  return internal::EncryptBatchWithRandomIv(*aead_, kIvSizeInBytes, plaintexts,
+                                            associated_data, output_prefix,
+                                            ciphertexts, offsets);
+}
+
+util::Status AesGcmSivBoringSsl::DecryptBatch(
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* plaintexts, std::vector<int64_t>* offsets) const {
+  return internal::DecryptBatchWithPrefixIv(*aead_, kIvSizeInBytes,
+                                            kTagSizeInBytes, ciphertexts,
+                                            associated_data, plaintexts,
+                                            offsets);
 }
 
 }  // namespace subtle
@@ -17,15 +17,20 @@
 #ifndef TINK_SUBTLE_AES_GCM_SIV_BORINGSSL_H_
 #define TINK_SUBTLE_AES_GCM_SIV_BORINGSSL_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/aead/internal/ssl_aead.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/util/secret_data.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -49,11 +54,15 @@ namespace subtle {
 // https://cyber.biu.ac.il/aes-gcm-siv/
 // or Section 6.3 of this paper:
 // https://eprint.iacr.org/2017/702.pdf
-class AesGcmSivBoringSsl : public Aead {
+class AesGcmSivBoringSsl : public Aead, public ZeroCopyAead {
  public:
   static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
       const util::SecretData& key);
 
+  // Same as New(), but returns the ZeroCopyAead view of the primitive.
+  static crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>>
+  NewZeroCopy(const util::SecretData& key);
+
   crypto::tink::util::StatusOr<std::string> Encrypt(
       absl::string_view plaintext,
       absl::string_view associated_data) const override;
@@ -62,10 +71,43 @@ class AesGcmSivBoringSsl : public Aead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const override;
 
+  // ZeroCopyAead: the ciphertext is written into the caller's `buffer`, in
+  // the same format as Encrypt() above.
+  int64_t MaxEncryptionSize(int64_t plaintext_size) const override;
+
+  crypto::tink::util::StatusOr<int64_t> Encrypt(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> buffer) const override;
+
+  int64_t MaxDecryptionSize(int64_t ciphertext_size) const override;
+
+  crypto::tink::util::StatusOr<int64_t> Decrypt(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> buffer) const override;
+
+  // Encryption and decryption may be done in place after the nonce.
+  int64_t InPlaceOffset() const override;
+
+  // Encrypts/decrypts the whole batch directly into the output buffer; see
+  // Aead::EncryptBatchWithPrefix.
+  crypto::tink::util::Status EncryptBatchWithPrefix(
+      absl::string_view output_prefix,
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* ciphertexts, std::vector<int64_t>* offsets) const override;
+
+  crypto::tink::util::Status DecryptBatch(
+      absl::Span<const absl::string_view> ciphertexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* plaintexts, std::vector<int64_t>* offsets) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kNotFips;
 
  private:
+  static crypto::tink::util::StatusOr<std::unique_ptr<AesGcmSivBoringSsl>>
+  Create(const util::SecretData& key);
+
   explicit AesGcmSivBoringSsl(std::unique_ptr<internal::SslOneShotAead> aead)
       : aead_(std::move(aead)) {}
 
@@ -18,10 +18,12 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
@@ -32,6 +34,7 @@
 #include "tink/aead/internal/aead_util.h"
 #include "tink/deterministic_aead.h"
 #include "tink/internal/aes_util.h"
+#include "tink/internal/batch_util.h"
 #include "tink/subtle/subtle_util.h"
 #include "tink/util/errors.h"
 #include "tink/util/status.h"
@@ -53,6 +56,26 @@ crypto::tink::util::StatusOr<util::SecretUniquePtr<AES_KEY>> InitializeAesKey(
   return std::move(aes_key);
 }
 
+uint64_t LoadBigEndian64(const uint8_t in[8]) {
+  uint64_t value = 0;
+  for (int i = 0; i < 8; ++i) {
+    value = (value << 8) | in[i];
+  }
+  return value;
+}
+
+void StoreBigEndian64(uint64_t value, uint8_t out[8]) {
+  for (int i = 7; i >= 0; --i) {
+    out[i] = static_cast<uint8_t>(value);
+    value >>= 8;
+  }
+}
+
+absl::Span<const uint8_t> AsBytes(absl::string_view data) {
+  return absl::MakeSpan(reinterpret_cast<const uint8_t*>(data.data()),
+                        data.size());
+}
+
 }  // namespace
 
 // static
@@ -91,6 +114,13 @@ util::SecretData AesSivBoringSsl::ComputeCmacK2() const {
   return cmac_k2;
 }
 
+util::SecretData AesSivBoringSsl::ComputeS2vZero() const {
+  util::SecretData s2v_zero(kBlockSize, 0);
+  Cmac(s2v_zero, s2v_zero.data());
+  MultiplyByX(s2v_zero.data());
+  return s2v_zero;
+}
+
 void AesSivBoringSsl::EncryptBlock(const uint8_t in[kBlockSize],
                                    uint8_t out[kBlockSize]) const {
   AES_encrypt(in, out, k1_.get());
@@ -98,93 +128,141 @@ void AesSivBoringSsl::EncryptBlock(const uint8_t in[kBlockSize],
 
 // static
 void AesSivBoringSsl::MultiplyByX(uint8_t block[kBlockSize]) {
+  uint64_t high = LoadBigEndian64(block);
+  uint64_t low = LoadBigEndian64(block + 8);
   // Carry over 0x87 if msb is 1 0x00 if msb is 0.
-  uint8_t carry = 0x87 & -(block[0] >> 7);
-  for (size_t i = 0; i < kBlockSize - 1; ++i) {
-    block[i] = (block[i] << 1) | (block[i + 1] >> 7);
-  }
-  block[kBlockSize - 1] =
-      (block[kBlockSize - 1] << 1) ^ carry;
+  uint64_t carry = 0x87 & -(high >> 63);
+  high = (high << 1) | (low >> 63);
+  low = (low << 1) ^ carry;
+  StoreBigEndian64(high, block);
+  StoreBigEndian64(low, block + 8);
 }
 
 // static
 void AesSivBoringSsl::XorBlock(const uint8_t x[kBlockSize],
                                const uint8_t y[kBlockSize],
                                uint8_t res[kBlockSize]) {
-  for (int i = 0; i < kBlockSize; ++i) {
-    res[i] = x[i] ^ y[i];
+  // Compilers turn the word-wise xor into a single vector instruction.
+  uint64_t x_words[2];
+  uint64_t y_words[2];
+  std::memcpy(x_words, x, kBlockSize);
+  std::memcpy(y_words, y, kBlockSize);
+  x_words[0] ^= y_words[0];
+  x_words[1] ^= y_words[1];
+  std::memcpy(res, x_words, kBlockSize);
+}
+
+void AesSivBoringSsl::CbcMac(absl::Span<const uint8_t> data,
+                             uint8_t state[kBlockSize]) const {
+  for (size_t idx = 0; idx < data.size(); idx += kBlockSize) {
+    XorBlock(state, &data[idx], state);
+    EncryptBlock(state, state);
+  }
+}
+
+void AesSivBoringSsl::CbcMacLanes(absl::Span<CbcMacLane> lanes) const {
+  size_t max_size = 0;
+  for (const CbcMacLane& lane : lanes) {
+    max_size = std::max(max_size, lane.data.size());
+  }
+  for (size_t idx = 0; idx < max_size; idx += kBlockSize) {
+    for (CbcMacLane& lane : lanes) {
+      if (idx < lane.data.size()) {
+        XorBlock(lane.state, &lane.data[idx], lane.state);
+        EncryptBlock(lane.state, lane.state);
+      }
+    }
   }
 }
 
+// static
+size_t AesSivBoringSsl::CmacPrefixSize(size_t size) {
+  const size_t blocks =
+      std::max(size_t{1}, (size + kBlockSize - 1) / kBlockSize);
+  return kBlockSize * (blocks - 1);
+}
+
 void AesSivBoringSsl::Cmac(absl::Span<const uint8_t> data,
                            uint8_t mac[kBlockSize]) const {
-  const size_t blocks =
-      std::max(size_t{1}, (data.size() + kBlockSize - 1) / kBlockSize);
-  const size_t last_block_idx = kBlockSize * (blocks - 1);
-  const size_t last_block_size = data.size() - last_block_idx;
-  uint8_t block[kBlockSize];
-  std::fill(std::begin(block), std::end(block), 0);
-  for (size_t idx = 0; idx < last_block_idx; idx += kBlockSize) {
-    XorBlock(block, &data[idx], block);
-    EncryptBlock(block, block);
-  }
-  for (size_t j = 0; j < last_block_size; j++) {
-    block[j] ^= data[last_block_idx + j];
+  uint8_t state[kBlockSize];
+  std::fill(std::begin(state), std::end(state), 0);
+  const size_t prefix_size = CmacPrefixSize(data.size());
+  CbcMac(data.subspan(0, prefix_size), state);
+  CmacFinish(data.subspan(prefix_size), state, mac);
+}
+
+void AesSivBoringSsl::CmacFinish(absl::Span<const uint8_t> last,
+                                 uint8_t state[kBlockSize],
+                                 uint8_t mac[kBlockSize]) const {
+  for (size_t j = 0; j < last.size(); j++) {
+    state[j] ^= last[j];
   }
-  if (last_block_size == kBlockSize) {
-    XorBlock(block, cmac_k1_.data(), block);
+  if (last.size() == kBlockSize) {
+    XorBlock(state, cmac_k1_.data(), state);
   } else {
-    block[last_block_size] ^= 0x80;
-    XorBlock(block, cmac_k2_.data(), block);
+    state[last.size()] ^= 0x80;
+    XorBlock(state, cmac_k2_.data(), state);
   }
-  EncryptBlock(block, mac);
+  EncryptBlock(state, mac);
 }
 
-// Computes Cmac(XorEnd(data, last))
-void AesSivBoringSsl::CmacLong(absl::Span<const uint8_t> data,
-                               const uint8_t last[kBlockSize],
-                               uint8_t mac[kBlockSize]) const {
-  uint8_t block[kBlockSize];
-  std::copy_n(data.begin(), kBlockSize, block);
-  size_t idx = kBlockSize;
-  while (kBlockSize <= data.size() - idx) {
-    EncryptBlock(block, block);
-    XorBlock(block, &data[idx], block);
-    idx += kBlockSize;
-  }
-  size_t remaining = data.size() - idx;
+// Finishes Cmac(XorEnd(data, xor_end))
+void AesSivBoringSsl::CmacLongFinish(absl::Span<const uint8_t> tail,
+                                     const uint8_t xor_end[kBlockSize],
+                                     uint8_t state[kBlockSize],
+                                     uint8_t mac[kBlockSize]) const {
+  XorBlock(state, tail.data(), state);
+  size_t remaining = tail.size() - kBlockSize;
   for (int j = 0; j < kBlockSize - remaining; ++j) {
-    block[remaining + j] ^= last[j];
+    state[remaining + j] ^= xor_end[j];
   }
   if (remaining == 0) {
-    XorBlock(block, cmac_k1_.data(), block);
+    XorBlock(state, cmac_k1_.data(), state);
   } else {
-    EncryptBlock(block, block);
+    EncryptBlock(state, state);
     for (int j = 0; j < remaining; ++j) {
-      block[j] ^= last[kBlockSize - remaining + j];
-      block[j] ^= data[idx + j];
+      state[j] ^= xor_end[kBlockSize - remaining + j];
+      state[j] ^= tail[kBlockSize + j];
     }
-    block[remaining] ^= 0x80;
-    XorBlock(block, cmac_k2_.data(), block);
+    state[remaining] ^= 0x80;
+    XorBlock(state, cmac_k2_.data(), state);
   }
-  EncryptBlock(block, mac);
+  EncryptBlock(state, mac);
 }
 
 void AesSivBoringSsl::S2v(absl::Span<const uint8_t> aad,
                           absl::Span<const uint8_t> msg,
                           uint8_t siv[kBlockSize]) const {
-  // This stuff could be precomputed.
-  uint8_t block[kBlockSize];
-  std::fill(std::begin(block), std::end(block), 0);
-  Cmac(block, block);
-  MultiplyByX(block);
+  // The CMACs of aad and msg are independent up to the last bytes of msg,
+  // which are combined with the CMAC of aad. Both chains run in lockstep.
+  uint8_t aad_state[kBlockSize];
+  uint8_t msg_state[kBlockSize];
+  std::fill(std::begin(aad_state), std::end(aad_state), 0);
+  std::fill(std::begin(msg_state), std::end(msg_state), 0);
+  CbcMacLane lanes[] = {
+      {aad.subspan(0, CmacPrefixSize(aad.size())), aad_state},
+      {msg.subspan(0, S2vMessagePrefixSize(msg.size())), msg_state}};
+  CbcMacLanes(absl::MakeSpan(lanes));
+  S2vFinish(aad, msg, aad_state, msg_state, siv);
+}
+
+// static
+size_t AesSivBoringSsl::S2vMessagePrefixSize(size_t size) {
+  return size >= kBlockSize ? (size / kBlockSize - 1) * kBlockSize : 0;
+}
 
-  uint8_t aad_mac[kBlockSize];
-  Cmac(aad, aad_mac);
-  XorBlock(block, aad_mac, block);
+void AesSivBoringSsl::S2vFinish(absl::Span<const uint8_t> aad,
+                                absl::Span<const uint8_t> msg,
+                                uint8_t aad_state[kBlockSize],
+                                uint8_t msg_state[kBlockSize],
+                                uint8_t siv[kBlockSize]) const {
+  uint8_t block[kBlockSize];
+  CmacFinish(aad.subspan(CmacPrefixSize(aad.size())), aad_state, block);
+  XorBlock(block, s2v_zero_.data(), block);
 
   if (msg.size() >= kBlockSize) {
-    CmacLong(msg, block, siv);
+    CmacLongFinish(msg.subspan(S2vMessagePrefixSize(msg.size())), block,
+                   msg_state, siv);
   } else {
     MultiplyByX(block);
     for (size_t i = 0; i < msg.size(); ++i) {
@@ -195,6 +273,38 @@ void AesSivBoringSsl::S2v(absl::Span<const uint8_t> aad,
   }
 }
 
+void AesSivBoringSsl::S2vBatch(
+    absl::Span<const absl::string_view> associated_data,
+    absl::Span<const absl::string_view> messages, uint8_t* sivs) const {
+  constexpr size_t kMessagesPerGroup = kMaxCbcMacLanes / 2;
+  uint8_t states[kMaxCbcMacLanes][kBlockSize];
+  CbcMacLane lanes[kMaxCbcMacLanes];
+  for (size_t first = 0; first < messages.size();
+       first += kMessagesPerGroup) {
+    const size_t group_size =
+        std::min(kMessagesPerGroup, messages.size() - first);
+    for (size_t i = 0; i < group_size; ++i) {
+      absl::Span<const uint8_t> aad =
+          AsBytes(internal::BatchAssociatedData(associated_data, first + i));
+      absl::Span<const uint8_t> msg = AsBytes(messages[first + i]);
+      std::fill(std::begin(states[2 * i]), std::end(states[2 * i]), 0);
+      std::fill(std::begin(states[2 * i + 1]), std::end(states[2 * i + 1]),
+                0);
+      lanes[2 * i] = {aad.subspan(0, CmacPrefixSize(aad.size())),
+                      states[2 * i]};
+      lanes[2 * i + 1] = {msg.subspan(0, S2vMessagePrefixSize(msg.size())),
+                          states[2 * i + 1]};
+    }
+    CbcMacLanes(absl::MakeSpan(lanes, 2 * group_size));
+    for (size_t i = 0; i < group_size; ++i) {
+      S2vFinish(
+          AsBytes(internal::BatchAssociatedData(associated_data, first + i)),
+          AsBytes(messages[first + i]), states[2 * i], states[2 * i + 1],
+          sivs + (first + i) * kBlockSize);
+    }
+  }
+}
+
 util::Status AesSivBoringSsl::AesCtrCrypt(absl::string_view in,
                                           const uint8_t siv[kBlockSize],
                                           const AES_KEY* key,
@@ -209,11 +319,7 @@ util::Status AesSivBoringSsl::AesCtrCrypt(absl::string_view in,
 util::StatusOr<std::string> AesSivBoringSsl::EncryptDeterministically(
     absl::string_view plaintext, absl::string_view associated_data) const {
   uint8_t siv[kBlockSize];
-  S2v(absl::MakeSpan(reinterpret_cast<const uint8_t*>(associated_data.data()),
-                     associated_data.size()),
-      absl::MakeSpan(reinterpret_cast<const uint8_t*>(plaintext.data()),
-                     plaintext.size()),
-      siv);
+  S2v(AsBytes(associated_data), AsBytes(plaintext), siv);
   size_t ciphertext_size = plaintext.size() + kBlockSize;
 
   std::string ciphertext;
@@ -245,11 +351,7 @@ util::StatusOr<std::string> AesSivBoringSsl::DecryptDeterministically(
   }
 
   uint8_t s2v[kBlockSize];
-  S2v(absl::MakeSpan(reinterpret_cast<const uint8_t*>(associated_data.data()),
-                     associated_data.size()),
-      absl::MakeSpan(reinterpret_cast<const uint8_t*>(plaintext.data()),
-                     plaintext_size),
-      s2v);
+  S2v(AsBytes(associated_data), AsBytes(plaintext), s2v);
   if (CRYPTO_memcmp(siv, s2v, kBlockSize) != 0) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "invalid ciphertext");
@@ -257,6 +359,97 @@ util::StatusOr<std::string> AesSivBoringSsl::DecryptDeterministically(
   return plaintext;
 }
 
+util::Status AesSivBoringSsl::EncryptDeterministicallyBatchWithPrefix(
+    absl::string_view output_prefix,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* ciphertexts, std::vector<int64_t>* offsets) const {
+  util::Status status = internal::ValidateBatchAssociatedData(
+      plaintexts.size(), associated_data);
+  if (!status.ok()) {
+    return status;
+  }
+  std::vector<uint8_t> sivs(plaintexts.size() * kBlockSize);
+  S2vBatch(associated_data, plaintexts, sivs.data());
+
+  offsets->resize(plaintexts.size() + 1);
+  (*offsets)[0] = 0;
+  for (int64_t i = 0; i < plaintexts.size(); ++i) {
+    (*offsets)[i + 1] = (*offsets)[i] + output_prefix.size() + kBlockSize +
+                        plaintexts[i].size();
+  }
+  ciphertexts->clear();
+  ResizeStringUninitialized(ciphertexts, offsets->back());
+  for (int64_t i = 0; i < plaintexts.size(); ++i) {
+    const uint8_t* siv = &sivs[i * kBlockSize];
+    const int64_t siv_offset = (*offsets)[i] + output_prefix.size();
+    std::copy(output_prefix.begin(), output_prefix.end(),
+              &(*ciphertexts)[(*offsets)[i]]);
+    std::copy_n(siv, kBlockSize, &(*ciphertexts)[siv_offset]);
+    util::Status res = AesCtrCrypt(
+        plaintexts[i], siv, k2_.get(),
+        absl::MakeSpan(*ciphertexts)
+            .subspan(siv_offset + kBlockSize, plaintexts[i].size()));
+    if (!res.ok()) {
+      return res;
+    }
+  }
+  return util::OkStatus();
+}
+
+util::Status AesSivBoringSsl::DecryptDeterministicallyBatch(
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* plaintexts, std::vector<int64_t>* offsets) const {
+  util::Status status = internal::ValidateBatchAssociatedData(
+      ciphertexts.size(), associated_data);
+  if (!status.ok()) {
+    internal::ClearFailedBatchOutputs(plaintexts, offsets);
+    return status;
+  }
+  offsets->resize(ciphertexts.size() + 1);
+  (*offsets)[0] = 0;
+  for (int64_t i = 0; i < ciphertexts.size(); ++i) {
+    if (ciphertexts[i].size() < kBlockSize) {
+      internal::ClearFailedBatchOutputs(plaintexts, offsets);
+      return util::Status(absl::StatusCode::kInvalidArgument,
+                          "ciphertext too short");
+    }
+    (*offsets)[i + 1] = (*offsets)[i] + ciphertexts[i].size() - kBlockSize;
+  }
+  plaintexts->clear();
+  ResizeStringUninitialized(plaintexts, offsets->back());
+  std::vector<absl::string_view> plaintext_views;
+  plaintext_views.reserve(ciphertexts.size());
+  for (int64_t i = 0; i < ciphertexts.size(); ++i) {
+    const int64_t plaintext_size = (*offsets)[i + 1] - (*offsets)[i];
+    util::Status res = AesCtrCrypt(
+        ciphertexts[i].substr(kBlockSize),
+        reinterpret_cast<const uint8_t*>(ciphertexts[i].data()), k2_.get(),
+        absl::MakeSpan(*plaintexts).subspan((*offsets)[i], plaintext_size));
+    if (!res.ok()) {
+      internal::ClearFailedBatchOutputs(plaintexts, offsets);
+      return res;
+    }
+    plaintext_views.push_back(
+        absl::string_view(*plaintexts).substr((*offsets)[i], plaintext_size));
+  }
+
+  std::vector<uint8_t> s2vs(ciphertexts.size() * kBlockSize);
+  S2vBatch(associated_data, plaintext_views, s2vs.data());
+  int mismatch = 0;
+  for (int64_t i = 0; i < ciphertexts.size(); ++i) {
+    mismatch |= CRYPTO_memcmp(ciphertexts[i].data(), &s2vs[i * kBlockSize],
+                              kBlockSize);
+  }
+  if (mismatch != 0) {
+    internal::ClearFailedBatchOutputs(plaintexts, offsets);
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "invalid ciphertext");
+  }
+  return util::OkStatus();
+}
+
 }  // namespace subtle
 }  // namespace tink
 }  // namespace crypto
@@ -17,9 +17,11 @@
 #ifndef TINK_SUBTLE_AES_SIV_BORINGSSL_H_
 #define TINK_SUBTLE_AES_SIV_BORINGSSL_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
@@ -70,6 +72,20 @@ class AesSivBoringSsl : public DeterministicAead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const override;
 
+  // Encrypts/decrypts the whole batch directly into the output buffer; see
+  // DeterministicAead::EncryptDeterministicallyBatchWithPrefix. The S2V
+  // computations of several inputs are interleaved.
+  crypto::tink::util::Status EncryptDeterministicallyBatchWithPrefix(
+      absl::string_view output_prefix,
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* ciphertexts, std::vector<int64_t>* offsets) const override;
+
+  crypto::tink::util::Status DecryptDeterministicallyBatch(
+      absl::Span<const absl::string_view> ciphertexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* plaintexts, std::vector<int64_t>* offsets) const override;
+
   static bool IsValidKeySizeInBytes(size_t size) { return size == 64; }
 
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
@@ -77,32 +93,65 @@ class AesSivBoringSsl : public DeterministicAead {
 
  private:
   static constexpr size_t kBlockSize = internal::AesBlockSize();
+  // Maximum number of CBC-MAC chains advanced in lockstep.
+  static constexpr int kMaxCbcMacLanes = 8;
+
+  // A CBC-MAC chain: the data still to absorb and the state it goes into.
+  struct CbcMacLane {
+    absl::Span<const uint8_t> data;
+    uint8_t* state;
+  };
 
   AesSivBoringSsl(util::SecretUniquePtr<AES_KEY> k1,
                   util::SecretUniquePtr<AES_KEY> k2)
       : k1_(std::move(k1)),
         k2_(std::move(k2)),
         cmac_k1_(ComputeCmacK1()),
-        cmac_k2_(ComputeCmacK2()) {}
+        cmac_k2_(ComputeCmacK2()),
+        s2v_zero_(ComputeS2vZero()) {}
 
   // Precomputes cmac_k1
   util::SecretData ComputeCmacK1() const;
   // Precomputes cmac_k2
   util::SecretData ComputeCmacK2() const;
+  // Precomputes s2v_zero_, the S2V starting value dbl(CMAC(0^128)).
+  util::SecretData ComputeS2vZero() const;
 
-  // Encrypts a single block using k2_.
+  // Encrypts a single block using k1_.
   // This is used for CMACs.
   void EncryptBlock(const uint8_t in[kBlockSize],
                     uint8_t out[kBlockSize]) const;
 
+  // Absorbs the full blocks of `data` into the CBC-MAC state `state`, i.e.
+  // sets state = E(state ^ block) for each block. The size of `data` must be
+  // a multiple of kBlockSize.
+  void CbcMac(absl::Span<const uint8_t> data, uint8_t state[kBlockSize]) const;
+
+  // Same as calling CbcMac(lane.data, lane.state) for each lane, but advances
+  // all chains in lockstep. The chains are independent, so the block
+  // encryptions of one overlap with those of the others. At most
+  // kMaxCbcMacLanes lanes may be passed.
+  void CbcMacLanes(absl::Span<CbcMacLane> lanes) const;
+
+  // Returns the number of leading bytes of a `size` byte input that CMAC
+  // processes as plain CBC-MAC blocks, i.e. everything but the last block.
+  static size_t CmacPrefixSize(size_t size);
+
   // Computes a CMAC of some data.
   void Cmac(absl::Span<const uint8_t> data, uint8_t mac[kBlockSize]) const;
 
-  // Computes CMAC(XorEnd(data, last)), where XorEnd
-  // xors the bytes in last to the last bytes in data.
-  // The size of the data must be at least 16 bytes.
-  void CmacLong(absl::Span<const uint8_t> data, const uint8_t last[kBlockSize],
-                uint8_t mac[kBlockSize]) const;
+  // Finishes a CMAC whose CBC-MAC state `state` has absorbed the first
+  // CmacPrefixSize() bytes of the input. `last` holds the remaining bytes.
+  void CmacFinish(absl::Span<const uint8_t> last, uint8_t state[kBlockSize],
+                  uint8_t mac[kBlockSize]) const;
+
+  // Finishes CMAC(XorEnd(data, xor_end)), where XorEnd xors the bytes in
+  // xor_end to the last bytes in data, and `state` has absorbed all but the
+  // last 16 to 31 bytes of data. `tail` holds these remaining bytes.
+  void CmacLongFinish(absl::Span<const uint8_t> tail,
+                      const uint8_t xor_end[kBlockSize],
+                      uint8_t state[kBlockSize],
+                      uint8_t mac[kBlockSize]) const;
 
   // Multiplying an element in GF(2^128) by its generator.
   // This functions is incorrectly named "doubling" in section 2.3 of RFC 5297.
@@ -116,6 +165,27 @@ class AesSivBoringSsl : public DeterministicAead {
   void S2v(absl::Span<const uint8_t> aad, absl::Span<const uint8_t> msg,
            uint8_t siv[kBlockSize]) const;
 
+  // Returns the number of leading bytes of a `size` byte message that S2V
+  // processes as plain CBC-MAC blocks. The remaining 16 to 31 bytes (or the
+  // whole message if shorter than a block) are combined with the CMAC of the
+  // associated data.
+  static size_t S2vMessagePrefixSize(size_t size);
+
+  // Finishes S2V, given CBC-MAC states that have absorbed the first
+  // CmacPrefixSize(aad.size()) bytes of aad and the first
+  // S2vMessagePrefixSize(msg.size()) bytes of msg.
+  void S2vFinish(absl::Span<const uint8_t> aad, absl::Span<const uint8_t> msg,
+                 uint8_t aad_state[kBlockSize], uint8_t msg_state[kBlockSize],
+                 uint8_t siv[kBlockSize]) const;
+
+  // Computes the SIVs of a batch of messages, with batch associated data as
+  // in DeterministicAead::EncryptDeterministicallyBatch, and writes them back
+  // to back into `sivs`. The chains of kMaxCbcMacLanes / 2 messages are
+  // advanced together.
+  void S2vBatch(absl::Span<const absl::string_view> associated_data,
+                absl::Span<const absl::string_view> messages,
+                uint8_t* sivs) const;
+
   // Encrypts (or decrypts) `in` using an SIV `siv` and key `key`, and writes
   // the result to `out`.
   util::Status AesCtrCrypt(absl::string_view in, const uint8_t siv[kBlockSize],
@@ -125,6 +195,7 @@ class AesSivBoringSsl : public DeterministicAead {
   const util::SecretUniquePtr<AES_KEY> k2_;
   const util::SecretData cmac_k1_;
   const util::SecretData cmac_k2_;
+  const util::SecretData s2v_zero_;
 };
 
 }  // namespace subtle
@@ -24,6 +24,8 @@
 
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
 #include "tink/config/tink_fips.h"
 #include "tink/subtle/wycheproof_util.h"
 #include "tink/util/secret_data.h"
@@ -36,6 +38,7 @@ namespace tink {
 namespace subtle {
 namespace {
 
+using ::crypto::tink::test::IsOk;
 using ::crypto::tink::test::StatusIs;
 
 TEST(AesSivBoringSslTest, testCarryComputation) {
@@ -180,6 +183,121 @@ TEST(AesSivBoringSslTest, testEncryptDecryptAssociatedDataSize) {
   }
 }
 
+// The CMACs of the associated data and of the message are computed in
+// lockstep. Checks the SIV for combinations where one chain is longer than the
+// other, or where the message is shorter than a block.
+TEST(AesSivBoringSslTest, testSivForMessageAndAssociatedDataSizes) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  struct TestCase {
+    int associated_data_size;
+    int message_size;
+    std::string siv_hex;
+  };
+  const std::vector<TestCase> test_cases = {
+      {0, 0, "6ff5b8ef53fc365606cd3ea047374885"},
+      {0, 48, "da3861c32b527e3f7517ef9d0bda2717"},
+      {16, 16, "dd3445aa4e70aee8f1db4173b939629d"},
+      {17, 31, "5c185faa01733dca6571e1aaf4f233ee"},
+      {48, 33, "b7317e927bc9c1b29fa6ffcb54963a1f"},
+      {33, 100, "c5f7acd228d28a87b83728111d795d3f"},
+      {100, 47, "d8a5ad43bd20c090e1047d0a488f9593"},
+  };
+  std::string key_bytes;
+  for (int i = 0; i < 64; ++i) {
+    key_bytes.push_back(static_cast<char>(i));
+  }
+  auto res = AesSivBoringSsl::New(util::SecretDataFromStringView(key_bytes));
+  ASSERT_TRUE(res.ok()) << res.status();
+  auto cipher = std::move(res.value());
+  for (const TestCase& test_case : test_cases) {
+    std::string associated_data;
+    for (int i = 0; i < test_case.associated_data_size; ++i) {
+      associated_data.push_back(static_cast<char>(i));
+    }
+    std::string message;
+    for (int i = 0; i < test_case.message_size; ++i) {
+      message.push_back(static_cast<char>(0x80 + i));
+    }
+    auto ct = cipher->EncryptDeterministically(message, associated_data);
+    ASSERT_TRUE(ct.ok()) << ct.status();
+    EXPECT_EQ(test::HexEncode(ct.value().substr(0, 16)), test_case.siv_hex)
+        << "associated_data_size: " << test_case.associated_data_size
+        << " message_size: " << test_case.message_size;
+    auto pt = cipher->DecryptDeterministically(ct.value(), associated_data);
+    ASSERT_TRUE(pt.ok()) << pt.status();
+    EXPECT_EQ(pt.value(), message);
+  }
+}
+
+TEST(AesSivBoringSslTest, testEncryptDecryptBatch) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  util::SecretData key = util::SecretDataFromStringView(test::HexDecodeOrDie(
+      "000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e1f"
+      "00112233445566778899aabbccddeefff0f1f2f3f4f5f6f7f8f9fafbfcfdfeff"));
+  auto res = AesSivBoringSsl::New(key);
+  ASSERT_TRUE(res.ok()) << res.status();
+  auto cipher = std::move(res.value());
+
+  // More values than are interleaved at once, of varying sizes.
+  std::vector<std::string> messages;
+  std::vector<std::string> associated_data;
+  for (int i = 0; i < 11; ++i) {
+    messages.push_back(std::string(i * 7, 'a' + i));
+    associated_data.push_back(std::string(i * 5 % 40, 'A' + i));
+  }
+  std::vector<absl::string_view> message_views(messages.begin(),
+                                               messages.end());
+  std::vector<absl::string_view> associated_data_views(associated_data.begin(),
+                                                       associated_data.end());
+  std::string ciphertexts;
+  std::vector<int64_t> offsets;
+  ASSERT_THAT(cipher->EncryptDeterministicallyBatch(
+                  message_views, associated_data_views, &ciphertexts,
+                  &offsets),
+              IsOk());
+  ASSERT_EQ(offsets.size(), messages.size() + 1);
+
+  // Ciphertexts of a batch are the regular ciphertexts.
+  std::vector<absl::string_view> ciphertext_views;
+  for (int i = 0; i < messages.size(); ++i) {
+    absl::string_view ciphertext = absl::string_view(ciphertexts).substr(
+        offsets[i], offsets[i + 1] - offsets[i]);
+    auto ct = cipher->EncryptDeterministically(messages[i], associated_data[i]);
+    ASSERT_TRUE(ct.ok()) << ct.status();
+    EXPECT_EQ(ciphertext, ct.value());
+    ciphertext_views.push_back(ciphertext);
+  }
+
+  std::string plaintexts;
+  ASSERT_THAT(cipher->DecryptDeterministicallyBatch(
+                  ciphertext_views, associated_data_views, &plaintexts,
+                  &offsets),
+              IsOk());
+  EXPECT_EQ(plaintexts, absl::StrJoin(messages, ""));
+
+  // A single modified ciphertext fails the whole batch, and no plaintext is
+  // returned.
+  std::string modified(ciphertext_views.back());
+  modified[modified.size() - 1] ^= 1;
+  ciphertext_views.back() = modified;
+  EXPECT_THAT(cipher->DecryptDeterministicallyBatch(
+                  ciphertext_views, associated_data_views, &plaintexts,
+                  &offsets),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_EQ(plaintexts, std::string(plaintexts.size(), '\0'));
+
+  // So does a ciphertext shorter than the SIV.
+  ciphertext_views.back() = "too short";
+  EXPECT_THAT(cipher->DecryptDeterministicallyBatch(
+                  ciphertext_views, associated_data_views, &plaintexts,
+                  &offsets),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(AesSivBoringSslTest, testDecryptModification) {
   if (IsFipsModeEnabled()) {
     GTEST_SKIP() << "Not supported in FIPS-only mode";
@@ -27,7 +27,10 @@
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/synchronization/blocking_counter.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "tink/internal/thread_pool.h"
 #include "tink/random_access_stream.h"
 #include "tink/subtle/stream_segment_decrypter.h"
 #include "tink/util/buffer.h"
@@ -49,6 +52,15 @@ using crypto::tink::util::StatusOr;
 StatusOr<std::unique_ptr<RandomAccessStream>> DecryptingRandomAccessStream::New(
     std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
     std::unique_ptr<RandomAccessStream> ciphertext_source) {
+  return New(std::move(segment_decrypter), std::move(ciphertext_source),
+             Options());
+}
+
+// static
+StatusOr<std::unique_ptr<RandomAccessStream>> DecryptingRandomAccessStream::New(
+    std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
+    std::unique_ptr<RandomAccessStream> ciphertext_source,
+    const Options& options) {
   if (segment_decrypter == nullptr) {
     return Status(absl::StatusCode::kInvalidArgument,
                   "segment_decrypter must be non-null");
@@ -57,6 +69,10 @@ StatusOr<std::unique_ptr<RandomAccessStream>> DecryptingRandomAccessStream::New(
     return Status(absl::StatusCode::kInvalidArgument,
                   "cipertext_source must be non-null");
   }
+  if (options.max_cached_segments < 0 || options.num_threads < 0) {
+    return Status(absl::StatusCode::kInvalidArgument,
+                  "max_cached_segments and num_threads must be non-negative");
+  }
   std::unique_ptr<DecryptingRandomAccessStream> dec_stream(
       new DecryptingRandomAccessStream());
   absl::MutexLock lock(&(dec_stream->status_mutex_));
@@ -78,6 +94,11 @@ StatusOr<std::unique_ptr<RandomAccessStream>> DecryptingRandomAccessStream::New(
   dec_stream->status_ =
       Status(absl::StatusCode::kUnavailable,
              "The header hasn't been read yet.");
+  dec_stream->max_cached_segments_ = options.max_cached_segments;
+  if (options.num_threads > 0) {
+    dec_stream->thread_pool_ =
+        absl::make_unique<internal::ThreadPool>(options.num_threads);
+  }
   return {std::move(dec_stream)};
 }
 
@@ -191,22 +212,18 @@ void DecryptingRandomAccessStream::InitializeIfNeeded()
   pt_size_ = ct_size - overhead;
 }
 
-int DecryptingRandomAccessStream::GetPlaintextOffset(int64_t pt_position) {
-  if (GetSegmentNr(pt_position) == 0) return pt_position;
-  // Computed according to the formula:
-  // (pt_position - (pt_segment_size_ - ct_offset_ - header_size_))
-  //     % pt_segment_size_;
-  // pt_position + ct_offset_ + header_size_ is always smaller than size of
-  // the ciphertext, thus it should never overflow.
-  return (pt_position + ct_offset_ + header_size_) % pt_segment_size_;
-}
-
 int64_t DecryptingRandomAccessStream::GetSegmentNr(int64_t pt_position) {
   return (pt_position + ct_offset_ + header_size_) / pt_segment_size_;
 }
 
-util::Status DecryptingRandomAccessStream::ReadAndDecryptSegment(
-    int64_t segment_nr, Buffer* ct_buffer, std::vector<uint8_t>* pt_segment) {
+int64_t DecryptingRandomAccessStream::GetSegmentStart(int64_t segment_nr) {
+  if (segment_nr == 0) return 0;
+  return segment_nr * pt_segment_size_ - ct_offset_ - header_size_;
+}
+
+Status DecryptingRandomAccessStream::ReadSegment(
+    int64_t segment_nr, std::vector<uint8_t>* ct_buffer,
+    absl::Span<const uint8_t>* ct_segment) {
   int64_t ct_position = segment_nr * ct_segment_size_;
   if (ct_position / ct_segment_size_ != segment_nr /* overflow occured! */) {
     return Status(absl::StatusCode::kOutOfRange,
@@ -221,23 +238,103 @@ util::Status DecryptingRandomAccessStream::ReadAndDecryptSegment(
     ct_position = ct_offset_ + header_size_;
     segment_size = ct_segment_size_ - ct_position;
   }
+  // If ct_source_ offers its contents in memory, the segment is decrypted
+  // straight from there.
+  auto view_result = ct_source_->View(ct_position, segment_size);
+  if (view_result.ok()) {
+    *ct_segment = absl::Span<const uint8_t>(
+        reinterpret_cast<const uint8_t*>(view_result->data()),
+        view_result->size());
+    return util::OkStatus();
+  }
+  if (view_result.status().code() != absl::StatusCode::kUnimplemented) {
+    return view_result.status();
+  }
   bool is_last_segment = (segment_nr == segment_count_ - 1);
-  auto pread_status = ct_source_->PRead(ct_position, segment_size, ct_buffer);
-  if (pread_status.ok() ||
-      (is_last_segment && ct_buffer->size() > 0 &&
-       pread_status.code() == absl::StatusCode::kOutOfRange)) {
-    // some bytes were read
-    auto dec_status = segment_decrypter_->DecryptSegment(
-        std::vector<uint8_t>(ct_buffer->get_mem_block(),
-                             ct_buffer->get_mem_block() + ct_buffer->size()),
-        segment_nr, is_last_segment, pt_segment);
-    if (dec_status.ok()) {
-      return is_last_segment ?
-          Status(absl::StatusCode::kOutOfRange, "EOF") : util::OkStatus();
-    }
-    return dec_status;
+  // Otherwise the ciphertext is read directly into 'ct_buffer', which is then
+  // passed to the segment decrypter.
+  ct_buffer->resize(segment_size);
+  auto ct_buffer_result = Buffer::NewNonOwning(
+      reinterpret_cast<char*>(ct_buffer->data()), segment_size);
+  if (!ct_buffer_result.ok()) {
+    return ToStatusF(absl::StatusCode::kInvalidArgument,
+                     "Invalid ciphertext segment size %d.", segment_size);
+  }
+  Buffer* buffer = ct_buffer_result.value().get();
+  auto pread_status = ct_source_->PRead(ct_position, segment_size, buffer);
+  if (!pread_status.ok() &&
+      !(is_last_segment && buffer->size() > 0 &&
+        pread_status.code() == absl::StatusCode::kOutOfRange)) {
+    return pread_status;
   }
-  return pread_status;
+  // some bytes were read
+  ct_buffer->resize(buffer->size());
+  *ct_segment = absl::MakeConstSpan(*ct_buffer);
+  return util::OkStatus();
+}
+
+StatusOr<std::shared_ptr<const std::vector<uint8_t>>>
+DecryptingRandomAccessStream::ReadAndDecryptSegment(int64_t segment_nr) {
+  std::shared_ptr<const std::vector<uint8_t>> cached =
+      GetCachedSegment(segment_nr);
+  if (cached != nullptr) return cached;
+
+  std::vector<uint8_t> ct_buffer;
+  absl::Span<const uint8_t> ct_segment;
+  Status read_status = ReadSegment(segment_nr, &ct_buffer, &ct_segment);
+  if (!read_status.ok()) return read_status;
+  int overhead = ct_segment_size_ - pt_segment_size_;
+  auto pt_segment = std::make_shared<std::vector<uint8_t>>(
+      std::max(static_cast<int>(ct_segment.size()) - overhead, 0));
+  auto dec_status = segment_decrypter_->DecryptSegmentInto(
+      ct_segment, segment_nr, /* is_last_segment = */
+      segment_nr == segment_count_ - 1, absl::MakeSpan(*pt_segment));
+  if (!dec_status.ok()) return dec_status;
+  CacheSegment(segment_nr, pt_segment);
+  return {std::move(pt_segment)};
+}
+
+std::shared_ptr<const std::vector<uint8_t>>
+DecryptingRandomAccessStream::GetCachedSegment(int64_t segment_nr) {
+  if (max_cached_segments_ == 0) return nullptr;
+  absl::MutexLock lock(&cache_mutex_);
+  auto it = cached_segments_.find(segment_nr);
+  if (it == cached_segments_.end()) return nullptr;
+  lru_segments_.splice(lru_segments_.begin(), lru_segments_,
+                       it->second.second);
+  return it->second.first;
+}
+
+void DecryptingRandomAccessStream::CacheSegment(
+    int64_t segment_nr,
+    std::shared_ptr<const std::vector<uint8_t>> pt_segment) {
+  if (max_cached_segments_ == 0) return;
+  absl::MutexLock lock(&cache_mutex_);
+  auto it = cached_segments_.find(segment_nr);
+  if (it != cached_segments_.end()) {
+    // Decrypted concurrently by another PRead()-call.
+    lru_segments_.splice(lru_segments_.begin(), lru_segments_,
+                         it->second.second);
+    return;
+  }
+  if (cached_segments_.size() >= static_cast<size_t>(max_cached_segments_)) {
+    cached_segments_.erase(lru_segments_.back());
+    lru_segments_.pop_back();
+  }
+  lru_segments_.push_front(segment_nr);
+  cached_segments_.emplace(
+      segment_nr, std::make_pair(std::move(pt_segment), lru_segments_.begin()));
+}
+
+Status DecryptingRandomAccessStream::ReadAndDecryptSegmentInto(
+    int64_t segment_nr, absl::Span<uint8_t> pt_segment) {
+  std::vector<uint8_t> ct_buffer;
+  absl::Span<const uint8_t> ct_segment;
+  Status read_status = ReadSegment(segment_nr, &ct_buffer, &ct_segment);
+  if (!read_status.ok()) return read_status;
+  return segment_decrypter_->DecryptSegmentInto(
+      ct_segment, segment_nr, /* is_last_segment = */
+      segment_nr == segment_count_ - 1, pt_segment);
 }
 
 util::Status DecryptingRandomAccessStream::PReadAndDecrypt(
@@ -264,37 +361,86 @@ util::Status DecryptingRandomAccessStream::PReadAndDecrypt(
                     "position is larger than stream size");
     }
   }
-  auto ct_buffer_result = Buffer::New(ct_segment_size_);
-  if (!ct_buffer_result.ok()) {
-    return ToStatusF(absl::StatusCode::kInvalidArgument,
-                     "Invalid ciphertext segment size %d.", ct_segment_size_);
-  }
-  auto ct_buffer = std::move(ct_buffer_result.value());
-  std::vector<uint8_t> pt_segment;
-  int remaining = count;
-  int read_count = 0;
-  int pt_offset = GetPlaintextOffset(position);
-  while (remaining > 0) {
-    auto segment_nr = GetSegmentNr(position + read_count);
-    auto status =
-        ReadAndDecryptSegment(segment_nr, ct_buffer.get(), &pt_segment);
-    if (status.ok() || status.code() == absl::StatusCode::kOutOfRange) {
-      int pt_count = pt_segment.size() - pt_offset;
-      int to_copy_count = std::min(pt_count, remaining);
-      auto s = dest_buffer->set_size(read_count + to_copy_count);
+  if (count == 0) return util::OkStatus();
+
+  int64_t first_segment_nr = GetSegmentNr(position);
+  if (first_segment_nr >= segment_count_) {
+    // 'position' is the end of a stream whose last segment is full.
+    return Status(absl::StatusCode::kOutOfRange, "EOF");
+  }
+  int64_t last_segment_nr = std::min(GetSegmentNr(position + count - 1),
+                                     segment_count_ - 1);
+  int segment_count = last_segment_nr - first_segment_nr + 1;
+
+  // The plaintext bytes [position, end_position) are returned, each segment
+  // writing its part of them to dest_buffer. Segments that lie entirely
+  // within this range are decrypted directly into dest_buffer, unless they
+  // are to be cached.
+  int64_t end_position = std::min(position + count, pt_size_);
+  auto s = dest_buffer->set_size(end_position - position);
+  if (!s.ok()) return s;
+  char* dest = dest_buffer->get_mem_block();
+  auto decrypt_segment = [this, position, end_position,
+                          dest](int64_t segment_nr) -> Status {
+    int64_t segment_start = GetSegmentStart(segment_nr);
+    int64_t segment_end =
+        std::min(GetSegmentStart(segment_nr + 1), pt_size_);
+    int64_t copy_start = std::max(segment_start, position);
+    int64_t copy_end = std::min(segment_end, end_position);
+    if (max_cached_segments_ == 0 && copy_start == segment_start &&
+        copy_end == segment_end) {
+      return ReadAndDecryptSegmentInto(
+          segment_nr,
+          absl::MakeSpan(reinterpret_cast<uint8_t*>(dest) +
+                             (segment_start - position),
+                         segment_end - segment_start));
+    }
+    auto pt_segment = ReadAndDecryptSegment(segment_nr);
+    if (!pt_segment.ok()) return pt_segment.status();
+    if ((*pt_segment)->size() < copy_end - segment_start) {
+      return Status(absl::StatusCode::kInvalidArgument,
+                    "Plaintext segment too short.");
+    }
+    std::memcpy(dest + (copy_start - position),
+                (*pt_segment)->data() + (copy_start - segment_start),
+                copy_end - copy_start);
+    return util::OkStatus();
+  };
+
+  // Decrypts the segments, the first one on this thread and the others on
+  // thread_pool_ (if any).
+  std::vector<Status> statuses(segment_count);
+  if (thread_pool_ != nullptr && segment_count > 1) {
+    absl::BlockingCounter pending(segment_count - 1);
+    for (int i = 1; i < segment_count; i++) {
+      thread_pool_->Schedule(
+          [&decrypt_segment, &statuses, &pending, first_segment_nr, i] {
+            statuses[i] = decrypt_segment(first_segment_nr + i);
+            pending.DecrementCount();
+          });
+    }
+    statuses[0] = decrypt_segment(first_segment_nr);
+    pending.Wait();
+  } else {
+    for (int i = 0; i < segment_count; i++) {
+      statuses[i] = decrypt_segment(first_segment_nr + i);
+      if (!statuses[i].ok()) break;
+    }
+  }
+
+  // Returns the plaintext up to the first failed segment.
+  for (int i = 0; i < segment_count; i++) {
+    if (!statuses[i].ok()) {
+      int64_t segment_start = GetSegmentStart(first_segment_nr + i);
+      s = dest_buffer->set_size(std::max(segment_start - position,
+                                         static_cast<int64_t>(0)));
       if (!s.ok()) return s;
-      std::memcpy(dest_buffer->get_mem_block() + read_count,
-                  pt_segment.data() + pt_offset, to_copy_count);
-      pt_offset = 0;
-      if (status.code() == absl::StatusCode::kOutOfRange &&
-          to_copy_count == pt_count)
-        return status;
-      read_count += to_copy_count;
-      remaining = count - dest_buffer->size();
-    } else {  // some other error happened
-      return status;
+      return statuses[i];
     }
   }
+  if (end_position == pt_size_) {
+    return Status(absl::StatusCode::kOutOfRange, "EOF");
+  }
   return util::OkStatus();
 }
 
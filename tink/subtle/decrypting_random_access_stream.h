@@ -17,10 +17,17 @@
 #ifndef TINK_SUBTLE_DECRYPTING_RANDOM_ACCESS_STREAM_H_
 #define TINK_SUBTLE_DECRYPTING_RANDOM_ACCESS_STREAM_H_
 
+#include <cstdint>
+#include <list>
 #include <memory>
+#include <utility>
 #include <vector>
 
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "tink/internal/thread_pool.h"
 #include "tink/random_access_stream.h"
 #include "tink/subtle/stream_segment_decrypter.h"
 #include "tink/util/statusor.h"
@@ -39,8 +46,23 @@ namespace subtle {
 //  - size()-call returns the size of the entire plaintext
 //    if it were to be decrypted.
 // Instances of this class are thread safe.
+//
+// Optionally, decrypted segments are kept in a bounded LRU cache shared by
+// all PRead()-calls, and the segments of a PRead()-call that spans several
+// segments are decrypted in parallel; see Options.
 class DecryptingRandomAccessStream : public crypto::tink::RandomAccessStream {
  public:
+  struct Options {
+    // Maximum number of decrypted plaintext segments that are cached, so that
+    // PRead()-calls into recently read segments do not decrypt them again.
+    // 0 disables the cache.
+    int max_cached_segments = 0;
+    // Number of worker threads that decrypt the segments of a PRead()-call
+    // which spans several segments. With 0, all segments are decrypted on the
+    // calling thread.
+    int num_threads = 0;
+  };
+
   // A factory that produces decrypting random access streams.
   // The returned stream is a wrapper around 'ciphertext_source',
   // such that any bytes written via the wrapper are AEAD-decrypted
@@ -51,6 +73,13 @@ class DecryptingRandomAccessStream : public crypto::tink::RandomAccessStream {
   New(std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
       std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source);
 
+  // Like New() above, with the caching and parallelism given by 'options'.
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<crypto::tink::RandomAccessStream>>
+  New(std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
+      std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source,
+      const Options& options);
+
   // -----------------------
   // Methods of RandomAccessStream-interface implemented by this class.
   crypto::tink::util::Status PRead(
@@ -63,15 +92,32 @@ class DecryptingRandomAccessStream : public crypto::tink::RandomAccessStream {
   crypto::tink::util::Status PReadAndDecrypt(
       int64_t position, int count, crypto::tink::util::Buffer* dest_buffer);
   // Reads the specified ciphertext segment from ct_source_, decrypts it,
-  // and writes the resulting plaintext bytes to pt_segment.
-  // Uses the provided ct_buffer as a buffer for the ciphertext segment.
-  crypto::tink::util::Status ReadAndDecryptSegment(
-      int64_t segment_nr, crypto::tink::util::Buffer* ct_buffer,
-      std::vector<uint8_t>* pt_segment);
+  // and returns the resulting plaintext bytes.
+  crypto::tink::util::StatusOr<std::shared_ptr<const std::vector<uint8_t>>>
+  ReadAndDecryptSegment(int64_t segment_nr);
+  // Like ReadAndDecryptSegment(), but decrypts directly into 'pt_segment',
+  // which must have exactly the plaintext size of the segment, and bypasses
+  // the cache.
+  crypto::tink::util::Status ReadAndDecryptSegmentInto(
+      int64_t segment_nr, absl::Span<uint8_t> pt_segment);
+  // Reads the specified ciphertext segment from ct_source_ and sets
+  // 'ct_segment' to it: to a view of ct_source_ if it supports View(),
+  // and otherwise to the bytes read into 'ct_buffer'.
+  crypto::tink::util::Status ReadSegment(
+      int64_t segment_nr, std::vector<uint8_t>* ct_buffer,
+      absl::Span<const uint8_t>* ct_segment);
+  // Returns the position of the first plaintext byte of the specified segment.
+  int64_t GetSegmentStart(int64_t segment_nr);
+  // Returns the plaintext of the specified segment from the cache, or nullptr
+  // if it is not cached.
+  std::shared_ptr<const std::vector<uint8_t>> GetCachedSegment(
+      int64_t segment_nr);
+  // Adds the plaintext of the specified segment to the cache, evicting the
+  // least recently used segment if the cache is full.
+  void CacheSegment(int64_t segment_nr,
+                    std::shared_ptr<const std::vector<uint8_t>> pt_segment);
   // Returns the segment number that contains the specified 'pt_position'.
   int64_t GetSegmentNr(int64_t pt_position);
-  // Returns the offset within a segment for the specified 'pt_position'.
-  int GetPlaintextOffset(int64_t pt_position);
   // Initializes this stream (if not initialized yet or in a permantent error)
   // by reading the stream header from ct_source_ and using it initialize
   // segment_decrypter_.
@@ -88,6 +134,20 @@ class DecryptingRandomAccessStream : public crypto::tink::RandomAccessStream {
   int ct_segment_overhead_;
   int64_t segment_count_;
   int64_t pt_size_;
+
+  int max_cached_segments_ = 0;
+  absl::Mutex cache_mutex_;
+  // Cached segment numbers, most recently used first.
+  std::list<int64_t> lru_segments_ ABSL_GUARDED_BY(cache_mutex_);
+  absl::flat_hash_map<int64_t,
+                      std::pair<std::shared_ptr<const std::vector<uint8_t>>,
+                                std::list<int64_t>::iterator>>
+      cached_segments_ ABSL_GUARDED_BY(cache_mutex_);
+
+  // Decrypts segments of multi-segment PRead()-calls; null if
+  // Options::num_threads is 0. Declared last, so that on destruction the
+  // workers finish before the members above are destroyed.
+  std::unique_ptr<internal::ThreadPool> thread_pool_;
 };
 
 }  // namespace subtle
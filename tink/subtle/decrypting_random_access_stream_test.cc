@@ -17,19 +17,23 @@
 #include "tink/subtle/decrypting_random_access_stream.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <limits>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
 #include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/internal/test_random_access_stream.h"
 #include "tink/output_stream.h"
 #include "tink/random_access_stream.h"
@@ -79,6 +83,40 @@ class DummyRandomAccessStream : public RandomAccessStream {
   int ct_offset_;
 };
 
+// A RandomAccessStream over a std::string that also supports View(), and
+// counts the PRead()-calls.
+class ViewableRandomAccessStream : public RandomAccessStream {
+ public:
+  explicit ViewableRandomAccessStream(std::string content)
+      : content_(content), stream_(std::move(content)) {}
+
+  crypto::tink::util::Status PRead(
+      int64_t position, int count,
+      crypto::tink::util::Buffer* dest_buffer) override {
+    pread_count_++;
+    return stream_.PRead(position, count, dest_buffer);
+  }
+
+  crypto::tink::util::StatusOr<int64_t> size() override {
+    return content_.size();
+  }
+
+  crypto::tink::util::StatusOr<absl::string_view> View(int64_t position,
+                                                       int count) override {
+    if (position >= static_cast<int64_t>(content_.size())) {
+      return util::Status(absl::StatusCode::kOutOfRange, "EOF");
+    }
+    return absl::string_view(content_).substr(position, count);
+  }
+
+  int pread_count() const { return pread_count_; }
+
+ private:
+  std::string content_;
+  TestRandomAccessStream stream_;
+  std::atomic<int> pread_count_{0};
+};
+
 // Returns a ciphertext resulting from encryption of 'pt' with 'aad' as
 // associated data, using 'saead'.
 std::string GetCiphertext(StreamingAead* saead, absl::string_view pt,
@@ -393,6 +431,199 @@ TEST(DecryptingRandomAccessStreamTest, NullCiphertextSource) {
                        HasSubstr("cipertext_source must be non-null")));
 }
 
+// A DummyStreamSegmentDecrypter which counts the decrypted segments.
+class CountingSegmentDecrypter : public DummyStreamSegmentDecrypter {
+ public:
+  using DummyStreamSegmentDecrypter::DummyStreamSegmentDecrypter;
+
+  util::Status DecryptSegmentInto(
+      absl::Span<const uint8_t> ciphertext, int64_t segment_number,
+      bool is_last_segment, absl::Span<uint8_t> plaintext) const override {
+    {
+      absl::MutexLock lock(&mutex_);
+      decrypted_segments_++;
+    }
+    return DummyStreamSegmentDecrypter::DecryptSegmentInto(
+        ciphertext, segment_number, is_last_segment, plaintext);
+  }
+
+  int decrypted_segments() {
+    absl::MutexLock lock(&mutex_);
+    return decrypted_segments_;
+  }
+
+ private:
+  mutable absl::Mutex mutex_;
+  mutable int decrypted_segments_ = 0;
+};
+
+TEST(DecryptingRandomAccessStreamTest, SelectiveDecryptionWithOptions) {
+  int pt_segment_size = 50;
+  int header_size = 10;
+  std::vector<DecryptingRandomAccessStream::Options> all_options = {
+      {0, 0}, {0, 4}, {1, 0}, {3, 2}, {100, 4}};
+  for (const auto& options : all_options) {
+    for (int ct_offset : {0, 7}) {
+      for (int pt_size : {0, 1, 40, 1000}) {
+        SCOPED_TRACE(absl::StrCat(
+            "max_cached_segments = ", options.max_cached_segments,
+            ", num_threads = ", options.num_threads,
+            ", ct_offset = ", ct_offset, ", pt_size = ", pt_size));
+        std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
+        DummyStreamingAead saead(pt_segment_size, header_size, ct_offset);
+        auto dec_stream_result = saead.NewParallelDecryptingRandomAccessStream(
+            GetCiphertextSource(&saead, plaintext, "some aad", ct_offset),
+            "some aad", options);
+        ASSERT_THAT(dec_stream_result, IsOk());
+        auto dec_stream = std::move(dec_stream_result.value());
+        // Reads twice, so that the second reads are served from the cache.
+        for (int i = 0; i < 2; i++) {
+          for (int position : {0, 1, pt_size / 3, pt_size / 2, pt_size}) {
+            if (position > pt_size) continue;
+            for (int chunk_size : {1, 49, 50, 51, 200, pt_size}) {
+              SCOPED_TRACE(absl::StrCat("position = ", position,
+                                        ", chunk_size = ", chunk_size));
+              auto buffer =
+                  std::move(util::Buffer::New(std::max(chunk_size, 1)).value());
+              auto status =
+                  dec_stream->PRead(position, chunk_size, buffer.get());
+              int expected_size = std::min(chunk_size, pt_size - position);
+              if (chunk_size > 0 && position + chunk_size >= pt_size) {
+                EXPECT_THAT(status, StatusIs(absl::StatusCode::kOutOfRange));
+              } else {
+                EXPECT_THAT(status, IsOk());
+              }
+              ASSERT_EQ(expected_size, buffer->size());
+              EXPECT_EQ(0, std::memcmp(plaintext.data() + position,
+                                       buffer->get_mem_block(),
+                                       buffer->size()));
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(DecryptingRandomAccessStreamTest, CachedSegmentsAreNotDecryptedAgain) {
+  int pt_segment_size = 100;
+  int header_size = 10;
+  int ct_offset = 0;
+  std::string plaintext = subtle::Random::GetRandomBytes(1000);
+  DummyStreamingAead saead(pt_segment_size, header_size, ct_offset);
+  auto seg_decrypter = absl::make_unique<CountingSegmentDecrypter>(
+      pt_segment_size, header_size, ct_offset);
+  CountingSegmentDecrypter* counter = seg_decrypter.get();
+  DecryptingRandomAccessStream::Options options;
+  options.max_cached_segments = 2;
+  auto dec_stream_result = DecryptingRandomAccessStream::New(
+      std::move(seg_decrypter),
+      GetCiphertextSource(&saead, plaintext, "some aad", ct_offset), options);
+  ASSERT_THAT(dec_stream_result, IsOk());
+  auto dec_stream = std::move(dec_stream_result.value());
+  auto buffer = std::move(util::Buffer::New(10).value());
+
+  // Segment 1 covers the plaintext bytes 90 to 189.
+  ASSERT_THAT(dec_stream->PRead(100, 10, buffer.get()), IsOk());
+  ASSERT_THAT(dec_stream->PRead(150, 10, buffer.get()), IsOk());
+  EXPECT_EQ(counter->decrypted_segments(), 1);
+  EXPECT_EQ(0, std::memcmp(plaintext.data() + 150, buffer->get_mem_block(),
+                           buffer->size()));
+
+  // Reading segments 2 and 3 evicts segment 1.
+  ASSERT_THAT(dec_stream->PRead(200, 10, buffer.get()), IsOk());
+  ASSERT_THAT(dec_stream->PRead(300, 10, buffer.get()), IsOk());
+  EXPECT_EQ(counter->decrypted_segments(), 3);
+  ASSERT_THAT(dec_stream->PRead(100, 10, buffer.get()), IsOk());
+  EXPECT_EQ(counter->decrypted_segments(), 4);
+  ASSERT_THAT(dec_stream->PRead(300, 10, buffer.get()), IsOk());
+  EXPECT_EQ(counter->decrypted_segments(), 4);
+}
+
+TEST(DecryptingRandomAccessStreamTest, ConcurrentPReads) {
+  int pt_segment_size = 64;
+  int header_size = 16;
+  int ct_offset = 3;
+  int pt_size = 10000;
+  std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
+  DummyStreamingAead saead(pt_segment_size, header_size, ct_offset);
+  DecryptingRandomAccessStream::Options options;
+  options.max_cached_segments = 8;
+  options.num_threads = 3;
+  auto dec_stream_result = saead.NewParallelDecryptingRandomAccessStream(
+      GetCiphertextSource(&saead, plaintext, "some aad", ct_offset),
+      "some aad", options);
+  ASSERT_THAT(dec_stream_result, IsOk());
+  RandomAccessStream* dec_stream = dec_stream_result.value().get();
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([dec_stream, &plaintext, pt_size, t] {
+      auto buffer = std::move(util::Buffer::New(300).value());
+      for (int i = 0; i < 200; i++) {
+        int position = (t * 997 + i * 131) % (pt_size - 300);
+        int chunk_size = 1 + (t * 31 + i * 17) % 300;
+        EXPECT_THAT(dec_stream->PRead(position, chunk_size, buffer.get()),
+                    IsOk());
+        EXPECT_EQ(chunk_size, buffer->size());
+        EXPECT_EQ(0, std::memcmp(plaintext.data() + position,
+                                 buffer->get_mem_block(), buffer->size()));
+      }
+    });
+  }
+  for (std::thread& thread : threads) thread.join();
+}
+
+TEST(DecryptingRandomAccessStreamTest, DecryptsFromViews) {
+  int pt_segment_size = 100;
+  int header_size = 10;
+  int ct_offset = 5;
+  int pt_size = 1000;
+  std::string plaintext = subtle::Random::GetRandomBytes(pt_size);
+  DummyStreamingAead saead(pt_segment_size, header_size, ct_offset);
+  std::vector<DecryptingRandomAccessStream::Options> all_options = {
+      {0, 0}, {2, 0}, {0, 3}};
+  for (const auto& options : all_options) {
+    SCOPED_TRACE(absl::StrCat("max_cached_segments = ",
+                              options.max_cached_segments,
+                              ", num_threads = ", options.num_threads));
+    auto ct_source = absl::make_unique<ViewableRandomAccessStream>(
+        GetCiphertext(&saead, plaintext, "some aad", ct_offset));
+    ViewableRandomAccessStream* ct_source_ptr = ct_source.get();
+    auto dec_stream_result = DecryptingRandomAccessStream::New(
+        absl::make_unique<DummyStreamSegmentDecrypter>(
+            pt_segment_size, header_size, ct_offset),
+        std::move(ct_source), options);
+    ASSERT_THAT(dec_stream_result, IsOk());
+    auto dec_stream = std::move(dec_stream_result.value());
+
+    std::string decrypted;
+    EXPECT_THAT(
+        internal::ReadAllFromRandomAccessStream(dec_stream.get(), decrypted),
+        StatusIs(absl::StatusCode::kOutOfRange));
+    EXPECT_EQ(plaintext, decrypted);
+    auto buffer = std::move(util::Buffer::New(pt_size).value());
+    EXPECT_THAT(dec_stream->PRead(0, pt_size, buffer.get()),
+                StatusIs(absl::StatusCode::kOutOfRange));
+    EXPECT_EQ(plaintext, std::string(buffer->get_mem_block(), buffer->size()));
+    // Only the header is read with PRead().
+    EXPECT_EQ(ct_source_ptr->pread_count(), 1);
+  }
+}
+
+TEST(DecryptingRandomAccessStreamTest, InvalidOptions) {
+  auto seg_decrypter =
+      absl::make_unique<DummyStreamSegmentDecrypter>(42, 10, 0);
+  DecryptingRandomAccessStream::Options options;
+  options.max_cached_segments = -1;
+  EXPECT_THAT(DecryptingRandomAccessStream::New(
+                  std::move(seg_decrypter),
+                  std::make_unique<TestRandomAccessStream>("ciphertext"),
+                  options)
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 }  // namespace
 }  // namespace subtle
 }  // namespace tink
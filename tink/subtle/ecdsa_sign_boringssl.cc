@@ -22,9 +22,10 @@
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
 #include "tink/internal/md_util.h"
-#include "tink/internal/util.h"
 #include "tink/signature/internal/ecdsa_raw_sign_boringssl.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/subtle_util_boringssl.h"
@@ -60,22 +61,21 @@ util::StatusOr<std::unique_ptr<EcdsaSignBoringSsl>> EcdsaSignBoringSsl::New(
 
 util::StatusOr<std::string> EcdsaSignBoringSsl::Sign(
     absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = internal::EnsureStringNonNull(data);
+  return SignFromParts({data});
+}
 
+util::StatusOr<std::string> EcdsaSignBoringSsl::SignFromParts(
+    absl::Span<const absl::string_view> data_parts) const {
   // Compute the digest.
-  unsigned int digest_size;
-  uint8_t digest[EVP_MAX_MD_SIZE];
-  if (1 != EVP_Digest(data.data(), data.size(), digest, &digest_size, hash_,
-                      nullptr)) {
+  util::StatusOr<std::string> digest =
+      internal::ComputeHashFromParts(data_parts, *hash_);
+  if (!digest.ok()) {
     return util::Status(absl::StatusCode::kInternal,
                         "Could not compute digest.");
   }
 
   // Compute the signature.
-  return raw_signer_->Sign(
-      absl::string_view(reinterpret_cast<char*>(digest), digest_size));
+  return raw_signer_->Sign(*digest);
 }
 
 }  // namespace subtle
@@ -22,6 +22,7 @@
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/public_key_sign.h"
@@ -45,6 +46,10 @@ class EcdsaSignBoringSsl : public PublicKeySign {
   crypto::tink::util::StatusOr<std::string> Sign(
       absl::string_view data) const override;
 
+  // Hashes the parts one after the other, without concatenating them.
+  crypto::tink::util::StatusOr<std::string> SignFromParts(
+      absl::Span<const absl::string_view> data_parts) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kRequiresBoringCrypto;
 
@@ -16,11 +16,14 @@
 
 #include "tink/subtle/ecdsa_sign_boringssl.h"
 
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
+#include "absl/strings/string_view.h"
 #include "tink/internal/ec_util.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/public_key_sign.h"
@@ -83,6 +86,36 @@ TEST_F(EcdsaSignBoringSslTest, testBasicSigning) {
   }
 }
 
+TEST_F(EcdsaSignBoringSslTest, SignFromParts) {
+  if (internal::IsFipsModeEnabled() && !internal::IsFipsEnabledInSsl()) {
+    GTEST_SKIP()
+        << "Test is skipped if kOnlyUseFips but BoringCrypto is unavailable.";
+  }
+  auto ec_key =
+      SubtleUtilBoringSSL::GetNewEcKey(EllipticCurveType::NIST_P256).value();
+  util::StatusOr<std::unique_ptr<EcdsaSignBoringSsl>> signer =
+      EcdsaSignBoringSsl::New(ec_key, HashType::SHA256,
+                              EcdsaSignatureEncoding::DER);
+  ASSERT_THAT(signer, IsOk());
+  util::StatusOr<std::unique_ptr<EcdsaVerifyBoringSsl>> verifier =
+      EcdsaVerifyBoringSsl::New(ec_key, HashType::SHA256,
+                                EcdsaSignatureEncoding::DER);
+  ASSERT_THAT(verifier, IsOk());
+
+  // A signature of the parts is a signature of their concatenation.
+  std::vector<absl::string_view> parts = {"some data ", "", "to be signed"};
+  util::StatusOr<std::string> signature = (*signer)->SignFromParts(parts);
+  ASSERT_THAT(signature, IsOk());
+  EXPECT_THAT((*verifier)->Verify(*signature, "some data to be signed"),
+              IsOk());
+  EXPECT_THAT((*verifier)->VerifyFromParts(*signature, parts), IsOk());
+
+  std::vector<absl::string_view> other_parts = {"some data ", "to be signed",
+                                                "!"};
+  EXPECT_THAT((*verifier)->VerifyFromParts(*signature, other_parts),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST_F(EcdsaSignBoringSslTest, testEncodingsMismatch) {
   if (internal::IsFipsModeEnabled() && !internal::IsFipsEnabledInSsl()) {
     GTEST_SKIP()
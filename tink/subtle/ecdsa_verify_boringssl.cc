@@ -16,12 +16,15 @@
 
 #include "tink/subtle/ecdsa_verify_boringssl.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/bn.h"
 #include "openssl/ec.h"
 #include "openssl/ecdsa.h"
@@ -30,7 +33,6 @@
 #include "tink/internal/err_util.h"
 #include "tink/internal/md_util.h"
 #include "tink/internal/ssl_unique_ptr.h"
-#include "tink/internal/util.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/subtle_util_boringssl.h"
 #include "tink/util/errors.h"
@@ -87,15 +89,18 @@ util::StatusOr<std::unique_ptr<EcdsaVerifyBoringSsl>> EcdsaVerifyBoringSsl::New(
 
 util::Status EcdsaVerifyBoringSsl::Verify(absl::string_view signature,
                                           absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = internal::EnsureStringNonNull(data);
+  return VerifyFromParts(signature, {data});
+}
 
+util::Status EcdsaVerifyBoringSsl::VerifyFromParts(
+    absl::string_view signature,
+    absl::Span<const absl::string_view> data_parts) const {
   // Compute the digest.
-  unsigned int digest_size;
   uint8_t digest[EVP_MAX_MD_SIZE];
-  if (1 != EVP_Digest(data.data(), data.size(), digest, &digest_size, hash_,
-                      nullptr)) {
+  util::StatusOr<uint32_t> digest_length =
+      internal::ComputeHashFromPartsInto(data_parts, *hash_,
+                                         absl::MakeSpan(digest));
+  if (!digest_length.ok()) {
     return util::Status(absl::StatusCode::kInternal,
                         "Could not compute digest.");
   }
@@ -112,7 +117,7 @@ util::Status EcdsaVerifyBoringSsl::Verify(absl::string_view signature,
   }
 
   // Verify the signature.
-  if (1 != ECDSA_verify(0 /* unused */, digest, digest_size,
+  if (1 != ECDSA_verify(0 /* unused */, digest, *digest_length,
                         reinterpret_cast<const uint8_t*>(derSig.data()),
                         derSig.size(), key_.get())) {
     // signature is invalid
@@ -21,6 +21,7 @@
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/ec.h"
 #include "openssl/evp.h"
 #include "tink/internal/fips_utils.h"
@@ -50,6 +51,11 @@ class EcdsaVerifyBoringSsl : public PublicKeyVerify {
       absl::string_view signature,
       absl::string_view data) const override;
 
+  // Hashes the parts one after the other, without concatenating them.
+  crypto::tink::util::Status VerifyFromParts(
+      absl::string_view signature,
+      absl::Span<const absl::string_view> data_parts) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kRequiresBoringCrypto;
 
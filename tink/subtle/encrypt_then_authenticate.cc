@@ -16,6 +16,7 @@
 
 #include "tink/subtle/encrypt_then_authenticate.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -25,10 +26,14 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/crypto.h"
 #include "tink/aead.h"
 #include "tink/internal/util.h"
 #include "tink/mac.h"
 #include "tink/subtle/ind_cpa_cipher.h"
+#include "tink/subtle/mac/stateful_mac.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/util/errors.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -54,7 +59,40 @@ util::StatusOr<std::unique_ptr<Aead>> EncryptThenAuthenticate::New(
                         "tag size too small");
   }
   std::unique_ptr<Aead> aead(new EncryptThenAuthenticate(
-      std::move(ind_cpa_cipher), std::move(mac), tag_size));
+      std::move(ind_cpa_cipher), std::move(mac), /*mac_factory=*/nullptr,
+      tag_size));
+  return std::move(aead);
+}
+
+util::StatusOr<std::unique_ptr<Aead>> EncryptThenAuthenticate::New(
+    std::unique_ptr<IndCpaCipher> ind_cpa_cipher,
+    std::unique_ptr<StatefulMacFactory> mac_factory, uint8_t tag_size) {
+  if (tag_size < kMinTagSizeInBytes) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "tag size too small");
+  }
+  std::unique_ptr<Aead> aead(new EncryptThenAuthenticate(
+      std::move(ind_cpa_cipher), /*mac=*/nullptr, std::move(mac_factory),
+      tag_size));
+  return std::move(aead);
+}
+
+util::StatusOr<std::unique_ptr<ZeroCopyAead>>
+EncryptThenAuthenticate::NewZeroCopy(
+    std::unique_ptr<IndCpaCipher> ind_cpa_cipher,
+    std::unique_ptr<StatefulMacFactory> mac_factory, uint8_t tag_size) {
+  if (tag_size < kMinTagSizeInBytes) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "tag size too small");
+  }
+  if (ind_cpa_cipher->CiphertextSize(0) < 0 ||
+      ind_cpa_cipher->PlaintextSize(0) < 0) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "cipher does not support encryption into buffers");
+  }
+  std::unique_ptr<ZeroCopyAead> aead(new EncryptThenAuthenticate(
+      std::move(ind_cpa_cipher), /*mac=*/nullptr, std::move(mac_factory),
+      tag_size));
   return std::move(aead);
 }
 
@@ -73,20 +111,134 @@ util::StatusOr<std::string> EncryptThenAuthenticate::Encrypt(
                         "associated data too long");
   }
 
-  auto ciphertext = ind_cpa_cipher_->Encrypt(plaintext);
-  if (!ciphertext.ok()) {
-    return ciphertext.status();
+  // If the cipher supports it, encrypt directly into the output, leaving room
+  // for the tag, so that appending the tag does not reallocate.
+  std::string ciphertext;
+  if (ind_cpa_cipher_->CiphertextSize(plaintext.size()) >= 0) {
+    ResizeStringUninitialized(&ciphertext,
+                              MaxEncryptionSize(plaintext.size()));
+    util::Status status = EncryptAndTagToBuffer(
+        plaintext, associated_data, absl::MakeSpan(ciphertext));
+    if (!status.ok()) {
+      return status;
+    }
+    return ciphertext;
+  }
+
+  util::StatusOr<std::string> raw_ciphertext =
+      ind_cpa_cipher_->Encrypt(plaintext);
+  if (!raw_ciphertext.ok()) {
+    return raw_ciphertext.status();
+  }
+  util::StatusOr<std::string> tag =
+      ComputeTag(associated_data, *raw_ciphertext);
+  if (!tag.ok()) {
+    return tag.status();
+  }
+  return absl::StrCat(*raw_ciphertext, *tag);
+}
+
+util::Status EncryptThenAuthenticate::EncryptAndTagToBuffer(
+    absl::string_view plaintext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
+  const int64_t raw_ciphertext_size = buffer.size() - tag_size_;
+  absl::Span<char> raw_ciphertext = buffer.subspan(0, raw_ciphertext_size);
+  util::StatusOr<std::string> tag;
+  if (mac_factory_ == nullptr) {
+    util::Status status =
+        ind_cpa_cipher_->EncryptToBuffer(plaintext, raw_ciphertext);
+    if (!status.ok()) {
+      return status;
+    }
+    tag = ComputeTag(associated_data,
+                     absl::string_view(raw_ciphertext.data(),
+                                       raw_ciphertext.size()));
+  } else {
+    util::StatusOr<std::unique_ptr<StatefulMac>> mac = mac_factory_->Create();
+    if (!mac.ok()) {
+      return mac.status();
+    }
+    util::Status status = (*mac)->Update(associated_data);
+    if (!status.ok()) {
+      return status;
+    }
+    // Each piece of ciphertext is MACed right after it is written.
+    status = ind_cpa_cipher_->EncryptToBufferAndVisit(
+        plaintext, raw_ciphertext,
+        [&mac](absl::string_view ciphertext_piece) {
+          return (*mac)->Update(ciphertext_piece);
+        });
+    if (!status.ok()) {
+      return status;
+    }
+    status = (*mac)->Update(longToBigEndianStr(associated_data.size() * 8));
+    if (!status.ok()) {
+      return status;
+    }
+    tag = (*mac)->Finalize();
   }
-  auto tag = mac_->ComputeMac(
-      absl::StrCat(associated_data, *ciphertext,
-                   longToBigEndianStr(associated_data_size_in_bits)));
   if (!tag.ok()) {
     return tag.status();
   }
   if (tag->size() != tag_size_) {
     return util::Status(absl::StatusCode::kInternal, "invalid tag size");
   }
-  return ciphertext->append(tag.value());
+  std::copy(tag->begin(), tag->end(), buffer.begin() + raw_ciphertext_size);
+  return util::OkStatus();
+}
+
+util::StatusOr<std::string> EncryptThenAuthenticate::ComputeTag(
+    absl::string_view associated_data,
+    absl::string_view raw_ciphertext) const {
+  const std::string associated_data_size_in_bits =
+      longToBigEndianStr(associated_data.size() * 8);
+  util::StatusOr<std::string> tag;
+  if (mac_factory_ == nullptr) {
+    tag = mac_->ComputeMacFromParts(
+        {associated_data, raw_ciphertext, associated_data_size_in_bits});
+  } else {
+    util::StatusOr<std::unique_ptr<StatefulMac>> mac = mac_factory_->Create();
+    if (!mac.ok()) {
+      return mac.status();
+    }
+    for (absl::string_view part :
+         {associated_data, raw_ciphertext,
+          absl::string_view(associated_data_size_in_bits)}) {
+      util::Status status = (*mac)->Update(part);
+      if (!status.ok()) {
+        return status;
+      }
+    }
+    tag = (*mac)->Finalize();
+  }
+  if (!tag.ok()) {
+    return tag.status();
+  }
+  if (tag->size() != tag_size_) {
+    return util::Status(absl::StatusCode::kInternal, "invalid tag size");
+  }
+  return tag;
+}
+
+util::Status EncryptThenAuthenticate::VerifyTag(
+    absl::string_view associated_data, absl::string_view raw_ciphertext,
+    absl::string_view tag) const {
+  if (mac_factory_ == nullptr) {
+    return mac_->VerifyMacFromParts(
+        tag, {associated_data, raw_ciphertext,
+              longToBigEndianStr(associated_data.size() * 8)});
+  }
+  util::StatusOr<std::string> expected_tag =
+      ComputeTag(associated_data, raw_ciphertext);
+  if (!expected_tag.ok()) {
+    return expected_tag.status();
+  }
+  if (expected_tag->size() != tag.size() ||
+      CRYPTO_memcmp(expected_tag->data(), tag.data(), tag.size()) != 0) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "verification failed");
+  }
+  return util::OkStatus();
 }
 
 util::StatusOr<std::string> EncryptThenAuthenticate::Decrypt(
@@ -108,22 +260,91 @@ util::StatusOr<std::string> EncryptThenAuthenticate::Decrypt(
                         "additional data too long");
   }
 
-  auto payload = ciphertext.substr(0, ciphertext.size() - tag_size_);
-  auto tag = ciphertext.substr(ciphertext.size() - tag_size_, tag_size_);
+  absl::string_view payload =
+      ciphertext.substr(0, ciphertext.size() - tag_size_);
+  absl::string_view tag = ciphertext.substr(payload.size());
 
-  auto verified = mac_->VerifyMac(
-      tag, absl::StrCat(associated_data, payload,
-                        longToBigEndianStr(associated_data_size_in_bits)));
-  if (!verified.ok()) {
-    return verified;
+  // The whole ciphertext is authenticated before any of it is decrypted, so
+  // that no plaintext of a forged ciphertext is ever produced.
+  util::Status status = VerifyTag(associated_data, payload, tag);
+  if (!status.ok()) {
+    return status;
+  }
+  const int64_t plaintext_size = ind_cpa_cipher_->PlaintextSize(payload.size());
+  if (plaintext_size < 0) {
+    return ind_cpa_cipher_->Decrypt(payload);
   }
+  std::string plaintext;
+  ResizeStringUninitialized(&plaintext, plaintext_size);
+  status = ind_cpa_cipher_->DecryptToBuffer(payload, absl::MakeSpan(plaintext));
+  if (!status.ok()) {
+    return status;
+  }
+  return plaintext;
+}
 
-  auto pt = ind_cpa_cipher_->Decrypt(payload);
-  if (!pt.ok()) {
-    return pt.status();
+int64_t EncryptThenAuthenticate::MaxEncryptionSize(
+    int64_t plaintext_size) const {
+  return ind_cpa_cipher_->CiphertextSize(plaintext_size) + tag_size_;
+}
+
+util::StatusOr<int64_t> EncryptThenAuthenticate::Encrypt(
+    absl::string_view plaintext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
+  plaintext = internal::EnsureStringNonNull(plaintext);
+  associated_data = internal::EnsureStringNonNull(associated_data);
+  const int64_t ciphertext_size = MaxEncryptionSize(plaintext.size());
+  if (static_cast<int64_t>(buffer.size()) < ciphertext_size) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "encryption buffer too small");
+  }
+  util::Status status = EncryptAndTagToBuffer(
+      plaintext, associated_data, buffer.subspan(0, ciphertext_size));
+  if (!status.ok()) {
+    return status;
   }
+  return ciphertext_size;
+}
+
+int64_t EncryptThenAuthenticate::MaxDecryptionSize(
+    int64_t ciphertext_size) const {
+  return ind_cpa_cipher_->PlaintextSize(
+      std::max<int64_t>(ciphertext_size - tag_size_, 0));
+}
 
-  return pt.value();
+util::StatusOr<int64_t> EncryptThenAuthenticate::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
+  associated_data = internal::EnsureStringNonNull(associated_data);
+  if (ciphertext.size() < tag_size_) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "ciphertext too short");
+  }
+  const int64_t plaintext_size = MaxDecryptionSize(ciphertext.size());
+  if (static_cast<int64_t>(buffer.size()) < plaintext_size) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "decryption buffer too small");
+  }
+  if (internal::BuffersOverlap(
+          ciphertext, absl::string_view(buffer.data(), plaintext_size))) {
+    return util::Status(
+        absl::StatusCode::kFailedPrecondition,
+        "Plaintext and ciphertext buffers overlap; this is disallowed");
+  }
+  absl::string_view payload =
+      ciphertext.substr(0, ciphertext.size() - tag_size_);
+  absl::string_view tag = ciphertext.substr(payload.size());
+  util::Status status = VerifyTag(associated_data, payload, tag);
+  if (!status.ok()) {
+    std::fill_n(buffer.data(), plaintext_size, 0);
+    return status;
+  }
+  status = ind_cpa_cipher_->DecryptToBuffer(
+      payload, buffer.subspan(0, plaintext_size));
+  if (!status.ok()) {
+    return status;
+  }
+  return plaintext_size;
 }
 
 }  // namespace subtle
@@ -22,9 +22,12 @@
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/mac.h"
 #include "tink/subtle/ind_cpa_cipher.h"
+#include "tink/subtle/mac/stateful_mac.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
@@ -36,12 +39,28 @@ namespace subtle {
 // associated data (ad). The Mac is computed over (ad ||
 // ciphertext || size of ad). This implementation is based on
 // http://tools.ietf.org/html/draft-mcgrew-aead-aes-cbc-hmac-sha2-05.
-class EncryptThenAuthenticate : public Aead {
+class EncryptThenAuthenticate : public Aead, public ZeroCopyAead {
  public:
   static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
       std::unique_ptr<IndCpaCipher> ind_cpa_cipher, std::unique_ptr<Mac> mac,
       uint8_t tag_size);
 
+  // As above, but computes the MAC incrementally with a StatefulMac created by
+  // 'mac_factory' for each message. This avoids copying the associated data
+  // and the ciphertext into a single MAC input. 'mac_factory' must produce
+  // tags of 'tag_size' bytes.
+  static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
+      std::unique_ptr<IndCpaCipher> ind_cpa_cipher,
+      std::unique_ptr<StatefulMacFactory> mac_factory, uint8_t tag_size);
+
+  // Same as New() with a StatefulMacFactory, but returns the ZeroCopyAead
+  // view of the primitive. 'ind_cpa_cipher' must support EncryptToBuffer()
+  // and DecryptToBuffer().
+  static crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>>
+  NewZeroCopy(std::unique_ptr<IndCpaCipher> ind_cpa_cipher,
+              std::unique_ptr<StatefulMacFactory> mac_factory,
+              uint8_t tag_size);
+
   // Encrypts 'plaintext' with 'associated_data'. The resulting ciphertext
   // allows for checking authenticity and integrity of associated_data (ad), but
   // does not guarantee its secrecy.
@@ -58,17 +77,56 @@ class EncryptThenAuthenticate : public Aead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const override;
 
+  // ZeroCopyAead: the ciphertext is written into the caller's `buffer`, in
+  // the same format as Encrypt() above. The tag is verified before anything
+  // is decrypted into `buffer`.
+  int64_t MaxEncryptionSize(int64_t plaintext_size) const override;
+
+  crypto::tink::util::StatusOr<int64_t> Encrypt(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> buffer) const override;
+
+  int64_t MaxDecryptionSize(int64_t ciphertext_size) const override;
+
+  crypto::tink::util::StatusOr<int64_t> Decrypt(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> buffer) const override;
+
  private:
   static constexpr int kMinTagSizeInBytes = 10;
 
   EncryptThenAuthenticate(std::unique_ptr<IndCpaCipher> ind_cpa_cipher,
-                          std::unique_ptr<Mac> mac, uint8_t tag_size)
+                          std::unique_ptr<Mac> mac,
+                          std::unique_ptr<StatefulMacFactory> mac_factory,
+                          uint8_t tag_size)
       : ind_cpa_cipher_(std::move(ind_cpa_cipher)),
         mac_(std::move(mac)),
+        mac_factory_(std::move(mac_factory)),
         tag_size_(tag_size) {}
 
+  // Encrypts 'plaintext' into 'buffer', which must be exactly
+  // MaxEncryptionSize(plaintext.size()) bytes long, and appends the tag. With
+  // mac_factory_, the ciphertext is MACed piece by piece, interleaved with the
+  // cipher, so that the data is read from memory only once.
+  crypto::tink::util::Status EncryptAndTagToBuffer(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> buffer) const;
+
+  // Returns the MAC of (associated_data || raw_ciphertext || size of
+  // associated_data in bits).
+  crypto::tink::util::StatusOr<std::string> ComputeTag(
+      absl::string_view associated_data,
+      absl::string_view raw_ciphertext) const;
+
+  // Checks that 'tag' is the MAC of 'raw_ciphertext' as in ComputeTag().
+  crypto::tink::util::Status VerifyTag(absl::string_view associated_data,
+                                       absl::string_view raw_ciphertext,
+                                       absl::string_view tag) const;
+
   const std::unique_ptr<IndCpaCipher> ind_cpa_cipher_;
+  // Exactly one of mac_ and mac_factory_ is set.
   const std::unique_ptr<Mac> mac_;
+  const std::unique_ptr<StatefulMacFactory> mac_factory_;
   const uint8_t tag_size_;
 };
 
@@ -21,14 +21,23 @@
 #include <utility>
 #include <vector>
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/aead/zero_copy_aead.h"
+#include "tink/mac.h"
 #include "tink/subtle/aes_ctr_boringssl.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/subtle/hmac_boringssl.h"
+#include "tink/subtle/ind_cpa_cipher.h"
 #include "tink/subtle/random.h"
+#include "tink/subtle/stateful_hmac_boringssl.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
 #include "tink/util/test_util.h"
 
 namespace crypto {
@@ -36,6 +45,12 @@ namespace tink {
 namespace subtle {
 namespace {
 
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::IsOkAndHolds;
+using ::crypto::tink::test::StatusIs;
+using ::testing::Each;
+using ::testing::Not;
+
 // Copied from
 // https://tools.ietf.org/html/draft-mcgrew-aead-aes-cbc-hmac-sha2-05.
 // We use CTR but the RFC uses CBC mode, so it's not possible to compare
@@ -265,6 +280,296 @@ TEST(EncryptThenAuthenticateTest, testParamsEmptyVersusNullStringView) {
   }
 }
 
+// Returns EncryptThenAuthenticate with a StatefulMac instead of a Mac.
+util::StatusOr<std::unique_ptr<Aead>> CreateAeadWithStatefulMac(
+    util::SecretData encryption_key, int iv_size, util::SecretData mac_key,
+    uint8_t tag_size, HashType hash_type) {
+  util::StatusOr<std::unique_ptr<IndCpaCipher>> ind_cpa_cipher =
+      AesCtrBoringSsl::New(std::move(encryption_key), iv_size);
+  if (!ind_cpa_cipher.ok()) {
+    return ind_cpa_cipher.status();
+  }
+  return EncryptThenAuthenticate::New(
+      *std::move(ind_cpa_cipher),
+      absl::make_unique<StatefulHmacBoringSslFactory>(hash_type, tag_size,
+                                                      mac_key),
+      tag_size);
+}
+
+// IndCpaCipher which does not support encryption into a caller buffer.
+class StringOnlyIndCpaCipher : public IndCpaCipher {
+ public:
+  explicit StringOnlyIndCpaCipher(std::unique_ptr<IndCpaCipher> cipher)
+      : cipher_(std::move(cipher)) {}
+
+  util::StatusOr<std::string> Encrypt(
+      absl::string_view plaintext) const override {
+    return cipher_->Encrypt(plaintext);
+  }
+
+  util::StatusOr<std::string> Decrypt(
+      absl::string_view ciphertext) const override {
+    return cipher_->Decrypt(ciphertext);
+  }
+
+ private:
+  const std::unique_ptr<IndCpaCipher> cipher_;
+};
+
+// IndCpaCipher which counts the decryptions it is asked to do.
+class DecryptionCountingIndCpaCipher : public StringOnlyIndCpaCipher {
+ public:
+  DecryptionCountingIndCpaCipher(std::unique_ptr<IndCpaCipher> cipher,
+                                 int* decryptions)
+      : StringOnlyIndCpaCipher(std::move(cipher)), decryptions_(decryptions) {}
+
+  util::StatusOr<std::string> Decrypt(
+      absl::string_view ciphertext) const override {
+    ++*decryptions_;
+    return StringOnlyIndCpaCipher::Decrypt(ciphertext);
+  }
+
+ private:
+  int* const decryptions_;
+};
+
+TEST(EncryptThenAuthenticateTest, DecryptVerifiesTagBeforeDecrypting) {
+  int iv_size = 12;
+  int tag_size = 16;
+  util::SecretData encryption_key = Random::GetRandomKeyBytes(16);
+  util::SecretData mac_key = Random::GetRandomKeyBytes(16);
+  for (bool stateful_mac : {false, true}) {
+    SCOPED_TRACE(stateful_mac);
+    util::StatusOr<std::unique_ptr<IndCpaCipher>> ind_cpa_cipher =
+        AesCtrBoringSsl::New(encryption_key, iv_size);
+    ASSERT_THAT(ind_cpa_cipher, IsOk());
+    int decryptions = 0;
+    auto counting_cipher = absl::make_unique<DecryptionCountingIndCpaCipher>(
+        *std::move(ind_cpa_cipher), &decryptions);
+    util::StatusOr<std::unique_ptr<Aead>> aead;
+    if (stateful_mac) {
+      aead = EncryptThenAuthenticate::New(
+          std::move(counting_cipher),
+          absl::make_unique<StatefulHmacBoringSslFactory>(HashType::SHA256,
+                                                          tag_size, mac_key),
+          tag_size);
+    } else {
+      util::StatusOr<std::unique_ptr<Mac>> mac =
+          HmacBoringSsl::New(HashType::SHA256, tag_size, mac_key);
+      ASSERT_THAT(mac, IsOk());
+      aead = EncryptThenAuthenticate::New(std::move(counting_cipher),
+                                          *std::move(mac), tag_size);
+    }
+    ASSERT_THAT(aead, IsOk());
+
+    std::string message = "Some data to encrypt.";
+    std::string associated_data = "Some data to authenticate.";
+    util::StatusOr<std::string> ct = (*aead)->Encrypt(message, associated_data);
+    ASSERT_THAT(ct, IsOk());
+    std::string modified_ct = *ct;
+    modified_ct[iv_size] ^= 1;
+    EXPECT_THAT((*aead)->Decrypt(modified_ct, associated_data), Not(IsOk()));
+    EXPECT_THAT((*aead)->Decrypt(*ct, "other associated data"), Not(IsOk()));
+    EXPECT_EQ(decryptions, 0);
+    EXPECT_THAT((*aead)->Decrypt(*ct, associated_data), IsOkAndHolds(message));
+    EXPECT_EQ(decryptions, 1);
+  }
+}
+
+TEST(EncryptThenAuthenticateTest, StatefulMacRfcVectors) {
+  for (const TestVector& test : test_vectors) {
+    util::SecretData mac_key =
+        util::SecretDataFromStringView(test::HexDecodeOrDie(test.mac_key));
+    util::SecretData enc_key =
+        util::SecretDataFromStringView(test::HexDecodeOrDie(test.enc_key));
+    std::string ct = test::HexDecodeOrDie(test.ciphertext);
+    std::string associated_data = test::HexDecodeOrDie(test.associated_data);
+    util::StatusOr<std::unique_ptr<Aead>> aead = CreateAeadWithStatefulMac(
+        std::move(enc_key), test.iv_size, std::move(mac_key), test.tag_size,
+        test.hash_type);
+    ASSERT_THAT(aead, IsOk());
+    EXPECT_THAT((*aead)->Decrypt(ct, associated_data), IsOk());
+  }
+}
+
+TEST(EncryptThenAuthenticateTest, StatefulMacMatchesMac) {
+  int iv_size = 12;
+  int tag_size = 16;
+  util::SecretData encryption_key = Random::GetRandomKeyBytes(16);
+  util::SecretData mac_key = Random::GetRandomKeyBytes(16);
+  util::StatusOr<std::unique_ptr<Aead>> aead = createAead2(
+      encryption_key, iv_size, mac_key, tag_size, HashType::SHA256);
+  ASSERT_THAT(aead, IsOk());
+  util::StatusOr<std::unique_ptr<Aead>> stateful_mac_aead =
+      CreateAeadWithStatefulMac(encryption_key, iv_size, mac_key, tag_size,
+                                HashType::SHA256);
+  ASSERT_THAT(stateful_mac_aead, IsOk());
+
+  for (int i = 0; i < 64; i++) {
+    std::string message = Random::GetRandomBytes(i);
+    std::string associated_data = Random::GetRandomBytes(i);
+    util::StatusOr<std::string> ct =
+        (*stateful_mac_aead)->Encrypt(message, associated_data);
+    ASSERT_THAT(ct, IsOk());
+    EXPECT_EQ(ct->size(), message.size() + iv_size + tag_size);
+    EXPECT_THAT((*aead)->Decrypt(*ct, associated_data), IsOkAndHolds(message));
+
+    ct = (*aead)->Encrypt(message, associated_data);
+    ASSERT_THAT(ct, IsOk());
+    EXPECT_THAT((*stateful_mac_aead)->Decrypt(*ct, associated_data),
+                IsOkAndHolds(message));
+  }
+}
+
+TEST(EncryptThenAuthenticateTest, StatefulMacModifiedCiphertext) {
+  util::StatusOr<std::unique_ptr<Aead>> aead = CreateAeadWithStatefulMac(
+      Random::GetRandomKeyBytes(16), /*iv_size=*/12,
+      Random::GetRandomKeyBytes(16), /*tag_size=*/16, HashType::SHA256);
+  ASSERT_THAT(aead, IsOk());
+
+  std::string message = "Some data to encrypt.";
+  std::string associated_data = "Some data to authenticate.";
+  util::StatusOr<std::string> ct = (*aead)->Encrypt(message, associated_data);
+  ASSERT_THAT(ct, IsOk());
+  for (size_t i = 0; i < ct->size() * 8; i++) {
+    std::string modified_ct = *ct;
+    modified_ct[i / 8] ^= 1 << (i % 8);
+    EXPECT_THAT((*aead)->Decrypt(modified_ct, associated_data), Not(IsOk()))
+        << i;
+  }
+  for (size_t i = 0; i < associated_data.size() * 8; i++) {
+    std::string modified_associated_data = associated_data;
+    modified_associated_data[i / 8] ^= 1 << (i % 8);
+    EXPECT_THAT((*aead)->Decrypt(*ct, modified_associated_data), Not(IsOk()))
+        << i;
+  }
+  for (size_t i = 0; i < ct->size(); i++) {
+    EXPECT_THAT((*aead)->Decrypt(ct->substr(0, i), associated_data),
+                Not(IsOk()))
+        << i;
+  }
+}
+
+TEST(EncryptThenAuthenticateTest, CipherWithoutEncryptToBuffer) {
+  int iv_size = 12;
+  int tag_size = 16;
+  util::SecretData encryption_key = Random::GetRandomKeyBytes(16);
+  util::SecretData mac_key = Random::GetRandomKeyBytes(16);
+  util::StatusOr<std::unique_ptr<IndCpaCipher>> ind_cpa_cipher =
+      AesCtrBoringSsl::New(encryption_key, iv_size);
+  ASSERT_THAT(ind_cpa_cipher, IsOk());
+  util::StatusOr<std::unique_ptr<Aead>> string_only_aead =
+      EncryptThenAuthenticate::New(
+          absl::make_unique<StringOnlyIndCpaCipher>(*std::move(ind_cpa_cipher)),
+          absl::make_unique<StatefulHmacBoringSslFactory>(HashType::SHA256,
+                                                          tag_size, mac_key),
+          tag_size);
+  ASSERT_THAT(string_only_aead, IsOk());
+  util::StatusOr<std::unique_ptr<Aead>> aead = CreateAeadWithStatefulMac(
+      encryption_key, iv_size, mac_key, tag_size, HashType::SHA256);
+  ASSERT_THAT(aead, IsOk());
+
+  std::string message = "Some data to encrypt.";
+  std::string associated_data = "Some data to authenticate.";
+  util::StatusOr<std::string> ct =
+      (*string_only_aead)->Encrypt(message, associated_data);
+  ASSERT_THAT(ct, IsOk());
+  EXPECT_EQ(ct->size(), message.size() + iv_size + tag_size);
+  EXPECT_THAT((*aead)->Decrypt(*ct, associated_data), IsOkAndHolds(message));
+}
+
+TEST(EncryptThenAuthenticateTest, ZeroCopyMatchesAead) {
+  int iv_size = 12;
+  int tag_size = 16;
+  util::SecretData encryption_key = Random::GetRandomKeyBytes(16);
+  util::SecretData mac_key = Random::GetRandomKeyBytes(16);
+  util::StatusOr<std::unique_ptr<IndCpaCipher>> ind_cpa_cipher =
+      AesCtrBoringSsl::New(encryption_key, iv_size);
+  ASSERT_THAT(ind_cpa_cipher, IsOk());
+  util::StatusOr<std::unique_ptr<ZeroCopyAead>> zero_copy_aead =
+      EncryptThenAuthenticate::NewZeroCopy(
+          *std::move(ind_cpa_cipher),
+          absl::make_unique<StatefulHmacBoringSslFactory>(HashType::SHA256,
+                                                          tag_size, mac_key),
+          tag_size);
+  ASSERT_THAT(zero_copy_aead, IsOk());
+  util::StatusOr<std::unique_ptr<Aead>> aead = createAead2(
+      encryption_key, iv_size, mac_key, tag_size, HashType::SHA256);
+  ASSERT_THAT(aead, IsOk());
+
+  for (int i = 0; i < 64; i++) {
+    std::string message = Random::GetRandomBytes(i);
+    std::string associated_data = Random::GetRandomBytes(i);
+    std::string ct((*zero_copy_aead)->MaxEncryptionSize(message.size()), '\0');
+    ASSERT_THAT((*zero_copy_aead)
+                    ->Encrypt(message, associated_data, absl::MakeSpan(ct)),
+                IsOkAndHolds(message.size() + iv_size + tag_size));
+    EXPECT_THAT((*aead)->Decrypt(ct, associated_data), IsOkAndHolds(message));
+
+    util::StatusOr<std::string> aead_ct =
+        (*aead)->Encrypt(message, associated_data);
+    ASSERT_THAT(aead_ct, IsOk());
+    std::string plaintext(
+        (*zero_copy_aead)->MaxDecryptionSize(aead_ct->size()), '\0');
+    ASSERT_THAT(
+        (*zero_copy_aead)
+            ->Decrypt(*aead_ct, associated_data, absl::MakeSpan(plaintext)),
+        IsOkAndHolds(message.size()));
+    EXPECT_EQ(plaintext, message);
+  }
+}
+
+TEST(EncryptThenAuthenticateTest, ZeroCopyDecryptModifiedCiphertext) {
+  int tag_size = 16;
+  util::StatusOr<std::unique_ptr<IndCpaCipher>> ind_cpa_cipher =
+      AesCtrBoringSsl::New(Random::GetRandomKeyBytes(16), /*iv_size=*/12);
+  ASSERT_THAT(ind_cpa_cipher, IsOk());
+  util::StatusOr<std::unique_ptr<ZeroCopyAead>> aead =
+      EncryptThenAuthenticate::NewZeroCopy(
+          *std::move(ind_cpa_cipher),
+          absl::make_unique<StatefulHmacBoringSslFactory>(
+              HashType::SHA256, tag_size, Random::GetRandomKeyBytes(16)),
+          tag_size);
+  ASSERT_THAT(aead, IsOk());
+
+  std::string message = "Some data to encrypt.";
+  std::string associated_data = "Some data to authenticate.";
+  std::string ct((*aead)->MaxEncryptionSize(message.size()), '\0');
+  ASSERT_THAT((*aead)->Encrypt(message, associated_data, absl::MakeSpan(ct)),
+              IsOk());
+  for (size_t i = 0; i < ct.size() * 8; i++) {
+    std::string modified_ct = ct;
+    modified_ct[i / 8] ^= 1 << (i % 8);
+    // Nothing but zeros is written to the buffer if the tag does not verify.
+    std::string plaintext((*aead)->MaxDecryptionSize(ct.size()), 'x');
+    EXPECT_THAT((*aead)
+                    ->Decrypt(modified_ct, associated_data,
+                              absl::MakeSpan(plaintext))
+                    .status(),
+                StatusIs(absl::StatusCode::kInvalidArgument))
+        << i;
+    EXPECT_THAT(plaintext, Each('\0')) << i;
+  }
+  std::string plaintext((*aead)->MaxDecryptionSize(ct.size()) - 1, '\0');
+  EXPECT_THAT(
+      (*aead)->Decrypt(ct, associated_data, absl::MakeSpan(plaintext)).status(),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(EncryptThenAuthenticateTest, ZeroCopyRequiresBufferSupport) {
+  util::StatusOr<std::unique_ptr<IndCpaCipher>> ind_cpa_cipher =
+      AesCtrBoringSsl::New(Random::GetRandomKeyBytes(16), /*iv_size=*/12);
+  ASSERT_THAT(ind_cpa_cipher, IsOk());
+  EXPECT_THAT(
+      EncryptThenAuthenticate::NewZeroCopy(
+          absl::make_unique<StringOnlyIndCpaCipher>(*std::move(ind_cpa_cipher)),
+          absl::make_unique<StatefulHmacBoringSslFactory>(
+              HashType::SHA256, /*tag_size=*/16, Random::GetRandomKeyBytes(16)),
+          /*tag_size=*/16)
+          .status(),
+      Not(IsOk()));
+}
+
 // EncryptThenAuthenticate computes the MAC over associated_data || ciphertext
 // || associated_data_size_in_bits, where associated_data_size_in_bits =
 // associated_data.size() * 8 [1]. associated_data.size() returns a size_t which
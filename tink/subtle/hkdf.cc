@@ -19,22 +19,12 @@
 #include <cstdint>
 #include <string>
 
-#include "absl/algorithm/container.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "openssl/evp.h"
-// BoringSSL and OpenSSL have incompatible ways to compute HKDF: BoringSSL
-// provides a one-shot API HKDF, while OpenSSL doesn't make that API public, but
-// instead provides this functionality over the EVP interface, which in turn
-// doesn't provide means to compute HKDF in BoringSSL. As a consequence, we need
-// to selectively include the correct header and use different implementations.
-#ifdef OPENSSL_IS_BORINGSSL
-#include "openssl/base.h"
-#include "openssl/hkdf.h"
-#else
-#include "openssl/kdf.h"
-#endif
+#include "openssl/hmac.h"
+#include "tink/internal/hkdf_util.h"
 #include "tink/internal/md_util.h"
 #include "tink/internal/ssl_unique_ptr.h"
 #include "tink/subtle/common_enums.h"
@@ -48,37 +38,31 @@ namespace tink {
 namespace subtle {
 namespace {
 
-// Compute HKDF using `evp_md` hashing, key `ikm`, salt `salt` and info `info`.
-// The result is written to `key`.
-util::Status SslHkdf(const EVP_MD *evp_md, absl::string_view ikm,
-                     absl::string_view salt, absl::string_view info,
-                     absl::Span<uint8_t> out_key) {
-  const uint8_t *ikm_ptr = reinterpret_cast<const uint8_t *>(ikm.data());
-  const uint8_t *salt_ptr = reinterpret_cast<const uint8_t *>(salt.data());
-  const uint8_t *info_ptr = reinterpret_cast<const uint8_t *>(info.data());
-#ifdef OPENSSL_IS_BORINGSSL
-  if (HKDF(out_key.data(), out_key.size(), evp_md, ikm_ptr, ikm.size(),
-           salt_ptr, salt.size(), info_ptr, info.size()) != 1) {
-    return util::Status(absl::StatusCode::kInternal, "HKDF failed");
+// Computes HKDF with hash function `hash`, the concatenation of `ikm_parts`
+// as input key material, salt `salt` and info `info`, and writes the result
+// to `out_key`.
+//
+// This runs both steps of HKDF directly on an HMAC context rather than
+// through the EVP_PKEY interface, which OpenSSL would need for HKDF and which
+// is several times slower for short outputs. It also lets the input key
+// material be given in parts.
+util::Status HmacHkdf(HashType hash,
+                      absl::Span<const absl::string_view> ikm_parts,
+                      absl::string_view salt, absl::string_view info,
+                      absl::Span<uint8_t> out_key) {
+  util::StatusOr<const EVP_MD *> evp_md = internal::EvpHashFromHashType(hash);
+  if (!evp_md.ok()) {
+    return evp_md.status();
   }
-  return util::OkStatus();
-#else
-  internal::SslUniquePtr<EVP_PKEY_CTX> pctx(
-      EVP_PKEY_CTX_new_id(EVP_PKEY_HKDF, /*e=*/nullptr));
-  if (pctx == nullptr || EVP_PKEY_derive_init(pctx.get()) <= 0 ||
-      EVP_PKEY_CTX_set_hkdf_md(pctx.get(), evp_md) <= 0 ||
-      EVP_PKEY_CTX_set1_hkdf_salt(pctx.get(), salt_ptr, salt.size()) <= 0 ||
-      EVP_PKEY_CTX_set1_hkdf_key(pctx.get(), ikm_ptr, ikm.size()) <= 0 ||
-      EVP_PKEY_CTX_add1_hkdf_info(pctx.get(), info_ptr, info.size()) <= 0) {
-    return util::Status(absl::StatusCode::kInternal,
-                        "EVP_PKEY_CTX setup failed");
+  internal::SslUniquePtr<HMAC_CTX> context(HMAC_CTX_new());
+  if (context == nullptr) {
+    return util::Status(absl::StatusCode::kInternal, "HMAC_CTX_new failed");
   }
-  size_t output_length = out_key.size();
-  if (EVP_PKEY_derive(pctx.get(), out_key.data(), &output_length) <= 0) {
+  if (!internal::HkdfExtract(*evp_md, ikm_parts, salt, context.get()).ok() ||
+      !internal::HkdfExpand(context.get(), info, out_key).ok()) {
     return util::Status(absl::StatusCode::kInternal, "HKDF failed");
   }
   return util::OkStatus();
-#endif
 }
 
 }  // namespace
@@ -88,15 +72,10 @@ util::StatusOr<util::SecretData> Hkdf::ComputeHkdf(HashType hash,
                                                    absl::string_view salt,
                                                    absl::string_view info,
                                                    size_t out_len) {
-  util::StatusOr<const EVP_MD *> evp_md = internal::EvpHashFromHashType(hash);
-  if (!evp_md.ok()) {
-    return evp_md.status();
-  }
-
   util::SecretData out_key(out_len);
   util::Status result =
-      SslHkdf(*evp_md, util::SecretDataAsStringView(ikm), salt, info,
-              absl::MakeSpan(out_key.data(), out_key.size()));
+      HmacHkdf(hash, {util::SecretDataAsStringView(ikm)}, salt, info,
+               absl::MakeSpan(out_key.data(), out_key.size()));
   if (!result.ok()) {
     return result;
   }
@@ -108,14 +87,10 @@ util::StatusOr<std::string> Hkdf::ComputeHkdf(HashType hash,
                                               absl::string_view salt,
                                               absl::string_view info,
                                               size_t out_len) {
-  util::StatusOr<const EVP_MD *> evp_md = internal::EvpHashFromHashType(hash);
-  if (!evp_md.ok()) {
-    return evp_md.status();
-  }
   std::string out_key;
   ResizeStringUninitialized(&out_key, out_len);
-  util::Status result = SslHkdf(
-      *evp_md, ikm, salt, info,
+  util::Status result = HmacHkdf(
+      hash, {ikm}, salt, info,
       absl::MakeSpan(reinterpret_cast<uint8_t *>(&out_key[0]), out_key.size()));
   if (!result.ok()) {
     return result;
@@ -127,10 +102,16 @@ util::StatusOr<util::SecretData> Hkdf::ComputeEciesHkdfSymmetricKey(
     HashType hash, absl::string_view kem_bytes,
     const util::SecretData &shared_secret, absl::string_view salt,
     absl::string_view info, size_t out_len) {
-  util::SecretData ikm(kem_bytes.size() + shared_secret.size());
-  absl::c_copy(kem_bytes, ikm.begin());
-  absl::c_copy(shared_secret, ikm.begin() + kem_bytes.size());
-  return Hkdf::ComputeHkdf(hash, ikm, salt, info, out_len);
+  // The input key material is kem_bytes || shared_secret, which HKDF-Extract
+  // consumes in parts, without copying the shared secret.
+  util::SecretData out_key(out_len);
+  util::Status result = HmacHkdf(
+      hash, {kem_bytes, util::SecretDataAsStringView(shared_secret)}, salt,
+      info, absl::MakeSpan(out_key.data(), out_key.size()));
+  if (!result.ok()) {
+    return result;
+  }
+  return out_key;
 }
 
 }  // namespace subtle
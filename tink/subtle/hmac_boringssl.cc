@@ -16,20 +16,26 @@
 
 #include "tink/subtle/hmac_boringssl.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/crypto.h"
 #include "openssl/evp.h"
 #include "openssl/hmac.h"
 #include "tink/internal/md_util.h"
+#include "tink/internal/ssl_unique_ptr.h"
 #include "tink/internal/util.h"
 #include "tink/mac.h"
 #include "tink/subtle/common_enums.h"
+#include "tink/subtle/subtle_util.h"
 #include "tink/util/errors.h"
 #include "tink/util/status.h"
 #include "tink/util/statusor.h"
@@ -57,56 +63,154 @@ util::StatusOr<std::unique_ptr<Mac>> HmacBoringSsl::New(HashType hash_type,
   if (key.size() < kMinKeySize) {
     return util::Status(absl::StatusCode::kInvalidArgument, "invalid key size");
   }
-  return {absl::WrapUnique(new HmacBoringSsl(*md, tag_size, std::move(key)))};
+  internal::SslUniquePtr<HMAC_CTX> keyed_context(HMAC_CTX_new());
+  if (keyed_context == nullptr ||
+      !HMAC_Init_ex(keyed_context.get(), key.data(), key.size(), *md,
+                    /*impl=*/nullptr)) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "BoringSSL failed to initialize HMAC");
+  }
+  return {absl::WrapUnique(
+      new HmacBoringSsl(std::move(keyed_context), tag_size))};
 }
 
-util::StatusOr<std::string> HmacBoringSsl::ComputeMac(
-    absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = internal::EnsureStringNonNull(data);
+util::StatusOr<internal::SslUniquePtr<HMAC_CTX>> HmacBoringSsl::NewContext()
+    const {
+  internal::SslUniquePtr<HMAC_CTX> context(HMAC_CTX_new());
+  if (context == nullptr ||
+      !HMAC_CTX_copy(context.get(), keyed_context_.get())) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "BoringSSL failed to copy the HMAC context");
+  }
+  return std::move(context);
+}
 
-  uint8_t buf[EVP_MAX_MD_SIZE];
+// static
+util::Status HmacBoringSsl::ComputeFullMac(
+    HMAC_CTX* context, absl::Span<const absl::string_view> data_parts,
+    uint8_t* mac) {
+  // Without a key and hash function, HMAC_Init_ex restores the hash states
+  // after the key pads, which is much cheaper than keying from scratch.
+  bool ok = HMAC_Init_ex(context, /*key=*/nullptr, /*key_len=*/0,
+                         /*md=*/nullptr, /*impl=*/nullptr);
+  for (int i = 0; ok && i < data_parts.size(); ++i) {
+    // BoringSSL expects a non-null pointer for data,
+    // regardless of whether the size is 0.
+    absl::string_view data = internal::EnsureStringNonNull(data_parts[i]);
+    ok = HMAC_Update(context, reinterpret_cast<const uint8_t*>(data.data()),
+                     data.size());
+  }
   unsigned int out_len;
-  const uint8_t* res = HMAC(md_, key_.data(), key_.size(),
-                            reinterpret_cast<const uint8_t*>(data.data()),
-                            data.size(), buf, &out_len);
-  if (res == nullptr) {
+  if (!ok || !HMAC_Final(context, mac, &out_len)) {
     // TODO(bleichen): We expect that BoringSSL supports the
     //   hashes that we use. Maybe we should have a status that indicates
     //   such mismatches between expected and actual behaviour.
     return util::Status(absl::StatusCode::kInternal,
                         "BoringSSL failed to compute HMAC");
   }
-  return std::string(reinterpret_cast<char*>(buf), tag_size_);
+  return util::OkStatus();
+}
+
+util::StatusOr<std::string> HmacBoringSsl::ComputeMac(
+    absl::string_view data) const {
+  return ComputeMacFromParts({data});
 }
 
 util::Status HmacBoringSsl::VerifyMac(absl::string_view mac,
                                       absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = internal::EnsureStringNonNull(data);
+  return VerifyMacFromParts(mac, {data});
+}
+
+util::StatusOr<std::string> HmacBoringSsl::ComputeMacFromParts(
+    absl::Span<const absl::string_view> data_parts) const {
+  util::StatusOr<internal::SslUniquePtr<HMAC_CTX>> context = NewContext();
+  if (!context.ok()) {
+    return context.status();
+  }
+  uint8_t buf[EVP_MAX_MD_SIZE];
+  util::Status status = ComputeFullMac(context->get(), data_parts, buf);
+  if (!status.ok()) {
+    return status;
+  }
+  return std::string(reinterpret_cast<char*>(buf), tag_size_);
+}
 
-  if (mac.size() != tag_size_) {
+util::Status HmacBoringSsl::VerifyMacFromParts(
+    absl::string_view mac_value,
+    absl::Span<const absl::string_view> data_parts) const {
+  if (mac_value.size() != tag_size_) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "incorrect tag size");
   }
+  util::StatusOr<internal::SslUniquePtr<HMAC_CTX>> context = NewContext();
+  if (!context.ok()) {
+    return context.status();
+  }
   uint8_t buf[EVP_MAX_MD_SIZE];
-  unsigned int out_len;
-  const uint8_t* res = HMAC(md_, key_.data(), key_.size(),
-                            reinterpret_cast<const uint8_t*>(data.data()),
-                            data.size(), buf, &out_len);
-  if (res == nullptr) {
-    return util::Status(absl::StatusCode::kInternal,
-                        "BoringSSL failed to compute HMAC");
+  util::Status status = ComputeFullMac(context->get(), data_parts, buf);
+  if (!status.ok()) {
+    return status;
   }
-  if (CRYPTO_memcmp(buf, mac.data(), tag_size_) != 0) {
+  if (CRYPTO_memcmp(buf, mac_value.data(), tag_size_) != 0) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         "verification failed");
   }
   return util::OkStatus();
 }
 
+util::Status HmacBoringSsl::ComputeMacBatchWithPrefix(
+    absl::string_view output_prefix, absl::Span<const absl::string_view> data,
+    std::string* mac_values, std::vector<int64_t>* offsets) const {
+  util::StatusOr<internal::SslUniquePtr<HMAC_CTX>> context = NewContext();
+  if (!context.ok()) {
+    return context.status();
+  }
+  const int64_t output_size = output_prefix.size() + tag_size_;
+  mac_values->clear();
+  ResizeStringUninitialized(mac_values, data.size() * output_size);
+  offsets->resize(data.size() + 1);
+  (*offsets)[0] = 0;
+  uint8_t buf[EVP_MAX_MD_SIZE];
+  for (int64_t i = 0; i < data.size(); ++i) {
+    util::Status status = ComputeFullMac(context->get(), {data[i]}, buf);
+    if (!status.ok()) {
+      return status;
+    }
+    char* out = &(*mac_values)[i * output_size];
+    std::copy(output_prefix.begin(), output_prefix.end(), out);
+    std::copy_n(buf, tag_size_, out + output_prefix.size());
+    (*offsets)[i + 1] = (i + 1) * output_size;
+  }
+  return util::OkStatus();
+}
+
+util::Status HmacBoringSsl::VerifyMacBatch(
+    absl::Span<const absl::string_view> mac_values,
+    absl::Span<const absl::string_view> data,
+    std::vector<bool>* verified) const {
+  if (mac_values.size() != data.size()) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "mac_values and data must have the same size");
+  }
+  util::StatusOr<internal::SslUniquePtr<HMAC_CTX>> context = NewContext();
+  if (!context.ok()) {
+    return context.status();
+  }
+  verified->assign(data.size(), false);
+  uint8_t buf[EVP_MAX_MD_SIZE];
+  for (int64_t i = 0; i < data.size(); ++i) {
+    if (mac_values[i].size() != tag_size_) {
+      continue;
+    }
+    util::Status status = ComputeFullMac(context->get(), {data[i]}, buf);
+    if (!status.ok()) {
+      return status;
+    }
+    (*verified)[i] = CRYPTO_memcmp(buf, mac_values[i].data(), tag_size_) == 0;
+  }
+  return util::OkStatus();
+}
+
 }  // namespace subtle
 }  // namespace tink
 }  // namespace crypto
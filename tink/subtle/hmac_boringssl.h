@@ -17,13 +17,18 @@
 #ifndef TINK_SUBTLE_HMAC_BORINGSSL_H_
 #define TINK_SUBTLE_HMAC_BORINGSSL_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
+#include "openssl/hmac.h"
 #include "tink/internal/fips_utils.h"
+#include "tink/internal/ssl_unique_ptr.h"
 #include "tink/mac.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/util/secret_data.h"
@@ -49,6 +54,27 @@ class HmacBoringSsl : public Mac {
       absl::string_view mac,
       absl::string_view data) const override;
 
+  // Feeds the parts to the HMAC one after the other, without concatenating
+  // them; see Mac::ComputeMacFromParts.
+  crypto::tink::util::StatusOr<std::string> ComputeMacFromParts(
+      absl::Span<const absl::string_view> data_parts) const override;
+
+  crypto::tink::util::Status VerifyMacFromParts(
+      absl::string_view mac_value,
+      absl::Span<const absl::string_view> data_parts) const override;
+
+  // Processes the whole batch with a single copy of the keyed context, which
+  // is reset to the keyed state for every element; see
+  // Mac::ComputeMacBatchWithPrefix.
+  crypto::tink::util::Status ComputeMacBatchWithPrefix(
+      absl::string_view output_prefix, absl::Span<const absl::string_view> data,
+      std::string* mac_values, std::vector<int64_t>* offsets) const override;
+
+  crypto::tink::util::Status VerifyMacBatch(
+      absl::Span<const absl::string_view> mac_values,
+      absl::Span<const absl::string_view> data,
+      std::vector<bool>* verified) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kRequiresBoringCrypto;
 
@@ -56,13 +82,27 @@ class HmacBoringSsl : public Mac {
   // Minimum HMAC key size in bytes.
   static constexpr size_t kMinKeySize = 16;
 
-  HmacBoringSsl(const EVP_MD* md, uint32_t tag_size, util::SecretData key)
-      : md_(md), tag_size_(tag_size), key_(std::move(key)) {}
+  HmacBoringSsl(internal::SslUniquePtr<HMAC_CTX> keyed_context,
+                uint32_t tag_size)
+      : keyed_context_(std::move(keyed_context)), tag_size_(tag_size) {}
+
+  // Returns a copy of keyed_context_ owned by the caller.
+  crypto::tink::util::StatusOr<internal::SslUniquePtr<HMAC_CTX>> NewContext()
+      const;
+
+  // Resets 'context', a copy of keyed_context_, to the keyed state, computes
+  // the untruncated HMAC of the concatenation of 'data_parts' and writes it to
+  // 'mac', which must hold at least EVP_MAX_MD_SIZE bytes.
+  static crypto::tink::util::Status ComputeFullMac(
+      HMAC_CTX* context, absl::Span<const absl::string_view> data_parts,
+      uint8_t* mac);
 
-  // HmacBoringSsl is not owner of md (it is owned by BoringSSL).
-  const EVP_MD* const md_;
+  // Context on which HMAC_Init_ex ran once with the key, i.e. which holds the
+  // hash states after the inner and outer key pads. It is copied for every
+  // message, so that the pads are not hashed again, and is never modified
+  // after construction.
+  const internal::SslUniquePtr<HMAC_CTX> keyed_context_;
   const uint32_t tag_size_;
-  const util::SecretData key_;
 };
 
 }  // namespace subtle
@@ -16,12 +16,18 @@
 
 #include "tink/subtle/hmac_boringssl.h"
 
+#include <cstdint>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
+#include <vector>
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/status/status.h"
 #include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/mac.h"
 #include "tink/subtle/common_enums.h"
@@ -35,6 +41,7 @@ namespace tink {
 namespace subtle {
 namespace {
 
+using ::crypto::tink::test::IsOk;
 using ::crypto::tink::test::StatusIs;
 
 class HmacBoringSslTest : public ::testing::Test {
@@ -140,6 +147,135 @@ TEST_F(HmacBoringSslTest, testTruncation) {
   }
 }
 
+// The keyed HMAC context is shared by all calls; check that concurrent calls
+// neither interfere with each other nor modify it.
+TEST_F(HmacBoringSslTest, ConcurrentComputeAndVerify) {
+  if (internal::IsFipsModeEnabled() && !internal::IsFipsEnabledInSsl()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      absl::HexStringToBytes("000102030405060708090a0b0c0d0e0f"));
+  auto hmac_result = HmacBoringSsl::New(HashType::SHA256, 32, key);
+  ASSERT_TRUE(hmac_result.ok()) << hmac_result.status();
+  auto hmac = std::move(hmac_result.value());
+  const std::string data = "Some data to test.";
+  util::StatusOr<std::string> expected_tag = hmac->ComputeMac(data);
+  ASSERT_TRUE(expected_tag.ok()) << expected_tag.status();
+
+  constexpr int kNumThreads = 8;
+  constexpr int kNumMessages = 50;
+  std::vector<int> failures(kNumThreads, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&, t] {
+      const std::string message = absl::StrCat(data, t);
+      for (int i = 0; i < kNumMessages; ++i) {
+        util::StatusOr<std::string> tag = hmac->ComputeMac(message);
+        if (!tag.ok() || !hmac->VerifyMac(*tag, message).ok() ||
+            hmac->VerifyMac(*tag, data).ok()) {
+          ++failures[t];
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_THAT(failures, testing::Each(0));
+  util::StatusOr<std::string> tag = hmac->ComputeMac(data);
+  ASSERT_TRUE(tag.ok()) << tag.status();
+  EXPECT_EQ(*tag, *expected_tag);
+}
+
+TEST_F(HmacBoringSslTest, ComputeAndVerifyFromParts) {
+  if (internal::IsFipsModeEnabled() && !internal::IsFipsEnabledInSsl()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      absl::HexStringToBytes("000102030405060708090a0b0c0d0e0f"));
+  auto hmac_result = HmacBoringSsl::New(HashType::SHA256, 16, key);
+  ASSERT_TRUE(hmac_result.ok()) << hmac_result.status();
+  auto hmac = std::move(hmac_result.value());
+  const absl::string_view data = "Some data to test.";
+  util::StatusOr<std::string> expected_tag = hmac->ComputeMac(data);
+  ASSERT_TRUE(expected_tag.ok()) << expected_tag.status();
+
+  for (int i = 0; i <= data.size(); ++i) {
+    std::vector<absl::string_view> parts = {data.substr(0, i),
+                                            absl::string_view(),
+                                            data.substr(i)};
+    util::StatusOr<std::string> tag = hmac->ComputeMacFromParts(parts);
+    ASSERT_TRUE(tag.ok()) << tag.status();
+    EXPECT_EQ(*tag, *expected_tag);
+    EXPECT_THAT(hmac->VerifyMacFromParts(*expected_tag, parts), IsOk());
+  }
+  std::vector<absl::string_view> other_parts = {data, "!"};
+  EXPECT_THAT(hmac->VerifyMacFromParts(*expected_tag, other_parts),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST_F(HmacBoringSslTest, ComputeAndVerifyBatch) {
+  if (internal::IsFipsModeEnabled() && !internal::IsFipsEnabledInSsl()) {
+    GTEST_SKIP()
+        << "Test should not run in FIPS mode when BoringCrypto is unavailable.";
+  }
+
+  util::SecretData key = util::SecretDataFromStringView(
+      absl::HexStringToBytes("000102030405060708090a0b0c0d0e0f"));
+  uint32_t tag_size = 16;
+  auto hmac_result = HmacBoringSsl::New(HashType::SHA256, tag_size, key);
+  ASSERT_TRUE(hmac_result.ok()) << hmac_result.status();
+  auto hmac = std::move(hmac_result.value());
+
+  const std::string long_data(1000, 'a');
+  std::vector<absl::string_view> data = {"Some data to test.", "", long_data};
+  std::string tags;
+  std::vector<int64_t> offsets;
+  ASSERT_THAT(hmac->ComputeMacBatch(data, &tags, &offsets), IsOk());
+  EXPECT_THAT(offsets, testing::ElementsAre(0, 16, 32, 48));
+
+  // The batch computes the same tags as ComputeMac().
+  std::vector<absl::string_view> tag_views;
+  for (int i = 0; i < data.size(); ++i) {
+    absl::string_view tag =
+        absl::string_view(tags).substr(offsets[i], tag_size);
+    util::StatusOr<std::string> expected_tag = hmac->ComputeMac(data[i]);
+    ASSERT_TRUE(expected_tag.ok()) << expected_tag.status();
+    EXPECT_EQ(tag, *expected_tag);
+    tag_views.push_back(tag);
+  }
+
+  std::vector<bool> verified;
+  ASSERT_THAT(hmac->VerifyMacBatch(tag_views, data, &verified), IsOk());
+  EXPECT_THAT(verified, testing::ElementsAre(true, true, true));
+
+  // Modified and truncated tags are reported as not verified.
+  std::string modified_tag(tag_views[0]);
+  modified_tag[0] ^= 1;
+  tag_views[0] = modified_tag;
+  tag_views[2] = tag_views[2].substr(0, tag_size - 1);
+  ASSERT_THAT(hmac->VerifyMacBatch(tag_views, data, &verified), IsOk());
+  EXPECT_THAT(verified, testing::ElementsAre(false, true, false));
+
+  EXPECT_THAT(hmac->VerifyMacBatch(tag_views, {}, &verified),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+
+  // The tags of a prefixed batch follow the prefix.
+  ASSERT_THAT(hmac->ComputeMacBatchWithPrefix("pre", data, &tags, &offsets),
+              IsOk());
+  EXPECT_THAT(offsets, testing::ElementsAre(0, 19, 38, 57));
+  for (int i = 0; i < data.size(); ++i) {
+    absl::string_view tag =
+        absl::string_view(tags).substr(offsets[i], offsets[i + 1] - offsets[i]);
+    EXPECT_EQ(tag.substr(0, 3), "pre");
+    EXPECT_THAT(hmac->VerifyMac(tag.substr(3), data[i]), IsOk());
+  }
+}
+
 TEST_F(HmacBoringSslTest, testInvalidKeySizes) {
   if (internal::IsFipsModeEnabled() && !internal::IsFipsEnabledInSsl()) {
     GTEST_SKIP()
@@ -17,9 +17,14 @@
 #ifndef TINK_SUBTLE_IND_CPA_CIPHER_H_
 #define TINK_SUBTLE_IND_CPA_CIPHER_H_
 
+#include <cstdint>
 #include <string>
 
+#include "absl/functional/function_ref.h"
+#include "absl/status/status.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/util/status.h"
 #include "tink/util/statusor.h"
 
 namespace crypto {
@@ -42,6 +47,55 @@ class IndCpaCipher {
   virtual crypto::tink::util::StatusOr<std::string> Decrypt(
       absl::string_view ciphertext) const = 0;
 
+  // Returns the size of the ciphertext of a `plaintext_size` bytes plaintext,
+  // or -1 if the cipher does not support EncryptToBuffer().
+  virtual int64_t CiphertextSize(int64_t plaintext_size) const { return -1; }
+
+  // Encrypts 'plaintext' into 'ciphertext_buffer', which must be exactly
+  // CiphertextSize(plaintext.size()) bytes long and must not overlap with
+  // 'plaintext'. This saves the allocation of Encrypt() for callers which
+  // append to the ciphertext.
+  virtual crypto::tink::util::Status EncryptToBuffer(
+      absl::string_view plaintext, absl::Span<char> ciphertext_buffer) const {
+    return crypto::tink::util::Status(absl::StatusCode::kUnimplemented,
+                                      "EncryptToBuffer is not supported");
+  }
+
+  // Returns the size of the plaintext of a `ciphertext_size` bytes ciphertext,
+  // or -1 if the cipher does not support DecryptToBuffer(). For supported
+  // ciphers, the result is >= 0 even if `ciphertext_size` is too small.
+  virtual int64_t PlaintextSize(int64_t ciphertext_size) const { return -1; }
+
+  // Decrypts 'ciphertext' into 'plaintext_buffer', which must be exactly
+  // PlaintextSize(ciphertext.size()) bytes long and must not overlap with
+  // 'ciphertext'.
+  virtual crypto::tink::util::Status DecryptToBuffer(
+      absl::string_view ciphertext, absl::Span<char> plaintext_buffer) const {
+    return crypto::tink::util::Status(absl::StatusCode::kUnimplemented,
+                                      "DecryptToBuffer is not supported");
+  }
+
+  // Receives consecutive pieces of a ciphertext.
+  using CiphertextVisitor =
+      absl::FunctionRef<crypto::tink::util::Status(absl::string_view)>;
+
+  // Like EncryptToBuffer(), but also passes the ciphertext to
+  // 'visit_ciphertext', piece by piece as it is produced, so that callers can
+  // authenticate it in the same pass over the data. Stops at the first error
+  // returned by 'visit_ciphertext'. The default implementation visits the
+  // whole ciphertext after encrypting.
+  virtual crypto::tink::util::Status EncryptToBufferAndVisit(
+      absl::string_view plaintext, absl::Span<char> ciphertext_buffer,
+      CiphertextVisitor visit_ciphertext) const {
+    crypto::tink::util::Status status =
+        EncryptToBuffer(plaintext, ciphertext_buffer);
+    if (!status.ok()) {
+      return status;
+    }
+    return visit_ciphertext(
+        absl::string_view(ciphertext_buffer.data(), ciphertext_buffer.size()));
+  }
+
   virtual ~IndCpaCipher() = default;
 };
 
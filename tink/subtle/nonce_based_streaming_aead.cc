@@ -25,6 +25,8 @@
 #include "tink/random_access_stream.h"
 #include "tink/streaming_aead.h"
 #include "tink/subtle/decrypting_random_access_stream.h"
+#include "tink/subtle/parallel_streaming_aead_decrypting_stream.h"
+#include "tink/subtle/parallel_streaming_aead_encrypting_stream.h"
 #include "tink/subtle/stream_segment_decrypter.h"
 #include "tink/subtle/stream_segment_encrypter.h"
 #include "tink/subtle/streaming_aead_decrypting_stream.h"
@@ -46,6 +48,18 @@ crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::OutputStream>>
       std::move(ciphertext_destination));
 }
 
+crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::OutputStream>>
+    NonceBasedStreamingAead::NewParallelEncryptingStream(
+        std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination,
+        absl::string_view associated_data,
+        const ParallelStreamingAeadEncryptingStream::Options& options) const {
+  auto segment_encrypter_result = NewSegmentEncrypter(associated_data);
+  if (!segment_encrypter_result.ok()) return segment_encrypter_result.status();
+  return ParallelStreamingAeadEncryptingStream::New(
+      std::move(segment_encrypter_result.value()),
+      std::move(ciphertext_destination), options);
+}
+
 crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::InputStream>>
     NonceBasedStreamingAead::NewDecryptingStream(
         std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
@@ -57,6 +71,18 @@ crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::InputStream>>
       std::move(ciphertext_source));
 }
 
+crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::InputStream>>
+    NonceBasedStreamingAead::NewParallelDecryptingStream(
+        std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
+        absl::string_view associated_data,
+        const ParallelStreamingAeadDecryptingStream::Options& options) const {
+  auto segment_decrypter_result = NewSegmentDecrypter(associated_data);
+  if (!segment_decrypter_result.ok()) return segment_decrypter_result.status();
+  return ParallelStreamingAeadDecryptingStream::New(
+      std::move(segment_decrypter_result.value()),
+      std::move(ciphertext_source), options);
+}
+
 crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::RandomAccessStream>>
     NonceBasedStreamingAead::NewDecryptingRandomAccessStream(
         std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source,
@@ -68,6 +94,18 @@ crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::RandomAccessStream>>
       std::move(ciphertext_source));
 }
 
+crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::RandomAccessStream>>
+    NonceBasedStreamingAead::NewParallelDecryptingRandomAccessStream(
+        std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source,
+        absl::string_view associated_data,
+        const DecryptingRandomAccessStream::Options& options) const {
+  auto segment_decrypter_result = NewSegmentDecrypter(associated_data);
+  if (!segment_decrypter_result.ok()) return segment_decrypter_result.status();
+  return DecryptingRandomAccessStream::New(
+      std::move(segment_decrypter_result.value()),
+      std::move(ciphertext_source), options);
+}
+
 }  // namespace subtle
 }  // namespace tink
 }  // namespace crypto
@@ -24,6 +24,9 @@
 #include "tink/output_stream.h"
 #include "tink/random_access_stream.h"
 #include "tink/streaming_aead.h"
+#include "tink/subtle/decrypting_random_access_stream.h"
+#include "tink/subtle/parallel_streaming_aead_decrypting_stream.h"
+#include "tink/subtle/parallel_streaming_aead_encrypting_stream.h"
 #include "tink/subtle/stream_segment_decrypter.h"
 #include "tink/subtle/stream_segment_encrypter.h"
 #include "tink/util/statusor.h"
@@ -55,6 +58,33 @@ class NonceBasedStreamingAead : public StreamingAead {
       std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source,
       absl::string_view associated_data) const override;
 
+  // Like NewEncryptingStream(), but encrypts segments concurrently on
+  // `options.num_threads` threads. The ciphertext format is the same, so
+  // the ciphertext can be decrypted with any of the decrypting streams.
+  crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::OutputStream>>
+  NewParallelEncryptingStream(
+      std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination,
+      absl::string_view associated_data,
+      const ParallelStreamingAeadEncryptingStream::Options& options) const;
+
+  // Like NewDecryptingStream(), but reads and decrypts segments ahead of the
+  // caller on `options.num_threads` threads.
+  crypto::tink::util::StatusOr<std::unique_ptr<crypto::tink::InputStream>>
+  NewParallelDecryptingStream(
+      std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
+      absl::string_view associated_data,
+      const ParallelStreamingAeadDecryptingStream::Options& options) const;
+
+  // Like NewDecryptingRandomAccessStream(), but caches decrypted segments and
+  // decrypts the segments of a PRead() in parallel, as configured by
+  // `options`.
+  crypto::tink::util::StatusOr<
+      std::unique_ptr<crypto::tink::RandomAccessStream>>
+  NewParallelDecryptingRandomAccessStream(
+      std::unique_ptr<crypto::tink::RandomAccessStream> ciphertext_source,
+      absl::string_view associated_data,
+      const DecryptingRandomAccessStream::Options& options) const;
+
  protected:
   // Methods to be implemented by a subclass of this class.
 
@@ -0,0 +1,324 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/parallel_streaming_aead_decrypting_stream.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "tink/input_stream.h"
+#include "tink/subtle/stream_segment_decrypter.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+namespace {
+
+// Reads at most 'count' bytes from the specified 'input_stream',
+// and puts them into 'output', where both 'input_stream' and 'output'
+// must be non-null.
+// Will try to read exactly 'count' bytes, unless the end of stream
+// is reached (then returns status OUT_OF_RANGE) or an error occurs
+// (an other non-OK status).
+// Before returning, resizes 'output' accordingly, to reflect
+// the actual number of bytes read.
+util::Status ReadFromStream(InputStream* input_stream, int count,
+                            std::vector<uint8_t>* output) {
+  if (count <= 0 || input_stream == nullptr || output == nullptr) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "Illegal read from a stream");
+  }
+  const void* buffer;
+  int bytes_to_be_read = count;
+  int read_bytes;    // bytes read in one Next()-call
+  int needed_bytes;  // bytes actually needed
+  output->resize(count);
+  while (bytes_to_be_read > 0) {
+    util::StatusOr<int> next_result = input_stream->Next(&buffer);
+    if (next_result.status().code() == absl::StatusCode::kOutOfRange) {
+      // End of stream.
+      output->resize(count - bytes_to_be_read);
+      return next_result.status();
+    }
+    if (!next_result.ok()) return next_result.status();
+    read_bytes = *next_result;
+    needed_bytes = std::min(read_bytes, bytes_to_be_read);
+    memcpy(output->data() + (count - bytes_to_be_read), buffer, needed_bytes);
+    bytes_to_be_read -= needed_bytes;
+  }
+  if (read_bytes > needed_bytes) {
+    input_stream->BackUp(read_bytes - needed_bytes);
+  }
+  return util::OkStatus();
+}
+
+int FirstSegmentSize(const StreamSegmentDecrypter& segment_decrypter) {
+  return segment_decrypter.get_ciphertext_segment_size() -
+         segment_decrypter.get_ciphertext_offset() -
+         segment_decrypter.get_header_size();
+}
+
+}  // namespace
+
+// static
+util::StatusOr<std::unique_ptr<InputStream>>
+ParallelStreamingAeadDecryptingStream::New(
+    std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
+    std::unique_ptr<InputStream> ciphertext_source, const Options& options) {
+  if (segment_decrypter == nullptr) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "segment_decrypter must be non-null");
+  }
+  if (ciphertext_source == nullptr) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "cipertext_source must be non-null");
+  }
+  if ((options.thread_pool == nullptr && options.num_threads < 1) ||
+      options.max_segments_in_flight < 1) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        "num_threads and max_segments_in_flight must be positive");
+  }
+  if (FirstSegmentSize(*segment_decrypter) <= 0) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "Size of the first segment must be greater than 0.");
+  }
+  return {absl::WrapUnique(new ParallelStreamingAeadDecryptingStream(
+      std::move(segment_decrypter), std::move(ciphertext_source), options))};
+}
+
+ParallelStreamingAeadDecryptingStream::ParallelStreamingAeadDecryptingStream(
+    std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
+    std::unique_ptr<InputStream> ciphertext_source, const Options& options)
+    : segment_decrypter_(std::move(segment_decrypter)),
+      ct_source_(std::move(ciphertext_source)),
+      max_segments_in_flight_(options.max_segments_in_flight),
+      thread_pool_(options.thread_pool != nullptr
+                       ? options.thread_pool
+                       : std::make_shared<internal::ThreadPool>(
+                             options.num_threads)) {}
+
+ParallelStreamingAeadDecryptingStream::
+    ~ParallelStreamingAeadDecryptingStream() {
+  // Stops the reader. Segments already read are still decrypted, and a shared
+  // pool outlives the stream, so wait for them.
+  absl::MutexLock lock(&mutex_);
+  cancelled_ = true;
+  mutex_.Await(absl::Condition(
+      this, &ParallelStreamingAeadDecryptingStream::AllTasksDone));
+}
+
+void ParallelStreamingAeadDecryptingStream::DecryptSegment(
+    Segment* segment) const {
+  const int segment_overhead =
+      segment_decrypter_->get_ciphertext_segment_size() -
+      segment_decrypter_->get_plaintext_segment_size();
+  // A segment shorter than the overhead is rejected by the decrypter.
+  segment->plaintext.resize(std::max<int>(
+      static_cast<int>(segment->ciphertext.size()) - segment_overhead, 0));
+  segment->status = segment_decrypter_->DecryptSegmentInto(
+      segment->ciphertext, segment->segment_number, segment->is_last_segment,
+      absl::MakeSpan(segment->plaintext));
+  if (!segment->status.ok() && !segment->is_last_segment) {
+    // Try decrypting as the last segment, if haven't tried yet.
+    segment->is_last_segment = true;
+    segment->status = segment_decrypter_->DecryptSegmentInto(
+        segment->ciphertext, segment->segment_number,
+        /*is_last_segment=*/true, absl::MakeSpan(segment->plaintext));
+  }
+}
+
+util::Status ParallelStreamingAeadDecryptingStream::ReadFirstSegment() {
+  std::vector<uint8_t> header;
+  util::Status status = ReadFromStream(
+      ct_source_.get(), segment_decrypter_->get_header_size(), &header);
+  if (status.code() == absl::StatusCode::kOutOfRange) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "Could not read stream header.");
+  }
+  if (!status.ok()) return status;
+  status = segment_decrypter_->Init(header);
+  if (!status.ok()) return status;
+
+  Segment segment;
+  status = ReadFromStream(ct_source_.get(),
+                          FirstSegmentSize(*segment_decrypter_),
+                          &segment.ciphertext);
+  if (!status.ok() && status.code() != absl::StatusCode::kOutOfRange) {
+    return status;
+  }
+  segment.is_last_segment = (status.code() == absl::StatusCode::kOutOfRange);
+  DecryptSegment(&segment);
+  if (!segment.status.ok()) return segment.status;
+  pt_buffer_.swap(segment.plaintext);
+  read_last_segment_ = segment.is_last_segment;
+  return util::OkStatus();
+}
+
+void ParallelStreamingAeadDecryptingStream::MaybeStartReader() {
+  if (reader_running_ || cancelled_ || source_exhausted_ ||
+      static_cast<int>(in_flight_.size()) >= max_segments_in_flight_) {
+    return;
+  }
+  reader_running_ = true;
+  thread_pool_->Schedule([this] { ReadSegments(); });
+}
+
+void ParallelStreamingAeadDecryptingStream::ReadSegments() {
+  const int ct_segment_size = segment_decrypter_->get_ciphertext_segment_size();
+  while (true) {
+    std::shared_ptr<Segment> segment;
+    {
+      absl::MutexLock lock(&mutex_);
+      if (cancelled_ || source_exhausted_ ||
+          static_cast<int>(in_flight_.size()) >= max_segments_in_flight_) {
+        reader_running_ = false;
+        return;
+      }
+      if (free_segments_.empty()) {
+        segment = std::make_shared<Segment>();
+      } else {
+        segment = std::move(free_segments_.back());
+        free_segments_.pop_back();
+      }
+      segment->segment_number = next_segment_number_++;
+    }
+    // Only this task accesses ct_source_ once read-ahead has started.
+    util::Status status =
+        ReadFromStream(ct_source_.get(), ct_segment_size, &segment->ciphertext);
+    const bool is_last_segment =
+        (status.code() == absl::StatusCode::kOutOfRange);
+
+    absl::MutexLock lock(&mutex_);
+    segment->is_last_segment = is_last_segment;
+    segment->done = false;
+    in_flight_.push_back(segment);
+    if (!status.ok() && !is_last_segment) {
+      // Reported when the caller reaches this segment.
+      segment->status = std::move(status);
+      segment->done = true;
+      source_exhausted_ = true;
+      continue;
+    }
+    source_exhausted_ = is_last_segment;
+    thread_pool_->Schedule([this, segment] {
+      DecryptSegment(segment.get());
+      absl::MutexLock lock(&mutex_);
+      segment->done = true;
+    });
+  }
+}
+
+bool ParallelStreamingAeadDecryptingStream::OldestSegmentDone() const {
+  return !in_flight_.empty() && in_flight_.front()->done;
+}
+
+bool ParallelStreamingAeadDecryptingStream::AllTasksDone() const {
+  return !reader_running_ &&
+         std::all_of(in_flight_.begin(), in_flight_.end(),
+                     [](const std::shared_ptr<Segment>& segment) {
+                       return segment->done;
+                     });
+}
+
+util::StatusOr<int> ParallelStreamingAeadDecryptingStream::Next(
+    const void** data) {
+  if (!status_.ok()) return status_;
+
+  // The first call to Next().
+  if (!is_initialized_) {
+    is_initialized_ = true;
+    status_ = ReadFirstSegment();
+    if (!status_.ok()) return status_;
+    *data = pt_buffer_.data();
+    position_ = pt_buffer_.size();
+    return pt_buffer_.size();
+  }
+
+  // If some bytes were backed up, return them first.
+  if (count_backedup_ > 0) {
+    position_ += count_backedup_;
+    pt_buffer_offset_ = pt_buffer_.size() - count_backedup_;
+    int backedup = count_backedup_;
+    count_backedup_ = 0;
+    *data = pt_buffer_.data() + pt_buffer_offset_;
+    return backedup;
+  }
+
+  if (read_last_segment_) {
+    status_ = util::Status(absl::StatusCode::kOutOfRange,
+                           "Reached end of stream.");
+    return status_;
+  }
+
+  // Take the next segment read ahead, waiting for it as needed.
+  std::shared_ptr<Segment> segment;
+  {
+    absl::MutexLock lock(&mutex_);
+    MaybeStartReader();
+    mutex_.Await(absl::Condition(
+        this, &ParallelStreamingAeadDecryptingStream::OldestSegmentDone));
+    segment = std::move(in_flight_.front());
+    in_flight_.pop_front();
+  }
+  status_ = segment->status;
+  if (status_.ok()) {
+    pt_buffer_.swap(segment->plaintext);
+    read_last_segment_ = segment->is_last_segment;
+  }
+  {
+    absl::MutexLock lock(&mutex_);
+    free_segments_.push_back(std::move(segment));
+    if (!status_.ok() || read_last_segment_) {
+      // Any remaining ciphertext is not needed.
+      cancelled_ = true;
+    } else {
+      MaybeStartReader();
+    }
+  }
+  if (!status_.ok()) return status_;
+  *data = pt_buffer_.data();
+  pt_buffer_offset_ = 0;
+  position_ += pt_buffer_.size();
+  return pt_buffer_.size();
+}
+
+void ParallelStreamingAeadDecryptingStream::BackUp(int count) {
+  if (!is_initialized_ || !status_.ok() || count < 1) return;
+  int curr_buffer_size = pt_buffer_.size() - pt_buffer_offset_;
+  int actual_count = std::min(count, curr_buffer_size - count_backedup_);
+  count_backedup_ += actual_count;
+  position_ -= actual_count;
+}
+
+int64_t ParallelStreamingAeadDecryptingStream::Position() const {
+  return position_;
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
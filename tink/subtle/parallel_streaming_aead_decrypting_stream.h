@@ -0,0 +1,156 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_PARALLEL_STREAMING_AEAD_DECRYPTING_STREAM_H_
+#define TINK_SUBTLE_PARALLEL_STREAMING_AEAD_DECRYPTING_STREAM_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/input_stream.h"
+#include "tink/internal/thread_pool.h"
+#include "tink/subtle/stream_segment_decrypter.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// A decrypting stream like StreamingAeadDecryptingStream, which reads and
+// decrypts segments ahead of the caller on a pool of worker threads. Reading
+// the ciphertext, decrypting segments and consuming the plaintext overlap,
+// while the plaintext is returned in order through Next() and BackUp(). The
+// plaintext and the errors returned are the same as those of
+// StreamingAeadDecryptingStream.
+//
+// The header and the first segment are read and decrypted on the caller's
+// thread in the first call to Next(); read-ahead starts with the second call.
+// From then on, the ciphertext source is only accessed by the worker
+// threads, one call at a time.
+//
+// Segments are decrypted in parallel only if the segment decrypter overrides
+// DecryptSegmentInto().
+class ParallelStreamingAeadDecryptingStream : public InputStream {
+ public:
+  struct Options {
+    // Number of worker threads that read and decrypt segments. Ignored if
+    // `thread_pool` is set.
+    int num_threads = 4;
+    // Maximum number of segments read ahead and not yet returned by Next().
+    // Bounds the memory used to about
+    // 2 * max_segments_in_flight * ciphertext segment size. Must be at least
+    // 1.
+    int max_segments_in_flight = 16;
+    // If not null, segments are read and decrypted on this pool, which may be
+    // shared with other streams, instead of on a pool owned by the stream.
+    // The stream must not be used from the threads of the pool.
+    std::shared_ptr<internal::ThreadPool> thread_pool;
+  };
+
+  // Returns a stream that decrypts the ciphertext read from
+  // 'ciphertext_source' with 'segment_decrypter'.
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<crypto::tink::InputStream>>
+  New(std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
+      std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
+      const Options& options);
+
+  // Stops reading ahead, and waits for the tasks of the stream on the pool.
+  ~ParallelStreamingAeadDecryptingStream() override;
+
+  // -----------------------
+  // Methods of InputStream-interface implemented by this class.
+  crypto::tink::util::StatusOr<int> Next(const void** data) override;
+  void BackUp(int count) override;
+  int64_t Position() const override;
+
+ private:
+  // A segment read ahead of the caller.
+  struct Segment {
+    int64_t segment_number = 0;
+    std::vector<uint8_t> ciphertext;
+    std::vector<uint8_t> plaintext;
+    crypto::tink::util::Status status;
+    // Set when the ciphertext was read, and updated if the segment could only
+    // be decrypted as the last one.
+    bool is_last_segment = false;
+    bool done = false;
+  };
+
+  ParallelStreamingAeadDecryptingStream(
+      std::unique_ptr<StreamSegmentDecrypter> segment_decrypter,
+      std::unique_ptr<crypto::tink::InputStream> ciphertext_source,
+      const Options& options);
+
+  // Reads the header and decrypts the first segment on the caller's thread.
+  crypto::tink::util::Status ReadFirstSegment();
+
+  // Decrypts 'segment' like StreamingAeadDecryptingStream does: if a segment
+  // which is not known to be the last one does not decrypt, it is decrypted
+  // again as the last segment.
+  void DecryptSegment(Segment* segment) const;
+
+  // Schedules the reader task, unless it is running, the source is exhausted
+  // or max_segments_in_flight segments have been read ahead.
+  void MaybeStartReader() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Reads ciphertext segments and schedules their decryption, until
+  // max_segments_in_flight segments have been read ahead.
+  void ReadSegments();
+
+  bool OldestSegmentDone() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Whether no task of the stream is scheduled or running.
+  bool AllTasksDone() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  const std::unique_ptr<StreamSegmentDecrypter> segment_decrypter_;
+  const std::unique_ptr<crypto::tink::InputStream> ct_source_;
+  const int max_segments_in_flight_;
+
+  std::vector<uint8_t> pt_buffer_;  // plaintext buffer
+  int64_t position_ = 0;  // number of plaintext bytes read from this stream
+  crypto::tink::util::Status status_;  // status of the stream
+
+  // Counters that describe the state of the data in pt_buffer_, as in
+  // StreamingAeadDecryptingStream.
+  int count_backedup_ = 0;
+  int pt_buffer_offset_ = 0;
+  bool is_initialized_ = false;
+  bool read_last_segment_ = false;
+
+  absl::Mutex mutex_;
+  // Segments read ahead, oldest first, and segments kept for reuse of their
+  // buffers.
+  std::deque<std::shared_ptr<Segment>> in_flight_ ABSL_GUARDED_BY(mutex_);
+  std::vector<std::shared_ptr<Segment>> free_segments_ ABSL_GUARDED_BY(mutex_);
+  int64_t next_segment_number_ ABSL_GUARDED_BY(mutex_) = 1;
+  bool reader_running_ ABSL_GUARDED_BY(mutex_) = false;
+  bool source_exhausted_ ABSL_GUARDED_BY(mutex_) = false;
+  bool cancelled_ ABSL_GUARDED_BY(mutex_) = false;
+
+  const std::shared_ptr<internal::ThreadPool> thread_pool_;
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_PARALLEL_STREAMING_AEAD_DECRYPTING_STREAM_H_
@@ -0,0 +1,406 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/parallel_streaming_aead_decrypting_stream.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/config/tink_fips.h"
+#include "tink/input_stream.h"
+#include "tink/internal/thread_pool.h"
+#include "tink/output_stream.h"
+#include "tink/subtle/aes_ctr_hmac_streaming.h"
+#include "tink/subtle/aes_gcm_hkdf_streaming.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/nonce_based_streaming_aead.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/stream_segment_decrypter.h"
+#include "tink/subtle/streaming_aead_decrypting_stream.h"
+#include "tink/subtle/test_util.h"
+#include "tink/util/istream_input_stream.h"
+#include "tink/util/ostream_output_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+using ::crypto::tink::subtle::test::DummyStreamSegmentDecrypter;
+using ::crypto::tink::subtle::test::DummyStreamSegmentEncrypter;
+using ::crypto::tink::subtle::test::ReadFromStream;
+using ::crypto::tink::subtle::test::WriteToStream;
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::crypto::tink::util::IstreamInputStream;
+using ::crypto::tink::util::OstreamOutputStream;
+using ::crypto::tink::util::StatusOr;
+using ::testing::Not;
+
+using Options = ParallelStreamingAeadDecryptingStream::Options;
+
+// Returns an InputStream with 'contents', which returns at most
+// 'buffer_size' bytes per Next()-call.
+std::unique_ptr<InputStream> GetInputStream(absl::string_view contents,
+                                            int buffer_size = 64) {
+  return absl::make_unique<IstreamInputStream>(
+      absl::make_unique<std::stringstream>(std::string(contents)),
+      buffer_size);
+}
+
+std::unique_ptr<InputStream> GetDecryptingStream(
+    absl::string_view ciphertext, int pt_segment_size, int header_size,
+    int ct_offset, const Options& options) {
+  StatusOr<std::unique_ptr<InputStream>> dec_stream =
+      ParallelStreamingAeadDecryptingStream::New(
+          absl::make_unique<DummyStreamSegmentDecrypter>(
+              pt_segment_size, header_size, ct_offset),
+          GetInputStream(ciphertext), options);
+  EXPECT_THAT(dec_stream, IsOk());
+  return *std::move(dec_stream);
+}
+
+// Returns the status and the plaintext which a sequential
+// StreamingAeadDecryptingStream returns for 'ciphertext'.
+util::Status SequentialDecrypt(absl::string_view ciphertext,
+                               int pt_segment_size, int header_size,
+                               int ct_offset, std::string* plaintext) {
+  StatusOr<std::unique_ptr<InputStream>> dec_stream =
+      StreamingAeadDecryptingStream::New(
+          absl::make_unique<DummyStreamSegmentDecrypter>(
+              pt_segment_size, header_size, ct_offset),
+          GetInputStream(ciphertext));
+  if (!dec_stream.ok()) return dec_stream.status();
+  return ReadFromStream(dec_stream->get(), plaintext);
+}
+
+TEST(ParallelStreamingAeadDecryptingStreamTest, SamePlaintextAsSequential) {
+  struct TestVector {
+    int pt_segment_size;
+    int header_size;
+    int ct_offset;
+    int pt_size;
+  };
+  std::vector<TestVector> vectors = {
+      {512, 64, 0, 0},    {512, 64, 0, 1},        {512, 64, 0, 448},
+      {512, 64, 0, 449},  {512, 64, 8, 440},      {512, 64, 8, 5000},
+      {128, 16, 0, 1000}, {128, 16, 5, 128 * 40}, {64, 10, 3, 12345},
+  };
+  std::vector<Options> all_options = {{1, 1}, {1, 4}, {4, 1}, {4, 3},
+                                      {4, 16}, {8, 64}};
+  for (const TestVector& vector : vectors) {
+    DummyStreamSegmentEncrypter seg_enc(vector.pt_segment_size,
+                                        vector.header_size, vector.ct_offset);
+    std::string plaintext = Random::GetRandomBytes(vector.pt_size);
+    std::string ciphertext = seg_enc.GenerateCiphertext(plaintext);
+    for (const Options& options : all_options) {
+      SCOPED_TRACE(testing::Message()
+                   << "pt_segment_size = " << vector.pt_segment_size
+                   << ", pt_size = " << vector.pt_size
+                   << ", num_threads = " << options.num_threads
+                   << ", max_segments_in_flight = "
+                   << options.max_segments_in_flight);
+      std::unique_ptr<InputStream> dec_stream =
+          GetDecryptingStream(ciphertext, vector.pt_segment_size,
+                              vector.header_size, vector.ct_offset, options);
+      std::string decrypted;
+      EXPECT_THAT(ReadFromStream(dec_stream.get(), &decrypted), IsOk());
+      EXPECT_EQ(decrypted, plaintext);
+      EXPECT_EQ(dec_stream->Position(), vector.pt_size);
+    }
+  }
+}
+
+TEST(ParallelStreamingAeadDecryptingStreamTest, SmallReadsWithBackUp) {
+  int pt_segment_size = 100;
+  int header_size = 20;
+  DummyStreamSegmentEncrypter seg_enc(pt_segment_size, header_size,
+                                      /*ct_offset=*/0);
+  std::string plaintext = Random::GetRandomBytes(1000);
+  std::unique_ptr<InputStream> dec_stream =
+      GetDecryptingStream(seg_enc.GenerateCiphertext(plaintext),
+                          pt_segment_size, header_size, 0, Options());
+
+  // Reads 7 bytes per Next(), backing up the rest of each buffer.
+  std::string decrypted;
+  while (true) {
+    const void* buffer;
+    StatusOr<int> next_result = dec_stream->Next(&buffer);
+    if (next_result.status().code() == absl::StatusCode::kOutOfRange) break;
+    ASSERT_THAT(next_result, IsOk());
+    int count = std::min(7, *next_result);
+    decrypted.append(static_cast<const char*>(buffer), count);
+    dec_stream->BackUp(*next_result - count);
+    EXPECT_EQ(dec_stream->Position(), decrypted.size());
+  }
+  EXPECT_EQ(decrypted, plaintext);
+}
+
+TEST(ParallelStreamingAeadDecryptingStreamTest, SameErrorsAsSequential) {
+  int pt_segment_size = 64;
+  int header_size = 10;
+  DummyStreamSegmentEncrypter seg_enc(pt_segment_size, header_size,
+                                      /*ct_offset=*/0);
+  std::string ciphertext =
+      seg_enc.GenerateCiphertext(Random::GetRandomBytes(2000));
+  int ct_segment_size = seg_enc.get_ciphertext_segment_size();
+  int first_segment_end = ct_segment_size - header_size;
+
+  std::vector<std::string> modified_ciphertexts = {
+      // Truncated header.
+      ciphertext.substr(0, header_size - 1),
+      // Truncated after the first segment.
+      ciphertext.substr(0, first_segment_end),
+      // Truncated after a later segment.
+      ciphertext.substr(0, first_segment_end + 5 * ct_segment_size),
+      // Truncated within a segment.
+      ciphertext.substr(0, first_segment_end + 5 * ct_segment_size + 3),
+      // Segments swapped.
+      ciphertext.substr(0, first_segment_end + 3 * ct_segment_size) +
+          ciphertext.substr(first_segment_end + 4 * ct_segment_size,
+                            ct_segment_size) +
+          ciphertext.substr(first_segment_end + 3 * ct_segment_size),
+      // Trailing data after the last segment.
+      ciphertext + "trailing",
+  };
+  for (const std::string& modified : modified_ciphertexts) {
+    SCOPED_TRACE(testing::Message() << "size = " << modified.size());
+    std::string expected_plaintext;
+    util::Status expected_status = SequentialDecrypt(
+        modified, pt_segment_size, header_size, 0, &expected_plaintext);
+    for (const Options& options : std::vector<Options>{{1, 1}, {4, 8}}) {
+      std::unique_ptr<InputStream> dec_stream = GetDecryptingStream(
+          modified, pt_segment_size, header_size, 0, options);
+      std::string decrypted;
+      util::Status status = ReadFromStream(dec_stream.get(), &decrypted);
+      EXPECT_EQ(status, expected_status);
+      EXPECT_EQ(decrypted, expected_plaintext);
+    }
+  }
+}
+
+TEST(ParallelStreamingAeadDecryptingStreamTest, DestroyBeforeEnd) {
+  DummyStreamSegmentEncrypter seg_enc(64, 8, 0);
+  std::unique_ptr<InputStream> dec_stream = GetDecryptingStream(
+      seg_enc.GenerateCiphertext(Random::GetRandomBytes(5000)), 64, 8, 0,
+      {4, 8});
+  const void* buffer;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_THAT(dec_stream->Next(&buffer), IsOk());
+  }
+  dec_stream.reset();
+}
+
+TEST(ParallelStreamingAeadDecryptingStreamTest, SharedThreadPool) {
+  Options options;
+  options.num_threads = 0;
+  options.max_segments_in_flight = 4;
+  options.thread_pool = std::make_shared<internal::ThreadPool>(2);
+  DummyStreamSegmentEncrypter seg_enc(64, 8, 0);
+  std::vector<std::string> plaintexts;
+  std::vector<std::unique_ptr<InputStream>> dec_streams;
+  for (int i = 0; i < 3; ++i) {
+    plaintexts.push_back(Random::GetRandomBytes(3000));
+    dec_streams.push_back(GetDecryptingStream(
+        seg_enc.GenerateCiphertext(plaintexts.back()), 64, 8, 0, options));
+  }
+  // Interleave the streams, so that all of them read ahead on the pool.
+  std::vector<std::string> decrypted(dec_streams.size());
+  std::vector<bool> finished(dec_streams.size(), false);
+  int num_finished = 0;
+  while (num_finished < static_cast<int>(dec_streams.size())) {
+    for (size_t i = 0; i < dec_streams.size(); ++i) {
+      if (finished[i]) continue;
+      const void* buffer;
+      StatusOr<int> next_result = dec_streams[i]->Next(&buffer);
+      if (next_result.status().code() == absl::StatusCode::kOutOfRange) {
+        finished[i] = true;
+        ++num_finished;
+        continue;
+      }
+      ASSERT_THAT(next_result, IsOk());
+      decrypted[i].append(static_cast<const char*>(buffer), *next_result);
+    }
+  }
+  EXPECT_EQ(decrypted, plaintexts);
+}
+
+TEST(ParallelStreamingAeadDecryptingStreamTest,
+     DestroyBeforeEndOnSharedThreadPool) {
+  Options options;
+  options.thread_pool = std::make_shared<internal::ThreadPool>(4);
+  DummyStreamSegmentEncrypter seg_enc(64, 8, 0);
+  std::unique_ptr<InputStream> dec_stream = GetDecryptingStream(
+      seg_enc.GenerateCiphertext(Random::GetRandomBytes(5000)), 64, 8, 0,
+      options);
+  const void* buffer;
+  for (int i = 0; i < 3; ++i) {
+    ASSERT_THAT(dec_stream->Next(&buffer), IsOk());
+  }
+  // The pool outlives the stream, so the stream waits for its tasks.
+  dec_stream.reset();
+}
+
+TEST(ParallelStreamingAeadDecryptingStreamTest, InvalidArguments) {
+  EXPECT_THAT(ParallelStreamingAeadDecryptingStream::New(
+                  nullptr, GetInputStream("ciphertext"), Options())
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParallelStreamingAeadDecryptingStream::New(
+                  absl::make_unique<DummyStreamSegmentDecrypter>(64, 8, 0),
+                  nullptr, Options())
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParallelStreamingAeadDecryptingStream::New(
+                  absl::make_unique<DummyStreamSegmentDecrypter>(64, 8, 0),
+                  GetInputStream("ciphertext"), {0, 16})
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParallelStreamingAeadDecryptingStream::New(
+                  absl::make_unique<DummyStreamSegmentDecrypter>(64, 8, 0),
+                  GetInputStream("ciphertext"), {4, 0})
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+// A segment decrypter that only implements DecryptSegment().
+class SequentialOnlySegmentDecrypter : public DummyStreamSegmentDecrypter {
+ public:
+  using DummyStreamSegmentDecrypter::DummyStreamSegmentDecrypter;
+
+  util::Status DecryptSegmentInto(
+      absl::Span<const uint8_t> ciphertext, int64_t segment_number,
+      bool is_last_segment, absl::Span<uint8_t> plaintext) const override {
+    return StreamSegmentDecrypter::DecryptSegmentInto(
+        ciphertext, segment_number, is_last_segment, plaintext);
+  }
+};
+
+TEST(ParallelStreamingAeadDecryptingStreamTest, SequentialOnlyDecrypter) {
+  DummyStreamSegmentEncrypter seg_enc(64, 8, 0);
+  std::string plaintext = Random::GetRandomBytes(1000);
+  StatusOr<std::unique_ptr<InputStream>> dec_stream =
+      ParallelStreamingAeadDecryptingStream::New(
+          absl::make_unique<SequentialOnlySegmentDecrypter>(64, 8, 0),
+          GetInputStream(seg_enc.GenerateCiphertext(plaintext)), Options());
+  ASSERT_THAT(dec_stream, IsOk());
+  std::string decrypted;
+  EXPECT_THAT(ReadFromStream(dec_stream->get(), &decrypted), IsOk());
+  EXPECT_EQ(decrypted, plaintext);
+}
+
+// Encrypts 'plaintext' with 'streaming_aead', and decrypts it with a
+// parallel decrypting stream.
+void EncryptThenParallelDecrypt(const NonceBasedStreamingAead& streaming_aead,
+                                int ct_offset, int pt_size,
+                                const Options& options) {
+  std::string plaintext = Random::GetRandomBytes(pt_size);
+  std::string associated_data = "associated data";
+
+  auto ct_stream = absl::make_unique<std::stringstream>();
+  std::stringbuf* ct_buf = ct_stream->rdbuf();
+  ct_stream->write(std::string(ct_offset, 'o').data(), ct_offset);
+  StatusOr<std::unique_ptr<OutputStream>> enc_stream =
+      streaming_aead.NewEncryptingStream(
+          absl::make_unique<OstreamOutputStream>(std::move(ct_stream)),
+          associated_data);
+  ASSERT_THAT(enc_stream, IsOk());
+  ASSERT_THAT(WriteToStream(enc_stream->get(), plaintext), IsOk());
+
+  StatusOr<std::unique_ptr<InputStream>> dec_stream =
+      streaming_aead.NewParallelDecryptingStream(
+          GetInputStream(ct_buf->str().substr(ct_offset), 4096),
+          associated_data, options);
+  ASSERT_THAT(dec_stream, IsOk());
+  std::string decrypted;
+  ASSERT_THAT(ReadFromStream(dec_stream->get(), &decrypted), IsOk());
+  EXPECT_EQ(decrypted, plaintext);
+
+  StatusOr<std::unique_ptr<InputStream>> wrong_dec_stream =
+      streaming_aead.NewParallelDecryptingStream(
+          GetInputStream(ct_buf->str().substr(ct_offset), 4096),
+          "wrong associated data", options);
+  ASSERT_THAT(wrong_dec_stream, IsOk());
+  EXPECT_THAT(ReadFromStream(wrong_dec_stream->get(), &decrypted),
+              Not(IsOk()));
+}
+
+TEST(ParallelStreamingAeadDecryptingStreamTest, AesGcmHkdfRoundTrip) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  for (int ct_offset : {0, 5}) {
+    AesGcmHkdfStreaming::Params params;
+    params.ikm = Random::GetRandomKeyBytes(32);
+    params.hkdf_hash = SHA256;
+    params.derived_key_size = 32;
+    params.ciphertext_segment_size = 256;
+    params.ciphertext_offset = ct_offset;
+    StatusOr<std::unique_ptr<AesGcmHkdfStreaming>> streaming_aead =
+        AesGcmHkdfStreaming::New(std::move(params));
+    ASSERT_THAT(streaming_aead, IsOk());
+    for (int pt_size : {0, 10, 1000, 20000}) {
+      SCOPED_TRACE(testing::Message() << "ct_offset = " << ct_offset
+                                      << ", pt_size = " << pt_size);
+      EncryptThenParallelDecrypt(**streaming_aead, ct_offset, pt_size,
+                                 {4, 5});
+    }
+  }
+}
+
+TEST(ParallelStreamingAeadDecryptingStreamTest, AesCtrHmacRoundTrip) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  for (int ct_offset : {0, 5}) {
+    AesCtrHmacStreaming::Params params;
+    params.ikm = Random::GetRandomKeyBytes(32);
+    params.hkdf_algo = SHA256;
+    params.key_size = 16;
+    params.ciphertext_segment_size = 256;
+    params.ciphertext_offset = ct_offset;
+    params.tag_algo = SHA256;
+    params.tag_size = 16;
+    StatusOr<std::unique_ptr<AesCtrHmacStreaming>> streaming_aead =
+        AesCtrHmacStreaming::New(std::move(params));
+    ASSERT_THAT(streaming_aead, IsOk());
+    for (int pt_size : {0, 10, 1000, 20000}) {
+      SCOPED_TRACE(testing::Message() << "ct_offset = " << ct_offset
+                                      << ", pt_size = " << pt_size);
+      EncryptThenParallelDecrypt(**streaming_aead, ct_offset, pt_size,
+                                 {4, 5});
+    }
+  }
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,274 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/parallel_streaming_aead_encrypting_stream.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
+#include "tink/output_stream.h"
+#include "tink/subtle/stream_segment_encrypter.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+namespace {
+
+// Writes 'contents' to the specified 'output_stream', which must be non-null.
+// In case of errors returns the first non-OK status of
+// output_stream->Next()-operation.
+util::Status WriteToStream(const std::vector<uint8_t>& contents,
+                           OutputStream* output_stream) {
+  void* buffer;
+  int pos = 0;
+  int remaining = contents.size();
+  int available_space = 0;
+  int available_bytes = 0;
+  while (remaining > 0) {
+    util::StatusOr<int> next_result = output_stream->Next(&buffer);
+    if (!next_result.ok()) return next_result.status();
+    available_space = *next_result;
+    available_bytes = std::min(available_space, remaining);
+    memcpy(buffer, contents.data() + pos, available_bytes);
+    remaining -= available_bytes;
+    pos += available_bytes;
+  }
+  if (available_space > available_bytes) {
+    output_stream->BackUp(available_space - available_bytes);
+  }
+  return util::OkStatus();
+}
+
+}  // namespace
+
+// static
+util::StatusOr<std::unique_ptr<OutputStream>>
+ParallelStreamingAeadEncryptingStream::New(
+    std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+    std::unique_ptr<OutputStream> ciphertext_destination,
+    const Options& options) {
+  if (segment_encrypter == nullptr) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "segment_encrypter must be non-null");
+  }
+  if (ciphertext_destination == nullptr) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "ciphertext_destination must be non-null");
+  }
+  if ((options.thread_pool == nullptr && options.num_threads < 1) ||
+      options.max_segments_in_flight < 1) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        "num_threads and max_segments_in_flight must be positive");
+  }
+  int first_segment_size = segment_encrypter->get_plaintext_segment_size() -
+                           segment_encrypter->get_ciphertext_offset() -
+                           segment_encrypter->get_header().size();
+  if (first_segment_size <= 0) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "Size of the first segment must be greater than 0.");
+  }
+  return {absl::WrapUnique(new ParallelStreamingAeadEncryptingStream(
+      std::move(segment_encrypter), std::move(ciphertext_destination),
+      options))};
+}
+
+ParallelStreamingAeadEncryptingStream::ParallelStreamingAeadEncryptingStream(
+    std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+    std::unique_ptr<OutputStream> ciphertext_destination,
+    const Options& options)
+    : segment_encrypter_(std::move(segment_encrypter)),
+      ct_destination_(std::move(ciphertext_destination)),
+      max_segments_in_flight_(options.max_segments_in_flight),
+      thread_pool_(options.thread_pool != nullptr
+                       ? options.thread_pool
+                       : std::make_shared<internal::ThreadPool>(
+                             options.num_threads)) {
+  int first_segment_size = segment_encrypter_->get_plaintext_segment_size() -
+                           segment_encrypter_->get_ciphertext_offset() -
+                           segment_encrypter_->get_header().size();
+  pt_buffer_.resize(first_segment_size);
+  count_backedup_ = first_segment_size;
+}
+
+ParallelStreamingAeadEncryptingStream::
+    ~ParallelStreamingAeadEncryptingStream() {
+  // The workers access `segment_encrypter_` and `mutex_`, and a shared pool
+  // outlives the stream.
+  absl::MutexLock lock(&mutex_);
+  for (const std::shared_ptr<Segment>& segment : in_flight_) {
+    mutex_.Await(absl::Condition(&segment->done));
+  }
+}
+
+util::Status ParallelStreamingAeadEncryptingStream::EncryptInBackground(
+    std::vector<uint8_t>* plaintext, bool is_last_segment) {
+  while (static_cast<int>(in_flight_.size()) >= max_segments_in_flight_) {
+    util::Status status = WriteOldestSegment();
+    if (!status.ok()) return status;
+  }
+  std::shared_ptr<Segment> segment;
+  if (free_segments_.empty()) {
+    segment = std::make_shared<Segment>();
+  } else {
+    segment = std::move(free_segments_.back());
+    free_segments_.pop_back();
+  }
+  // Hand the plaintext over and leave the segment's old buffer in its place.
+  segment->plaintext.swap(*plaintext);
+  plaintext->clear();
+  segment->done = false;
+  const int64_t segment_number = next_segment_number_++;
+  in_flight_.push_back(segment);
+  segment->ciphertext.resize(segment->plaintext.size() +
+                             segment_encrypter_->get_ciphertext_segment_size() -
+                             segment_encrypter_->get_plaintext_segment_size());
+  thread_pool_->Schedule([this, segment, segment_number, is_last_segment] {
+    util::Status status = segment_encrypter_->EncryptSegmentAt(
+        segment->plaintext, segment_number, is_last_segment,
+        absl::MakeSpan(segment->ciphertext));
+    absl::MutexLock lock(&mutex_);
+    segment->status = std::move(status);
+    segment->done = true;
+  });
+  return util::OkStatus();
+}
+
+util::Status ParallelStreamingAeadEncryptingStream::WriteOldestSegment() {
+  std::shared_ptr<Segment> segment = std::move(in_flight_.front());
+  in_flight_.pop_front();
+  {
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(&segment->done));
+  }
+  if (!segment->status.ok()) return segment->status;
+  util::Status status =
+      WriteToStream(segment->ciphertext, ct_destination_.get());
+  free_segments_.push_back(std::move(segment));
+  return status;
+}
+
+util::Status ParallelStreamingAeadEncryptingStream::WriteAllSegments() {
+  while (!in_flight_.empty()) {
+    util::Status status = WriteOldestSegment();
+    if (!status.ok()) return status;
+  }
+  return util::OkStatus();
+}
+
+util::StatusOr<int> ParallelStreamingAeadEncryptingStream::Next(void** data) {
+  if (!status_.ok()) return status_;
+
+  // The first call to Next().
+  if (is_first_segment_) {
+    is_first_segment_ = false;
+    count_backedup_ = 0;
+    status_ =
+        WriteToStream(segment_encrypter_->get_header(), ct_destination_.get());
+    if (!status_.ok()) return status_;
+    *data = pt_buffer_.data();
+    position_ = pt_buffer_.size();
+    return pt_buffer_.size();
+  }
+
+  // If some space was backed up, return it first.
+  if (count_backedup_ > 0) {
+    position_ += count_backedup_;
+    pt_buffer_offset_ = pt_buffer_.size() - count_backedup_;
+    int backedup = count_backedup_;
+    count_backedup_ = 0;
+    *data = pt_buffer_.data() + pt_buffer_offset_;
+    return backedup;
+  }
+
+  // As in StreamingAeadEncryptingStream, the full pt_buffer_ becomes the
+  // pending segment, since only the next call to Next() or Close() tells
+  // whether it is the last one. The previously pending segment is now known
+  // not to be the last one, and is handed to the workers.
+  if (!pt_to_encrypt_.empty()) {
+    status_ = EncryptInBackground(&pt_to_encrypt_, /*is_last_segment=*/false);
+    if (!status_.ok()) return status_;
+  }
+  pt_buffer_.swap(pt_to_encrypt_);
+  pt_buffer_.resize(segment_encrypter_->get_plaintext_segment_size());
+  *data = pt_buffer_.data();
+  pt_buffer_offset_ = 0;
+  position_ += pt_buffer_.size();
+  return pt_buffer_.size();
+}
+
+void ParallelStreamingAeadEncryptingStream::BackUp(int count) {
+  if (is_first_segment_ || !status_.ok() || count < 1) return;
+  int curr_buffer_size = pt_buffer_.size() - pt_buffer_offset_;
+  int actual_count = std::min(count, curr_buffer_size - count_backedup_);
+  count_backedup_ += actual_count;
+  position_ -= actual_count;
+}
+
+util::Status ParallelStreamingAeadEncryptingStream::Close() {
+  if (!status_.ok()) return status_;
+  if (is_first_segment_) {  // Next() was never called.
+    status_ =
+        WriteToStream(segment_encrypter_->get_header(), ct_destination_.get());
+    if (!status_.ok()) return status_;
+  }
+
+  // The last segment encrypts plaintext from pt_to_encrypt_,
+  // unless the current pt_buffer_ has some plaintext bytes.
+  std::vector<uint8_t>* pt_last_segment = &pt_to_encrypt_;
+  if ((!pt_buffer_.empty()) &&
+      count_backedup_ < static_cast<int>(pt_buffer_.size())) {
+    pt_buffer_.resize(pt_buffer_.size() - count_backedup_);
+    pt_last_segment = &pt_buffer_;
+  }
+  if (pt_last_segment != &pt_to_encrypt_ && (!pt_to_encrypt_.empty())) {
+    status_ = EncryptInBackground(&pt_to_encrypt_, /*is_last_segment=*/false);
+    if (!status_.ok()) {
+      ct_destination_->Close().IgnoreError();
+      return status_;
+    }
+  }
+  status_ = EncryptInBackground(pt_last_segment, /*is_last_segment=*/true);
+  if (status_.ok()) {
+    status_ = WriteAllSegments();
+  }
+  if (!status_.ok()) {
+    ct_destination_->Close().IgnoreError();
+    return status_;
+  }
+  status_ = util::Status(absl::StatusCode::kFailedPrecondition,
+                         "Stream closed");
+  return ct_destination_->Close();
+}
+
+int64_t ParallelStreamingAeadEncryptingStream::Position() const {
+  return position_;
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,138 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_PARALLEL_STREAMING_AEAD_ENCRYPTING_STREAM_H_
+#define TINK_SUBTLE_PARALLEL_STREAMING_AEAD_ENCRYPTING_STREAM_H_
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "tink/internal/thread_pool.h"
+#include "tink/output_stream.h"
+#include "tink/subtle/stream_segment_encrypter.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// An encrypting stream like StreamingAeadEncryptingStream, which encrypts
+// full segments on a pool of worker threads while the caller keeps writing.
+// Ciphertext segments are written to the destination in order and on the
+// caller's thread, so the ciphertext is byte-for-byte the same as the one
+// StreamingAeadEncryptingStream produces with the same segment encrypter.
+//
+// The segment encrypter must support EncryptSegmentAt().
+class ParallelStreamingAeadEncryptingStream : public OutputStream {
+ public:
+  struct Options {
+    // Number of worker threads that encrypt segments. Ignored if
+    // `thread_pool` is set.
+    int num_threads = 4;
+    // Maximum number of segments handed to the workers and not yet written
+    // to the destination. Bounds the memory used to about
+    // 2 * max_segments_in_flight * ciphertext segment size. Must be at least
+    // 1.
+    int max_segments_in_flight = 16;
+    // If not null, segments are encrypted on this pool, which may be shared
+    // with other streams, instead of on a pool owned by the stream. The
+    // stream must not be used from the threads of the pool.
+    std::shared_ptr<internal::ThreadPool> thread_pool;
+  };
+
+  // Returns a stream that encrypts the bytes written to it with
+  // 'segment_encrypter' and writes the ciphertext to
+  // 'ciphertext_destination'.
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<crypto::tink::OutputStream>>
+  New(std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+      std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination,
+      const Options& options);
+
+  // -----------------------
+  // Methods of OutputStream-interface implemented by this class.
+  crypto::tink::util::StatusOr<int> Next(void** data) override;
+  void BackUp(int count) override;
+  crypto::tink::util::Status Close() override;
+  int64_t Position() const override;
+
+  // Waits for the segments still being encrypted.
+  ~ParallelStreamingAeadEncryptingStream() override;
+
+ private:
+  // A segment handed to the worker threads.
+  struct Segment {
+    std::vector<uint8_t> plaintext;
+    std::vector<uint8_t> ciphertext;
+    crypto::tink::util::Status status;
+    bool done = false;
+  };
+
+  ParallelStreamingAeadEncryptingStream(
+      std::unique_ptr<StreamSegmentEncrypter> segment_encrypter,
+      std::unique_ptr<crypto::tink::OutputStream> ciphertext_destination,
+      const Options& options);
+
+  // Schedules encryption of `plaintext`, taking over its contents, as the
+  // next segment. Writes completed segments to the destination as needed to
+  // stay within max_segments_in_flight.
+  crypto::tink::util::Status EncryptInBackground(
+      std::vector<uint8_t>* plaintext, bool is_last_segment);
+
+  // Waits for the oldest segment in flight and writes it to the destination.
+  crypto::tink::util::Status WriteOldestSegment();
+
+  // Writes all segments in flight to the destination.
+  crypto::tink::util::Status WriteAllSegments();
+
+  const std::unique_ptr<StreamSegmentEncrypter> segment_encrypter_;
+  const std::unique_ptr<crypto::tink::OutputStream> ct_destination_;
+  const int max_segments_in_flight_;
+
+  std::vector<uint8_t> pt_buffer_;  // plaintext buffer
+  std::vector<uint8_t> pt_to_encrypt_;  // plaintext of the pending segment
+  int64_t position_ = 0;  // number of plaintext bytes written to this stream
+  crypto::tink::util::Status status_;  // status of the stream
+  int64_t next_segment_number_ = 0;
+
+  // Counters that describe the state of the data in pt_buffer_, as in
+  // StreamingAeadEncryptingStream.
+  int count_backedup_;
+  int pt_buffer_offset_ = 0;
+  bool is_first_segment_ = true;
+
+  // Segments in flight, oldest first, and segments kept for reuse of their
+  // buffers. Only accessed by the caller's thread; the workers only access
+  // the Segment they encrypt.
+  std::deque<std::shared_ptr<Segment>> in_flight_;
+  std::vector<std::shared_ptr<Segment>> free_segments_;
+
+  // Guards Segment::done and Segment::status of all segments.
+  absl::Mutex mutex_;
+
+  const std::shared_ptr<internal::ThreadPool> thread_pool_;
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_PARALLEL_STREAMING_AEAD_ENCRYPTING_STREAM_H_
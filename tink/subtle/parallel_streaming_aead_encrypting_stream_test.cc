@@ -0,0 +1,347 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/parallel_streaming_aead_encrypting_stream.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/config/tink_fips.h"
+#include "tink/input_stream.h"
+#include "tink/internal/thread_pool.h"
+#include "tink/output_stream.h"
+#include "tink/streaming_aead.h"
+#include "tink/subtle/aes_ctr_hmac_streaming.h"
+#include "tink/subtle/aes_gcm_hkdf_streaming.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/nonce_based_streaming_aead.h"
+#include "tink/subtle/random.h"
+#include "tink/subtle/stream_segment_encrypter.h"
+#include "tink/subtle/test_util.h"
+#include "tink/util/istream_input_stream.h"
+#include "tink/util/ostream_output_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+using ::crypto::tink::subtle::test::DummyStreamSegmentEncrypter;
+using ::crypto::tink::subtle::test::ReadFromStream;
+using ::crypto::tink::subtle::test::WriteToStream;
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::crypto::tink::util::IstreamInputStream;
+using ::crypto::tink::util::OstreamOutputStream;
+using ::crypto::tink::util::StatusOr;
+using ::testing::HasSubstr;
+
+using Options = ParallelStreamingAeadEncryptingStream::Options;
+
+struct TestVector {
+  int pt_segment_size;
+  int header_size;
+  int ct_offset;
+  int pt_size;
+};
+
+std::unique_ptr<OutputStream> GetCiphertextDestination(std::stringbuf** buf) {
+  auto ct_stream = absl::make_unique<std::stringstream>();
+  *buf = ct_stream->rdbuf();
+  return absl::make_unique<OstreamOutputStream>(std::move(ct_stream));
+}
+
+// Encrypts 'plaintext' with a parallel stream over a
+// DummyStreamSegmentEncrypter, and checks that the ciphertext is the one a
+// sequential stream produces.
+void EncryptAndCompare(const TestVector& vector, const Options& options) {
+  SCOPED_TRACE(testing::Message()
+               << "pt_segment_size = " << vector.pt_segment_size
+               << ", header_size = " << vector.header_size
+               << ", ct_offset = " << vector.ct_offset
+               << ", pt_size = " << vector.pt_size
+               << ", num_threads = " << options.num_threads
+               << ", max_segments_in_flight = "
+               << options.max_segments_in_flight);
+  std::stringbuf* ct_buf;
+  auto seg_enc = absl::make_unique<DummyStreamSegmentEncrypter>(
+      vector.pt_segment_size, vector.header_size, vector.ct_offset);
+  DummyStreamSegmentEncrypter* seg_enc_ref = seg_enc.get();
+  StatusOr<std::unique_ptr<OutputStream>> enc_stream =
+      ParallelStreamingAeadEncryptingStream::New(
+          std::move(seg_enc), GetCiphertextDestination(&ct_buf), options);
+  ASSERT_THAT(enc_stream, IsOk());
+
+  std::string plaintext = Random::GetRandomBytes(vector.pt_size);
+  ASSERT_THAT(WriteToStream(enc_stream->get(), plaintext), IsOk());
+  EXPECT_EQ((*enc_stream)->Position(), vector.pt_size);
+  EXPECT_EQ(ct_buf->str(), seg_enc_ref->GenerateCiphertext(plaintext));
+  EXPECT_EQ(ct_buf->str().size(), seg_enc_ref->get_generated_output_size());
+  EXPECT_THAT((*enc_stream)->Close(),
+              StatusIs(absl::StatusCode::kFailedPrecondition));
+}
+
+TEST(ParallelStreamingAeadEncryptingStreamTest, SameCiphertextAsSequential) {
+  std::vector<TestVector> vectors = {
+      {512, 64, 0, 0},    {512, 64, 0, 1},       {512, 64, 0, 448},
+      {512, 64, 0, 449},  {512, 64, 8, 440},     {512, 64, 8, 5000},
+      {128, 16, 0, 1000}, {128, 16, 5, 128 * 40}, {64, 10, 3, 12345},
+  };
+  std::vector<Options> all_options = {{1, 1}, {1, 4}, {4, 1}, {4, 3},
+                                      {4, 16}, {8, 64}};
+  for (const TestVector& vector : vectors) {
+    for (const Options& options : all_options) {
+      EncryptAndCompare(vector, options);
+    }
+  }
+}
+
+TEST(ParallelStreamingAeadEncryptingStreamTest, SmallWritesWithBackUp) {
+  int pt_segment_size = 100;
+  int header_size = 20;
+  std::stringbuf* ct_buf;
+  auto seg_enc = absl::make_unique<DummyStreamSegmentEncrypter>(
+      pt_segment_size, header_size, /*ct_offset=*/0);
+  DummyStreamSegmentEncrypter* seg_enc_ref = seg_enc.get();
+  StatusOr<std::unique_ptr<OutputStream>> enc_stream =
+      ParallelStreamingAeadEncryptingStream::New(
+          std::move(seg_enc), GetCiphertextDestination(&ct_buf), Options());
+  ASSERT_THAT(enc_stream, IsOk());
+
+  // Writes 7 bytes per Next(), backing up the rest of each buffer.
+  std::string plaintext = Random::GetRandomBytes(1000);
+  int pos = 0;
+  while (pos < static_cast<int>(plaintext.size())) {
+    void* buffer;
+    StatusOr<int> next_result = (*enc_stream)->Next(&buffer);
+    ASSERT_THAT(next_result, IsOk());
+    int count = std::min<int>(
+        {7, *next_result, static_cast<int>(plaintext.size() - pos)});
+    memcpy(buffer, plaintext.data() + pos, count);
+    (*enc_stream)->BackUp(*next_result - count);
+    pos += count;
+    EXPECT_EQ((*enc_stream)->Position(), pos);
+  }
+  ASSERT_THAT((*enc_stream)->Close(), IsOk());
+  EXPECT_EQ(ct_buf->str(), seg_enc_ref->GenerateCiphertext(plaintext));
+}
+
+TEST(ParallelStreamingAeadEncryptingStreamTest, DestroyWithoutClose) {
+  std::stringbuf* ct_buf;
+  StatusOr<std::unique_ptr<OutputStream>> enc_stream =
+      ParallelStreamingAeadEncryptingStream::New(
+          absl::make_unique<DummyStreamSegmentEncrypter>(64, 8, 0),
+          GetCiphertextDestination(&ct_buf), {4, 8});
+  ASSERT_THAT(enc_stream, IsOk());
+  ASSERT_THAT(WriteToStream(enc_stream->get(), Random::GetRandomBytes(5000),
+                            /*close_stream=*/false),
+              IsOk());
+  enc_stream->reset();
+}
+
+TEST(ParallelStreamingAeadEncryptingStreamTest, SharedThreadPool) {
+  Options options;
+  options.num_threads = 0;
+  options.max_segments_in_flight = 4;
+  options.thread_pool = std::make_shared<internal::ThreadPool>(2);
+  std::vector<std::stringbuf*> ct_bufs(3);
+  std::vector<DummyStreamSegmentEncrypter*> seg_encs;
+  std::vector<std::unique_ptr<OutputStream>> enc_streams;
+  for (std::stringbuf*& ct_buf : ct_bufs) {
+    auto seg_enc = absl::make_unique<DummyStreamSegmentEncrypter>(64, 8, 0);
+    seg_encs.push_back(seg_enc.get());
+    StatusOr<std::unique_ptr<OutputStream>> enc_stream =
+        ParallelStreamingAeadEncryptingStream::New(
+            std::move(seg_enc), GetCiphertextDestination(&ct_buf), options);
+    ASSERT_THAT(enc_stream, IsOk());
+    enc_streams.push_back(*std::move(enc_stream));
+  }
+  std::vector<std::string> plaintexts;
+  for (std::unique_ptr<OutputStream>& enc_stream : enc_streams) {
+    plaintexts.push_back(Random::GetRandomBytes(3000));
+    ASSERT_THAT(WriteToStream(enc_stream.get(), plaintexts.back(),
+                              /*close_stream=*/false),
+                IsOk());
+  }
+  for (size_t i = 0; i < enc_streams.size(); ++i) {
+    ASSERT_THAT(enc_streams[i]->Close(), IsOk());
+    EXPECT_EQ(ct_bufs[i]->str(),
+              seg_encs[i]->GenerateCiphertext(plaintexts[i]));
+  }
+}
+
+TEST(ParallelStreamingAeadEncryptingStreamTest,
+     DestroyWithoutCloseOnSharedThreadPool) {
+  Options options;
+  options.thread_pool = std::make_shared<internal::ThreadPool>(4);
+  std::stringbuf* ct_buf;
+  StatusOr<std::unique_ptr<OutputStream>> enc_stream =
+      ParallelStreamingAeadEncryptingStream::New(
+          absl::make_unique<DummyStreamSegmentEncrypter>(64, 8, 0),
+          GetCiphertextDestination(&ct_buf), options);
+  ASSERT_THAT(enc_stream, IsOk());
+  ASSERT_THAT(WriteToStream(enc_stream->get(), Random::GetRandomBytes(5000),
+                            /*close_stream=*/false),
+              IsOk());
+  // The pool outlives the stream, so the stream waits for its segments.
+  enc_stream->reset();
+}
+
+TEST(ParallelStreamingAeadEncryptingStreamTest, InvalidArguments) {
+  std::stringbuf* ct_buf;
+  EXPECT_THAT(ParallelStreamingAeadEncryptingStream::New(
+                  nullptr, GetCiphertextDestination(&ct_buf), Options())
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParallelStreamingAeadEncryptingStream::New(
+                  absl::make_unique<DummyStreamSegmentEncrypter>(64, 8, 0),
+                  nullptr, Options())
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParallelStreamingAeadEncryptingStream::New(
+                  absl::make_unique<DummyStreamSegmentEncrypter>(64, 8, 0),
+                  GetCiphertextDestination(&ct_buf), {0, 16})
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(ParallelStreamingAeadEncryptingStream::New(
+                  absl::make_unique<DummyStreamSegmentEncrypter>(64, 8, 0),
+                  GetCiphertextDestination(&ct_buf), {4, 0})
+                  .status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+// A segment encrypter that only supports sequential encryption.
+class SequentialOnlySegmentEncrypter : public DummyStreamSegmentEncrypter {
+ public:
+  using DummyStreamSegmentEncrypter::DummyStreamSegmentEncrypter;
+
+  util::Status EncryptSegmentAt(absl::Span<const uint8_t> plaintext,
+                                int64_t segment_number, bool is_last_segment,
+                                absl::Span<uint8_t> ciphertext) const override {
+    return StreamSegmentEncrypter::EncryptSegmentAt(
+        plaintext, segment_number, is_last_segment, ciphertext);
+  }
+};
+
+TEST(ParallelStreamingAeadEncryptingStreamTest, UnsupportedSegmentEncrypter) {
+  std::stringbuf* ct_buf;
+  StatusOr<std::unique_ptr<OutputStream>> enc_stream =
+      ParallelStreamingAeadEncryptingStream::New(
+          absl::make_unique<SequentialOnlySegmentEncrypter>(64, 8, 0),
+          GetCiphertextDestination(&ct_buf), Options());
+  ASSERT_THAT(enc_stream, IsOk());
+  EXPECT_THAT(WriteToStream(enc_stream->get(), Random::GetRandomBytes(1000)),
+              StatusIs(absl::StatusCode::kUnimplemented,
+                       HasSubstr("EncryptSegmentAt")));
+}
+
+// Encrypts 'plaintext' with a parallel stream of 'streaming_aead', and
+// decrypts it with a regular decrypting stream.
+void ParallelEncryptThenDecrypt(const NonceBasedStreamingAead& streaming_aead,
+                                int ct_offset, int pt_size,
+                                const Options& options) {
+  std::string plaintext = Random::GetRandomBytes(pt_size);
+  std::string associated_data = "associated data";
+
+  auto ct_stream = absl::make_unique<std::stringstream>();
+  std::stringbuf* ct_buf = ct_stream->rdbuf();
+  ct_stream->write(std::string(ct_offset, 'o').data(), ct_offset);
+  StatusOr<std::unique_ptr<OutputStream>> enc_stream =
+      streaming_aead.NewParallelEncryptingStream(
+          absl::make_unique<OstreamOutputStream>(std::move(ct_stream)),
+          associated_data, options);
+  ASSERT_THAT(enc_stream, IsOk());
+  ASSERT_THAT(WriteToStream(enc_stream->get(), plaintext), IsOk());
+
+  auto ct_input = absl::make_unique<std::stringstream>(
+      ct_buf->str().substr(ct_offset));
+  StatusOr<std::unique_ptr<InputStream>> dec_stream =
+      streaming_aead.NewDecryptingStream(
+          absl::make_unique<IstreamInputStream>(std::move(ct_input)),
+          associated_data);
+  ASSERT_THAT(dec_stream, IsOk());
+  std::string decrypted;
+  ASSERT_THAT(ReadFromStream(dec_stream->get(), &decrypted), IsOk());
+  EXPECT_EQ(decrypted, plaintext);
+}
+
+TEST(ParallelStreamingAeadEncryptingStreamTest, AesGcmHkdfRoundTrip) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  for (int ct_offset : {0, 5}) {
+    AesGcmHkdfStreaming::Params params;
+    params.ikm = Random::GetRandomKeyBytes(32);
+    params.hkdf_hash = SHA256;
+    params.derived_key_size = 32;
+    params.ciphertext_segment_size = 256;
+    params.ciphertext_offset = ct_offset;
+    StatusOr<std::unique_ptr<AesGcmHkdfStreaming>> streaming_aead =
+        AesGcmHkdfStreaming::New(std::move(params));
+    ASSERT_THAT(streaming_aead, IsOk());
+    for (int pt_size : {0, 10, 1000, 20000}) {
+      SCOPED_TRACE(testing::Message() << "ct_offset = " << ct_offset
+                                      << ", pt_size = " << pt_size);
+      ParallelEncryptThenDecrypt(**streaming_aead, ct_offset, pt_size,
+                                 {4, 5});
+    }
+  }
+}
+
+TEST(ParallelStreamingAeadEncryptingStreamTest, AesCtrHmacRoundTrip) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  for (int ct_offset : {0, 5}) {
+    AesCtrHmacStreaming::Params params;
+    params.ikm = Random::GetRandomKeyBytes(32);
+    params.hkdf_algo = SHA256;
+    params.key_size = 16;
+    params.ciphertext_segment_size = 256;
+    params.ciphertext_offset = ct_offset;
+    params.tag_algo = SHA256;
+    params.tag_size = 16;
+    StatusOr<std::unique_ptr<AesCtrHmacStreaming>> streaming_aead =
+        AesCtrHmacStreaming::New(std::move(params));
+    ASSERT_THAT(streaming_aead, IsOk());
+    for (int pt_size : {0, 10, 1000, 20000}) {
+      SCOPED_TRACE(testing::Message() << "ct_offset = " << ct_offset
+                                      << ", pt_size = " << pt_size);
+      ParallelEncryptThenDecrypt(**streaming_aead, ct_offset, pt_size,
+                                 {4, 5});
+    }
+  }
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,153 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/prf/hkdf_prf.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/evp.h"
+#include "openssl/hmac.h"
+#include "tink/internal/fips_utils.h"
+#include "tink/internal/hkdf_util.h"
+#include "tink/internal/md_util.h"
+#include "tink/internal/ssl_unique_ptr.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/subtle_util.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+namespace {
+
+// RFC 5869 limits the output of HKDF-Expand to 255 blocks.
+constexpr size_t kMaxNumBlocks = 255;
+
+}  // namespace
+
+// static
+util::StatusOr<std::unique_ptr<Prf>> HkdfPrf::New(
+    HashType hash, const util::SecretData& secret, absl::string_view salt) {
+  auto status = internal::CheckFipsCompatibility<HkdfPrf>();
+  if (!status.ok()) return status;
+
+  if (hash != SHA256 && hash != SHA512 && hash != SHA1) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Hash ", hash, " not acceptable for HkdfPrf"));
+  }
+  if (secret.size() < 10) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "Too short secret for HkdfPrf");
+  }
+  util::StatusOr<const EVP_MD*> md = internal::EvpHashFromHashType(hash);
+  if (!md.ok()) {
+    return util::Status(absl::StatusCode::kUnimplemented, "Unsupported hash");
+  }
+
+  internal::SslUniquePtr<HMAC_CTX> keyed_context(HMAC_CTX_new());
+  if (keyed_context == nullptr) {
+    return util::Status(absl::StatusCode::kInternal, "HMAC_CTX_new failed");
+  }
+  status = internal::HkdfExtract(*md, {util::SecretDataAsStringView(secret)},
+                                 salt, keyed_context.get());
+  if (!status.ok()) {
+    return status;
+  }
+  return {absl::WrapUnique(
+      new HkdfPrf(std::move(keyed_context), EVP_MD_size(*md)))};
+}
+
+util::StatusOr<internal::SslUniquePtr<HMAC_CTX>> HkdfPrf::NewContext() const {
+  internal::SslUniquePtr<HMAC_CTX> context(HMAC_CTX_new());
+  if (context == nullptr ||
+      !HMAC_CTX_copy(context.get(), keyed_context_.get())) {
+    return util::Status(absl::StatusCode::kInternal,
+                        "BoringSSL failed to copy the HMAC context");
+  }
+  return std::move(context);
+}
+
+util::Status HkdfPrf::CheckOutputLength(size_t output_length) const {
+  if (output_length > kMaxNumBlocks * digest_size_) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("PRF only supports outputs up to ",
+                     kMaxNumBlocks * digest_size_, " bytes, but ",
+                     output_length, " bytes were requested"));
+  }
+  return util::OkStatus();
+}
+
+util::StatusOr<std::string> HkdfPrf::Compute(absl::string_view input,
+                                             size_t output_length) const {
+  util::Status status = CheckOutputLength(output_length);
+  if (!status.ok()) {
+    return status;
+  }
+  util::StatusOr<internal::SslUniquePtr<HMAC_CTX>> context = NewContext();
+  if (!context.ok()) {
+    return context.status();
+  }
+  std::string output;
+  ResizeStringUninitialized(&output, output_length);
+  status = internal::HkdfExpand(
+      context->get(), input,
+      absl::MakeSpan(reinterpret_cast<uint8_t*>(&output[0]), output_length));
+  if (!status.ok()) {
+    return status;
+  }
+  return output;
+}
+
+util::Status HkdfPrf::ComputeBatch(absl::Span<const absl::string_view> inputs,
+                                   size_t output_length,
+                                   std::string* outputs) const {
+  util::Status status = CheckOutputLength(output_length);
+  if (!status.ok()) {
+    return status;
+  }
+  util::StatusOr<internal::SslUniquePtr<HMAC_CTX>> context = NewContext();
+  if (!context.ok()) {
+    return context.status();
+  }
+  ResizeStringUninitialized(outputs, inputs.size() * output_length);
+  uint8_t* output = reinterpret_cast<uint8_t*>(&(*outputs)[0]);
+  for (absl::string_view input : inputs) {
+    status = internal::HkdfExpand(context->get(), input,
+                                  absl::MakeSpan(output, output_length));
+    if (!status.ok()) {
+      return status;
+    }
+    output += output_length;
+  }
+  return util::OkStatus();
+}
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,83 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_SUBTLE_PRF_HKDF_PRF_H_
+#define TINK_SUBTLE_PRF_HKDF_PRF_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "openssl/hmac.h"
+#include "tink/internal/fips_utils.h"
+#include "tink/internal/ssl_unique_ptr.h"
+#include "tink/prf/prf_set.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+
+// HKDF (RFC 5869) as a Prf, with the input used as the HKDF info. Computes
+// the same outputs as the prefixes of the streams of HkdfStreamingPrf.
+//
+// HKDF-Extract only depends on the key and the salt, so it runs once in
+// New(), and every computation only runs HKDF-Expand. This is much cheaper
+// than going through HkdfStreamingPrf and an InputStream for every input.
+class HkdfPrf : public Prf {
+ public:
+  static crypto::tink::util::StatusOr<std::unique_ptr<Prf>> New(
+      HashType hash, const util::SecretData& secret, absl::string_view salt);
+
+  crypto::tink::util::StatusOr<std::string> Compute(
+      absl::string_view input, size_t output_length) const override;
+
+  // Expands the whole batch with a single copy of the keyed context; see
+  // Prf::ComputeBatch.
+  crypto::tink::util::Status ComputeBatch(
+      absl::Span<const absl::string_view> inputs, size_t output_length,
+      std::string* outputs) const override;
+
+  static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
+      crypto::tink::internal::FipsCompatibility::kNotFips;
+
+ private:
+  HkdfPrf(internal::SslUniquePtr<HMAC_CTX> keyed_context, size_t digest_size)
+      : keyed_context_(std::move(keyed_context)), digest_size_(digest_size) {}
+
+  // Returns a copy of keyed_context_ owned by the caller.
+  crypto::tink::util::StatusOr<internal::SslUniquePtr<HMAC_CTX>> NewContext()
+      const;
+
+  crypto::tink::util::Status CheckOutputLength(size_t output_length) const;
+
+  // Context keyed with the pseudorandom key computed by HKDF-Extract. It is
+  // copied for every computation and never modified after construction.
+  const internal::SslUniquePtr<HMAC_CTX> keyed_context_;
+  const size_t digest_size_;
+};
+
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_SUBTLE_PRF_HKDF_PRF_H_
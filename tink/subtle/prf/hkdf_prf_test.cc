@@ -0,0 +1,186 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/subtle/prf/hkdf_prf.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tink/config/tink_fips.h"
+#include "tink/prf/prf_set.h"
+#include "tink/subtle/common_enums.h"
+#include "tink/subtle/hkdf.h"
+#include "tink/subtle/prf/hkdf_streaming_prf.h"
+#include "tink/subtle/prf/streaming_prf.h"
+#include "tink/util/input_stream_util.h"
+#include "tink/util/secret_data.h"
+#include "tink/util/statusor.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace subtle {
+namespace {
+
+using ::crypto::tink::test::HexDecodeOrDie;
+using ::crypto::tink::test::HexEncode;
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+using ::testing::Eq;
+using ::testing::Not;
+using ::testing::TestWithParam;
+using ::testing::Values;
+
+// Test case 1 of RFC 5869, Appendix A.
+TEST(HkdfPrfTest, Rfc5869TestVector) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  util::StatusOr<std::unique_ptr<Prf>> prf = HkdfPrf::New(
+      SHA256,
+      util::SecretDataFromStringView(
+          HexDecodeOrDie("0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b0b")),
+      HexDecodeOrDie("000102030405060708090a0b0c"));
+  ASSERT_THAT(prf, IsOk());
+  util::StatusOr<std::string> output =
+      (*prf)->Compute(HexDecodeOrDie("f0f1f2f3f4f5f6f7f8f9"), 42);
+  ASSERT_THAT(output, IsOk());
+  EXPECT_THAT(HexEncode(*output),
+              Eq("3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4"
+                 "c5bf34007208d5b887185865"));
+}
+
+class HkdfPrfHashTest : public TestWithParam<HashType> {};
+
+TEST_P(HkdfPrfHashTest, MatchesHkdfStreamingPrf) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  util::SecretData secret = util::SecretDataFromStringView("key0123456");
+  util::StatusOr<std::unique_ptr<Prf>> prf =
+      HkdfPrf::New(GetParam(), secret, "salt");
+  ASSERT_THAT(prf, IsOk());
+  util::StatusOr<std::unique_ptr<StreamingPrf>> streaming_prf =
+      HkdfStreamingPrf::New(GetParam(), secret, "salt");
+  ASSERT_THAT(streaming_prf, IsOk());
+
+  for (absl::string_view input : {"", "input", "a somewhat longer input"}) {
+    // Spans several HKDF blocks for all hash functions.
+    for (int output_length = 0; output_length <= 200; ++output_length) {
+      SCOPED_TRACE(output_length);
+      util::StatusOr<std::string> output =
+          (*prf)->Compute(input, output_length);
+      ASSERT_THAT(output, IsOk());
+      std::unique_ptr<InputStream> stream = (*streaming_prf)->ComputePrf(input);
+      util::StatusOr<std::string> expected =
+          ReadBytesFromStream(output_length, stream.get());
+      ASSERT_THAT(expected, IsOk());
+      EXPECT_THAT(*output, Eq(*expected));
+    }
+  }
+}
+
+TEST_P(HkdfPrfHashTest, MatchesComputeHkdf) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  util::StatusOr<std::unique_ptr<Prf>> prf = HkdfPrf::New(
+      GetParam(), util::SecretDataFromStringView("key0123456"), "salt");
+  ASSERT_THAT(prf, IsOk());
+  util::StatusOr<std::string> output = (*prf)->Compute("input", 100);
+  ASSERT_THAT(output, IsOk());
+  util::StatusOr<std::string> expected =
+      Hkdf::ComputeHkdf(GetParam(), "key0123456", "salt", "input", 100);
+  ASSERT_THAT(expected, IsOk());
+  EXPECT_THAT(*output, Eq(*expected));
+}
+
+TEST_P(HkdfPrfHashTest, ComputeBatch) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  util::StatusOr<std::unique_ptr<Prf>> prf = HkdfPrf::New(
+      GetParam(), util::SecretDataFromStringView("key0123456"), "salt");
+  ASSERT_THAT(prf, IsOk());
+  std::vector<absl::string_view> inputs = {"", "input", "input", "other"};
+  for (int output_length : {0, 1, 16, 65, 300}) {
+    SCOPED_TRACE(output_length);
+    std::string outputs = "previous contents";
+    ASSERT_THAT((*prf)->ComputeBatch(inputs, output_length, &outputs), IsOk());
+    ASSERT_THAT(outputs.size(), Eq(inputs.size() * output_length));
+    for (int i = 0; i < inputs.size(); ++i) {
+      util::StatusOr<std::string> output =
+          (*prf)->Compute(inputs[i], output_length);
+      ASSERT_THAT(output, IsOk());
+      EXPECT_THAT(outputs.substr(i * output_length, output_length),
+                  Eq(*output));
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(HkdfPrfHashTests, HkdfPrfHashTest,
+                         Values(SHA1, SHA256, SHA512));
+
+TEST(HkdfPrfTest, MaxOutputLength) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  util::StatusOr<std::unique_ptr<Prf>> prf = HkdfPrf::New(
+      SHA256, util::SecretDataFromStringView("key0123456"), "salt");
+  ASSERT_THAT(prf, IsOk());
+  const int max_output_length = 255 * (256 / 8);
+  EXPECT_THAT((*prf)->Compute("input", max_output_length), IsOk());
+  EXPECT_THAT((*prf)->Compute("input", max_output_length + 1).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  std::string outputs;
+  EXPECT_THAT((*prf)->ComputeBatch({"input"}, max_output_length + 1, &outputs),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(HkdfPrfTest, InvalidParameters) {
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+  EXPECT_THAT(
+      HkdfPrf::New(SHA256, util::SecretDataFromStringView("key012345"), "salt")
+          .status(),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(
+      HkdfPrf::New(SHA384, util::SecretDataFromStringView("key0123456"), "salt")
+          .status(),
+      StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(HkdfPrfTest, FailsInFipsMode) {
+  if (!IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Only supported in FIPS-only mode";
+  }
+  EXPECT_THAT(HkdfPrf::New(SHA256,
+                           util::SecretDataFromStringView("key0123456"), "salt")
+                  .status(),
+              Not(IsOk()));
+}
+
+}  // namespace
+}  // namespace subtle
+}  // namespace tink
+}  // namespace crypto
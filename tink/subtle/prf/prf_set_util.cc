@@ -15,13 +15,18 @@
 ////////////////////////////////////////////////////////////////////////////////
 #include "tink/subtle/prf/prf_set_util.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "tink/mac.h"
 #include "tink/subtle/mac/stateful_mac.h"
 #include "tink/util/input_stream_util.h"
 #include "tink/util/status.h"
@@ -32,6 +37,17 @@ namespace tink {
 namespace subtle {
 namespace {
 
+util::Status CheckOutputLength(size_t max_output_length,
+                               size_t output_length) {
+  if (max_output_length < output_length) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("PRF only supports outputs up to ", max_output_length,
+                     " bytes, but ", output_length, " bytes were requested"));
+  }
+  return util::OkStatus();
+}
+
 class PrfFromStreamingPrf : public Prf {
  public:
   explicit PrfFromStreamingPrf(std::unique_ptr<StreamingPrf> streaming_prf)
@@ -72,11 +88,9 @@ class PrfFromStatefulMacFactory : public Prf {
       return output_result.status();
     }
     std::string output = std::move(output_result.value());
-    if (output.size() < output_length) {
-      return util::Status(
-          absl::StatusCode::kInvalidArgument,
-          absl::StrCat("PRF only supports outputs up to ", output.size(),
-                       " bytes, but ", output_length, " bytes were requested"));
+    status = CheckOutputLength(output.size(), output_length);
+    if (!status.ok()) {
+      return status;
     }
     return output.substr(0, output_length);
   }
@@ -85,6 +99,49 @@ class PrfFromStatefulMacFactory : public Prf {
   std::unique_ptr<StatefulMacFactory> stateful_mac_factory_;
 };
 
+class PrfFromMac : public Prf {
+ public:
+  explicit PrfFromMac(std::unique_ptr<Mac> mac) : mac_(std::move(mac)) {}
+
+  util::StatusOr<std::string> Compute(absl::string_view input,
+                                      size_t output_length) const override {
+    util::StatusOr<std::string> output = mac_->ComputeMac(input);
+    if (!output.ok()) {
+      return output.status();
+    }
+    util::Status status = CheckOutputLength(output->size(), output_length);
+    if (!status.ok()) {
+      return status;
+    }
+    output->resize(output_length);
+    return output;
+  }
+
+  util::Status ComputeBatch(absl::Span<const absl::string_view> inputs,
+                            size_t output_length,
+                            std::string* outputs) const override {
+    std::string mac_values;
+    std::vector<int64_t> offsets;
+    util::Status status = mac_->ComputeMacBatch(inputs, &mac_values, &offsets);
+    if (!status.ok()) {
+      return status;
+    }
+    outputs->clear();
+    outputs->reserve(inputs.size() * output_length);
+    for (int64_t i = 0; i < inputs.size(); ++i) {
+      status = CheckOutputLength(offsets[i + 1] - offsets[i], output_length);
+      if (!status.ok()) {
+        return status;
+      }
+      outputs->append(mac_values, offsets[i], output_length);
+    }
+    return util::OkStatus();
+  }
+
+ private:
+  std::unique_ptr<Mac> mac_;
+};
+
 }  // namespace
 
 std::unique_ptr<Prf> CreatePrfFromStreamingPrf(
@@ -98,6 +155,10 @@ std::unique_ptr<Prf> CreatePrfFromStatefulMacFactory(
       std::move(stateful_mac_factory));
 }
 
+std::unique_ptr<Prf> CreatePrfFromMac(std::unique_ptr<Mac> mac) {
+  return absl::make_unique<PrfFromMac>(std::move(mac));
+}
+
 }  // namespace subtle
 }  // namespace tink
 }  // namespace crypto
@@ -18,6 +18,7 @@
 
 #include <memory>
 
+#include "tink/mac.h"
 #include "tink/prf/prf_set.h"
 #include "tink/subtle/mac/stateful_mac.h"
 #include "tink/subtle/prf/streaming_prf.h"
@@ -35,6 +36,12 @@ std::unique_ptr<Prf> CreatePrfFromStreamingPrf(
 // do not produce output indistinguishable from random numbers.
 std::unique_ptr<Prf> CreatePrfFromStatefulMacFactory(
     std::unique_ptr<StatefulMacFactory> mac_factory);
+// Creates a Prf from a Mac, taking ownership of the Mac. The Prf supports
+// outputs up to the size of the MAC tags, and computes batches with
+// Mac::ComputeMacBatch. The same restrictions as for
+// CreatePrfFromStatefulMacFactory apply: 'mac' must be a Prf, like HMAC and
+// CMAC.
+std::unique_ptr<Prf> CreatePrfFromMac(std::unique_ptr<Mac> mac);
 
 }  // namespace subtle
 }  // namespace tink
@@ -20,13 +20,16 @@
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "tink/input_stream.h"
+#include "tink/mac.h"
 #include "tink/subtle/prf/streaming_prf.h"
 #include "tink/util/istream_input_stream.h"
 #include "tink/util/status.h"
@@ -38,6 +41,7 @@ namespace subtle {
 namespace {
 
 using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
 using ::testing::_;
 using ::testing::AnyNumber;
 using ::testing::DefaultValue;
@@ -182,6 +186,48 @@ TEST_F(PrfFromStreamingPrfTest, ComputeTooMuch) {
       << "Output should not be okay, too much output requested";
 }
 
+// Mac whose tag for 'data' is "tag(data)".
+class FakeMac : public Mac {
+ public:
+  util::StatusOr<std::string> ComputeMac(
+      absl::string_view data) const override {
+    return absl::StrCat("tag(", data, ")");
+  }
+
+  util::Status VerifyMac(absl::string_view mac_value,
+                         absl::string_view data) const override {
+    return util::Status(absl::StatusCode::kUnimplemented, "Not implemented");
+  }
+};
+
+TEST(PrfFromMacTest, Compute) {
+  std::unique_ptr<Prf> prf = CreatePrfFromMac(absl::make_unique<FakeMac>());
+  util::StatusOr<std::string> output = prf->Compute("input", 8);
+  ASSERT_THAT(output, IsOk());
+  EXPECT_THAT(*output, StrEq("tag(inpu"));
+  output = prf->Compute("input", 10);
+  ASSERT_THAT(output, IsOk());
+  EXPECT_THAT(*output, StrEq("tag(input)"));
+}
+
+TEST(PrfFromMacTest, ComputeTooMuchOutputRequested) {
+  std::unique_ptr<Prf> prf = CreatePrfFromMac(absl::make_unique<FakeMac>());
+  EXPECT_THAT(prf->Compute("input", 11).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(PrfFromMacTest, ComputeBatch) {
+  std::unique_ptr<Prf> prf = CreatePrfFromMac(absl::make_unique<FakeMac>());
+  std::vector<absl::string_view> inputs = {"a", "bc", ""};
+  std::string outputs = "previous contents";
+  ASSERT_THAT(prf->ComputeBatch(inputs, 5, &outputs), IsOk());
+  EXPECT_THAT(outputs, StrEq("tag(atag(btag()"));
+  ASSERT_THAT(prf->ComputeBatch({}, 5, &outputs), IsOk());
+  EXPECT_THAT(outputs, StrEq(""));
+  EXPECT_THAT(prf->ComputeBatch(inputs, 6, &outputs),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 }  // namespace
 }  // namespace subtle
 }  // namespace tink
@@ -16,13 +16,25 @@
 
 #include "tink/subtle/random.h"
 
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
+#include "openssl/crypto.h"
 #include "openssl/rand.h"
+#include "tink/internal/fips_utils.h"
 #include "tink/subtle/subtle_util.h"
 #include "tink/util/status.h"
 
@@ -41,6 +53,95 @@ UintType GetRandomUint() {
   return result;
 }
 
+// Set by Random::EnableNonceBuffering(); GetRandomNonceBytes() only uses
+// the per-thread buffer while this is true.
+std::atomic<bool> nonce_buffering_enabled{false};
+
+#if !defined(_WIN32)
+// Requests larger than this are not served from the buffer; they are rare
+// and already amortize the cost of RAND_bytes.
+constexpr size_t kMaxBufferedRequestSize = 64;
+
+// Reseed policy of the per-thread buffer: every reseed draws
+// kNonceBufferSize bytes from RAND_bytes, and bytes that were drawn more than
+// kMaxNonceBufferAge ago are discarded instead of handed out.
+constexpr size_t kNonceBufferSize = 4096;
+constexpr std::chrono::steady_clock::duration kMaxNonceBufferAge =
+    std::chrono::seconds(1);
+
+// Contents of a per-thread buffer. Kept in its own anonymous mapping, so that
+// it can be marked MADV_WIPEONFORK: the child of a fork() then sees the
+// mapping zeroed, i.e. with no bytes available.
+struct NonceBufferState {
+  uint8_t bytes[kNonceBufferSize];
+  size_t available;
+  // Process that filled `bytes`; checked only if MADV_WIPEONFORK failed.
+  pid_t pid;
+  std::chrono::steady_clock::duration filled_at;
+};
+
+// Per-thread store of random bytes for GetRandomNonceBytes. Bytes are handed
+// out from the back of the buffer, and each byte is handed out at most once.
+class NonceBuffer {
+ public:
+  NonceBuffer() {
+    void* mapping = mmap(nullptr, sizeof(NonceBufferState),
+                         PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                         /*fd=*/-1, /*offset=*/0);
+    if (mapping == MAP_FAILED) {
+      return;
+    }
+    // Anonymous mappings are zero-filled, so the buffer starts out empty.
+    state_ = static_cast<NonceBufferState*>(mapping);
+#if defined(MADV_WIPEONFORK)
+    wiped_on_fork_ =
+        madvise(mapping, sizeof(NonceBufferState), MADV_WIPEONFORK) == 0;
+#endif
+  }
+
+  NonceBuffer(const NonceBuffer&) = delete;
+  NonceBuffer& operator=(const NonceBuffer&) = delete;
+
+  ~NonceBuffer() {
+    if (state_ == nullptr) {
+      return;
+    }
+    OPENSSL_cleanse(state_, sizeof(NonceBufferState));
+    munmap(state_, sizeof(NonceBufferState));
+  }
+
+  util::Status Fill(absl::Span<char> out) {
+    if (state_ == nullptr) {
+      return Random::GetRandomBytes(out);
+    }
+    std::chrono::steady_clock::duration now =
+        std::chrono::steady_clock::now().time_since_epoch();
+    if (now - state_->filled_at > kMaxNonceBufferAge ||
+        (!wiped_on_fork_ && state_->pid != getpid())) {
+      state_->available = 0;
+    }
+    if (out.size() > state_->available) {
+      if (RAND_bytes(state_->bytes, kNonceBufferSize) <= 0) {
+        state_->available = 0;
+        return util::Status(absl::StatusCode::kInternal,
+                            absl::StrCat("RAND_bytes failed to generate ",
+                                         kNonceBufferSize, " bytes"));
+      }
+      state_->available = kNonceBufferSize;
+      state_->pid = getpid();
+      state_->filled_at = now;
+    }
+    state_->available -= out.size();
+    std::memcpy(out.data(), state_->bytes + state_->available, out.size());
+    return util::OkStatus();
+  }
+
+ private:
+  NonceBufferState* state_ = nullptr;
+  bool wiped_on_fork_ = false;
+};
+#endif
+
 }  // namespace
 
 // BoringSSL documentation says that it always returns 1; while
@@ -73,6 +174,31 @@ std::string Random::GetRandomBytes(size_t length) {
   return buffer;
 }
 
+util::Status Random::GetRandomNonceBytes(absl::Span<char> buffer) {
+#if defined(_WIN32)
+  return GetRandomBytes(buffer);
+#else
+  if (!nonce_buffering_enabled.load(std::memory_order_relaxed) ||
+      buffer.size() > kMaxBufferedRequestSize ||
+      internal::IsFipsModeEnabled()) {
+    return GetRandomBytes(buffer);
+  }
+  thread_local NonceBuffer nonce_buffer;
+  return nonce_buffer.Fill(buffer);
+#endif
+}
+
+std::string Random::GetRandomNonceBytes(size_t length) {
+  std::string buffer;
+  ResizeStringUninitialized(&buffer, length);
+  GetRandomNonceBytes(absl::MakeSpan(buffer)).IgnoreError();
+  return buffer;
+}
+
+void Random::EnableNonceBuffering(bool enable) {
+  nonce_buffering_enabled.store(enable, std::memory_order_relaxed);
+}
+
 uint32_t Random::GetRandomUInt32() { return GetRandomUint<uint32_t>(); }
 uint16_t Random::GetRandomUInt16() { return GetRandomUint<uint16_t>(); }
 uint8_t Random::GetRandomUInt8() { return GetRandomUint<uint8_t>(); }
@@ -17,9 +17,12 @@
 #ifndef TINK_SUBTLE_RANDOM_H_
 #define TINK_SUBTLE_RANDOM_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 
+#include "absl/types/span.h"
 #include "tink/util/secret_data.h"
 #include "tink/util/status.h"
 
@@ -33,6 +36,28 @@ class Random {
   static util::Status GetRandomBytes(absl::Span<char> buffer);
   // Returns a random string of desired length.
   static std::string GetRandomBytes(size_t length);
+  // Fills the given `buffer` with random bytes for public values, such as
+  // nonces, IVs and nonce prefixes. Must not be used for keys or other
+  // secrets.
+  //
+  // Unless nonce buffering is enabled with EnableNonceBuffering(), this is
+  // the same as GetRandomBytes(). With buffering enabled, requests of up to
+  // 64 bytes are served from a per-thread buffer, so that drawing a nonce
+  // does not need a call to RAND_bytes every time. The buffer is reseeded
+  // with a fresh 4096-byte draw from RAND_bytes once it is used up, and its
+  // remaining bytes are discarded once they are older than one second. On
+  // fork(), the child never reuses bytes buffered by the parent: the buffer
+  // lives in memory marked MADV_WIPEONFORK where the kernel supports it, and
+  // is otherwise tagged with the pid of the process that filled it. Larger
+  // requests, all requests when FIPS restrictions are enabled, and all
+  // requests on Windows go directly to RAND_bytes.
+  static util::Status GetRandomNonceBytes(absl::Span<char> buffer);
+  // Returns a random string of desired length, drawn like
+  // GetRandomNonceBytes.
+  static std::string GetRandomNonceBytes(size_t length);
+  // Enables or disables the per-thread buffer of GetRandomNonceBytes for
+  // the whole process. Buffering is disabled by default.
+  static void EnableNonceBuffering(bool enable);
   static uint32_t GetRandomUInt32();
   static uint16_t GetRandomUInt16();
   static uint8_t GetRandomUInt8();
@@ -16,8 +16,14 @@
 
 #include "tink/subtle/random.h"
 
+#if !defined(_WIN32)
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #include <set>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <vector>
 
 #include "gmock/gmock.h"
@@ -62,6 +68,88 @@ TEST(RandomTest, MultipleGeneratedRandomStringAreUnique) {
   EXPECT_THAT(random_strings, SizeIs(kNumRandomItems));
 }
 
+// Runs the nonce tests with the per-thread buffer of GetRandomNonceBytes
+// disabled and enabled.
+class RandomNonceTest : public testing::TestWithParam<bool> {
+ protected:
+  void SetUp() override { Random::EnableNonceBuffering(GetParam()); }
+  void TearDown() override { Random::EnableNonceBuffering(false); }
+};
+
+INSTANTIATE_TEST_SUITE_P(RandomNonceTests, RandomNonceTest, testing::Bool());
+
+TEST_P(RandomNonceTest, MultipleNonceBytesAreUnique) {
+  // Enough draws to refill the per-thread buffer several times.
+  constexpr int kNumRandomItems = 2000;
+  absl::flat_hash_set<std::string> random_strings;
+  for (int i = 0; i < kNumRandomItems; i++) {
+    std::string s(12, '\0');
+    EXPECT_THAT(Random::GetRandomNonceBytes(absl::MakeSpan(s)), IsOk());
+    random_strings.insert(s);
+  }
+  EXPECT_THAT(random_strings, SizeIs(kNumRandomItems));
+}
+
+TEST_P(RandomNonceTest, NonceBytesOfAnySize) {
+  for (int size : {0, 1, 7, 12, 24, 64, 65, 1000, 5000}) {
+    SCOPED_TRACE(size);
+    std::string first = Random::GetRandomNonceBytes(size);
+    std::string second = Random::GetRandomNonceBytes(size);
+    EXPECT_THAT(first, SizeIs(size));
+    EXPECT_THAT(second, SizeIs(size));
+    if (size >= 7) {
+      EXPECT_NE(first, second);
+    }
+  }
+}
+
+TEST_P(RandomNonceTest, NonceBytesAreUniqueAcrossThreads) {
+  constexpr int kNumThreads = 4;
+  constexpr int kNumRandomItems = 500;
+  std::vector<std::vector<std::string>> nonces(kNumThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kNumThreads; ++t) {
+    threads.emplace_back([&nonces, t]() {
+      for (int i = 0; i < kNumRandomItems; i++) {
+        nonces[t].push_back(Random::GetRandomNonceBytes(12));
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  absl::flat_hash_set<std::string> random_strings;
+  for (const std::vector<std::string>& thread_nonces : nonces) {
+    random_strings.insert(thread_nonces.begin(), thread_nonces.end());
+  }
+  EXPECT_THAT(random_strings, SizeIs(kNumThreads * kNumRandomItems));
+}
+
+#if !defined(_WIN32)
+TEST_P(RandomNonceTest, ForkedChildDoesNotRepeatParentNonces) {
+  // Fill the buffer of this thread before forking.
+  std::string first = Random::GetRandomNonceBytes(16);
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+  pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    std::string child_nonce = Random::GetRandomNonceBytes(16);
+    ssize_t written = write(fds[1], child_nonce.data(), child_nonce.size());
+    _exit(written == child_nonce.size() ? 0 : 1);
+  }
+  close(fds[1]);
+  std::string parent_nonce = Random::GetRandomNonceBytes(16);
+  std::string child_nonce(16, '\0');
+  EXPECT_EQ(read(fds[0], &child_nonce[0], child_nonce.size()), 16);
+  close(fds[0]);
+  int status;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  EXPECT_NE(child_nonce, parent_nonce);
+  EXPECT_NE(child_nonce, first);
+}
+#endif
 
 TEST(RandomTest, MultipleGeneratedSecretDataAreUnique) {
   constexpr int kNumRandomItems = 32;
@@ -91,6 +179,23 @@ TEST(RandomTest, KeyBytesRandomGenerationIsUniform) {
   }
 }
 
+TEST_P(RandomNonceTest, NonceBytesRandomGenerationIsUniform) {
+  constexpr int kNonceLengthInBytes = 12;
+  std::vector<int> bit_counts(8 * kNonceLengthInBytes);
+  for (int i = 0; i < kTests; ++i) {
+    std::string random = Random::GetRandomNonceBytes(kNonceLengthInBytes);
+    for (int bit = 0; bit < 8 * kNonceLengthInBytes; ++bit) {
+      if (random[bit / 8] & (1 << (bit % 8))) {
+        ++bit_counts[bit];
+      }
+    }
+  }
+  for (int i = 0; i < 8 * kNonceLengthInBytes; ++i) {
+    EXPECT_THAT(bit_counts[i], Gt(kTests * 0.4)) << i;
+    EXPECT_THAT(bit_counts[i], Lt(kTests * 0.6)) << i;
+  }
+}
+
 TEST(RandomTest, UInt8RandomGenerationIsUniform) {
   const int kNumBits = 8;
   std::vector<int> bit_counts(kNumBits);
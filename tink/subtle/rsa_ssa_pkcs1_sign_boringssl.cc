@@ -31,7 +31,6 @@
 #include "tink/internal/md_util.h"
 #include "tink/internal/rsa_util.h"
 #include "tink/internal/ssl_unique_ptr.h"
-#include "tink/internal/util.h"
 #include "tink/subtle/subtle_util.h"
 #include "tink/util/statusor.h"
 
@@ -85,8 +84,13 @@ util::StatusOr<std::unique_ptr<PublicKeySign>> RsaSsaPkcs1SignBoringSsl::New(
 
 util::StatusOr<std::string> RsaSsaPkcs1SignBoringSsl::Sign(
     absl::string_view data) const {
-  data = internal::EnsureStringNonNull(data);
-  util::StatusOr<std::string> digest = internal::ComputeHash(data, *sig_hash_);
+  return SignFromParts({data});
+}
+
+util::StatusOr<std::string> RsaSsaPkcs1SignBoringSsl::SignFromParts(
+    absl::Span<const absl::string_view> data_parts) const {
+  util::StatusOr<std::string> digest =
+      internal::ComputeHashFromParts(data_parts, *sig_hash_);
   if (!digest.ok()) {
     return digest.status();
   }
@@ -22,6 +22,7 @@
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/ec.h"
 #include "openssl/rsa.h"
 #include "tink/internal/fips_utils.h"
@@ -49,6 +50,10 @@ class RsaSsaPkcs1SignBoringSsl : public PublicKeySign {
   crypto::tink::util::StatusOr<std::string> Sign(
       absl::string_view data) const override;
 
+  // Hashes the parts one after the other, without concatenating them.
+  crypto::tink::util::StatusOr<std::string> SignFromParts(
+      absl::Span<const absl::string_view> data_parts) const override;
+
   ~RsaSsaPkcs1SignBoringSsl() override = default;
 
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
@@ -28,7 +28,6 @@
 #include "tink/internal/md_util.h"
 #include "tink/internal/rsa_util.h"
 #include "tink/internal/ssl_unique_ptr.h"
-#include "tink/internal/util.h"
 #include "tink/subtle/common_enums.h"
 #include "tink/util/errors.h"
 #include "tink/util/statusor.h"
@@ -73,11 +72,14 @@ RsaSsaPkcs1VerifyBoringSsl::New(const internal::RsaPublicKey& pub_key,
 
 util::Status RsaSsaPkcs1VerifyBoringSsl::Verify(absl::string_view signature,
                                                 absl::string_view data) const {
-  // BoringSSL expects a non-null pointer for data,
-  // regardless of whether the size is 0.
-  data = internal::EnsureStringNonNull(data);
+  return VerifyFromParts(signature, {data});
+}
 
-  util::StatusOr<std::string> digest = internal::ComputeHash(data, *sig_hash_);
+util::Status RsaSsaPkcs1VerifyBoringSsl::VerifyFromParts(
+    absl::string_view signature,
+    absl::Span<const absl::string_view> data_parts) const {
+  util::StatusOr<std::string> digest =
+      internal::ComputeHashFromParts(data_parts, *sig_hash_);
   if (!digest.ok()) {
     return digest.status();
   }
@@ -21,6 +21,7 @@
 #include <utility>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "openssl/evp.h"
 #include "openssl/rsa.h"
 #include "tink/internal/fips_utils.h"
@@ -49,6 +50,11 @@ class RsaSsaPkcs1VerifyBoringSsl : public PublicKeyVerify {
   crypto::tink::util::Status Verify(absl::string_view signature,
                                     absl::string_view data) const override;
 
+  // Hashes the parts one after the other, without concatenating them.
+  crypto::tink::util::Status VerifyFromParts(
+      absl::string_view signature,
+      absl::Span<const absl::string_view> data_parts) const override;
+
   ~RsaSsaPkcs1VerifyBoringSsl() override = default;
 
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
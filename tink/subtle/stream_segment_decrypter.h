@@ -18,8 +18,12 @@
 #define TINK_SUBTLE_STREAM_SEGMENT_DECRYPTER_H_
 
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/span.h"
 #include "tink/util/status.h"
 
 namespace crypto {
@@ -50,6 +54,43 @@ class StreamSegmentDecrypter {
       bool is_last_segment,
       std::vector<uint8_t>* plaintext_buffer) = 0;
 
+  // Decrypts 'ciphertext' as a segment like DecryptSegment(), but writes the
+  // plaintext to 'plaintext', which must be exactly
+  //   get_ciphertext_segment_size() - get_plaintext_segment_size()
+  // bytes shorter than 'ciphertext'. This lets a stream decrypt directly from
+  // the buffer of its source into the buffer of its caller. On failure, the
+  // contents of 'plaintext' are unspecified. Once Init() has succeeded, this
+  // may be called concurrently for different segments.
+  // The default implementation copies through DecryptSegment(), one call at
+  // a time; decrypters override it to decrypt in place and in parallel.
+  virtual util::Status DecryptSegmentInto(absl::Span<const uint8_t> ciphertext,
+                                          int64_t segment_number,
+                                          bool is_last_segment,
+                                          absl::Span<uint8_t> plaintext) const {
+    if (plaintext.size() + get_ciphertext_segment_size() -
+            get_plaintext_segment_size() !=
+        ciphertext.size()) {
+      return util::Status(absl::StatusCode::kInvalidArgument,
+                          "wrong plaintext size");
+    }
+    // DecryptSegment() is not const, and may not be safe to call concurrently.
+    static absl::Mutex* const decrypt_segment_mutex = new absl::Mutex();
+    absl::MutexLock lock(decrypt_segment_mutex);
+    std::vector<uint8_t> plaintext_buffer;
+    util::Status status =
+        const_cast<StreamSegmentDecrypter*>(this)->DecryptSegment(
+            std::vector<uint8_t>(ciphertext.begin(), ciphertext.end()),
+            segment_number, is_last_segment, &plaintext_buffer);
+    if (!status.ok()) return status;
+    if (plaintext_buffer.size() != plaintext.size()) {
+      return util::Status(absl::StatusCode::kInternal,
+                          "unexpected plaintext size");
+    }
+    std::memcpy(plaintext.data(), plaintext_buffer.data(),
+                plaintext_buffer.size());
+    return util::OkStatus();
+  }
+
   // Initializes this decrypter, using the information from 'header',
   // which must be of size exactly get_header_size().
   virtual util::Status Init(const std::vector<uint8_t>& header) = 0;
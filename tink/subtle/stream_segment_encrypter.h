@@ -18,8 +18,11 @@
 #define TINK_SUBTLE_STREAM_SEGMENT_ENCRYPTER_H_
 
 #include <cstdint>
+#include <cstring>
 #include <vector>
 
+#include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "tink/util/status.h"
 
 namespace crypto {
@@ -76,6 +79,47 @@ class StreamSegmentEncrypter {
       bool is_last_segment,
       std::vector<uint8_t>* ciphertext_buffer) = 0;
 
+  // Encrypts 'plaintext' as the segment with number 'segment_number' like
+  // EncryptSegmentInto(). Neither uses nor changes the current segment number,
+  // so that, unlike EncryptSegmentInto(), this may be called concurrently for
+  // different segments. Encrypters that do not support this return an
+  // UNIMPLEMENTED error.
+  virtual util::Status EncryptSegmentAt(absl::Span<const uint8_t> plaintext,
+                                        int64_t segment_number,
+                                        bool is_last_segment,
+                                        absl::Span<uint8_t> ciphertext) const {
+    return util::Status(absl::StatusCode::kUnimplemented,
+                        "EncryptSegmentAt is not supported");
+  }
+
+  // Encrypts 'plaintext' as a segment like EncryptSegment(), but writes the
+  // ciphertext to 'ciphertext', which must be exactly
+  //   get_ciphertext_segment_size() - get_plaintext_segment_size()
+  // bytes longer than 'plaintext'. This lets a stream encrypt directly into
+  // the buffer of its destination. The default implementation copies through
+  // EncryptSegment().
+  virtual util::Status EncryptSegmentInto(absl::Span<const uint8_t> plaintext,
+                                          bool is_last_segment,
+                                          absl::Span<uint8_t> ciphertext) {
+    if (ciphertext.size() != plaintext.size() + get_ciphertext_segment_size() -
+                                 get_plaintext_segment_size()) {
+      return util::Status(absl::StatusCode::kInvalidArgument,
+                          "wrong ciphertext size");
+    }
+    std::vector<uint8_t> ciphertext_buffer;
+    util::Status status = EncryptSegment(
+        std::vector<uint8_t>(plaintext.begin(), plaintext.end()),
+        is_last_segment, &ciphertext_buffer);
+    if (!status.ok()) return status;
+    if (ciphertext_buffer.size() != ciphertext.size()) {
+      return util::Status(absl::StatusCode::kInternal,
+                          "unexpected ciphertext size");
+    }
+    std::memcpy(ciphertext.data(), ciphertext_buffer.data(),
+                ciphertext_buffer.size());
+    return util::OkStatus();
+  }
+
   // Returns the header of the ciphertext stream.
   virtual const std::vector<uint8_t>& get_header() const = 0;
 
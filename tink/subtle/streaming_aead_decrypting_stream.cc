@@ -24,6 +24,7 @@
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "tink/input_stream.h"
 #include "tink/subtle/stream_segment_decrypter.h"
 #include "tink/util/status.h"
@@ -131,25 +132,7 @@ StatusOr<int> StreamingAeadDecryptingStream::Next(const void** data) {
     if (!status_.ok()) return status_;
     is_initialized_ = true;
     count_backedup_ = 0;
-    status_ = ReadFromStream(ct_source_.get(), ct_buffer_.size(), &ct_buffer_);
-    if (!status_.ok() && (status_.code() != absl::StatusCode::kOutOfRange)) {
-      return status_;
-    }
-    read_last_segment_ = (status_.code() == absl::StatusCode::kOutOfRange);
-    status_ = segment_decrypter_->DecryptSegment(
-        ct_buffer_,
-        /* segment_number = */ segment_number_,
-        /* is_last_segment = */ read_last_segment_,
-        &pt_buffer_);
-    if (!status_.ok() && !read_last_segment_) {
-      // Try decrypting as the last segment, if haven't tried yet.
-      read_last_segment_ = true;
-      status_ = segment_decrypter_->DecryptSegment(
-          ct_buffer_,
-          /* segment_number = */ segment_number_,
-          /* is_last_segment = */ read_last_segment_,
-          &pt_buffer_);
-    }
+    status_ = ReadAndDecryptSegment(ct_buffer_.size());
     if (!status_.ok()) return status_;
     *data = pt_buffer_.data();
     position_ = pt_buffer_.size();
@@ -173,31 +156,80 @@ StatusOr<int> StreamingAeadDecryptingStream::Next(const void** data) {
     return status_;
   }
   segment_number_++;
-  ct_buffer_.resize(segment_decrypter_->get_ciphertext_segment_size());
-  status_ = ReadFromStream(ct_source_.get(), ct_buffer_.size(), &ct_buffer_);
-  if (!status_.ok() && (status_.code() != absl::StatusCode::kOutOfRange)) {
-    return status_;
+  status_ = ReadAndDecryptSegment(
+      segment_decrypter_->get_ciphertext_segment_size());
+  if (!status_.ok()) return status_;
+  *data = pt_buffer_.data();
+  pt_buffer_offset_ = 0;
+  position_ += pt_buffer_.size();
+  return pt_buffer_.size();
+}
+
+Status StreamingAeadDecryptingStream::ReadAndDecryptSegment(int ct_size) {
+  const void* buffer;
+  auto next_result = ct_source_->Next(&buffer);
+  if (!next_result.ok() &&
+      next_result.status().code() != absl::StatusCode::kOutOfRange) {
+    return next_result.status();
+  }
+  if (next_result.ok() && next_result.value() >= ct_size) {
+    // The whole segment is available, so we decrypt it in place. Since
+    // ct_source_ is not at its end yet, we first try decrypting it as
+    // a not-last segment.
+    int read_bytes = next_result.value();
+    absl::Span<const uint8_t> ciphertext(static_cast<const uint8_t*>(buffer),
+                                         ct_size);
+    int overhead = segment_decrypter_->get_ciphertext_segment_size() -
+                   segment_decrypter_->get_plaintext_segment_size();
+    pt_buffer_.resize(std::max(ct_size - overhead, 0));
+    read_last_segment_ = false;
+    Status status = segment_decrypter_->DecryptSegmentInto(
+        ciphertext,
+        /* segment_number = */ segment_number_,
+        /* is_last_segment = */ read_last_segment_,
+        absl::MakeSpan(pt_buffer_));
+    if (!status.ok()) {
+      // Try decrypting as the last segment.
+      read_last_segment_ = true;
+      status = segment_decrypter_->DecryptSegmentInto(
+          ciphertext,
+          /* segment_number = */ segment_number_,
+          /* is_last_segment = */ read_last_segment_,
+          absl::MakeSpan(pt_buffer_));
+    }
+    if (read_bytes > ct_size) ct_source_->BackUp(read_bytes - ct_size);
+    return status;
   }
-  read_last_segment_ = (status_.code() == absl::StatusCode::kOutOfRange);
-  status_ = segment_decrypter_->DecryptSegment(
+
+  // The segment is split across buffers of ct_source_, or ct_source_ is at
+  // its end: collect the segment in ct_buffer_.
+  Status status;
+  if (next_result.ok()) {
+    ct_source_->BackUp(next_result.value());
+    status = ReadFromStream(ct_source_.get(), ct_size, &ct_buffer_);
+  } else {
+    ct_buffer_.clear();
+    status = next_result.status();
+  }
+  if (!status.ok() && (status.code() != absl::StatusCode::kOutOfRange)) {
+    return status;
+  }
+  read_last_segment_ = (status.code() == absl::StatusCode::kOutOfRange);
+  status = segment_decrypter_->DecryptSegment(
       ct_buffer_,
       /* segment_number = */ segment_number_,
       /* is_last_segment = */ read_last_segment_,
       &pt_buffer_);
-  if (!status_.ok() && !read_last_segment_) {
+  if (!status.ok() && !read_last_segment_) {
     // Try decrypting as the last segment, if haven't tried yet.
     read_last_segment_ = true;
-    status_ = segment_decrypter_->DecryptSegment(
+    status = segment_decrypter_->DecryptSegment(
         ct_buffer_,
         /* segment_number = */ segment_number_,
         /* is_last_segment = */ read_last_segment_,
         &pt_buffer_);
   }
-  if (!status_.ok()) return status_;
-  *data = pt_buffer_.data();
-  pt_buffer_offset_ = 0;
-  position_ += pt_buffer_.size();
-  return pt_buffer_.size();
+  return status;
 }
 
 void StreamingAeadDecryptingStream::BackUp(int count) {
@@ -49,6 +49,14 @@ class StreamingAeadDecryptingStream : public InputStream {
 
  private:
   StreamingAeadDecryptingStream() {}
+
+  // Reads the next ciphertext segment of (at most) 'ct_size' bytes from
+  // ct_source_, decrypts it as segment segment_number_ into pt_buffer_,
+  // and sets read_last_segment_ if it is the last segment. When ct_source_
+  // returns the whole segment in one buffer, the segment is decrypted
+  // directly from that buffer rather than copied to ct_buffer_ first.
+  crypto::tink::util::Status ReadAndDecryptSegment(int ct_size);
+
   std::unique_ptr<StreamSegmentDecrypter> segment_decrypter_;
   std::unique_ptr<crypto::tink::InputStream> ct_source_;
   std::vector<uint8_t> ct_buffer_;  // ciphertext buffer
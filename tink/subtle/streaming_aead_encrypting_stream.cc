@@ -24,6 +24,7 @@
 
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "tink/output_stream.h"
 #include "tink/subtle/stream_segment_encrypter.h"
 #include "tink/util/statusor.h"
@@ -64,6 +65,43 @@ util::Status WriteToStream(const std::vector<uint8_t>& contents,
   return util::OkStatus();
 }
 
+// Encrypts 'plaintext' as the next segment using 'segment_encrypter', and
+// writes the resulting ciphertext to 'output_stream'.
+// If 'output_stream' offers a buffer large enough for the whole ciphertext
+// segment, the segment is encrypted directly into that buffer; otherwise
+// it is encrypted into 'ct_buffer' and copied to 'output_stream'.
+util::Status EncryptAndWriteSegment(StreamSegmentEncrypter* segment_encrypter,
+                                    const std::vector<uint8_t>& plaintext,
+                                    bool is_last_segment,
+                                    std::vector<uint8_t>* ct_buffer,
+                                    OutputStream* output_stream) {
+  int ct_size = plaintext.size() +
+                segment_encrypter->get_ciphertext_segment_size() -
+                segment_encrypter->get_plaintext_segment_size();
+  void* buffer;
+  auto next_result = output_stream->Next(&buffer);
+  if (!next_result.ok()) return next_result.status();
+  int available_space = next_result.value();
+  if (available_space >= ct_size) {
+    util::Status status = segment_encrypter->EncryptSegmentInto(
+        plaintext, is_last_segment,
+        absl::MakeSpan(static_cast<uint8_t*>(buffer), ct_size));
+    if (!status.ok()) {
+      output_stream->BackUp(available_space);
+      return status;
+    }
+    if (available_space > ct_size) {
+      output_stream->BackUp(available_space - ct_size);
+    }
+    return util::OkStatus();
+  }
+  output_stream->BackUp(available_space);
+  util::Status status =
+      segment_encrypter->EncryptSegment(plaintext, is_last_segment, ct_buffer);
+  if (!status.ok()) return status;
+  return WriteToStream(*ct_buffer, output_stream);
+}
+
 }  // anonymous namespace
 
 // static
@@ -135,10 +173,9 @@ StatusOr<int> StreamingAeadEncryptingStream::Next(void** data) {
   //
   // Step 1.
   if (!pt_to_encrypt_.empty()) {
-    status_ = segment_encrypter_->EncryptSegment(
-        pt_to_encrypt_, /* is_last_segment = */ false, &ct_buffer_);
-    if (!status_.ok()) return status_;
-    status_ = WriteToStream(ct_buffer_, ct_destination_.get());
+    status_ = EncryptAndWriteSegment(
+        segment_encrypter_.get(), pt_to_encrypt_,
+        /* is_last_segment = */ false, &ct_buffer_, ct_destination_.get());
     if (!status_.ok()) return status_;
   }
   // Step 2.
@@ -177,13 +214,9 @@ Status StreamingAeadEncryptingStream::Close() {
   }
   if (pt_last_segment != &pt_to_encrypt_ && (!pt_to_encrypt_.empty())) {
     // Before writing the last segment we must encrypt pt_to_encrypt_.
-    status_ = segment_encrypter_->EncryptSegment(
-        pt_to_encrypt_, /* is_last_segment = */ false, &ct_buffer_);
-    if (!status_.ok()) {
-      ct_destination_->Close().IgnoreError();
-      return status_;
-    }
-    status_ = WriteToStream(ct_buffer_, ct_destination_.get());
+    status_ = EncryptAndWriteSegment(
+        segment_encrypter_.get(), pt_to_encrypt_,
+        /* is_last_segment = */ false, &ct_buffer_, ct_destination_.get());
     if (!status_.ok()) {
       ct_destination_->Close().IgnoreError();
       return status_;
@@ -191,13 +224,9 @@ Status StreamingAeadEncryptingStream::Close() {
   }
 
   // Encrypt pt_last_segment, write the ciphertext, and close the stream.
-  status_ = segment_encrypter_->EncryptSegment(
-      *pt_last_segment, /* is_last_segment = */ true, &ct_buffer_);
-  if (!status_.ok()) {
-    ct_destination_->Close().IgnoreError();
-    return status_;
-  }
-  status_ = WriteToStream(ct_buffer_, ct_destination_.get());
+  status_ = EncryptAndWriteSegment(
+      segment_encrypter_.get(), *pt_last_segment,
+      /* is_last_segment = */ true, &ct_buffer_, ct_destination_.get());
   if (!status_.ok()) {
     ct_destination_->Close().IgnoreError();
     return status_;
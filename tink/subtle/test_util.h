@@ -17,6 +17,7 @@
 #ifndef TINK_SUBTLE_TEST_UTIL_H_
 #define TINK_SUBTLE_TEST_UTIL_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "absl/status/status.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/input_stream.h"
 #include "tink/output_stream.h"
 #include "tink/subtle/nonce_based_streaming_aead.h"
@@ -107,17 +109,30 @@ class DummyStreamSegmentEncrypter : public StreamSegmentEncrypter {
       bool is_last_segment,
       std::vector<uint8_t>* ciphertext_buffer) override {
     ciphertext_buffer->resize(plaintext.size() + kSegmentTagSize);
-    memcpy(ciphertext_buffer->data(), plaintext.data(), plaintext.size());
-    memcpy(ciphertext_buffer->data() + plaintext.size(),
-           &segment_number_, sizeof(segment_number_));
-    // The last byte of the a ciphertext segment.
-    ciphertext_buffer->back() =
-        is_last_segment ? kLastSegment : kNotLastSegment;
-    generated_output_size_ += ciphertext_buffer->size();
+    util::Status status =
+        EncryptSegmentAt(plaintext, segment_number_, is_last_segment,
+                         absl::MakeSpan(*ciphertext_buffer));
+    if (!status.ok()) return status;
     IncSegmentNumber();
     return util::OkStatus();
   }
 
+  util::Status EncryptSegmentAt(absl::Span<const uint8_t> plaintext,
+                                int64_t segment_number, bool is_last_segment,
+                                absl::Span<uint8_t> ciphertext) const override {
+    if (ciphertext.size() != plaintext.size() + kSegmentTagSize) {
+      return util::Status(absl::StatusCode::kInvalidArgument,
+                          "wrong ciphertext size");
+    }
+    memcpy(ciphertext.data(), plaintext.data(), plaintext.size());
+    memcpy(ciphertext.data() + plaintext.size(),
+           &segment_number, sizeof(segment_number));
+    // The last byte of the a ciphertext segment.
+    ciphertext.back() = is_last_segment ? kLastSegment : kNotLastSegment;
+    generated_output_size_ += ciphertext.size();
+    return util::OkStatus();
+  }
+
   const std::vector<uint8_t>& get_header() const override {
     return header_;
   }
@@ -154,7 +169,7 @@ class DummyStreamSegmentEncrypter : public StreamSegmentEncrypter {
   int pt_segment_size_;
   int ct_offset_;
   int64_t segment_number_;
-  int64_t generated_output_size_;
+  mutable std::atomic<int64_t> generated_output_size_;
 };   // class DummyStreamSegmentEncrypter
 
 // A dummy decrypter that "decrypts" segments encrypted by
@@ -194,6 +209,20 @@ class DummyStreamSegmentDecrypter : public StreamSegmentDecrypter {
       return util::Status(absl::StatusCode::kInvalidArgument,
                           "Ciphertext segment too short");
     }
+    plaintext_buffer->resize(ciphertext.size() -
+                             DummyStreamSegmentEncrypter::kSegmentTagSize);
+    return DummyStreamSegmentDecrypter::DecryptSegmentInto(
+        ciphertext, segment_number, is_last_segment,
+        absl::MakeSpan(*plaintext_buffer));
+  }
+
+  util::Status DecryptSegmentInto(
+      absl::Span<const uint8_t> ciphertext, int64_t segment_number,
+      bool is_last_segment, absl::Span<uint8_t> plaintext) const override {
+    if (ciphertext.size() < DummyStreamSegmentEncrypter::kSegmentTagSize) {
+      return util::Status(absl::StatusCode::kInvalidArgument,
+                          "Ciphertext segment too short");
+    }
     if (ciphertext.back() !=
         (is_last_segment ? DummyStreamSegmentEncrypter::kLastSegment :
          DummyStreamSegmentEncrypter::kNotLastSegment)) {
@@ -208,8 +237,11 @@ class DummyStreamSegmentDecrypter : public StreamSegmentDecrypter {
       return util::Status(absl::StatusCode::kInvalidArgument,
                           "wrong segment number");
     }
-    plaintext_buffer->resize(pt_size);
-    memcpy(plaintext_buffer->data(), ciphertext.data(), pt_size);
+    if (static_cast<int>(plaintext.size()) != pt_size) {
+      return util::Status(absl::StatusCode::kInvalidArgument,
+                          "wrong plaintext size");
+    }
+    memcpy(plaintext.data(), ciphertext.data(), pt_size);
     generated_output_size_ += pt_size;
     return util::OkStatus();
   }
@@ -237,7 +269,7 @@ class DummyStreamSegmentDecrypter : public StreamSegmentDecrypter {
   std::vector<uint8_t> header_;
   int pt_segment_size_;
   int ct_offset_;
-  int64_t generated_output_size_;
+  mutable std::atomic<int64_t> generated_output_size_;
 };   // class DummyStreamSegmentDecrypter
 
 class DummyStreamingAead : public NonceBasedStreamingAead {
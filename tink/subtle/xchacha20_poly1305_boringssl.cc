@@ -30,6 +30,7 @@
 #include "absl/types/span.h"
 #include "tink/aead.h"
 #include "tink/aead/internal/ssl_aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/internal/util.h"
 #include "tink/subtle/random.h"
 #include "tink/subtle/subtle_util.h"
@@ -44,64 +45,151 @@ namespace subtle {
 constexpr int kNonceSizeInBytes = 24;
 constexpr int kTagSizeInBytes = 16;
 
-util::StatusOr<std::unique_ptr<Aead>> XChacha20Poly1305BoringSsl::New(
-    util::SecretData key) {
+util::StatusOr<std::unique_ptr<XChacha20Poly1305BoringSsl>>
+XChacha20Poly1305BoringSsl::Create(util::SecretData key) {
   auto status = internal::CheckFipsCompatibility<XChacha20Poly1305BoringSsl>();
   if (!status.ok()) {
     return status;
   }
+
   util::StatusOr<std::unique_ptr<internal::SslOneShotAead>> aead =
       internal::CreateXchacha20Poly1305OneShotCrypter(key);
   if (!aead.ok()) {
     return aead.status();
   }
-  std::unique_ptr<Aead> aead_impl =
-      absl::WrapUnique(new XChacha20Poly1305BoringSsl(*std::move(aead)));
-  return std::move(aead_impl);
+
+  return {absl::WrapUnique(new XChacha20Poly1305BoringSsl(*std::move(aead)))};
+}
+
+util::StatusOr<std::unique_ptr<Aead>> XChacha20Poly1305BoringSsl::New(
+    util::SecretData key) {
+  util::StatusOr<std::unique_ptr<XChacha20Poly1305BoringSsl>> aead =
+      Create(key);
+  if (!aead.ok()) {
+    return aead.status();
+  }
+  return {std::unique_ptr<Aead>(*std::move(aead))};
+}
+
+util::StatusOr<std::unique_ptr<ZeroCopyAead>>
+XChacha20Poly1305BoringSsl::NewZeroCopy(util::SecretData key) {
+  util::StatusOr<std::unique_ptr<XChacha20Poly1305BoringSsl>> aead =
+      Create(key);
+  if (!aead.ok()) {
+    return aead.status();
+  }
+  return {std::unique_ptr<ZeroCopyAead>(*std::move(aead))};
 }
 
 util::StatusOr<std::string> XChacha20Poly1305BoringSsl::Encrypt(
     absl::string_view plaintext, absl::string_view associated_data) const {
-  const int64_t kCiphertextSize =
-      kNonceSizeInBytes + aead_->CiphertextSize(plaintext.size());
-  std::string ct;
-  ResizeStringUninitialized(&ct, kCiphertextSize);
-  util::Status res =
-      Random::GetRandomBytes(absl::MakeSpan(ct).subspan(0, kNonceSizeInBytes));
+  std::string ciphertext;
+  ResizeStringUninitialized(&ciphertext, MaxEncryptionSize(plaintext.size()));
+  util::StatusOr<int64_t> written_bytes =
+      Encrypt(plaintext, associated_data, absl::MakeSpan(ciphertext));
+  if (!written_bytes.ok()) {
+    return written_bytes.status();
+  }
+  ciphertext.resize(*written_bytes);
+  return ciphertext;
+}
+
+util::StatusOr<std::string> XChacha20Poly1305BoringSsl::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data) const {
+  std::string plaintext;
+  ResizeStringUninitialized(&plaintext, MaxDecryptionSize(ciphertext.size()));
+  util::StatusOr<int64_t> written_bytes =
+      Decrypt(ciphertext, associated_data, absl::MakeSpan(plaintext));
+  if (!written_bytes.ok()) {
+    return written_bytes.status();
+  }
+  plaintext.resize(*written_bytes);
+  return plaintext;
+}
+
+int64_t XChacha20Poly1305BoringSsl::MaxEncryptionSize(
+    int64_t plaintext_size) const {
+  return kNonceSizeInBytes + aead_->CiphertextSize(plaintext_size);
+}
+
+util::StatusOr<int64_t> XChacha20Poly1305BoringSsl::Encrypt(
+    absl::string_view plaintext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
+  if (buffer.size() < kNonceSizeInBytes) {
+    return util::Status(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrCat("Encryption buffer too small; expected at least ",
+                     MaxEncryptionSize(plaintext.size()), " bytes, got ",
+                     buffer.size()));
+  }
+  util::Status res = internal::ValidateEncryptionBuffersWithPrefixIv(
+      plaintext, buffer, kNonceSizeInBytes);
+  if (!res.ok()) {
+    return res;
+  }
+  res = Random::GetRandomNonceBytes(buffer.subspan(0, kNonceSizeInBytes));
   if (!res.ok()) {
     return res;
   }
-  auto nonce = absl::string_view(ct).substr(0, kNonceSizeInBytes);
-  auto ciphertext_and_tag_buffer =
-      absl::MakeSpan(ct).subspan(kNonceSizeInBytes);
+  auto nonce = absl::string_view(buffer.data(), kNonceSizeInBytes);
   util::StatusOr<int64_t> written_bytes = aead_->Encrypt(
-      plaintext, associated_data, nonce, ciphertext_and_tag_buffer);
+      plaintext, associated_data, nonce, buffer.subspan(kNonceSizeInBytes));
   if (!written_bytes.ok()) {
     return written_bytes.status();
   }
-  return ct;
+  return kNonceSizeInBytes + *written_bytes;
 }
 
-util::StatusOr<std::string> XChacha20Poly1305BoringSsl::Decrypt(
-    absl::string_view ciphertext, absl::string_view associated_data) const {
+int64_t XChacha20Poly1305BoringSsl::MaxDecryptionSize(
+    int64_t ciphertext_size) const {
+  if (ciphertext_size < kNonceSizeInBytes + kTagSizeInBytes) {
+    return 0;
+  }
+  return aead_->PlaintextSize(ciphertext_size - kNonceSizeInBytes);
+}
+
+util::StatusOr<int64_t> XChacha20Poly1305BoringSsl::Decrypt(
+    absl::string_view ciphertext, absl::string_view associated_data,
+    absl::Span<char> buffer) const {
   if (ciphertext.size() < kNonceSizeInBytes + kTagSizeInBytes) {
     return util::Status(absl::StatusCode::kInvalidArgument,
                         absl::StrCat("Ciphertext too short; expected at least ",
                                      kNonceSizeInBytes + kTagSizeInBytes,
                                      " got ", ciphertext.size()));
   }
-  const int64_t kPlaintextSize =
-      aead_->PlaintextSize(ciphertext.size() - kNonceSizeInBytes);
-  std::string plaintext;
-  ResizeStringUninitialized(&plaintext, kPlaintextSize);
+  util::Status res = internal::ValidateDecryptionBuffersWithPrefixIv(
+      ciphertext, buffer, kNonceSizeInBytes);
+  if (!res.ok()) {
+    return res;
+  }
   auto nonce = ciphertext.substr(0, kNonceSizeInBytes);
   auto encrypted = ciphertext.substr(kNonceSizeInBytes);
-  util::StatusOr<int64_t> written_bytes = aead_->Decrypt(
-      encrypted, associated_data, nonce, absl::MakeSpan(plaintext));
-  if (!written_bytes.ok()) {
-    return written_bytes.status();
-  }
-  return plaintext;
+  return aead_->Decrypt(encrypted, associated_data, nonce, buffer);
+}
+
+int64_t XChacha20Poly1305BoringSsl::InPlaceOffset() const {
+  return kNonceSizeInBytes;
+}
+
+util::Status XChacha20Poly1305BoringSsl::EncryptBatchWithPrefix(
+    absl::string_view output_prefix,
+    absl::Span<const absl::string_view> plaintexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* ciphertexts, std::vector<int64_t>* offsets) const {
+  return internal::EncryptBatchWithRandomIv(*aead_, kNonceSizeInBytes,
+                                            plaintexts, associated_data,
+                                            output_prefix, ciphertexts,
+                                            offsets);
+}
+
+util::Status XChacha20Poly1305BoringSsl::DecryptBatch(
+    absl::Span<const absl::string_view> ciphertexts,
+    absl::Span<const absl::string_view> associated_data,
+    std::string* plaintexts, std::vector<int64_t>* offsets) const {
+  return internal::DecryptBatchWithPrefixIv(*aead_, kNonceSizeInBytes,
+                                            kTagSizeInBytes, ciphertexts,
+                                            associated_data, plaintexts,
+                                            offsets);
 }
 
 }  // namespace subtle
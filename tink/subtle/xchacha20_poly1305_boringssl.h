@@ -17,12 +17,16 @@
 #ifndef TINK_SUBTLE_XCHACHA20_POLY1305_BORINGSSL_H_
 #define TINK_SUBTLE_XCHACHA20_POLY1305_BORINGSSL_H_
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/aead.h"
+#include "tink/aead/zero_copy_aead.h"
 #include "tink/aead/internal/ssl_aead.h"
 #include "tink/internal/fips_utils.h"
 #include "tink/util/secret_data.h"
@@ -33,7 +37,7 @@ namespace crypto {
 namespace tink {
 namespace subtle {
 
-class XChacha20Poly1305BoringSsl : public Aead {
+class XChacha20Poly1305BoringSsl : public Aead, public ZeroCopyAead {
  public:
   // Constructs a new Aead cipher for XChacha20-Poly1305.
   // Currently supported key size is 256 bits.
@@ -42,6 +46,10 @@ class XChacha20Poly1305BoringSsl : public Aead {
   static crypto::tink::util::StatusOr<std::unique_ptr<Aead>> New(
       util::SecretData key);
 
+  // Same as New(), but returns the ZeroCopyAead view of the primitive.
+  static crypto::tink::util::StatusOr<std::unique_ptr<ZeroCopyAead>>
+  NewZeroCopy(util::SecretData key);
+
   crypto::tink::util::StatusOr<std::string> Encrypt(
       absl::string_view plaintext,
       absl::string_view associated_data) const override;
@@ -50,10 +58,44 @@ class XChacha20Poly1305BoringSsl : public Aead {
       absl::string_view ciphertext,
       absl::string_view associated_data) const override;
 
+  // ZeroCopyAead: the ciphertext is written into the caller's `buffer`, in
+  // the same format as Encrypt() above.
+  int64_t MaxEncryptionSize(int64_t plaintext_size) const override;
+
+  crypto::tink::util::StatusOr<int64_t> Encrypt(
+      absl::string_view plaintext, absl::string_view associated_data,
+      absl::Span<char> buffer) const override;
+
+  int64_t MaxDecryptionSize(int64_t ciphertext_size) const override;
+
+  crypto::tink::util::StatusOr<int64_t> Decrypt(
+      absl::string_view ciphertext, absl::string_view associated_data,
+      absl::Span<char> buffer) const override;
+
+  // Encryption and decryption may be done in place after the nonce.
+  int64_t InPlaceOffset() const override;
+
+  // Writes all ciphertexts (resp. plaintexts) of the batch into a single
+  // buffer, drawing the nonces of the whole batch at once.
+  crypto::tink::util::Status EncryptBatchWithPrefix(
+      absl::string_view output_prefix,
+      absl::Span<const absl::string_view> plaintexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* ciphertexts, std::vector<int64_t>* offsets) const override;
+
+  crypto::tink::util::Status DecryptBatch(
+      absl::Span<const absl::string_view> ciphertexts,
+      absl::Span<const absl::string_view> associated_data,
+      std::string* plaintexts, std::vector<int64_t>* offsets) const override;
+
   static constexpr crypto::tink::internal::FipsCompatibility kFipsStatus =
       crypto::tink::internal::FipsCompatibility::kNotFips;
 
  private:
+  static crypto::tink::util::StatusOr<
+      std::unique_ptr<XChacha20Poly1305BoringSsl>>
+  Create(util::SecretData key);
+
   explicit XChacha20Poly1305BoringSsl(
       std::unique_ptr<internal::SslOneShotAead> aead)
       : aead_(std::move(aead)) {}
@@ -16,6 +16,7 @@
 
 #include "tink/subtle/xchacha20_poly1305_boringssl.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,8 @@
 #include "absl/status/status.h"
 #include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "tink/aead/internal/wycheproof_aead.h"
 #include "tink/config/tink_fips.h"
 #include "tink/internal/ssl_util.h"
@@ -83,10 +86,123 @@ TEST(XChacha20Poly1305BoringSslTest, EncryptDecrypt) {
   }
 }
 
+TEST(XChacha20Poly1305BoringSslTest, EncryptDecryptBatch) {
+  if (!internal::IsBoringSsl()) {
+    GTEST_SKIP() << "Unimplemented with OpenSSL";
+  }
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  util::SecretData key =
+      util::SecretDataFromStringView(absl::HexStringToBytes(kKey256Hex));
+  util::StatusOr<std::unique_ptr<Aead>> aead =
+      XChacha20Poly1305BoringSsl::New(key);
+  ASSERT_THAT(aead, IsOk());
+
+  std::vector<absl::string_view> messages = {kMessage, "", "Another message"};
+  std::vector<absl::string_view> associated_data = {kAssociatedData, "", "ad"};
+  std::string ciphertexts;
+  std::vector<int64_t> offsets;
+  ASSERT_THAT((*aead)->EncryptBatch(messages, associated_data, &ciphertexts,
+                                    &offsets),
+              IsOk());
+  ASSERT_THAT(offsets, SizeIs(messages.size() + 1));
+  std::vector<absl::string_view> ciphertext_views;
+  for (int i = 0; i < messages.size(); ++i) {
+    absl::string_view ciphertext = absl::string_view(ciphertexts).substr(
+        offsets[i], offsets[i + 1] - offsets[i]);
+    EXPECT_THAT(ciphertext, SizeIs(messages[i].size() + kNonceSizeInBytes +
+                                   kTagSizeInBytes));
+    // Ciphertexts of a batch are regular ciphertexts.
+    util::StatusOr<std::string> plaintext =
+        (*aead)->Decrypt(ciphertext, associated_data[i]);
+    ASSERT_THAT(plaintext, IsOk());
+    EXPECT_EQ(*plaintext, messages[i]);
+    ciphertext_views.push_back(ciphertext);
+  }
+
+  std::string plaintexts;
+  ASSERT_THAT((*aead)->DecryptBatch(ciphertext_views, associated_data,
+                                    &plaintexts, &offsets),
+              IsOk());
+  EXPECT_EQ(plaintexts, absl::StrCat(messages[0], messages[1], messages[2]));
+
+  // Decryption fails if the associated data does not match.
+  std::vector<absl::string_view> wrong_associated_data = {kAssociatedData};
+  EXPECT_THAT((*aead)->DecryptBatch(ciphertext_views, wrong_associated_data,
+                                    &plaintexts, &offsets),
+              Not(IsOk()));
+  EXPECT_THAT((*aead)->DecryptBatch(
+                  ciphertext_views,
+                  absl::MakeConstSpan(associated_data).subspan(0, 2),
+                  &plaintexts, &offsets),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 // Test decryption with a known ciphertext, message, associated_data and key
 // tuple to make sure this is using the correct algorithm. The values are taken
 // from the test vector tcId 1 of the Wycheproof tests:
 // https://github.com/google/wycheproof/blob/master/testvectors/xchacha20_poly1305_test.json#L21
+TEST(XChacha20Poly1305BoringSslTest, ZeroCopyEncryptDecrypt) {
+  if (!internal::IsBoringSsl()) {
+    GTEST_SKIP() << "XChaCha20-Poly1305 is not supported when OpenSSL is used";
+  }
+  if (IsFipsModeEnabled()) {
+    GTEST_SKIP() << "Not supported in FIPS-only mode";
+  }
+
+  util::SecretData key =
+      util::SecretDataFromStringView(absl::HexStringToBytes(kKey256Hex));
+  util::StatusOr<std::unique_ptr<ZeroCopyAead>> zero_copy_aead =
+      XChacha20Poly1305BoringSsl::NewZeroCopy(key);
+  ASSERT_THAT(zero_copy_aead, IsOk());
+  util::StatusOr<std::unique_ptr<Aead>> aead =
+      XChacha20Poly1305BoringSsl::New(key);
+  ASSERT_THAT(aead, IsOk());
+
+  std::string ciphertext;
+  subtle::ResizeStringUninitialized(
+      &ciphertext, (*zero_copy_aead)->MaxEncryptionSize(kMessage.size()));
+  EXPECT_THAT(ciphertext,
+              SizeIs(kMessage.size() + kNonceSizeInBytes + kTagSizeInBytes));
+  util::StatusOr<int64_t> written = (*zero_copy_aead)->Encrypt(
+      kMessage, kAssociatedData, absl::MakeSpan(ciphertext));
+  ASSERT_THAT(written, IsOk());
+  EXPECT_EQ(*written, ciphertext.size());
+
+  // Zero-copy ciphertexts are Aead ciphertexts, and vice versa.
+  util::StatusOr<std::string> plaintext =
+      (*aead)->Decrypt(ciphertext, kAssociatedData);
+  ASSERT_THAT(plaintext, IsOk());
+  EXPECT_EQ(*plaintext, kMessage);
+
+  util::StatusOr<std::string> aead_ciphertext =
+      (*aead)->Encrypt(kMessage, kAssociatedData);
+  ASSERT_THAT(aead_ciphertext, IsOk());
+  std::string buffer;
+  subtle::ResizeStringUninitialized(
+      &buffer, (*zero_copy_aead)->MaxDecryptionSize(aead_ciphertext->size()));
+  written = (*zero_copy_aead)->Decrypt(*aead_ciphertext, kAssociatedData,
+                                       absl::MakeSpan(buffer));
+  ASSERT_THAT(written, IsOk());
+  EXPECT_EQ(absl::string_view(buffer).substr(0, *written), kMessage);
+
+  // Buffers that are too small are rejected.
+  std::string small_buffer(ciphertext.size() - 1, '\0');
+  EXPECT_THAT((*zero_copy_aead)
+                  ->Encrypt(kMessage, kAssociatedData,
+                            absl::MakeSpan(small_buffer))
+                  .status(),
+              Not(IsOk()));
+  small_buffer.resize(kMessage.size() - 1);
+  EXPECT_THAT((*zero_copy_aead)
+                  ->Decrypt(ciphertext, kAssociatedData,
+                            absl::MakeSpan(small_buffer))
+                  .status(),
+              Not(IsOk()));
+}
+
 TEST(XChacha20Poly1305BoringSslTest, SimpleDecrypt) {
   if (!internal::IsBoringSsl()) {
     GTEST_SKIP() << "Unimplemented with OpenSSL";
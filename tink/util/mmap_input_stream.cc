@@ -0,0 +1,131 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/mmap_input_stream.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "tink/util/errors.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+namespace {
+
+constexpr int kMaxChunkSize = 1 << 30;
+// How far ahead of the current position the kernel is asked to read.
+constexpr int64_t kReadAheadSize = 4 * 1024 * 1024;
+
+int close_ignoring_eintr(int fd) {
+  int result;
+  do {
+    result = close(fd);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+}  // anonymous namespace
+
+// static
+StatusOr<std::unique_ptr<MmapInputStream>> MmapInputStream::New(
+    int file_descriptor, int max_chunk_size) {
+  struct stat s;
+  if (fstat(file_descriptor, &s) == -1) {
+    int error = errno;
+    close_ignoring_eintr(file_descriptor);
+    return ToStatusF(absl::StatusCode::kInvalidArgument,
+                     "Cannot stat the file: %d", error);
+  }
+  if (!S_ISREG(s.st_mode)) {
+    close_ignoring_eintr(file_descriptor);
+    return Status(absl::StatusCode::kInvalidArgument,
+                  "Only regular files can be mapped");
+  }
+  const int64_t size = s.st_size;
+  void* data = nullptr;
+  // Empty files cannot be mapped, and are represented by data == nullptr.
+  if (size > 0) {
+    data = mmap(nullptr, size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    if (data == MAP_FAILED) {
+      int error = errno;
+      close_ignoring_eintr(file_descriptor);
+      return ToStatusF(absl::StatusCode::kInternal, "Cannot map the file: %d",
+                       error);
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+  }
+  // The mapping stays valid after the file is closed.
+  close_ignoring_eintr(file_descriptor);
+  return absl::WrapUnique(new MmapInputStream(
+      static_cast<const char*>(data), size,
+      max_chunk_size > 0 ? std::min(max_chunk_size, kMaxChunkSize)
+                         : kMaxChunkSize));
+}
+
+MmapInputStream::~MmapInputStream() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+util::StatusOr<int> MmapInputStream::Next(const void** data) {
+  if (data == nullptr) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "Data pointer must not be nullptr");
+  }
+  if (position_ >= size_) {
+    count_returned_ = 0;
+    return Status(absl::StatusCode::kOutOfRange, "EOF");
+  }
+  // Once less than half of the read-ahead window is left, ask the kernel to
+  // read the next window (starting at a page boundary, as madvise requires).
+  if (advised_end_ < size_ && position_ + kReadAheadSize / 2 >= advised_end_) {
+    static const int64_t kPageSize = sysconf(_SC_PAGESIZE);
+    int64_t start = std::max(advised_end_, position_);
+    start -= start % kPageSize;
+    advised_end_ = std::min(position_ + kReadAheadSize, size_);
+    madvise(const_cast<char*>(data_) + start, advised_end_ - start,
+            MADV_WILLNEED);
+  }
+  count_returned_ = std::min<int64_t>(max_chunk_size_, size_ - position_);
+  *data = data_ + position_;
+  position_ += count_returned_;
+  return count_returned_;
+}
+
+void MmapInputStream::BackUp(int count) {
+  if (count < 1) return;
+  int actual_count = std::min(count, count_returned_);
+  count_returned_ -= actual_count;
+  position_ -= actual_count;
+}
+
+int64_t MmapInputStream::Position() const { return position_; }
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
@@ -0,0 +1,81 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_MMAP_INPUT_STREAM_H_
+#define TINK_UTIL_MMAP_INPUT_STREAM_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "tink/input_stream.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// An InputStream that maps a local file into memory. Next() returns the
+// mapped file pages directly rather than copying them to an internal buffer,
+// so that streaming decryption can decrypt straight from the page cache.
+//
+// The stream covers the contents of the file at the time of construction.
+// The file is mapped shared, so it must not be truncated while the stream is
+// alive: reading a page beyond the new end of the file raises SIGBUS rather
+// than returning an error.
+//
+// NOTE: This class in not available when building on Windows.
+class MmapInputStream : public crypto::tink::InputStream {
+ public:
+  // Returns a MmapInputStream that reads from the file specified via
+  // 'file_descriptor', which must be a regular file opened for reading.
+  // Next() returns at most 'max_chunk_size' bytes at a time, if given
+  // (if no legal 'max_chunk_size' is given, the rest of the file is
+  // returned, up to 1 GB).
+  // Takes the ownership of the file, and closes it once it has been mapped.
+  static crypto::tink::util::StatusOr<std::unique_ptr<MmapInputStream>> New(
+      int file_descriptor, int max_chunk_size = -1);
+
+  ~MmapInputStream() override;
+
+  crypto::tink::util::StatusOr<int> Next(const void** data) override;
+
+  void BackUp(int count) override;
+
+  int64_t Position() const override;
+
+ private:
+  MmapInputStream(const char* data, int64_t size, int max_chunk_size)
+      : data_(data), size_(size), max_chunk_size_(max_chunk_size) {}
+
+  // Start of the mapping, or nullptr if the file is empty.
+  const char* const data_;
+  const int64_t size_;
+  const int max_chunk_size_;
+
+  // Current position in the stream (from the beginning).
+  int64_t position_ = 0;
+  // # of bytes returned by the last Next() that were not backed up.
+  int count_returned_ = 0;
+  // End of the range for which the kernel was asked to read ahead.
+  int64_t advised_end_ = 0;
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_MMAP_INPUT_STREAM_H_
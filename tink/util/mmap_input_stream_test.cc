@@ -0,0 +1,139 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/mmap_input_stream.h"
+
+#include <fcntl.h>
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tink/internal/test_file_util.h"
+#include "tink/subtle/random.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::IsOkAndHolds;
+using ::crypto::tink::test::StatusIs;
+
+// Writes `contents` to a new test file and returns a file descriptor to it.
+util::StatusOr<int> CreateTestFileToRead(absl::string_view contents) {
+  std::string filename = absl::StrCat(
+      contents.size(), crypto::tink::internal::GetTestFileNamePrefix(),
+      "_file.bin");
+  util::Status status =
+      crypto::tink::internal::CreateTestFile(filename, contents);
+  if (!status.ok()) return status;
+  std::string full_filename = absl::StrCat(test::TmpDir(), "/", filename);
+  int fd = open(full_filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return util::Status(absl::StatusCode::kInternal,
+                        absl::StrCat("Cannot open file ", full_filename,
+                                     " error: ", std::strerror(errno)));
+  }
+  return fd;
+}
+
+TEST(MmapInputStreamTest, ReadingStreams) {
+  for (int stream_size : {0, 1, 10, 100, 1000, 10000, 1000000}) {
+    for (int max_chunk_size : {-1, 1, 100, 4096}) {
+      SCOPED_TRACE(absl::StrCat("stream_size = ", stream_size,
+                                ", max_chunk_size = ", max_chunk_size));
+      std::string file_contents = subtle::Random::GetRandomBytes(stream_size);
+      util::StatusOr<int> input_fd = CreateTestFileToRead(file_contents);
+      ASSERT_THAT(input_fd, IsOk());
+      auto input_stream = MmapInputStream::New(*input_fd, max_chunk_size);
+      ASSERT_THAT(input_stream, IsOk());
+
+      std::string stream_contents;
+      const void* buffer;
+      auto next_result = (*input_stream)->Next(&buffer);
+      while (next_result.ok()) {
+        if (max_chunk_size > 0) {
+          EXPECT_LE(*next_result, max_chunk_size);
+        }
+        stream_contents.append(static_cast<const char*>(buffer),
+                               *next_result);
+        EXPECT_EQ(stream_contents.size(), (*input_stream)->Position());
+        next_result = (*input_stream)->Next(&buffer);
+      }
+      EXPECT_THAT(next_result.status(),
+                  StatusIs(absl::StatusCode::kOutOfRange));
+      EXPECT_EQ(file_contents, stream_contents);
+    }
+  }
+}
+
+TEST(MmapInputStreamTest, BackUp) {
+  int stream_size = 10000;
+  std::string file_contents = subtle::Random::GetRandomBytes(stream_size);
+  util::StatusOr<int> input_fd = CreateTestFileToRead(file_contents);
+  ASSERT_THAT(input_fd, IsOk());
+  auto input_stream = MmapInputStream::New(*input_fd, /*max_chunk_size=*/1000);
+  ASSERT_THAT(input_stream, IsOk());
+  const void* buffer;
+
+  ASSERT_THAT((*input_stream)->Next(&buffer), IsOkAndHolds(1000));
+  // Repeated BackUp()-calls accumulate, and are capped at the size of the
+  // last buffer.
+  (*input_stream)->BackUp(100);
+  (*input_stream)->BackUp(-5);
+  (*input_stream)->BackUp(200);
+  EXPECT_EQ(700, (*input_stream)->Position());
+  (*input_stream)->BackUp(5000);
+  EXPECT_EQ(0, (*input_stream)->Position());
+
+  // The backed up bytes are returned again.
+  ASSERT_THAT((*input_stream)->Next(&buffer), IsOkAndHolds(1000));
+  EXPECT_EQ(file_contents.substr(0, 1000),
+            std::string(static_cast<const char*>(buffer), 1000));
+  (*input_stream)->BackUp(10);
+  ASSERT_THAT((*input_stream)->Next(&buffer), IsOkAndHolds(1000));
+  EXPECT_EQ(file_contents.substr(990, 1000),
+            std::string(static_cast<const char*>(buffer), 1000));
+  EXPECT_EQ(1990, (*input_stream)->Position());
+}
+
+TEST(MmapInputStreamTest, NullDataPointer) {
+  util::StatusOr<int> input_fd = CreateTestFileToRead("some contents");
+  ASSERT_THAT(input_fd, IsOk());
+  auto input_stream = MmapInputStream::New(*input_fd);
+  ASSERT_THAT(input_stream, IsOk());
+  EXPECT_THAT((*input_stream)->Next(nullptr).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(MmapInputStreamTest, InvalidFileDescriptor) {
+  EXPECT_THAT(MmapInputStream::New(-1).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
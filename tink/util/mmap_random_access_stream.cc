@@ -0,0 +1,163 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/mmap_random_access_stream.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "tink/util/buffer.h"
+#include "tink/util/errors.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+namespace {
+
+// How far ahead of the current read the kernel is asked to read.
+constexpr int64_t kReadAheadSize = 4 * 1024 * 1024;
+
+int close_ignoring_eintr(int fd) {
+  int result;
+  do {
+    result = close(fd);
+  } while (result < 0 && errno == EINTR);
+  return result;
+}
+
+}  // anonymous namespace
+
+// static
+StatusOr<std::unique_ptr<MmapRandomAccessStream>> MmapRandomAccessStream::New(
+    int file_descriptor) {
+  struct stat s;
+  if (fstat(file_descriptor, &s) == -1) {
+    int error = errno;
+    close_ignoring_eintr(file_descriptor);
+    return ToStatusF(absl::StatusCode::kInvalidArgument,
+                     "Cannot stat the file: %d", error);
+  }
+  if (!S_ISREG(s.st_mode)) {
+    close_ignoring_eintr(file_descriptor);
+    return Status(absl::StatusCode::kInvalidArgument,
+                  "Only regular files can be mapped");
+  }
+  const int64_t size = s.st_size;
+  void* data = nullptr;
+  // Empty files cannot be mapped, and are represented by data == nullptr.
+  if (size > 0) {
+    data = mmap(nullptr, size, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    if (data == MAP_FAILED) {
+      int error = errno;
+      close_ignoring_eintr(file_descriptor);
+      return ToStatusF(absl::StatusCode::kInternal, "Cannot map the file: %d",
+                       error);
+    }
+  }
+  // The mapping stays valid after the file is closed.
+  close_ignoring_eintr(file_descriptor);
+  return absl::WrapUnique(
+      new MmapRandomAccessStream(static_cast<const char*>(data), size));
+}
+
+MmapRandomAccessStream::~MmapRandomAccessStream() {
+  if (data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+void MmapRandomAccessStream::AdviseWillNeed(int64_t position, int count) {
+  const int64_t end = position + count;
+  const int64_t advised_start =
+      advised_start_.load(std::memory_order_relaxed);
+  const int64_t advised_end = advised_end_.load(std::memory_order_relaxed);
+  // As long as the read lies within the advised range, and more than half of
+  // a read-ahead window is left after it, there is nothing to do.
+  if (position >= advised_start &&
+      std::min(end + kReadAheadSize / 2, size_) <= advised_end) {
+    return;
+  }
+  // Reads continuing within the advised range only extend it; other reads
+  // start a new one (at a page boundary, as madvise requires).
+  const bool extends_range =
+      position >= advised_start && position < advised_end;
+  static const int64_t kPageSize = sysconf(_SC_PAGESIZE);
+  int64_t start = extends_range ? advised_end : position;
+  start -= start % kPageSize;
+  const int64_t new_end = std::min(end + kReadAheadSize, size_);
+  madvise(const_cast<char*>(data_) + start, new_end - start, MADV_WILLNEED);
+  advised_start_.store(extends_range ? advised_start : start,
+                       std::memory_order_relaxed);
+  advised_end_.store(new_end, std::memory_order_relaxed);
+}
+
+Status MmapRandomAccessStream::PRead(int64_t position, int count,
+                                     Buffer* dest_buffer) {
+  if (dest_buffer == nullptr) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "dest_buffer must be non-null");
+  }
+  if (count > dest_buffer->allocated_size()) {
+    return util::Status(absl::StatusCode::kInvalidArgument, "buffer too small");
+  }
+  auto view = View(position, count);
+  if (!view.ok()) {
+    dest_buffer->set_size(0).IgnoreError();
+    return view.status();
+  }
+  crypto::tink::util::Status status = dest_buffer->set_size(view->size());
+  if (!status.ok()) return status;
+  std::memcpy(dest_buffer->get_mem_block(), view->data(), view->size());
+  return util::OkStatus();
+}
+
+StatusOr<absl::string_view> MmapRandomAccessStream::View(int64_t position,
+                                                         int count) {
+  if (count <= 0) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "count must be positive");
+  }
+  if (position < 0) {
+    return util::Status(absl::StatusCode::kInvalidArgument,
+                        "position cannot be negative");
+  }
+  if (position >= size_) {
+    return Status(absl::StatusCode::kOutOfRange, "EOF");
+  }
+  int view_count = std::min<int64_t>(count, size_ - position);
+  AdviseWillNeed(position, view_count);
+  return absl::string_view(data_ + position, view_count);
+}
+
+StatusOr<int64_t> MmapRandomAccessStream::size() { return size_; }
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
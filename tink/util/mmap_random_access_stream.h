@@ -0,0 +1,87 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef TINK_UTIL_MMAP_RANDOM_ACCESS_STREAM_H_
+#define TINK_UTIL_MMAP_RANDOM_ACCESS_STREAM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "absl/strings/string_view.h"
+#include "tink/random_access_stream.h"
+#include "tink/util/buffer.h"
+#include "tink/util/status.h"
+#include "tink/util/statusor.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+
+// A RandomAccessStream that maps a local file into memory. Besides PRead(),
+// it supports View(), which exposes the mapped file pages directly, so that
+// e.g. DecryptingRandomAccessStream decrypts ciphertext segments without
+// copying them first.
+//
+// The stream covers the contents of the file at the time of construction.
+// The file is mapped shared, so it must not be truncated while the stream is
+// alive: reading a page beyond the new end of the file raises SIGBUS rather
+// than returning an error.
+//
+// NOTE: This class in not available when building on Windows.
+class MmapRandomAccessStream : public crypto::tink::RandomAccessStream {
+ public:
+  // Returns a MmapRandomAccessStream that reads from the file specified
+  // via 'file_descriptor', which must be a regular file opened for reading.
+  // Takes the ownership of the file, and closes it once it has been mapped.
+  static crypto::tink::util::StatusOr<std::unique_ptr<MmapRandomAccessStream>>
+  New(int file_descriptor);
+
+  ~MmapRandomAccessStream() override;
+
+  crypto::tink::util::Status PRead(int64_t position, int count,
+                                   Buffer* dest_buffer) override;
+
+  crypto::tink::util::StatusOr<int64_t> size() override;
+
+  crypto::tink::util::StatusOr<absl::string_view> View(int64_t position,
+                                                       int count) override;
+
+ private:
+  MmapRandomAccessStream(const char* data, int64_t size)
+      : data_(data), size_(size) {}
+
+  // Hints the kernel that the pages holding the 'count' bytes at 'position',
+  // and the ones following them, will be accessed soon. Skips the system call
+  // if these pages have already been advised.
+  void AdviseWillNeed(int64_t position, int count);
+
+  // Start of the mapping, or nullptr if the file is empty.
+  const char* const data_;
+  const int64_t size_;
+
+  // The range for which the kernel was last asked to read ahead. This is only
+  // a hint, so concurrent readers may update it without further
+  // synchronization.
+  std::atomic<int64_t> advised_start_{0};
+  std::atomic<int64_t> advised_end_{0};
+};
+
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
+
+#endif  // TINK_UTIL_MMAP_RANDOM_ACCESS_STREAM_H_
@@ -0,0 +1,163 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "tink/util/mmap_random_access_stream.h"
+
+#include <fcntl.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tink/internal/test_file_util.h"
+#include "tink/subtle/random.h"
+#include "tink/util/buffer.h"
+#include "tink/util/test_matchers.h"
+#include "tink/util/test_util.h"
+
+namespace crypto {
+namespace tink {
+namespace util {
+namespace {
+
+using ::crypto::tink::test::IsOk;
+using ::crypto::tink::test::StatusIs;
+
+// Writes `contents` to a new test file and returns a file descriptor to it.
+util::StatusOr<int> CreateTestFileToRead(absl::string_view contents) {
+  std::string filename = absl::StrCat(
+      contents.size(), crypto::tink::internal::GetTestFileNamePrefix(),
+      "_file.bin");
+  util::Status status =
+      crypto::tink::internal::CreateTestFile(filename, contents);
+  if (!status.ok()) return status;
+  std::string full_filename = absl::StrCat(test::TmpDir(), "/", filename);
+  int fd = open(full_filename.c_str(), O_RDONLY);
+  if (fd == -1) {
+    return util::Status(absl::StatusCode::kInternal,
+                        absl::StrCat("Cannot open file ", full_filename,
+                                     " error: ", std::strerror(errno)));
+  }
+  return fd;
+}
+
+TEST(MmapRandomAccessStreamTest, ReadingStreams) {
+  for (int stream_size : {0, 1, 10, 100, 1000, 10000, 1000000}) {
+    SCOPED_TRACE(absl::StrCat("stream_size = ", stream_size));
+    std::string file_contents = subtle::Random::GetRandomBytes(stream_size);
+    util::StatusOr<int> input_fd = CreateTestFileToRead(file_contents);
+    ASSERT_THAT(input_fd, IsOk());
+    auto ra_stream = MmapRandomAccessStream::New(*input_fd);
+    ASSERT_THAT(ra_stream, IsOk());
+    EXPECT_EQ(stream_size, (*ra_stream)->size().value());
+
+    int chunk_size = 1 + stream_size / 10;
+    auto buffer = std::move(Buffer::New(chunk_size).value());
+    std::string stream_contents;
+    util::Status status = util::OkStatus();
+    while (status.ok()) {
+      status = (*ra_stream)->PRead(stream_contents.size(), chunk_size,
+                                   buffer.get());
+      stream_contents.append(buffer->get_mem_block(), buffer->size());
+    }
+    EXPECT_THAT(status, StatusIs(absl::StatusCode::kOutOfRange));
+    EXPECT_EQ(0, buffer->size());
+    EXPECT_EQ(file_contents, stream_contents);
+  }
+}
+
+TEST(MmapRandomAccessStreamTest, Views) {
+  int stream_size = 10000;
+  std::string file_contents = subtle::Random::GetRandomBytes(stream_size);
+  util::StatusOr<int> input_fd = CreateTestFileToRead(file_contents);
+  ASSERT_THAT(input_fd, IsOk());
+  auto ra_stream = MmapRandomAccessStream::New(*input_fd);
+  ASSERT_THAT(ra_stream, IsOk());
+
+  for (int64_t position : {0, 1, 4095, 4096, 5000, 9999}) {
+    for (int count : {1, 100, 5000, 10000}) {
+      SCOPED_TRACE(absl::StrCat("position = ", position, ", count = ", count));
+      util::StatusOr<absl::string_view> view =
+          (*ra_stream)->View(position, count);
+      ASSERT_THAT(view, IsOk());
+      EXPECT_EQ(absl::string_view(file_contents).substr(position, count),
+                *view);
+    }
+  }
+  EXPECT_THAT((*ra_stream)->View(stream_size, 1).status(),
+              StatusIs(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT((*ra_stream)->View(-1, 1).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT((*ra_stream)->View(0, 0).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(MmapRandomAccessStreamTest, ViewsOutOfOrder) {
+  // Larger than the read-ahead window, so that reads both extend and move it.
+  int stream_size = 10 * 1024 * 1024 + 123;
+  std::string file_contents = subtle::Random::GetRandomBytes(stream_size);
+  util::StatusOr<int> input_fd = CreateTestFileToRead(file_contents);
+  ASSERT_THAT(input_fd, IsOk());
+  auto ra_stream = MmapRandomAccessStream::New(*input_fd);
+  ASSERT_THAT(ra_stream, IsOk());
+
+  for (int64_t position :
+       {0, 4096, 3 * 1024 * 1024, 9 * 1024 * 1024, 1000, 5 * 1024 * 1024,
+        10 * 1024 * 1024, 2 * 1024 * 1024 + 1}) {
+    SCOPED_TRACE(absl::StrCat("position = ", position));
+    util::StatusOr<absl::string_view> view =
+        (*ra_stream)->View(position, 100000);
+    ASSERT_THAT(view, IsOk());
+    EXPECT_EQ(absl::string_view(file_contents).substr(position, 100000),
+              *view);
+  }
+}
+
+TEST(MmapRandomAccessStreamTest, InvalidPReadArguments) {
+  std::string file_contents = subtle::Random::GetRandomBytes(100);
+  util::StatusOr<int> input_fd = CreateTestFileToRead(file_contents);
+  ASSERT_THAT(input_fd, IsOk());
+  auto ra_stream = MmapRandomAccessStream::New(*input_fd);
+  ASSERT_THAT(ra_stream, IsOk());
+  auto buffer = std::move(Buffer::New(42).value());
+
+  EXPECT_THAT((*ra_stream)->PRead(-1, 42, buffer.get()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT((*ra_stream)->PRead(0, 0, buffer.get()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT((*ra_stream)->PRead(0, 43, buffer.get()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT((*ra_stream)->PRead(0, 42, nullptr),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(MmapRandomAccessStreamTest, InvalidFileDescriptor) {
+  EXPECT_THAT(MmapRandomAccessStream::New(-1).status(),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+}  // namespace
+}  // namespace util
+}  // namespace tink
+}  // namespace crypto
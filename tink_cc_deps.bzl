@@ -91,3 +91,15 @@ def tink_cc_deps():
             url = "https://github.com/google/wycheproof/archive/d8ed1ba95ac4c551db67f410c06131c3bc00a97c.zip",
             sha256 = "eb1d558071acf1aa6d677d7f1cabec2328d1cf8381496c17185bd92b52ce7545",
         )
+
+    # -------------------------------------------------------------------------
+    # Google Benchmark (used only by //tink/benchmarks).
+    # -------------------------------------------------------------------------
+    if not native.existing_rule("com_github_google_benchmark"):
+        # Release from 2023-08-31.
+        http_archive(
+            name = "com_github_google_benchmark",
+            strip_prefix = "benchmark-1.8.3",
+            url = "https://github.com/google/benchmark/archive/refs/tags/v1.8.3.tar.gz",
+            sha256 = "6bc180a57d23d4d9515519f92b0c83d61b05b5bab188961f36ac7b06b0d9e9ce",
+        )